@@ -31,7 +31,9 @@
 
 
 
+import gdaltest
 import ogrtest
+import pytest
 
 from osgeo import gdal, ogr
 
@@ -192,4 +194,98 @@ def test_polygonize_4():
     assert tr
 
 
+###############################################################################
+# Test that the multi-threaded output writes the same features as the
+# single-threaded one.
+
+
+@pytest.mark.parametrize('num_threads', ['2', 'ALL_CPUS'])
+def test_polygonize_num_threads(num_threads):
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 200, 150)
+    src_ds.SetGeoTransform([10, 0.5, 0, 20, 0, -0.5])
+    data = bytearray((x // 3 + y // 5 + (x * y) % 3) % 5
+                     for y in range(150) for x in range(200))
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, 200, 150, bytes(data))
+    src_band = src_ds.GetRasterBand(1)
+
+    def polygonize(options):
+        mem_ds = ogr.GetDriverByName('Memory').CreateDataSource('out')
+        mem_layer = mem_ds.CreateLayer('poly', None, ogr.wkbPolygon)
+        mem_layer.CreateField(ogr.FieldDefn('DN', ogr.OFTInteger))
+        assert gdal.Polygonize(src_band, None, mem_layer, 0, options) == 0
+        return [(f.GetField('DN'), f.GetGeometryRef().ExportToWkt())
+                for f in mem_layer]
+
+    ref = polygonize(['NUM_THREADS=1'])
+    assert len(ref) > 2000
+    assert polygonize(['NUM_THREADS=' + num_threads]) == ref
+
+
+###############################################################################
+# Test that an interruption in the multi-threaded mode stops the writing of
+# the pending features.
 
+
+def test_polygonize_num_threads_interrupted():
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 200, 150)
+    data = bytearray((x // 3 + y // 5 + (x * y) % 3) % 5
+                     for y in range(150) for x in range(200))
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, 200, 150, bytes(data))
+    src_band = src_ds.GetRasterBand(1)
+
+    def polygonize(options, callback=None):
+        mem_ds = ogr.GetDriverByName('Memory').CreateDataSource('out')
+        mem_layer = mem_ds.CreateLayer('poly', None, ogr.wkbPolygon)
+        mem_layer.CreateField(ogr.FieldDefn('DN', ogr.OFTInteger))
+        ret = gdal.Polygonize(src_band, None, mem_layer, 0, options,
+                              callback=callback)
+        return ret, mem_layer.GetFeatureCount()
+
+    ret, ref_count = polygonize(['NUM_THREADS=1'])
+    assert ret == 0
+
+    def cbk(pct, msg, user_data):
+        # pylint: disable=unused-argument
+        return pct < 0.5
+
+    with gdaltest.error_handler():
+        ret, count = polygonize(['NUM_THREADS=2'], cbk)
+    assert ret != 0
+    assert count < ref_count
+
+
+###############################################################################
+# Test that the output layer may belong to the source dataset when
+# NUM_THREADS is set.
+
+
+def test_polygonize_num_threads_same_dataset():
+
+    gpkg_drv = gdal.GetDriverByName('GPKG')
+    if gpkg_drv is None:
+        pytest.skip()
+
+    filename = '/vsimem/polygonize_num_threads_same_dataset.gpkg'
+    ds = gpkg_drv.Create(filename, 200, 150)
+    ds.SetGeoTransform([10, 0.5, 0, 20, 0, -0.5])
+    data = bytearray((x // 3 + y // 5 + (x * y) % 3) % 5
+                     for y in range(150) for x in range(200))
+    ds.GetRasterBand(1).WriteRaster(0, 0, 200, 150, bytes(data))
+    ds = None
+
+    ds = gdal.OpenEx(filename, gdal.OF_RASTER | gdal.OF_VECTOR | gdal.OF_UPDATE)
+    layers = []
+    for options in (['NUM_THREADS=1'], ['NUM_THREADS=2']):
+        lyr = ds.CreateLayer('poly_%d' % len(layers), None, ogr.wkbPolygon)
+        lyr.CreateField(ogr.FieldDefn('DN', ogr.OFTInteger))
+        assert gdal.Polygonize(ds.GetRasterBand(1), None, lyr, 0,
+                               options) == 0
+        layers.append([(f.GetField('DN'), f.GetGeometryRef().ExportToWkt())
+                       for f in lyr])
+    ds = None
+    gdal.Unlink(filename)
+
+    assert len(layers[0]) > 2000
+    assert layers[1] == layers[0]
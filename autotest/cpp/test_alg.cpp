@@ -34,6 +34,10 @@
 #include "gdal_alg.h"
 #include "gdalwarper.h"
 #include "gdal_priv.h"
+#include "ogr_api.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace tut
 {
@@ -290,5 +294,116 @@ namespace tut
         GDALClose(hWarpedVRT);
     }
 
+    // Test that the cutline masks are the same as the ones burnt by
+    // GDALRasterizeGeometries()
+    template<> template<> void object::test<9>()
+    {
+        const char* const apszWKT[] = {
+            // Polygon with a hole, and horizontal edges on pixel centers
+            "POLYGON ((10.5 10.5,160.5 10.5,160.5 120.5,10.5 120.5,10.5 10.5),"
+            "(40 40,80.5 40,80.5 80.5,40 80.5,40 40))",
+            // Oblique edges
+            "POLYGON ((5.3 22.7,180.8 4.4,243.6 189.2,120.4 251.2,13.2 160.8,"
+            "5.3 22.7))",
+            // Overlapping parts of a multipolygon
+            "MULTIPOLYGON (((0 0,120 0,120 120,0 120,0 0)),"
+            "((60.5 60.5,255.5 60.5,255.5 200.5,60.5 200.5,60.5 60.5)),"
+            "((160 160.5,240 160.5,200 252,160 160.5)))"
+        };
+        // Large enough for the warp to be split in several chunks
+        constexpr int nSize = 256;
+        auto poMEMDrv = GDALDriver::FromHandle(GDALGetDriverByName("MEM"));
+        double adfGeoTransform[6] = { 0, 1, 0, 0, 0, 1 };
+        for( const char* pszWKT: apszWKT )
+        {
+            OGRGeometryH hCutline = nullptr;
+            char* pszWKTIter = const_cast<char*>(pszWKT);
+            ensure_equals( OGR_G_CreateFromWkt(&pszWKTIter, nullptr, &hCutline),
+                           OGRERR_NONE );
+
+            // Reference mask
+            GDALDatasetUniquePtr poRefDS(
+                poMEMDrv->Create("", nSize, nSize, 1, GDT_Byte, nullptr));
+            poRefDS->SetGeoTransform(adfGeoTransform);
+            int nBand = 1;
+            double dfBurnValue = 1;
+            ensure_equals( GDALRasterizeGeometries(
+                GDALDataset::ToHandle(poRefDS.get()), 1, &nBand, 1, &hCutline,
+                nullptr, nullptr, &dfBurnValue, nullptr, nullptr, nullptr),
+                CE_None );
+            std::vector<GByte> abyRef(nSize * nSize);
+            ensure_equals( poRefDS->GetRasterBand(1)->RasterIO(GF_Read,
+                0, 0, nSize, nSize, abyRef.data(), nSize, nSize, GDT_Byte,
+                0, 0, nullptr), CE_None );
+
+            // Masks of windows of the source, burnt by the cutline masker
+            GDALWarpOptions* psWO = GDALCreateWarpOptions();
+            psWO->hCutline = OGR_G_Clone(hCutline);
+            for( int nChunkSize: { nSize, 37, 13 } )
+            {
+                for( int nYOff = 0; nYOff < nSize; nYOff += nChunkSize )
+                {
+                    for( int nXOff = 0; nXOff < nSize; nXOff += nChunkSize )
+                    {
+                        const int nXSize = std::min(nChunkSize, nSize - nXOff);
+                        const int nYSize = std::min(nChunkSize, nSize - nYOff);
+                        std::vector<float> afMask(nXSize * nYSize, 1.0f);
+                        ensure_equals( GDALWarpCutlineMasker(psWO, 1, GDT_Byte,
+                            nXOff, nYOff, nXSize, nYSize, nullptr, TRUE,
+                            afMask.data()), CE_None );
+                        for( int iY = 0; iY < nYSize; iY++ )
+                        {
+                            for( int iX = 0; iX < nXSize; iX++ )
+                            {
+                                ensure_equals( afMask[iY * nXSize + iX] != 0,
+                                    abyRef[(nYOff + iY) * nSize + nXOff + iX] != 0 );
+                            }
+                        }
+                    }
+                }
+            }
+            GDALDestroyWarpOptions(psWO);
+
+            // Chunked warp. The cutline is in pixel coordinates of the source
+            GDALDatasetUniquePtr poSrcDS(
+                poMEMDrv->Create("", nSize, nSize, 1, GDT_Byte, nullptr));
+            double adfWarpGeoTransform[6] = { 100, 1, 0, 200, 0, -1 };
+            poSrcDS->SetGeoTransform(adfWarpGeoTransform);
+            poSrcDS->GetRasterBand(1)->Fill(1);
+            GDALDatasetUniquePtr poDstDS(
+                poMEMDrv->Create("", nSize, nSize, 1, GDT_Byte, nullptr));
+            poDstDS->SetGeoTransform(adfWarpGeoTransform);
+            psWO = GDALCreateWarpOptions();
+            psWO->hSrcDS = GDALDataset::ToHandle(poSrcDS.get());
+            psWO->hDstDS = GDALDataset::ToHandle(poDstDS.get());
+            psWO->nBandCount = 1;
+            psWO->panSrcBands = static_cast<int*>(CPLMalloc(sizeof(int)));
+            psWO->panSrcBands[0] = 1;
+            psWO->panDstBands = static_cast<int*>(CPLMalloc(sizeof(int)));
+            psWO->panDstBands[0] = 1;
+            psWO->pfnTransformer = GDALGenImgProjTransform;
+            psWO->pTransformerArg = GDALCreateGenImgProjTransformer2(
+                psWO->hSrcDS, psWO->hDstDS, nullptr);
+            ensure( psWO->pTransformerArg != nullptr );
+            psWO->dfWarpMemoryLimit = 100000;
+            psWO->hCutline = OGR_G_Clone(hCutline);
+            {
+                GDALWarpOperation oWO;
+                ensure_equals( oWO.Initialize(psWO), CE_None );
+                ensure_equals( oWO.ChunkAndWarpImage(0, 0, nSize, nSize),
+                               CE_None );
+            }
+            GDALDestroyGenImgProjTransformer(psWO->pTransformerArg);
+            GDALDestroyWarpOptions(psWO);
+            std::vector<GByte> abyWarped(nSize * nSize);
+            ensure_equals( poDstDS->GetRasterBand(1)->RasterIO(GF_Read,
+                0, 0, nSize, nSize, abyWarped.data(), nSize, nSize, GDT_Byte,
+                0, 0, nullptr), CE_None );
+            ensure( abyWarped == abyRef );
+
+            OGR_G_DestroyGeometry(hCutline);
+        }
+    }
+
 
 } // namespace tut
@@ -41,12 +41,19 @@
 #include "cpl_json_streaming_parser.h"
 #include "cpl_json_streaming_writer.h"
 #include "cpl_mem_cache.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_http.h"
 #include "cpl_auto_close.h"
+#include "cpl_compressor.h"
 #include "cpl_minixml.h"
+#include "cpl_numa.h"
+#include "cpl_trace.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <limits>
 #include <string>
 
 static bool gbGotError = false;
@@ -71,7 +78,7 @@ namespace tut
     };
 
     // Register test group
-    typedef test_group<test_cpl_data> group;
+    typedef test_group<test_cpl_data, 100> group;
     typedef group::object object;
     group test_cpl_group("CPL");
 
@@ -3089,4 +3096,739 @@ namespace tut
         VSIUnlink("/vsimem/.gdal/gdalrc");
     }
 
+    // Test nested CPLJobQueue
+    template<>
+    template<>
+    void object::test<45>()
+    {
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(2, nullptr, nullptr));
+
+        struct OuterJob
+        {
+            CPLWorkerThreadPool* poPool = nullptr;
+            std::vector<int> res{};
+        };
+
+        // Each job waits for jobs it submits to its own queue. With more
+        // outer jobs than threads, this requires waiting threads to run
+        // pending inner jobs.
+        const auto outerJob = [](void* pData)
+        {
+            const auto innerJob = [](void* pDataInner)
+            {
+                (*static_cast<int*>(pDataInner))++;
+            };
+
+            OuterJob* psJob = static_cast<OuterJob*>(pData);
+            auto jobQueue = psJob->poPool->CreateJobQueue();
+            for( int i = 0; i < 100; i++ )
+            {
+                psJob->res[i] = i;
+                jobQueue->SubmitJob(innerJob, &psJob->res[i]);
+            }
+            jobQueue->WaitCompletion();
+        };
+
+        std::vector<OuterJob> outerJobs(10);
+        auto jobQueue = oPool.CreateJobQueue();
+        for( auto& job: outerJobs )
+        {
+            job.poPool = &oPool;
+            job.res.resize(100);
+            jobQueue->SubmitJob(outerJob, &job);
+        }
+        jobQueue->WaitCompletion();
+        for( const auto& job: outerJobs )
+        {
+            for( int i = 0; i < 100; i++ )
+            {
+                ensure_equals(job.res[i], i + 1);
+            }
+        }
+    }
+
+    // Test CPLGetConfigOption() while other threads set options
+    template<>
+    template<>
+    void object::test<46>()
+    {
+        CPLSetConfigOption("TEST_CONFIG_OPTION_STABLE", "YES");
+
+        struct ReaderJob
+        {
+            std::atomic<bool>* pbStop = nullptr;
+            bool bOK = true;
+        };
+
+        const auto readerJob = [](void* pData)
+        {
+            ReaderJob* psJob = static_cast<ReaderJob*>(pData);
+            // Values of keys that are not set again must remain valid
+            const char* pszStable =
+                CPLGetConfigOption("TEST_CONFIG_OPTION_STABLE", nullptr);
+            while( !*(psJob->pbStop) )
+            {
+                const char* pszVal =
+                    CPLGetConfigOption("TEST_CONFIG_OPTION_STABLE", nullptr);
+                if( pszVal == nullptr || !EQUAL(pszVal, "YES") ||
+                    !EQUAL(pszStable, "YES") )
+                {
+                    psJob->bOK = false;
+                }
+                pszVal = CPLGetConfigOption("TEST_CONFIG_OPTION_0", "default");
+                if( !EQUAL(pszVal, "default") && !STARTS_WITH(pszVal, "val") )
+                    psJob->bOK = false;
+            }
+        };
+
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(4, nullptr, nullptr));
+        std::atomic<bool> bStop{false};
+        std::vector<ReaderJob> jobs(4);
+        for( auto& job: jobs )
+        {
+            job.pbStop = &bStop;
+            oPool.SubmitJob(readerJob, &job);
+        }
+        for( int i = 0; i < 1000; i++ )
+        {
+            const std::string osKey(
+                CPLSPrintf("TEST_CONFIG_OPTION_%d", i % 5));
+            const std::string osVal(CPLSPrintf("val%d", i));
+            CPLSetConfigOption(osKey.c_str(),
+                               (i % 3) == 0 ? nullptr : osVal.c_str());
+        }
+        bStop = true;
+        oPool.WaitCompletion();
+        for( const auto& job: jobs )
+        {
+            ensure(job.bOK);
+        }
+
+        for( int i = 0; i < 5; i++ )
+        {
+            CPLSetConfigOption(CPLSPrintf("TEST_CONFIG_OPTION_%d", i), nullptr);
+        }
+        CPLSetConfigOption("TEST_CONFIG_OPTION_STABLE", nullptr);
+        ensure(CPLGetConfigOption("TEST_CONFIG_OPTION_STABLE", nullptr) == nullptr);
+    }
+
+    // Test CPLTraceSpan and CPLTraceExport()
+    template<>
+    template<>
+    void object::test<47>()
+    {
+        CPLTraceSetEnabled(FALSE);
+        CPLTraceClear();
+        {
+            CPLTraceSpan oSpan("test", "NotRecorded");
+            ensure(!oSpan.IsActive());
+        }
+
+        CPLTraceSetEnabled(TRUE);
+        {
+            CPLTraceSpan oSpan("test", "Outer");
+            ensure(oSpan.IsActive());
+            oSpan.SetDetailf("detail %d", 1);
+            {
+                CPLTraceSpan oSpanInner("test", "Inner");
+                oSpanInner.SetName("Renamed");
+            }
+        }
+        CPLTraceSetEnabled(FALSE);
+
+        ensure(CPLTraceExport("/vsimem/trace.json"));
+        CPLJSONDocument oDoc;
+        ensure(oDoc.Load("/vsimem/trace.json"));
+        VSIUnlink("/vsimem/trace.json");
+        const auto oEvents = oDoc.GetRoot().GetArray("traceEvents");
+        ensure_equals(oEvents.Size(), 2);
+        // Inner span finishes first
+        ensure_equals(oEvents[0].GetString("name"), "Renamed");
+        ensure_equals(oEvents[1].GetString("name"), "Outer");
+        ensure_equals(oEvents[1].GetString("cat"), "test");
+        ensure_equals(oEvents[1].GetString("ph"), "X");
+        ensure_equals(oEvents[1].GetString("args/detail"), "detail 1");
+        ensure(oEvents[1].GetLong("ts") <= oEvents[0].GetLong("ts"));
+        ensure(oEvents[1].GetLong("dur") >= oEvents[0].GetLong("dur"));
+
+        CPLTraceClear();
+        ensure(CPLTraceExport("/vsimem/trace.json"));
+        ensure(oDoc.Load("/vsimem/trace.json"));
+        VSIUnlink("/vsimem/trace.json");
+        ensure_equals(oDoc.GetRoot().GetArray("traceEvents").Size(), 0);
+    }
+
+    // Test CPLWorkerThreadPool statistics
+    template<>
+    template<>
+    void object::test<48>()
+    {
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(2, nullptr, nullptr));
+        ensure_equals(oPool.GetQueuedJobCount(), 0);
+        ensure_equals(oPool.GetCompletedJobCount(), 0);
+        ensure_equals(oPool.GetBusyTimeMicroSec(), 0);
+
+        const auto job = [](void*)
+        {
+            CPLSleep(0.01);
+        };
+        for( int i = 0; i < 10; i++ )
+        {
+            ensure(oPool.SubmitJob(job, nullptr));
+        }
+        oPool.WaitCompletion();
+        ensure_equals(oPool.GetQueuedJobCount(), 0);
+        ensure_equals(oPool.GetCompletedJobCount(), 10);
+        ensure(oPool.GetBusyTimeMicroSec() >= 10 * 10000);
+    }
+
+    // Test CPLPackedRTree
+    template<>
+    template<>
+    void object::test<49>()
+    {
+        const auto BruteForceSearch = [](const std::vector<CPLRectObj>& asRects,
+                                         const CPLRectObj& sAoi)
+        {
+            std::vector<int> anRes;
+            for( int i = 0; i < static_cast<int>(asRects.size()); i++ )
+            {
+                if( !(sAoi.maxx < asRects[i].minx || sAoi.maxy < asRects[i].miny ||
+                      sAoi.minx > asRects[i].maxx || sAoi.miny > asRects[i].maxy) )
+                    anRes.push_back(i);
+            }
+            return anRes;
+        };
+        const auto Search = [](const CPLPackedRTree* hTree,
+                               const CPLRectObj& sAoi)
+        {
+            int nCount = 0;
+            int* panRes = CPLPackedRTreeSearch(hTree, &sAoi, &nCount);
+            std::vector<int> anRes(panRes, panRes + nCount);
+            CPLFree(panRes);
+            std::sort(anRes.begin(), anRes.end());
+            return anRes;
+        };
+
+        // Empty tree
+        {
+            CPLPackedRTree* hTree = CPLPackedRTreeCreate(0, nullptr, 0);
+            ensure(hTree != nullptr);
+            CPLRectObj sAoi = { -1, -1, 1, 1 };
+            ensure(Search(hTree, sAoi).empty());
+            int nCount = -1;
+            ensure(CPLPackedRTreeNearest(hTree, 0, 0, 1, 0, &nCount) == nullptr);
+            ensure_equals(nCount, 0);
+            CPLPackedRTreeDestroy(hTree);
+        }
+
+        // NaN bounds are rejected, infinite ones are accepted
+        {
+            const double dfNaN = std::numeric_limits<double>::quiet_NaN();
+            const double dfInf = std::numeric_limits<double>::infinity();
+            CPLRectObj asBadRects[] = { { 0, 0, 1, 1 },
+                                        { dfNaN, 0, 1, 1 } };
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            ensure(CPLPackedRTreeCreate(2, asBadRects, 0) == nullptr);
+            CPLPopErrorHandler();
+
+            CPLRectObj asInfRects[] = { { 0, 0, 1, 1 },
+                                        { -dfInf, -dfInf, dfInf, dfInf },
+                                        { 2, 2, dfInf, 3 } };
+            CPLPackedRTree* hTree = CPLPackedRTreeCreate(3, asInfRects, 0);
+            ensure(hTree != nullptr);
+            CPLRectObj sAoi = { 0.5, 0.5, 0.6, 0.6 };
+            ensure_equals(Search(hTree, sAoi).size(), 2U);
+            CPLPackedRTreeDestroy(hTree);
+        }
+
+        std::vector<CPLRectObj> asRects;
+        for( int j = 0; j < 50; j++ )
+        {
+            for( int i = 0; i < 70; i++ )
+            {
+                CPLRectObj sRect = { i * 10.0, j * 10.0,
+                                     i * 10.0 + (i + j) % 15, j * 10.0 + 1 };
+                asRects.push_back(sRect);
+            }
+        }
+        CPLPackedRTree* hTree = CPLPackedRTreeCreate(
+            static_cast<int>(asRects.size()), asRects.data(), 5);
+        ensure(hTree != nullptr);
+        ensure_equals(CPLPackedRTreeGetItemCount(hTree),
+                      static_cast<int>(asRects.size()));
+        CPLRectObj sBounds;
+        CPLPackedRTreeGetBounds(hTree, &sBounds);
+        ensure_equals(sBounds.minx, 0.0);
+        ensure_equals(sBounds.miny, 0.0);
+        ensure_equals(sBounds.maxx, 69 * 10.0 + 14);
+        ensure_equals(sBounds.maxy, 491.0);
+
+        const CPLRectObj asAois[] = { { -10, -10, -5, -5 },
+                                      { 0, 0, 0, 0 },
+                                      { 15, 15, 55.5, 33 },
+                                      { 100, -100, 101, 1000 },
+                                      { -1000, -1000, 1000, 1000 } };
+        for( const auto& sAoi: asAois )
+        {
+            ensure(Search(hTree, sAoi) == BruteForceSearch(asRects, sAoi));
+        }
+
+        // Stop the iteration after the first item found
+        int nCalls = 0;
+        CPLPackedRTreeForeach(hTree, &asAois[4],
+            [](int, void* pUserData)
+            {
+                ++(*static_cast<int*>(pUserData));
+                return FALSE;
+            }, &nCalls);
+        ensure_equals(nCalls, 1);
+
+        // Nearest items
+        {
+            int nCount = 0;
+            int* panRes = CPLPackedRTreeNearest(hTree, 4, 3, 3, 0, &nCount);
+            ensure_equals(nCount, 3);
+            // Squared distances: 20 for item 0, 40 for item 1, 58 for
+            // item 70 and 85 for item 71
+            ensure_equals(panRes[0], 0);
+            ensure_equals(panRes[1], 1);
+            ensure_equals(panRes[2], 70);
+            CPLFree(panRes);
+
+            panRes = CPLPackedRTreeNearest(hTree, 10.5, 0.5, 10, 0.1, &nCount);
+            ensure_equals(nCount, 1);
+            ensure_equals(panRes[0], 1);
+            CPLFree(panRes);
+
+            ensure(CPLPackedRTreeNearest(hTree, -100, -100, 1, 10,
+                                         &nCount) == nullptr);
+            ensure_equals(nCount, 0);
+        }
+
+        // Serialization
+        ensure(CPLPackedRTreeSave(hTree, "/vsimem/test.rtree"));
+        CPLPackedRTree* hTree2 = CPLPackedRTreeLoad("/vsimem/test.rtree");
+        ensure(hTree2 != nullptr);
+        for( const auto& sAoi: asAois )
+        {
+            ensure(Search(hTree2, sAoi) == BruteForceSearch(asRects, sAoi));
+        }
+        CPLPackedRTreeDestroy(hTree2);
+        CPLPackedRTreeDestroy(hTree);
+
+        // Corrupted file
+        {
+            VSILFILE* fp = VSIFOpenL("/vsimem/test.rtree", "rb+");
+            ensure(fp != nullptr);
+            VSIFSeekL(fp, 0, SEEK_END);
+            // Last index is the one of the root, pointing to the first
+            // entry of the level below
+            VSIFSeekL(fp, VSIFTellL(fp) - sizeof(int), SEEK_SET);
+            const int nVal = 1;
+            VSIFWriteL(&nVal, sizeof(nVal), 1, fp);
+            VSIFCloseL(fp);
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            ensure(CPLPackedRTreeLoad("/vsimem/test.rtree") == nullptr);
+            ensure(CPLPackedRTreeLoad("/vsimem/i_do_not_exist.rtree") == nullptr);
+            CPLPopErrorHandler();
+            VSIUnlink("/vsimem/test.rtree");
+        }
+
+        // Multi-threaded construction must give the same tree as the
+        // single-threaded one
+        asRects.clear();
+        for( int i = 0; i < 200000; i++ )
+        {
+            const double dfX = (i * 7919) % 1000;
+            const double dfY = (i * 104729) % 997;
+            CPLRectObj sRect = { dfX, dfY, dfX + i % 3, dfY + i % 5 };
+            asRects.push_back(sRect);
+        }
+        CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", "1");
+        hTree = CPLPackedRTreeCreate(
+            static_cast<int>(asRects.size()), asRects.data(), 0);
+        CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", "3");
+        hTree2 = CPLPackedRTreeCreate(
+            static_cast<int>(asRects.size()), asRects.data(), 0);
+        CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", nullptr);
+        ensure(hTree != nullptr);
+        ensure(hTree2 != nullptr);
+        ensure(CPLPackedRTreeSave(hTree, "/vsimem/test1.rtree"));
+        ensure(CPLPackedRTreeSave(hTree2, "/vsimem/test2.rtree"));
+        vsi_l_offset nSize1 = 0;
+        vsi_l_offset nSize2 = 0;
+        GByte* pabyData1 = VSIGetMemFileBuffer("/vsimem/test1.rtree", &nSize1, FALSE);
+        GByte* pabyData2 = VSIGetMemFileBuffer("/vsimem/test2.rtree", &nSize2, FALSE);
+        ensure_equals(nSize1, nSize2);
+        ensure(memcmp(pabyData1, pabyData2, static_cast<size_t>(nSize1)) == 0);
+        VSIUnlink("/vsimem/test1.rtree");
+        VSIUnlink("/vsimem/test2.rtree");
+        const CPLRectObj sAoi = { 100, 200, 120, 230 };
+        ensure(Search(hTree2, sAoi) == BruteForceSearch(asRects, sAoi));
+        CPLPackedRTreeDestroy(hTree);
+        CPLPackedRTreeDestroy(hTree2);
+    }
+
+    // Test compressor registry
+    template<>
+    template<>
+    void object::test<50>()
+    {
+        char** papszCompressors = CPLGetCompressors();
+        ensure(CSLFindString(papszCompressors, "zlib") >= 0);
+        ensure(CSLFindString(papszCompressors, "gzip") >= 0);
+        ensure(CSLFindString(papszCompressors, "shuffle") >= 0);
+        ensure(CSLFindString(papszCompressors, "bitshuffle") >= 0);
+        CSLDestroy(papszCompressors);
+        ensure(CPLGetCompressor("invalid") == nullptr);
+        ensure(CPLGetDecompressor("invalid") == nullptr);
+
+        std::vector<GByte> abyIn(10000);
+        for( size_t i = 0; i < abyIn.size(); ++i )
+            abyIn[i] = static_cast<GByte>((i / 7) % 13);
+
+        for( const char* pszId: { "zlib", "gzip" } )
+        {
+            const CPLCompressor* psComp = CPLGetCompressor(pszId);
+            const CPLCompressor* psDecomp = CPLGetDecompressor(pszId);
+            ensure(psComp != nullptr);
+            ensure(psDecomp != nullptr);
+            ensure_equals(psComp->eType, CCT_COMPRESSOR);
+
+            // Compression into an allocated buffer
+            void* pCompressed = nullptr;
+            size_t nCompressedSize = 0;
+            const char* const apszOptions[] = { "LEVEL=9", nullptr };
+            ensure(psComp->pfnFunc(abyIn.data(), abyIn.size(),
+                                   &pCompressed, &nCompressedSize,
+                                   apszOptions, psComp->user_data));
+            ensure(pCompressed != nullptr);
+            ensure(nCompressedSize < abyIn.size() / 10);
+
+            // Decompression into a user provided buffer
+            std::vector<GByte> abyOut(abyIn.size());
+            void* pOut = abyOut.data();
+            size_t nOutSize = abyOut.size();
+            ensure(psDecomp->pfnFunc(pCompressed, nCompressedSize,
+                                     &pOut, &nOutSize,
+                                     nullptr, psDecomp->user_data));
+            ensure_equals(nOutSize, abyIn.size());
+            ensure(abyOut == abyIn);
+
+            // Too small output buffer
+            nOutSize = abyIn.size() / 2;
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            const bool bRetSmallBuffer =
+                psDecomp->pfnFunc(pCompressed, nCompressedSize,
+                                  &pOut, &nOutSize,
+                                  nullptr, psDecomp->user_data);
+            CPLPopErrorHandler();
+            ensure(!bRetSmallBuffer);
+
+            // Decompression into an allocated buffer
+            void* pAllocOut = nullptr;
+            nOutSize = 0;
+            ensure(psDecomp->pfnFunc(pCompressed, nCompressedSize,
+                                     &pAllocOut, &nOutSize,
+                                     nullptr, psDecomp->user_data));
+            ensure_equals(nOutSize, abyIn.size());
+            ensure(memcmp(pAllocOut, abyIn.data(), nOutSize) == 0);
+            VSIFree(pAllocOut);
+
+            // Query of the compressed size upper bound
+            size_t nMaxSize = 0;
+            ensure(psComp->pfnFunc(abyIn.data(), abyIn.size(),
+                                   nullptr, &nMaxSize,
+                                   nullptr, psComp->user_data));
+            ensure(nMaxSize >= nCompressedSize);
+            VSIFree(pCompressed);
+        }
+
+        // Filters, with an element size and a buffer size that are not
+        // a power of two, nor a multiple of each other.
+        for( const char* pszId: { "shuffle", "bitshuffle" } )
+        {
+            const CPLCompressor* psComp = CPLGetCompressor(pszId);
+            const CPLCompressor* psDecomp = CPLGetDecompressor(pszId);
+            ensure(psComp != nullptr);
+            ensure(psDecomp != nullptr);
+            ensure_equals(psComp->eType, CCT_FILTER);
+            for( const char* pszEltSize: { "ELEMENTSIZE=1", "ELEMENTSIZE=2",
+                                           "ELEMENTSIZE=3", "ELEMENTSIZE=4",
+                                           "ELEMENTSIZE=8" } )
+            {
+                const char* const apszOptions[] = { pszEltSize, nullptr };
+                std::vector<GByte> abyFiltered(abyIn.size() - 1);
+                void* pFiltered = abyFiltered.data();
+                size_t nFilteredSize = abyFiltered.size();
+                ensure(psComp->pfnFunc(abyIn.data(), abyIn.size() - 1,
+                                       &pFiltered, &nFilteredSize,
+                                       apszOptions, psComp->user_data));
+                ensure_equals(nFilteredSize, abyIn.size() - 1);
+                std::vector<GByte> abyOut(abyIn.size() - 1);
+                void* pOut = abyOut.data();
+                size_t nOutSize = abyOut.size();
+                ensure(psDecomp->pfnFunc(abyFiltered.data(), nFilteredSize,
+                                         &pOut, &nOutSize,
+                                         apszOptions, psDecomp->user_data));
+                ensure(memcmp(abyOut.data(), abyIn.data(), nOutSize) == 0);
+            }
+        }
+
+        // Check the byte shuffle layout
+        {
+            const GByte abyData[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+            GByte abyRes[9] = { 0 };
+            void* pOut = abyRes;
+            size_t nOutSize = sizeof(abyRes);
+            const char* const apszOptions[] = { "ELEMENTSIZE=4", nullptr };
+            const CPLCompressor* psComp = CPLGetCompressor("shuffle");
+            ensure(psComp->pfnFunc(abyData, sizeof(abyData), &pOut, &nOutSize,
+                                   apszOptions, psComp->user_data));
+            const GByte abyExpected[] = { 1, 5, 2, 6, 3, 7, 4, 8, 9 };
+            ensure(memcmp(abyRes, abyExpected, sizeof(abyRes)) == 0);
+        }
+
+        // Check the bit shuffle layout against a naive implementation
+        {
+            constexpr int ELT_SIZE = 2;
+            constexpr int NELTS = 16;
+            std::vector<GByte> abyData(ELT_SIZE * NELTS);
+            for( size_t i = 0; i < abyData.size(); ++i )
+                abyData[i] = static_cast<GByte>(i * 37 + 11);
+            std::vector<GByte> abyExpected(abyData.size());
+            // Groups of 8 elements: for each byte of the element, and each
+            // bit of that byte, pack the bit of the 8 elements in a byte.
+            for( int iGroup = 0; iGroup < NELTS / 8; ++iGroup )
+            {
+                for( int iByte = 0; iByte < ELT_SIZE; ++iByte )
+                {
+                    for( int iBit = 0; iBit < 8; ++iBit )
+                    {
+                        GByte byVal = 0;
+                        for( int iElt = 0; iElt < 8; ++iElt )
+                        {
+                            const GByte bySrc = abyData[
+                                (iGroup * 8 + iElt) * ELT_SIZE + iByte];
+                            if( bySrc & (1 << iBit) )
+                                byVal |= static_cast<GByte>(1 << iElt);
+                        }
+                        abyExpected[(iByte * 8 + iBit) * (NELTS / 8) +
+                                    iGroup] = byVal;
+                    }
+                }
+            }
+            std::vector<GByte> abyRes(abyData.size());
+            void* pOut = abyRes.data();
+            size_t nOutSize = abyRes.size();
+            const char* const apszOptions[] = { "ELEMENTSIZE=2", nullptr };
+            const CPLCompressor* psComp = CPLGetCompressor("bitshuffle");
+            ensure(psComp->pfnFunc(abyData.data(), abyData.size(),
+                                   &pOut, &nOutSize,
+                                   apszOptions, psComp->user_data));
+            ensure(abyRes == abyExpected);
+        }
+
+        // Compression of several buffers in parallel
+        {
+            const CPLCompressor* psComp = CPLGetCompressor("zlib");
+            const CPLCompressor* psDecomp = CPLGetDecompressor("zlib");
+            constexpr size_t N_BUFFERS = 10;
+            std::vector<const void*> apInput(N_BUFFERS, abyIn.data());
+            std::vector<size_t> anInputSize(N_BUFFERS);
+            for( size_t i = 0; i < N_BUFFERS; ++i )
+                anInputSize[i] = abyIn.size() - i * 100;
+            std::vector<void*> apOutput(N_BUFFERS, nullptr);
+            std::vector<size_t> anOutputSize(N_BUFFERS, 0);
+            ensure(CPLCompressorRunMultiple(psComp, N_BUFFERS,
+                                            apInput.data(), anInputSize.data(),
+                                            apOutput.data(), anOutputSize.data(),
+                                            nullptr, 4));
+            for( size_t i = 0; i < N_BUFFERS; ++i )
+            {
+                void* pOut = nullptr;
+                size_t nOutSize = 0;
+                ensure(apOutput[i] != nullptr);
+                ensure(psDecomp->pfnFunc(apOutput[i], anOutputSize[i],
+                                         &pOut, &nOutSize,
+                                         nullptr, psDecomp->user_data));
+                ensure_equals(nOutSize, anInputSize[i]);
+                ensure(memcmp(pOut, abyIn.data(), nOutSize) == 0);
+                VSIFree(pOut);
+                VSIFree(apOutput[i]);
+            }
+        }
+
+        // Registration of a custom compressor
+        {
+            const auto myCompressor = [](const void* input_data,
+                                         size_t input_size,
+                                         void** output_data,
+                                         size_t* output_size,
+                                         CSLConstList,
+                                         void* user_data)
+            {
+                if( output_data == nullptr || *output_data == nullptr ||
+                    *output_size < input_size )
+                    return false;
+                memcpy(*output_data, input_data, input_size);
+                *output_size = input_size;
+                ++(*static_cast<int*>(user_data));
+                return true;
+            };
+            int nCalls = 0;
+            CPLCompressor sComp;
+            sComp.nStructVersion = 1;
+            sComp.pszId = "test_cpl_copy";
+            sComp.eType = CCT_FILTER;
+            sComp.papszMetadata = nullptr;
+            sComp.pfnFunc = myCompressor;
+            sComp.user_data = &nCalls;
+            ensure(CPLRegisterCompressor(&sComp));
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            ensure(!CPLRegisterCompressor(&sComp));
+            sComp.pszId = "zlib";
+            ensure(!CPLRegisterCompressor(&sComp));
+            CPLPopErrorHandler();
+
+            const CPLCompressor* psComp = CPLGetCompressor("test_cpl_copy");
+            ensure(psComp != nullptr);
+            GByte abyOut[3] = { 0 };
+            void* pOut = abyOut;
+            size_t nOutSize = sizeof(abyOut);
+            ensure(psComp->pfnFunc("abc", 3, &pOut, &nOutSize,
+                                   nullptr, psComp->user_data));
+            ensure_equals(nCalls, 1);
+            ensure(memcmp(abyOut, "abc", 3) == 0);
+        }
+    }
+
+    // Test VSIMallocLarge() and NUMA functions
+    template<>
+    template<>
+    void object::test<51>()
+    {
+        ensure(CPLGetNUMANodeCount() >= 1);
+        ensure(CPLGetCurrentNUMANode() < CPLGetNUMANodeCount());
+        ensure(!CPLBindCurrentThreadToNUMANode(-1));
+        ensure(!CPLBindCurrentThreadToNUMANode(CPLGetNUMANodeCount()));
+
+        for( const char* pszHugePages: { "NO", "TRANSPARENT", "EXPLICIT" } )
+        {
+            for( const char* pszNUMA: { "NO", "YES" } )
+            {
+                CPLSetThreadLocalConfigOption("CPL_HUGE_PAGES", pszHugePages);
+                CPLSetThreadLocalConfigOption("CPL_NUMA_LOCAL_ALLOC", pszNUMA);
+                for( size_t nSize: { static_cast<size_t>(0),
+                                     static_cast<size_t>(1),
+                                     static_cast<size_t>(100 * 1000),
+                                     static_cast<size_t>(2 * 1024 * 1024),
+                                     static_cast<size_t>(5 * 1024 * 1024 + 1) } )
+                {
+                    GByte* pabyBuffer =
+                        static_cast<GByte*>(VSIMallocLarge(nSize));
+                    ensure(pabyBuffer != nullptr || nSize == 0);
+                    ensure_equals(
+                        reinterpret_cast<size_t>(pabyBuffer) % 64, 0U);
+#if defined(__linux__) && defined(__x86_64__)
+                    // Huge page buffers start on a huge page boundary
+                    if( EQUAL(pszHugePages, "TRANSPARENT") &&
+                        nSize >= 2 * 1024 * 1024 )
+                    {
+                        ensure_equals(reinterpret_cast<size_t>(pabyBuffer) %
+                                          (2 * 1024 * 1024), 0U);
+                    }
+#endif
+                    if( nSize )
+                    {
+                        memset(pabyBuffer, 1, nSize);
+                        ensure_equals(pabyBuffer[nSize - 1], 1);
+                    }
+                    VSIFreeLarge(pabyBuffer);
+                }
+            }
+        }
+        CPLSetThreadLocalConfigOption("CPL_HUGE_PAGES", nullptr);
+        CPLSetThreadLocalConfigOption("CPL_NUMA_LOCAL_ALLOC", nullptr);
+        VSIFreeLarge(nullptr);
+
+        // Worker threads pinning
+        for( const char* pszPinning: { "NUMA", "CPU" } )
+        {
+            CPLSetThreadLocalConfigOption("GDAL_THREAD_PINNING", pszPinning);
+            CPLWorkerThreadPool oPool;
+            ensure(oPool.Setup(3, nullptr, nullptr));
+            CPLSetThreadLocalConfigOption("GDAL_THREAD_PINNING", nullptr);
+            std::atomic<int> nCounter{0};
+            const auto Job = [](void* pData)
+            {
+                ++(*static_cast<std::atomic<int>*>(pData));
+            };
+            for( int i = 0; i < 10; ++i )
+                oPool.SubmitJob(Job, &nCounter);
+            oPool.WaitCompletion();
+            ensure_equals(nCounter.load(), 10);
+        }
+    }
+
+    // Test that CPLWorkerThreadPool::WaitCompletion() does not return
+    // while jobs submitted by worker threads, and stolen by other worker
+    // threads, are still pending
+    template<>
+    template<>
+    void object::test<52>()
+    {
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(4, nullptr, nullptr));
+
+        struct Context
+        {
+            CPLWorkerThreadPool* poPool = nullptr;
+            std::atomic<int> nStarted{0};
+            std::atomic<int> nFinished{0};
+        };
+
+        static const auto innerJob = [](void* pData)
+        {
+            Context* psContext = static_cast<Context*>(pData);
+            psContext->nFinished++;
+        };
+
+        // Each outer job submits inner jobs to the pool, which idle worker
+        // threads may steal and complete before the outer job returns.
+        const auto outerJob = [](void* pData)
+        {
+            Context* psContext = static_cast<Context*>(pData);
+            for( int i = 0; i < 20; i++ )
+            {
+                psContext->nStarted++;
+                psContext->poPool->SubmitJob(innerJob, psContext);
+                if( (i % 5) == 0 )
+                {
+                    std::vector<void*> apData(3, psContext);
+                    psContext->nStarted += 3;
+                    psContext->poPool->SubmitJobs(innerJob, apData);
+                }
+            }
+            psContext->nFinished++;
+        };
+
+        for( int iIter = 0; iIter < 200; iIter++ )
+        {
+            Context sContext;
+            sContext.poPool = &oPool;
+            sContext.nStarted = 2;
+            oPool.SubmitJob(outerJob, &sContext);
+            oPool.SubmitJob(outerJob, &sContext);
+            oPool.WaitCompletion();
+            ensure_equals(sContext.nFinished.load(), sContext.nStarted.load());
+        }
+        // The pending job count must not have gone negative
+        oPool.SubmitJob(innerJob, nullptr);
+    }
+
 } // namespace tut
@@ -34,6 +34,11 @@
 #include <limits>
 #include <string>
 
+#ifndef _WIN32
+#include <sys/types.h>
+#include <utime.h>
+#endif
+
 #include "test_data.h"
 
 namespace tut
@@ -1676,4 +1681,331 @@ namespace tut
         poDS.reset();
         VSIUnlink("/vsimem/tmp.pix");
     }
+
+    // Test GDALGetRuntimeStatistics() and related functions
+    template<> template<> void object::test<22>()
+    {
+        const auto GetCounter = [](CSLConstList papszList, const char* pszKey)
+        {
+            const char* pszVal = CSLFetchNameValue(papszList, pszKey);
+            return pszVal ? CPLAtoGIntBig(pszVal) : -1;
+        };
+
+        GDALDriverH hDrv = GDALGetDriverByName("MEM");
+        char** papszDrvStatsBefore = GDALGetDriverRuntimeStatistics(hDrv);
+        char** papszStatsBefore = GDALGetRuntimeStatistics();
+        ensure( GetCounter(papszStatsBefore, "BLOCK_CACHE_HITS") >= 0 );
+        ensure( GetCounter(papszStatsBefore, "BLOCK_CACHE_MAX") > 0 );
+        ensure( GetCounter(papszStatsBefore, "VSICURL_REGION_CACHE_HITS") >= 0 );
+        ensure( GetCounter(papszStatsBefore, "PROXY_POOL_OPENS") >= 0 );
+        ensure( GetCounter(papszStatsBefore, "OGR_CT_CACHE_HITS") >= 0 );
+        ensure( GetCounter(papszStatsBefore, "THREAD_POOL_BUSY_TIME_US") >= 0 );
+
+        {
+            GDALDatasetUniquePtr poDS(GDALDriver::FromHandle(hDrv)->Create(
+                "", 10, 10, 1, GDT_Byte, nullptr));
+            ensure( poDS != nullptr );
+            auto poBand = poDS->GetRasterBand(1);
+
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, 0);
+            ensure( poBlock != nullptr );
+            poBlock->MarkDirty();
+            poBlock->DropLock();
+
+            poBlock = poBand->GetLockedBlockRef(0, 0);
+            ensure( poBlock != nullptr );
+            poBlock->DropLock();
+
+            poDS->FlushCache();
+
+            char** papszDSStats = GDALDatasetGetRuntimeStatistics(
+                GDALDataset::ToHandle(poDS.get()));
+            ensure_equals( GetCounter(papszDSStats, "BLOCK_CACHE_MISSES"), 1 );
+            ensure_equals( GetCounter(papszDSStats, "BLOCK_CACHE_HITS"), 1 );
+            ensure_equals( GetCounter(papszDSStats, "BLOCK_CACHE_DIRTY_FLUSHES"), 1 );
+            CSLDestroy(papszDSStats);
+        }
+
+        char** papszDrvStatsAfter = GDALGetDriverRuntimeStatistics(hDrv);
+        ensure_equals( GetCounter(papszDrvStatsAfter, "BLOCK_CACHE_MISSES") -
+                       GetCounter(papszDrvStatsBefore, "BLOCK_CACHE_MISSES"), 1 );
+        ensure_equals( GetCounter(papszDrvStatsAfter, "BLOCK_CACHE_HITS") -
+                       GetCounter(papszDrvStatsBefore, "BLOCK_CACHE_HITS"), 1 );
+        char** papszStatsAfter = GDALGetRuntimeStatistics();
+        ensure( GetCounter(papszStatsAfter, "BLOCK_CACHE_HITS") >
+                GetCounter(papszStatsBefore, "BLOCK_CACHE_HITS") );
+        CSLDestroy(papszDrvStatsBefore);
+        CSLDestroy(papszDrvStatsAfter);
+        CSLDestroy(papszStatsBefore);
+        CSLDestroy(papszStatsAfter);
+    }
+
+    // Test GDALDriver::SetDeferredInit()
+    template<> template<> void object::test<23>()
+    {
+        int nInitCount = 0;
+        GDALDriver* poDriver = new GDALDriver();
+        poDriver->SetDescription("TEST_DEFERRED_INIT");
+        poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+        poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "Test");
+        poDriver->SetDeferredInit(
+            [&nInitCount](GDALDriver* poDriverIn)
+            {
+                nInitCount ++;
+                poDriverIn->SetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST,
+                                            "<CreationOptionList/>");
+                poDriverIn->SetMetadataItem("FOO", "BAR", "OTHER_DOMAIN");
+            });
+        GetGDALDriverManager()->RegisterDriver(poDriver);
+        const bool bLazy = CPLTestBool(
+            CPLGetConfigOption("GDAL_LAZY_DRIVER_REGISTRATION", "YES"));
+
+        ensure_equals( std::string(poDriver->GetMetadataItem(GDAL_DMD_LONGNAME)),
+                       "Test" );
+        ensure( poDriver->GetMetadataItem(GDAL_DCAP_VECTOR) == nullptr );
+        ensure( poDriver->GetMetadataItem(GDAL_DCAP_CREATE) == nullptr );
+        ensure_equals( nInitCount, bLazy ? 0 : 1 );
+        ensure_equals( poDriver->HasPendingDeferredInit(), bLazy );
+
+        ensure_equals( std::string(poDriver->GetMetadataItem(
+                            GDAL_DMD_CREATIONOPTIONLIST)),
+                       "<CreationOptionList/>" );
+        ensure_equals( nInitCount, 1 );
+        ensure( !poDriver->HasPendingDeferredInit() );
+        ensure_equals( std::string(poDriver->GetMetadataItem(GDAL_DMD_LONGNAME)),
+                       "Test" );
+        ensure_equals( std::string(poDriver->GetMetadataItem(GDAL_DCAP_RASTER)),
+                       "YES" );
+        ensure_equals( std::string(poDriver->GetMetadataItem("FOO",
+                                                             "OTHER_DOMAIN")),
+                       "BAR" );
+        CPLStringList aosDomains(poDriver->GetMetadataDomainList());
+        ensure( aosDomains.FindString("OTHER_DOMAIN") >= 0 );
+
+        poDriver->SetMetadataItem("BAR", "BAZ");
+        ensure_equals( std::string(poDriver->GetMetadataItem("BAR")), "BAZ" );
+        ensure_equals( nInitCount, 1 );
+
+        GetGDALDriverManager()->DeregisterDriver(poDriver);
+        delete poDriver;
+    }
+
+    // Test caching of directory listings by GDALOpenInfo::GetSiblingFiles()
+    template<> template<> void object::test<24>()
+    {
+        CPLString osDir(CPLGenerateTempFilename("test_sibling_files"));
+        ensure( VSIMkdir(osDir, 0755) == 0 );
+        const auto CreateFile = [&osDir](const char* pszName)
+        {
+            VSILFILE* fp = VSIFOpenL(CPLFormFilename(osDir, pszName, nullptr),
+                                     "wb");
+            if( fp )
+                VSIFCloseL(fp);
+        };
+        CreateFile("b.tif");
+        CreateFile("A.tif");
+        CreateFile("c.TFW");
+        const std::string osFilename(CPLFormFilename(osDir, "b.tif", nullptr));
+#ifndef _WIN32
+        // Make the directory old enough for its listing to be cached
+        struct utimbuf sTimes;
+        sTimes.actime = time(nullptr) - 100;
+        sTimes.modtime = sTimes.actime;
+        ensure( utime(osDir, &sTimes) == 0 );
+#endif
+
+        {
+            GDALOpenInfo oOpenInfo(osFilename.c_str(), GA_ReadOnly);
+            char** papszSiblings = oOpenInfo.GetSiblingFiles();
+            // "." and ".." are listed
+            ensure_equals( CSLCount(papszSiblings), 5 );
+            ensure_equals( std::string(papszSiblings[2]), "A.tif" );
+            ensure_equals( std::string(papszSiblings[4]), "c.TFW" );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "a.TIF"), 2 );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "C.tfw"), 4 );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "b.tif.ovr"), -1 );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "0"), -1 );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "z"), -1 );
+
+#ifndef _WIN32
+            GDALOpenInfo oOpenInfo2(osFilename.c_str(), GA_ReadOnly);
+            ensure( oOpenInfo2.GetSiblingFiles() == papszSiblings );
+#endif
+
+            char** papszStolen = oOpenInfo.StealSiblingFiles();
+            ensure_equals( CSLCount(papszStolen), 5 );
+            ensure_equals( GDALFindSiblingFile(papszStolen, "c.tfw"), 4 );
+            CSLDestroy(papszStolen);
+        }
+
+        // Adding a file changes the modification time of the directory
+        CreateFile("d.tif");
+#ifndef _WIN32
+        sTimes.actime = time(nullptr) - 50;
+        sTimes.modtime = sTimes.actime;
+        ensure( utime(osDir, &sTimes) == 0 );
+#endif
+        {
+            GDALOpenInfo oOpenInfo(osFilename.c_str(), GA_ReadOnly);
+            char** papszSiblings = oOpenInfo.GetSiblingFiles();
+            ensure_equals( CSLCount(papszSiblings), 6 );
+            ensure_equals( GDALFindSiblingFile(papszSiblings, "D.TIF"), 5 );
+        }
+
+        {
+            CPLSetThreadLocalConfigOption("GDAL_READDIR_LIMIT_ON_OPEN", "2");
+            GDALOpenInfo oOpenInfo(osFilename.c_str(), GA_ReadOnly);
+            ensure( oOpenInfo.GetSiblingFiles() == nullptr );
+            CPLSetThreadLocalConfigOption("GDAL_READDIR_LIMIT_ON_OPEN", nullptr);
+        }
+
+        for( const char* pszName: { "A.tif", "b.tif", "c.TFW", "d.tif" } )
+            VSIUnlink(CPLFormFilename(osDir, pszName, nullptr));
+        VSIRmdir(osDir);
+    }
+
+    // Test recycling of block buffers
+    template<> template<> void object::test<25>()
+    {
+        const GIntBig nOldCacheMax = GDALGetCacheMax64();
+        GDALSetCacheMax64(10 * 1024 * 1024);
+        GDALRasterBlock::TrimRecycledBuffers(0);
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("MEM"));
+        {
+            GDALDatasetUniquePtr poDS(
+                poDrv->Create("", 1000, 100, 1, GDT_Byte, nullptr));
+            ensure( poDS != nullptr );
+            auto poBand = poDS->GetRasterBand(1);
+            for( int i = 0; i < 100; ++i )
+            {
+                GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+                ensure( poBlock != nullptr );
+                poBlock->DropLock();
+            }
+        }
+        // Blocks of the closed dataset are freed
+        ensure_equals( GDALRasterBlock::GetRecycledBuffersSize(), 0 );
+        {
+            // Buffers of evicted blocks are only kept within the cache size
+            // limit.
+            GDALSetCacheMax64(50 * 1000);
+            GDALDatasetUniquePtr poDS(
+                poDrv->Create("", 1000, 100, 1, GDT_Byte, nullptr));
+            GDALDatasetUniquePtr poDS2(
+                poDrv->Create("", 3000, 10, 1, GDT_Byte, nullptr));
+            for( int i = 0; i < 100; ++i )
+            {
+                GDALRasterBlock* poBlock =
+                    (i % 10 == 9 ? poDS2 : poDS)->GetRasterBand(1)->
+                        GetLockedBlockRef(0, i % 10 == 9 ? i / 10 : i);
+                ensure( poBlock != nullptr );
+                poBlock->DropLock();
+                ensure( GDALGetCacheUsed64() +
+                        GDALRasterBlock::GetRecycledBuffersSize() <=
+                        GDALGetCacheMax64() );
+            }
+        }
+
+        // Recycled buffers count against the cache size limit
+        GDALSetCacheMax64(GDALGetCacheUsed64());
+        ensure_equals( GDALRasterBlock::GetRecycledBuffersSize(), 0 );
+        GDALSetCacheMax64(nOldCacheMax);
+    }
+
+    // Test GDALDataset::SamplePoints()
+    template<> template<> void object::test<26>()
+    {
+        constexpr int nXSize = 200;
+        constexpr int nYSize = 100;
+        std::vector<float> afData(nXSize * nYSize);
+        for( int j = 0; j < nYSize; ++j )
+            for( int i = 0; i < nXSize; ++i )
+                afData[j * nXSize + i] = static_cast<float>(i + 1000 * j);
+        afData[nXSize + 1] = -1;
+        // Opened through a DATAPOINTER connection string so that threads
+        // can reopen it
+        char szPtr[64] = {};
+        CPLPrintPointer(szPtr, afData.data(), sizeof(szPtr));
+        const std::string osName = CPLSPrintf(
+            "MEM:::DATAPOINTER=%s,PIXELS=%d,LINES=%d,DATATYPE=Float32",
+            szPtr, nXSize, nYSize);
+        GDALDatasetUniquePtr poDS(GDALDataset::Open(osName.c_str(),
+                                                    GDAL_OF_RASTER));
+        ensure( poDS != nullptr );
+        auto poBand = poDS->GetRasterBand(1);
+        poBand->SetNoDataValue(-1);
+
+        const double adfX[] = { 0.5, 10.25, 3.0, -1, 199.99, 1.5, 1.5 };
+        const double adfY[] = { 0.5, 3.5, 3.0, 0, 99.99, 1.5, 1.6 };
+        constexpr size_t nPoints = sizeof(adfX) / sizeof(adfX[0]);
+        double adfValues[nPoints] = {};
+        int abValid[nPoints] = {};
+        ensure_equals( poBand->SamplePoints(nPoints, adfX, adfY,
+                                            GRIORA_NearestNeighbour,
+                                            adfValues, abValid), CE_None );
+        ensure_equals( adfValues[0], 0.0 );
+        ensure_equals( adfValues[1], 3010.0 );
+        ensure_equals( adfValues[2], 3003.0 );
+        ensure( !abValid[3] );
+        ensure_equals( adfValues[3], -1.0 );
+        ensure_equals( adfValues[4], 99199.0 );
+        ensure( !abValid[5] );
+
+        ensure_equals( poBand->SamplePoints(nPoints, adfX, adfY,
+                                            GRIORA_Bilinear,
+                                            adfValues, abValid), CE_None );
+        ensure_equals( adfValues[0], 0.0 );
+        ensure( std::fabs(adfValues[1] - (9.75 + 3000)) < 1e-9 );
+        ensure_equals( adfValues[2], 2502.5 );
+        ensure( !abValid[3] );
+        // Clamped on the last row and column
+        ensure_equals( adfValues[4], 99199.0 );
+        ensure( !abValid[5] );
+        // Nodata pixel skipped
+        ensure( abValid[6] );
+        ensure( std::fabs(adfValues[6] - 2001) < 1e-9 );
+
+        // Cubic reproduces a linear function away from nodata
+        ensure_equals( poBand->SamplePoints(nPoints, adfX, adfY,
+                                            GRIORA_Cubic,
+                                            adfValues, abValid), CE_None );
+        ensure( std::fabs(adfValues[1] - (9.75 + 3000)) < 1e-9 );
+
+        ensure_equals( poBand->SamplePoints(nPoints, adfX, adfY,
+                                            GRIORA_Average,
+                                            adfValues, abValid), CE_Failure );
+
+        // Georeferenced coordinates, multi-threaded, many points
+        double adfGT[6] = { 1000, 2, 0, 500, 0, -2 };
+        poDS->SetGeoTransform(adfGT);
+        constexpr int nMany = 10000;
+        std::vector<double> adfManyX(nMany), adfManyY(nMany);
+        for( int k = 0; k < nMany; ++k )
+        {
+            const int i = (k * 7919) % nXSize;
+            const int j = (k * 104729) % nYSize;
+            adfManyX[k] = 1000 + 2 * (i + 0.5);
+            adfManyY[k] = 500 - 2 * (j + 0.5);
+        }
+        std::vector<double> adfManyValues(nMany);
+        std::vector<int> abManyValid(nMany);
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("COORDINATES", "GEOREFERENCED");
+        aosOptions.SetNameValue("NUM_THREADS", "4");
+        const int nBand = 1;
+        ensure_equals( poDS->SamplePoints(nMany, adfManyX.data(),
+                                          adfManyY.data(), 1, &nBand,
+                                          GRIORA_Bilinear,
+                                          adfManyValues.data(),
+                                          abManyValid.data(),
+                                          aosOptions.List()), CE_None );
+        for( int k = 0; k < nMany; ++k )
+        {
+            const int i = (k * 7919) % nXSize;
+            const int j = (k * 104729) % nYSize;
+            ensure_equals( abManyValid[k] != 0, !(i == 1 && j == 1) );
+            if( abManyValid[k] )
+                ensure_equals( adfManyValues[k], afData[j * nXSize + i] );
+        }
+    }
 } // namespace tut
@@ -717,3 +717,96 @@ def test_stats_clear():
     assert ds.GetRasterBand(1).GetStatistics(False, False) == [0,0,0,-1]
 
     gdal.GetDriverByName('GTiff').Delete(filename)
+
+###############################################################################
+# Test approximate statistics computed from a stratified sample of blocks
+
+
+@pytest.mark.parametrize('num_threads', ['1', '4'])
+def test_stats_approx_stratified_sampling(num_threads):
+
+    filename = '/vsimem/stats_approx_stratified_sampling.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(filename, 1024, 1024, 1,
+                                              gdal.GDT_Float32,
+                                              options=['TILED=YES',
+                                                       'BLOCKXSIZE=16',
+                                                       'BLOCKYSIZE=16'])
+    ds.GetRasterBand(1).SetNoDataValue(-1)
+    data = b''.join(struct.pack('f' * 1024,
+                                *[-1 if (x + y) % 10 == 0 else x + 0.5 * y
+                                  for x in range(1024)])
+                    for y in range(1024))
+    ds.GetRasterBand(1).WriteRaster(0, 0, 1024, 1024, data)
+    ds = None
+
+    ds = gdal.Open(filename)
+    exact_stats = ds.GetRasterBand(1).ComputeStatistics(False)
+    assert ds.GetRasterBand(1).GetMetadataItem('STATISTICS_MEAN_STDERR') is None
+    ds = None
+    gdal.Unlink(filename + '.aux.xml')
+
+    ds = gdal.Open(filename)
+    progress = []
+
+    def cbk(pct, msg, user_data):
+        # pylint: disable=unused-argument
+        progress.append(pct)
+        return 1
+
+    with gdaltest.config_options({'GDAL_STATS_APPROX_SAMPLING': 'STRATIFIED',
+                                  'GDAL_NUM_THREADS': num_threads}):
+        approx_stats = ds.GetRasterBand(1).ComputeStatistics(True,
+                                                             callback=cbk)
+    assert progress
+    assert progress == sorted(progress)
+    assert progress[-1] == 1.0
+    band = ds.GetRasterBand(1)
+    assert band.GetMetadataItem('STATISTICS_APPROXIMATE') == 'YES'
+    stderr = float(band.GetMetadataItem('STATISTICS_MEAN_STDERR'))
+    assert stderr > 0
+    assert approx_stats[2] == pytest.approx(exact_stats[2], abs=4 * stderr)
+    assert approx_stats[3] == pytest.approx(exact_stats[3], rel=0.1)
+    assert float(band.GetMetadataItem('STATISTICS_VALID_PERCENT')) == \
+        pytest.approx(90, abs=1)
+
+    # Exact statistics do not have a standard error
+    band.ComputeStatistics(False)
+    assert band.GetMetadataItem('STATISTICS_MEAN_STDERR') is None
+    ds = None
+
+    gdal.GetDriverByName('GTiff').Delete(filename)
+
+
+###############################################################################
+# Test that the stratified sampling of a raster with a single row of blocks
+# does not read more blocks than the sampling target.
+
+
+def test_stats_approx_stratified_sampling_single_block_row():
+
+    filename = '/vsimem/stats_approx_stratified_sampling_single_block_row.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(filename, 65536, 16, 1,
+                                              options=['TILED=YES',
+                                                       'BLOCKXSIZE=16',
+                                                       'BLOCKYSIZE=16'])
+    ds.GetRasterBand(1).Fill(1)
+    ds = None
+
+    messages = []
+
+    def handler(err_type, err_no, msg):
+        # pylint: disable=unused-argument
+        messages.append(msg)
+
+    ds = gdal.Open(filename)
+    with gdaltest.config_options({'GDAL_STATS_APPROX_SAMPLING': 'STRATIFIED',
+                                  'CPL_DEBUG': 'ON'}):
+        gdal.PushErrorHandler(handler)
+        stats = ds.GetRasterBand(1).ComputeStatistics(True)
+        gdal.PopErrorHandler()
+    ds = None
+    gdal.GetDriverByName('GTiff').Delete(filename)
+
+    assert stats[0:3] == [1, 1, 1]
+    # 4096 blocks, so 4096 / sqrt(4096) are sampled
+    assert any('from 64 blocks (64 x 1 strata)' in msg for msg in messages)
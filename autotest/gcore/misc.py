@@ -31,6 +31,7 @@
 
 import os
 import shutil
+import sys
 from osgeo import gdal
 
 
@@ -737,7 +738,59 @@ def test_misc_15():
         gdal.SetErrorHandler('CPLDefaultErrorHandler')
         gdal.SetConfigOption('CPL_DEBUG', prev_debug)
 
-    
+
+###############################################################################
+# Test that blocks read through the shared memory block cache by another
+# process are identical to the ones read from the file
+
+
+def test_misc_shared_block_cache():
+
+    if not sys.platform.startswith('linux'):
+        pytest.skip('Linux only')
+
+    import test_cli_utilities
+    gdalinfo_path = test_cli_utilities.get_gdalinfo_path()
+    if gdalinfo_path is None:
+        pytest.skip()
+
+    cache_filename = '/dev/shm/gdal_test_misc_shared_block_cache'
+    if not os.path.isdir('/dev/shm'):
+        cache_filename = 'tmp/gdal_test_misc_shared_block_cache'
+    gdal.Unlink(cache_filename)
+
+    filename = 'tmp/test_misc_shared_block_cache.tif'
+    gdal.Translate(filename, 'data/byte.tif')
+
+    cmd = gdalinfo_path + ' -checksum --debug on' + \
+        ' --config GDAL_SHARED_BLOCK_CACHE ' + cache_filename + \
+        ' --config GDAL_SHARED_BLOCK_CACHE_SIZE 16 ' + filename
+    hit_msg = 'block found in shared block cache'
+    try:
+        out, err = gdaltest.runexternal_out_and_err(cmd)
+        if 'Using shared block cache' not in err:
+            pytest.skip('shared block cache not available')
+        assert 'Checksum=4672' in out
+        assert hit_msg not in err
+
+        # Second run: the blocks are read from the shared cache
+        out, err = gdaltest.runexternal_out_and_err(cmd)
+        assert 'Checksum=4672' in out
+        assert hit_msg in err
+
+        # Rewrite the file in place, with the same size: the blocks of the
+        # previous content must not be returned.
+        ds = gdal.Open(filename, gdal.GA_Update)
+        ds.GetRasterBand(1).Fill(0)
+        ds = None
+        out, err = gdaltest.runexternal_out_and_err(cmd)
+        assert 'Checksum=0' in out
+        assert hit_msg not in err
+    finally:
+        gdal.Unlink(cache_filename)
+        gdal.GetDriverByName('GTiff').Delete(filename)
+
+
 ###############################################################################
 
 
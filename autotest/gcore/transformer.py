@@ -757,6 +757,28 @@ def test_transformer_tps_precision():
     assert success, 'at least one point could not be transformed'
     assert maxDiffResult < 1e-3, 'at least one transformation exceeds the error bound'
 
+###############################################################################
+# Test TPS_APPROX_ERROR_IN_PIXEL and multi-threaded thin plate splines
+
+
+def test_transformer_tps_approx_error():
+
+    ds = gdal.Open('data/gcps_2115.vrt')
+    tr = gdal.Transformer(ds, None, ['METHOD=GCP_TPS'])
+    tr_approx = gdal.Transformer(ds, None, ['METHOD=GCP_TPS',
+                                            'TPS_APPROX_ERROR_IN_PIXEL=0.1',
+                                            'NUM_THREADS=2'])
+    assert tr_approx
+
+    points = [(gcp.GCPX, gcp.GCPY) for gcp in ds.GetGCPs()]
+    res, success = tr.TransformPoints(1, points)
+    assert min(success)
+    res_approx, success = tr_approx.TransformPoints(1, points)
+    assert min(success)
+    for (x, y, _), (x_approx, y_approx, _) in zip(res, res_approx):
+        assert x_approx == pytest.approx(x, abs=0.1)
+        assert y_approx == pytest.approx(y, abs=0.1)
+
 
 ###############################################################################
 def test_transformer_image_no_srs():
@@ -525,3 +525,36 @@ def test_hdf5_multidim_dimension_labels_with_null():
 def test_hdf5_multidim_family_driver():
 
     assert gdal.OpenEx('data/hdf5/test_family_0.h5', gdal.OF_MULTIDIM_RASTER)
+
+
+@pytest.mark.parametrize("num_threads,cache_size", [('1', '0'), ('1', '64'),
+                                                    ('4', '0'), ('4', '64')])
+def test_hdf5_multidim_chunked_filters(num_threads, cache_size):
+
+    ref_data = tuple([i * 7 - 500 for i in range(4 * 10 * 9)])
+
+    with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                  'GDAL_MDARRAY_CHUNK_CACHE_SIZE': cache_size}):
+        ds = gdal.OpenEx('data/hdf5/chunked_filters.h5', gdal.OF_MULTIDIM_RASTER)
+        rg = ds.GetRootGroup()
+        for name in ['contiguous', 'chunked', 'deflate', 'shuffle_deflate',
+                     'fletcher32']:
+            ar = rg.OpenMDArray(name)
+            for _ in range(2):
+                got = struct.unpack('h' * len(ref_data), ar.Read())
+                assert got == ref_data, name
+
+                got = struct.unpack('h' * 2 * 3 * 2, ar.Read(
+                    array_start_idx=[1, 2, 3], count=[2, 3, 2],
+                    array_step=[2, 3, 4]))
+                expected = tuple([ref_data[(1 + 2 * t) * 90 + (2 + 3 * y) * 9 + 3 + 4 * x]
+                                  for t in range(2) for y in range(3) for x in range(2)])
+                assert got == expected, name
+
+                got = struct.unpack('d' * 3 * 4, ar.Read(
+                    array_start_idx=[3, 9, 8], count=[1, 3, 4],
+                    array_step=[1, -1, -2],
+                    buffer_datatype=gdal.ExtendedDataType.Create(gdal.GDT_Float64)))
+                expected = tuple([ref_data[3 * 90 + (9 - y) * 9 + 8 - 2 * x]
+                                  for y in range(3) for x in range(4)])
+                assert got == expected, name
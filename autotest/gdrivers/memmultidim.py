@@ -1873,6 +1873,38 @@ def test_mem_md_array_statistics_float32():
     assert stats.valid_count == 5
 
 
+@pytest.mark.parametrize("datatype,structtype", [(gdal.GDT_Byte, 'B'),
+                                                  (gdal.GDT_UInt16, 'H'),
+                                                  (gdal.GDT_Float32, 'f')])
+@pytest.mark.parametrize("num_threads", ['1', '4'])
+def test_mem_md_array_statistics_multithreaded(datatype, structtype, num_threads):
+
+    drv = gdal.GetDriverByName('MEM')
+    ds = drv.CreateMultiDimensional('myds')
+    rg = ds.GetRootGroup()
+    dim0 = rg.CreateDimension("dim0", "unspecified type", "unspecified direction", 10)
+    dim1 = rg.CreateDimension("dim1", "unspecified type", "unspecified direction", 100)
+    ar = rg.CreateMDArray("myarray", [dim0, dim1],
+                          gdal.ExtendedDataType.Create(datatype))
+    ar.SetNoDataValueDouble(0)
+    vals = [i % 251 for i in range(1000)]
+    ar.Write(struct.pack(structtype * 1000, *vals))
+
+    valid_vals = [v for v in vals if v != 0]
+    mean = sum(valid_vals) / len(valid_vals)
+    std_dev = (sum((v - mean) ** 2 for v in valid_vals) / len(valid_vals)) ** 0.5
+
+    # Force the array to be processed in several chunks
+    with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                  'GDAL_SWATH_SIZE': '400'}):
+        stats = ar.ComputeStatistics(None, False)
+    assert stats.min == 1.0
+    assert stats.max == 250.0
+    assert stats.mean == pytest.approx(mean, rel=1e-12)
+    assert stats.std_dev == pytest.approx(std_dev, rel=1e-12)
+    assert stats.valid_count == len(valid_vals)
+
+
 def test_mem_md_array_copy_autoscale():
 
     drv = gdal.GetDriverByName('MEM')
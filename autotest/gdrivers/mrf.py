@@ -467,6 +467,78 @@ def test_mrf_versioned():
     cleanup()
 
 
+@pytest.mark.parametrize('options', [['COMPRESS=DEFLATE'],
+                                     ['COMPRESS=JPEG', 'INTERLEAVE=PIXEL'],
+                                     ['COMPRESS=PNG', 'INTERLEAVE=BAND'],
+                                     ['COMPRESS=TIF', 'INTERLEAVE=BAND'],
+                                     ['COMPRESS=PNG', 'OPTIONS=DEFLATE:ON']])
+def test_mrf_num_threads(options):
+
+    def read_files(base, ext):
+        f = gdal.VSIFOpenL(base + ext, 'rb')
+        data = gdal.VSIFReadL(1, 10000000, f)
+        gdal.VSIFCloseL(f)
+        f = gdal.VSIFOpenL(base + 'idx', 'rb')
+        idx = gdal.VSIFReadL(1, 10000000, f)
+        gdal.VSIFCloseL(f)
+        return data, idx
+
+    ext = {'DEFLATE': 'pzp', 'JPEG': 'pjg', 'PNG': 'ppg', 'TIF': 'ptf'}[options[0][len('COMPRESS='):]]
+
+    # Reference, single threaded
+    gdal.Translate('/vsimem/out.mrf', 'data/small_world.tif', format='MRF',
+                   creationOptions=options + ['BLOCKSIZE=64'])
+    ds = gdal.Open('/vsimem/out.mrf')
+    ref_cs = [ds.GetRasterBand(i + 1).Checksum() for i in range(ds.RasterCount)]
+    ds = None
+    ref_data, ref_idx = read_files('/vsimem/out.', ext)
+    gdal.Unlink('/vsimem/out.' + ext)
+    cleanup()
+
+    gdal.Translate('/vsimem/out.mrf', 'data/small_world.tif', format='MRF',
+                   creationOptions=options + ['BLOCKSIZE=64', 'NUM_THREADS=4'])
+    ds = gdal.Open('/vsimem/out.mrf')
+    cs = [ds.GetRasterBand(i + 1).Checksum() for i in range(ds.RasterCount)]
+    ds = None
+    data, idx = read_files('/vsimem/out.', ext)
+    gdal.Unlink('/vsimem/out.' + ext)
+    cleanup()
+
+    assert cs == ref_cs
+    # Tiles are written in the same order as with a single thread
+    assert data == ref_data
+    assert idx == ref_idx
+
+
+def test_mrf_num_threads_ppng():
+
+    # The palette is set up by the first page compressed, in any of the threads
+    for i in range(3):
+        gdal.Translate('/vsimem/out.mrf', 'data/small_world_pct.tif', format='MRF',
+                       creationOptions=['COMPRESS=PPNG', 'BLOCKSIZE=32', 'NUM_THREADS=8'])
+        ds = gdal.Open('/vsimem/out.mrf')
+        assert ds.GetRasterBand(1).Checksum() == 14890
+        assert ds.GetRasterBand(1).GetColorTable() is not None
+        ds = None
+        gdal.Unlink('/vsimem/out.ppg')
+        cleanup()
+
+
+def test_mrf_num_threads_update():
+
+    gdal.Translate('/vsimem/out.mrf', 'data/byte.tif', format='MRF',
+                   creationOptions=['BLOCKSIZE=8'])
+    ds = gdal.OpenEx('/vsimem/out.mrf', gdal.OF_UPDATE, open_options=['NUM_THREADS=2'])
+    ds.GetRasterBand(1).Fill(1)
+    # Reading flushes the pending pages first
+    assert ds.GetRasterBand(1).ReadRaster(0, 0, 20, 20) == b'\x01' * 400
+    ds = None
+    ds = gdal.Open('/vsimem/out.mrf')
+    assert ds.GetRasterBand(1).Checksum() == 400
+    ds = None
+    cleanup()
+
+
 def test_mrf_cleanup():
 
     files = [
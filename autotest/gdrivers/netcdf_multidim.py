@@ -1613,3 +1613,60 @@ def test_netcdf_multidim_group_by_same_dimension(netcdf_setup):  # noqa
         dims = ar.GetDimensions()
         assert len(dims) == 1
         assert dims[0].GetName() == 'time_01'
+
+
+def test_netcdf_multidim_chunk_cache(netcdf_setup):  # noqa
+
+    if not gdaltest.netcdf_drv_has_nc4:
+        pytest.skip()
+
+    tmpfilename = 'tmp/test_netcdf_multidim_chunk_cache.nc'
+    drv = gdal.GetDriverByName('netCDF')
+    ds = drv.CreateMultiDimensional(tmpfilename)
+    rg = ds.GetRootGroup()
+    dim_t = rg.CreateDimension('t', None, None, 5)
+    dim_y = rg.CreateDimension('y', None, None, 13)
+    dim_x = rg.CreateDimension('x', None, None, 11)
+    var = rg.CreateMDArray('var', [dim_t, dim_y, dim_x],
+                           gdal.ExtendedDataType.Create(gdal.GDT_Int16),
+                           ['BLOCKSIZE=2,4,3', 'COMPRESS=DEFLATE'])
+    ref_data = [i for i in range(5 * 13 * 11)]
+    assert var.Write(struct.pack('h' * len(ref_data), *ref_data)) == gdal.CE_None
+    ds = None
+
+    def read_subsets(var):
+        return [var.Read(),
+                var.Read(array_start_idx=[1, 2, 3], count=[3, 5, 4]),
+                var.Read(array_start_idx=[0, 1, 1], count=[3, 4, 3],
+                         array_step=[2, 3, 4]),
+                var.Read(array_start_idx=[4, 12, 10], count=[1, 1, 1]),
+                var.Read(array_start_idx=[4, 12, 10], count=[2, 3, 2],
+                         array_step=[-2, -4, -5]),
+                var.Read(buffer_datatype=gdal.ExtendedDataType.Create(gdal.GDT_Float64))]
+
+    try:
+        with gdaltest.config_option('GDAL_MDARRAY_CHUNK_CACHE_SIZE', '0'):
+            ds = gdal.OpenEx(tmpfilename, gdal.OF_MULTIDIM_RASTER)
+            expected = read_subsets(ds.GetRootGroup().OpenMDArray('var'))
+            ds = None
+        assert struct.unpack('h' * len(ref_data), expected[0]) == tuple(ref_data)
+
+        ds = gdal.OpenEx(tmpfilename, gdal.OF_MULTIDIM_RASTER)
+        var = ds.GetRootGroup().OpenMDArray('var')
+        assert read_subsets(var) == expected
+        # Second time, from the chunk cache
+        assert read_subsets(var) == expected
+        ds = None
+
+        # Check that writing invalidates cached chunks
+        ds = gdal.OpenEx(tmpfilename, gdal.OF_MULTIDIM_RASTER | gdal.OF_UPDATE)
+        var = ds.GetRootGroup().OpenMDArray('var')
+        assert read_subsets(var) == expected
+        assert var.Write(struct.pack('h' * 4, -1, -2, -3, -4),
+                         array_start_idx=[1, 2, 3], count=[1, 2, 2]) == gdal.CE_None
+        got = struct.unpack('h' * 4, var.Read(array_start_idx=[1, 2, 3],
+                                              count=[1, 2, 2]))
+        assert got == (-1, -2, -3, -4)
+        ds = None
+    finally:
+        gdal.Unlink(tmpfilename)
@@ -0,0 +1,300 @@
+#!/usr/bin/env pytest
+###############################################################################
+# $Id$
+#
+# Project:  GDAL/OGR Test Suite
+# Purpose:  Test Zarr driver
+# Author:   Even Rouault <even.rouault@spatialys.com>
+#
+###############################################################################
+# Copyright (c) 2021, Even Rouault <even.rouault@spatialys.com>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+###############################################################################
+
+import math
+import struct
+
+import gdaltest
+import pytest
+
+from osgeo import gdal
+
+pytestmark = pytest.mark.require_driver('Zarr')
+
+
+def test_zarr_read_groups():
+
+    ds = gdal.OpenEx('data/zarr/groups.zarr', gdal.OF_MULTIDIM_RASTER)
+    assert ds is not None
+    rg = ds.GetRootGroup()
+    assert set(rg.GetMDArrayNames()) == set(['a', 'y'])
+    assert rg.GetGroupNames() == ['sub']
+    assert rg.GetAttribute('title').Read() == 'test'
+    assert rg.GetAttribute('version').Read() == 3
+
+    ar = rg.OpenMDArray('a')
+    assert ar.GetDataType().GetNumericDataType() == gdal.GDT_Int16
+    assert [dim.GetName() for dim in ar.GetDimensions()] == ['y', 'x']
+    assert [dim.GetSize() for dim in ar.GetDimensions()] == [7, 11]
+    assert ar.GetDimensions()[0].GetIndexingVariable().GetName() == 'y'
+    assert ar.GetBlockSize() == [3, 4]
+    assert ar.GetUnit() == 'm'
+    assert ar.GetNoDataValueAsDouble() == -1
+    assert ar.GetStructuralInfo()['COMPRESSOR'] == 'zlib'
+    assert ar.GetStructuralInfo()['FILTER'] == 'shuffle'
+    # Big endian data type
+    assert ar.GetStructuralInfo()['DTYPE'] == '>i2'
+
+    expected = [i * 7 - 200 for i in range(7 * 11)]
+    assert struct.unpack('h' * (7 * 11), ar.Read()) == tuple(expected)
+    data = ar.Read(array_start_idx=[6, 10], count=[3, 4], array_step=[-2, -3])
+    assert struct.unpack('h' * 12, data) == tuple(
+        expected[(6 - 2 * j) * 11 + 10 - 3 * i] for j in range(3) for i in range(4))
+
+    sub = rg.OpenGroup('sub')
+    assert set(sub.GetMDArrayNames()) == set(['b', 'c', 'd'])
+
+    # i1 data type, gzip compressor and '/' dimension separator
+    ar = sub.OpenMDArray('b')
+    assert ar.GetDataType().GetNumericDataType() == gdal.GDT_Int16
+    expected = [(y * 6 + x - 9) if (z == 0 and y < 3) else 0
+                for z in range(2) for y in range(5) for x in range(6)]
+    assert struct.unpack('h' * 60, ar.Read()) == tuple(expected)
+
+    # NaN fill value, and missing chunks
+    ar = sub.OpenMDArray('c')
+    assert math.isnan(ar.GetNoDataValueAsDouble())
+    data = struct.unpack('f' * 12, ar.Read())
+    assert data[0] == 1.5 and data[4] == 1.5
+    assert math.isnan(data[2]) and math.isnan(data[11])
+
+    # i8 data type
+    ar = sub.OpenMDArray('d')
+    assert ar.GetDataType().GetNumericDataType() == gdal.GDT_Float64
+    assert struct.unpack('d' * 6, ar.Read()) == (1, -2, 3, -4, 5, 1 << 40)
+
+
+def test_zarr_read_classic():
+
+    ds = gdal.Open('data/zarr/groups.zarr')
+    subds = ds.GetSubDatasets()
+    assert len(subds) == 4
+    assert subds[0][0] == 'ZARR:"data/zarr/groups.zarr":/a'
+
+    ds = gdal.Open(subds[0][0])
+    assert ds.RasterXSize == 11
+    assert ds.RasterYSize == 7
+    assert ds.RasterCount == 1
+    assert struct.unpack('h', ds.ReadRaster(2, 1, 1, 1))[0] == 13 * 7 - 200
+
+    # Directly open an array
+    ds = gdal.Open('data/zarr/groups.zarr/sub/b')
+    assert ds.RasterXSize == 6
+    assert ds.RasterYSize == 5
+    assert ds.RasterCount == 2
+
+
+@pytest.mark.parametrize("options", [[],
+                                     ['COMPRESS=ZLIB', 'SHUFFLE=YES'],
+                                     ['DIM_SEPARATOR=/']])
+def test_zarr_create(options):
+
+    filename = '/vsimem/test_zarr_create.zarr'
+    drv = gdal.GetDriverByName('Zarr')
+    ds = drv.CreateMultiDimensional(filename)
+    rg = ds.GetRootGroup()
+    attr = rg.CreateAttribute('str', [], gdal.ExtendedDataType.CreateString())
+    assert attr.Write('hello') == gdal.CE_None
+    dim_t = rg.CreateDimension('t', None, None, 3)
+    dim_y = rg.CreateDimension('y', None, None, 13)
+    dim_x = rg.CreateDimension('x', None, None, 17)
+    var_y = rg.CreateMDArray('y', [dim_y],
+                             gdal.ExtendedDataType.Create(gdal.GDT_Float64))
+    assert var_y.Write(struct.pack('d' * 13, *[i * 0.5 for i in range(13)])) == gdal.CE_None
+    ar = rg.CreateMDArray('ar', [dim_t, dim_y, dim_x],
+                          gdal.ExtendedDataType.Create(gdal.GDT_UInt16),
+                          ['BLOCKSIZE=2,5,4'] + options)
+    assert ar.SetNoDataValueDouble(65535) == gdal.CE_None
+    assert ar.SetUnit('K') == gdal.CE_None
+    ref_data = [i % 65535 for i in range(3 * 13 * 17)]
+    assert ar.Write(struct.pack('H' * len(ref_data), *ref_data)) == gdal.CE_None
+    # Partial update, with negative steps
+    assert ar.Write(struct.pack('H' * 6, 1, 2, 3, 4, 5, 6),
+                    array_start_idx=[2, 12, 16], count=[1, 2, 3],
+                    array_step=[1, -3, -2]) == gdal.CE_None
+    for j in range(2):
+        for i in range(3):
+            ref_data[2 * 13 * 17 + (12 - 3 * j) * 17 + 16 - 2 * i] = 1 + j * 3 + i
+    # Array with missing chunks
+    ar2 = rg.CreateMDArray('ar2', [dim_y, dim_x],
+                           gdal.ExtendedDataType.Create(gdal.GDT_Float32),
+                           ['BLOCKSIZE=2,5'] + options)
+    assert ar2.SetNoDataValueDouble(-9999) == gdal.CE_None
+    assert ar2.Write(struct.pack('f', 1.5), array_start_idx=[3, 6],
+                     count=[1, 1]) == gdal.CE_None
+    subg = rg.CreateGroup('subg')
+    ar3 = subg.CreateMDArray('ar3', [dim_x],
+                             gdal.ExtendedDataType.Create(gdal.GDT_Int16))
+    attr = ar3.CreateAttribute('values', [3],
+                               gdal.ExtendedDataType.Create(gdal.GDT_Float64))
+    assert attr.Write([1.5, 2, 3]) == gdal.CE_None
+    ds = None
+
+    try:
+        assert gdal.VSIStatL(filename + '/.zgroup') is not None
+        assert gdal.VSIStatL(filename + '/ar/.zarray') is not None
+        if 'DIM_SEPARATOR=/' in options:
+            assert gdal.VSIStatL(filename + '/ar2/1/1') is not None
+        else:
+            assert gdal.VSIStatL(filename + '/ar2/1.1') is not None
+            assert gdal.VSIStatL(filename + '/ar2/0.0') is None
+
+        ds = gdal.OpenEx(filename, gdal.OF_MULTIDIM_RASTER)
+        rg = ds.GetRootGroup()
+        assert rg.GetAttribute('str').Read() == 'hello'
+        ar = rg.OpenMDArray('ar')
+        assert [dim.GetName() for dim in ar.GetDimensions()] == ['t', 'y', 'x']
+        assert ar.GetDimensions()[1].GetIndexingVariable().GetName() == 'y'
+        assert ar.GetBlockSize() == [2, 5, 4]
+        assert ar.GetNoDataValueAsDouble() == 65535
+        assert ar.GetUnit() == 'K'
+        with gdaltest.config_option('GDAL_NUM_THREADS', '1'):
+            assert struct.unpack('H' * len(ref_data), ar.Read()) == tuple(ref_data)
+        with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+            assert struct.unpack('H' * len(ref_data), ar.Read()) == tuple(ref_data)
+
+        ar2 = rg.OpenMDArray('ar2')
+        data = struct.unpack('f' * (13 * 17), ar2.Read())
+        assert data[3 * 17 + 6] == 1.5
+        assert data[0] == -9999
+        assert data[3 * 17 + 5] == -9999
+
+        ar3 = rg.OpenGroup('subg').OpenMDArray('ar3')
+        assert ar3.GetAttribute('values').Read() == (1.5, 2, 3)
+        ds = None
+
+        # Not allowed in read-only mode
+        ds = gdal.OpenEx(filename, gdal.OF_MULTIDIM_RASTER)
+        ar = ds.GetRootGroup().OpenMDArray('ar')
+        with gdaltest.error_handler():
+            assert ar.Write(ar.Read()) != gdal.CE_None
+        ds = None
+
+        # Update mode
+        ds = gdal.OpenEx(filename, gdal.OF_MULTIDIM_RASTER | gdal.OF_UPDATE)
+        ar = ds.GetRootGroup().OpenMDArray('ar')
+        assert ar.Write(struct.pack('H', 10), array_start_idx=[0, 0, 0],
+                        count=[1, 1, 1]) == gdal.CE_None
+        # Cached chunks must be invalidated
+        assert struct.unpack('H', ar.Read(array_start_idx=[0, 0, 0],
+                                          count=[1, 1, 1]))[0] == 10
+        ds = None
+    finally:
+        gdal.RmdirRecursive(filename)
+
+
+def test_zarr_read_chunk_by_chunk_and_corrupted_chunk():
+
+    filename = '/vsimem/test_zarr_read_corrupted_chunk.zarr'
+    drv = gdal.GetDriverByName('Zarr')
+    ds = drv.CreateMultiDimensional(filename)
+    rg = ds.GetRootGroup()
+    dim_y = rg.CreateDimension('y', None, None, 7)
+    dim_x = rg.CreateDimension('x', None, None, 11)
+    ar = rg.CreateMDArray('ar', [dim_y, dim_x],
+                          gdal.ExtendedDataType.Create(gdal.GDT_Int16),
+                          ['BLOCKSIZE=3,4', 'COMPRESS=ZLIB'])
+    assert ar.SetNoDataValueDouble(-1) == gdal.CE_None
+    ref_data = [i for i in range(7 * 11)]
+    assert ar.Write(struct.pack('h' * len(ref_data), *ref_data)) == gdal.CE_None
+    ds = None
+
+    try:
+        # Without the chunk cache, chunks are read one after the other
+        with gdaltest.config_option('GDAL_MDARRAY_CHUNK_CACHE_SIZE', '0'):
+            ds = gdal.OpenEx(filename, gdal.OF_MULTIDIM_RASTER)
+            ar = ds.GetRootGroup().OpenMDArray('ar')
+            assert struct.unpack('h' * len(ref_data), ar.Read()) == tuple(ref_data)
+            data = ar.Read(array_start_idx=[6, 10], count=[3, 4], array_step=[-2, -3])
+            assert struct.unpack('h' * 12, data) == tuple(
+                ref_data[(6 - 2 * j) * 11 + 10 - 3 * i] for j in range(3) for i in range(4))
+            ds = None
+
+        # A corrupted chunk is an error, not the fill value
+        f = gdal.VSIFOpenL(filename + '/ar/1.1', 'wb')
+        gdal.VSIFWriteL(b'not zlib', 1, 8, f)
+        gdal.VSIFCloseL(f)
+        ds = gdal.OpenEx(filename, gdal.OF_MULTIDIM_RASTER)
+        ar = ds.GetRootGroup().OpenMDArray('ar')
+        with gdaltest.error_handler():
+            assert ar.Read() is None
+        # Chunks not touching the corrupted one are still readable
+        assert struct.unpack('h', ar.Read(array_start_idx=[0, 0],
+                                          count=[1, 1]))[0] == 0
+        ds = None
+    finally:
+        gdal.RmdirRecursive(filename)
+
+
+def test_zarr_create_unsupported():
+
+    filename = '/vsimem/test_zarr_create_unsupported.zarr'
+    drv = gdal.GetDriverByName('Zarr')
+    ds = drv.CreateMultiDimensional(filename)
+    try:
+        rg = ds.GetRootGroup()
+        dim = rg.CreateDimension('x', None, None, 2)
+        with gdaltest.error_handler():
+            assert rg.CreateMDArray('ar', [dim], gdal.ExtendedDataType.CreateString()) is None
+            assert rg.CreateMDArray('ar', [dim], gdal.ExtendedDataType.Create(gdal.GDT_Byte),
+                                    ['COMPRESS=FOO']) is None
+            assert rg.CreateMDArray('ar', [dim], gdal.ExtendedDataType.Create(gdal.GDT_Byte),
+                                    ['BLOCKSIZE=1,2']) is None
+        ds = None
+    finally:
+        gdal.RmdirRecursive(filename)
+
+
+def test_zarr_statistics_approx():
+
+    drv = gdal.GetDriverByName('Zarr')
+    ds = drv.CreateMultiDimensional('/vsimem/test_zarr_statistics_approx.zarr')
+    try:
+        rg = ds.GetRootGroup()
+        dim_y = rg.CreateDimension('y', None, None, 100)
+        dim_x = rg.CreateDimension('x', None, None, 100)
+        ar = rg.CreateMDArray('ar', [dim_y, dim_x],
+                              gdal.ExtendedDataType.Create(gdal.GDT_Byte),
+                              ['BLOCKSIZE=10,10'])
+        assert ar.Write(struct.pack('B' * 10000,
+                                    *[i % 256 for i in range(10000)])) == gdal.CE_None
+
+        stats = ar.ComputeStatistics(None, False)
+        assert stats.valid_count == 10000
+        assert stats.min == 0
+        assert stats.max == 255
+
+        # Only a sample of the 100 chunks is read
+        stats = ar.ComputeStatistics(None, True)
+        assert 0 < stats.valid_count < 10000
+        assert stats.valid_count % 100 == 0
+        ds = None
+    finally:
+        gdal.RmdirRecursive('/vsimem/test_zarr_statistics_approx.zarr')
@@ -31,6 +31,8 @@
 
 import struct
 
+import gdaltest
+
 from osgeo import gdal
 
 ###############################################################################
@@ -317,3 +319,50 @@ def test_gdalbuildvrt_lib_usemaskband_on_alpha_band():
     ds = gdal.BuildVRT('', [src1_ds, src2_ds])
     assert struct.unpack('B' * 3, ds.GetRasterBand(1).ReadRaster()) == (255, 127, 0)
     assert struct.unpack('B' * 3, ds.GetRasterBand(2).ReadRaster()) == (255, 255, 0)
+
+
+###############################################################################
+def test_gdalbuildvrt_lib_num_threads_and_harvest_cache():
+
+    filenames = []
+    for i in range(10):
+        filename = '/vsimem/test_gdalbuildvrt_lib_num_threads_%d.tif' % i
+        ds = gdal.GetDriverByName('GTiff').Create(filename, 10, 10)
+        ds.SetGeoTransform([2 + 0.01 * i, 0.001, 0, 49, 0, -0.001])
+        ds.GetRasterBand(1).Fill(i)
+        ds = None
+        filenames.append(filename)
+    filenames.append('/vsimem/test_gdalbuildvrt_lib_num_threads_missing.tif')
+
+    with gdaltest.error_handler():
+        ref_ds = gdal.BuildVRT('', filenames, options='-num_threads 1')
+    ref_xml = ref_ds.GetMetadata('xml:VRT')[0]
+    ref_cs = ref_ds.GetRasterBand(1).Checksum()
+
+    with gdaltest.error_handler():
+        ds = gdal.BuildVRT('', filenames, options='-num_threads 4')
+    assert ds.GetMetadata('xml:VRT')[0] == ref_xml
+
+    cache = '/vsimem/test_gdalbuildvrt_lib_num_threads.cache'
+    for _ in range(2):
+        with gdaltest.error_handler():
+            ds = gdal.BuildVRT('', filenames,
+                               options='-num_threads 4 -harvest_cache ' + cache)
+        assert ds.GetMetadata('xml:VRT')[0] == ref_xml
+        assert ds.GetRasterBand(1).Checksum() == ref_cs
+        ds = None
+    assert gdal.VSIStatL(cache) is not None
+
+    # A source that has changed is analysed again
+    ds = gdal.GetDriverByName('GTiff').Create(filenames[0], 20, 10)
+    ds.SetGeoTransform([2, 0.001, 0, 49, 0, -0.001])
+    ds = None
+    with gdaltest.error_handler():
+        ds = gdal.BuildVRT('', filenames,
+                           options='-num_threads 4 -harvest_cache ' + cache)
+    assert ds.GetMetadata('xml:VRT')[0] != ref_xml
+    ds = None
+
+    gdal.Unlink(cache)
+    for filename in filenames:
+        gdal.Unlink(filename)
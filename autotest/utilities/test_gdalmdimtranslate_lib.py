@@ -30,6 +30,7 @@
 ###############################################################################
 
 import gdaltest
+import pytest
 import struct
 
 from osgeo import gdal
@@ -299,6 +300,25 @@ def test_gdalmdimtranslate_array_with_transpose_and_view():
 ###############################################################################
 
 
+@pytest.mark.parametrize("num_threads", ['1', '4'])
+def test_gdalmdimtranslate_array_with_transpose_and_view_small_swath(num_threads):
+
+    ref_ds = gdal.MultiDimTranslate('', 'data/mdim.vrt', format = 'MEM',
+                                    arraySpecs = ['name=my_variable_with_time_increasing,dstname=foo,transpose=[1,2,0],view=[::-1,1,...]'])
+    ref_data = ref_ds.GetRootGroup().OpenMDArray('foo').Read()
+
+    # Force the copy to be split in many units
+    with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                  'GDAL_SWATH_SIZE': '20'}):
+        out_ds = gdal.MultiDimTranslate('', 'data/mdim.vrt', format = 'MEM',
+                                        arraySpecs = ['name=my_variable_with_time_increasing,dstname=foo,transpose=[1,2,0],view=[::-1,1,...]'])
+    assert out_ds.GetRootGroup().OpenMDArray('foo').Read() == ref_data
+    assert out_ds.GetRootGroup().OpenMDArray('time_increasing').Read() == \
+        ['2010-01-01', '2011-01-01', '2012-01-01', '2013-01-01']
+
+###############################################################################
+
+
 def test_gdalmdimtranslate_group():
 
     tmpfile = '/vsimem/out.vrt'
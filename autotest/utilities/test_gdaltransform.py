@@ -30,6 +30,10 @@
 
 
 
+import shlex
+import struct
+import subprocess
+
 import gdaltest
 import test_cli_utilities
 import pytest
@@ -191,3 +195,42 @@ def test_gdaltransform_ct_4D():
     assert values[1] == pytest.approx(49.0000003766711, abs=1e-10), ret
     assert values[2] == pytest.approx(-0.0222802283242345, abs=1e-8), ret
 
+
+###############################################################################
+# Test batch mode, with text and binary input and output
+
+
+def test_gdaltransform_batch():
+    if test_cli_utilities.get_gdaltransform_path() is None:
+        pytest.skip()
+
+    gcps = ' -tps -gcp 0 0 100 200 -gcp 100 0 300 210 -gcp 0 100 90 400 -gcp 100 100 310 390 -gcp 50 50 200 305'
+    strin = ''
+    for i in range(3000):
+        strin += '%d %d %d\n' % (i % 100, i // 30, i % 7)
+
+    ref = gdaltest.runexternal(test_cli_utilities.get_gdaltransform_path() + gcps, strin)
+    ret = gdaltest.runexternal(test_cli_utilities.get_gdaltransform_path() + gcps + ' -batch -num_threads 4', strin)
+    assert ret == ref
+
+    ret = gdaltest.runexternal(test_cli_utilities.get_gdaltransform_path() + gcps + ' -batch -num_threads 4 -output_xy', strin)
+    lines = ret.strip().split('\n')
+    assert len(lines) == 3000
+    assert lines[1] == ' '.join(ref.split('\n')[1].split(' ')[0:2])
+
+    binary_in = b''.join(struct.pack('=3d', *[float(x) for x in line.split(' ')])
+                         for line in strin.strip().split('\n'))
+    cmd = test_cli_utilities.get_gdaltransform_path() + gcps + ' -binary_input -binary_output -num_threads 4'
+    data = subprocess.run(shlex.split(cmd), input=binary_in,
+                          stdout=subprocess.PIPE, check=True).stdout
+    assert len(data) == 3000 * 3 * 8
+    for i, line in enumerate(ref.strip().split('\n')):
+        values = struct.unpack('=3d', data[i * 24:(i + 1) * 24])
+        assert values == pytest.approx([float(x) for x in line.split(' ')], abs=1e-8)
+
+    # Truncated last record
+    res = subprocess.run(shlex.split(cmd), input=binary_in[0:-4],
+                         stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    assert res.returncode == 1
+    assert b'Truncated binary input' in res.stderr
+    assert len(res.stdout) == 2999 * 3 * 8
@@ -2060,6 +2060,42 @@ def test_gdalwarp_lib_cutline_zero_width_sliver():
     ds = gdal.Warp('', src_ds, format='MEM', cutlineDSName='/vsimem/cutline.geojson')
     assert ds is not None
 
+###############################################################################
+# Test warping several overlapping sources concurrently
+
+
+@pytest.mark.parametrize('src_threads', ['2', 'ALL_CPUS'])
+def test_gdalwarp_lib_src_threads(src_threads):
+
+    srs = osr.SpatialReference()
+    srs.ImportFromEPSG(32631)
+    src_ds_list = []
+    for i in range(6):
+        src_ds = gdal.GetDriverByName('MEM').Create('', 100, 100)
+        src_ds.SetSpatialRef(srs)
+        src_ds.SetGeoTransform([500000 + 40 * 60 * (i % 3), 60, 0,
+                                4500000 - 40 * 60 * (i // 3), 0, -60])
+        src_ds.GetRasterBand(1).Fill(10 * (i + 1))
+        src_ds_list.append(src_ds)
+
+    options = '-of MEM -t_srs EPSG:4326 -r bilinear -wm 0.1 -ts 300 200'
+    ref_ds = gdal.Warp('', src_ds_list, options=options)
+    ds = gdal.Warp('', src_ds_list,
+                   options=options + ' -src_threads ' + src_threads)
+    assert ds.GetRasterBand(1).Checksum() == ref_ds.GetRasterBand(1).Checksum()
+    assert ds.ReadRaster() == ref_ds.ReadRaster()
+
+
+@pytest.mark.parametrize('src_threads', ['0', '-1', 'foo', '2x'])
+def test_gdalwarp_lib_src_threads_invalid(src_threads):
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 10, 10)
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    with gdaltest.error_handler():
+        ds = gdal.Warp('', src_ds,
+                       options='-of MEM -src_threads ' + src_threads)
+    assert ds is None
+
 ###############################################################################
 # Cleanup
 
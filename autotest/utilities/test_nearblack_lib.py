@@ -154,3 +154,22 @@ def test_nearblack_lib_8():
 
 
 
+###############################################################################
+# Test that the result does not depend on the number of threads
+
+
+def test_nearblack_lib_num_threads():
+
+    src_ds = gdal.Translate('', '../gdrivers/data/rgbsmall.tif',
+                            format='MEM', width=500, height=400)
+
+    ref_ds = gdal.Nearblack('', src_ds, options='-of MEM -setmask -num_threads 1')
+    assert ref_ds is not None
+
+    ds = gdal.Nearblack('', src_ds, options='-of MEM -setmask -num_threads 4')
+    assert ds is not None
+
+    for i in range(3):
+        assert ds.GetRasterBand(i + 1).Checksum() == ref_ds.GetRasterBand(i + 1).Checksum()
+    assert ds.GetRasterBand(1).GetMaskBand().Checksum() == ref_ds.GetRasterBand(1).GetMaskBand().Checksum()
+
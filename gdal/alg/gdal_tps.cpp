@@ -32,8 +32,10 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
@@ -45,6 +47,7 @@
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -67,6 +70,9 @@ typedef struct
     int       nGCPCount;
     GDAL_GCP *pasGCPList;
 
+    int       nThreads;
+    double    dfApproxErrorInPixel;
+
     volatile int nRefCount;
 
 } TPSTransformInfo;
@@ -98,9 +104,17 @@ void* GDALCreateSimilarTPSTransformer( void *hTransformArg,
             pasGCPList[i].dfGCPPixel /= dfRatioX;
             pasGCPList[i].dfGCPLine /= dfRatioY;
         }
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("NUM_THREADS",
+                                CPLSPrintf("%d", psInfo->nThreads));
+        if( psInfo->dfApproxErrorInPixel > 0 )
+            aosOptions.SetNameValue("TPS_APPROX_ERROR_IN_PIXEL",
+                                    CPLSPrintf("%.18g",
+                                               psInfo->dfApproxErrorInPixel));
         psInfo = static_cast<TPSTransformInfo *>(
-            GDALCreateTPSTransformer( psInfo->nGCPCount, pasGCPList,
-                                      psInfo->bReversed ));
+            GDALCreateTPSTransformerInt( psInfo->nGCPCount, pasGCPList,
+                                         psInfo->bReversed,
+                                         aosOptions.List() ));
         GDALDeinitGCPs( psInfo->nGCPCount, pasGCPList );
         CPLFree( pasGCPList );
     }
@@ -150,7 +164,8 @@ void *GDALCreateTPSTransformer( int nGCPCount, const GDAL_GCP *pasGCPList,
 static void GDALTPSComputeForwardInThread( void *pData )
 {
     TPSTransformInfo *psInfo = static_cast<TPSTransformInfo *>(pData);
-    psInfo->bForwardSolved = psInfo->poForward->solve() != 0;
+    psInfo->bForwardSolved =
+        psInfo->poForward->solve(std::max(1, psInfo->nThreads / 2)) != 0;
 }
 
 void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
@@ -269,17 +284,20 @@ void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
         else
             nThreads = atoi(pszWarpThreads);
     }
+    psInfo->nThreads = std::max(1, nThreads);
 
     if( nThreads > 1 )
     {
-        // Compute direct and reverse transforms in parallel.
+        // Compute direct and reverse transforms in parallel, each of them
+        // using half of the threads for the resolution of its linear system.
         CPLJoinableThread* hThread =
             CPLCreateJoinableThread(GDALTPSComputeForwardInThread, psInfo);
-        psInfo->bReverseSolved = psInfo->poReverse->solve() != 0;
+        psInfo->bReverseSolved =
+            psInfo->poReverse->solve(std::max(1, nThreads / 2)) != 0;
         if( hThread != nullptr )
             CPLJoinThread(hThread);
         else
-            psInfo->bForwardSolved = psInfo->poForward->solve() != 0;
+            psInfo->bForwardSolved = psInfo->poForward->solve(nThreads) != 0;
     }
     else
     {
@@ -293,6 +311,30 @@ void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
         return nullptr;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Optionally approximate the contribution of the far away GCPs.   */
+/*      The spline whose input is pixel/line outputs georeferenced      */
+/*      coordinates, so its tolerance is scaled by the pixel size.      */
+/* -------------------------------------------------------------------- */
+    const char* pszApproxError =
+        CSLFetchNameValue(papszOptions, "TPS_APPROX_ERROR_IN_PIXEL");
+    if( pszApproxError != nullptr )
+    {
+        psInfo->dfApproxErrorInPixel = CPLAtof(pszApproxError);
+        if( psInfo->dfApproxErrorInPixel > 0 )
+        {
+            VizGeorefSpline2D* poPixelToGeo =
+                bReversed ? psInfo->poReverse : psInfo->poForward;
+            VizGeorefSpline2D* poGeoToPixel =
+                bReversed ? psInfo->poForward : psInfo->poReverse;
+            poPixelToGeo->set_far_field_tolerance(
+                psInfo->dfApproxErrorInPixel *
+                    poPixelToGeo->get_linear_scale() );
+            poGeoToPixel->set_far_field_tolerance(
+                psInfo->dfApproxErrorInPixel );
+        }
+    }
+
     return psInfo;
 }
 
@@ -355,6 +397,31 @@ void GDALDestroyTPSTransformer( void *pTransformArg )
  * @return TRUE.
  */
 
+namespace {
+struct GDALTPSTransformJob
+{
+    VizGeorefSpline2D *poSpline;
+    double *x;
+    double *y;
+    int    *panSuccess;
+    int     nPointCount;
+};
+} // namespace
+
+static void GDALTPSTransformPoints( void *pData )
+{
+    GDALTPSTransformJob *psJob = static_cast<GDALTPSTransformJob *>(pData);
+
+    for( int i = 0; i < psJob->nPointCount; i++ )
+    {
+        double xy_out[2] = { 0.0, 0.0 };
+        psJob->poSpline->get_point( psJob->x[i], psJob->y[i], xy_out );
+        psJob->x[i] = xy_out[0];
+        psJob->y[i] = xy_out[1];
+        psJob->panSuccess[i] = TRUE;
+    }
+}
+
 int GDALTPSTransform( void *pTransformArg, int bDstToSrc,
                       int nPointCount,
                       double *x, double *y,
@@ -364,25 +431,45 @@ int GDALTPSTransform( void *pTransformArg, int bDstToSrc,
     VALIDATE_POINTER1( pTransformArg, "GDALTPSTransform", 0 );
 
     TPSTransformInfo *psInfo = static_cast<TPSTransformInfo *>(pTransformArg);
+    VizGeorefSpline2D *poSpline =
+        bDstToSrc ? psInfo->poReverse : psInfo->poForward;
 
-    for( int i = 0; i < nPointCount; i++ )
+/* -------------------------------------------------------------------- */
+/*      Split large requests among threads. The cost of each point is   */
+/*      proportional to the number of GCPs.                             */
+/* -------------------------------------------------------------------- */
+    constexpr double MIN_WORK_PER_JOB = 1e6;
+    int nJobs = 1;
+    if( psInfo->nThreads > 1 )
     {
-        double xy_out[2] = { 0.0, 0.0 };
+        const double dfWork =
+            static_cast<double>(nPointCount) * psInfo->nGCPCount;
+        nJobs = static_cast<int>(std::min(
+            static_cast<double>(psInfo->nThreads),
+            dfWork / MIN_WORK_PER_JOB));
+    }
+    CPLWorkerThreadPool* poThreadPool =
+        nJobs > 1 ? GDALGetGlobalThreadPool(psInfo->nThreads) : nullptr;
+    if( poThreadPool == nullptr )
+    {
+        GDALTPSTransformJob sJob = { poSpline, x, y, panSuccess, nPointCount };
+        GDALTPSTransformPoints(&sJob);
+        return TRUE;
+    }
 
-        if( bDstToSrc )
-        {
-            psInfo->poReverse->get_point( x[i], y[i], xy_out );
-            x[i] = xy_out[0];
-            y[i] = xy_out[1];
-        }
-        else
-        {
-            psInfo->poForward->get_point( x[i], y[i], xy_out );
-            x[i] = xy_out[0];
-            y[i] = xy_out[1];
-        }
-        panSuccess[i] = TRUE;
+    std::vector<GDALTPSTransformJob> asJobs(nJobs);
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    for( int i = 0; i < nJobs; i++ )
+    {
+        const int iStart = static_cast<int>(
+            static_cast<GIntBig>(nPointCount) * i / nJobs);
+        const int iEnd = static_cast<int>(
+            static_cast<GIntBig>(nPointCount) * (i + 1) / nJobs);
+        asJobs[i] = { poSpline, x + iStart, y + iStart, panSuccess + iStart,
+                      iEnd - iStart };
+        poJobQueue->SubmitJob(GDALTPSTransformPoints, &asJobs[i]);
     }
+    poJobQueue->WaitCompletion();
 
     return TRUE;
 }
@@ -407,6 +494,13 @@ CPLXMLNode *GDALSerializeTPSTransformer( void *pTransformArg )
         psTree, "Reversed",
         CPLString().Printf( "%d", static_cast<int>(psInfo->bReversed) ) );
 
+    if( psInfo->dfApproxErrorInPixel > 0 )
+    {
+        CPLCreateXMLElementAndValue(
+            psTree, "ApproxErrorInPixel",
+            CPLString().Printf( "%.18g", psInfo->dfApproxErrorInPixel ) );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Attach GCP List.                                                */
 /* -------------------------------------------------------------------- */
@@ -447,12 +541,18 @@ void *GDALDeserializeTPSTransformer( CPLXMLNode *psTree )
 /*      Get other flags.                                                */
 /* -------------------------------------------------------------------- */
     const int bReversed = atoi(CPLGetXMLValue(psTree, "Reversed", "0"));
+    CPLStringList aosOptions;
+    const char* pszApproxError =
+        CPLGetXMLValue(psTree, "ApproxErrorInPixel", nullptr);
+    if( pszApproxError )
+        aosOptions.SetNameValue("TPS_APPROX_ERROR_IN_PIXEL", pszApproxError);
 
 /* -------------------------------------------------------------------- */
 /*      Generate transformation.                                        */
 /* -------------------------------------------------------------------- */
     void *pResult =
-        GDALCreateTPSTransformer( nGCPCount, pasGCPList, bReversed );
+        GDALCreateTPSTransformerInt( nGCPCount, pasGCPList, bReversed,
+                                     aosOptions.List() );
 
 /* -------------------------------------------------------------------- */
 /*      Cleanup GCP copy.                                               */
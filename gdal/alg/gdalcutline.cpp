@@ -34,9 +34,13 @@
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <climits>
+#include <memory>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_string.h"
 #include "gdal.h"
 #include "gdal_alg.h"
@@ -257,6 +261,392 @@ static int CutlineTransformer( void *pTransformArg,
     return TRUE;
 }
 
+/************************************************************************/
+/*                        GDALWarpCutlineIndex                          */
+/*                                                                      */
+/*      The edges of the cutline, which is already expressed in         */
+/*      source pixel coordinates, indexed by a packed R-tree, so that   */
+/*      each chunk only has to consider the edges that can change the   */
+/*      mask in its window.                                             */
+/************************************************************************/
+
+namespace {
+
+struct GDALCutlineEdge
+{
+    // In the order of the ring, once normalized to clockwise as done by
+    // GDALRasterizeGeometries(): it matters for horizontal edges.
+    double dfX1;
+    double dfY1;
+    double dfX2;
+    double dfY2;
+    // Index of the polygon of the edge. Polygons of a multipolygon are
+    // burnt separately, so the even-odd rule applies to each of them.
+    int    nPart;
+};
+
+struct GDALWarpCutlineIndex
+{
+    std::vector<GDALCutlineEdge> asEdges{};
+    CPLPackedRTree              *hTree = nullptr;
+    CPLRectObj                   sBounds{};
+
+    GDALWarpCutlineIndex() = default;
+    ~GDALWarpCutlineIndex() { CPLPackedRTreeDestroy(hTree); }
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALWarpCutlineIndex)
+};
+
+} // namespace
+
+static void CollectCutlineEdges( const OGRGeometry *poGeom,
+                                 std::vector<GDALCutlineEdge> &asEdges,
+                                 int &nPartCount )
+{
+    const OGRwkbGeometryType eFlatType = wkbFlatten(poGeom->getGeometryType());
+    if( eFlatType == wkbMultiPolygon )
+    {
+        for( const auto poPart: *(poGeom->toMultiPolygon()) )
+            CollectCutlineEdges( poPart, asEdges, nPartCount );
+        return;
+    }
+    if( eFlatType != wkbPolygon || poGeom->IsEmpty() )
+        return;
+
+    const int nPart = nPartCount++;
+
+    for( const auto poRing: *(poGeom->toPolygon()) )
+    {
+        const int nCount = poRing->getNumPoints();
+        if( nCount == 0 )
+            continue;
+        const bool bClockwise = CPL_TO_BOOL(poRing->isClockwise());
+        const auto GetPoint = [poRing, nCount, bClockwise](int i,
+                                                           double &dfX,
+                                                           double &dfY)
+        {
+            const int iPoint = bClockwise ? i : nCount - 1 - i;
+            dfX = poRing->getX(iPoint);
+            dfY = poRing->getY(iPoint);
+        };
+        // Same edges as GDALdllImageFilledPolygon(): the closing one first.
+        GDALCutlineEdge sEdge;
+        sEdge.nPart = nPart;
+        GetPoint(nCount - 1, sEdge.dfX1, sEdge.dfY1);
+        for( int i = 0; i < nCount; i++ )
+        {
+            GetPoint(i, sEdge.dfX2, sEdge.dfY2);
+            // Degenerate edges never burn anything.
+            if( sEdge.dfX1 != sEdge.dfX2 || sEdge.dfY1 != sEdge.dfY2 )
+                asEdges.push_back(sEdge);
+            sEdge.dfX1 = sEdge.dfX2;
+            sEdge.dfY1 = sEdge.dfY2;
+        }
+    }
+}
+
+/************************************************************************/
+/*                      GDALCreateWarpCutlineIndex()                    */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+void *GDALCreateWarpCutlineIndex( void *hCutline )
+{
+    const OGRGeometry *poCutline = static_cast<const OGRGeometry *>(hCutline);
+    const OGRwkbGeometryType eFlatType =
+        wkbFlatten(poCutline->getGeometryType());
+    if( eFlatType != wkbPolygon && eFlatType != wkbMultiPolygon )
+        return nullptr;
+
+    auto poIndex = new GDALWarpCutlineIndex();
+    int nPartCount = 0;
+    CollectCutlineEdges( poCutline, poIndex->asEdges, nPartCount );
+
+    const auto &asEdges = poIndex->asEdges;
+    if( asEdges.size() > static_cast<size_t>(INT_MAX / 2) )
+    {
+        delete poIndex;
+        return nullptr;
+    }
+    std::vector<CPLRectObj> asBounds(asEdges.size());
+    for( size_t i = 0; i < asEdges.size(); i++ )
+    {
+        asBounds[i].minx = std::min(asEdges[i].dfX1, asEdges[i].dfX2);
+        asBounds[i].maxx = std::max(asEdges[i].dfX1, asEdges[i].dfX2);
+        asBounds[i].miny = std::min(asEdges[i].dfY1, asEdges[i].dfY2);
+        asBounds[i].maxy = std::max(asEdges[i].dfY1, asEdges[i].dfY2);
+    }
+    poIndex->hTree = CPLPackedRTreeCreate( static_cast<int>(asBounds.size()),
+                                           asBounds.data(), 0 );
+    if( poIndex->hTree == nullptr )
+    {
+        delete poIndex;
+        return nullptr;
+    }
+    CPLPackedRTreeGetBounds( poIndex->hTree, &(poIndex->sBounds) );
+    return poIndex;
+}
+
+/************************************************************************/
+/*                     GDALDestroyWarpCutlineIndex()                    */
+/************************************************************************/
+
+void GDALDestroyWarpCutlineIndex( void *hIndex )
+{
+    delete static_cast<GDALWarpCutlineIndex *>(hIndex);
+}
+/*! @endcond */
+
+/************************************************************************/
+/*                         SearchCutlineEdges()                         */
+/************************************************************************/
+
+static std::vector<int> SearchCutlineEdges( const GDALWarpCutlineIndex *poIndex,
+                                            double dfMinX, double dfMinY,
+                                            double dfMaxX, double dfMaxY )
+{
+    CPLRectObj sAoi;
+    sAoi.minx = dfMinX;
+    sAoi.miny = dfMinY;
+    sAoi.maxx = dfMaxX;
+    sAoi.maxy = dfMaxY;
+    int nCount = 0;
+    int *panEdges = CPLPackedRTreeSearch( poIndex->hTree, &sAoi, &nCount );
+    std::vector<int> anEdges( panEdges, panEdges + nCount );
+    CPLFree( panEdges );
+    return anEdges;
+}
+
+/************************************************************************/
+/*                        EdgeIntersectsRect()                          */
+/************************************************************************/
+
+// Liang-Barsky clipping of the edge against the closed rectangle.
+static bool EdgeIntersectsRect( const GDALCutlineEdge &sEdge,
+                                double dfMinX, double dfMinY,
+                                double dfMaxX, double dfMaxY )
+{
+    const double dfDX = sEdge.dfX2 - sEdge.dfX1;
+    const double dfDY = sEdge.dfY2 - sEdge.dfY1;
+    const double adfP[4] = { -dfDX, dfDX, -dfDY, dfDY };
+    const double adfQ[4] = { sEdge.dfX1 - dfMinX, dfMaxX - sEdge.dfX1,
+                             sEdge.dfY1 - dfMinY, dfMaxY - sEdge.dfY1 };
+    double dfT0 = 0.0;
+    double dfT1 = 1.0;
+    for( int i = 0; i < 4; i++ )
+    {
+        if( adfP[i] == 0.0 )
+        {
+            if( adfQ[i] < 0.0 )
+                return false;
+        }
+        else
+        {
+            const double dfT = adfQ[i] / adfP[i];
+            if( adfP[i] < 0.0 )
+                dfT0 = std::max(dfT0, dfT);
+            else
+                dfT1 = std::min(dfT1, dfT);
+            if( dfT0 > dfT1 )
+                return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                     GDALWarpCutlineIndexGetStatus()                  */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+// Returns GCWS_OUTSIDE (resp. GCWS_INSIDE) if no edge of the cutline
+// crosses the window and its pixel centers are outside (resp. inside) the
+// cutline, and GCWS_CROSSED otherwise.
+int GDALWarpCutlineIndexGetStatus( void *hIndex,
+                                   double dfMinX, double dfMinY,
+                                   double dfMaxX, double dfMaxY )
+{
+    const auto poIndex = static_cast<const GDALWarpCutlineIndex *>(hIndex);
+    const auto &sBounds = poIndex->sBounds;
+    if( poIndex->asEdges.empty() ||
+        sBounds.maxx < dfMinX || sBounds.minx > dfMaxX ||
+        sBounds.maxy < dfMinY || sBounds.miny > dfMaxY )
+    {
+        return GCWS_OUTSIDE;
+    }
+
+    for( int iEdge: SearchCutlineEdges( poIndex, dfMinX, dfMinY,
+                                        dfMaxX, dfMaxY ) )
+    {
+        if( EdgeIntersectsRect( poIndex->asEdges[iEdge],
+                                dfMinX, dfMinY, dfMaxX, dfMaxY ) )
+            return GCWS_CROSSED;
+    }
+
+    // Even-odd test of the pixel center of the top left corner in each
+    // polygon, with a ray going left, consistently with
+    // GDALdllImageFilledPolygon().
+    const double dfX = std::floor(dfMinX) + 0.5;
+    const double dfY = std::floor(dfMinY) + 0.5;
+    std::vector<int> anCrossedParts;
+    for( int iEdge: SearchCutlineEdges( poIndex, sBounds.minx, dfY,
+                                        dfX, dfY ) )
+    {
+        const auto &sEdge = poIndex->asEdges[iEdge];
+        double dfY1 = sEdge.dfY1;
+        double dfY2 = sEdge.dfY2;
+        double dfX1 = sEdge.dfX1;
+        double dfX2 = sEdge.dfX2;
+        if( dfY1 > dfY2 )
+        {
+            std::swap(dfY1, dfY2);
+            std::swap(dfX1, dfX2);
+        }
+        if( dfY < dfY2 && dfY >= dfY1 &&
+            (dfY - dfY1) * (dfX2 - dfX1) / (dfY2 - dfY1) + dfX1 < dfX )
+        {
+            anCrossedParts.push_back(sEdge.nPart);
+        }
+    }
+    std::sort( anCrossedParts.begin(), anCrossedParts.end() );
+    for( size_t i = 0; i < anCrossedParts.size(); )
+    {
+        size_t j = i + 1;
+        while( j < anCrossedParts.size() &&
+               anCrossedParts[j] == anCrossedParts[i] )
+            j++;
+        if( ((j - i) % 2) == 1 )
+            return GCWS_INSIDE;
+        i = j;
+    }
+    return GCWS_OUTSIDE;
+}
+/*! @endcond */
+
+/************************************************************************/
+/*                          BurnCutlineMask()                           */
+/*                                                                      */
+/*      Equivalent of GDALRasterizeGeometries() on a window, but only   */
+/*      considering the cutline edges that can reach it.                */
+/************************************************************************/
+
+static void BurnCutlineMask( const GDALWarpCutlineIndex *poIndex,
+                             int nXOff, int nYOff, int nXSize, int nYSize,
+                             GByte *pabyPolyMask )
+{
+    const auto ToPixel = [nXSize](double dfX)
+    {
+        // Clamping does not change the result, but avoids overflows.
+        return static_cast<int>(std::floor(
+            std::max(-1.0, std::min(nXSize + 1.0, dfX + 0.5))));
+    };
+    const auto Fill = [nXSize, pabyPolyMask](int iLine, int nXStart, int nXEnd)
+    {
+        nXStart = std::max(0, nXStart);
+        nXEnd = std::min(nXSize - 1, nXEnd);
+        if( nXStart <= nXEnd )
+        {
+            memset( pabyPolyMask + static_cast<size_t>(iLine) * nXSize +
+                        nXStart, 255, nXEnd - nXStart + 1 );
+        }
+    };
+
+    // All the edges to the left of the window are needed to determine
+    // whether its first pixel of each line is inside the cutline.
+    const std::vector<int> anCandidates =
+        SearchCutlineEdges( poIndex, poIndex->sBounds.minx, nYOff,
+                            static_cast<double>(nXOff) + nXSize,
+                            static_cast<double>(nYOff) + nYSize );
+
+    // Intersections of the pixel center lines with the edges, as
+    // (line, polygon index, pixel) tuples. Coordinates are expressed
+    // relative to the window, with the same arithmetic as
+    // CutlineTransformer() and GDALdllImageFilledPolygon(), so that the
+    // result is identical to the one of GDALRasterizeGeometries().
+    struct Intersection
+    {
+        int nLine;
+        int nPart;
+        int nPixel;
+        bool operator< (const Intersection& other) const
+        {
+            if( nLine != other.nLine )
+                return nLine < other.nLine;
+            if( nPart != other.nPart )
+                return nPart < other.nPart;
+            return nPixel < other.nPixel;
+        }
+    };
+    std::vector<Intersection> asInts;
+    for( int iEdge: anCandidates )
+    {
+        const auto &sEdge = poIndex->asEdges[iEdge];
+        const double dfX1 = sEdge.dfX1 - nXOff;
+        const double dfX2 = sEdge.dfX2 - nXOff;
+        const double dfY1 = sEdge.dfY1 - nYOff;
+        const double dfY2 = sEdge.dfY2 - nYOff;
+
+        if( dfY1 == dfY2 )
+        {
+            // Bottom horizontal edges are filled separately, top ones
+            // by the regular loop.
+            const double dfLine = dfY1 - 0.5;
+            if( dfX1 > dfX2 && dfLine >= 0 && dfLine < nYSize &&
+                dfLine == std::floor(dfLine) &&
+                static_cast<int>(dfLine) + 0.5 == dfY1 )
+            {
+                Fill( static_cast<int>(dfLine),
+                      ToPixel(dfX2), ToPixel(dfX1) - 1 );
+            }
+            continue;
+        }
+
+        double dy1 = dfY1;
+        double dy2 = dfY2;
+        double dx1 = dfX1;
+        double dx2 = dfX2;
+        if( dy1 > dy2 )
+        {
+            std::swap(dy1, dy2);
+            std::swap(dx1, dx2);
+        }
+        // Conservative range of lines, checked exactly below.
+        const int nLineStart = static_cast<int>(
+            std::max(0.0, std::floor(dy1 - 0.5)));
+        const int nLineEnd = static_cast<int>(
+            std::min(static_cast<double>(nYSize - 1), std::floor(dy2)));
+        for( int iLine = nLineStart; iLine <= nLineEnd; iLine++ )
+        {
+            const double dy = iLine + 0.5;
+            if( dy < dy2 && dy >= dy1 )
+            {
+                const double intersect =
+                    (dy - dy1) * (dx2 - dx1) / (dy2 - dy1) + dx1;
+                asInts.push_back( { iLine, sEdge.nPart, ToPixel(intersect) } );
+            }
+        }
+    }
+
+    // Fill between pairs of intersections of each polygon. Edges on the
+    // right of the window are not considered: the line is inside a polygon
+    // after its last intersection in the window if their count is odd.
+    std::sort( asInts.begin(), asInts.end() );
+    for( size_t i = 0; i < asInts.size(); )
+    {
+        const auto &sInt = asInts[i];
+        if( i + 1 == asInts.size() ||
+            asInts[i + 1].nLine != sInt.nLine ||
+            asInts[i + 1].nPart != sInt.nPart )
+        {
+            Fill( sInt.nLine, sInt.nPixel, nXSize - 1 );
+            i++;
+            continue;
+        }
+        Fill( sInt.nLine, sInt.nPixel, asInts[i + 1].nPixel - 1 );
+        i += 2;
+    }
+}
+
 /************************************************************************/
 /*                       GDALWarpCutlineMasker()                        */
 /*                                                                      */
@@ -266,12 +656,37 @@ static int CutlineTransformer( void *pTransformArg,
 
 CPLErr
 GDALWarpCutlineMasker( void *pMaskFuncArg,
-                       int /* nBandCount */,
-                       GDALDataType /* eType */,
+                       int nBandCount,
+                       GDALDataType eType,
                        int nXOff, int nYOff, int nXSize, int nYSize,
-                       GByte ** /*ppImageData */,
+                       GByte ** ppImageData,
                        int bMaskIsFloat, void *pValidityMask )
 
+{
+    return GDALWarpCutlineMaskerEx( pMaskFuncArg, nBandCount, eType,
+                                    nXOff, nYOff, nXSize, nYSize,
+                                    ppImageData, bMaskIsFloat, pValidityMask,
+                                    nullptr );
+}
+
+/************************************************************************/
+/*                      GDALWarpCutlineMaskerEx()                       */
+/*                                                                      */
+/*      Same as GDALWarpCutlineMasker(), reusing an index of the        */
+/*      cutline created with GDALCreateWarpCutlineIndex(), or creating  */
+/*      a temporary one if hCutlineIndex is NULL.                       */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+CPLErr
+GDALWarpCutlineMaskerEx( void *pMaskFuncArg,
+                         int /* nBandCount */,
+                         GDALDataType /* eType */,
+                         int nXOff, int nYOff, int nXSize, int nYSize,
+                         GByte ** /*ppImageData */,
+                         int bMaskIsFloat, void *pValidityMask,
+                         void *hCutlineIndex )
+
 {
     if( nXSize < 1 || nYSize < 1 )
         return CE_None;
@@ -293,14 +708,6 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
         return CE_Failure;
     }
 
-    GDALDriverH hMemDriver = GDALGetDriverByName("MEM");
-    if( hMemDriver == nullptr )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "GDALWarpCutlineMasker needs MEM driver");
-        return CE_Failure;
-    }
-
 /* -------------------------------------------------------------------- */
 /*      Check the polygon.                                              */
 /* -------------------------------------------------------------------- */
@@ -314,70 +721,104 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
         return CE_Failure;
     }
 
-    OGREnvelope sEnvelope;
-    OGR_G_GetEnvelope( hPolygon, &sEnvelope );
+    std::unique_ptr<GDALWarpCutlineIndex> poTmpIndex;
+    auto poIndex = static_cast<const GDALWarpCutlineIndex *>(hCutlineIndex);
+    if( poIndex == nullptr )
+    {
+        poTmpIndex.reset( static_cast<GDALWarpCutlineIndex *>(
+            GDALCreateWarpCutlineIndex( hPolygon )) );
+        if( poTmpIndex == nullptr )
+            return CE_Failure;
+        poIndex = poTmpIndex.get();
+    }
 
     float *pafMask = static_cast<float *>(pValidityMask);
 
-    if( sEnvelope.MaxX + psWO->dfCutlineBlendDist < nXOff
-        || sEnvelope.MinX - psWO->dfCutlineBlendDist > nXOff + nXSize
-        || sEnvelope.MaxY + psWO->dfCutlineBlendDist < nYOff
-        || sEnvelope.MinY - psWO->dfCutlineBlendDist > nYOff + nYSize )
+/* -------------------------------------------------------------------- */
+/*      Windows not crossed by the cutline, or its blend area, are      */
+/*      either completely masked, or left untouched.                    */
+/* -------------------------------------------------------------------- */
+    const bool bAllTouched =
+        CPLFetchBool( psWO->papszWarpOptions, "CUTLINE_ALL_TOUCHED", false );
+    const double dfMargin = psWO->dfCutlineBlendDist > 0 ?
+        psWO->dfCutlineBlendDist + 1 : bAllTouched ? 1 : 0;
+    const int nStatus = GDALWarpCutlineIndexGetStatus(
+        const_cast<GDALWarpCutlineIndex *>(poIndex),
+        nXOff - dfMargin, nYOff - dfMargin,
+        nXOff + nXSize + dfMargin, nYOff + nYSize + dfMargin );
+    if( nStatus == GCWS_OUTSIDE )
     {
-        // We are far from the blend line - everything is masked to zero.
-        // It would be nice to realize no work is required for this whole
-        // chunk!
         memset( pafMask, 0, sizeof(float) * nXSize * nYSize );
         return CE_None;
     }
+    if( nStatus == GCWS_INSIDE )
+    {
+        return CE_None;
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Create a byte buffer into which we can burn the                 */
-/*      mask polygon and wrap it up as a memory dataset.                */
+/*      Create a byte buffer into which we can burn the mask polygon.   */
 /* -------------------------------------------------------------------- */
     GByte *pabyPolyMask = static_cast<GByte *>(CPLCalloc(nXSize, nYSize));
+    CPLErr eErr = CE_None;
 
-    char szDataPointer[100] = {};
-
-    // cppcheck-suppress redundantCopy
-    snprintf( szDataPointer, sizeof(szDataPointer), "DATAPOINTER=" );
-    CPLPrintPointer(
-        szDataPointer+strlen(szDataPointer),
-        pabyPolyMask,
-        static_cast<int>(sizeof(szDataPointer) - strlen(szDataPointer)) );
-
-    GDALDatasetH hMemDS = GDALCreate( hMemDriver, "warp_temp",
-                                      nXSize, nYSize, 0, GDT_Byte, nullptr );
-    char *apszOptions[] = { szDataPointer, nullptr };
-    GDALAddBand( hMemDS, GDT_Byte, apszOptions );
-
-    double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
-    GDALSetGeoTransform( hMemDS, adfGeoTransform );
-
+    if( !bAllTouched )
+    {
+        BurnCutlineMask( poIndex, nXOff, nYOff, nXSize, nYSize,
+                         pabyPolyMask );
+    }
+    else
+    {
 /* -------------------------------------------------------------------- */
-/*      Burn the polygon into the mask with 1.0 values.                 */
+/*      The all touched mode is not implemented by BurnCutlineMask(),   */
+/*      so wrap the buffer up as a memory dataset, and burn the         */
+/*      polygon into it with GDALRasterizeGeometries().                 */
 /* -------------------------------------------------------------------- */
-    int nTargetBand = 1;
-    double dfBurnValue = 255.0;
-    char **papszRasterizeOptions = nullptr;
-
-    if( CPLFetchBool( psWO->papszWarpOptions, "CUTLINE_ALL_TOUCHED", false ))
-        papszRasterizeOptions =
-            CSLSetNameValue( papszRasterizeOptions, "ALL_TOUCHED", "TRUE" );
-
-    int anXYOff[2] = { nXOff, nYOff };
-
-    CPLErr eErr =
-        GDALRasterizeGeometries( hMemDS, 1, &nTargetBand,
-                                 1, &hPolygon,
-                                 CutlineTransformer, anXYOff,
-                                 &dfBurnValue, papszRasterizeOptions,
-                                 nullptr, nullptr );
-
-    CSLDestroy( papszRasterizeOptions );
+        GDALDriverH hMemDriver = GDALGetDriverByName("MEM");
+        if( hMemDriver == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GDALWarpCutlineMasker needs MEM driver");
+            CPLFree( pabyPolyMask );
+            return CE_Failure;
+        }
 
-    // Close and ensure data flushed to underlying array.
-    GDALClose( hMemDS );
+        char szDataPointer[100] = {};
+
+        // cppcheck-suppress redundantCopy
+        snprintf( szDataPointer, sizeof(szDataPointer), "DATAPOINTER=" );
+        CPLPrintPointer(
+            szDataPointer+strlen(szDataPointer),
+            pabyPolyMask,
+            static_cast<int>(sizeof(szDataPointer) - strlen(szDataPointer)) );
+
+        GDALDatasetH hMemDS = GDALCreate( hMemDriver, "warp_temp",
+                                          nXSize, nYSize, 0, GDT_Byte,
+                                          nullptr );
+        char *apszOptions[] = { szDataPointer, nullptr };
+        GDALAddBand( hMemDS, GDT_Byte, apszOptions );
+
+        double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+        GDALSetGeoTransform( hMemDS, adfGeoTransform );
+
+        int nTargetBand = 1;
+        double dfBurnValue = 255.0;
+        const char* const apszRasterizeOptions[] = { "ALL_TOUCHED=TRUE",
+                                                     nullptr };
+
+        int anXYOff[2] = { nXOff, nYOff };
+
+        eErr =
+            GDALRasterizeGeometries( hMemDS, 1, &nTargetBand,
+                                     1, &hPolygon,
+                                     CutlineTransformer, anXYOff,
+                                     &dfBurnValue,
+                                     const_cast<char**>(apszRasterizeOptions),
+                                     nullptr, nullptr );
+
+        // Close and ensure data flushed to underlying array.
+        GDALClose( hMemDS );
+    }
 
 /* -------------------------------------------------------------------- */
 /*      In the case with no blend distance, we just apply this as a     */
@@ -388,14 +829,13 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
         for( int i = nXSize * nYSize - 1; i >= 0; i-- )
         {
             if( pabyPolyMask[i] == 0 )
-                static_cast<float *>(pValidityMask)[i] = 0.0;
+                pafMask[i] = 0.0;
         }
     }
     else
     {
         eErr = BlendMaskGenerator( nXOff, nYOff, nXSize, nYSize,
-                                   pabyPolyMask,
-                                   static_cast<float *>(pValidityMask),
+                                   pabyPolyMask, pafMask,
                                    hPolygon, psWO->dfCutlineBlendDist );
     }
 
@@ -406,3 +846,4 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
 
     return eErr;
 }
+/*! @endcond */
@@ -40,6 +40,7 @@
 #include "cpl_port.h"
 #include "cpl_conv.h"
 #include "gdallinearsystem.h"
+#include "gdal_thread_pool.h"
 
 #ifdef HAVE_ARMADILLO
 #include "armadillo_headers.h"
@@ -49,15 +50,91 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <memory>
 
 CPL_CVSID("$Id$")
 
 #ifndef HAVE_ARMADILLO
 namespace
 {
+    // Width of the panels of the blocked LU decomposition.
+    constexpr int LU_PANEL_WIDTH = 64;
+    // Number of rows of the trailing matrix updated at once, so that the
+    // corresponding part of the panel stays in cache.
+    constexpr int LU_ROW_BLOCK = 256;
+
+    struct LUColumnsJob
+    {
+        GDALMatrix *poA;
+        int nPanelStart;   // first column of the panel
+        int nPanelEnd;     // last column of the panel + 1
+        const int *panPivots;  // row swapped with each row of the panel
+        int nColStart;     // first column to process
+        int nColEnd;       // last column to process + 1
+    };
+
+    // Apply the row swaps of a panel, and the corresponding transformations,
+    // to columns outside of this panel.
+    void UpdateLUColumns( void *pData )
+    {
+        const LUColumnsJob *psJob = static_cast<const LUColumnsJob *>(pData);
+        GDALMatrix &A = *(psJob->poA);
+        const int m = A.getNumRows();
+        const int k0 = psJob->nPanelStart;
+        const int k1 = psJob->nPanelEnd;
+
+        for( int iCol = psJob->nColStart; iCol < psJob->nColEnd; ++iCol )
+        {
+            for( int step = k0; step < k1; ++step )
+            {
+                const int iMax = psJob->panPivots[step - k0];
+                if( iMax != step )
+                    std::swap(A(iMax, iCol), A(step, iCol));
+            }
+        }
+
+        // Columns at the left of the panel are already factorized.
+        const int nColStart = std::max(psJob->nColStart, k1);
+        for( int iCol = nColStart; iCol < psJob->nColEnd; ++iCol )
+        {
+            // Forward substitution with the unit lower triangle of the panel
+            double *padfCol = &A(0, iCol);
+            for( int step = k0; step < k1; ++step )
+            {
+                const double dfVal = padfCol[step];
+                const double *padfL = &A(0, step);
+                for( int iRow = step + 1; iRow < k1; ++iRow )
+                    padfCol[iRow] -= padfL[iRow] * dfVal;
+            }
+        }
+
+        // Update of the trailing matrix, by blocks of rows.
+        for( int iRowStart = k1; iRowStart < m; iRowStart += LU_ROW_BLOCK )
+        {
+            const int iRowEnd = std::min(m, iRowStart + LU_ROW_BLOCK);
+            for( int iCol = nColStart; iCol < psJob->nColEnd; ++iCol )
+            {
+                double *padfCol = &A(0, iCol);
+                for( int step = k0; step < k1; ++step )
+                {
+                    const double dfVal = padfCol[step];
+                    if( dfVal == 0.0 )
+                        continue;
+                    const double *padfL = &A(0, step);
+                    for( int iRow = iRowStart; iRow < iRowEnd; ++iRow )
+                        padfCol[iRow] -= padfL[iRow] * dfVal;
+                }
+            }
+        }
+    }
+
     // LU decomposition of the quadratic matrix A
     // see https://en.wikipedia.org/wiki/LU_decomposition#C_code_examples
-    bool solve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X, double eps )
+    // The decomposition is done by panels of LU_PANEL_WIDTH columns, so that
+    // the update of the rest of the matrix can be split by columns between
+    // several threads, and is done with a better cache usage.
+    bool solve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X, double eps,
+                int nThreads )
     {
         assert(A.getNumRows() == A.getNumCols());
         if(eps < 0) return false;
@@ -68,43 +145,102 @@ namespace
         for(int iRow = 0; iRow < m; ++iRow)
             perm[iRow] = iRow;
 
-        for(int step = 0; step < m - 1; ++step)
+        CPLWorkerThreadPool* poThreadPool =
+            nThreads > 1 && m > 2 * LU_PANEL_WIDTH ?
+                GDALGetGlobalThreadPool(nThreads) : nullptr;
+        auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() :
+                                         std::unique_ptr<CPLJobQueue>();
+        std::vector<int> anPivots;
+        std::vector<LUColumnsJob> asJobs;
+
+        for(int k0 = 0; k0 < m - 1; k0 += LU_PANEL_WIDTH)
         {
-            // determine pivot element
-            int iMax = step;
-            double dMax = std::abs(A(step, step));
-            for(int i = step + 1; i < m; ++i)
+            const int k1 = std::min(m, k0 + LU_PANEL_WIDTH);
+            anPivots.resize(k1 - k0);
+
+            // Unblocked decomposition of the panel
+            for(int step = k0; step < k1; ++step)
             {
-                if(std::abs(A(i, step)) > dMax)
+                anPivots[step - k0] = step;
+                if( step == m - 1 )
+                    break;
+                // determine pivot element
+                int iMax = step;
+                double dMax = std::abs(A(step, step));
+                for(int i = step + 1; i < m; ++i)
                 {
-                    iMax = i;
-                    dMax = std::abs(A(i, step));
+                    if(std::abs(A(i, step)) > dMax)
+                    {
+                        iMax = i;
+                        dMax = std::abs(A(i, step));
+                    }
+                }
+                if(dMax <= eps)
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined, "GDALLinearSystemSolve: matrix not invertible" );
+                    return false;
+                }
+                // swap rows, in the panel only for now
+                anPivots[step - k0] = iMax;
+                if(iMax != step)
+                {
+                    std::swap(perm[iMax], perm[step]);
+                    for(int iCol = k0; iCol < k1; ++iCol)
+                    {
+                        std::swap(A(iMax, iCol), A(step, iCol));
+                    }
+                }
+                for(int iRow = step + 1; iRow < m; ++iRow)
+                {
+                    A(iRow, step) /= A(step, step);
+                }
+                for(int iCol = step + 1; iCol < k1; ++iCol)
+                {
+                    for(int iRow = step + 1; iRow < m; ++iRow)
+                    {
+                        A(iRow, iCol) -= A(iRow, step) * A(step, iCol);
+                    }
                 }
             }
-            if(dMax <= eps)
-            {
-                CPLError( CE_Failure, CPLE_AppDefined, "GDALLinearSystemSolve: matrix not invertible" );
-                return false;
-            }
-            // swap rows
-            if(iMax != step)
+
+            // Apply the panel to the other columns
+            const int nCols = m - (k1 - k0);
+            if( nCols == 0 )
+                continue;
+            const int nJobs = poJobQueue ?
+                std::max(1, std::min(4 * nThreads, (m - k1) / 16)) : 1;
+            const int nColsPerJob = (nCols + nJobs - 1) / nJobs;
+            asJobs.clear();
+            for(int iJob = 0; iJob < nJobs; ++iJob)
             {
-                std::swap(perm[iMax], perm[step]);
-                for(int iCol = 0; iCol < m; ++iCol)
+                // Columns are numbered skipping the ones of the panel.
+                int nStart = iJob * nColsPerJob;
+                int nEnd = std::min(nCols, nStart + nColsPerJob);
+                if( nStart >= nEnd )
+                    break;
+                // Split ranges that contain the panel.
+                if( nStart < k0 && nEnd > k0 )
                 {
-                    std::swap(A(iMax, iCol), A(step, iCol));
+                    asJobs.push_back({&A, k0, k1, anPivots.data(), nStart, k0});
+                    nStart = k0;
+                }
+                if( nStart >= k0 )
+                {
+                    nStart += k1 - k0;
+                    nEnd += k1 - k0;
                 }
+                asJobs.push_back({&A, k0, k1, anPivots.data(), nStart, nEnd});
             }
-            for(int iRow = step + 1; iRow < m; ++iRow)
+            if( poJobQueue )
             {
-                A(iRow, step) /= A(step, step);
+                for( auto& sJob: asJobs )
+                    poJobQueue->SubmitJob(UpdateLUColumns, &sJob);
+                poJobQueue->WaitCompletion();
             }
-            for(int iCol = step + 1; iCol < m; ++iCol)
+            else
             {
-                for(int iRow = step + 1; iRow < m; ++iRow)
-                {
-                    A(iRow, iCol) -= A(iRow, step) * A(step, iCol);
-                }
+                for( auto& sJob: asJobs )
+                    UpdateLUColumns(&sJob);
             }
         }
 
@@ -114,18 +250,24 @@ namespace
             for (int iRow = 0; iRow < m; ++iRow)
             {
                 X(iRow, iCol) = RHS(perm[iRow], iCol);
-                for (int k = 0; k < iRow; ++k)
+            }
+            // Column oriented substitutions, to access A by columns.
+            for (int k = 0; k < m; ++k)
+            {
+                const double dfVal = X(k, iCol);
+                for (int iRow = k + 1; iRow < m; ++iRow)
                 {
-                    X(iRow, iCol) -= A(iRow, k) * X(k, iCol);
+                    X(iRow, iCol) -= A(iRow, k) * dfVal;
                 }
             }
-            for (int iRow = m - 1; iRow >= 0; --iRow)
+            for (int k = m - 1; k >= 0; --k)
             {
-                for (int k = iRow + 1; k < m; ++k)
+                X(k, iCol) /= A(k, k);
+                const double dfVal = X(k, iCol);
+                for (int iRow = 0; iRow < k; ++iRow)
                 {
-                    X(iRow, iCol) -= A(iRow, k) * X(k, iCol);
+                    X(iRow, iCol) -= A(iRow, k) * dfVal;
                 }
-                X(iRow, iCol) /= A(iRow, iRow);
             }
         }
         return true;
@@ -136,9 +278,11 @@ namespace
 /*                       GDALLinearSystemSolve()                        */
 /*                                                                      */
 /*   Solves the linear system A*X_i = RHS_i for each column i           */
-/*   where A is a square matrix.                                        */
+/*   where A is a square matrix. A is modified. Without Armadillo, the  */
+/*   decomposition of A may use nThreads threads of the global pool.    */
 /************************************************************************/
-bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X )
+bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X,
+                            int nThreads )
 {
     assert(A.getNumRows() == RHS.getNumRows());
     assert(A.getNumCols() == X.getNumRows());
@@ -146,6 +290,8 @@ bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X )
     try
     {
 #ifdef HAVE_ARMADILLO
+        // Multi-threading is left to the LAPACK implementation.
+        CPL_IGNORE_RET_VAL(nThreads);
         arma::mat matA( A.data(), A.getNumRows(), A.getNumCols(), false, true );
         arma::mat matRHS(RHS.data(), RHS.getNumRows(), RHS.getNumCols(), false, true );
         arma::mat matOut(X.data(), X.getNumRows(), X.getNumCols(), false, true);
@@ -158,7 +304,7 @@ bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X )
 #endif
 
 #else //HAVE_ARMADILLO
-        return solve(A, RHS, X, 0);
+        return solve(A, RHS, X, 0, nThreads);
 #endif
     }
     catch(std::exception const & e) {
@@ -69,7 +69,8 @@ private:
     std::vector<double> v;
 };
 
-bool GDALLinearSystemSolve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X );
+bool GDALLinearSystemSolve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X,
+                            int nThreads = 1 );
 
 
 #endif /* #ifndef GDALLINEARSYSTEM_H_INCLUDED */
@@ -1428,6 +1428,10 @@ bool GDALComputeAreaOfInterest(OGRSpatialReference* poSRS,
  * <li> MAX_GCP_ORDER: the maximum order to use for GCP derived polynomials if
  * possible.  The default is to autoselect based on the number of GCPs.
  * A value of -1 triggers use of Thin Plate Spline instead of polynomials.
+ * <li> TPS_APPROX_ERROR_IN_PIXEL=err_threshold_in_pixel. (GDAL &gt;= 3.4)
+ * When using a Thin Plate Spline, approximate the contribution of the GCPs
+ * far from the transformed points, with an error of at most err_threshold_in_pixel.
+ * This speeds up the transformation when there are thousands of GCPs.
  * <li> SRC_METHOD: may have a value which is one of GEOTRANSFORM,
  * GCP_POLYNOMIAL, GCP_TPS, GEOLOC_ARRAY, RPC to force only one geolocation
  * method to be considered on the source dataset. Will be used for pixel/line
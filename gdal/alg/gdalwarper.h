@@ -117,6 +117,27 @@ GDALWarpCutlineMasker( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
                        int nXOff, int nYOff, int nXSize, int nYSize,
                        GByte ** /* ppImageData */,
                        int bMaskIsFloat, void *pValidityMask );
+
+CPLErr
+GDALWarpCutlineMaskerEx( void *pMaskFuncArg, int nBandCount, GDALDataType eType,
+                         int nXOff, int nYOff, int nXSize, int nYSize,
+                         GByte ** /* ppImageData */,
+                         int bMaskIsFloat, void *pValidityMask,
+                         void *hCutlineIndex );
+
+void *GDALCreateWarpCutlineIndex( void *hCutline );
+void GDALDestroyWarpCutlineIndex( void *hIndex );
+
+/** Status of a window relatively to a cutline */
+typedef enum {
+    GCWS_OUTSIDE = 0,
+    GCWS_INSIDE = 1,
+    GCWS_CROSSED = 2
+} GDALCutlineWindowStatus;
+
+int GDALWarpCutlineIndexGetStatus( void *hIndex,
+                                   double dfMinX, double dfMinY,
+                                   double dfMaxX, double dfMaxY );
 /*! @endcond */
 
 /************************************************************************/
@@ -513,6 +534,13 @@ public:
                                        int nDstXSize, int nDstYSize );
     CPLErr          ChunkAndWarpMulti( int nDstXOff, int nDstYOff,
                                        int nDstXSize, int nDstYSize );
+    static CPLErr   ChunkAndWarpConcurrently(
+                                    int nOperations,
+                                    GDALWarpOperation* const* papoOperations,
+                                    const int* panDstWindows,
+                                    int nThreads,
+                                    GDALProgressFunc pfnProgress,
+                                    void* pProgressData );
     CPLErr          WarpRegion( int nDstXOff, int nDstYOff,
                                 int nDstXSize, int nDstYSize,
                                 int nSrcXOff=0, int nSrcYOff=0,
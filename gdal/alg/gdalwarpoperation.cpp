@@ -37,16 +37,22 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_priv.h"
@@ -68,6 +74,16 @@ struct GDALWarpPrivateData
     std::vector<int> abSuccess{};
     std::vector<double> adfDstX{};
     std::vector<double> adfDstY{};
+    void* hCutlineIndex = nullptr;
+
+    GDALWarpPrivateData() = default;
+    ~GDALWarpPrivateData()
+    {
+        if( hCutlineIndex )
+            GDALDestroyWarpCutlineIndex(hCutlineIndex);
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALWarpPrivateData)
 };
 
 static std::mutex gMutex{};
@@ -637,6 +653,18 @@ CPLErr GDALWarpOperation::Initialize( const GDALWarpOptions *psNewOptions )
             eErr = CE_Failure;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Index the edges of the cutline once for all chunks.             */
+/* -------------------------------------------------------------------- */
+    if( eErr == CE_None && psOptions->hCutline != nullptr )
+    {
+        GDALWarpPrivateData* privateData = GetWarpPrivateData(this);
+        if( privateData->hCutlineIndex )
+            GDALDestroyWarpCutlineIndex(privateData->hCutlineIndex);
+        privateData->hCutlineIndex =
+            GDALCreateWarpCutlineIndex(psOptions->hCutline);
+    }
+
     return eErr;
 }
 
@@ -663,7 +691,21 @@ void* GDALWarpOperation::CreateDestinationBuffer(
 /* -------------------------------------------------------------------- */
     const int nWordSize = GDALGetDataTypeSizeBytes(psOptions->eWorkingDataType);
 
-    void *pDstBuffer = VSI_MALLOC3_VERBOSE( nWordSize * psOptions->nBandCount, nDstXSize, nDstYSize );
+    const size_t nPixelSize =
+        static_cast<size_t>(nWordSize) * psOptions->nBandCount;
+    if( nDstXSize > 0 && nDstYSize > 0 &&
+        nPixelSize > std::numeric_limits<size_t>::max() / nDstXSize /
+                                                         nDstYSize )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Integer overflow : nDstXSize=%d, nDstYSize=%d",
+                 nDstXSize, nDstYSize);
+        return nullptr;
+    }
+    // Large buffer allocation, to benefit from huge pages and NUMA local
+    // placement when enabled.
+    void *pDstBuffer = VSI_MALLOC_LARGE_VERBOSE(
+        nPixelSize * nDstXSize * nDstYSize );
     if( pDstBuffer == nullptr )
     {
         return nullptr;
@@ -765,7 +807,7 @@ void* GDALWarpOperation::CreateDestinationBuffer(
  */
 void GDALWarpOperation::DestroyDestinationBuffer( void *pDstBuffer )
 {
-    VSIFree( pDstBuffer );
+    VSIFreeLarge( pDstBuffer );
 }
 
 /************************************************************************/
@@ -1223,6 +1265,373 @@ CPLErr GDALChunkAndWarpMulti( GDALWarpOperationH hOperation,
         ChunkAndWarpMulti( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
 }
 
+/************************************************************************/
+/*                      ChunkAndWarpConcurrently()                      */
+/************************************************************************/
+
+namespace {
+
+struct GDALConcurrentWarpTask
+{
+    GDALWarpOperation *poOperation = nullptr;
+    GDALWarpChunk      sChunk{};
+    int                nPendingDeps = 0;
+    std::vector<int>   anSuccessors{};
+};
+
+struct GDALConcurrentWarpContext
+{
+    std::vector<GDALConcurrentWarpTask> asTasks{};
+    CPLMutex               *hIOMutex = nullptr;
+
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    std::set<int>           oReadyTasks{};
+    size_t                  nRemainingTasks = 0;
+    double                  dfPixelsProcessed = 0;
+    bool                    bStop = false;
+    CPLErr                  eErr = CE_None;
+};
+
+} // namespace
+
+static void ConcurrentWarpThreadMain( void *pThreadData )
+{
+    auto psCtxt = static_cast<GDALConcurrentWarpContext*>(pThreadData);
+    std::unique_lock<std::mutex> oLock(psCtxt->oMutex);
+    while( true )
+    {
+        while( psCtxt->oReadyTasks.empty() && !psCtxt->bStop &&
+               psCtxt->nRemainingTasks > 0 )
+        {
+            psCtxt->oCV.wait(oLock);
+        }
+        if( psCtxt->oReadyTasks.empty() || psCtxt->bStop )
+            break;
+
+        // Lowest task first, so that sources are processed roughly in order.
+        const int iTask = *(psCtxt->oReadyTasks.begin());
+        psCtxt->oReadyTasks.erase(psCtxt->oReadyTasks.begin());
+        oLock.unlock();
+
+        const GDALConcurrentWarpTask& sTask = psCtxt->asTasks[iTask];
+        const GDALWarpChunk& sChunk = sTask.sChunk;
+        CPLErr eErr = CE_Failure;
+        if( !CPLAcquireMutex( psCtxt->hIOMutex, 600.0 ) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Failed to acquire IOMutex in WarpRegion()." );
+        }
+        else
+        {
+            eErr = sTask.poOperation->WarpRegion(
+                sChunk.dx, sChunk.dy, sChunk.dsx, sChunk.dsy,
+                sChunk.sx, sChunk.sy, sChunk.ssx, sChunk.ssy,
+                sChunk.sExtraSx, sChunk.sExtraSy, 0.0, 1.0);
+            CPLReleaseMutex( psCtxt->hIOMutex );
+        }
+
+        oLock.lock();
+        psCtxt->nRemainingTasks--;
+        psCtxt->dfPixelsProcessed +=
+            static_cast<double>(sChunk.dsx) * sChunk.dsy;
+        if( eErr != CE_None )
+        {
+            psCtxt->eErr = eErr;
+            psCtxt->bStop = true;
+        }
+        for( const int iSuccessor: sTask.anSuccessors )
+        {
+            if( --psCtxt->asTasks[iSuccessor].nPendingDeps == 0 )
+                psCtxt->oReadyTasks.insert(iSuccessor);
+        }
+        psCtxt->oCV.notify_all();
+    }
+}
+
+/**
+ * \brief Warp several sources into the same destination concurrently.
+ *
+ * Each operation warps a different source into the same destination
+ * dataset. This method gives the same result as calling ChunkAndWarpImage()
+ * on each operation in turn: a chunk of an operation is only warped once
+ * the chunks of the previous operations that overlap it have been written,
+ * so where sources overlap, the last one wins. Chunks that do not overlap
+ * are warped by nThreads threads. Reading and writing of pixels is done
+ * by one thread at a time, and the warping kernels of the different
+ * operations run in parallel.
+ *
+ * The progress functions of the operations are not called: progress is
+ * reported to pfnProgress, from the calling thread.
+ *
+ * @param nOperations Number of operations.
+ * @param papoOperations Initialized operations, in the order sources must
+ * be composited. They must all have the same destination dataset.
+ * @param panDstWindows Destination window (x offset, y offset, width and
+ * height) of each operation, 4 values per operation.
+ * @param nThreads Number of threads.
+ * @param pfnProgress Progress function, or NULL.
+ * @param pProgressData Argument of the progress function.
+ *
+ * @return CE_None on success or CE_Failure if an error occurs.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALWarpOperation::ChunkAndWarpConcurrently(
+    int nOperations, GDALWarpOperation* const* papoOperations,
+    const int* panDstWindows, int nThreads,
+    GDALProgressFunc pfnProgress, void* pProgressData )
+{
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    for( int iOp = 0; iOp < nOperations; iOp++ )
+    {
+        if( papoOperations[iOp]->psOptions == nullptr ||
+            papoOperations[iOp]->psOptions->hDstDS !=
+                papoOperations[0]->psOptions->hDstDS )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "ChunkAndWarpConcurrently(): operations must be "
+                      "initialized and share the same destination dataset" );
+            return CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the chunks of all operations.                           */
+/* -------------------------------------------------------------------- */
+    GDALConcurrentWarpContext sCtxt;
+    std::vector<int> anOperationOfTask;
+    double dfTotalPixels = 0;
+    for( int iOp = 0; iOp < nOperations; iOp++ )
+    {
+        GDALWarpOperation* poOp = papoOperations[iOp];
+        poOp->CollectChunkList( panDstWindows[4 * iOp + 0],
+                                panDstWindows[4 * iOp + 1],
+                                panDstWindows[4 * iOp + 2],
+                                panDstWindows[4 * iOp + 3] );
+        for( int iChunk = 0;
+             poOp->pasChunkList != nullptr && iChunk < poOp->nChunkListCount;
+             iChunk++ )
+        {
+            GDALConcurrentWarpTask sTask;
+            sTask.poOperation = poOp;
+            sTask.sChunk = poOp->pasChunkList[iChunk];
+            dfTotalPixels +=
+                static_cast<double>(sTask.sChunk.dsx) * sTask.sChunk.dsy;
+            sCtxt.asTasks.emplace_back(std::move(sTask));
+            anOperationOfTask.push_back(iOp);
+        }
+        poOp->WipeChunkList();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      A chunk only depends on the most recent earlier chunks that     */
+/*      write to some part of it: the older writers of that part are    */
+/*      already dependencies of those. The candidates are found with    */
+/*      a spatial index, and the chunk is split along their edges to    */
+/*      find the last writer of each cell.                              */
+/* -------------------------------------------------------------------- */
+    const int nTasks = static_cast<int>(sCtxt.asTasks.size());
+    std::vector<CPLRectObj> asBounds(nTasks);
+    for( int iTask = 0; iTask < nTasks; iTask++ )
+    {
+        const GDALWarpChunk& sChunk = sCtxt.asTasks[iTask].sChunk;
+        asBounds[iTask].minx = sChunk.dx;
+        asBounds[iTask].miny = sChunk.dy;
+        asBounds[iTask].maxx = static_cast<double>(sChunk.dx) + sChunk.dsx;
+        asBounds[iTask].maxy = static_cast<double>(sChunk.dy) + sChunk.dsy;
+    }
+    CPLPackedRTree* hTree = CPLPackedRTreeCreate( nTasks, asBounds.data(), 0 );
+    if( hTree == nullptr )
+        return CE_Failure;
+
+    for( int iTask = 0; iTask < nTasks; iTask++ )
+    {
+        auto& sTask = sCtxt.asTasks[iTask];
+        const GDALWarpChunk& sChunk = sTask.sChunk;
+
+        int nCount = 0;
+        int* panCandidates =
+            CPLPackedRTreeSearch( hTree, &asBounds[iTask], &nCount );
+        std::vector<int> anPrev;
+        for( int i = 0; i < nCount; i++ )
+        {
+            const int iPrev = panCandidates[i];
+            // Chunks of the same operation never overlap, and the search
+            // also returns chunks that only touch this one.
+            if( iPrev >= iTask ||
+                anOperationOfTask[iPrev] == anOperationOfTask[iTask] )
+                continue;
+            const GDALWarpChunk& sPrevChunk = sCtxt.asTasks[iPrev].sChunk;
+            if( sPrevChunk.dx < sChunk.dx + sChunk.dsx &&
+                sChunk.dx < sPrevChunk.dx + sPrevChunk.dsx &&
+                sPrevChunk.dy < sChunk.dy + sChunk.dsy &&
+                sChunk.dy < sPrevChunk.dy + sPrevChunk.dsy )
+            {
+                anPrev.push_back(iPrev);
+            }
+        }
+        CPLFree( panCandidates );
+
+        if( !anPrev.empty() )
+        {
+            std::vector<int> anX{ sChunk.dx, sChunk.dx + sChunk.dsx };
+            std::vector<int> anY{ sChunk.dy, sChunk.dy + sChunk.dsy };
+            for( const int iPrev: anPrev )
+            {
+                const GDALWarpChunk& sPrevChunk = sCtxt.asTasks[iPrev].sChunk;
+                anX.push_back(std::max(sPrevChunk.dx, sChunk.dx));
+                anX.push_back(std::min(sPrevChunk.dx + sPrevChunk.dsx,
+                                       sChunk.dx + sChunk.dsx));
+                anY.push_back(std::max(sPrevChunk.dy, sChunk.dy));
+                anY.push_back(std::min(sPrevChunk.dy + sPrevChunk.dsy,
+                                       sChunk.dy + sChunk.dsy));
+            }
+            std::sort(anX.begin(), anX.end());
+            anX.erase(std::unique(anX.begin(), anX.end()), anX.end());
+            std::sort(anY.begin(), anY.end());
+            anY.erase(std::unique(anY.begin(), anY.end()), anY.end());
+
+            const size_t nCellsX = anX.size() - 1;
+            size_t nUncoveredCells = nCellsX * (anY.size() - 1);
+            std::vector<bool> abCovered(nUncoveredCells, false);
+
+            // Most recent chunks first.
+            std::sort(anPrev.begin(), anPrev.end(), std::greater<int>());
+            for( const int iPrev: anPrev )
+            {
+                const GDALWarpChunk& sPrevChunk = sCtxt.asTasks[iPrev].sChunk;
+                const size_t iX0 = std::lower_bound(anX.begin(), anX.end(),
+                    std::max(sPrevChunk.dx, sChunk.dx)) - anX.begin();
+                const size_t iX1 = std::lower_bound(anX.begin(), anX.end(),
+                    std::min(sPrevChunk.dx + sPrevChunk.dsx,
+                             sChunk.dx + sChunk.dsx)) - anX.begin();
+                const size_t iY0 = std::lower_bound(anY.begin(), anY.end(),
+                    std::max(sPrevChunk.dy, sChunk.dy)) - anY.begin();
+                const size_t iY1 = std::lower_bound(anY.begin(), anY.end(),
+                    std::min(sPrevChunk.dy + sPrevChunk.dsy,
+                             sChunk.dy + sChunk.dsy)) - anY.begin();
+                bool bLastWriter = false;
+                for( size_t iY = iY0; iY < iY1; iY++ )
+                {
+                    for( size_t iX = iX0; iX < iX1; iX++ )
+                    {
+                        if( !abCovered[iY * nCellsX + iX] )
+                        {
+                            abCovered[iY * nCellsX + iX] = true;
+                            nUncoveredCells--;
+                            bLastWriter = true;
+                        }
+                    }
+                }
+                if( bLastWriter )
+                {
+                    sCtxt.asTasks[iPrev].anSuccessors.push_back(iTask);
+                    sTask.nPendingDeps++;
+                }
+                if( nUncoveredCells == 0 )
+                    break;
+            }
+        }
+        if( sTask.nPendingDeps == 0 )
+            sCtxt.oReadyTasks.insert(iTask);
+    }
+    CPLPackedRTreeDestroy( hTree );
+    sCtxt.nRemainingTasks = sCtxt.asTasks.size();
+
+    CPLDebug( "WARP", "Warping %d chunks of %d sources with %d threads",
+              nTasks, nOperations, nThreads );
+
+/* -------------------------------------------------------------------- */
+/*      All operations share the same IO mutex, and each one has its    */
+/*      own warp mutex, so that warping kernels run in parallel.        */
+/* -------------------------------------------------------------------- */
+    sCtxt.hIOMutex = CPLCreateMutex();
+    CPLReleaseMutex( sCtxt.hIOMutex );
+    for( int iOp = 0; iOp < nOperations; iOp++ )
+    {
+        GDALWarpOperation* poOp = papoOperations[iOp];
+        if( poOp->hIOMutex != nullptr )
+        {
+            CPLDestroyMutex( poOp->hIOMutex );
+            CPLDestroyMutex( poOp->hWarpMutex );
+        }
+        poOp->hIOMutex = sCtxt.hIOMutex;
+        poOp->hWarpMutex = CPLCreateMutex();
+        CPLReleaseMutex( poOp->hWarpMutex );
+    }
+
+    std::vector<CPLJoinableThread*> ahThreads;
+    for( int i = 0; i < std::max(1, std::min(nThreads, nTasks)); i++ )
+    {
+        CPLJoinableThread* hThread =
+            CPLCreateJoinableThread(ConcurrentWarpThreadMain, &sCtxt);
+        if( hThread == nullptr )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "CPLCreateJoinableThread() failed in "
+                      "ChunkAndWarpConcurrently()" );
+            std::lock_guard<std::mutex> oLock(sCtxt.oMutex);
+            sCtxt.eErr = CE_Failure;
+            sCtxt.bStop = true;
+            sCtxt.oCV.notify_all();
+            break;
+        }
+        ahThreads.push_back(hThread);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Report progress until all chunks are done.                      */
+/* -------------------------------------------------------------------- */
+    {
+        std::unique_lock<std::mutex> oLock(sCtxt.oMutex);
+        double dfLastPixelsProcessed = -1;
+        while( true )
+        {
+            if( sCtxt.dfPixelsProcessed != dfLastPixelsProcessed )
+            {
+                dfLastPixelsProcessed = sCtxt.dfPixelsProcessed;
+                oLock.unlock();
+                const bool bContinue = CPL_TO_BOOL(pfnProgress(
+                    dfTotalPixels > 0 ?
+                        dfLastPixelsProcessed / dfTotalPixels : 1.0,
+                    "", pProgressData ));
+                oLock.lock();
+                if( !bContinue && !sCtxt.bStop )
+                {
+                    CPLError( CE_Failure, CPLE_UserInterrupt,
+                              "User terminated" );
+                    sCtxt.eErr = CE_Failure;
+                    sCtxt.bStop = true;
+                    sCtxt.oCV.notify_all();
+                }
+                continue;
+            }
+            if( sCtxt.nRemainingTasks == 0 || sCtxt.bStop ||
+                ahThreads.empty() )
+                break;
+            sCtxt.oCV.wait(oLock);
+        }
+    }
+
+    for( auto hThread: ahThreads )
+        CPLJoinThread(hThread);
+
+    for( int iOp = 0; iOp < nOperations; iOp++ )
+    {
+        GDALWarpOperation* poOp = papoOperations[iOp];
+        CPLDestroyMutex( poOp->hWarpMutex );
+        poOp->hWarpMutex = nullptr;
+        poOp->hIOMutex = nullptr;
+    }
+    CPLDestroyMutex( sCtxt.hIOMutex );
+
+    return sCtxt.eErr;
+}
+
 /************************************************************************/
 /*                           WipeChunkList()                            */
 /************************************************************************/
@@ -1543,6 +1952,11 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
 {
     ReportTiming( nullptr );
 
+    CPLTraceSpan oTraceSpan("warp", "WarpChunk");
+    if( oTraceSpan.IsActive() )
+        oTraceSpan.SetDetailf("dst %d,%d %dx%d",
+                              nDstXOff, nDstYOff, nDstXSize, nDstYSize);
+
 /* -------------------------------------------------------------------- */
 /*      Allocate the output buffer.                                     */
 /* -------------------------------------------------------------------- */
@@ -1560,6 +1974,7 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
     GDALDataset* poDstDS = reinterpret_cast<GDALDataset*>(psOptions->hDstDS);
     if( !bDstBufferInitialized )
     {
+        CPLTraceSpan oTraceSpanRead("warp", "WarpDstRead");
         CPLErr eErr = CE_None;
         if( psOptions->nBandCount == 1 )
         {
@@ -1608,6 +2023,7 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
 /* -------------------------------------------------------------------- */
     if( eErr == CE_None )
     {
+        CPLTraceSpan oTraceSpanWrite("warp", "WarpDstWrite");
         if( psOptions->nBandCount == 1 )
         {
             // Particular case to simplify the stack a bit.
@@ -1795,6 +2211,38 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      Nothing is warped from a source window which is completely      */
+/*      outside of the cutline, so do not even read it.                 */
+/* -------------------------------------------------------------------- */
+    void* hCutlineIndex = nullptr;
+    if( psOptions->hCutline != nullptr )
+    {
+        hCutlineIndex = GetWarpPrivateData(this)->hCutlineIndex;
+        const double dfMargin = psOptions->dfCutlineBlendDist > 0 ?
+                                    psOptions->dfCutlineBlendDist + 1 : 1;
+        if( hCutlineIndex != nullptr && nSrcXSize > 0 && nSrcYSize > 0 &&
+            GDALWarpCutlineIndexGetStatus(hCutlineIndex,
+                                          nSrcXOff - dfMargin,
+                                          nSrcYOff - dfMargin,
+                                          nSrcXOff + nSrcXSize + dfMargin,
+                                          nSrcYOff + nSrcYSize + dfMargin)
+                == GCWS_OUTSIDE )
+        {
+            CPLDebug("WARP",
+                     "Source window %d,%d,%dx%d is outside of the cutline",
+                     nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize);
+            if( psOptions->pfnProgress != nullptr &&
+                !psOptions->pfnProgress(dfProgressBase + dfProgressScale, "",
+                                        psOptions->pProgressArg) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                return CE_Failure;
+            }
+            return CE_None;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Prepare a WarpKernel object to match this operation.            */
 /* -------------------------------------------------------------------- */
@@ -1845,7 +2293,7 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     oWK.papabySrcImage = static_cast<GByte **>(
         CPLCalloc(sizeof(GByte*), psOptions->nBandCount));
     oWK.papabySrcImage[0] = static_cast<GByte *>(
-        VSI_MALLOC_VERBOSE(static_cast<size_t>(nAlloc64)));
+        VSI_MALLOC_LARGE_VERBOSE(static_cast<size_t>(nAlloc64)));
 
     CPLErr eErr =
         nSrcXSize != 0 && nSrcYSize != 0 && oWK.papabySrcImage[0] == nullptr
@@ -1859,6 +2307,10 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 
     if( eErr == CE_None && nSrcXSize > 0 && nSrcYSize > 0 )
     {
+        CPLTraceSpan oTraceSpanRead("warp", "WarpSrcRead");
+        if( oTraceSpanRead.IsActive() )
+            oTraceSpanRead.SetDetailf("src %d,%d %dx%d",
+                                      nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize);
         GDALDataset* poSrcDS =
             reinterpret_cast<GDALDataset*>(psOptions->hSrcDS);
         if( psOptions->nBandCount == 1 )
@@ -1885,6 +2337,9 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 
     ReportTiming( "Input buffer read" );
 
+    const GIntBig nTraceMasksStart =
+        CPLTraceIsEnabled() ? CPLTraceGetTimestamp() : -1;
+
 /* -------------------------------------------------------------------- */
 /*      Initialize destination buffer.                                  */
 /* -------------------------------------------------------------------- */
@@ -1964,13 +2419,14 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 
         if( eErr == CE_None )
             eErr =
-                GDALWarpCutlineMasker( psOptions,
-                                       psOptions->nBandCount,
-                                       psOptions->eWorkingDataType,
-                                       oWK.nSrcXOff, oWK.nSrcYOff,
-                                       oWK.nSrcXSize, oWK.nSrcYSize,
-                                       oWK.papabySrcImage,
-                                       TRUE, oWK.pafUnifiedSrcDensity );
+                GDALWarpCutlineMaskerEx( psOptions,
+                                         psOptions->nBandCount,
+                                         psOptions->eWorkingDataType,
+                                         oWK.nSrcXOff, oWK.nSrcYOff,
+                                         oWK.nSrcXSize, oWK.nSrcYSize,
+                                         oWK.papabySrcImage,
+                                         TRUE, oWK.pafUnifiedSrcDensity,
+                                         hCutlineIndex );
     }
 
 /* -------------------------------------------------------------------- */
@@ -2187,6 +2643,10 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
         }
     }
 
+    if( nTraceMasksStart >= 0 )
+        CPLTraceRecordSpan("warp", "WarpMasks", nullptr,
+                           nTraceMasksStart, CPLTraceGetTimestamp());
+
 /* -------------------------------------------------------------------- */
 /*      Release IO Mutex, and acquire warper mutex.                     */
 /* -------------------------------------------------------------------- */
@@ -2213,6 +2673,7 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 /* -------------------------------------------------------------------- */
     if( eErr == CE_None )
     {
+        CPLTraceSpan oTraceSpanKernel("warp", "WarpKernel");
         eErr = oWK.PerformWarp();
         ReportTiming( "In memory warp operation" );
     }
@@ -2256,7 +2717,7 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 /* -------------------------------------------------------------------- */
 /*      Cleanup.                                                        */
 /* -------------------------------------------------------------------- */
-    CPLFree( oWK.papabySrcImage[0] );
+    VSIFreeLarge( oWK.papabySrcImage[0] );
     CPLFree( oWK.papabySrcImage );
     CPLFree( oWK.papabyDstImage );
 
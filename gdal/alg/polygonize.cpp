@@ -35,13 +35,17 @@
 #include <string.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 #include "gdal_alg_priv.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "cpl_conv.h"
@@ -414,12 +418,11 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
 }
 
 /************************************************************************/
-/*                         EmitPolygonToLayer()                         */
+/*                       CreatePolygonGeometry()                        */
 /************************************************************************/
 
-static CPLErr
-EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
-                    RPolygon *poRPoly, double *padfGeoTransform )
+static OGRGeometryH
+CreatePolygonGeometry( RPolygon *poRPoly, const double *padfGeoTransform )
 
 {
 /* -------------------------------------------------------------------- */
@@ -461,6 +464,20 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
         OGR_G_AddGeometryDirectly( hPolygon, hRing );
     }
 
+    return hPolygon;
+}
+
+/************************************************************************/
+/*                        WritePolygonToLayer()                         */
+/*                                                                      */
+/*      Write a polygon, whose ownership is taken, as a new feature.    */
+/************************************************************************/
+
+static CPLErr
+WritePolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
+                     OGRGeometryH hPolygon, double dfPolyValue )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Create the feature object.                                      */
 /* -------------------------------------------------------------------- */
@@ -469,7 +486,7 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     OGR_F_SetGeometryDirectly( hFeat, hPolygon );
 
     if( iPixValField >= 0 )
-        OGR_F_SetFieldDouble( hFeat, iPixValField, poRPoly->dfPolyValue );
+        OGR_F_SetFieldDouble( hFeat, iPixValField, dfPolyValue );
 
 /* -------------------------------------------------------------------- */
 /*      Write the to the layer.                                         */
@@ -484,6 +501,380 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     return eErr;
 }
 
+/************************************************************************/
+/*                         EmitPolygonToLayer()                         */
+/************************************************************************/
+
+static CPLErr
+EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
+                    RPolygon *poRPoly, const double *padfGeoTransform )
+
+{
+    return WritePolygonToLayer( hOutLayer, iPixValField,
+                                CreatePolygonGeometry( poRPoly,
+                                                       padfGeoTransform ),
+                                poRPoly->dfPolyValue );
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         GDALPolygonOutput                            */
+/*                                                                      */
+/*      Output of the completed polygons. In the multi-threaded mode,   */
+/*      polygons are grouped in batches. The geometries of each batch   */
+/*      are built by a job of the global thread pool, and a writer      */
+/*      thread writes the batches to the layer in their submission      */
+/*      order, within transactions. The enumerating thread only waits  */
+/*      when too many batches are pending, to bound memory use.         */
+/* ==================================================================== */
+/************************************************************************/
+
+namespace {
+
+// Number of polygons of a batch.
+constexpr size_t POLYGON_BATCH_SIZE = 1000;
+// Number of features written in a transaction.
+constexpr int FEATURES_PER_TRANSACTION = 100 * 1000;
+
+struct GDALPolygonBatch
+{
+    std::vector<RPolygon *>   apoPolygons{};
+    std::vector<OGRGeometryH> ahGeometries{};
+    std::vector<double>       adfValues{};
+    const double             *padfGeoTransform = nullptr;
+    // Set when ahGeometries is filled, under the mutex of GDALPolygonOutput
+    bool                      bReady = false;
+    std::mutex               *poMutex = nullptr;
+    std::condition_variable  *poCV = nullptr;
+
+    GDALPolygonBatch() = default;
+    ~GDALPolygonBatch()
+    {
+        for( auto poRPoly: apoPolygons )
+            delete poRPoly;
+        for( auto hGeom: ahGeometries )
+            OGR_G_DestroyGeometry( hGeom );
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALPolygonBatch)
+};
+
+class GDALPolygonOutput
+{
+    OGRLayerH       hOutLayer;
+    int             iPixValField;
+    const double   *padfGeoTransform;
+
+    CPLWorkerThreadPool          *poThreadPool = nullptr;
+    std::unique_ptr<CPLJobQueue>  poJobQueue{};
+    CPLJoinableThread            *hWriterThread = nullptr;
+
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    std::deque<std::unique_ptr<GDALPolygonBatch>> aoBatches{};
+    size_t                  nMaxPendingBatches = 0;
+    bool                    bNoMoreBatches = false;
+    // Set when the pending batches must be discarded instead of written
+    bool                    bAbort = false;
+    CPLErr                  eWriterErr = CE_None;
+
+    // Errors emitted in the writer thread, reported in the calling thread
+    struct ErrorMessage
+    {
+        CPLErr      eErr;
+        CPLErrorNum nErrNo;
+        CPLString   osMsg;
+    };
+    std::vector<ErrorMessage> aoWriterErrors{};
+
+    std::unique_ptr<GDALPolygonBatch> poCurrentBatch{};
+
+    static void BuildGeometries( void *pData );
+    static void WriterThread( void *pData );
+    static void CPL_STDCALL WriterErrorHandler( CPLErr eErr,
+                                                CPLErrorNum nErrNo,
+                                                const char *pszMsg );
+    void        WriteBatches();
+    CPLErr      SubmitCurrentBatch();
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALPolygonOutput)
+
+  public:
+    GDALPolygonOutput( OGRLayerH hOutLayerIn, int iPixValFieldIn,
+                       const double *padfGeoTransformIn, int nThreads );
+    ~GDALPolygonOutput();
+
+    CPLErr      AddPolygon( RPolygon *poRPoly );
+    CPLErr      Finish( bool bAbortIn );
+};
+
+/************************************************************************/
+/*                         GDALPolygonOutput()                          */
+/************************************************************************/
+
+GDALPolygonOutput::GDALPolygonOutput( OGRLayerH hOutLayerIn,
+                                      int iPixValFieldIn,
+                                      const double *padfGeoTransformIn,
+                                      int nThreads ) :
+    hOutLayer(hOutLayerIn),
+    iPixValField(iPixValFieldIn),
+    padfGeoTransform(padfGeoTransformIn)
+{
+    if( nThreads <= 1 )
+        return;
+
+    poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return;
+    poJobQueue = poThreadPool->CreateJobQueue();
+    nMaxPendingBatches = 2 * static_cast<size_t>(nThreads);
+    hWriterThread = CPLCreateJoinableThread(WriterThread, this);
+    if( hWriterThread == nullptr )
+    {
+        poJobQueue.reset();
+        poThreadPool = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                         ~GDALPolygonOutput()                         */
+/************************************************************************/
+
+GDALPolygonOutput::~GDALPolygonOutput()
+{
+    Finish(true);
+}
+
+/************************************************************************/
+/*                          BuildGeometries()                           */
+/************************************************************************/
+
+void GDALPolygonOutput::BuildGeometries( void *pData )
+{
+    GDALPolygonBatch *poBatch = static_cast<GDALPolygonBatch *>(pData);
+    for( auto& poRPoly: poBatch->apoPolygons )
+    {
+        poBatch->ahGeometries.push_back(
+            CreatePolygonGeometry( poRPoly, poBatch->padfGeoTransform ) );
+        poBatch->adfValues.push_back( poRPoly->dfPolyValue );
+        delete poRPoly;
+        poRPoly = nullptr;
+    }
+    poBatch->apoPolygons.clear();
+
+    // The batch may be freed by the writer thread as soon as the mutex is
+    // released.
+    std::condition_variable *poCV = poBatch->poCV;
+    {
+        std::lock_guard<std::mutex> oLock(*(poBatch->poMutex));
+        poBatch->bReady = true;
+    }
+    poCV->notify_all();
+}
+
+/************************************************************************/
+/*                            WriterThread()                            */
+/************************************************************************/
+
+void GDALPolygonOutput::WriterThread( void *pData )
+{
+    CPLPushErrorHandlerEx( WriterErrorHandler, pData );
+    static_cast<GDALPolygonOutput *>(pData)->WriteBatches();
+    CPLPopErrorHandler();
+}
+
+/************************************************************************/
+/*                         WriterErrorHandler()                         */
+/************************************************************************/
+
+void CPL_STDCALL GDALPolygonOutput::WriterErrorHandler( CPLErr eErr,
+                                                        CPLErrorNum nErrNo,
+                                                        const char *pszMsg )
+{
+    GDALPolygonOutput *poThis =
+        static_cast<GDALPolygonOutput *>(CPLGetErrorHandlerUserData());
+    if( eErr == CE_Debug )
+    {
+        CPLDefaultErrorHandler( eErr, nErrNo, pszMsg );
+        return;
+    }
+    std::lock_guard<std::mutex> oLock(poThis->oMutex);
+    poThis->aoWriterErrors.push_back( ErrorMessage{ eErr, nErrNo, pszMsg } );
+}
+
+/************************************************************************/
+/*                            WriteBatches()                            */
+/************************************************************************/
+
+void GDALPolygonOutput::WriteBatches()
+{
+    // Group features in transactions, if the layer supports them, and
+    // no transaction is already active.
+    bool bUseTransactions =
+        OGR_L_TestCapability( hOutLayer, OLCTransactions ) != FALSE;
+    bool bInTransaction = false;
+    int nFeaturesInTransaction = 0;
+    CPLErr eErr = CE_None;
+
+    while( true )
+    {
+        std::unique_ptr<GDALPolygonBatch> poBatch;
+        {
+            std::unique_lock<std::mutex> oLock(oMutex);
+            oCV.wait(oLock, [this]
+                {
+                    return (!aoBatches.empty() && aoBatches.front()->bReady) ||
+                           (aoBatches.empty() && bNoMoreBatches);
+                });
+            if( aoBatches.empty() )
+                break;
+            poBatch = std::move(aoBatches.front());
+            aoBatches.pop_front();
+            if( bAbort )
+                eErr = CE_Failure;
+        }
+        oCV.notify_all();
+
+        for( size_t i = 0; eErr == CE_None &&
+                           i < poBatch->ahGeometries.size(); i++ )
+        {
+            if( bUseTransactions && !bInTransaction )
+            {
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                bInTransaction =
+                    OGR_L_StartTransaction( hOutLayer ) == OGRERR_NONE;
+                CPLPopErrorHandler();
+                bUseTransactions = bInTransaction;
+            }
+
+            OGRGeometryH hGeom = poBatch->ahGeometries[i];
+            poBatch->ahGeometries[i] = nullptr;
+            eErr = WritePolygonToLayer( hOutLayer, iPixValField, hGeom,
+                                        poBatch->adfValues[i] );
+
+            if( bInTransaction &&
+                ++nFeaturesInTransaction == FEATURES_PER_TRANSACTION )
+            {
+                if( OGR_L_CommitTransaction( hOutLayer ) != OGRERR_NONE )
+                    eErr = CE_Failure;
+                bInTransaction = false;
+                nFeaturesInTransaction = 0;
+            }
+        }
+
+        if( eErr != CE_None )
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            if( !bAbort )
+                eWriterErr = eErr;
+        }
+    }
+
+    if( bInTransaction &&
+        OGR_L_CommitTransaction( hOutLayer ) != OGRERR_NONE )
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        eWriterErr = CE_Failure;
+    }
+}
+
+/************************************************************************/
+/*                         SubmitCurrentBatch()                         */
+/************************************************************************/
+
+CPLErr GDALPolygonOutput::SubmitCurrentBatch()
+{
+    GDALPolygonBatch *poBatch = poCurrentBatch.get();
+    {
+        std::unique_lock<std::mutex> oLock(oMutex);
+        oCV.wait(oLock, [this]
+            {
+                return aoBatches.size() < nMaxPendingBatches ||
+                       eWriterErr != CE_None;
+            });
+        if( eWriterErr != CE_None )
+            return CE_Failure;
+        aoBatches.push_back(std::move(poCurrentBatch));
+    }
+    oCV.notify_all();
+    poJobQueue->SubmitJob(BuildGeometries, poBatch);
+    return CE_None;
+}
+
+/************************************************************************/
+/*                             AddPolygon()                             */
+/*                                                                      */
+/*      Output a completed polygon, and take its ownership.             */
+/************************************************************************/
+
+CPLErr GDALPolygonOutput::AddPolygon( RPolygon *poRPoly )
+{
+    if( hWriterThread == nullptr )
+    {
+        const CPLErr eErr =
+            EmitPolygonToLayer( hOutLayer, iPixValField, poRPoly,
+                                padfGeoTransform );
+        delete poRPoly;
+        return eErr;
+    }
+
+    if( !poCurrentBatch )
+    {
+        poCurrentBatch.reset(new GDALPolygonBatch());
+        poCurrentBatch->padfGeoTransform = padfGeoTransform;
+        poCurrentBatch->poMutex = &oMutex;
+        poCurrentBatch->poCV = &oCV;
+    }
+    poCurrentBatch->apoPolygons.push_back(poRPoly);
+    if( poCurrentBatch->apoPolygons.size() < POLYGON_BATCH_SIZE )
+        return CE_None;
+    return SubmitCurrentBatch();
+}
+
+/************************************************************************/
+/*                               Finish()                               */
+/*                                                                      */
+/*      Write the pending polygons, and wait for the writer thread.     */
+/*      If bAbortIn is set, after an error or an interruption, the      */
+/*      polygons that are not written yet are discarded instead.        */
+/************************************************************************/
+
+CPLErr GDALPolygonOutput::Finish( bool bAbortIn )
+{
+    if( hWriterThread == nullptr )
+        return CE_None;
+
+    CPLErr eErr = CE_None;
+    if( bAbortIn )
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bAbort = true;
+    }
+    else if( poCurrentBatch )
+    {
+        eErr = SubmitCurrentBatch();
+    }
+    poCurrentBatch.reset();
+
+    poJobQueue->WaitCompletion();
+    {
+        std::lock_guard<std::mutex> oLock(oMutex);
+        bNoMoreBatches = true;
+    }
+    oCV.notify_all();
+    CPLJoinThread(hWriterThread);
+    hWriterThread = nullptr;
+
+    for( const auto& oError: aoWriterErrors )
+        CPLError( oError.eErr, oError.nErrNo, "%s", oError.osMsg.c_str() );
+    aoWriterErrors.clear();
+    if( eWriterErr != CE_None )
+        eErr = eWriterErr;
+    return eErr;
+}
+
+} // namespace
+
 /************************************************************************/
 /*                          GPMaskImageData()                           */
 /*                                                                      */
@@ -537,6 +928,36 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     const int nConnectedness =
         CSLFetchNameValue( papszOptions, "8CONNECTED" ) ? 8 : 4;
 
+    const char* pszNumThreads =
+        CSLFetchNameValueDef( papszOptions, "NUM_THREADS", "1" );
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+        CPLGetNumCPUs() : atoi(pszNumThreads);
+
+    // The writer thread would access the dataset of the output layer
+    // concurrently with the reading of the source and mask bands.
+    if( nThreads > 1 )
+    {
+        for( GDALRasterBandH hBand : { hSrcBand, hMaskBand } )
+        {
+            GDALDatasetH hBandDS =
+                hBand ? GDALGetBandDataset( hBand ) : nullptr;
+            if( hBandDS == nullptr )
+                continue;
+            const int nLayers = GDALDatasetGetLayerCount( hBandDS );
+            for( int i = 0; i < nLayers; i++ )
+            {
+                if( GDALDatasetGetLayer( hBandDS, i ) == hOutLayer )
+                {
+                    CPLDebug( "GDAL",
+                              "Output layer belongs to the source dataset: "
+                              "NUM_THREADS ignored" );
+                    nThreads = 1;
+                    break;
+                }
+            }
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Confirm our output layer will support feature creation.         */
 /* -------------------------------------------------------------------- */
@@ -686,6 +1107,9 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     RPolygon **papoPoly = static_cast<RPolygon **>(
         CPLCalloc(sizeof(RPolygon*), oFirstEnum.nNextPolygonId));
 
+    GDALPolygonOutput oOutput( hOutLayer, iPixValField, adfGeoTransform,
+                               nThreads );
+
 /* ==================================================================== */
 /*      Second pass during which we will actually collect polygon       */
 /*      edges as geometries.                                            */
@@ -754,11 +1178,7 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
             {
                 if( papoPoly[iX] && papoPoly[iX]->nLastLineUpdated < iY-1 )
                 {
-                    eErr =
-                        EmitPolygonToLayer( hOutLayer, iPixValField,
-                                            papoPoly[iX], adfGeoTransform );
-
-                    delete papoPoly[iX];
+                    eErr = oOutput.AddPolygon( papoPoly[iX] );
                     papoPoly[iX] = nullptr;
                 }
             }
@@ -791,14 +1211,15 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     {
         if( papoPoly[iX] )
         {
-            eErr = EmitPolygonToLayer( hOutLayer, iPixValField,
-                                       papoPoly[iX], adfGeoTransform );
-
-            delete papoPoly[iX];
+            eErr = oOutput.AddPolygon( papoPoly[iX] );
             papoPoly[iX] = nullptr;
         }
     }
 
+    const CPLErr eFinishErr = oOutput.Finish(eErr != CE_None);
+    if( eErr == CE_None )
+        eErr = eFinishErr;
+
 /* -------------------------------------------------------------------- */
 /*      Cleanup                                                         */
 /* -------------------------------------------------------------------- */
@@ -911,6 +1332,12 @@ GBool GDALFloatEquals( float A, float B )
  * <ul>
  * <li>8CONNECTED=8: May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm</li>
+ * <li>NUM_THREADS=number|ALL_CPUS: (GDAL &gt;= 3.4) When greater than 1,
+ * the geometries of the polygons are built by worker threads, and the
+ * features are written by a separate thread, grouped in transactions when
+ * the layer supports them. The features are written in the same order as
+ * with a single thread. Ignored when the output layer belongs to the
+ * dataset of the source or mask band. Defaults to 1.</li>
  * </ul>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
@@ -988,6 +1415,12 @@ GDALPolygonize( GDALRasterBandH hSrcBand,
  * <ul>
  * <li>8CONNECTED=8: May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm</li>
+ * <li>NUM_THREADS=number|ALL_CPUS: (GDAL &gt;= 3.4) When greater than 1,
+ * the geometries of the polygons are built by worker threads, and the
+ * features are written by a separate thread, grouped in transactions when
+ * the layer supports them. The features are written in the same order as
+ * with a single thread. Ignored when the output layer belongs to the
+ * dataset of the source or mask band. Defaults to 1.</li>
  * </ul>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
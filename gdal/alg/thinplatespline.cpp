@@ -35,13 +35,16 @@
 #include "cpl_port.h"
 #include "thinplatespline.h"
 #include "gdallinearsystem.h"
+#include "gdal_thread_pool.h"
 
 #include <climits>
 #include <cstdio>
 #include <cstring>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <memory>
 #include <utility>
 
 #include "cpl_error.h"
@@ -430,8 +433,46 @@ static void VizGeorefSpline2DBase_func4( double* res,
 }
 #endif // defined(USE_OPTIMIZED_VizGeorefSpline2DBase_func4)
 
-int VizGeorefSpline2D::solve()
+/************************************************************************/
+/*                     VizGeorefSpline2DFillMatrix()                    */
+/************************************************************************/
+
+namespace {
+struct VizGeorefSpline2DFillJob
+{
+    GDALMatrix *poA;
+    const double *x;
+    const double *y;
+    int nof_points;
+    int first_row;
+    int row_step;
+};
+} // namespace
+
+// Fill the radial basis part of the matrix, for the rows first_row,
+// first_row + row_step, etc. Interleaving the rows balances the jobs, since
+// only the upper triangle is computed.
+static void VizGeorefSpline2DFillMatrix( void *pData )
 {
+    const VizGeorefSpline2DFillJob *psJob =
+        static_cast<const VizGeorefSpline2DFillJob *>(pData);
+    GDALMatrix &A = *(psJob->poA);
+    const double *x = psJob->x;
+    const double *y = psJob->y;
+    for( int r = psJob->first_row; r < psJob->nof_points; r += psJob->row_step )
+        for( int c = r; c < psJob->nof_points; c++ )
+        {
+            A(r+3, c+3) = VizGeorefSpline2DBase_func( x[r], y[r], x[c], y[c] );
+            if( r != c )
+                A(c+3, r+3) = A(r+3, c+3);
+        }
+}
+
+int VizGeorefSpline2D::solve( int nThreads )
+{
+    clusters.clear();
+    _far_field_max_ratio = 0;
+
     // No points at all.
     if( _nof_points < 1 )
     {
@@ -580,13 +621,25 @@ int VizGeorefSpline2D::solve()
         A(c+3, 2) = y[c];
     }
 
-    for( int r = 0; r < _nof_points; r++ )
-        for( int c = r; c < _nof_points; c++ )
+    CPLWorkerThreadPool* poThreadPool =
+        nThreads > 1 && _nof_points > 1000 ?
+            GDALGetGlobalThreadPool(nThreads) : nullptr;
+    if( poThreadPool )
+    {
+        std::vector<VizGeorefSpline2DFillJob> asJobs(nThreads);
+        auto poJobQueue = poThreadPool->CreateJobQueue();
+        for( int i = 0; i < nThreads; i++ )
         {
-            A(r+3, c+3) = VizGeorefSpline2DBase_func( x[r], y[r], x[c], y[c] );
-            if( r != c )
-                A(c+3, r+3) = A(r+3, c+3);
+            asJobs[i] = { &A, x, y, _nof_points, i, nThreads };
+            poJobQueue->SubmitJob(VizGeorefSpline2DFillMatrix, &asJobs[i]);
         }
+        poJobQueue->WaitCompletion();
+    }
+    else
+    {
+        VizGeorefSpline2DFillJob sJob = { &A, x, y, _nof_points, 0, 1 };
+        VizGeorefSpline2DFillMatrix(&sJob);
+    }
 
 #if VIZ_GEOREF_SPLINE_DEBUG
 
@@ -606,7 +659,7 @@ int VizGeorefSpline2D::solve()
 
     GDALMatrix Coef(_nof_eqs, _nof_vars);
 
-    if( !GDALLinearSystemSolve(A, RHS, Coef ) )
+    if( !GDALLinearSystemSolve(A, RHS, Coef, nThreads) )
     {
         return 0;
     }
@@ -677,6 +730,11 @@ int VizGeorefSpline2D::get_point( const double Px, const double Py,
     case VIZ_GEOREF_SPLINE_FULL:
     {
         const double Pxy[2] = { Px - x_mean, Py -y_mean };
+        if( !clusters.empty() )
+        {
+            get_point_far_field( Pxy, vars );
+            break;
+        }
         for( int v = 0; v < _nof_vars; v++ )
             vars[v] = coef[v][0] + coef[v][1] * Pxy[0] + coef[v][2] * Pxy[1];
 
@@ -725,4 +783,263 @@ int VizGeorefSpline2D::get_point( const double Px, const double Py,
     return 1;
 }
 
+/************************************************************************/
+/*                          get_linear_scale()                          */
+/*                                                                      */
+/*      Return the smallest scale factor of the affine part of a 2D     */
+/*      spline, i.e. the smallest singular value of its 2x2 matrix, so  */
+/*      that a distance d in the output space is at most                */
+/*      d / get_linear_scale() in the input space, whatever its         */
+/*      direction.                                                      */
+/************************************************************************/
+
+double VizGeorefSpline2D::get_linear_scale() const
+{
+    if( type != VIZ_GEOREF_SPLINE_FULL || _nof_vars != 2 )
+        return 0.0;
+    const double a = coef[0][1];
+    const double b = coef[0][2];
+    const double c = coef[1][1];
+    const double d = coef[1][2];
+    // The singular values are the square roots of the eigenvalues of
+    // M^T M, whose trace is the sum of the squares of the coefficients and
+    // whose determinant is det(M)^2. The smallest one is computed as
+    // |det(M)| / largest one to avoid cancellation.
+    const double sum_sq = a * a + b * b + c * c + d * d;
+    const double det = a * d - b * c;
+    const double delta = std::max(0.0, sum_sq * sum_sq - 4 * det * det);
+    const double largest = sqrt((sum_sq + sqrt(delta)) / 2);
+    if( largest == 0 )
+        return 0.0;
+    return fabs(det) / largest;
+}
+
+/************************************************************************/
+/*                      set_far_field_tolerance()                       */
+/*                                                                      */
+/*      Enable the far field approximation, so that the values          */
+/*      returned by get_point() differ by at most tolerance from the    */
+/*      exact ones, or disable it if tolerance is 0. Must be called     */
+/*      after solve().                                                  */
+/*                                                                      */
+/*      The control points are grouped in a tree of clusters. With      */
+/*      complex coordinates, r^2 log(r^2) for the points z and t is     */
+/*      2 Re((conj(z) - conj(t)) (z - t) log(z - t)), so the sum over   */
+/*      the points of a cluster is 2 Re(conj(w) F(w) - G(w)), where w   */
+/*      is z relative to the center of the cluster, and F and G are     */
+/*      analytic outside of the cluster. Their Laurent series only      */
+/*      depend on the moments of the coefficients of the cluster, and   */
+/*      are truncated after VIZGEOREF_FAR_FIELD_ORDER terms. For a       */
+/*      cluster of radius rho at a distance R, with q = rho / R < 1,    */
+/*      the error is at most                                            */
+/*      2 rho (R + rho) q^(p+1) / ((p+1) (p+2) (1 - q)) times the sum    */
+/*      of the absolute values of the coefficients of the cluster.      */
+/*      Clusters are only approximated if that error is within their    */
+/*      share of the tolerance.                                         */
+/************************************************************************/
+
+void VizGeorefSpline2D::set_far_field_tolerance( double tolerance )
+{
+    clusters.clear();
+    cluster_x.clear();
+    cluster_y.clear();
+    for( int v = 0; v < _nof_vars; v++ )
+        cluster_coef[v].clear();
+    _far_field_max_ratio = 0;
+
+    // Not worth it for small numbers of points.
+    if( type != VIZ_GEOREF_SPLINE_FULL || !(tolerance > 0) ||
+        _nof_points < 256 )
+        return;
+
+    double max_sum_abs = 0;
+    for( int v = 0; v < _nof_vars; v++ )
+    {
+        double sum_abs = 0;
+        for( int r = 0; r < _nof_points; r++ )
+            sum_abs += fabs(coef[v][r+3]);
+        max_sum_abs = std::max(max_sum_abs, sum_abs);
+    }
+    if( max_sum_abs == 0 )
+        return;
+    _far_field_max_ratio = tolerance / max_sum_abs;
+
+    std::vector<int> indices(_nof_points);
+    for( int r = 0; r < _nof_points; r++ )
+        indices[r] = r;
+    build_cluster( indices, 0, _nof_points );
+
+    cluster_x.resize(_nof_points);
+    cluster_y.resize(_nof_points);
+    for( int v = 0; v < _nof_vars; v++ )
+        cluster_coef[v].resize(_nof_points);
+    for( int i = 0; i < _nof_points; i++ )
+    {
+        cluster_x[i] = x[indices[i]];
+        cluster_y[i] = y[indices[i]];
+        for( int v = 0; v < _nof_vars; v++ )
+            cluster_coef[v][i] = coef[v][indices[i]+3];
+    }
+}
+
+/************************************************************************/
+/*                           build_cluster()                            */
+/*                                                                      */
+/*      Build the cluster of the points of indices[start:end], and its   */
+/*      children. Return its index in clusters.                         */
+/************************************************************************/
+
+int VizGeorefSpline2D::build_cluster( std::vector<int>& indices,
+                                      int start, int end )
+{
+    constexpr int LEAF_SIZE = 32;
+
+    VizGeorefSplineCluster sCluster;
+    sCluster.start = start;
+    sCluster.end = end;
+
+    double xmin = x[indices[start]];
+    double xmax = xmin;
+    double ymin = y[indices[start]];
+    double ymax = ymin;
+    for( int i = start + 1; i < end; i++ )
+    {
+        xmin = std::min(xmin, x[indices[i]]);
+        xmax = std::max(xmax, x[indices[i]]);
+        ymin = std::min(ymin, y[indices[i]]);
+        ymax = std::max(ymax, y[indices[i]]);
+    }
+    sCluster.cx = (xmin + xmax) / 2;
+    sCluster.cy = (ymin + ymax) / 2;
+
+    double max_dist2 = 0;
+    for( int i = start; i < end; i++ )
+    {
+        const int r = indices[i];
+        const std::complex<double> d(x[r] - sCluster.cx, y[r] - sCluster.cy);
+        max_dist2 = std::max(max_dist2, std::norm(d));
+        for( int v = 0; v < _nof_vars; v++ )
+        {
+            const double c = coef[v][r+3];
+            std::complex<double> c_dk(c, 0);  // c * d^k
+            for( int k = 0; k < VIZGEOREF_FAR_FIELD_ORDER + 2; k++ )
+            {
+                sCluster.f_moments[v][k] += c_dk;
+                sCluster.g_moments[v][k] += std::conj(d) * c_dk;
+                c_dk *= d;
+            }
+        }
+    }
+    sCluster.radius = sqrt(max_dist2);
+
+    const int idx = static_cast<int>(clusters.size());
+    clusters.push_back(sCluster);
+
+    if( end - start > LEAF_SIZE )
+    {
+        // Split at the median along the largest dimension.
+        const int mid = start + (end - start) / 2;
+        const bool bSplitX = xmax - xmin >= ymax - ymin;
+        std::nth_element(indices.begin() + start, indices.begin() + mid,
+                         indices.begin() + end,
+                         [this, bSplitX](int a, int b)
+                         {
+                             return bSplitX ? x[a] < x[b] : y[a] < y[b];
+                         });
+        const int child0 = build_cluster( indices, start, mid );
+        const int child1 = build_cluster( indices, mid, end );
+        clusters[idx].child[0] = child0;
+        clusters[idx].child[1] = child1;
+    }
+    return idx;
+}
+
+/************************************************************************/
+/*                        get_point_far_field()                         */
+/************************************************************************/
+
+void VizGeorefSpline2D::get_point_far_field( const double Pxy[2],
+                                             double *vars ) const
+{
+    constexpr int p = VIZGEOREF_FAR_FIELD_ORDER;
+
+    for( int v = 0; v < _nof_vars; v++ )
+        vars[v] = coef[v][0] + coef[v][1] * Pxy[0] + coef[v][2] * Pxy[1];
+
+    // The depth of the tree is the logarithm of the number of points.
+    int stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = 0;
+    while( stack_size > 0 )
+    {
+        const VizGeorefSplineCluster& sCluster =
+            clusters[stack[--stack_size]];
+        const std::complex<double> w(Pxy[0] - sCluster.cx,
+                                     Pxy[1] - sCluster.cy);
+        const double dist = std::abs(w);
+        const double radius = sCluster.radius;
+        bool bApproximate = false;
+        if( dist > 2 * radius )
+        {
+            const double q = radius / dist;
+            const double max_error =
+                2 * radius * (dist + radius) * std::pow(q, p + 1) /
+                ((p + 1) * (p + 2) * (1 - q));
+            bApproximate = max_error <= _far_field_max_ratio;
+        }
+        if( bApproximate )
+        {
+            // F(w) = M0 w log(w) - M1 (log(w) + 1) +
+            //        sum(M(j+1) / (j (j+1)) w^-j, j = 1..p)
+            // with the f_moments for F and the g_moments for G.
+            const std::complex<double> log_w = std::log(w);
+            const std::complex<double> inv_w = 1.0 / w;
+            for( int v = 0; v < _nof_vars; v++ )
+            {
+                const std::complex<double>* f = sCluster.f_moments[v];
+                const std::complex<double>* g = sCluster.g_moments[v];
+                std::complex<double> F = f[0] * w * log_w - f[1] * (log_w + 1.0);
+                std::complex<double> G = g[0] * w * log_w - g[1] * (log_w + 1.0);
+                std::complex<double> inv_w_j = inv_w;
+                for( int j = 1; j <= p; j++ )
+                {
+                    const double factor = 1.0 / (j * (j + 1));
+                    F += factor * f[j+1] * inv_w_j;
+                    G += factor * g[j+1] * inv_w_j;
+                    inv_w_j *= inv_w;
+                }
+                vars[v] += 2 * std::real(std::conj(w) * F - G);
+            }
+        }
+        else if( sCluster.child[0] >= 0 )
+        {
+            stack[stack_size++] = sCluster.child[0];
+            stack[stack_size++] = sCluster.child[1];
+        }
+        else
+        {
+            int r = sCluster.start;
+            for( ; r + 4 <= sCluster.end; r += 4 )
+            {
+                double dfTmp[4] = {};
+                VizGeorefSpline2DBase_func4( dfTmp, Pxy,
+                                             &cluster_x[r], &cluster_y[r] );
+                for( int v = 0; v < _nof_vars; v++ )
+                {
+                    const double* pc = &cluster_coef[v][r];
+                    vars[v] += pc[0] * dfTmp[0] + pc[1] * dfTmp[1] +
+                               pc[2] * dfTmp[2] + pc[3] * dfTmp[3];
+                }
+            }
+            for( ; r < sCluster.end; r++ )
+            {
+                const double tmp = VizGeorefSpline2DBase_func(
+                    Pxy[0], Pxy[1], cluster_x[r], cluster_y[r] );
+                for( int v = 0; v < _nof_vars; v++ )
+                    vars[v] += cluster_coef[v][r] * tmp;
+            }
+        }
+    }
+}
+
 /*! @endcond */
@@ -38,6 +38,9 @@
 #include "gdal_alg.h"
 #include "cpl_conv.h"
 
+#include <complex>
+#include <vector>
+
 typedef enum
 {
     VIZ_GEOREF_SPLINE_ZERO_POINTS,
@@ -53,9 +56,32 @@ typedef enum
 //#define VIZ_GEOREF_SPLINE_MAX_POINTS 40
 #define VIZGEOREF_MAX_VARS 2
 
+// Number of terms of the far field expansions.
+#define VIZGEOREF_FAR_FIELD_ORDER 12
+
+// Node of the tree of clusters of points used by the far field
+// approximation.
+struct VizGeorefSplineCluster
+{
+    double cx = 0;      // center
+    double cy = 0;
+    double radius = 0;  // max distance from the center to the points
+    int start = 0;      // range of the points in the cluster_* arrays
+    int end = 0;
+    int child[2] = {-1, -1};
+    // Complex moments sum(c_i * d_i^k) and sum(c_i * conj(d_i) * d_i^k)
+    // of the coefficients, where d_i = point_i - center.
+    std::complex<double> f_moments[VIZGEOREF_MAX_VARS]
+                                  [VIZGEOREF_FAR_FIELD_ORDER + 2] = {};
+    std::complex<double> g_moments[VIZGEOREF_MAX_VARS]
+                                  [VIZGEOREF_FAR_FIELD_ORDER + 2] = {};
+};
+
 class VizGeorefSpline2D
 {
     bool grow_points();
+    int build_cluster( std::vector<int>& indices, int start, int end );
+    void get_point_far_field( const double Pxy[2], double *vars ) const;
 
   public:
 
@@ -78,7 +104,8 @@ class VizGeorefSpline2D
         unused(nullptr),
         index(nullptr),
         x_mean(0),
-        y_mean(0)
+        y_mean(0),
+        _far_field_max_ratio(0)
     {
         for( int i = 0; i < VIZGEOREF_MAX_VARS; i++ )
         {
@@ -152,13 +179,15 @@ class VizGeorefSpline2D
 
     bool add_point( const double Px, const double Py, const double *Pvars );
     int get_point( const double Px, const double Py, double *Pvars );
+    void set_far_field_tolerance( double tolerance );
+    double get_linear_scale() const;
 #if 0
     int delete_point(const double Px, const double Py );
     bool get_xy(int index, double& x, double& y);
     bool change_point(int index, double x, double y, double* Pvars);
     void reset(void) { _nof_points = 0; }
 #endif
-    int solve(void);
+    int solve( int nThreads = 1 );
 
   private:
 
@@ -191,6 +220,17 @@ class VizGeorefSpline2D
 
     double x_mean;
     double y_mean;
+
+    // Far field approximation: clusters of points, and their points and
+    // coefficients, ordered so that each cluster is a range.
+    std::vector<VizGeorefSplineCluster> clusters{};
+    std::vector<double> cluster_x{};
+    std::vector<double> cluster_y{};
+    std::vector<double> cluster_coef[VIZGEOREF_MAX_VARS]{};
+    // Maximum error of the far field expansion of a cluster, per unit of
+    // the sum of the absolute values of its coefficients.
+    double _far_field_max_ratio;
+
   private:
     CPL_DISALLOW_COPY_ASSIGN(VizGeorefSpline2D)
 };
@@ -55,6 +55,7 @@ static void Usage(const char* pszErrorMsg)
             "                    [-a_srs srs_def]\n"
             "                    [-r {nearest,bilinear,cubic,cubicspline,lanczos,average,mode}]\n"
             "                    [-oo NAME=VALUE]*\n"
+            "                    [-num_threads value|ALL_CPUS] [-harvest_cache filename]\n"
             "                    [-input_file_list my_list.txt] [-overwrite] output.vrt [gdalfile]*\n"
             "\n"
             "e.g.\n"
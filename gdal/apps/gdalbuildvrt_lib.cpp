@@ -41,15 +41,23 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <set>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
+#include "cpl_json.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_vrt.h"
 #include "gdal_priv.h"
@@ -122,8 +130,607 @@ struct BandProperty
     bool                   bHasScale = false;
     double                 dfScale = 0;
 };
+
+/* Properties of a band, as read from the source dataset */
+struct HarvestedBand
+{
+    GDALColorInterp        eColorInterp = GCI_Undefined;
+    GDALDataType           eDataType = GDT_Unknown;
+    std::shared_ptr<const GDALColorTable> poColorTable{};
+    bool                   bHasNoData = false;
+    double                 dfNoData = 0;
+    bool                   bHasOffset = false;
+    double                 dfOffset = 0;
+    bool                   bHasScale = false;
+    double                 dfScale = 1;
+    int                    nMaskFlags = GMF_ALL_VALID;
+};
+
+/* Properties of a source dataset, as read from it, independently of the */
+/* other sources. Can be collected in parallel and be cached. */
+struct HarvestedRaster
+{
+    bool        bOpened = false;
+    std::string osDescription{};
+    CPLStringList aosSubdatasets{};
+    bool        bHasProjection = false;
+    std::string osProjection{};
+    bool        bGotGeoTransform = false;
+    double      adfGeoTransform[6] = { 0, 0, 0, 0, 0, 0 };
+    int         nRasterXSize = 0;
+    int         nRasterYSize = 0;
+    int         nBandCount = 0;
+    int         nBlockXSize = 0;
+    int         nBlockYSize = 0;
+    int         nMaskBlockXSize = 0;
+    int         nMaskBlockYSize = 0;
+    std::vector<int> anOverviewFactors{};
+    std::vector<HarvestedBand> asBands{};
+};
+} // namespace
+
+/************************************************************************/
+/*                           HarvestRaster()                            */
+/************************************************************************/
+
+/* Read the properties of at most nMaxBands bands of hDS. */
+static void HarvestRaster( GDALDatasetH hDS, int nMaxBands,
+                           HarvestedRaster* psRaster )
+{
+    GDALDataset* poDS = GDALDataset::FromHandle(hDS);
+    psRaster->bOpened = true;
+    psRaster->osDescription = poDS->GetDescription();
+    psRaster->nBandCount = poDS->GetRasterCount();
+    if( psRaster->nBandCount == 0 )
+    {
+        psRaster->aosSubdatasets =
+            CSLDuplicate(poDS->GetMetadata("SUBDATASETS"));
+        if( !psRaster->aosSubdatasets.empty() )
+            return;
+    }
+
+    const char* pszProjection = poDS->GetProjectionRef();
+    psRaster->bHasProjection = pszProjection != nullptr;
+    if( pszProjection )
+        psRaster->osProjection = pszProjection;
+    psRaster->bGotGeoTransform =
+        poDS->GetGeoTransform(psRaster->adfGeoTransform) == CE_None;
+    psRaster->nRasterXSize = poDS->GetRasterXSize();
+    psRaster->nRasterYSize = poDS->GetRasterYSize();
+    if( psRaster->nBandCount == 0 )
+        return;
+
+    GDALRasterBand* poFirstBand = poDS->GetRasterBand(1);
+    poFirstBand->GetBlockSize(&psRaster->nBlockXSize,
+                              &psRaster->nBlockYSize);
+    poFirstBand->GetMaskBand()->GetBlockSize(&psRaster->nMaskBlockXSize,
+                                             &psRaster->nMaskBlockYSize);
+
+    // Collect overview factors. We only handle power-of-two situations for now
+    const int nOverviews = poFirstBand->GetOverviewCount();
+    int nExpectedOvFactor = 2;
+    for(int j=0; j < nOverviews; j++)
+    {
+        GDALRasterBand* poOverview = poFirstBand->GetOverview(j);
+        if( !poOverview )
+            continue;
+        if( poOverview->GetXSize() < 128 &&
+            poOverview->GetYSize() < 128 )
+        {
+            break;
+        }
+
+        const int nOvFactor =
+            GDALComputeOvFactor(poOverview->GetXSize(),
+                                poFirstBand->GetXSize(),
+                                poOverview->GetYSize(),
+                                poFirstBand->GetYSize());
+
+        if( nOvFactor != nExpectedOvFactor )
+            break;
+
+        psRaster->anOverviewFactors.push_back(nOvFactor);
+        nExpectedOvFactor *= 2;
+    }
+
+    const int nBands = std::min(psRaster->nBandCount, nMaxBands);
+    psRaster->asBands.resize(nBands);
+    for(int j=0;j<nBands;j++)
+    {
+        GDALRasterBand* poBand = poDS->GetRasterBand(j+1);
+        HarvestedBand& sBand = psRaster->asBands[j];
+        sBand.eColorInterp = poBand->GetColorInterpretation();
+        sBand.eDataType = poBand->GetRasterDataType();
+        if( sBand.eColorInterp == GCI_PaletteIndex &&
+            poBand->GetColorTable() != nullptr )
+        {
+            sBand.poColorTable.reset(poBand->GetColorTable()->Clone());
+        }
+
+        int bHasNoData = false;
+        sBand.dfNoData = poBand->GetNoDataValue(&bHasNoData);
+        sBand.bHasNoData = bHasNoData != 0;
+
+        int bHasOffset = false;
+        sBand.dfOffset = poBand->GetOffset(&bHasOffset);
+        sBand.bHasOffset = bHasOffset != 0;
+
+        int bHasScale = false;
+        sBand.dfScale = poBand->GetScale(&bHasScale);
+        sBand.bHasScale = bHasScale != 0;
+
+        sBand.nMaskFlags = poBand->GetMaskFlags();
+    }
+}
+
+/************************************************************************/
+/*                          Harvest cache                               */
+/************************************************************************/
+
+/* The harvest cache is a file where each line is a JSON object: a header */
+/* line, followed by lines that either define a SRS, referenced by the    */
+/* following lines, or give the properties of a source dataset.           */
+/* Properties are reused when the size, modification time, and ETag for   */
+/* network file systems, of the source have not changed since they were   */
+/* written.                                                                */
+
+#define HARVEST_CACHE_TYPE     "gdalbuildvrt_harvest_cache"
+#define HARVEST_CACHE_VERSION  1
+
+namespace {
+struct HarvestCacheEntry
+{
+    std::string     osKey{};
+    HarvestedRaster sRaster{};
+};
+
+typedef std::map<std::string, HarvestCacheEntry> HarvestCache;
+} // namespace
+
+/************************************************************************/
+/*                        GetHarvestCacheKey()                          */
+/************************************************************************/
+
+/* Return a string identifying the version of a file, or an empty string */
+/* if it is not a file (subdataset names for example). */
+static std::string GetHarvestCacheKey(const char* pszFilename)
+{
+    VSIStatBufL sStat;
+    if( VSIStatExL(pszFilename, &sStat, VSI_STAT_EXISTS_FLAG |
+                                        VSI_STAT_SIZE_FLAG) != 0 ||
+        VSI_ISDIR(sStat.st_mode) )
+    {
+        return std::string();
+    }
+    std::string osKey(CPLSPrintf(CPL_FRMT_GUIB "/" CPL_FRMT_GIB,
+                                 static_cast<GUIntBig>(sStat.st_size),
+                                 static_cast<GIntBig>(sStat.st_mtime)));
+    if( STARTS_WITH(pszFilename, "/vsi") &&
+        !STARTS_WITH(pszFilename, "/vsimem/") )
+    {
+        const CPLStringList aosHeaders(
+            VSIGetFileMetadata(pszFilename, "HEADERS", nullptr));
+        const char* pszETag = aosHeaders.FetchNameValue("ETag");
+        if( pszETag )
+        {
+            osKey += '/';
+            osKey += pszETag;
+        }
+    }
+    return osKey;
+}
+
+/************************************************************************/
+/*                         DoubleToJSON()                               */
+/************************************************************************/
+
+/* Doubles are written as strings, so that nan and inf survive. */
+static std::string DoubleToJSON(double dfVal)
+{
+    return CPLSPrintf("%.18g", dfVal);
+}
+
+/************************************************************************/
+/*                        HarvestedRasterToJSON()                       */
+/************************************************************************/
+
+static CPLJSONObject HarvestedRasterToJSON(const HarvestedRaster& sRaster,
+                                           int nSRSId)
+{
+    CPLJSONObject oObj;
+    oObj.Add("x_size", sRaster.nRasterXSize);
+    oObj.Add("y_size", sRaster.nRasterYSize);
+    oObj.Add("band_count", sRaster.nBandCount);
+    if( !sRaster.aosSubdatasets.empty() )
+    {
+        CPLJSONArray oSubdatasets;
+        for( int i = 0; i < sRaster.aosSubdatasets.size(); ++i )
+            oSubdatasets.Add(sRaster.aosSubdatasets[i]);
+        oObj.Add("subdatasets", oSubdatasets);
+    }
+    oObj.Add("srs_id", nSRSId);
+    if( sRaster.bGotGeoTransform )
+    {
+        CPLJSONArray oGT;
+        for( int i = 0; i < 6; ++i )
+            oGT.Add(DoubleToJSON(sRaster.adfGeoTransform[i]));
+        oObj.Add("geotransform", oGT);
+    }
+    CPLJSONArray oBlock;
+    oBlock.Add(sRaster.nBlockXSize);
+    oBlock.Add(sRaster.nBlockYSize);
+    oBlock.Add(sRaster.nMaskBlockXSize);
+    oBlock.Add(sRaster.nMaskBlockYSize);
+    oObj.Add("block_size", oBlock);
+    CPLJSONArray oOvrFactors;
+    for( int nFactor: sRaster.anOverviewFactors )
+        oOvrFactors.Add(nFactor);
+    oObj.Add("overview_factors", oOvrFactors);
+
+    CPLJSONArray oBands;
+    for( const auto& sBand: sRaster.asBands )
+    {
+        CPLJSONObject oBand;
+        oBand.Add("color_interp", static_cast<int>(sBand.eColorInterp));
+        oBand.Add("data_type", static_cast<int>(sBand.eDataType));
+        if( sBand.poColorTable )
+        {
+            CPLJSONArray oCT;
+            for( int i = 0; i < sBand.poColorTable->GetColorEntryCount(); ++i )
+            {
+                const GDALColorEntry* psEntry =
+                    sBand.poColorTable->GetColorEntry(i);
+                CPLJSONArray oEntry;
+                oEntry.Add(psEntry->c1);
+                oEntry.Add(psEntry->c2);
+                oEntry.Add(psEntry->c3);
+                oEntry.Add(psEntry->c4);
+                oCT.Add(oEntry);
+            }
+            oBand.Add("color_table", oCT);
+        }
+        if( sBand.bHasNoData )
+            oBand.Add("nodata", DoubleToJSON(sBand.dfNoData));
+        if( sBand.bHasOffset )
+            oBand.Add("offset", DoubleToJSON(sBand.dfOffset));
+        if( sBand.bHasScale )
+            oBand.Add("scale", DoubleToJSON(sBand.dfScale));
+        oBand.Add("mask_flags", sBand.nMaskFlags);
+        oBands.Add(oBand);
+    }
+    oObj.Add("bands", oBands);
+    return oObj;
+}
+
+/************************************************************************/
+/*                       HarvestedRasterFromJSON()                      */
+/************************************************************************/
+
+static void HarvestedRasterFromJSON(const CPLJSONObject& oObj,
+                                    const std::vector<std::string>& aosSRS,
+                                    HarvestedRaster* psRaster)
+{
+    psRaster->bOpened = true;
+    psRaster->osDescription = oObj.GetString("path");
+    psRaster->nRasterXSize = oObj.GetInteger("x_size");
+    psRaster->nRasterYSize = oObj.GetInteger("y_size");
+    psRaster->nBandCount = oObj.GetInteger("band_count");
+    for( const auto& oSubdataset: oObj.GetArray("subdatasets") )
+        psRaster->aosSubdatasets.AddString(oSubdataset.ToString().c_str());
+    const int nSRSId = oObj.GetInteger("srs_id", -1);
+    if( nSRSId >= 0 && nSRSId < static_cast<int>(aosSRS.size()) )
+    {
+        psRaster->bHasProjection = true;
+        psRaster->osProjection = aosSRS[nSRSId];
+    }
+    auto oGT = oObj.GetArray("geotransform");
+    if( oGT.Size() == 6 )
+    {
+        psRaster->bGotGeoTransform = true;
+        for( int i = 0; i < 6; ++i )
+            psRaster->adfGeoTransform[i] = CPLAtof(oGT[i].ToString().c_str());
+    }
+    auto oBlock = oObj.GetArray("block_size");
+    if( oBlock.Size() == 4 )
+    {
+        psRaster->nBlockXSize = oBlock[0].ToInteger();
+        psRaster->nBlockYSize = oBlock[1].ToInteger();
+        psRaster->nMaskBlockXSize = oBlock[2].ToInteger();
+        psRaster->nMaskBlockYSize = oBlock[3].ToInteger();
+    }
+    for( const auto& oFactor: oObj.GetArray("overview_factors") )
+        psRaster->anOverviewFactors.push_back(oFactor.ToInteger());
+
+    for( const auto& oBand: oObj.GetArray("bands") )
+    {
+        HarvestedBand sBand;
+        sBand.eColorInterp =
+            static_cast<GDALColorInterp>(oBand.GetInteger("color_interp"));
+        sBand.eDataType =
+            static_cast<GDALDataType>(oBand.GetInteger("data_type"));
+        auto oCT = oBand.GetArray("color_table");
+        if( oCT.IsValid() )
+        {
+            auto poCT = std::make_shared<GDALColorTable>();
+            for( int i = 0; i < oCT.Size(); ++i )
+            {
+                auto oEntry = oCT[i].ToArray();
+                GDALColorEntry sEntry;
+                sEntry.c1 = static_cast<short>(oEntry[0].ToInteger());
+                sEntry.c2 = static_cast<short>(oEntry[1].ToInteger());
+                sEntry.c3 = static_cast<short>(oEntry[2].ToInteger());
+                sEntry.c4 = static_cast<short>(oEntry[3].ToInteger());
+                poCT->SetColorEntry(i, &sEntry);
+            }
+            sBand.poColorTable = poCT;
+        }
+        const auto ParseDouble = [&oBand](const char* pszKey, bool* pbSet,
+                                          double* pdfVal)
+        {
+            const std::string osVal = oBand.GetString(pszKey);
+            *pbSet = !osVal.empty();
+            if( *pbSet )
+                *pdfVal = CPLAtof(osVal.c_str());
+        };
+        ParseDouble("nodata", &sBand.bHasNoData, &sBand.dfNoData);
+        ParseDouble("offset", &sBand.bHasOffset, &sBand.dfOffset);
+        ParseDouble("scale", &sBand.bHasScale, &sBand.dfScale);
+        sBand.nMaskFlags = oBand.GetInteger("mask_flags", GMF_ALL_VALID);
+        psRaster->asBands.emplace_back(std::move(sBand));
+    }
+}
+
+/************************************************************************/
+/*                     GetHarvestCacheHeader()                          */
+/************************************************************************/
+
+static CPLJSONObject GetHarvestCacheHeader(CSLConstList papszOpenOptions)
+{
+    CPLJSONObject oHeader;
+    oHeader.Add("type", HARVEST_CACHE_TYPE);
+    oHeader.Add("version", HARVEST_CACHE_VERSION);
+    CPLJSONArray oOpenOptions;
+    for( CSLConstList papszIter = papszOpenOptions;
+         papszIter && *papszIter; ++papszIter )
+    {
+        oOpenOptions.Add(*papszIter);
+    }
+    oHeader.Add("open_options", oOpenOptions);
+    return oHeader;
+}
+
+/************************************************************************/
+/*                         LoadHarvestCache()                           */
+/************************************************************************/
+
+static void LoadHarvestCache(const char* pszFilename,
+                             CSLConstList papszOpenOptions,
+                             HarvestCache& oCache)
+{
+    VSILFILE* fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == nullptr )
+        return;
+
+    const std::string osExpectedHeader =
+        GetHarvestCacheHeader(papszOpenOptions).Format(
+                                            CPLJSONObject::PrettyFormat::Plain);
+    std::vector<std::string> aosSRS;
+    bool bFirstLine = true;
+    const char* pszLine;
+    while( (pszLine = CPLReadLineL(fp)) != nullptr )
+    {
+        CPLJSONDocument oDoc;
+        if( !oDoc.LoadMemory(std::string(pszLine)) )
+            break;
+        const CPLJSONObject oObj = oDoc.GetRoot();
+        if( bFirstLine )
+        {
+            // Cache written for other open options or by another version
+            if( oObj.Format(CPLJSONObject::PrettyFormat::Plain) !=
+                                                        osExpectedHeader )
+            {
+                CPLDebug("GDALBuildVRT", "Ignoring harvest cache %s",
+                         pszFilename);
+                break;
+            }
+            bFirstLine = false;
+        }
+        else if( oObj.GetObj("srs").IsValid() )
+        {
+            aosSRS.push_back(oObj.GetString("srs"));
+        }
+        else
+        {
+            HarvestCacheEntry& oEntry = oCache[oObj.GetString("path")];
+            oEntry.osKey = oObj.GetString("key");
+            oEntry.sRaster = HarvestedRaster();
+            HarvestedRasterFromJSON(oObj, aosSRS, &oEntry.sRaster);
+        }
+    }
+    VSIFCloseL(fp);
+    CPLDebug("GDALBuildVRT", "%d entries read from harvest cache %s",
+             static_cast<int>(oCache.size()), pszFilename);
+}
+
+/************************************************************************/
+/*                         HarvestCacheWriter                           */
+/************************************************************************/
+
+namespace {
+class HarvestCacheWriter
+{
+    CPL_DISALLOW_COPY_ASSIGN(HarvestCacheWriter)
+
+    std::string m_osFilename;
+    std::string m_osTmpFilename;
+    VSILFILE*   m_fp = nullptr;
+    std::map<std::string, int> m_oMapSRSToId{};
+
+    void WriteLine(const CPLJSONObject& oObj)
+    {
+        const std::string osLine =
+            oObj.Format(CPLJSONObject::PrettyFormat::Plain) + '\n';
+        if( m_fp && VSIFWriteL(osLine.data(), osLine.size(), 1, m_fp) != 1 )
+        {
+            VSIFCloseL(m_fp);
+            m_fp = nullptr;
+        }
+    }
+
+  public:
+    HarvestCacheWriter(const char* pszFilename,
+                       CSLConstList papszOpenOptions):
+        m_osFilename(pszFilename),
+        m_osTmpFilename(std::string(pszFilename) + ".tmp")
+    {
+        m_fp = VSIFOpenL(m_osTmpFilename.c_str(), "wb");
+        if( m_fp == nullptr )
+        {
+            CPLError(CE_Warning, CPLE_FileIO, "Cannot create %s",
+                     m_osTmpFilename.c_str());
+        }
+        WriteLine(GetHarvestCacheHeader(papszOpenOptions));
+    }
+
+    ~HarvestCacheWriter()
+    {
+        if( m_fp )
+        {
+            VSIFCloseL(m_fp);
+            VSIUnlink(m_osTmpFilename.c_str());
+        }
+    }
+
+    void Write(const char* pszPath, const std::string& osKey,
+               const HarvestedRaster& sRaster)
+    {
+        if( m_fp == nullptr || osKey.empty() || !sRaster.bOpened )
+            return;
+        int nSRSId = -1;
+        if( sRaster.bHasProjection )
+        {
+            auto oIter = m_oMapSRSToId.find(sRaster.osProjection);
+            if( oIter == m_oMapSRSToId.end() )
+            {
+                nSRSId = static_cast<int>(m_oMapSRSToId.size());
+                m_oMapSRSToId[sRaster.osProjection] = nSRSId;
+                CPLJSONObject oSRS;
+                oSRS.Add("srs", sRaster.osProjection);
+                WriteLine(oSRS);
+            }
+            else
+            {
+                nSRSId = oIter->second;
+            }
+        }
+        CPLJSONObject oObj(HarvestedRasterToJSON(sRaster, nSRSId));
+        oObj.Add("path", pszPath);
+        oObj.Add("key", osKey);
+        WriteLine(oObj);
+    }
+
+    /* Replace the previous cache file */
+    void Commit()
+    {
+        if( m_fp == nullptr )
+            return;
+        const bool bOK = VSIFCloseL(m_fp) == 0;
+        m_fp = nullptr;
+        if( !bOK ||
+            VSIRename(m_osTmpFilename.c_str(), m_osFilename.c_str()) != 0 )
+        {
+            CPLError(CE_Warning, CPLE_FileIO, "Cannot write %s",
+                     m_osFilename.c_str());
+            VSIUnlink(m_osTmpFilename.c_str());
+        }
+    }
+};
+
+/************************************************************************/
+/*                             HarvestJob                               */
+/************************************************************************/
+
+struct HarvestJob
+{
+    CPL_DISALLOW_COPY_ASSIGN(HarvestJob)
+
+    HarvestJob() = default;
+
+    // Input
+    std::string         osFilename{};
+    CSLConstList        papszOpenOptions = nullptr;
+    int                 nMaxBands = 0;
+    const HarvestCache* poCache = nullptr;
+    bool                bAccumulateErrors = false;
+
+    // Output
+    std::string            osCacheKey{};
+    const HarvestedRaster* psCachedRaster = nullptr;
+    HarvestedRaster        sRaster{};
+    // Errors emitted while opening, to be re-emitted in input order
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+    // Synchronization
+    bool                    bFinished = false;
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+
+    const HarvestedRaster& GetRaster() const
+        { return psCachedRaster ? *psCachedRaster : sRaster; }
+};
 } // namespace
 
+/************************************************************************/
+/*                          HarvestJobFunc()                            */
+/************************************************************************/
+
+static void HarvestJobFunc(void* pData)
+{
+    HarvestJob* psJob = static_cast<HarvestJob*>(pData);
+    if( psJob->bAccumulateErrors )
+    {
+        CPLInstallErrorHandlerAccumulator(psJob->aoErrors);
+        CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+    }
+
+    const char* pszFilename = psJob->osFilename.c_str();
+    if( psJob->poCache )
+    {
+        psJob->osCacheKey = GetHarvestCacheKey(pszFilename);
+        const auto oIter = psJob->poCache->find(psJob->osFilename);
+        if( !psJob->osCacheKey.empty() &&
+            oIter != psJob->poCache->end() &&
+            oIter->second.osKey == psJob->osCacheKey &&
+            static_cast<int>(oIter->second.sRaster.asBands.size()) >=
+                std::min(oIter->second.sRaster.nBandCount, psJob->nMaxBands) )
+        {
+            psJob->psCachedRaster = &(oIter->second.sRaster);
+        }
+    }
+
+    if( psJob->psCachedRaster == nullptr )
+    {
+        GDALDatasetH hDS =
+            GDALOpenEx( pszFilename,
+                        GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr,
+                        psJob->papszOpenOptions, nullptr );
+        if( hDS )
+        {
+            HarvestRaster(hDS, psJob->nMaxBands, &psJob->sRaster);
+            GDALClose(hDS);
+        }
+    }
+
+    if( psJob->bAccumulateErrors )
+        CPLUninstallErrorHandlerAccumulator();
+
+    {
+        std::lock_guard<std::mutex> oLock(psJob->oMutex);
+        psJob->bFinished = true;
+    }
+    psJob->oCV.notify_one();
+}
+
 /************************************************************************/
 /*                            ArgIsNumeric()                            */
 /************************************************************************/
@@ -245,6 +852,8 @@ class VRTBuilder
     char               *pszResampling = nullptr;
     char              **papszOpenOptions = nullptr;
     bool                bUseSrcMaskBand = true;
+    int                 nNumThreads = 1;
+    char               *pszHarvestCache = nullptr;
 
     /* Internal variables */
     char               *pszProjectionRef = nullptr;
@@ -264,7 +873,7 @@ class VRTBuilder
     int                 bHasRunBuild = 0;
     int                 bHasDatasetMask = 0;
 
-    int         AnalyseRaster(GDALDatasetH hDS,
+    int         AnalyseRaster(const HarvestedRaster& sRaster,
                               DatasetProperty* psDatasetProperties);
 
     void        CreateVRTSeparate(VRTDatasetH hVRTDS);
@@ -286,7 +895,9 @@ class VRTBuilder
                            bool bUseSrcMaskBand,
                            const char* pszOutputSRS,
                            const char* pszResampling,
-                           const char* const* papszOpenOptionsIn );
+                           const char* const* papszOpenOptionsIn,
+                           int nNumThreadsIn,
+                           const char* pszHarvestCacheIn );
 
                ~VRTBuilder();
 
@@ -312,7 +923,9 @@ VRTBuilder::VRTBuilder(const char* pszOutputFilenameIn,
                        bool bUseSrcMaskBandIn,
                        const char* pszOutputSRSIn,
                        const char* pszResamplingIn,
-                       const char* const * papszOpenOptionsIn )
+                       const char* const * papszOpenOptionsIn,
+                       int nNumThreadsIn,
+                       const char* pszHarvestCacheIn )
 {
     pszOutputFilename = CPLStrdup(pszOutputFilenameIn);
     nInputFiles = nInputFilesIn;
@@ -367,6 +980,8 @@ VRTBuilder::VRTBuilder(const char* pszOutputFilenameIn,
     pszOutputSRS = (pszOutputSRSIn) ? CPLStrdup(pszOutputSRSIn) : nullptr;
     pszResampling = (pszResamplingIn) ? CPLStrdup(pszResamplingIn) : nullptr;
     bUseSrcMaskBand = bUseSrcMaskBandIn;
+    nNumThreads = nNumThreadsIn;
+    pszHarvestCache = (pszHarvestCacheIn) ? CPLStrdup(pszHarvestCacheIn) : nullptr;
 }
 
 /************************************************************************/
@@ -396,6 +1011,7 @@ VRTBuilder::~VRTBuilder()
     CPLFree(pszOutputSRS);
     CPLFree(pszResampling);
     CSLDestroy(papszOpenOptions);
+    CPLFree(pszHarvestCache);
 }
 
 /************************************************************************/
@@ -440,12 +1056,12 @@ static CPLString GetProjectionName(const char* pszProjection)
 /*                           AnalyseRaster()                            */
 /************************************************************************/
 
-int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetProperties)
+int VRTBuilder::AnalyseRaster( const HarvestedRaster& sRaster,
+                               DatasetProperty* psDatasetProperties)
 {
-    GDALDataset* poDS = GDALDataset::FromHandle(hDS);
-    const char* dsFileName = poDS->GetDescription();
-    char** papszMetadata = poDS->GetMetadata( "SUBDATASETS" );
-    if( CSLCount(papszMetadata) > 0 && poDS->GetRasterCount() == 0 )
+    const char* dsFileName = sRaster.osDescription.c_str();
+    CSLConstList papszMetadata = sRaster.aosSubdatasets.List();
+    if( CSLCount(papszMetadata) > 0 && sRaster.nBandCount == 0 )
     {
         ppszInputFilenames = static_cast<char **>(
             CPLRealloc(ppszInputFilenames,
@@ -487,9 +1103,11 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         return FALSE;
     }
 
-    const char* proj = poDS->GetProjectionRef();
+    const char* proj =
+        sRaster.bHasProjection ? sRaster.osProjection.c_str() : nullptr;
     double* padfGeoTransform = psDatasetProperties->adfGeoTransform;
-    int bGotGeoTransform = poDS->GetGeoTransform(padfGeoTransform) == CE_None;
+    memcpy(padfGeoTransform, sRaster.adfGeoTransform, 6 * sizeof(double));
+    int bGotGeoTransform = sRaster.bGotGeoTransform;
     if (bSeparate)
     {
         if (bFirst)
@@ -517,8 +1135,8 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
             return FALSE;
         }
         else if (!bHasGeoTransform &&
-                    (nRasterXSize != poDS->GetRasterXSize() ||
-                    nRasterYSize != poDS->GetRasterYSize()))
+                    (nRasterXSize != sRaster.nRasterXSize ||
+                    nRasterYSize != sRaster.nRasterYSize))
         {
             CPLError(CE_Warning, CPLE_NotSupported,
                     "gdalbuildvrt -separate cannot stack ungeoreferenced images that have not the same dimensions. Skipping %s",
@@ -557,24 +1175,24 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         }
     }
 
-    psDatasetProperties->nRasterXSize = poDS->GetRasterXSize();
-    psDatasetProperties->nRasterYSize = poDS->GetRasterYSize();
+    psDatasetProperties->nRasterXSize = sRaster.nRasterXSize;
+    psDatasetProperties->nRasterYSize = sRaster.nRasterYSize;
     if (bFirst && bSeparate && !bGotGeoTransform)
     {
-        nRasterXSize = poDS->GetRasterXSize();
-        nRasterYSize = poDS->GetRasterYSize();
+        nRasterXSize = sRaster.nRasterXSize;
+        nRasterYSize = sRaster.nRasterYSize;
     }
 
     double ds_minX = padfGeoTransform[GEOTRSFRM_TOPLEFT_X];
     double ds_maxY = padfGeoTransform[GEOTRSFRM_TOPLEFT_Y];
     double ds_maxX = ds_minX +
-                GDALGetRasterXSize(hDS) *
+                sRaster.nRasterXSize *
                 padfGeoTransform[GEOTRSFRM_WE_RES];
     double ds_minY = ds_maxY +
-                GDALGetRasterYSize(hDS) *
+                sRaster.nRasterYSize *
                 padfGeoTransform[GEOTRSFRM_NS_RES];
 
-    int _nBands = GDALGetRasterCount(hDS);
+    int _nBands = sRaster.nBandCount;
 
     //if provided band list
     if(nBands != 0 && _nBands != 0 && nMaxBandNo != 0 && _nBands > nMaxBandNo)
@@ -597,13 +1215,11 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         _nBands = 1;
     }
 
-    GDALRasterBand* poFirstBand = poDS->GetRasterBand(1);
-    poFirstBand->GetBlockSize(
-                        &psDatasetProperties->nBlockXSize,
-                        &psDatasetProperties->nBlockYSize);
+    psDatasetProperties->nBlockXSize = sRaster.nBlockXSize;
+    psDatasetProperties->nBlockYSize = sRaster.nBlockYSize;
 
     /* For the -separate case */
-    psDatasetProperties->firstBandType = poFirstBand->GetRasterDataType();
+    psDatasetProperties->firstBandType = sRaster.asBands[0].eDataType;
 
     psDatasetProperties->adfNoDataValues.resize(_nBands);
     psDatasetProperties->abHasNoData.resize(_nBands);
@@ -616,43 +1232,18 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
 
     psDatasetProperties->abHasMaskBand.resize(_nBands);
 
-    psDatasetProperties->bHasDatasetMask = poFirstBand->GetMaskFlags() == GMF_PER_DATASET;
+    psDatasetProperties->bHasDatasetMask =
+        sRaster.asBands[0].nMaskFlags == GMF_PER_DATASET;
     if (psDatasetProperties->bHasDatasetMask)
         bHasDatasetMask = TRUE;
-    poFirstBand->GetMaskBand()->GetBlockSize(
-                        &psDatasetProperties->nMaskBlockXSize,
-                        &psDatasetProperties->nMaskBlockYSize);
-
-    // Collect overview factors. We only handle power-of-two situations for now
-    const int nOverviews = poFirstBand->GetOverviewCount();
-    int nExpectedOvFactor = 2;
-    for(int j=0; j < nOverviews; j++)
-    {
-        GDALRasterBand* poOverview = poFirstBand->GetOverview(j);
-        if( !poOverview )
-            continue;
-        if( poOverview->GetXSize() < 128 &&
-            poOverview->GetYSize() < 128 )
-        {
-            break;
-        }
+    psDatasetProperties->nMaskBlockXSize = sRaster.nMaskBlockXSize;
+    psDatasetProperties->nMaskBlockYSize = sRaster.nMaskBlockYSize;
 
-        const int nOvFactor =
-            GDALComputeOvFactor(poOverview->GetXSize(),
-                                poFirstBand->GetXSize(),
-                                poOverview->GetYSize(),
-                                poFirstBand->GetYSize());
-
-        if( nOvFactor != nExpectedOvFactor )
-            break;
-
-        psDatasetProperties->anOverviewFactors.push_back(nOvFactor);
-        nExpectedOvFactor *= 2;
-    }
+    psDatasetProperties->anOverviewFactors = sRaster.anOverviewFactors;
 
     for(int j=0;j<_nBands;j++)
     {
-        GDALRasterBand* poBand = poDS->GetRasterBand(j+1);
+        const HarvestedBand& sBand = sRaster.asBands[j];
         if (!bSeparate && nSrcNoDataCount > 0)
         {
             psDatasetProperties->abHasNoData[j] = true;
@@ -663,26 +1254,22 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         }
         else
         {
-            int bHasNoData = false;
-            psDatasetProperties->adfNoDataValues[j]  =
-                poBand->GetNoDataValue(&bHasNoData);
-            psDatasetProperties->abHasNoData[j] = bHasNoData != 0;
+            psDatasetProperties->adfNoDataValues[j] = sBand.dfNoData;
+            psDatasetProperties->abHasNoData[j] = sBand.bHasNoData;
         }
 
-        int bHasOffset = false;
-        psDatasetProperties->adfOffset[j] = poBand->GetOffset(&bHasOffset);
-        psDatasetProperties->abHasOffset[j] = bHasOffset != 0 &&
+        psDatasetProperties->adfOffset[j] = sBand.dfOffset;
+        psDatasetProperties->abHasOffset[j] = sBand.bHasOffset &&
                             psDatasetProperties->adfOffset[j] != 0.0;
 
-        int bHasScale = false;
-        psDatasetProperties->adfScale[j] = poBand->GetScale(&bHasScale);
-        psDatasetProperties->abHasScale[j] = bHasScale != 0 &&
+        psDatasetProperties->adfScale[j] = sBand.dfScale;
+        psDatasetProperties->abHasScale[j] = sBand.bHasScale &&
                             psDatasetProperties->adfScale[j] != 1.0;
 
-        const int nMaskFlags = poBand->GetMaskFlags();
+        const int nMaskFlags = sBand.nMaskFlags;
         psDatasetProperties->abHasMaskBand[j] =
                     (nMaskFlags != GMF_ALL_VALID && nMaskFlags != GMF_NODATA) ||
-                    poBand->GetColorInterpretation() == GCI_AlphaBand;
+                    sBand.eColorInterp == GCI_AlphaBand;
     }
 
     if (bFirst)
@@ -712,19 +1299,25 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         }
         if (!bSeparate)
         {
+            if (nMaxBandNo > static_cast<int>(sRaster.asBands.size()))
+            {
+                CPLError(CE_Warning, CPLE_NotSupported,
+                         "Skipping %s as it has only %d bands",
+                         dsFileName, sRaster.nBandCount);
+                return FALSE;
+            }
             asBandProperties.resize(nMaxBandNo);
             for(int j=0;j<nMaxBandNo;j++)
             {
-                GDALRasterBand* poBand = poDS->GetRasterBand(j+1 );
-                asBandProperties[j].colorInterpretation =
-                        poBand->GetColorInterpretation();
-                asBandProperties[j].dataType = poBand->GetRasterDataType();
+                const HarvestedBand& sBand = sRaster.asBands[j];
+                asBandProperties[j].colorInterpretation = sBand.eColorInterp;
+                asBandProperties[j].dataType = sBand.eDataType;
                 if (asBandProperties[j].colorInterpretation == GCI_PaletteIndex)
                 {
-                    auto colorTable = poBand->GetColorTable();
-                    if (colorTable)
+                    if (sBand.poColorTable)
                     {
-                        asBandProperties[j].colorTable.reset(colorTable->Clone());
+                        asBandProperties[j].colorTable.reset(
+                            sBand.poColorTable->Clone());
                     }
                 }
                 else
@@ -740,20 +1333,16 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
                 }
                 else
                 {
-                    int bHasNoData = false;
-                    asBandProperties[j].noDataValue =
-                            poBand->GetNoDataValue(&bHasNoData);
-                    asBandProperties[j].bHasNoData = bHasNoData != 0;
+                    asBandProperties[j].noDataValue = sBand.dfNoData;
+                    asBandProperties[j].bHasNoData = sBand.bHasNoData;
                 }
 
-                int bHasOffset = false;
-                asBandProperties[j].dfOffset = poBand->GetOffset(&bHasOffset);
-                asBandProperties[j].bHasOffset = bHasOffset != 0 &&
+                asBandProperties[j].dfOffset = sBand.dfOffset;
+                asBandProperties[j].bHasOffset = sBand.bHasOffset &&
                                 asBandProperties[j].dfOffset != 0.0;
 
-                int bHasScale = false;
-                asBandProperties[j].dfScale = poBand->GetScale(&bHasScale);
-                asBandProperties[j].bHasScale = bHasScale != 0 &&
+                asBandProperties[j].dfScale = sBand.dfScale;
+                asBandProperties[j].bHasScale = sBand.bHasScale &&
                                 asBandProperties[j].dfScale != 1.0;
             }
         }
@@ -790,9 +1379,9 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
             }
             for(int j=0;j<nMaxBandNo;j++)
             {
-                GDALRasterBand* poBand = poDS->GetRasterBand(j+1 );
+                const HarvestedBand& sBand = sRaster.asBands[j];
                 if (asBandProperties[j].colorInterpretation !=
-                            poBand->GetColorInterpretation())
+                            sBand.eColorInterp)
                 {
                     CPLError(CE_Warning, CPLE_NotSupported,
                              "gdalbuildvrt does not support heterogeneous "
@@ -801,11 +1390,11 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
                              GDALGetColorInterpretationName(
                                  asBandProperties[j].colorInterpretation),
                              GDALGetColorInterpretationName(
-                                 poBand->GetColorInterpretation()),
+                                 sBand.eColorInterp),
                              dsFileName);
                     return FALSE;
                 }
-                if (asBandProperties[j].dataType != poBand->GetRasterDataType())
+                if (asBandProperties[j].dataType != sBand.eDataType)
                 {
                     CPLError(CE_Warning, CPLE_NotSupported,
                              "gdalbuildvrt does not support heterogeneous "
@@ -813,14 +1402,13 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
                              "Skipping %s",
                              GDALGetDataTypeName(
                                  asBandProperties[j].dataType),
-                             GDALGetDataTypeName(
-                                 poBand->GetRasterDataType()),
+                             GDALGetDataTypeName(sBand.eDataType),
                              dsFileName);
                     return FALSE;
                 }
                 if (asBandProperties[j].colorTable)
                 {
-                    const GDALColorTable* colorTable = poBand->GetColorTable();
+                    const GDALColorTable* colorTable = sBand.poColorTable.get();
                     int nRefColorEntryCount = asBandProperties[j].colorTable->GetColorEntryCount();
                     if (colorTable == nullptr ||
                         colorTable->GetColorEntryCount() != nRefColorEntryCount)
@@ -1399,6 +1987,47 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
         }
     }
 
+    /* The properties of the sources are read by a pool of threads, ahead */
+    /* of their analysis, that is done in input order. */
+    const int nMaxHarvestBands =
+        bSeparate ? 1 :
+        (nBands != 0 && nMaxBandNo != 0) ? nMaxBandNo :
+                                           std::numeric_limits<int>::max();
+
+    HarvestCache oHarvestCache;
+    std::unique_ptr<HarvestCacheWriter> poCacheWriter;
+    if( pszHarvestCache != nullptr && pahSrcDS == nullptr )
+    {
+        LoadHarvestCache(pszHarvestCache, papszOpenOptions, oHarvestCache);
+        poCacheWriter.reset(
+            new HarvestCacheWriter(pszHarvestCache, papszOpenOptions));
+    }
+
+    const auto CreateHarvestJob = [this, nMaxHarvestBands, &oHarvestCache,
+                                   &poCacheWriter](int iFile)
+    {
+        std::unique_ptr<HarvestJob> poJob(new HarvestJob());
+        poJob->osFilename = ppszInputFilenames[iFile];
+        poJob->papszOpenOptions = papszOpenOptions;
+        poJob->nMaxBands = nMaxHarvestBands;
+        if( poCacheWriter )
+            poJob->poCache = &oHarvestCache;
+        return poJob;
+    };
+
+    // Must be declared before the pool, so that it outlives it.
+    std::vector<std::unique_ptr<HarvestJob>> apoJobs;
+    std::unique_ptr<CPLWorkerThreadPool> poPool;
+    if( pahSrcDS == nullptr && nNumThreads > 1 && nInputFiles > 1 )
+    {
+        poPool.reset(new CPLWorkerThreadPool());
+        if( !poPool->Setup(nNumThreads, nullptr, nullptr) )
+            poPool.reset();
+    }
+    // Bounds the memory used by harvested properties not yet analysed
+    const int nMaxJobsAhead = poPool ? 4 * nNumThreads : 0;
+    int nSubmittedJobs = 0;
+
     int nCountValid = 0;
     for(int i=0; ppszInputFilenames != nullptr && i<nInputFiles;i++)
     {
@@ -1409,23 +2038,67 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
             return nullptr;
         }
 
-        GDALDatasetH hDS =
-            (pahSrcDS) ? pahSrcDS[i] :
-                GDALOpenEx( ppszInputFilenames[i],
-                            GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr,
-                            papszOpenOptions, nullptr );
         asDatasetProperties[i].isFileOK = FALSE;
 
-        if (hDS)
+        if( pahSrcDS )
         {
-            if (AnalyseRaster( hDS, &asDatasetProperties[i] ))
+            if (pahSrcDS[i])
+            {
+                HarvestedRaster sRaster;
+                HarvestRaster(pahSrcDS[i], nMaxHarvestBands, &sRaster);
+                if (AnalyseRaster( sRaster, &asDatasetProperties[i] ))
+                {
+                    asDatasetProperties[i].isFileOK = TRUE;
+                    nCountValid ++;
+                    bFirst = FALSE;
+                }
+            }
+            else
+            {
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "Can't open %s. Skipping it", dsFileName);
+            }
+            continue;
+        }
+
+        std::unique_ptr<HarvestJob> poJob;
+        if( poPool )
+        {
+            // nInputFiles grows when subdatasets are expanded
+            const int nJobsToSubmit = std::min(nInputFiles,
+                                               i + 1 + nMaxJobsAhead);
+            for( ; nSubmittedJobs < nJobsToSubmit; ++nSubmittedJobs )
+            {
+                apoJobs.emplace_back(CreateHarvestJob(nSubmittedJobs));
+                apoJobs.back()->bAccumulateErrors = true;
+                poPool->SubmitJob(HarvestJobFunc, apoJobs.back().get());
+            }
+            HarvestJob* psJob = apoJobs[i].get();
+            {
+                std::unique_lock<std::mutex> oLock(psJob->oMutex);
+                psJob->oCV.wait(oLock, [psJob]{ return psJob->bFinished; });
+            }
+            poJob = std::move(apoJobs[i]);
+            for( const auto& oError: poJob->aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+        else
+        {
+            poJob = CreateHarvestJob(i);
+            HarvestJobFunc(poJob.get());
+        }
+
+        const HarvestedRaster& sRaster = poJob->GetRaster();
+        if (sRaster.bOpened)
+        {
+            if( poCacheWriter )
+                poCacheWriter->Write(dsFileName, poJob->osCacheKey, sRaster);
+            if (AnalyseRaster( sRaster, &asDatasetProperties[i] ))
             {
                 asDatasetProperties[i].isFileOK = TRUE;
                 nCountValid ++;
                 bFirst = FALSE;
             }
-            if( pahSrcDS == nullptr )
-                GDALClose(hDS);
         }
         else
         {
@@ -1434,6 +2107,9 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
         }
     }
 
+    if( poCacheWriter )
+        poCacheWriter->Commit();
+
     if (nCountValid == 0)
         return nullptr;
 
@@ -1622,6 +2298,8 @@ struct GDALBuildVRTOptions
     char* pszResampling;
     char** papszOpenOptions;
     bool bUseSrcMaskBand;
+    int nNumThreads;
+    char* pszHarvestCache;
 
     /*! allow or suppress progress monitor and other non-error output */
     int bQuiet;
@@ -1654,6 +2332,7 @@ GDALBuildVRTOptions* GDALBuildVRTOptionsClone(const GDALBuildVRTOptions *psOptio
         memcpy(psOptions->panBandList, psOptionsIn->panBandList, sizeof(int) * psOptionsIn->nBandCount);
     }
     if( psOptionsIn->papszOpenOptions ) psOptions->papszOpenOptions = CSLDuplicate(psOptionsIn->papszOpenOptions);
+    if( psOptionsIn->pszHarvestCache ) psOptions->pszHarvestCache = CPLStrdup(psOptionsIn->pszHarvestCache);
     return psOptions;
 }
 
@@ -1759,6 +2438,15 @@ GDALDatasetH GDALBuildVRT( const char *pszDest,
     if (psOptions->pszSrcNoData != nullptr && psOptions->pszVRTNoData == nullptr)
         psOptions->pszVRTNoData = CPLStrdup(psOptions->pszSrcNoData);
 
+    int nNumThreads = psOptions->nNumThreads;
+    if( nNumThreads == 0 )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : std::max(1, atoi(pszNumThreads));
+    }
+
     VRTBuilder oBuilder(pszDest, nSrcCount, papszSrcDSNames, pahSrcDS,
                         psOptions->panBandList, psOptions->nBandCount, psOptions->nMaxBandNo,
                         eStrategy, psOptions->we_res, psOptions->ns_res, psOptions->bTargetAlignedPixels,
@@ -1768,7 +2456,8 @@ GDALDatasetH GDALBuildVRT( const char *pszDest,
                         psOptions->pszSrcNoData, psOptions->pszVRTNoData,
                         psOptions->bUseSrcMaskBand,
                         psOptions->pszOutputSRS, psOptions->pszResampling,
-                        psOptions->papszOpenOptions);
+                        psOptions->papszOpenOptions,
+                        nNumThreads, psOptions->pszHarvestCache);
 
     GDALDatasetH hDstDS =
         static_cast<GDALDatasetH>(oBuilder.Build(psOptions->pfnProgress, psOptions->pProgressData));
@@ -2016,6 +2705,24 @@ GDALBuildVRTOptions *GDALBuildVRTOptionsNew(char** papszArgv,
         {
             psOptions->bUseSrcMaskBand = false;
         }
+        else if( EQUAL(papszArgv[iArg],"-num_threads") && iArg + 1 < argc )
+        {
+            const char* pszNumThreads = papszArgv[++iArg];
+            psOptions->nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : atoi(pszNumThreads);
+            if( psOptions->nNumThreads <= 0 )
+            {
+                CPLError(CE_Failure, CPLE_IllegalArg,
+                         "Invalid value for -num_threads: %s", pszNumThreads);
+                GDALBuildVRTOptionsFree(psOptions);
+                return nullptr;
+            }
+        }
+        else if( EQUAL(papszArgv[iArg],"-harvest_cache") && iArg + 1 < argc )
+        {
+            CPLFree(psOptions->pszHarvestCache);
+            psOptions->pszHarvestCache = CPLStrdup(papszArgv[++iArg]);
+        }
         else if( papszArgv[iArg][0] == '-' )
         {
             CPLError(CE_Failure, CPLE_NotSupported,
@@ -2069,6 +2776,7 @@ void GDALBuildVRTOptionsFree( GDALBuildVRTOptions *psOptions )
         CPLFree( psOptions->panBandList );
         CPLFree( psOptions->pszResampling );
         CSLDestroy( psOptions->papszOpenOptions );
+        CPLFree( psOptions->pszHarvestCache );
     }
 
     CPLFree(psOptions);
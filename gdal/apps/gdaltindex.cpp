@@ -29,14 +29,22 @@
 
 #include "cpl_port.h"
 #include "cpl_conv.h"
+#include "cpl_error_internal.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_version.h"
 #include "gdal.h"
 #include "ogr_api.h"
 #include "ogr_srs_api.h"
 #include "commonutils.h"
 
+#include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -52,7 +60,8 @@ static void Usage(const char* pszErrorMsg)
             "Usage: gdaltindex [-f format] [-tileindex field_name] [-write_absolute_path] \n"
             "                  [-skip_different_projection] [-t_srs target_srs]\n"
             "                  [-src_srs_name field_name] [-src_srs_format [AUTO|WKT|EPSG|PROJ]\n"
-            "                  [-lyr_name name] index_file [gdal_file]*\n"
+            "                  [-lyr_name name] [-num_threads value|ALL_CPUS]\n"
+            "                  index_file [gdal_file]*\n"
             "\n"
             "e.g.\n"
             "  % gdaltindex doq_index.shp doq/*.tif\n"
@@ -68,7 +77,9 @@ static void Usage(const char* pszErrorMsg)
             "    target coordinate reference system.\n"
             "    Note that using this option generates files that are NOT compatible with MapServer < 6.4.\n"
             "  o Simple rectangular polygons are generated in the same coordinate reference system\n"
-            "    as the rasters, or in target reference system if the -t_srs option is used.\n");
+            "    as the rasters, or in target reference system if the -t_srs option is used.\n"
+            "  o With -num_threads, rasters are opened by several threads, which is\n"
+            "    mostly useful for rasters on network file systems.\n");
 
     if( pszErrorMsg != nullptr )
         fprintf(stderr, "\nFAILURE: %s\n", pszErrorMsg);
@@ -93,6 +104,73 @@ typedef enum
     FORMAT_PROJ
 } SrcSRSFormat;
 
+/************************************************************************/
+/*                            TileIndexRaster                           */
+/************************************************************************/
+
+namespace {
+struct TileIndexRaster
+{
+    CPL_DISALLOW_COPY_ASSIGN(TileIndexRaster)
+
+    TileIndexRaster() = default;
+
+    // Input
+    std::string osFilename{};
+    bool        bAccumulateErrors = false;
+
+    // Output
+    bool        bOpened = false;
+    double      adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    std::string osProjectionRef{};
+    int         nXSize = 0;
+    int         nYSize = 0;
+    // Errors emitted while opening, to be re-emitted in input order
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+    // Synchronization
+    bool                    bFinished = false;
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+};
+} // namespace
+
+/************************************************************************/
+/*                          ReadTileIndexRaster()                       */
+/************************************************************************/
+
+static void ReadTileIndexRaster(void* pData)
+{
+    TileIndexRaster* psRaster = static_cast<TileIndexRaster*>(pData);
+    if( psRaster->bAccumulateErrors )
+    {
+        CPLInstallErrorHandlerAccumulator(psRaster->aoErrors);
+        CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+    }
+
+    GDALDatasetH hDS = GDALOpen( psRaster->osFilename.c_str(), GA_ReadOnly );
+    if( hDS != nullptr )
+    {
+        psRaster->bOpened = true;
+        GDALGetGeoTransform( hDS, psRaster->adfGeoTransform );
+        const char* pszProjectionRef = GDALGetProjectionRef(hDS);
+        if( pszProjectionRef )
+            psRaster->osProjectionRef = pszProjectionRef;
+        psRaster->nXSize = GDALGetRasterXSize( hDS );
+        psRaster->nYSize = GDALGetRasterYSize( hDS );
+        GDALClose( hDS );
+    }
+
+    if( psRaster->bAccumulateErrors )
+        CPLUninstallErrorHandlerAccumulator();
+
+    {
+        std::lock_guard<std::mutex> oLock(psRaster->oMutex);
+        psRaster->bFinished = true;
+    }
+    psRaster->oCV.notify_one();
+}
+
 MAIN_START(argc, argv)
 {
     // Check that we are running against at least GDAL 1.4.
@@ -130,6 +208,7 @@ MAIN_START(argc, argv)
     int i_SrcSRSName = -1;
     bool bSrcSRSFormatSpecified = false;
     SrcSRSFormat eSrcSRSFormat = FORMAT_AUTO;
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
 
     int iArg = 1;  // Used after for.
     for( ; iArg < argc; iArg++ )
@@ -193,6 +272,11 @@ MAIN_START(argc, argv)
             else if( EQUAL(pszFormat, "PROJ") )
                 eSrcSRSFormat = FORMAT_PROJ;
         }
+        else if( strcmp(argv[iArg], "-num_threads") == 0 )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            pszNumThreads = argv[++iArg];
+        }
         else if( argv[iArg][0] == '-' )
             Usage(CPLSPrintf("Unknown option name '%s'", argv[iArg]));
         else if( index_filename == nullptr )
@@ -210,6 +294,8 @@ MAIN_START(argc, argv)
     if( bSrcSRSFormatSpecified && pszSrcSRSName == nullptr )
         Usage("-src_srs_name must be specified when -src_srs_format is "
               "specified.");
+    const int nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+        CPLGetNumCPUs() : std::max(1, atoi(pszNumThreads));
 
 /* -------------------------------------------------------------------- */
 /*      Create and validate target SRS if given.                        */
@@ -443,56 +529,111 @@ MAIN_START(argc, argv)
     }
 
 /* -------------------------------------------------------------------- */
-/*      loop over GDAL files, processing.                               */
+/*      Find the files not yet in the tile index.                       */
 /* -------------------------------------------------------------------- */
-    for( ; iArg < argc; iArg++ )
+    const int nFirstFile = iArg;
+    const int nFiles = argc - nFirstFile;
+    std::vector<std::string> aosFileNamesToWrite(nFiles);
+    std::vector<bool> abAlreadyInIndex(nFiles);
+    for( int iFile = 0; iFile < nFiles; iFile++ )
     {
-        char *fileNameToWrite = nullptr;
+        const char* pszFilename = argv[nFirstFile + iFile];
         VSIStatBuf sStatBuf;
 
         // Make sure it is a file before building absolute path name.
-        if( write_absolute_path && CPLIsFilenameRelative( argv[iArg] ) &&
-            VSIStat( argv[iArg], &sStatBuf ) == 0 )
+        if( write_absolute_path && CPLIsFilenameRelative( pszFilename ) &&
+            VSIStat( pszFilename, &sStatBuf ) == 0 )
         {
-            fileNameToWrite =
-                CPLStrdup(CPLProjectRelativeFilename(current_path, argv[iArg]));
+            aosFileNamesToWrite[iFile] =
+                CPLProjectRelativeFilename(current_path, pszFilename);
         }
         else
         {
-            fileNameToWrite = CPLStrdup(argv[iArg]);
+            aosFileNamesToWrite[iFile] = pszFilename;
         }
 
         // Checks that file is not already in tileindex.
+        for( int i = 0; i < nExistingFiles; i++ )
         {
-            int i = 0;  // Used after for.
-            for( ; i < nExistingFiles; i++ )
+            if (EQUAL(aosFileNamesToWrite[iFile].c_str(), existingFilesTab[i]))
             {
-                if (EQUAL(fileNameToWrite, existingFilesTab[i]))
-                {
-                    fprintf(stderr,
-                            "File %s is already in tileindex. Skipping it.\n",
-                            fileNameToWrite);
-                    break;
-                }
+                abAlreadyInIndex[iFile] = true;
+                break;
             }
-            if (i != nExistingFiles)
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      The files are opened by a pool of threads, ahead of their       */
+/*      insertion, that is done in input order.                         */
+/* -------------------------------------------------------------------- */
+    // Must be declared before the pool, so that it outlives it.
+    std::vector<std::unique_ptr<TileIndexRaster>> apoRasters(nFiles);
+    std::unique_ptr<CPLWorkerThreadPool> poPool;
+    if( nNumThreads > 1 && nFiles > 1 )
+    {
+        poPool.reset(new CPLWorkerThreadPool());
+        if( !poPool->Setup(nNumThreads, nullptr, nullptr) )
+            poPool.reset();
+    }
+    // Bounds the number of rasters opened ahead
+    const int nMaxJobsAhead = poPool ? 4 * nNumThreads : 0;
+    int nSubmittedJobs = 0;
+
+/* -------------------------------------------------------------------- */
+/*      loop over GDAL files, processing.                               */
+/* -------------------------------------------------------------------- */
+    for( int iFile = 0; iFile < nFiles; iFile++ )
+    {
+        const char* pszFilename = argv[nFirstFile + iFile];
+        const char* fileNameToWrite = aosFileNamesToWrite[iFile].c_str();
+
+        if( abAlreadyInIndex[iFile] )
+        {
+            fprintf(stderr,
+                    "File %s is already in tileindex. Skipping it.\n",
+                    fileNameToWrite);
+            continue;
+        }
+
+        std::unique_ptr<TileIndexRaster> poRaster;
+        if( poPool )
+        {
+            for( ; nSubmittedJobs < std::min(nFiles, iFile + 1 + nMaxJobsAhead);
+                 ++nSubmittedJobs )
+            {
+                if( abAlreadyInIndex[nSubmittedJobs] )
+                    continue;
+                auto& poJob = apoRasters[nSubmittedJobs];
+                poJob.reset(new TileIndexRaster());
+                poJob->osFilename = argv[nFirstFile + nSubmittedJobs];
+                poJob->bAccumulateErrors = true;
+                poPool->SubmitJob(ReadTileIndexRaster, poJob.get());
+            }
+            TileIndexRaster* psJob = apoRasters[iFile].get();
             {
-                CPLFree(fileNameToWrite);
-                continue;
+                std::unique_lock<std::mutex> oLock(psJob->oMutex);
+                psJob->oCV.wait(oLock, [psJob]{ return psJob->bFinished; });
             }
+            poRaster = std::move(apoRasters[iFile]);
+            for( const auto& oError: poRaster->aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+        else
+        {
+            poRaster.reset(new TileIndexRaster());
+            poRaster->osFilename = pszFilename;
+            ReadTileIndexRaster(poRaster.get());
         }
 
-        GDALDatasetH hDS = GDALOpen( argv[iArg], GA_ReadOnly );
-        if( hDS == nullptr )
+        if( !poRaster->bOpened )
         {
             fprintf( stderr, "Unable to open %s, skipping.\n",
-                     argv[iArg] );
-            CPLFree(fileNameToWrite);
+                     pszFilename );
             continue;
         }
 
-        double adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
-        GDALGetGeoTransform( hDS, adfGeoTransform );
+        const double* adfGeoTransform = poRaster->adfGeoTransform;
         if( adfGeoTransform[0] == 0.0
             && adfGeoTransform[1] == 1.0
             && adfGeoTransform[3] == 0.0
@@ -501,13 +642,11 @@ MAIN_START(argc, argv)
             fprintf( stderr,
                      "It appears no georeferencing is available for\n"
                      "`%s', skipping.\n",
-                     argv[iArg] );
-            GDALClose( hDS );
-            CPLFree(fileNameToWrite);
+                     pszFilename );
             continue;
         }
 
-        const char *projectionRef = GDALGetProjectionRef(hDS);
+        const char *projectionRef = poRaster->osProjectionRef.c_str();
 
         // If not set target srs, test that the current file uses same
         // projection as others.
@@ -533,12 +672,10 @@ MAIN_START(argc, argv)
                         "for example.\n"
                         "Use -t_srs option to set target projection system "
                         "(not supported by MapServer).\n"
-                        "%s\n", argv[iArg],
+                        "%s\n", pszFilename,
                         skip_different_projection ? "Skipping this file." : "");
                     if( skip_different_projection )
                     {
-                        CPLFree(fileNameToWrite);
-                        GDALClose( hDS );
                         continue;
                     }
                 }
@@ -550,8 +687,8 @@ MAIN_START(argc, argv)
             }
         }
 
-        const int nXSize = GDALGetRasterXSize( hDS );
-        const int nYSize = GDALGetRasterYSize( hDS );
+        const int nXSize = poRaster->nXSize;
+        const int nYSize = poRaster->nYSize;
 
         double adfX[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
         double adfY[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
@@ -712,10 +849,6 @@ MAIN_START(argc, argv)
         }
 
         OGR_F_Destroy( hFeature );
-
-        CPLFree(fileNameToWrite);
-
-        GDALClose( hDS );
     }
 
     CPLFree(current_path);
@@ -29,14 +29,22 @@
 
 #include "cpl_port.h"
 
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_string.h"
 #include "gdal_version.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_alg.h"
+#include "gdal_alg_priv.h"
 #include "gdalwarper.h"
 #include "gdal.h"
 #include "gdal_version.h"
@@ -47,6 +55,7 @@
 #include "commonutils.h"
 
 #ifdef _WIN32
+#include <fcntl.h>
 #include <io.h>
 #else
 #include <unistd.h>
@@ -66,6 +75,8 @@ static void Usage(const char* pszErrorMsg = nullptr)
         "    [-i] [-s_srs srs_def] [-t_srs srs_def] [-to \"NAME=VALUE\"]\n"
         "    [-ct proj_string] [-order n] [-tps] [-rpc] [-geoloc] \n"
         "    [-gcp pixel line easting northing [elevation]]* [-output_xy]\n"
+        "    [-batch] [-binary_input] [-binary_output]\n"
+        "    [-num_threads value|ALL_CPUS]\n"
         "    [srcfile [dstfile]]\n"
         "\n" );
 
@@ -101,6 +112,95 @@ static bool IsValidSRS( const char *pszUserInput )
     return bRes;
 }
 
+/************************************************************************/
+/*                          TransformPoints()                           */
+/*                                                                      */
+/*      Transform a batch of points, splitting it between the threads   */
+/*      of the global thread pool. Each thread uses its own clone of    */
+/*      the transformer, since transformers are not thread-safe.        */
+/************************************************************************/
+
+namespace {
+struct TransformJob
+{
+    GDALTransformerFunc pfnTransformer = nullptr;
+    void               *hTransformArg = nullptr;
+    int                 bInverse = FALSE;
+    int                 nPointCount = 0;
+    double             *padfX = nullptr;
+    double             *padfY = nullptr;
+    double             *padfZ = nullptr;
+    int                *pabSuccess = nullptr;
+};
+} // namespace
+
+static void TransformJobFunc( void* pData )
+{
+    TransformJob* psJob = static_cast<TransformJob*>(pData);
+    if( !psJob->pfnTransformer( psJob->hTransformArg, psJob->bInverse,
+                                psJob->nPointCount,
+                                psJob->padfX, psJob->padfY, psJob->padfZ,
+                                psJob->pabSuccess ) )
+    {
+        std::fill(psJob->pabSuccess, psJob->pabSuccess + psJob->nPointCount,
+                  FALSE);
+    }
+}
+
+static void TransformPoints( GDALTransformerFunc pfnTransformer,
+                             void* hTransformArg,
+                             std::vector<void*>& ahClonedTransformArgs,
+                             CPLWorkerThreadPool* poPool,
+                             int bInverse, int nPointCount,
+                             double* padfX, double* padfY, double* padfZ,
+                             int* pabSuccess )
+{
+    // Not worth dispatching small batches.
+    const int nMinPointsPerJob = 1000;
+    int nJobs = std::max(1, std::min(poPool ? poPool->GetThreadCount() : 1,
+                                     nPointCount / nMinPointsPerJob));
+    CPLWorkerThreadPool* poThreadPool = nJobs > 1 ? poPool : nullptr;
+    while( poThreadPool != nullptr &&
+           static_cast<int>(ahClonedTransformArgs.size()) < nJobs - 1 )
+    {
+        void* hClonedTransformArg = GDALCloneTransformer(hTransformArg);
+        if( hClonedTransformArg == nullptr )
+            break;
+        ahClonedTransformArgs.push_back(hClonedTransformArg);
+    }
+    nJobs = poThreadPool ?
+        std::min(nJobs, static_cast<int>(ahClonedTransformArgs.size()) + 1) :
+        1;
+
+    std::vector<TransformJob> asJobs(nJobs);
+    const int nPointsPerJob = (nPointCount + nJobs - 1) / nJobs;
+    for( int i = 0; i < nJobs; i++ )
+    {
+        const int nStart = i * nPointsPerJob;
+        TransformJob& sJob = asJobs[i];
+        sJob.pfnTransformer = pfnTransformer;
+        sJob.hTransformArg =
+            i == 0 ? hTransformArg : ahClonedTransformArgs[i - 1];
+        sJob.bInverse = bInverse;
+        sJob.nPointCount = std::min(nPointsPerJob, nPointCount - nStart);
+        sJob.padfX = padfX + nStart;
+        sJob.padfY = padfY + nStart;
+        sJob.padfZ = padfZ + nStart;
+        sJob.pabSuccess = pabSuccess + nStart;
+    }
+
+    if( nJobs == 1 )
+    {
+        TransformJobFunc(&asJobs[0]);
+        return;
+    }
+
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    for( auto& sJob: asJobs )
+        poJobQueue->SubmitJob(TransformJobFunc, &sJob);
+    poJobQueue->WaitCompletion();
+}
+
 /************************************************************************/
 /*                                main()                                */
 /************************************************************************/
@@ -144,6 +244,11 @@ MAIN_START(argc, argv)
     double              dfZ = 0.0;
     double              dfT = 0.0;
     bool                bCoordOnCommandLine = false;
+    bool                bBatch = false;
+    bool                bBinaryInput = false;
+    bool                bBinaryOutput = false;
+    int                 nRetCode = 0;
+    int                 nNumThreads = 0;
 
 /* -------------------------------------------------------------------- */
 /*      Parse arguments.                                                */
@@ -250,6 +355,30 @@ MAIN_START(argc, argv)
         {
             bOutputXY = TRUE;
         }
+        else if( EQUAL(argv[i],"-batch") )
+        {
+            bBatch = true;
+        }
+        else if( EQUAL(argv[i],"-binary_input") )
+        {
+            bBatch = true;
+            bBinaryInput = true;
+        }
+        else if( EQUAL(argv[i],"-binary_output") )
+        {
+            bBatch = true;
+            bBinaryOutput = true;
+        }
+        else if( EQUAL(argv[i],"-num_threads") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            const char* pszNumThreads = argv[++i];
+            nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : atoi(pszNumThreads);
+            if( nNumThreads <= 0 )
+                Usage(CPLSPrintf("Invalid value for -num_threads: %s",
+                                 pszNumThreads));
+        }
         else if( EQUAL(argv[i],"-coord")  && i + 2 < argc)
         {
             bCoordOnCommandLine = true;
@@ -337,8 +466,23 @@ MAIN_START(argc, argv)
 /*      Read points from stdin, transform and write to stdout.          */
 /* -------------------------------------------------------------------- */
     double dfLastT = 0.0;
-    
-    if( !bCoordOnCommandLine )
+
+    const auto SetCoordinateEpoch = [&](double dfNewT)
+    {
+        if( dfNewT != 0.0 )
+        {
+            aosTO.SetNameValue("COORDINATE_EPOCH", CPLSPrintf("%g", dfNewT));
+        }
+        else
+        {
+            aosTO.SetNameValue("COORDINATE_EPOCH", nullptr);
+        }
+        GDALDestroyGenImgProjTransformer(hTransformArg);
+        hTransformArg =
+            GDALCreateGenImgProjTransformer2( hSrcDS, hDstDS, aosTO.List() );
+    };
+
+    if( !bCoordOnCommandLine && !bBinaryInput )
     {
         // Is it an interactive terminal ?
         if( isatty(static_cast<int>(fileno(stdin))) )
@@ -354,7 +498,178 @@ MAIN_START(argc, argv)
         }
     }
 
-    while( bCoordOnCommandLine || !feof(stdin) )
+/* -------------------------------------------------------------------- */
+/*      In batch mode, points are read by blocks, which are             */
+/*      transformed by several threads, and written in input order.     */
+/* -------------------------------------------------------------------- */
+    if( bBatch && !bCoordOnCommandLine )
+    {
+        if( nNumThreads == 0 )
+        {
+            const char* pszNumThreads =
+                CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+            nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : std::max(1, atoi(pszNumThreads));
+        }
+
+#ifdef _WIN32
+        if( bBinaryInput )
+            _setmode(_fileno(stdin), _O_BINARY);
+        if( bBinaryOutput )
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+        std::unique_ptr<CPLWorkerThreadPool> poPool;
+        if( nNumThreads > 1 )
+        {
+            poPool.reset(new CPLWorkerThreadPool());
+            if( !poPool->Setup(nNumThreads, nullptr, nullptr) )
+                poPool.reset();
+        }
+
+        const size_t nBatchSize = 100000;
+        const int nOutputDims = bOutputXY ? 2 : 3;
+        std::vector<double> adfX;
+        std::vector<double> adfY;
+        std::vector<double> adfZ;
+        std::vector<double> adfT;
+        std::vector<int> abSuccess;
+        std::vector<double> adfBuffer;
+        std::vector<void*> ahClonedTransformArgs;
+        const auto DestroyClonedTransformers = [&ahClonedTransformArgs]()
+        {
+            for( void* hClonedTransformArg: ahClonedTransformArgs )
+                GDALDestroyTransformer(hClonedTransformArg);
+            ahClonedTransformArgs.clear();
+        };
+
+        bool bEOF = false;
+        while( !bEOF )
+        {
+            adfX.clear();
+            adfY.clear();
+            adfZ.clear();
+            adfT.clear();
+            if( bBinaryInput )
+            {
+                // Records of X, Y and Z as native doubles.
+                constexpr size_t nRecordSize = 3 * sizeof(double);
+                adfBuffer.resize(3 * nBatchSize);
+                const size_t nReadBytes = fread(adfBuffer.data(), 1,
+                                                nRecordSize * nBatchSize,
+                                                stdin);
+                if( nReadBytes < nRecordSize * nBatchSize )
+                    bEOF = true;
+                if( (nReadBytes % nRecordSize) != 0 )
+                {
+                    fprintf(stderr, "Truncated binary input: the last "
+                            "record only has " CPL_FRMT_GUIB " bytes.\n",
+                            static_cast<GUIntBig>(nReadBytes % nRecordSize));
+                    nRetCode = 1;
+                }
+                const size_t nRead = nReadBytes / nRecordSize;
+                for( size_t i = 0; i < nRead; i++ )
+                {
+                    adfX.push_back(adfBuffer[3 * i]);
+                    adfY.push_back(adfBuffer[3 * i + 1]);
+                    adfZ.push_back(adfBuffer[3 * i + 2]);
+                    adfT.push_back(0.0);
+                }
+            }
+            else
+            {
+                while( adfX.size() < nBatchSize )
+                {
+                    char szLine[1024];
+                    if( fgets( szLine, sizeof(szLine)-1, stdin ) == nullptr )
+                    {
+                        bEOF = true;
+                        break;
+                    }
+
+                    const CPLStringList aosTokens(CSLTokenizeString(szLine));
+                    const int nCount = aosTokens.size();
+                    if( nCount < 2 )
+                        continue;
+
+                    adfX.push_back(CPLAtof(aosTokens[0]));
+                    adfY.push_back(CPLAtof(aosTokens[1]));
+                    adfZ.push_back(nCount >= 3 ? CPLAtof(aosTokens[2]) : 0.0);
+                    adfT.push_back(nCount == 4 ? CPLAtof(aosTokens[3]) : 0.0);
+                }
+            }
+
+            // Transform runs of points with the same coordinate epoch.
+            const size_t nPoints = adfX.size();
+            abSuccess.resize(nPoints);
+            for( size_t iStart = 0; iStart < nPoints; )
+            {
+                size_t iEnd = iStart + 1;
+                while( iEnd < nPoints && adfT[iEnd] == adfT[iStart] )
+                    iEnd++;
+                if( adfT[iStart] != dfLastT && nGCPCount == 0 )
+                {
+                    DestroyClonedTransformers();
+                    SetCoordinateEpoch(adfT[iStart]);
+                }
+                dfLastT = adfT[iStart];
+
+                TransformPoints(pfnTransformer, hTransformArg,
+                                ahClonedTransformArgs, poPool.get(), bInverse,
+                                static_cast<int>(iEnd - iStart),
+                                &adfX[iStart], &adfY[iStart], &adfZ[iStart],
+                                &abSuccess[iStart]);
+                iStart = iEnd;
+            }
+
+            if( bBinaryOutput )
+            {
+                // Points that could not be transformed are written as NaN.
+                adfBuffer.resize(nOutputDims * nPoints);
+                for( size_t i = 0; i < nPoints; i++ )
+                {
+                    double* padfOut = &adfBuffer[nOutputDims * i];
+                    if( abSuccess[i] )
+                    {
+                        padfOut[0] = adfX[i];
+                        padfOut[1] = adfY[i];
+                        if( nOutputDims == 3 )
+                            padfOut[2] = adfZ[i];
+                    }
+                    else
+                    {
+                        std::fill(padfOut, padfOut + nOutputDims,
+                                  std::numeric_limits<double>::quiet_NaN());
+                    }
+                }
+                if( fwrite(adfBuffer.data(), nOutputDims * sizeof(double),
+                           nPoints, stdout) != nPoints )
+                {
+                    fprintf(stderr, "Error while writing to stdout.\n");
+                    nRetCode = 1;
+                    break;
+                }
+            }
+            else
+            {
+                for( size_t i = 0; i < nPoints; i++ )
+                {
+                    if( !abSuccess[i] )
+                        printf( "transformation failed.\n" );
+                    else if( bOutputXY )
+                        CPLprintf( "%.15g %.15g\n", adfX[i], adfY[i] );
+                    else
+                        CPLprintf( "%.15g %.15g %.15g\n",
+                                   adfX[i], adfY[i], adfZ[i] );
+                }
+            }
+            fflush(stdout);
+        }
+
+        DestroyClonedTransformers();
+    }
+
+    while( bCoordOnCommandLine || (!bBatch && !feof(stdin)) )
     {
         if( !bCoordOnCommandLine )
         {
@@ -386,17 +701,7 @@ MAIN_START(argc, argv)
         }
         if( dfT != dfLastT && nGCPCount == 0 )
         {
-            if( dfT != 0.0 )
-            {
-                aosTO.SetNameValue("COORDINATE_EPOCH", CPLSPrintf("%g", dfT));
-            }
-            else
-            {
-                aosTO.SetNameValue("COORDINATE_EPOCH", nullptr);
-            }
-            GDALDestroyGenImgProjTransformer(hTransformArg);
-            hTransformArg =
-                GDALCreateGenImgProjTransformer2( hSrcDS, hDstDS, aosTO.List() );
+            SetCoordinateEpoch(dfT);
         }
 
         int bSuccess = TRUE;
@@ -449,6 +754,6 @@ MAIN_START(argc, argv)
 
     CSLDestroy( argv );
 
-    return 0;
+    return nRetCode;
 }
 MAIN_END
@@ -75,7 +75,8 @@ static void Usage(const char* pszErrorMsg = nullptr)
         "    [-te xmin ymin xmax ymax] [-tr xres yres] [-tap] [-ts width height]\n"
         "    [-ovr level|AUTO|AUTO-n|NONE] [-wo \"NAME=VALUE\"] [-ot Byte/Int16/...] [-wt Byte/Int16]\n"
         "    [-srcnodata \"value [value...]\"] [-dstnodata \"value [value...]\"] -dstalpha\n"
-        "    [-r resampling_method] [-wm memory_in_mb] [-multi] [-q]\n"
+        "    [-r resampling_method] [-wm memory_in_mb] [-multi]\n"
+        "    [-src_threads val|ALL_CPUS] [-q]\n"
         "    [-cutline datasource] [-cl layer] [-cwhere expression]\n"
         "    [-csql statement] [-cblend dist_in_pixels] [-crop_to_cutline]\n"
         "    [-if format]* [-of format] [-co \"NAME=VALUE\"]* [-overwrite]\n"
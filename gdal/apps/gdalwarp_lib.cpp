@@ -42,6 +42,7 @@
 #include <algorithm>
 #include <array>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "commonutils.h"
@@ -174,6 +175,11 @@ struct GDALWarpAppOptions
         to process chunks of image and perform input/output operation simultaneously. */
     bool bMulti;
 
+    /*! number of source datasets warped concurrently. Chunks of the output
+        that are covered by several sources are still composited in the order
+        of the sources. */
+    int nSrcThreads;
+
     /*! list of transformer options suitable to pass to GDALCreateGenImgProjTransformer2().
         ("NAME1=VALUE1","NAME2=VALUE2",...) */
     char **papszTO;
@@ -2205,6 +2211,33 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
     oProgress.nSrcCount = nSrcCount;
     oProgress.pahSrcDS = pahSrcDS;
 
+/* -------------------------------------------------------------------- */
+/*      When sources are warped concurrently, the warp operations of    */
+/*      all sources are first set up, and run together afterwards.      */
+/* -------------------------------------------------------------------- */
+    struct PendingWarp
+    {
+        std::unique_ptr<GDALWarpOperation> poWO{};
+        void* hTransformArg = nullptr;
+        GDALDatasetH hWrkSrcDS = nullptr;
+        int anDstWindow[4] = {0, 0, 0, 0};
+
+        PendingWarp() = default;
+        PendingWarp(const PendingWarp&) = delete;
+        PendingWarp& operator=(const PendingWarp&) = delete;
+
+        ~PendingWarp()
+        {
+            poWO.reset();
+            GDALDestroyTransformer( hTransformArg );
+            GDALReleaseDataset( hWrkSrcDS );
+        }
+    };
+
+    const bool bConcurrentSrc =
+        psOptions->nSrcThreads > 1 && nSrcCount > 1 && !bVRT;
+    std::vector<std::unique_ptr<PendingWarp>> apoPendingWarps;
+
 /* -------------------------------------------------------------------- */
 /*      Loop over all source files, processing each in turn.            */
 /* -------------------------------------------------------------------- */
@@ -2217,7 +2250,8 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
 /* -------------------------------------------------------------------- */
         hSrcDS = pahSrcDS[iSrc];
         oProgress.iSrc = iSrc;
-        oProgress.Do(0);
+        if( !bConcurrentSrc )
+            oProgress.Do(0);
 
 /* -------------------------------------------------------------------- */
 /*      Check that there's at least one raster band                     */
@@ -2478,7 +2512,7 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
         psWO->hSrcDS = hWrkSrcDS;
         psWO->hDstDS = hDstDS;
 
-        if( !bVRT )
+        if( !bVRT && !bConcurrentSrc )
         {
             psWO->pfnProgress = Progress::ProgressFunc;
             psWO->pProgressArg = &oProgress;
@@ -2648,6 +2682,28 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
             return hDstDS;
         }
 
+/* -------------------------------------------------------------------- */
+/*      Initialize the warp, and defer its execution if sources are     */
+/*      warped concurrently.                                            */
+/* -------------------------------------------------------------------- */
+        if( bConcurrentSrc )
+        {
+            std::unique_ptr<PendingWarp> poPendingWarp(new PendingWarp());
+            poPendingWarp->hTransformArg = hTransformArg;
+            poPendingWarp->hWrkSrcDS = hWrkSrcDS;
+            poPendingWarp->anDstWindow[0] = nWarpDstXOff;
+            poPendingWarp->anDstWindow[1] = nWarpDstYOff;
+            poPendingWarp->anDstWindow[2] = nWarpDstXSize;
+            poPendingWarp->anDstWindow[3] = nWarpDstYSize;
+            poPendingWarp->poWO.reset(new GDALWarpOperation());
+            if( poPendingWarp->poWO->Initialize( psWO ) == CE_None )
+                apoPendingWarps.push_back(std::move(poPendingWarp));
+            else
+                bHasGotErr = true;
+            GDALDestroyWarpOptions( psWO );
+            continue;
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Initialize and execute the warp.                                */
 /* -------------------------------------------------------------------- */
@@ -2684,6 +2740,30 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
         GDALReleaseDataset(hWrkSrcDS);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Run the warps of all sources together.                          */
+/* -------------------------------------------------------------------- */
+    if( !apoPendingWarps.empty() )
+    {
+        std::vector<GDALWarpOperation*> apoWO;
+        std::vector<int> anDstWindows;
+        for( const auto& poPendingWarp: apoPendingWarps )
+        {
+            apoWO.push_back(poPendingWarp->poWO.get());
+            anDstWindows.insert(anDstWindows.end(),
+                                poPendingWarp->anDstWindow,
+                                poPendingWarp->anDstWindow + 4);
+        }
+        if( GDALWarpOperation::ChunkAndWarpConcurrently(
+                static_cast<int>(apoWO.size()), apoWO.data(),
+                anDstWindows.data(), psOptions->nSrcThreads,
+                psOptions->pfnProgress, psOptions->pProgressData) != CE_None )
+        {
+            bHasGotErr = true;
+        }
+        apoPendingWarps.clear();
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Final Cleanup.                                                  */
 /* -------------------------------------------------------------------- */
@@ -4139,6 +4219,7 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
     psOptions->pszSrcNodata = nullptr;
     psOptions->pszDstNodata = nullptr;
     psOptions->bMulti = false;
+    psOptions->nSrcThreads = 1;
     psOptions->papszTO = nullptr;
     psOptions->pszCutlineDSName = nullptr;
     psOptions->pszCLayer = nullptr;
@@ -4191,6 +4272,29 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
         {
             psOptions->bMulti = true;
         }
+        else if( EQUAL(papszArgv[i],"-src_threads") && i+1 < argc )
+        {
+            const char* pszVal = papszArgv[++i];
+            if( EQUAL(pszVal, "ALL_CPUS") )
+            {
+                psOptions->nSrcThreads = CPLGetNumCPUs();
+            }
+            else
+            {
+                char* pszEnd = nullptr;
+                const long nVal = strtol(pszVal, &pszEnd, 10);
+                if( pszEnd == pszVal || *pszEnd != '\0' || nVal <= 0 )
+                {
+                    CPLError(CE_Failure, CPLE_IllegalArg,
+                             "Invalid value for -src_threads: %s.", pszVal);
+                    GDALWarpAppOptionsFree(psOptions);
+                    return nullptr;
+                }
+                // Each of them is a dedicated thread.
+                psOptions->nSrcThreads = static_cast<int>(
+                    std::min(nVal, static_cast<long>(CPLGetNumCPUs())));
+            }
+        }
         else if( EQUAL(papszArgv[i],"-q") || EQUAL(papszArgv[i],"-quiet"))
         {
             if( psOptionsForBinary )
@@ -44,7 +44,9 @@
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -71,13 +73,49 @@ struct GDALNearblackOptions
     Colors oColors;
 
     char** papszCreationOptions;
+
+    /*! number of threads, or 0 to use GDAL_NUM_THREADS */
+    int nNumThreads;
+};
+
+// Approximate amount of memory used to process a chunk of lines.
+constexpr GIntBig NEARBLACK_CHUNK_SIZE = 64 * 1024 * 1024;
+
+namespace {
+
+struct NearblackContext
+{
+    GByte *pabyChunk = nullptr;      // nLines lines of nXSize * nDstBands
+    GByte *pabyMaskChunk = nullptr;  // nLines lines of nXSize, or null
+    int *panLastLineCounts = nullptr; // state of the vertical scans
+    int *panChunkCounts = nullptr;   // panLastLineCounts after each line
+    int nXSize = 0;
+    int nLines = 0;
+    int nSrcBands = 0;
+    int nDstBands = 0;
+    int nNearDist = 0;
+    int nMaxNonBlack = 0;
+    bool bNearWhite = false;
+    Colors *poColors = nullptr;
+    bool bBottomUp = false;
+};
+
+struct NearblackJob
+{
+    const NearblackContext *psContext;
+    int iStart;  // first column or line
+    int iEnd;    // last column or line
 };
 
+} // namespace
+
 static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
                          int iEnd, int nSrcBands, int nDstBands, int nNearDist,
                          int nMaxNonBlack, bool bNearWhite, Colors *poColors,
                          int *panLastLineCounts, bool bDoHorizontalCheck,
                          bool bDoVerticalCheck, bool bBottomUp );
+static void ProcessChunk( NearblackContext &sContext, CPLJobQueue *poJobQueue,
+                          int nNumThreads );
 
 /************************************************************************/
 /*                            GDALNearblack()                           */
@@ -337,137 +375,141 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Allocate a line buffer.                                         */
+/*      Process the image by chunks of whole lines, first from the top  */
+/*      down, then from the bottom up. Within a chunk, the vertical     */
+/*      scans are run by column strips, and then the horizontal scans   */
+/*      by groups of lines, possibly on several threads.                */
 /* -------------------------------------------------------------------- */
+    int nNumThreads = psOptions->nNumThreads;
+    if( nNumThreads == 0 )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : std::max(1, atoi(pszNumThreads));
+    }
+    nNumThreads = std::min(nNumThreads, std::max(1, nXSize / 64));
 
-    GByte *pabyLine = static_cast<GByte *>(CPLMalloc(nXSize * nDstBands));
-
-    GByte *pabyMask = nullptr;
-    if( bSetMask )
-        pabyMask = static_cast<GByte *>(CPLMalloc(nXSize));
-
-    int *panLastLineCounts = static_cast<int *>(CPLCalloc(sizeof(int), nXSize));
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nNumThreads > 1 )
+    {
+        CPLWorkerThreadPool* poThreadPool =
+            GDALGetGlobalThreadPool(nNumThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
 
-/* -------------------------------------------------------------------- */
-/*      Processing data one line at a time.                             */
-/* -------------------------------------------------------------------- */
-    int iLine;
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    GDALGetBlockSize(GDALGetRasterBand(hDstDS, 1), &nBlockXSize, &nBlockYSize);
+    nBlockYSize = std::max(1, nBlockYSize);
+
+    const GIntBig nBytesPerLine =
+        static_cast<GIntBig>(nXSize) *
+            (nDstBands + (bSetMask ? 1 : 0) + sizeof(int));
+    int nChunkLines = static_cast<int>(std::min(
+        static_cast<GIntBig>(nYSize),
+        std::max(static_cast<GIntBig>(1), NEARBLACK_CHUNK_SIZE / nBytesPerLine)));
+    if( nChunkLines > nBlockYSize )
+        nChunkLines = (nChunkLines / nBlockYSize) * nBlockYSize;
+    const int nChunkCount = (nYSize + nChunkLines - 1) / nChunkLines;
+
+    const size_t nChunkPixels = static_cast<size_t>(nXSize) * nChunkLines;
+    GByte *pabyChunk = static_cast<GByte *>(
+        VSI_MALLOC2_VERBOSE(nChunkPixels, nDstBands));
+    GByte *pabyMaskChunk = bSetMask ?
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nChunkPixels)) : nullptr;
+    int *panChunkCounts = static_cast<int *>(
+        VSI_MALLOC2_VERBOSE(nChunkPixels, sizeof(int)));
+    int *panLastLineCounts = static_cast<int *>(
+        VSI_CALLOC_VERBOSE(sizeof(int), nXSize));
+    if( pabyChunk == nullptr || (bSetMask && pabyMaskChunk == nullptr) ||
+        panChunkCounts == nullptr || panLastLineCounts == nullptr )
+    {
+        if( bCloseOutDSOnError )
+            GDALClose(hDstDS);
+        hDstDS = nullptr;
+    }
 
-    for( iLine = 0; iLine < nYSize; iLine++ )
+    NearblackContext sContext;
+    sContext.pabyChunk = pabyChunk;
+    sContext.pabyMaskChunk = pabyMaskChunk;
+    sContext.panLastLineCounts = panLastLineCounts;
+    sContext.panChunkCounts = panChunkCounts;
+    sContext.nXSize = nXSize;
+    sContext.nSrcBands = nBands;
+    sContext.nDstBands = nDstBands;
+    sContext.nNearDist = nNearDist;
+    sContext.nMaxNonBlack = nMaxNonBlack;
+    sContext.bNearWhite = bNearWhite;
+    sContext.poColors = &oColors;
+
+    for( int iPass = 0; hDstDS != nullptr && iPass < 2; iPass++ )
     {
-        CPLErr eErr =
-            GDALDatasetRasterIO(hSrcDataset, GF_Read, 0, iLine, nXSize, 1,
-                                pabyLine, nXSize, 1, GDT_Byte,
-                                nBands, nullptr, nDstBands,
-                                nXSize * nDstBands, 1);
-        if( eErr != CE_None )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
+        const bool bBottomUp = iPass == 1;
+        sContext.bBottomUp = bBottomUp;
+        memset(panLastLineCounts, 0, sizeof(int) * nXSize);
 
-        if( bSetAlpha )
+        for( int iChunk = 0; iChunk < nChunkCount; iChunk++ )
         {
-            for( int iCol = 0; iCol < nXSize; iCol++ )
+            const int iChunkLine =
+                (bBottomUp ? nChunkCount - 1 - iChunk : iChunk) * nChunkLines;
+            const int nLines = std::min(nChunkLines, nYSize - iChunkLine);
+            sContext.nLines = nLines;
+
+            // The top down pass reads the source, and the bottom up pass
+            // reads back what the top down pass has written.
+            CPLErr eErr = bBottomUp ?
+                GDALDatasetRasterIO(hDstDS, GF_Read, 0, iChunkLine,
+                                    nXSize, nLines,
+                                    pabyChunk, nXSize, nLines, GDT_Byte,
+                                    nDstBands, nullptr, nDstBands,
+                                    static_cast<GSpacing>(nXSize) * nDstBands,
+                                    1) :
+                GDALDatasetRasterIO(hSrcDataset, GF_Read, 0, iChunkLine,
+                                    nXSize, nLines,
+                                    pabyChunk, nXSize, nLines, GDT_Byte,
+                                    nBands, nullptr, nDstBands,
+                                    static_cast<GSpacing>(nXSize) * nDstBands,
+                                    1);
+            if( eErr == CE_None && !bBottomUp )
             {
-                pabyLine[iCol * nDstBands + nDstBands - 1] = 255;
-            }
-        }
+                if( bSetAlpha )
+                {
+                    const size_t nPixels = static_cast<size_t>(nXSize) * nLines;
+                    for( size_t i = 0; i < nPixels; i++ )
+                        pabyChunk[i * nDstBands + nDstBands - 1] = 255;
+                }
 
-        if( bSetMask )
-        {
-            for( int iCol = 0; iCol < nXSize; iCol ++ )
+                if( bSetMask )
+                    memset(pabyMaskChunk, 255,
+                           static_cast<size_t>(nXSize) * nLines);
+            }
+            else if( eErr == CE_None && bSetMask )
             {
-                pabyMask[iCol] = 255;
+                /***** read the mask band lines back in *****/
+                eErr = GDALRasterIO(hMaskBand, GF_Read, 0, iChunkLine,
+                                    nXSize, nLines,
+                                    pabyMaskChunk, nXSize, nLines, GDT_Byte,
+                                    0, 0);
             }
-        }
-
-        ProcessLine(pabyLine, pabyMask, 0, nXSize-1, nBands, nDstBands,
-                    nNearDist, nMaxNonBlack, bNearWhite, &oColors,
-                    panLastLineCounts,
-                    true, // bDoHorizontalCheck
-                    true, // bDoVerticalCheck
-                    false // bBottomUp
-                    );
-        ProcessLine(pabyLine, pabyMask, nXSize-1, 0, nBands, nDstBands,
-                    nNearDist, nMaxNonBlack, bNearWhite, &oColors,
-                    panLastLineCounts,
-                    true,  // bDoHorizontalCheck
-                    false, // bDoVerticalCheck
-                    false  // bBottomUp
-                    );
-
-        eErr = GDALDatasetRasterIO(hDstDS, GF_Write, 0, iLine, nXSize, 1,
-                                   pabyLine, nXSize, 1, GDT_Byte,
-                                   nDstBands, nullptr, nDstBands,
-                                   nXSize * nDstBands, 1);
-
-        if( eErr != CE_None )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
-
-        /***** write out the mask band line *****/
-
-        if( bSetMask )
-        {
-            eErr = GDALRasterIO (hMaskBand, GF_Write, 0, iLine, nXSize, 1,
-                                 pabyMask, nXSize, 1, GDT_Byte,
-                                 0, 0);
             if( eErr != CE_None )
             {
-                CPLError(CE_Warning, CPLE_AppDefined,
-                         "ERROR writing out line to mask band.");
                 if( bCloseOutDSOnError )
                     GDALClose(hDstDS);
                 hDstDS = nullptr;
                 break;
             }
-        }
 
-        if( !(psOptions->pfnProgress(
-                  0.5 * ((iLine+1) / static_cast<double>(nYSize)), nullptr,
-                  psOptions->pProgressData)) )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Now process from the bottom back up                            .*/
-/* -------------------------------------------------------------------- */
-    memset(panLastLineCounts, 0, sizeof(int) * nXSize);
+            ProcessChunk(sContext, poJobQueue.get(), nNumThreads);
 
-    for( iLine = nYSize-1; hDstDS != nullptr && iLine >= 0; iLine-- )
-    {
-        CPLErr eErr =
-            GDALDatasetRasterIO(hDstDS, GF_Read, 0, iLine, nXSize, 1,
-                                pabyLine, nXSize, 1, GDT_Byte,
-                                nDstBands, nullptr, nDstBands,
-                                nXSize * nDstBands, 1 );
-        if( eErr != CE_None )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
-
-        /***** read the mask band line back in *****/
-
-        if( bSetMask )
-        {
-            eErr = GDALRasterIO(hMaskBand, GF_Read, 0, iLine, nXSize, 1,
-                                pabyMask, nXSize, 1, GDT_Byte,
-                                0, 0);
+            eErr = GDALDatasetRasterIO(hDstDS, GF_Write, 0, iChunkLine,
+                                       nXSize, nLines,
+                                       pabyChunk, nXSize, nLines, GDT_Byte,
+                                       nDstBands, nullptr, nDstBands,
+                                       static_cast<GSpacing>(nXSize) *
+                                           nDstBands,
+                                       1);
             if( eErr != CE_None )
             {
                 if( bCloseOutDSOnError )
@@ -475,43 +517,29 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
                 hDstDS = nullptr;
                 break;
             }
-        }
-
-        ProcessLine(pabyLine, pabyMask, 0, nXSize-1, nBands, nDstBands,
-                    nNearDist, nMaxNonBlack, bNearWhite, &oColors,
-                    panLastLineCounts,
-                    true, // bDoHorizontalCheck
-                    true, // bDoVerticalCheck
-                    true  // bBottomUp
-                    );
-        ProcessLine(pabyLine, pabyMask, nXSize-1, 0, nBands, nDstBands,
-                    nNearDist, nMaxNonBlack, bNearWhite, &oColors,
-                    panLastLineCounts,
-                    true,  // bDoHorizontalCheck
-                    false, // bDoVerticalCheck
-                    true   // bBottomUp
-                    );
 
-        eErr = GDALDatasetRasterIO(hDstDS, GF_Write, 0, iLine, nXSize, 1,
-                                   pabyLine, nXSize, 1, GDT_Byte,
-                                   nDstBands, nullptr, nDstBands,
-                                   nXSize * nDstBands, 1);
-        if( eErr != CE_None )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
+            /***** write out the mask band lines *****/
 
-        /***** write out the mask band line *****/
+            if( bSetMask )
+            {
+                eErr = GDALRasterIO(hMaskBand, GF_Write, 0, iChunkLine,
+                                    nXSize, nLines,
+                                    pabyMaskChunk, nXSize, nLines, GDT_Byte,
+                                    0, 0);
+                if( eErr != CE_None )
+                {
+                    CPLError(CE_Warning, CPLE_AppDefined,
+                             "ERROR writing out lines to mask band.");
+                    if( bCloseOutDSOnError )
+                        GDALClose(hDstDS);
+                    hDstDS = nullptr;
+                    break;
+                }
+            }
 
-        if( bSetMask )
-        {
-            eErr = GDALRasterIO (hMaskBand, GF_Write, 0, iLine, nXSize, 1,
-                                 pabyMask, nXSize, 1, GDT_Byte,
-                                 0, 0);
-            if( eErr != CE_None )
+            if( !(psOptions->pfnProgress(
+                      0.5 * iPass + 0.5 * (iChunk + 1) / nChunkCount, nullptr,
+                      psOptions->pProgressData)) )
             {
                 if( bCloseOutDSOnError )
                     GDALClose(hDstDS);
@@ -519,27 +547,139 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
                 break;
             }
         }
-
-        if( !(psOptions->pfnProgress( 0.5 + 0.5 * (nYSize-iLine) /
-            static_cast<double>(nYSize), nullptr, psOptions->pProgressData )) )
-        {
-            if( bCloseOutDSOnError )
-                GDALClose(hDstDS);
-            hDstDS = nullptr;
-            break;
-        }
     }
 
-    CPLFree(pabyLine);
-    if( bSetMask )
-        CPLFree(pabyMask);
-
-    CPLFree( panLastLineCounts );
+    VSIFree(pabyChunk);
+    VSIFree(pabyMaskChunk);
+    VSIFree(panChunkCounts);
+    VSIFree(panLastLineCounts);
     GDALNearblackOptionsFree(psOptionsToFree);
 
     return hDstDS;
 }
 
+/************************************************************************/
+/*                        ProcessVerticalStrip()                        */
+/*                                                                      */
+/*      Run the vertical scan of a strip of columns over the lines of   */
+/*      a chunk, and record the counts after each line.                 */
+/************************************************************************/
+
+static void ProcessVerticalStrip( void *pData )
+{
+    const NearblackJob *psJob = static_cast<const NearblackJob *>(pData);
+    const NearblackContext &sContext = *(psJob->psContext);
+    const int nXSize = sContext.nXSize;
+
+    for( int i = 0; i < sContext.nLines; i++ )
+    {
+        const int iLine = sContext.bBottomUp ? sContext.nLines - 1 - i : i;
+        const size_t nLineOffset = static_cast<size_t>(iLine) * nXSize;
+        ProcessLine(sContext.pabyChunk + nLineOffset * sContext.nDstBands,
+                    sContext.pabyMaskChunk ?
+                        sContext.pabyMaskChunk + nLineOffset : nullptr,
+                    psJob->iStart, psJob->iEnd,
+                    sContext.nSrcBands, sContext.nDstBands,
+                    sContext.nNearDist, sContext.nMaxNonBlack,
+                    sContext.bNearWhite, sContext.poColors,
+                    sContext.panLastLineCounts,
+                    false, // bDoHorizontalCheck
+                    true,  // bDoVerticalCheck
+                    sContext.bBottomUp);
+        memcpy(sContext.panChunkCounts + nLineOffset + psJob->iStart,
+               sContext.panLastLineCounts + psJob->iStart,
+               sizeof(int) * (psJob->iEnd - psJob->iStart + 1));
+    }
+}
+
+/************************************************************************/
+/*                       ProcessHorizontalLines()                       */
+/*                                                                      */
+/*      Run the horizontal scans of a group of lines of a chunk.        */
+/************************************************************************/
+
+static void ProcessHorizontalLines( void *pData )
+{
+    const NearblackJob *psJob = static_cast<const NearblackJob *>(pData);
+    const NearblackContext &sContext = *(psJob->psContext);
+    const int nXSize = sContext.nXSize;
+
+    for( int iLine = psJob->iStart; iLine <= psJob->iEnd; iLine++ )
+    {
+        const size_t nLineOffset = static_cast<size_t>(iLine) * nXSize;
+        GByte *pabyLine = sContext.pabyChunk + nLineOffset * sContext.nDstBands;
+        GByte *pabyMask = sContext.pabyMaskChunk ?
+                            sContext.pabyMaskChunk + nLineOffset : nullptr;
+        int *panCounts = sContext.panChunkCounts + nLineOffset;
+
+        ProcessLine(pabyLine, pabyMask, 0, nXSize-1,
+                    sContext.nSrcBands, sContext.nDstBands,
+                    sContext.nNearDist, sContext.nMaxNonBlack,
+                    sContext.bNearWhite, sContext.poColors, panCounts,
+                    true,  // bDoHorizontalCheck
+                    false, // bDoVerticalCheck
+                    sContext.bBottomUp);
+        ProcessLine(pabyLine, pabyMask, nXSize-1, 0,
+                    sContext.nSrcBands, sContext.nDstBands,
+                    sContext.nNearDist, sContext.nMaxNonBlack,
+                    sContext.bNearWhite, sContext.poColors, panCounts,
+                    true,  // bDoHorizontalCheck
+                    false, // bDoVerticalCheck
+                    sContext.bBottomUp);
+    }
+}
+
+/************************************************************************/
+/*                            ProcessChunk()                            */
+/*                                                                      */
+/*      Process a chunk of lines. This gives the same result as         */
+/*      processing its lines one after the other with ProcessLine(),    */
+/*      since the vertical scan of a line only depends on the previous  */
+/*      lines through panLastLineCounts, and the horizontal scans of a  */
+/*      line only modify that line.                                     */
+/************************************************************************/
+
+static void ProcessChunk( NearblackContext &sContext, CPLJobQueue *poJobQueue,
+                          int nNumThreads )
+{
+    const int nXSize = sContext.nXSize;
+    const int nLines = sContext.nLines;
+    // A few jobs per thread to balance the load.
+    const int nJobsPerPhase = poJobQueue ? 4 * nNumThreads : 1;
+
+    std::vector<NearblackJob> asJobs;
+    const auto RunJobs = [&asJobs, poJobQueue](CPLThreadFunc pfnFunc)
+    {
+        if( poJobQueue == nullptr )
+        {
+            for( auto &sJob: asJobs )
+                pfnFunc(&sJob);
+            return;
+        }
+        for( auto &sJob: asJobs )
+            poJobQueue->SubmitJob(pfnFunc, &sJob);
+        poJobQueue->WaitCompletion();
+    };
+
+    const int nStripWidth = std::max(64, (nXSize + nJobsPerPhase - 1) /
+                                             nJobsPerPhase);
+    for( int iCol = 0; iCol < nXSize; iCol += nStripWidth )
+    {
+        asJobs.push_back(
+            { &sContext, iCol, std::min(nXSize, iCol + nStripWidth) - 1 });
+    }
+    RunJobs(ProcessVerticalStrip);
+
+    asJobs.clear();
+    const int nLinesPerJob = (nLines + nJobsPerPhase - 1) / nJobsPerPhase;
+    for( int iLine = 0; iLine < nLines; iLine += nLinesPerJob )
+    {
+        asJobs.push_back(
+            { &sContext, iLine, std::min(nLines, iLine + nLinesPerJob) - 1 });
+    }
+    RunJobs(ProcessHorizontalLines);
+}
+
 /************************************************************************/
 /*                            ProcessLine()                             */
 /*                                                                      */
@@ -560,9 +700,10 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
 
     if( bDoVerticalCheck )
     {
-        const int nXSize = std::max(iStart + 1, iEnd + 1);
+        const int iFirst = std::min(iStart, iEnd);
+        const int iLast = std::max(iStart, iEnd);
 
-        for( int i = 0; i < nXSize; i++ )
+        for( int i = iFirst; i <= iLast; i++ )
         {
             // are we already terminated for this column?
             if( panLastLineCounts[i] > nMaxNonBlack )
@@ -577,7 +718,7 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
             for( int iColor = 0; iColor < static_cast<int>(poColors->size() );
                  iColor++) {
 
-                Color oColor = (*poColors)[iColor];
+                const Color& oColor = (*poColors)[iColor];
 
                 bIsNonBlack = false;
 
@@ -655,7 +796,7 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
                 for( int iColor = 0;
                      iColor < static_cast<int>(poColors->size()); iColor++ ) {
 
-                    Color oColor = (*poColors)[iColor];
+                    const Color& oColor = (*poColors)[iColor];
 
                     bIsNonBlack = false;
 
@@ -776,6 +917,7 @@ GDALNearblackOptions *GDALNearblackOptionsNew(
     psOptions->bNearWhite = false;
     psOptions->bSetAlpha = false;
     psOptions->bSetMask = false;
+    psOptions->nNumThreads = 0;
 
 /* -------------------------------------------------------------------- */
 /*      Handle command line arguments.                                  */
@@ -880,6 +1022,19 @@ GDALNearblackOptions *GDALNearblackOptionsNew(
         {
             psOptions->bSetMask = true;
         }
+        else if( i+1<argc && EQUAL(papszArgv[i], "-num_threads") )
+        {
+            const char* pszNumThreads = papszArgv[++i];
+            psOptions->nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : atoi(pszNumThreads);
+            if( psOptions->nNumThreads <= 0 )
+            {
+                CPLError(CE_Failure, CPLE_IllegalArg,
+                         "Invalid value for -num_threads: %s", pszNumThreads);
+                GDALNearblackOptionsFree(psOptions);
+                return nullptr;
+            }
+        }
         else if( papszArgv[i][0] == '-' )
         {
             CPLError(CE_Failure, CPLE_NotSupported,
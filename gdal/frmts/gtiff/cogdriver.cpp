@@ -1088,8 +1088,6 @@ static GDALDataset* COGCreateCopy( const char * pszFilename,
 
 class GDALCOGDriver final: public GDALDriver
 {
-        bool m_bInitialized = false;
-
         bool bHasLZW = false;
         bool bHasDEFLATE = false;
         bool bHasLZMA = false;
@@ -1099,25 +1097,10 @@ class GDALCOGDriver final: public GDALDriver
         bool bHasLERC = false;
         std::string osCompressValues{};
 
-        void InitializeCreationOptionList();
-
     public:
         GDALCOGDriver();
 
-        const char* GetMetadataItem(const char* pszName, const char* pszDomain) override
-        {
-            if( EQUAL(pszName, GDAL_DMD_CREATIONOPTIONLIST) )
-            {
-                InitializeCreationOptionList();
-            }
-            return GDALDriver::GetMetadataItem(pszName, pszDomain);
-        }
-
-        char** GetMetadata(const char* pszDomain) override
-        {
-            InitializeCreationOptionList();
-            return GDALDriver::GetMetadata(pszDomain);
-        }
+        void InitializeCreationOptionList();
 };
 
 GDALCOGDriver::GDALCOGDriver()
@@ -1133,10 +1116,6 @@ GDALCOGDriver::GDALCOGDriver()
 
 void GDALCOGDriver::InitializeCreationOptionList()
 {
-    if( m_bInitialized )
-        return;
-    m_bInitialized = true;
-
     CPLString osOptions;
     osOptions = "<CreationOptionList>"
                 "   <Option name='COMPRESS' type='string-select'>";
@@ -1275,5 +1254,12 @@ void GDALRegister_COG()
 
     poDriver->pfnCreateCopy = COGCreateCopy;
 
+    poDriver->SetDeferredInit(
+        [](GDALDriver* poDriverIn)
+        {
+            static_cast<GDALCOGDriver*>(poDriverIn)->
+                InitializeCreationOptionList();
+        });
+
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
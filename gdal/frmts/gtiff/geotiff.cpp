@@ -20114,30 +20114,21 @@ CPLString GTiffGetCompressValues(bool& bHasLZW,
 }
 
 /************************************************************************/
-/*                          GDALRegister_GTiff()                        */
-/************************************************************************/
-
-void GDALRegister_GTiff()
-
+/*                     GTiffSetCreationOptionList()                     */
+/************************************************************************/
+
+static void GTiffSetCreationOptionList( GDALDriver* poDriver,
+                                        const CPLString& osCompressValues,
+                                        bool bHasLZW,
+                                        bool bHasDEFLATE,
+                                        bool bHasLZMA,
+                                        bool bHasZSTD,
+                                        bool bHasJPEG,
+                                        bool bHasWebP,
+                                        bool bHasLERC )
 {
-    if( GDALGetDriverByName( "GTiff" ) != nullptr )
-        return;
-
     CPLString osOptions;
 
-    bool bHasLZW = false;
-    bool bHasDEFLATE = false;
-    bool bHasLZMA = false;
-    bool bHasZSTD = false;
-    bool bHasJPEG = false;
-    bool bHasWebP = false;
-    bool bHasLERC = false;
-    CPLString osCompressValues(GTiffGetCompressValues(
-        bHasLZW, bHasDEFLATE, bHasLZMA, bHasZSTD, bHasJPEG, bHasWebP, bHasLERC,
-        false /* bForCOG */));
-
-    GDALDriver *poDriver = new GDALDriver();
-
 /* -------------------------------------------------------------------- */
 /*      Build full creation option list.                                */
 /* -------------------------------------------------------------------- */
@@ -20265,6 +20256,32 @@ void GDALRegister_GTiff()
 #endif
 "</CreationOptionList>";
 
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, osOptions );
+}
+
+/************************************************************************/
+/*                          GDALRegister_GTiff()                        */
+/************************************************************************/
+
+void GDALRegister_GTiff()
+
+{
+    if( GDALGetDriverByName( "GTiff" ) != nullptr )
+        return;
+
+    bool bHasLZW = false;
+    bool bHasDEFLATE = false;
+    bool bHasLZMA = false;
+    bool bHasZSTD = false;
+    bool bHasJPEG = false;
+    bool bHasWebP = false;
+    bool bHasLERC = false;
+    CPLString osCompressValues(GTiffGetCompressValues(
+        bHasLZW, bHasDEFLATE, bHasLZMA, bHasZSTD, bHasJPEG, bHasWebP, bHasLERC,
+        false /* bForCOG */));
+
+    GDALDriver *poDriver = new GDALDriver();
+
 /* -------------------------------------------------------------------- */
 /*      Set the driver details.                                         */
 /* -------------------------------------------------------------------- */
@@ -20278,7 +20295,6 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte UInt16 Int16 UInt32 Int32 Float32 "
                                "Float64 CInt16 CInt32 CFloat32 CFloat64" );
-    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, osOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
 "   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
@@ -20308,5 +20324,15 @@ void GDALRegister_GTiff()
     poDriver->pfnUnloadDriver = GDALDeregister_GTiff;
     poDriver->pfnIdentify = GTiffDataset::Identify;
 
+    // Building the creation option list is deferred until it is needed.
+    poDriver->SetDeferredInit(
+        [osCompressValues, bHasLZW, bHasDEFLATE, bHasLZMA, bHasZSTD,
+         bHasJPEG, bHasWebP, bHasLERC](GDALDriver* poDriverIn)
+        {
+            GTiffSetCreationOptionList(poDriverIn, osCompressValues,
+                                       bHasLZW, bHasDEFLATE, bHasLZMA,
+                                       bHasZSTD, bHasJPEG, bHasWebP, bHasLERC);
+        });
+
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
@@ -35,6 +35,7 @@
 
 #include "cpl_list.h"
 #include "gdal_pam.h"
+#include "gdalmdarraychunkreader.h"
 
 typedef struct HDF5GroupObjects
 {
@@ -105,12 +106,14 @@ class HDF5SharedResources
     bool m_bReadOnly = true;
     hid_t            m_hHDF5 = 0;
     CPLString        m_osFilename{};
+    std::string      m_osChunkCacheKeyPrefix = GDALMDArrayChunkReader::GetNewKeyPrefix();
 public:
     HDF5SharedResources() = default;
     ~HDF5SharedResources();
 
     inline hid_t GetHDF5() const { return m_hHDF5; }
     inline bool IsReadOnly() const { return m_bReadOnly; }
+    inline const std::string& GetChunkCacheKeyPrefix() const { return m_osChunkCacheKeyPrefix; }
 };
 
 } // namespace GDAL
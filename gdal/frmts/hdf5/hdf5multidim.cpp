@@ -31,6 +31,13 @@
 #include <set>
 #include <utility>
 
+#if defined(H5_VERSION_GE)
+# if H5_VERSION_GE(1,10,2)
+// H5Dread_chunk() is available
+#  define HDF5_HAS_READ_CHUNK
+# endif
+#endif
+
 namespace GDAL
 {
 
@@ -269,6 +276,10 @@ class HDF5Array final: public GDALMDArray
     mutable bool    m_bHasDimensionList = false;
     mutable bool    m_bHasDimensionLabels = false;
     haddr_t         m_nOffset;
+#ifdef HDF5_HAS_READ_CHUNK
+    std::vector<std::pair<H5Z_filter_t, size_t>> m_aoFilters{};
+    std::unique_ptr<GDALMDArrayChunkReader> m_poChunkReader{};
+#endif
 
     HDF5Array(const std::string& osParentName,
               const std::string& osName,
@@ -290,6 +301,16 @@ class HDF5Array final: public GDALMDArray
     static herr_t GetAttributesCallback( hid_t hArray, const char *pszObjName,
                                          void* );
 
+#ifdef HDF5_HAS_READ_CHUNK
+    void InitChunkReader();
+    bool FetchChunk(const std::vector<GUInt64>& anChunkIdx,
+                    const std::vector<GUInt64>& anChunkSize,
+                    std::vector<GByte>& abyRaw) const;
+    bool DecodeChunk(const std::vector<GByte>& abyRaw,
+                     std::vector<GByte>& abyDecoded,
+                     size_t nChunkBytes) const;
+#endif
+
 protected:
 
     bool IRead(const GUInt64* arrayStartIdx,
@@ -456,6 +477,7 @@ public:
 
 HDF5SharedResources::~HDF5SharedResources()
 {
+    GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
     if( m_hHDF5 > 0 )
         H5Fclose(m_hHDF5);
 }
@@ -828,6 +850,10 @@ HDF5Array::HDF5Array(const std::string& osParentName,
     {
         InstantiateDimensions(osParentName, poGroup);
     }
+
+#ifdef HDF5_HAS_READ_CHUNK
+    InitChunkReader();
+#endif
 }
 
 /************************************************************************/
@@ -1619,6 +1645,247 @@ lbl_return_to_caller_in_loop:
         goto lbl_return_to_caller_in_loop;
 }
 
+#ifdef HDF5_HAS_READ_CHUNK
+
+/************************************************************************/
+/*                          InitChunkReader()                           */
+/************************************************************************/
+
+// Set up a GDALMDArrayChunkReader for chunked datasets of native numeric
+// type whose filters can be decoded by GDAL itself. Raw chunks are read
+// sequentially with H5Dread_chunk(), and decoded in parallel.
+void HDF5Array::InitChunkReader()
+{
+    const size_t nDims = m_dims.size();
+    if( nDims == 0 || m_dt.GetClass() != GEDTC_NUMERIC ||
+        m_bHasNonNativeDataType )
+        return;
+    const auto eClass = H5Tget_class(m_hNativeDT);
+    if( eClass != H5T_INTEGER && eClass != H5T_FLOAT )
+        return;
+    if( H5Tget_size(m_hNativeDT) != m_dt.GetSize() )
+        return;
+    const hid_t hFileDT = H5Dget_type(m_hArray);
+    const bool bNativeInFile = H5Tequal(hFileDT, m_hNativeDT) > 0;
+    H5Tclose(hFileDT);
+    if( !bNativeInFile )
+        return;
+
+    const hid_t hPlist = H5Dget_create_plist(m_hArray);
+    if( hPlist < 0 )
+        return;
+    bool bOK = H5Pget_layout(hPlist) == H5D_CHUNKED;
+    std::vector<hsize_t> anChunkDims(nDims);
+    if( bOK )
+    {
+        bOK = H5Pget_chunk(hPlist, static_cast<int>(nDims),
+                           anChunkDims.data()) == static_cast<int>(nDims);
+    }
+    const int nFilters = bOK ? H5Pget_nfilters(hPlist) : 0;
+    for( int i = 0; bOK && i < nFilters; ++i )
+    {
+        unsigned int nFlags = 0;
+        size_t nCdValues = 1;
+        unsigned int anCdValues[1] = { 0 };
+        const H5Z_filter_t nFilterId = H5Pget_filter2(
+            hPlist, static_cast<unsigned>(i), &nFlags, &nCdValues, anCdValues,
+            0, nullptr, nullptr);
+        if( nFilterId == H5Z_FILTER_DEFLATE )
+        {
+            m_aoFilters.emplace_back(nFilterId, 0);
+        }
+        else if( nFilterId == H5Z_FILTER_SHUFFLE )
+        {
+            m_aoFilters.emplace_back(nFilterId,
+                nCdValues >= 1 && anCdValues[0] > 0 ?
+                    static_cast<size_t>(anCdValues[0]) : m_dt.GetSize());
+        }
+        else
+        {
+            bOK = false;
+        }
+    }
+    H5Pclose(hPlist);
+    if( !bOK )
+    {
+        m_aoFilters.clear();
+        return;
+    }
+
+    std::vector<GUInt64> anArraySize;
+    std::vector<GUInt64> anChunkSize;
+    size_t nChunkBytes = m_dt.GetSize();
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        anArraySize.push_back(m_dims[i]->GetSize());
+        anChunkSize.push_back(anChunkDims[i]);
+        // Overflows are checked by GDALMDArrayChunkReader
+        nChunkBytes *= static_cast<size_t>(anChunkDims[i]);
+    }
+
+    GDALMDArrayChunkReader::DecodeFunc decodeFunc;
+    if( !m_aoFilters.empty() )
+    {
+        decodeFunc = [this, nChunkBytes](const std::vector<GUInt64>&,
+                                         const std::vector<GByte>& abyRaw,
+                                         std::vector<GByte>& abyDecoded)
+        {
+            return DecodeChunk(abyRaw, abyDecoded, nChunkBytes);
+        };
+    }
+    m_poChunkReader.reset(new GDALMDArrayChunkReader(
+        m_poShared->GetChunkCacheKeyPrefix() + GetFullName() + ':',
+        anArraySize, anChunkSize, m_dt,
+        [this, anChunkSize](const std::vector<GUInt64>& anChunkIdx,
+                            std::vector<GByte>& abyRaw)
+        {
+            return FetchChunk(anChunkIdx, anChunkSize, abyRaw);
+        },
+        decodeFunc));
+}
+
+/************************************************************************/
+/*                             FetchChunk()                             */
+/************************************************************************/
+
+bool HDF5Array::FetchChunk(const std::vector<GUInt64>& anChunkIdx,
+                           const std::vector<GUInt64>& anChunkSize,
+                           std::vector<GByte>& abyRaw) const
+{
+    const size_t nDims = m_dims.size();
+    std::vector<hsize_t> anOffset(nDims);
+    for( size_t i = 0; i < nDims; ++i )
+        anOffset[i] = static_cast<hsize_t>(anChunkIdx[i] * anChunkSize[i]);
+
+    // Unallocated chunks (that should be filled with the fill value) are
+    // left to the generic code path.
+    hsize_t nStorageSize = 0;
+    herr_t ret = -1;
+    H5E_BEGIN_TRY {
+        ret = H5Dget_chunk_storage_size(m_hArray, anOffset.data(),
+                                        &nStorageSize);
+    } H5E_END_TRY;
+    if( ret < 0 || nStorageSize == 0 ||
+        nStorageSize > std::numeric_limits<size_t>::max() - sizeof(uint32_t) )
+    {
+        return false;
+    }
+
+    // The filter mask of the chunk is stored at the beginning of the buffer
+    try
+    {
+        abyRaw.resize(sizeof(uint32_t) + static_cast<size_t>(nStorageSize));
+    }
+    catch( const std::exception& )
+    {
+        return false;
+    }
+    uint32_t nFilterMask = 0;
+    H5E_BEGIN_TRY {
+        ret = H5Dread_chunk(m_hArray, H5P_DEFAULT, anOffset.data(),
+                            &nFilterMask, abyRaw.data() + sizeof(uint32_t));
+    } H5E_END_TRY;
+    if( ret < 0 )
+        return false;
+    memcpy(abyRaw.data(), &nFilterMask, sizeof(uint32_t));
+
+    if( m_aoFilters.empty() )
+    {
+        // Uncompressed chunk: directly usable as a decoded chunk
+        abyRaw.erase(abyRaw.begin(), abyRaw.begin() + sizeof(uint32_t));
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            DecodeChunk()                             */
+/************************************************************************/
+
+// Undo the filter pipeline, in reverse order. This does not call the
+// HDF5 library, and is thus safe to run from worker threads.
+bool HDF5Array::DecodeChunk(const std::vector<GByte>& abyRaw,
+                            std::vector<GByte>& abyDecoded,
+                            size_t nChunkBytes) const
+{
+    if( abyRaw.size() < sizeof(uint32_t) )
+        return false;
+    uint32_t nFilterMask = 0;
+    memcpy(&nFilterMask, abyRaw.data(), sizeof(uint32_t));
+
+    std::vector<GByte> abyTmp;
+    const GByte* pabySrc = abyRaw.data() + sizeof(uint32_t);
+    size_t nSrcSize = abyRaw.size() - sizeof(uint32_t);
+    try
+    {
+        abyDecoded.resize(nChunkBytes);
+        if( m_aoFilters.size() > 1 )
+            abyTmp.resize(nChunkBytes);
+    }
+    catch( const std::exception& )
+    {
+        return false;
+    }
+
+    // Alternate between the two output buffers, so that the last filter
+    // writes into abyDecoded.
+    size_t nRemainingFilters = 0;
+    for( size_t i = 0; i < m_aoFilters.size(); ++i )
+    {
+        if( !(nFilterMask & (1U << i)) )
+            nRemainingFilters++;
+    }
+    for( size_t i = m_aoFilters.size(); i > 0; )
+    {
+        --i;
+        if( nFilterMask & (1U << i) )
+            continue;
+        --nRemainingFilters;
+        GByte* pabyDst = ((nRemainingFilters % 2) == 0) ? abyDecoded.data() :
+                                                          abyTmp.data();
+        if( m_aoFilters[i].first == H5Z_FILTER_DEFLATE )
+        {
+            size_t nOutBytes = 0;
+            if( CPLZLibInflate(pabySrc, nSrcSize, pabyDst, nChunkBytes,
+                               &nOutBytes) == nullptr ||
+                nOutBytes != nChunkBytes )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            CPLAssert(m_aoFilters[i].first == H5Z_FILTER_SHUFFLE);
+            if( nSrcSize != nChunkBytes )
+                return false;
+            const size_t nEltSize = m_aoFilters[i].second;
+            const size_t nElts = nChunkBytes / nEltSize;
+            for( size_t j = 0; j < nEltSize; ++j )
+            {
+                const GByte* pabySrcPlane = pabySrc + j * nElts;
+                for( size_t k = 0; k < nElts; ++k )
+                    pabyDst[k * nEltSize + j] = pabySrcPlane[k];
+            }
+            // Trailing bytes are not shuffled
+            const size_t nShuffled = nElts * nEltSize;
+            memcpy(pabyDst + nShuffled, pabySrc + nShuffled,
+                   nChunkBytes - nShuffled);
+        }
+        pabySrc = pabyDst;
+        nSrcSize = nChunkBytes;
+    }
+
+    if( pabySrc != abyDecoded.data() )
+    {
+        // All filters were skipped
+        if( nSrcSize != nChunkBytes )
+            return false;
+        memcpy(abyDecoded.data(), pabySrc, nChunkBytes);
+    }
+    return true;
+}
+
+#endif // HDF5_HAS_READ_CHUNK
+
 /************************************************************************/
 /*                               IRead()                                */
 /************************************************************************/
@@ -1630,6 +1897,15 @@ bool HDF5Array::IRead(const GUInt64* arrayStartIdx,
                                const GDALExtendedDataType& bufferDataType,
                                void* pDstBuffer) const
 {
+#ifdef HDF5_HAS_READ_CHUNK
+    if( m_poChunkReader && m_poChunkReader->IsUsable() &&
+        m_poChunkReader->Read(arrayStartIdx, count, arrayStep, bufferStride,
+                              bufferDataType, pDstBuffer) )
+    {
+        return true;
+    }
+#endif
+
     const size_t nDims(m_dims.size());
     std::vector<H5OFFSET_TYPE> anOffset(nDims);
     std::vector<hsize_t> anCount(nDims);
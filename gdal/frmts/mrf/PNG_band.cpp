@@ -323,17 +323,31 @@ CPLErr PNG_Band::Decompress(buf_mgr &dst, buf_mgr &src)
 
 CPLErr PNG_Band::Compress(buf_mgr &dst, buf_mgr &src)
 {
-    if (!codec.PNGColors && img.comp == IL_PPNG) { // Late set PNG palette to conserve memory
-        GDALColorTable *poCT = GetColorTable();
-        if (!poCT) {
-            CPLError(CE_Failure, CPLE_NotSupported, "MRF PPNG needs a color table");
-            return CE_Failure;
+    if (img.comp == IL_PPNG) { // Late set PNG palette to conserve memory
+        // Pages can be compressed by multiple threads
+        std::lock_guard<std::mutex> lock(paletteMutex);
+        if (!codec.PNGColors) {
+            GDALColorTable *poCT = GetColorTable();
+            if (!poCT) {
+                CPLError(CE_Failure, CPLE_NotSupported, "MRF PPNG needs a color table");
+                return CE_Failure;
+            }
+            ResetPalette(poCT, codec);
         }
-        ResetPalette(poCT, codec);
     }
 
-    codec.deflate_flags = deflate_flags;
-    return codec.CompressPNG(dst, src);
+    // Use a local codec, the band one is shared by the threads
+    // The palette doesn't change once set, it is still owned by the band codec
+    PNG_Codec lcodec(img);
+    lcodec.PNGColors = codec.PNGColors;
+    lcodec.PNGAlpha = codec.PNGAlpha;
+    lcodec.PalSize = codec.PalSize;
+    lcodec.TransSize = codec.TransSize;
+    lcodec.deflate_flags = deflate_flags;
+    CPLErr ret = lcodec.CompressPNG(dst, src);
+    lcodec.PNGColors = nullptr;
+    lcodec.PNGAlpha = nullptr;
+    return ret;
 }
 
 /**
@@ -42,10 +42,12 @@
 */
 
 #include "marfa.h"
+#include <atomic>
+
 NAMESPACE_MRF_START
 
 // Returns a string in /vsimem/ + prefix + count that doesn't exist when this function gets called
-// It is not thread safe, open the result as soon as possible
+// Open the result as soon as possible
 static CPLString uniq_memfname(const char* prefix) {
     // Define MRF_LOCAL_TMP to use local files instead of RAM
     // #define MRF_LOCAL_TMP
@@ -54,7 +56,8 @@ static CPLString uniq_memfname(const char* prefix) {
 #else
     CPLString fname;
     VSIStatBufL statb;
-    static unsigned int cnt = 0;
+    // Compression can run in multiple threads
+    static std::atomic<unsigned int> cnt(0);
     do {
         fname.Printf("/vsimem/%s_%08x", prefix, cnt++);
     } while (!VSIStatL(fname, &statb));
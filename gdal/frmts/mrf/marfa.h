@@ -51,8 +51,12 @@
 #include <gdal_pam.h>
 #include <ogr_srs_api.h>
 #include <ogr_spatialref.h>
+#include <cpl_worker_thread_pool.h>
 
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
 // For printing values
 #include <ostream>
 #include <iostream>
@@ -296,6 +300,18 @@ typedef struct {
 // Offset of index, pos is in pages
 GIntBig IdxOffset(const ILSize &pos, const ILImage &img);
 
+// A page being compressed in a worker thread
+// The buffer holds the raw page, followed by pbsize bytes for the compressed output
+typedef struct {
+    MRFRasterBand *band;
+    GUIntBig infooffset;
+    char *buffer;
+    buf_mgr dst;     // Compressed page, points inside of buffer when done
+    bool swab;       // Swap bytes before compressing
+    bool ready;      // Set by the worker thread
+    CPLErr ret;
+} MRFCompressionJob;
+
 enum { SAMPLING_ERR, SAMPLING_Avg, SAMPLING_Near };
 
 MRFRasterBand *newMRFRasterBand(MRFDataset *, const ILImage &, int, int level = 0);
@@ -363,6 +379,8 @@ public:
     void SetPBufferSize(unsigned int sz) { pbsize = sz; }
     unsigned int GetPBufferSize() { return pbsize; }
 
+    virtual void FlushCache() override;
+
 protected:
     // False if it failed
     int Crystalize();
@@ -413,6 +431,18 @@ protected:
     // Write a tile, the infooffset is the relative position in the index file
     virtual CPLErr WriteTile(void *buff, GUIntBig infooffset, GUIntBig size = 0);
 
+    // Set up the compression worker threads, from the NUM_THREADS option
+    void InitCompressionThreads(char **papszOptions);
+
+    // Queue a page for compression, the job takes ownership of the buffer
+    CPLErr SubmitCompressionJob(MRFRasterBand *band, GUIntBig infooffset, char *buffer, bool swab);
+
+    // Write the oldest pending compressed page
+    CPLErr WaitCompletionForJobIdx(int i);
+
+    // Write all the pending compressed pages, in submission order
+    CPLErr WaitCompletionForAllJobs();
+
     // Custom CopyWholeRaster for Zen JPEG
     CPLErr ZenCopy(GDALDataset *poSrc, GDALProgressFunc pfnProgress, void * pProgressData);
 
@@ -503,6 +533,13 @@ protected:
     VF dfp;  // Data file handle
     VF ifp;  // Index file handle
 
+    // Multi-threaded compression support, only used when writing
+    std::unique_ptr<CPLJobQueue> poCompressQueue;
+    std::vector<MRFCompressionJob> compressJobs;
+    std::queue<int> compressJobsQueue; // Indices of pending jobs, in submission order
+    std::mutex compressMutex;
+    bool writingJob; // Set while the result of a job is written
+
     // statistical values
     std::vector<double> vNoData, vMin, vMax;
 };
@@ -542,6 +579,9 @@ public:
     // Same, for interleaved bands, current band goes in buffer
     CPLErr FillBlock(int xblk, int yblk, void *buffer);
 
+    // Compress a page in a worker thread, the argument is a MRFCompressionJob
+    static void CompressionThreadFunc(void *data);
+
     // de-interlace a buffer in pixel blocks
     CPLErr ReadInterleavedBlock(int xblk, int yblk, void *buffer);
 
@@ -635,6 +675,7 @@ protected:
     virtual CPLErr Compress(buf_mgr &dst, buf_mgr &src) override;
 
     PNG_Codec codec;
+    std::mutex paletteMutex; // Protects the lazy palette setup in codec
 };
 
 /*
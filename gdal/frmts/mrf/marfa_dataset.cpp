@@ -51,6 +51,7 @@
 #include "marfa.h"
 #include "cpl_multiproc.h" /* for CPLSleep() */
 #include <gdal_priv.h>
+#include "gdal_thread_pool.h"
 #include <assert.h>
 
 #include <algorithm>
@@ -85,7 +86,8 @@ MRFDataset::MRFDataset() :
     bdirty(0),
     bGeoTransformValid(TRUE),
     poColorTable(nullptr),
-    Quality(0)
+    Quality(0),
+    writingJob(false)
 {
     //                X0   Xx   Xy  Y0    Yx   Yy
     double gt[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
@@ -143,6 +145,10 @@ MRFDataset::~MRFDataset() {   // Make sure everything gets written
     MRFDataset::FlushCache();
     MRFDataset::CloseDependentDatasets();
 
+    // Should be empty at this point, unless writing failed
+    for (auto &job : compressJobs)
+        CPLFree(job.buffer);
+
     if (ifp.FP)
         VSIFCloseL(ifp.FP);
     if (dfp.FP)
@@ -155,6 +161,15 @@ MRFDataset::~MRFDataset() {   // Make sure everything gets written
     pbsize = 0;
 }
 
+//
+// Writes the dirty blocks, then waits for the pages being compressed
+//
+void MRFDataset::FlushCache()
+{
+    GDALPamDataset::FlushCache();
+    WaitCompletionForAllJobs();
+}
+
 /*
  *\brief Format specific RasterIO, may be bypassed by BlockBasedRasterIO by setting
  * GDAL_FORCE_CACHING to Yes, in which case the band ReadBlock and WriteBLock are called
@@ -587,6 +602,9 @@ GDALDataset* MRFDataset::Open(GDALOpenInfo* poOpenInfo)
         return nullptr;
     }
 
+    if (ds->eAccess == GA_Update)
+        ds->InitCompressionThreads(poOpenInfo->papszOpenOptions);
+
     // Tell PAM what our real file name is, to help it find the aux.xml
     ds->SetPhysicalFilename(pszFileName);
     // Don't mess with metadata after this, otherwise PAM will re-write the aux.xml
@@ -1953,6 +1971,8 @@ MRFDataset::Create(const char* pszName,
         return nullptr;
     }
 
+    poDS->InitCompressionThreads(papszOptions);
+
     // Tell PAM what our real file name is, to help it find the aux.xml
     poDS->SetPhysicalFilename(poDS->GetFname());
     return poDS;
@@ -1996,6 +2016,134 @@ CPLErr MRFDataset::AddVersion() {
     return CE_None;
 }
 
+//
+// Compression is done by worker threads when NUM_THREADS is set, as a creation or
+// open option.
+// The compressed pages are written by the main thread, in the order they were
+// submitted, so the data file and index updates are the same as when using a
+// single thread
+//
+void MRFDataset::InitCompressionThreads(char** papszOptions)
+{
+    const char* pszValue = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if (pszValue == nullptr)
+        return;
+
+    int nThreads = EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+    if (nThreads > 1024)
+        nThreads = 1024;
+    if (nThreads < 0 || (nThreads < 2 && !EQUAL(pszValue, "0") &&
+        !EQUAL(pszValue, "1") && !EQUAL(pszValue, "ALL_CPUS")))
+    {
+        CPLError(CE_Warning, CPLE_AppDefined, "MRF: Invalid value for NUM_THREADS: %s", pszValue);
+        return;
+    }
+    if (nThreads < 2)
+        return;
+
+    // A single page doesn't need threads
+    if (current.pagecount.l == 1)
+        return;
+
+    auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if (poThreadPool)
+        poCompressQueue = poThreadPool->CreateJobQueue();
+    if (!poCompressQueue)
+        return;
+
+    CPLDebug("MRF", "Using %d threads for compression", nThreads);
+    // One extra job, so the main thread can do I/O while all the workers are busy
+    compressJobs.resize(nThreads + 1);
+    for (auto &job : compressJobs) {
+        job.band = nullptr;
+        job.infooffset = 0;
+        job.buffer = nullptr;
+        job.dst.buffer = nullptr;
+        job.dst.size = 0;
+        job.swab = false;
+        job.ready = false;
+        job.ret = CE_None;
+    }
+}
+
+// Takes ownership of the buffer, which is pageSizeBytes + pbsize
+CPLErr MRFDataset::SubmitCompressionJob(MRFRasterBand* band, GUIntBig infooffset,
+    char* buffer, bool swab)
+{
+    CPLErr ret = CE_None;
+    int idx = -1;
+    if (compressJobsQueue.size() == compressJobs.size()) {
+        // All busy, write the oldest one
+        idx = compressJobsQueue.front();
+        ret = WaitCompletionForJobIdx(idx);
+    }
+    else {
+        for (int i = 0; i < static_cast<int>(compressJobs.size()); i++) {
+            if (compressJobs[i].buffer == nullptr) {
+                idx = i;
+                break;
+            }
+        }
+    }
+    CPLAssert(idx >= 0);
+
+    MRFCompressionJob& job = compressJobs[idx];
+    job.band = band;
+    job.infooffset = infooffset;
+    job.buffer = buffer;
+    job.dst.buffer = nullptr;
+    job.dst.size = 0;
+    job.swab = swab;
+    job.ready = false;
+    job.ret = CE_None;
+    compressJobsQueue.push(idx);
+    poCompressQueue->SubmitJob(MRFRasterBand::CompressionThreadFunc, &job);
+    return ret;
+}
+
+CPLErr MRFDataset::WaitCompletionForJobIdx(int i)
+{
+    CPLAssert(!compressJobsQueue.empty() && compressJobsQueue.front() == i);
+    MRFCompressionJob& job = compressJobs[i];
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(compressMutex);
+            if (job.ready)
+                break;
+        }
+        poCompressQueue->GetPool()->WaitEvent();
+    }
+    compressJobsQueue.pop();
+
+    // A page which failed to compress has a null output. Like with a single thread,
+    // it gets written as an empty tile for interleaved pages, skipped otherwise
+    CPLErr ret = job.ret;
+    if (CE_None == ret || job.band->img.pagesize.c != 1) {
+        writingJob = true;
+        ret = WriteTile(job.dst.buffer, job.infooffset, job.dst.size);
+        writingJob = false;
+        if (CE_None != job.ret)
+            ret = job.ret;
+    }
+
+    CPLFree(job.buffer);
+    job.buffer = nullptr;
+    job.band = nullptr;
+    job.ready = false;
+    return ret;
+}
+
+CPLErr MRFDataset::WaitCompletionForAllJobs()
+{
+    CPLErr ret = CE_None;
+    while (!compressJobsQueue.empty()) {
+        CPLErr err = WaitCompletionForJobIdx(compressJobsQueue.front());
+        if (CE_None == ret)
+            ret = err;
+    }
+    return ret;
+}
+
 //
 // Write a tile at the end of the data file
 // If buff and size are zero, it is equivalent to erasing the tile
@@ -2010,6 +2158,10 @@ CPLErr MRFDataset::WriteTile(void* buff, GUIntBig infooffset, GUIntBig size)
     CPLErr ret = CE_None;
     ILIdx tinfo = { 0, 0 };
 
+    // Pending pages have to be written first, to preserve the order of updates
+    if (!writingJob && !compressJobsQueue.empty())
+        ret = WaitCompletionForAllJobs();
+
     VSILFILE* l_dfp = DataFP();
     VSILFILE* l_ifp = IdxFP();
 
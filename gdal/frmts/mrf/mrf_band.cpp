@@ -652,6 +652,9 @@ CPLErr MRFRasterBand::IReadBlock(int xblk, int yblk, void *buffer) {
     if (poDS->bypass_cache && !poDS->source.empty())
         return FetchBlock(xblk, yblk, buffer);
 
+    // Pages still being compressed are not in the index yet
+    poDS->WaitCompletionForAllJobs();
+
     tinfo.size = 0; // Just in case it is missing
     if (CE_None != poDS->ReadTileIdx(tinfo, req, img)) {
         if (!poDS->no_errors) {
@@ -785,6 +788,59 @@ CPLErr MRFRasterBand::IReadBlock(int xblk, int yblk, void *buffer) {
     return ReadInterleavedBlock(xblk, yblk, buffer);
 }
 
+/**
+*\brief Compress a page in a worker thread
+*
+* The job buffer holds the raw page followed by pbsize bytes for the compressed output.
+* On return, job.dst has the compressed page, or a null buffer if the page should be written
+* as an empty tile.  The page is written to disk later, by the main thread
+*
+*/
+
+void MRFRasterBand::CompressionThreadFunc(void *data)
+{
+    MRFCompressionJob *job = static_cast<MRFCompressionJob *>(data);
+    MRFRasterBand *band = job->band;
+    MRFDataset *poDS = band->poDS;
+    const ILImage &img = band->img;
+
+    buf_mgr src = {job->buffer, static_cast<size_t>(img.pageSizeBytes)};
+    if (job->swab)
+        swab_buff(src, img);
+
+    char *outbuff = job->buffer + img.pageSizeBytes;
+    buf_mgr dst = {outbuff, poDS->pbsize};
+    CPLErr ret = band->Compress(dst, src);
+    void *usebuff = outbuff;
+    if (ret != CE_None) {
+        // Write it as an empty tile
+        usebuff = nullptr;
+        dst.size = 0;
+        // Same as the single threaded write, the error is only ignored for
+        // interleaved pages, because it triggers partial band attempts
+        if (img.pagesize.c != 1)
+            ret = CE_None;
+    }
+    else if (band->dodeflate) {
+        // Move the packed part at the start of the buffer, to make more space available
+        memmove(job->buffer, outbuff, dst.size);
+        dst.buffer = job->buffer;
+        usebuff = DeflateBlock(dst, img.pageSizeBytes + poDS->pbsize - dst.size,
+            band->deflate_flags);
+        if (!usebuff) {
+            CPLError(CE_Failure, CPLE_AppDefined, "MRF: Deflate error");
+            dst.size = 0;
+            ret = CE_Failure;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(poDS->compressMutex);
+    job->dst.buffer = static_cast<char *>(usebuff);
+    job->dst.size = dst.size;
+    job->ret = ret;
+    job->ready = true;
+}
+
 /**
 *\brief Write a block from the provided buffer
 *
@@ -821,6 +877,18 @@ CPLErr MRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
         // Use the pbuffer to hold the compressed page before writing it
         poDS->tile = ILSize(); // Mark it corrupt
 
+        // Compress a copy of the page in a worker thread
+        if (poDS->poCompressQueue) {
+            char *tbuffer = static_cast<char *>(VSIMalloc(img.pageSizeBytes + poDS->pbsize));
+            if (!tbuffer) {
+                CPLError(CE_Failure, CPLE_AppDefined, "MRF: Can't allocate write buffer");
+                return CE_Failure;
+            }
+            memcpy(tbuffer, buffer, img.pageSizeBytes);
+            return poDS->SubmitCompressionJob(this, infooffset, tbuffer,
+                is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER));
+        }
+
         buf_mgr src;
         src.buffer = (char *)buffer;
         src.size = static_cast<size_t>(img.pageSizeBytes);
@@ -832,7 +900,8 @@ CPLErr MRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
 
         // Compress functions need to return the compressed size in
         // the bytes in buffer field
-        Compress(dst, src);
+        if (CE_None != Compress(dst, src))
+            return CE_Failure;
         void *usebuff = dst.buffer;
         if (dodeflate) {
             usebuff = DeflateBlock(dst, poDS->pbsize - dst.size, deflate_flags);
@@ -932,6 +1001,12 @@ CPLErr MRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
         CPLError(CE_Warning, CPLE_AppDefined, "MRF: IWrite, band dirty mask is " CPL_FRMT_GIB
             " instead of " CPL_FRMT_GIB, poDS->bdirty, AllBandMask());
 
+    // The worker thread takes ownership of tbuffer
+    if (poDS->poCompressQueue) {
+        poDS->bdirty = 0;
+        return poDS->SubmitCompressionJob(this, infooffset, static_cast<char *>(tbuffer), false);
+    }
+
     buf_mgr src;
     src.buffer = (char *)tbuffer;
     src.size = static_cast<size_t>(img.pageSizeBytes);
@@ -990,7 +1065,8 @@ bool MRFRasterBand::TestBlock(int xblk, int yblk)
     ILIdx tinfo;
     GInt32 cstride = img.pagesize.c;
     ILSize req(xblk, yblk, 0, (nBand - 1) / cstride, m_l);
-    
+
+    poDS->WaitCompletionForAllJobs();
     if (CE_None != poDS->ReadTileIdx(tinfo, req, img))
         // Got an error reading the tile index
         return !poDS->no_errors;
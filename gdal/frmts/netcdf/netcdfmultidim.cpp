@@ -30,6 +30,7 @@
 #include <map>
 
 #include "netcdfdataset.h"
+#include "gdalmdarraychunkreader.h"
 
 #ifdef NETCDF_HAS_NC4
 
@@ -54,6 +55,7 @@ class netCDFSharedResources
     bool m_bDefineMode = false;
     std::map<int, int> m_oMapDimIdToGroupId{};
     bool m_bIsInIndexingVariable = false;
+    std::string m_osChunkCacheKeyPrefix = GDALMDArrayChunkReader::GetNewKeyPrefix();
 
 public:
     netCDFSharedResources();
@@ -67,6 +69,8 @@ public:
 
     void SetIsInGetIndexingVariable(bool b) { m_bIsInIndexingVariable = b; }
     bool GetIsInIndexingVariable() const { return m_bIsInIndexingVariable; }
+
+    const std::string& GetChunkCacheKeyPrefix() const { return m_osChunkCacheKeyPrefix; }
 };
 
 /************************************************************************/
@@ -342,6 +346,8 @@ class netCDFVariable final: public GDALMDArray
     mutable std::vector<GUInt64> m_cachedArrayStartIdx{};
     mutable std::vector<size_t> m_cachedCount{};
     mutable std::shared_ptr<GDALMDArray> m_poCachedArray{};
+    mutable bool m_bChunkReaderInitialized = false;
+    mutable std::unique_ptr<GDALMDArrayChunkReader> m_poChunkReader{};
 
     void ConvertNCToGDAL(GByte*) const;
     void ConvertGDALToNC(GByte*) const;
@@ -356,6 +362,12 @@ class netCDFVariable final: public GDALMDArray
                          const size_t* array_idx,
                          const void* pSrcBuffer) const;
 
+    std::string GetChunkCacheKeyPrefix() const;
+    GDALMDArrayChunkReader* GetChunkReader() const;
+    bool FetchChunk(const std::vector<GUInt64>& anChunkIdx,
+                    const std::vector<GUInt64>& anChunkSize,
+                    std::vector<GByte>& abyRaw) const;
+
     template< typename BufferType,
               typename NCGetPutVar1FuncType,
               typename ReadOrWriteOneElementType >
@@ -481,6 +493,8 @@ public:
 
 netCDFSharedResources::~netCDFSharedResources()
 {
+    GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
+
     CPLMutexHolderD(&hNCMutex);
 
     if( m_cdfid > 0 )
@@ -2665,6 +2679,139 @@ bool netCDFVariable::ReadOneElement(const GDALExtendedDataType& src_datatype,
     return true;
 }
 
+/************************************************************************/
+/*                       GetChunkCacheKeyPrefix()                       */
+/************************************************************************/
+
+std::string netCDFVariable::GetChunkCacheKeyPrefix() const
+{
+    return m_poShared->GetChunkCacheKeyPrefix() +
+           CPLSPrintf("%d/%d/", m_gid, m_varid);
+}
+
+/************************************************************************/
+/*                            FetchChunk()                              */
+/************************************************************************/
+
+bool netCDFVariable::FetchChunk(const std::vector<GUInt64>& anChunkIdx,
+                                const std::vector<GUInt64>& anChunkSize,
+                                std::vector<GByte>& abyRaw) const
+{
+    const auto& dims = GetDimensions();
+    const size_t nDTSize = GetDataType().GetSize();
+    std::vector<size_t> startp(m_nDims);
+    std::vector<size_t> countp(m_nDims);
+    size_t nChunkElts = 1;
+    bool bFullChunk = true;
+    for( int i = 0; i < m_nDims; i++ )
+    {
+        startp[i] = static_cast<size_t>(anChunkIdx[i] * anChunkSize[i]);
+        countp[i] = static_cast<size_t>(std::min(anChunkSize[i],
+                                        dims[i]->GetSize() - startp[i]));
+        if( countp[i] != anChunkSize[i] )
+            bFullChunk = false;
+        nChunkElts *= static_cast<size_t>(anChunkSize[i]);
+    }
+
+    try
+    {
+        abyRaw.resize(nChunkElts * nDTSize);
+    }
+    catch( const std::exception& )
+    {
+        return false;
+    }
+
+    // Chunks at the right/bottom edges are partial: read the valid part
+    // and lay it out as a full chunk.
+    std::vector<GByte> abyPartial;
+    if( !bFullChunk )
+    {
+        size_t nElts = 1;
+        for( int i = 0; i < m_nDims; i++ )
+            nElts *= countp[i];
+        abyPartial.resize(nElts * nDTSize);
+    }
+
+    {
+        CPLMutexHolderD(&hNCMutex);
+        m_poShared->SetDefineMode(false);
+        int ret = nc_get_vara(m_gid, m_varid, startp.data(), countp.data(),
+                              bFullChunk ? abyRaw.data() : abyPartial.data());
+        NCDF_ERR(ret);
+        if( ret != NC_NOERR )
+            return false;
+    }
+
+    if( !bFullChunk )
+    {
+        const int iLast = m_nDims - 1;
+        const size_t nLineBytes = countp[iLast] * nDTSize;
+        std::vector<size_t> anIdx(m_nDims);
+        const GByte* pabySrc = abyPartial.data();
+        while( true )
+        {
+            size_t nDstOffset = 0;
+            for( int i = 0; i < m_nDims; i++ )
+                nDstOffset = nDstOffset * static_cast<size_t>(anChunkSize[i]) + anIdx[i];
+            memcpy(&abyRaw[nDstOffset * nDTSize], pabySrc, nLineBytes);
+            pabySrc += nLineBytes;
+
+            int i = iLast;
+            while( i > 0 )
+            {
+                --i;
+                if( ++anIdx[i] < countp[i] )
+                    break;
+                anIdx[i] = 0;
+                if( i == 0 )
+                    return true;
+            }
+            if( iLast == 0 )
+                return true;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           GetChunkReader()                           */
+/************************************************************************/
+
+GDALMDArrayChunkReader* netCDFVariable::GetChunkReader() const
+{
+    CPLMutexHolderD(&hNCMutex);
+    if( m_bChunkReaderInitialized )
+        return m_poChunkReader.get();
+    m_bChunkReaderInitialized = true;
+
+    // netCDF decodes chunks itself, and is not thread-safe, so the benefit
+    // of the chunk reader is limited to the process-wide cache.
+    if( m_nDims == 0 || GDALMDArrayChunkReader::GetCacheMaxSize() == 0 )
+        return nullptr;
+    const auto& eDT = GetDataType();
+    if( eDT.GetClass() != GEDTC_NUMERIC || !m_bPerfectDataTypeMatch )
+        return nullptr;
+    const auto anChunkSize = GetBlockSize();
+    if( anChunkSize.empty() || anChunkSize[0] == 0 )
+        return nullptr;
+
+    std::vector<GUInt64> anArraySize;
+    for( const auto& dim: GetDimensions() )
+        anArraySize.push_back(dim->GetSize());
+
+    m_poChunkReader.reset(new GDALMDArrayChunkReader(
+        GetChunkCacheKeyPrefix(), anArraySize, anChunkSize, eDT,
+        [this, anChunkSize](const std::vector<GUInt64>& anChunkIdx,
+                            std::vector<GByte>& abyRaw)
+        {
+            return FetchChunk(anChunkIdx, anChunkSize, abyRaw);
+        }));
+    if( !m_poChunkReader->IsUsable() )
+        m_poChunkReader.reset();
+    return m_poChunkReader.get();
+}
+
 /************************************************************************/
 /*                                   IRead()                            */
 /************************************************************************/
@@ -2732,6 +2879,14 @@ bool netCDFVariable::IRead(const GUInt64* arrayStartIdx,
         }
     }
 
+    auto poChunkReader = GetChunkReader();
+    if( poChunkReader &&
+        poChunkReader->Read(arrayStartIdx, count, arrayStep, bufferStride,
+                            bufferDataType, pDstBuffer) )
+    {
+        return true;
+    }
+
     return IReadWrite
                 (true,
                  arrayStartIdx, count, arrayStep, bufferStride,
@@ -2876,6 +3031,14 @@ bool netCDFVariable::IWrite(const GUInt64* arrayStartIdx,
 
     m_poCachedArray.reset();
 
+    {
+        // Unlimited dimensions might grow, and cached chunks be modified
+        CPLMutexHolderD(&hNCMutex);
+        m_bChunkReaderInitialized = false;
+        m_poChunkReader.reset();
+        GDALMDArrayChunkReader::InvalidateCache(GetChunkCacheKeyPrefix());
+    }
+
     if( m_nDims == 2 && m_nVarType == NC_CHAR && GetDimensions().size() == 1 )
     {
         CPLMutexHolderD(&hNCMutex);
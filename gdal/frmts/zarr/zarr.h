@@ -0,0 +1,340 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zarr driver
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef ZARR_H
+#define ZARR_H
+
+#include "cpl_compressor.h"
+#include "cpl_json.h"
+#include "gdal_priv.h"
+#include "gdalmdarraychunkreader.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+/************************************************************************/
+/*                            ZarrDataset                               */
+/************************************************************************/
+
+class ZarrDataset final: public GDALDataset
+{
+    std::shared_ptr<GDALGroup> m_poRootGroup{};
+    CPLStringList m_aosSubdatasets{};
+
+public:
+    explicit ZarrDataset(const std::shared_ptr<GDALGroup>& poRootGroup);
+    ~ZarrDataset() override;
+
+    static int Identify(GDALOpenInfo* poOpenInfo);
+    static GDALDataset* Open(GDALOpenInfo* poOpenInfo);
+    static GDALDataset* CreateMultiDimensional(const char * pszFilename,
+                                               CSLConstList papszRootGroupOptions,
+                                               CSLConstList papszOptions);
+
+    char** GetMetadata(const char* pszDomain) override;
+
+    std::shared_ptr<GDALGroup> GetRootGroup() const override { return m_poRootGroup; }
+};
+
+bool ZarrWriteJSON(const std::string& osFilename, const CPLJSONObject& oObj);
+
+/************************************************************************/
+/*                          ZarrSharedResource                          */
+/************************************************************************/
+
+class ZarrSharedResource
+{
+    std::string m_osRootDirectoryName;
+    bool m_bUpdatable;
+    std::string m_osChunkCacheKeyPrefix = GDALMDArrayChunkReader::GetNewKeyPrefix();
+    // Content of .zmetadata (consolidated metadata), indexed by the path of
+    // the metadata files relative to the root directory
+    std::map<std::string, CPLJSONObject> m_oMapConsolidated{};
+    bool m_bHasConsolidated = false;
+
+    ZarrSharedResource(const ZarrSharedResource&) = delete;
+    ZarrSharedResource& operator=(const ZarrSharedResource&) = delete;
+
+public:
+    ZarrSharedResource(const std::string& osRootDirectoryName, bool bUpdatable);
+    ~ZarrSharedResource();
+
+    const std::string& GetRootDirectoryName() const { return m_osRootDirectoryName; }
+    bool IsUpdatable() const { return m_bUpdatable; }
+    const std::string& GetChunkCacheKeyPrefix() const { return m_osChunkCacheKeyPrefix; }
+
+    bool HasConsolidatedMetadata() const { return m_bHasConsolidated; }
+    const std::map<std::string, CPLJSONObject>& GetConsolidatedMetadata() const { return m_oMapConsolidated; }
+    bool LoadJSON(const std::string& osDirectoryName,
+                  const char* pszFilename,
+                  CPLJSONObject& oObj) const;
+};
+
+/************************************************************************/
+/*                          ZarrAttributeGroup                          */
+/************************************************************************/
+
+// Stores the attributes of a group or array (.zattrs), in a MEM group.
+class ZarrAttributeGroup
+{
+    std::shared_ptr<GDALGroup> m_poGroup{};
+    bool m_bModified = false;
+
+public:
+    ZarrAttributeGroup();
+
+    void Init(const CPLJSONObject& obj);
+    CPLJSONObject Serialize() const;
+
+    std::shared_ptr<GDALAttribute> GetAttribute(const std::string& osName) const;
+    std::vector<std::shared_ptr<GDALAttribute>> GetAttributes(CSLConstList papszOptions = nullptr) const;
+    std::shared_ptr<GDALAttribute> CreateAttribute(const std::string& osName,
+                                                   const std::vector<GUInt64>& anDimensions,
+                                                   const GDALExtendedDataType& oDataType,
+                                                   CSLConstList papszOptions = nullptr);
+
+    bool IsModified() const { return m_bModified; }
+    void SetModified(bool b) { m_bModified = b; }
+};
+
+class ZarrArray;
+
+/************************************************************************/
+/*                             ZarrGroup                                */
+/************************************************************************/
+
+class ZarrGroup final: public GDALGroup
+{
+    std::shared_ptr<ZarrSharedResource> m_poSharedResource;
+    std::string m_osDirectoryName;
+    ZarrAttributeGroup m_oAttrGroup{};
+    mutable bool m_bDirectoryExplored = false;
+    mutable std::vector<std::string> m_aosGroups{};
+    mutable std::vector<std::string> m_aosArrays{};
+    mutable std::map<std::string, std::shared_ptr<ZarrGroup>> m_oMapGroups{};
+    mutable std::map<std::string, std::shared_ptr<ZarrArray>> m_oMapMDArrays{};
+    mutable std::map<std::string, std::shared_ptr<GDALDimension>> m_oMapDimensions{};
+    mutable std::set<std::string> m_oSetArraysInLoading{};
+
+    void ExploreDirectory() const;
+    std::shared_ptr<ZarrArray> LoadArray(const std::string& osName) const;
+
+public:
+    ZarrGroup(const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+              const std::string& osParentName,
+              const std::string& osName,
+              const std::string& osDirectoryName);
+    ~ZarrGroup();
+
+    void Init(const CPLJSONObject& oAttributes);
+    void SetSingleArray(const std::string& osArrayName);
+    void Flush();
+
+    std::shared_ptr<GDALDimension> GetOrCreateDimension(const std::string& osName,
+                                                        GUInt64 nSize) const;
+
+    std::vector<std::string> GetMDArrayNames(CSLConstList papszOptions = nullptr) const override;
+    std::shared_ptr<GDALMDArray> OpenMDArray(const std::string& osName,
+                                             CSLConstList papszOptions = nullptr) const override;
+
+    std::vector<std::string> GetGroupNames(CSLConstList papszOptions = nullptr) const override;
+    std::shared_ptr<GDALGroup> OpenGroup(const std::string& osName,
+                                         CSLConstList papszOptions = nullptr) const override;
+
+    std::vector<std::shared_ptr<GDALDimension>> GetDimensions(CSLConstList papszOptions = nullptr) const override;
+
+    std::shared_ptr<GDALAttribute> GetAttribute(const std::string& osName) const override;
+    std::vector<std::shared_ptr<GDALAttribute>> GetAttributes(CSLConstList papszOptions = nullptr) const override;
+    std::shared_ptr<GDALAttribute> CreateAttribute(const std::string& osName,
+                                                   const std::vector<GUInt64>& anDimensions,
+                                                   const GDALExtendedDataType& oDataType,
+                                                   CSLConstList papszOptions = nullptr) override;
+
+    std::shared_ptr<GDALGroup> CreateGroup(const std::string& osName,
+                                           CSLConstList papszOptions = nullptr) override;
+
+    std::shared_ptr<GDALDimension> CreateDimension(const std::string& osName,
+                                                   const std::string& osType,
+                                                   const std::string& osDirection,
+                                                   GUInt64 nSize,
+                                                   CSLConstList papszOptions = nullptr) override;
+
+    std::shared_ptr<GDALMDArray> CreateMDArray(const std::string& osName,
+                                               const std::vector<std::shared_ptr<GDALDimension>>& aoDimensions,
+                                               const GDALExtendedDataType& oDataType,
+                                               CSLConstList papszOptions = nullptr) override;
+};
+
+/************************************************************************/
+/*                           ZarrDataTypeInfo                           */
+/************************************************************************/
+
+// Description of the "dtype" of an array, and how it maps to a GDAL type.
+struct ZarrDataTypeInfo
+{
+    char chKind = 0;              // 'b', 'i', 'u', 'f' or 'c'
+    size_t nNativeSize = 0;       // size in bytes in the chunks
+    bool bLittleEndian = true;
+    GDALDataType eDT = GDT_Unknown;
+
+    bool NeedsByteSwap() const;
+    bool NeedsConversion() const;
+    std::string ToString() const;
+    static bool Parse(const std::string& osDType, ZarrDataTypeInfo& oInfo);
+    static bool FromGDALDataType(GDALDataType eDT, ZarrDataTypeInfo& oInfo);
+};
+
+/************************************************************************/
+/*                             ZarrArray                                */
+/************************************************************************/
+
+class ZarrArray final: public GDALMDArray
+{
+    std::shared_ptr<ZarrSharedResource> m_poSharedResource;
+    const std::vector<std::shared_ptr<GDALDimension>> m_aoDims;
+    const GDALExtendedDataType m_oType;
+    const ZarrDataTypeInfo m_oDTInfo;
+    const std::vector<GUInt64> m_anBlockSize;
+    std::string m_osDirectoryName;
+    std::string m_osDimSeparator = ".";
+    std::string m_osCompressorId{};
+    CPLJSONObject m_oCompressorJSon{};
+    CPLStringList m_aosCompressorOptions{};
+    const CPLCompressor* m_psCompressor = nullptr;
+    const CPLCompressor* m_psDecompressor = nullptr;
+    size_t m_nShuffleEltSize = 0;
+    std::vector<GByte> m_abyNoData{};
+    ZarrAttributeGroup m_oAttrGroup{};
+    std::string m_osUnit{};
+    bool m_bDefinitionModified = false;
+    std::string m_osChunkCacheKeyPrefix;
+    std::unique_ptr<GDALMDArrayChunkReader> m_poChunkReader{};
+    mutable CPLStringList m_aosStructuralInfo{};
+
+    ZarrArray(const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+              const std::string& osParentName,
+              const std::string& osName,
+              const std::vector<std::shared_ptr<GDALDimension>>& aoDims,
+              const GDALExtendedDataType& oType,
+              const ZarrDataTypeInfo& oDTInfo,
+              const std::vector<GUInt64>& anBlockSize,
+              const std::string& osDirectoryName);
+
+    size_t GetChunkElementCount() const;
+    std::string GetChunkFilename(const std::vector<GUInt64>& anChunkIdx) const;
+    void FillWithNoData(std::vector<GByte>& abyChunk) const;
+    bool ReadChunk(const std::vector<GUInt64>& anChunkIdx,
+                   std::vector<GByte>& abyChunk) const;
+    bool WriteChunk(const std::vector<GUInt64>& anChunkIdx,
+                    const std::vector<GByte>& abyChunk) const;
+    bool DecodeChunk(std::vector<GByte>& abyData,
+                     std::vector<GByte>& abyChunk) const;
+    bool EncodeChunk(const std::vector<GByte>& abyChunk,
+                     std::vector<GByte>& abyData) const;
+    CPLJSONObject SerializeDefinition() const;
+
+    static void WriteChunkJob(void* pData);
+
+    bool IReadChunkByChunk(const GUInt64* arrayStartIdx,
+                           const size_t* count,
+                           const GInt64* arrayStep,
+                           const GPtrDiff_t* bufferStride,
+                           const GDALExtendedDataType& bufferDataType,
+                           void* pDstBuffer) const;
+
+    ZarrArray(const ZarrArray&) = delete;
+    ZarrArray& operator=(const ZarrArray&) = delete;
+
+protected:
+    bool IRead(const GUInt64* arrayStartIdx,
+               const size_t* count,
+               const GInt64* arrayStep,
+               const GPtrDiff_t* bufferStride,
+               const GDALExtendedDataType& bufferDataType,
+               void* pDstBuffer) const override;
+
+    bool IWrite(const GUInt64* arrayStartIdx,
+                const size_t* count,
+                const GInt64* arrayStep,
+                const GPtrDiff_t* bufferStride,
+                const GDALExtendedDataType& bufferDataType,
+                const void* pSrcBuffer) override;
+
+public:
+    ~ZarrArray();
+
+    static std::shared_ptr<ZarrArray> Create(
+                    const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+                    const std::string& osParentName,
+                    const std::string& osName,
+                    const std::vector<std::shared_ptr<GDALDimension>>& aoDims,
+                    const GDALExtendedDataType& oType,
+                    const ZarrDataTypeInfo& oDTInfo,
+                    const std::vector<GUInt64>& anBlockSize,
+                    const std::string& osDirectoryName);
+
+    bool ParseCodecs(const CPLJSONObject& oZarray);
+    bool SetCompressor(const CPLJSONObject& oCompressor);
+    void SetShuffleEltSize(size_t nEltSize) { m_nShuffleEltSize = nEltSize; }
+    void SetDimSeparator(const std::string& osSep) { m_osDimSeparator = osSep; }
+    void InitAttributes(const CPLJSONObject& oAttributes);
+    void SetDefinitionModified() { m_bDefinitionModified = true; }
+    bool Flush();
+
+    bool IsWritable() const override { return m_poSharedResource->IsUpdatable(); }
+
+    const std::vector<std::shared_ptr<GDALDimension>>& GetDimensions() const override { return m_aoDims; }
+
+    const GDALExtendedDataType& GetDataType() const override { return m_oType; }
+
+    std::vector<GUInt64> GetBlockSize() const override { return m_anBlockSize; }
+
+    CSLConstList GetStructuralInfo() const override;
+
+    const void* GetRawNoDataValue() const override;
+
+    bool SetRawNoDataValue(const void* pRawNoData) override;
+
+    const std::string& GetUnit() const override;
+
+    bool SetUnit(const std::string& osUnit) override;
+
+    std::shared_ptr<GDALAttribute> GetAttribute(const std::string& osName) const override
+        { return m_oAttrGroup.GetAttribute(osName); }
+
+    std::vector<std::shared_ptr<GDALAttribute>> GetAttributes(CSLConstList papszOptions = nullptr) const override
+        { return m_oAttrGroup.GetAttributes(papszOptions); }
+
+    std::shared_ptr<GDALAttribute> CreateAttribute(const std::string& osName,
+                                                   const std::vector<GUInt64>& anDimensions,
+                                                   const GDALExtendedDataType& oDataType,
+                                                   CSLConstList papszOptions = nullptr) override;
+};
+
+#endif // ZARR_H
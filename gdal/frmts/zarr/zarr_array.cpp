@@ -0,0 +1,1318 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zarr driver
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "zarr.h"
+
+#include "gdal_thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/************************************************************************/
+/*                   ZarrDataTypeInfo::NeedsByteSwap()                  */
+/************************************************************************/
+
+bool ZarrDataTypeInfo::NeedsByteSwap() const
+{
+    return nNativeSize > 1 && bLittleEndian != CPL_TO_BOOL(CPL_IS_LSB);
+}
+
+/************************************************************************/
+/*                  ZarrDataTypeInfo::NeedsConversion()                 */
+/************************************************************************/
+
+// Whether the native data type has no direct GDAL equivalent.
+bool ZarrDataTypeInfo::NeedsConversion() const
+{
+    return (chKind == 'i' && nNativeSize == 1) ||
+           ((chKind == 'i' || chKind == 'u') && nNativeSize == 8);
+}
+
+/************************************************************************/
+/*                    ZarrDataTypeInfo::ToString()                      */
+/************************************************************************/
+
+std::string ZarrDataTypeInfo::ToString() const
+{
+    std::string osRet;
+    osRet += nNativeSize == 1 ? '|' : bLittleEndian ? '<' : '>';
+    osRet += chKind;
+    osRet += CPLSPrintf("%d", static_cast<int>(nNativeSize));
+    return osRet;
+}
+
+/************************************************************************/
+/*                      ZarrDataTypeInfo::Parse()                       */
+/************************************************************************/
+
+bool ZarrDataTypeInfo::Parse(const std::string& osDType,
+                             ZarrDataTypeInfo& oInfo)
+{
+    if( osDType.size() < 3 ||
+        (osDType[0] != '<' && osDType[0] != '>' && osDType[0] != '|') )
+    {
+        return false;
+    }
+    oInfo.bLittleEndian = osDType[0] != '>';
+    oInfo.chKind = osDType[1];
+    const int nSize = atoi(osDType.c_str() + 2);
+    oInfo.nNativeSize = static_cast<size_t>(std::max(0, nSize));
+
+    const char chKind = oInfo.chKind;
+    if( chKind == 'b' && nSize == 1 )
+        oInfo.eDT = GDT_Byte;
+    else if( chKind == 'u' && nSize == 1 )
+        oInfo.eDT = GDT_Byte;
+    else if( chKind == 'i' && nSize == 1 )
+        oInfo.eDT = GDT_Int16;
+    else if( chKind == 'i' && nSize == 2 )
+        oInfo.eDT = GDT_Int16;
+    else if( chKind == 'u' && nSize == 2 )
+        oInfo.eDT = GDT_UInt16;
+    else if( chKind == 'i' && nSize == 4 )
+        oInfo.eDT = GDT_Int32;
+    else if( chKind == 'u' && nSize == 4 )
+        oInfo.eDT = GDT_UInt32;
+    else if( (chKind == 'i' || chKind == 'u') && nSize == 8 )
+        oInfo.eDT = GDT_Float64;
+    else if( chKind == 'f' && nSize == 4 )
+        oInfo.eDT = GDT_Float32;
+    else if( chKind == 'f' && nSize == 8 )
+        oInfo.eDT = GDT_Float64;
+    else if( chKind == 'c' && nSize == 8 )
+        oInfo.eDT = GDT_CFloat32;
+    else if( chKind == 'c' && nSize == 16 )
+        oInfo.eDT = GDT_CFloat64;
+    else
+        return false;
+    return true;
+}
+
+/************************************************************************/
+/*                ZarrDataTypeInfo::FromGDALDataType()                  */
+/************************************************************************/
+
+bool ZarrDataTypeInfo::FromGDALDataType(GDALDataType eDT,
+                                        ZarrDataTypeInfo& oInfo)
+{
+    oInfo.eDT = eDT;
+    oInfo.bLittleEndian = true;
+    oInfo.nNativeSize = GDALGetDataTypeSizeBytes(eDT);
+    switch( eDT )
+    {
+        case GDT_Byte:
+        case GDT_UInt16:
+        case GDT_UInt32:
+            oInfo.chKind = 'u';
+            break;
+        case GDT_Int16:
+        case GDT_Int32:
+            oInfo.chKind = 'i';
+            break;
+        case GDT_Float32:
+        case GDT_Float64:
+            oInfo.chKind = 'f';
+            break;
+        case GDT_CFloat32:
+        case GDT_CFloat64:
+            oInfo.chKind = 'c';
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            ZarrArray()                               */
+/************************************************************************/
+
+ZarrArray::ZarrArray(const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+                     const std::string& osParentName,
+                     const std::string& osName,
+                     const std::vector<std::shared_ptr<GDALDimension>>& aoDims,
+                     const GDALExtendedDataType& oType,
+                     const ZarrDataTypeInfo& oDTInfo,
+                     const std::vector<GUInt64>& anBlockSize,
+                     const std::string& osDirectoryName):
+    GDALAbstractMDArray(osParentName, osName),
+    GDALMDArray(osParentName, osName),
+    m_poSharedResource(poSharedResource),
+    m_aoDims(aoDims),
+    m_oType(oType),
+    m_oDTInfo(oDTInfo),
+    m_anBlockSize(anBlockSize),
+    m_osDirectoryName(osDirectoryName),
+    m_osChunkCacheKeyPrefix(poSharedResource->GetChunkCacheKeyPrefix() +
+                            GetFullName() + '/')
+{
+}
+
+/************************************************************************/
+/*                              Create()                                */
+/************************************************************************/
+
+std::shared_ptr<ZarrArray> ZarrArray::Create(
+                const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+                const std::string& osParentName,
+                const std::string& osName,
+                const std::vector<std::shared_ptr<GDALDimension>>& aoDims,
+                const GDALExtendedDataType& oType,
+                const ZarrDataTypeInfo& oDTInfo,
+                const std::vector<GUInt64>& anBlockSize,
+                const std::string& osDirectoryName)
+{
+    auto poArray(std::shared_ptr<ZarrArray>(new ZarrArray(
+        poSharedResource, osParentName, osName, aoDims, oType, oDTInfo,
+        anBlockSize, osDirectoryName)));
+    poArray->SetSelf(poArray);
+
+    if( !aoDims.empty() )
+    {
+        std::vector<GUInt64> anArraySize;
+        for( const auto& poDim: aoDims )
+            anArraySize.push_back(poDim->GetSize());
+        // Chunk files are read and decoded together in worker threads, so
+        // that reads from network file systems can run concurrently.
+        const ZarrArray* poArrayRaw = poArray.get();
+        poArray->m_poChunkReader.reset(new GDALMDArrayChunkReader(
+            poArray->m_osChunkCacheKeyPrefix, anArraySize, anBlockSize, oType,
+            [](const std::vector<GUInt64>&, std::vector<GByte>& abyRaw)
+            {
+                abyRaw.clear();
+                return true;
+            },
+            [poArrayRaw](const std::vector<GUInt64>& anChunkIdx,
+                         const std::vector<GByte>&,
+                         std::vector<GByte>& abyDecoded)
+            {
+                return poArrayRaw->ReadChunk(anChunkIdx, abyDecoded);
+            }));
+    }
+    return poArray;
+}
+
+/************************************************************************/
+/*                            ~ZarrArray()                              */
+/************************************************************************/
+
+ZarrArray::~ZarrArray()
+{
+    Flush();
+}
+
+/************************************************************************/
+/*                            ParseCodecs()                             */
+/************************************************************************/
+
+bool ZarrArray::ParseCodecs(const CPLJSONObject& oZarray)
+{
+    const auto oCompressor = oZarray["compressor"];
+    if( oCompressor.IsValid() &&
+        oCompressor.GetType() != CPLJSONObject::Type::Null )
+    {
+        if( oCompressor.GetType() != CPLJSONObject::Type::Object )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Invalid compressor");
+            return false;
+        }
+        if( !SetCompressor(oCompressor) )
+            return false;
+    }
+
+    const auto oFilters = oZarray["filters"];
+    if( oFilters.IsValid() && oFilters.GetType() != CPLJSONObject::Type::Null )
+    {
+        if( oFilters.GetType() != CPLJSONObject::Type::Array )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Invalid filters");
+            return false;
+        }
+        for( const auto& oFilter: oFilters.ToArray() )
+        {
+            const std::string osId = oFilter.GetString("id");
+            if( osId != "shuffle" || m_nShuffleEltSize != 0 )
+            {
+                CPLError(CE_Failure, CPLE_NotSupported,
+                         "Unsupported filter: %s", osId.c_str());
+                return false;
+            }
+            const int nEltSize = oFilter.GetInteger(
+                "elementsize", static_cast<int>(m_oDTInfo.nNativeSize));
+            if( nEltSize <= 0 )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Invalid elementsize for shuffle filter");
+                return false;
+            }
+            m_nShuffleEltSize = static_cast<size_t>(nEltSize);
+        }
+    }
+
+    const auto oFillValue = oZarray["fill_value"];
+    const auto eFillValueType = oFillValue.GetType();
+    if( oFillValue.IsValid() && eFillValueType != CPLJSONObject::Type::Null )
+    {
+        double dfNoData = 0;
+        if( eFillValueType == CPLJSONObject::Type::Integer ||
+            eFillValueType == CPLJSONObject::Type::Long ||
+            eFillValueType == CPLJSONObject::Type::Double )
+        {
+            dfNoData = oFillValue.ToDouble();
+        }
+        else if( eFillValueType == CPLJSONObject::Type::Boolean )
+        {
+            dfNoData = oFillValue.ToBool() ? 1 : 0;
+        }
+        else if( eFillValueType == CPLJSONObject::Type::String )
+        {
+            const std::string osVal = oFillValue.ToString();
+            if( osVal == "NaN" )
+                dfNoData = std::numeric_limits<double>::quiet_NaN();
+            else if( osVal == "Infinity" )
+                dfNoData = std::numeric_limits<double>::infinity();
+            else if( osVal == "-Infinity" )
+                dfNoData = -std::numeric_limits<double>::infinity();
+            else
+            {
+                CPLError(CE_Failure, CPLE_NotSupported,
+                         "Unsupported fill_value: %s", osVal.c_str());
+                return false;
+            }
+        }
+        else
+        {
+            CPLError(CE_Failure, CPLE_NotSupported, "Unsupported fill_value");
+            return false;
+        }
+        m_abyNoData.resize(m_oType.GetSize());
+        GDALCopyWords(&dfNoData, GDT_Float64, 0,
+                      m_abyNoData.data(), m_oType.GetNumericDataType(), 0, 1);
+    }
+
+    const std::string osDimSeparator =
+        oZarray.GetString("dimension_separator", ".");
+    if( osDimSeparator != "." && osDimSeparator != "/" )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported dimension_separator: %s",
+                 osDimSeparator.c_str());
+        return false;
+    }
+    m_osDimSeparator = osDimSeparator;
+    return true;
+}
+
+/************************************************************************/
+/*                           SetCompressor()                            */
+/************************************************************************/
+
+bool ZarrArray::SetCompressor(const CPLJSONObject& oCompressor)
+{
+    // Compressors of numcodecs that map to the ones of the CPL registry.
+    const std::string osId = oCompressor.GetString("id");
+    if( osId != "zlib" && osId != "gzip" && osId != "lzma" &&
+        osId != "zstd" && osId != "lz4" )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported compressor: %s", osId.c_str());
+        return false;
+    }
+    m_psDecompressor = CPLGetDecompressor(osId.c_str());
+    m_psCompressor = CPLGetCompressor(osId.c_str());
+    if( m_psDecompressor == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s compressor not available in this build", osId.c_str());
+        return false;
+    }
+    if( osId == "lzma" )
+    {
+        // Only the default FORMAT_XZ format, without custom filters, is
+        // supported.
+        if( oCompressor.GetInteger("format", 1) != 1 ||
+            oCompressor["filters"].GetType() == CPLJSONObject::Type::Array )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Unsupported lzma format or filters");
+            return false;
+        }
+    }
+
+    // Other members of the compressor object, such as level, preset or
+    // acceleration, map to options of the same name in upper case.
+    m_aosCompressorOptions.Clear();
+    for( const auto& oChild: oCompressor.GetChildren() )
+    {
+        const auto eType = oChild.GetType();
+        if( oChild.GetName() == "id" ||
+            (eType != CPLJSONObject::Type::Integer &&
+             eType != CPLJSONObject::Type::Long) )
+        {
+            continue;
+        }
+        m_aosCompressorOptions.SetNameValue(
+            CPLString(oChild.GetName()).toupper().c_str(),
+            oChild.ToString().c_str());
+    }
+    m_osCompressorId = osId;
+    m_oCompressorJSon = oCompressor;
+    return true;
+}
+
+/************************************************************************/
+/*                           InitAttributes()                           */
+/************************************************************************/
+
+void ZarrArray::InitAttributes(const CPLJSONObject& oAttributes)
+{
+    m_oAttrGroup.Init(oAttributes);
+    const auto oUnits = oAttributes["units"];
+    if( oUnits.GetType() == CPLJSONObject::Type::String )
+        m_osUnit = oUnits.ToString();
+}
+
+/************************************************************************/
+/*                        SerializeDefinition()                         */
+/************************************************************************/
+
+CPLJSONObject ZarrArray::SerializeDefinition() const
+{
+    CPLJSONObject oZarray;
+
+    CPLJSONArray oChunks;
+    for( const auto nBlockSize: m_anBlockSize )
+        oChunks.Add(static_cast<GInt64>(nBlockSize));
+    oZarray.Add("chunks", oChunks);
+
+    if( m_osCompressorId.empty() )
+        oZarray.AddNull("compressor");
+    else
+        oZarray.Add("compressor", m_oCompressorJSon);
+
+    oZarray.Add("dtype", m_oDTInfo.ToString());
+
+    if( m_abyNoData.empty() )
+    {
+        oZarray.AddNull("fill_value");
+    }
+    else
+    {
+        double dfNoData = 0;
+        GDALCopyWords(m_abyNoData.data(), m_oType.GetNumericDataType(), 0,
+                      &dfNoData, GDT_Float64, 0, 1);
+        if( std::isnan(dfNoData) )
+            oZarray.Add("fill_value", "NaN");
+        else if( std::isinf(dfNoData) )
+            oZarray.Add("fill_value", dfNoData > 0 ? "Infinity" : "-Infinity");
+        else if( m_oDTInfo.chKind == 'f' || m_oDTInfo.chKind == 'c' )
+            oZarray.Add("fill_value", dfNoData);
+        else
+            oZarray.Add("fill_value", static_cast<GInt64>(dfNoData));
+    }
+
+    if( m_nShuffleEltSize == 0 )
+    {
+        oZarray.AddNull("filters");
+    }
+    else
+    {
+        CPLJSONArray oFilters;
+        CPLJSONObject oShuffle;
+        oShuffle.Add("id", "shuffle");
+        oShuffle.Add("elementsize", static_cast<int>(m_nShuffleEltSize));
+        oFilters.Add(oShuffle);
+        oZarray.Add("filters", oFilters);
+    }
+
+    oZarray.Add("order", "C");
+
+    CPLJSONArray oShape;
+    for( const auto& poDim: m_aoDims )
+        oShape.Add(static_cast<GInt64>(poDim->GetSize()));
+    oZarray.Add("shape", oShape);
+
+    oZarray.Add("zarr_format", 2);
+
+    if( m_osDimSeparator != "." )
+        oZarray.Add("dimension_separator", m_osDimSeparator);
+
+    return oZarray;
+}
+
+/************************************************************************/
+/*                               Flush()                                */
+/************************************************************************/
+
+bool ZarrArray::Flush()
+{
+    if( !m_bDefinitionModified && !m_oAttrGroup.IsModified() )
+        return true;
+
+    bool bRet = true;
+    if( m_bDefinitionModified )
+    {
+        m_bDefinitionModified = false;
+        bRet = ZarrWriteJSON(
+            CPLFormFilename(m_osDirectoryName.c_str(), ".zarray", nullptr),
+            SerializeDefinition());
+    }
+
+    m_oAttrGroup.SetModified(false);
+    auto oAttributes = m_oAttrGroup.Serialize();
+    CPLJSONArray oDimNames;
+    for( const auto& poDim: m_aoDims )
+        oDimNames.Add(poDim->GetName());
+    oAttributes.Add("_ARRAY_DIMENSIONS", oDimNames);
+    bRet = ZarrWriteJSON(
+        CPLFormFilename(m_osDirectoryName.c_str(), ".zattrs", nullptr),
+        oAttributes) && bRet;
+    return bRet;
+}
+
+/************************************************************************/
+/*                        GetChunkElementCount()                        */
+/************************************************************************/
+
+size_t ZarrArray::GetChunkElementCount() const
+{
+    size_t nCount = 1;
+    for( const auto nBlockSize: m_anBlockSize )
+        nCount *= static_cast<size_t>(nBlockSize);
+    return nCount;
+}
+
+/************************************************************************/
+/*                          GetChunkFilename()                          */
+/************************************************************************/
+
+std::string ZarrArray::GetChunkFilename(
+                            const std::vector<GUInt64>& anChunkIdx) const
+{
+    std::string osKey;
+    for( const auto nIdx: anChunkIdx )
+    {
+        if( !osKey.empty() )
+            osKey += m_osDimSeparator;
+        osKey += CPLSPrintf(CPL_FRMT_GUIB, static_cast<GUIntBig>(nIdx));
+    }
+    // 0-dimensional arrays have a single chunk
+    if( osKey.empty() )
+        osKey = "0";
+    return CPLFormFilename(m_osDirectoryName.c_str(), osKey.c_str(), nullptr);
+}
+
+/************************************************************************/
+/*                           FillWithNoData()                           */
+/************************************************************************/
+
+void ZarrArray::FillWithNoData(std::vector<GByte>& abyChunk) const
+{
+    const size_t nDTSize = m_oType.GetSize();
+    const size_t nElts = GetChunkElementCount();
+    if( m_abyNoData.empty() )
+    {
+        abyChunk.assign(nElts * nDTSize, 0);
+        return;
+    }
+    abyChunk.resize(nElts * nDTSize);
+    for( size_t i = 0; i < nElts; ++i )
+        memcpy(&abyChunk[i * nDTSize], m_abyNoData.data(), nDTSize);
+}
+
+/************************************************************************/
+/*                             ReadChunk()                              */
+/************************************************************************/
+
+/** Read and decode a chunk into its GDAL data type. A missing chunk file
+ * is equivalent to a chunk filled with the fill value. Thread-safe. */
+bool ZarrArray::ReadChunk(const std::vector<GUInt64>& anChunkIdx,
+                          std::vector<GByte>& abyChunk) const
+{
+    const std::string osFilename(GetChunkFilename(anChunkIdx));
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "rb");
+    if( fp == nullptr )
+    {
+        // Only a missing chunk means the fill value.
+        VSIStatBufL sStat;
+        if( VSIStatExL(osFilename.c_str(), &sStat,
+                       VSI_STAT_EXISTS_FLAG) != 0 )
+        {
+            FillWithNoData(abyChunk);
+            return true;
+        }
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot open %s",
+                 osFilename.c_str());
+        return false;
+    }
+
+    std::vector<GByte> abyData;
+    bool bOK = VSIFSeekL(fp, 0, SEEK_END) == 0;
+    const vsi_l_offset nSize = VSIFTellL(fp);
+    if( bOK && nSize > static_cast<vsi_l_offset>(INT_MAX) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s: too large chunk",
+                 osFilename.c_str());
+        bOK = false;
+    }
+    if( bOK )
+    {
+        try
+        {
+            abyData.resize(static_cast<size_t>(nSize));
+        }
+        catch( const std::exception& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate memory for chunk");
+            bOK = false;
+        }
+    }
+    bOK = bOK && VSIFSeekL(fp, 0, SEEK_SET) == 0 &&
+          VSIFReadL(abyData.data(), 1, abyData.size(), fp) == abyData.size();
+    VSIFCloseL(fp);
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot read %s",
+                 osFilename.c_str());
+        return false;
+    }
+    if( !DecodeChunk(abyData, abyChunk) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot decode %s",
+                 osFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          ApplyShuffle()                              */
+/************************************************************************/
+
+// Byte shuffling as done by the numcodecs Shuffle codec, with the shuffle
+// filter of the CPL compressor registry.
+static bool ApplyShuffle(const CPLCompressor* psFilter, size_t nEltSize,
+                         std::vector<GByte>& abyBuffer)
+{
+    if( psFilter == nullptr )
+        return false;
+    std::vector<GByte> abyTmp(abyBuffer.size());
+    void* pOut = abyTmp.data();
+    size_t nOutSize = abyTmp.size();
+    const std::string osEltSize(CPLSPrintf("ELEMENTSIZE=%d",
+                                           static_cast<int>(nEltSize)));
+    const char* const apszOptions[] = { osEltSize.c_str(), nullptr };
+    if( !psFilter->pfnFunc(abyBuffer.data(), abyBuffer.size(),
+                           &pOut, &nOutSize, apszOptions,
+                           psFilter->user_data) )
+        return false;
+    abyBuffer.swap(abyTmp);
+    return true;
+}
+
+/************************************************************************/
+/*                            DecodeChunk()                             */
+/************************************************************************/
+
+// Decompress, unshuffle, byte-swap and convert the content of a chunk file.
+// abyData is consumed.
+bool ZarrArray::DecodeChunk(std::vector<GByte>& abyData,
+                            std::vector<GByte>& abyChunk) const
+{
+    const size_t nElts = GetChunkElementCount();
+    const size_t nRawSize = nElts * m_oDTInfo.nNativeSize;
+
+    std::vector<GByte> abyRaw;
+    if( m_psDecompressor == nullptr )
+    {
+        abyRaw.swap(abyData);
+    }
+    else
+    {
+        abyRaw.resize(nRawSize);
+        void* pOut = abyRaw.data();
+        size_t nOutBytes = abyRaw.size();
+        if( !m_psDecompressor->pfnFunc(abyData.data(), abyData.size(),
+                                       &pOut, &nOutBytes,
+                                       m_aosCompressorOptions.List(),
+                                       m_psDecompressor->user_data) )
+        {
+            return false;
+        }
+        abyRaw.resize(nOutBytes);
+    }
+    std::vector<GByte>().swap(abyData);
+    if( abyRaw.size() != nRawSize )
+        return false;
+
+    if( m_nShuffleEltSize > 1 &&
+        !ApplyShuffle(CPLGetDecompressor("shuffle"), m_nShuffleEltSize,
+                      abyRaw) )
+    {
+        return false;
+    }
+
+    if( m_oDTInfo.NeedsByteSwap() )
+    {
+        if( m_oDTInfo.chKind == 'c' )
+        {
+            GDALSwapWordsEx(abyRaw.data(),
+                            static_cast<int>(m_oDTInfo.nNativeSize / 2),
+                            nElts * 2,
+                            static_cast<int>(m_oDTInfo.nNativeSize / 2));
+        }
+        else
+        {
+            GDALSwapWordsEx(abyRaw.data(),
+                            static_cast<int>(m_oDTInfo.nNativeSize),
+                            nElts,
+                            static_cast<int>(m_oDTInfo.nNativeSize));
+        }
+    }
+
+    if( !m_oDTInfo.NeedsConversion() )
+    {
+        abyChunk.swap(abyRaw);
+        return true;
+    }
+
+    abyChunk.resize(nElts * m_oType.GetSize());
+    if( m_oDTInfo.chKind == 'i' && m_oDTInfo.nNativeSize == 1 )
+    {
+        GInt16* panOut = reinterpret_cast<GInt16*>(abyChunk.data());
+        for( size_t i = 0; i < nElts; ++i )
+            panOut[i] = static_cast<signed char>(abyRaw[i]);
+    }
+    else if( m_oDTInfo.chKind == 'i' )
+    {
+        double* padfOut = reinterpret_cast<double*>(abyChunk.data());
+        for( size_t i = 0; i < nElts; ++i )
+        {
+            GInt64 nVal;
+            memcpy(&nVal, &abyRaw[i * sizeof(nVal)], sizeof(nVal));
+            padfOut[i] = static_cast<double>(nVal);
+        }
+    }
+    else
+    {
+        double* padfOut = reinterpret_cast<double*>(abyChunk.data());
+        for( size_t i = 0; i < nElts; ++i )
+        {
+            GUInt64 nVal;
+            memcpy(&nVal, &abyRaw[i * sizeof(nVal)], sizeof(nVal));
+            padfOut[i] = static_cast<double>(nVal);
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            EncodeChunk()                             */
+/************************************************************************/
+
+// Reverse of DecodeChunk()
+bool ZarrArray::EncodeChunk(const std::vector<GByte>& abyChunk,
+                            std::vector<GByte>& abyData) const
+{
+    const size_t nElts = GetChunkElementCount();
+    const size_t nRawSize = nElts * m_oDTInfo.nNativeSize;
+
+    std::vector<GByte> abyRaw;
+    if( !m_oDTInfo.NeedsConversion() )
+    {
+        abyRaw = abyChunk;
+    }
+    else
+    {
+        abyRaw.resize(nRawSize);
+        if( m_oDTInfo.chKind == 'i' && m_oDTInfo.nNativeSize == 1 )
+        {
+            const GInt16* panIn = reinterpret_cast<const GInt16*>(abyChunk.data());
+            for( size_t i = 0; i < nElts; ++i )
+            {
+                abyRaw[i] = static_cast<GByte>(static_cast<signed char>(
+                    std::max<GInt16>(-128, std::min<GInt16>(127, panIn[i]))));
+            }
+        }
+        else
+        {
+            const double* padfIn = reinterpret_cast<const double*>(abyChunk.data());
+            for( size_t i = 0; i < nElts; ++i )
+            {
+                const double dfVal = std::isnan(padfIn[i]) ? 0 : padfIn[i];
+                if( m_oDTInfo.chKind == 'i' )
+                {
+                    const GInt64 nVal = static_cast<GInt64>(
+                        std::max(-9.2233720368547758e18,
+                                 std::min(9.2233720368547748e18, dfVal)));
+                    memcpy(&abyRaw[i * sizeof(nVal)], &nVal, sizeof(nVal));
+                }
+                else
+                {
+                    const GUInt64 nVal = static_cast<GUInt64>(
+                        std::max(0.0, std::min(1.8446744073709550e19, dfVal)));
+                    memcpy(&abyRaw[i * sizeof(nVal)], &nVal, sizeof(nVal));
+                }
+            }
+        }
+    }
+
+    if( m_oDTInfo.NeedsByteSwap() )
+    {
+        if( m_oDTInfo.chKind == 'c' )
+        {
+            GDALSwapWordsEx(abyRaw.data(),
+                            static_cast<int>(m_oDTInfo.nNativeSize / 2),
+                            nElts * 2,
+                            static_cast<int>(m_oDTInfo.nNativeSize / 2));
+        }
+        else
+        {
+            GDALSwapWordsEx(abyRaw.data(),
+                            static_cast<int>(m_oDTInfo.nNativeSize),
+                            nElts,
+                            static_cast<int>(m_oDTInfo.nNativeSize));
+        }
+    }
+
+    if( m_nShuffleEltSize > 1 &&
+        !ApplyShuffle(CPLGetCompressor("shuffle"), m_nShuffleEltSize, abyRaw) )
+    {
+        return false;
+    }
+
+    if( m_osCompressorId.empty() )
+    {
+        abyData.swap(abyRaw);
+        return true;
+    }
+    if( m_psCompressor == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Writing with compressor %s is not supported",
+                 m_osCompressorId.c_str());
+        return false;
+    }
+    size_t nMaxOutBytes = 0;
+    if( !m_psCompressor->pfnFunc(abyRaw.data(), abyRaw.size(),
+                                 nullptr, &nMaxOutBytes,
+                                 m_aosCompressorOptions.List(),
+                                 m_psCompressor->user_data) )
+    {
+        return false;
+    }
+    abyData.resize(nMaxOutBytes);
+    void* pOut = abyData.data();
+    size_t nOutBytes = abyData.size();
+    if( !m_psCompressor->pfnFunc(abyRaw.data(), abyRaw.size(),
+                                 &pOut, &nOutBytes,
+                                 m_aosCompressorOptions.List(),
+                                 m_psCompressor->user_data) )
+    {
+        return false;
+    }
+    abyData.resize(nOutBytes);
+    return true;
+}
+
+/************************************************************************/
+/*                             WriteChunk()                             */
+/************************************************************************/
+
+bool ZarrArray::WriteChunk(const std::vector<GUInt64>& anChunkIdx,
+                           const std::vector<GByte>& abyChunk) const
+{
+    std::vector<GByte> abyData;
+    if( !EncodeChunk(abyChunk, abyData) )
+        return false;
+
+    const std::string osFilename(GetChunkFilename(anChunkIdx));
+    if( m_osDimSeparator == "/" && anChunkIdx.size() > 1 )
+    {
+        VSIMkdirRecursive(CPLGetPath(osFilename.c_str()), 0755);
+    }
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                 osFilename.c_str());
+        return false;
+    }
+    bool bOK = VSIFWriteL(abyData.data(), 1, abyData.size(), fp) ==
+                                                            abyData.size();
+    bOK = VSIFCloseL(fp) == 0 && bOK;
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write %s",
+                 osFilename.c_str());
+    }
+    return bOK;
+}
+
+/************************************************************************/
+/*                               IRead()                                */
+/************************************************************************/
+
+bool ZarrArray::IRead(const GUInt64* arrayStartIdx,
+                      const size_t* count,
+                      const GInt64* arrayStep,
+                      const GPtrDiff_t* bufferStride,
+                      const GDALExtendedDataType& bufferDataType,
+                      void* pDstBuffer) const
+{
+    if( m_aoDims.empty() )
+    {
+        std::vector<GByte> abyChunk;
+        if( !ReadChunk(std::vector<GUInt64>(), abyChunk) )
+            return false;
+        return GDALExtendedDataType::CopyValue(abyChunk.data(), m_oType,
+                                               pDstBuffer, bufferDataType);
+    }
+
+    if( bufferDataType.GetClass() != GEDTC_NUMERIC )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Only numeric buffer data types are supported");
+        return false;
+    }
+    for( size_t i = 0; i < m_aoDims.size(); ++i )
+    {
+        if( count[i] > 1 && arrayStep[i] == 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Null array steps are not supported");
+            return false;
+        }
+    }
+    if( m_poChunkReader->IsUsable() &&
+        m_poChunkReader->Read(arrayStartIdx, count, arrayStep,
+                              bufferStride, bufferDataType, pDstBuffer) )
+    {
+        return true;
+    }
+    return IReadChunkByChunk(arrayStartIdx, count, arrayStep,
+                             bufferStride, bufferDataType, pDstBuffer);
+}
+
+/************************************************************************/
+/*                          IReadChunkByChunk()                         */
+/************************************************************************/
+
+// Read the chunks intersecting the request one after the other, without
+// going through the chunk cache.
+bool ZarrArray::IReadChunkByChunk(const GUInt64* arrayStartIdx,
+                                  const size_t* count,
+                                  const GInt64* arrayStep,
+                                  const GPtrDiff_t* bufferStride,
+                                  const GDALExtendedDataType& bufferDataType,
+                                  void* pDstBuffer) const
+{
+    const size_t nDims = m_aoDims.size();
+
+    // Turn negative steps into positive ones, by starting from the other
+    // end of the request, and going backwards in the buffer.
+    std::vector<GUInt64> anStartIdx(arrayStartIdx, arrayStartIdx + nDims);
+    std::vector<GInt64> anStep(nDims);
+    std::vector<GPtrDiff_t> anBufferStride(bufferStride, bufferStride + nDims);
+    GByte* pabyDstBuffer = static_cast<GByte*>(pDstBuffer);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        if( count[i] == 0 )
+            return true;
+        anStep[i] = count[i] == 1 ? 1 : arrayStep[i];
+        if( anStep[i] < 0 )
+        {
+            anStartIdx[i] -= (count[i] - 1) * static_cast<GUInt64>(-anStep[i]);
+            pabyDstBuffer += static_cast<GPtrDiff_t>(count[i] - 1) *
+                anBufferStride[i] *
+                static_cast<GPtrDiff_t>(bufferDataType.GetSize());
+            anStep[i] = -anStep[i];
+            anBufferStride[i] = -anBufferStride[i];
+        }
+    }
+
+    std::vector<GUInt64> anFirstChunk(nDims), anLastChunk(nDims);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        const GUInt64 nEnd = anStartIdx[i] +
+            (count[i] - 1) * static_cast<GUInt64>(anStep[i]);
+        anFirstChunk[i] = anStartIdx[i] / m_anBlockSize[i];
+        anLastChunk[i] = nEnd / m_anBlockSize[i];
+    }
+
+    std::vector<GByte> abyChunk;
+    std::vector<GUInt64> anChunkIdx(anFirstChunk);
+    while( true )
+    {
+        bool bHasSamples = true;
+        for( size_t i = 0; i < nDims && bHasSamples; ++i )
+        {
+            const GUInt64 nStep = static_cast<GUInt64>(anStep[i]);
+            const GUInt64 nChunkStart = anChunkIdx[i] * m_anBlockSize[i];
+            GUInt64 nK = 0;
+            if( nChunkStart > anStartIdx[i] )
+                nK = (nChunkStart - anStartIdx[i] + nStep - 1) / nStep;
+            bHasSamples = nK < count[i] &&
+                anStartIdx[i] + nK * nStep < nChunkStart + m_anBlockSize[i];
+        }
+        if( bHasSamples )
+        {
+            if( !ReadChunk(anChunkIdx, abyChunk) )
+                return false;
+            GDALMDArrayChunkReader::CopyChunkToBuffer(
+                m_anBlockSize, m_oType, anChunkIdx, abyChunk.data(),
+                anStartIdx.data(), count, anStep.data(),
+                anBufferStride.data(), bufferDataType, pabyDstBuffer);
+        }
+
+        size_t i = nDims;
+        bool bFinished = true;
+        while( i > 0 )
+        {
+            --i;
+            if( anChunkIdx[i] < anLastChunk[i] )
+            {
+                ++anChunkIdx[i];
+                bFinished = false;
+                break;
+            }
+            anChunkIdx[i] = anFirstChunk[i];
+        }
+        if( bFinished )
+            break;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                               IWrite()                               */
+/************************************************************************/
+
+namespace
+{
+struct ZarrWriteJob
+{
+    const ZarrArray* poArray = nullptr;
+    std::vector<GUInt64> anChunkIdx{};
+    bool bFullyCovered = false;
+    bool bOK = false;
+    const GUInt64* arrayStartIdx = nullptr;
+    const size_t* count = nullptr;
+    const GInt64* arrayStep = nullptr;
+    const GPtrDiff_t* bufferStride = nullptr;
+    const GDALExtendedDataType* poBufferDataType = nullptr;
+    const void* pSrcBuffer = nullptr;
+};
+} // namespace
+
+// Read-modify-write of a chunk. Run in a worker thread.
+void ZarrArray::WriteChunkJob(void* pData)
+{
+    auto psJob = static_cast<ZarrWriteJob*>(pData);
+    const ZarrArray* poArray = psJob->poArray;
+    std::vector<GByte> abyChunk;
+    if( psJob->bFullyCovered )
+        poArray->FillWithNoData(abyChunk);
+    else if( !poArray->ReadChunk(psJob->anChunkIdx, abyChunk) )
+        return;
+    GDALMDArrayChunkReader::CopyBufferToChunk(
+        poArray->m_anBlockSize, poArray->m_oType, psJob->anChunkIdx,
+        abyChunk.data(), psJob->arrayStartIdx, psJob->count,
+        psJob->arrayStep, psJob->bufferStride, *(psJob->poBufferDataType),
+        psJob->pSrcBuffer);
+    psJob->bOK = poArray->WriteChunk(psJob->anChunkIdx, abyChunk);
+}
+
+bool ZarrArray::IWrite(const GUInt64* arrayStartIdx,
+                       const size_t* count,
+                       const GInt64* arrayStep,
+                       const GPtrDiff_t* bufferStride,
+                       const GDALExtendedDataType& bufferDataType,
+                       const void* pSrcBuffer)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return false;
+    }
+
+    const size_t nDims = m_aoDims.size();
+    if( nDims == 0 )
+    {
+        std::vector<GByte> abyChunk(m_oType.GetSize());
+        if( !GDALExtendedDataType::CopyValue(pSrcBuffer, bufferDataType,
+                                             abyChunk.data(), m_oType) )
+            return false;
+        const bool bRet = WriteChunk(std::vector<GUInt64>(), abyChunk);
+        GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
+        return bRet;
+    }
+
+    if( bufferDataType.GetClass() != GEDTC_NUMERIC )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Only numeric buffer data types are supported");
+        return false;
+    }
+
+    // Turn negative steps into positive ones, by starting from the other
+    // end of the request, and going backwards in the buffer.
+    std::vector<GUInt64> anStartIdx(arrayStartIdx, arrayStartIdx + nDims);
+    std::vector<GInt64> anStep(nDims);
+    std::vector<GPtrDiff_t> anBufferStride(bufferStride, bufferStride + nDims);
+    const GByte* pabySrcBuffer = static_cast<const GByte*>(pSrcBuffer);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        if( count[i] == 0 )
+            return true;
+        anStep[i] = count[i] == 1 ? 1 : arrayStep[i];
+        if( anStep[i] == 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Null array steps are not supported");
+            return false;
+        }
+        if( anStep[i] < 0 )
+        {
+            anStartIdx[i] -= (count[i] - 1) * static_cast<GUInt64>(-anStep[i]);
+            pabySrcBuffer += static_cast<GPtrDiff_t>(count[i] - 1) *
+                anBufferStride[i] *
+                static_cast<GPtrDiff_t>(bufferDataType.GetSize());
+            anStep[i] = -anStep[i];
+            anBufferStride[i] = -anBufferStride[i];
+        }
+    }
+
+    // Collect the chunks that contain at least one sample of the request
+    std::vector<GUInt64> anFirstChunk(nDims), anLastChunk(nDims);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        const GUInt64 nEnd = anStartIdx[i] +
+            (count[i] - 1) * static_cast<GUInt64>(anStep[i]);
+        anFirstChunk[i] = anStartIdx[i] / m_anBlockSize[i];
+        anLastChunk[i] = nEnd / m_anBlockSize[i];
+    }
+
+    std::vector<ZarrWriteJob> asJobs;
+    std::vector<GUInt64> anChunkIdx(anFirstChunk);
+    while( true )
+    {
+        bool bHasSamples = true;
+        bool bFullyCovered = true;
+        for( size_t i = 0; i < nDims && bHasSamples; ++i )
+        {
+            const GUInt64 nStep = static_cast<GUInt64>(anStep[i]);
+            const GUInt64 nChunkStart = anChunkIdx[i] * m_anBlockSize[i];
+            const GUInt64 nChunkEnd = std::min(
+                nChunkStart + m_anBlockSize[i], m_aoDims[i]->GetSize());
+            GUInt64 nK = 0;
+            if( nChunkStart > anStartIdx[i] )
+                nK = (nChunkStart - anStartIdx[i] + nStep - 1) / nStep;
+            bHasSamples = nK < count[i] &&
+                          anStartIdx[i] + nK * nStep < nChunkEnd;
+            bFullyCovered = bFullyCovered &&
+                (nStep == 1 || count[i] == 1) &&
+                anStartIdx[i] <= nChunkStart &&
+                anStartIdx[i] + (count[i] - 1) * nStep >= nChunkEnd - 1;
+        }
+        if( bHasSamples )
+        {
+            ZarrWriteJob sJob;
+            sJob.poArray = this;
+            sJob.anChunkIdx = anChunkIdx;
+            sJob.bFullyCovered = bFullyCovered;
+            sJob.arrayStartIdx = anStartIdx.data();
+            sJob.count = count;
+            sJob.arrayStep = anStep.data();
+            sJob.bufferStride = anBufferStride.data();
+            sJob.poBufferDataType = &bufferDataType;
+            sJob.pSrcBuffer = pabySrcBuffer;
+            asJobs.emplace_back(std::move(sJob));
+        }
+
+        size_t i = nDims;
+        bool bFinished = true;
+        while( i > 0 )
+        {
+            --i;
+            if( anChunkIdx[i] < anLastChunk[i] )
+            {
+                ++anChunkIdx[i];
+                bFinished = false;
+                break;
+            }
+            anChunkIdx[i] = anFirstChunk[i];
+        }
+        if( bFinished )
+            break;
+    }
+
+    // Each job touches a distinct chunk file, so they can be run
+    // concurrently.
+    const int nThreads = GDALMDArrayChunkReader::GetNumThreads();
+    std::unique_ptr<CPLJobQueue> poQueue;
+    if( nThreads > 1 && asJobs.size() > 1 )
+    {
+        auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poQueue = poThreadPool->CreateJobQueue();
+    }
+    for( auto& sJob: asJobs )
+    {
+        if( !poQueue || !poQueue->SubmitJob(WriteChunkJob, &sJob) )
+            WriteChunkJob(&sJob);
+    }
+    if( poQueue )
+        poQueue->WaitCompletion();
+
+    GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
+
+    for( const auto& sJob: asJobs )
+    {
+        if( !sJob.bOK )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         GetStructuralInfo()                          */
+/************************************************************************/
+
+CSLConstList ZarrArray::GetStructuralInfo() const
+{
+    if( m_aosStructuralInfo.empty() )
+    {
+        m_aosStructuralInfo.SetNameValue("COMPRESSOR",
+            m_osCompressorId.empty() ? "NONE" : m_osCompressorId.c_str());
+        if( m_nShuffleEltSize )
+            m_aosStructuralInfo.SetNameValue("FILTER", "shuffle");
+        m_aosStructuralInfo.SetNameValue("DTYPE", m_oDTInfo.ToString().c_str());
+    }
+    return m_aosStructuralInfo.List();
+}
+
+/************************************************************************/
+/*                         GetRawNoDataValue()                          */
+/************************************************************************/
+
+const void* ZarrArray::GetRawNoDataValue() const
+{
+    return m_abyNoData.empty() ? nullptr : m_abyNoData.data();
+}
+
+/************************************************************************/
+/*                         SetRawNoDataValue()                          */
+/************************************************************************/
+
+bool ZarrArray::SetRawNoDataValue(const void* pRawNoData)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return false;
+    }
+    if( pRawNoData == nullptr )
+    {
+        m_abyNoData.clear();
+    }
+    else
+    {
+        const auto pabyNoData = static_cast<const GByte*>(pRawNoData);
+        m_abyNoData.assign(pabyNoData, pabyNoData + m_oType.GetSize());
+    }
+    m_bDefinitionModified = true;
+    // Missing chunks cached with the previous fill value are now stale
+    GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
+    return true;
+}
+
+/************************************************************************/
+/*                              GetUnit()                               */
+/************************************************************************/
+
+const std::string& ZarrArray::GetUnit() const
+{
+    return m_osUnit;
+}
+
+/************************************************************************/
+/*                              SetUnit()                               */
+/************************************************************************/
+
+bool ZarrArray::SetUnit(const std::string& osUnit)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return false;
+    }
+    auto poAttr = m_oAttrGroup.GetAttribute("units");
+    if( !poAttr )
+    {
+        poAttr = m_oAttrGroup.CreateAttribute(
+            "units", {}, GDALExtendedDataType::CreateString());
+    }
+    if( !poAttr || !poAttr->Write(osUnit.c_str()) )
+        return false;
+    m_oAttrGroup.SetModified(true);
+    m_osUnit = osUnit;
+    return true;
+}
+
+/************************************************************************/
+/*                          CreateAttribute()                           */
+/************************************************************************/
+
+std::shared_ptr<GDALAttribute> ZarrArray::CreateAttribute(
+                                    const std::string& osName,
+                                    const std::vector<GUInt64>& anDimensions,
+                                    const GDALExtendedDataType& oDataType,
+                                    CSLConstList papszOptions)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return nullptr;
+    }
+    if( osName == "_ARRAY_DIMENSIONS" )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s is a reserved attribute name", osName.c_str());
+        return nullptr;
+    }
+    return m_oAttrGroup.CreateAttribute(osName, anDimensions, oDataType,
+                                        papszOptions);
+}
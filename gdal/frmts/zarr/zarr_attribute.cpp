@@ -0,0 +1,243 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zarr driver
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "zarr.h"
+#include "memdataset.h"
+
+/************************************************************************/
+/*                          ZarrAttributeGroup()                        */
+/************************************************************************/
+
+ZarrAttributeGroup::ZarrAttributeGroup()
+{
+    std::unique_ptr<GDALDataset> poTmpDS(
+                    MEMDataset::CreateMultiDimensional("", nullptr, nullptr));
+    m_poGroup = poTmpDS->GetRootGroup();
+}
+
+/************************************************************************/
+/*                     ZarrAttributeGroup::Init()                       */
+/************************************************************************/
+
+void ZarrAttributeGroup::Init(const CPLJSONObject& obj)
+{
+    if( obj.GetType() != CPLJSONObject::Type::Object )
+        return;
+    for( const auto& item: obj.GetChildren() )
+    {
+        const std::string osName = item.GetName();
+        // Reserved by xarray to store the dimension names
+        if( osName == "_ARRAY_DIMENSIONS" )
+            continue;
+        const auto eType = item.GetType();
+        if( eType == CPLJSONObject::Type::String )
+        {
+            auto poAttr = m_poGroup->CreateAttribute(
+                osName, {}, GDALExtendedDataType::CreateString());
+            if( poAttr )
+                poAttr->Write(item.ToString().c_str());
+        }
+        else if( eType == CPLJSONObject::Type::Integer ||
+                 eType == CPLJSONObject::Type::Boolean )
+        {
+            auto poAttr = m_poGroup->CreateAttribute(
+                osName, {}, GDALExtendedDataType::Create(GDT_Int32));
+            if( poAttr )
+                poAttr->Write(item.ToInteger());
+        }
+        else if( eType == CPLJSONObject::Type::Long ||
+                 eType == CPLJSONObject::Type::Double )
+        {
+            auto poAttr = m_poGroup->CreateAttribute(
+                osName, {}, GDALExtendedDataType::Create(GDT_Float64));
+            if( poAttr )
+                poAttr->Write(item.ToDouble());
+        }
+        else if( eType == CPLJSONObject::Type::Array )
+        {
+            const auto oArray = item.ToArray();
+            bool bAllString = oArray.Size() > 0;
+            bool bAllNumber = oArray.Size() > 0;
+            for( const auto& oElt: oArray )
+            {
+                const auto eEltType = oElt.GetType();
+                if( eEltType != CPLJSONObject::Type::String )
+                    bAllString = false;
+                if( eEltType != CPLJSONObject::Type::Integer &&
+                    eEltType != CPLJSONObject::Type::Long &&
+                    eEltType != CPLJSONObject::Type::Double )
+                    bAllNumber = false;
+            }
+            const std::vector<GUInt64> anDims{
+                static_cast<GUInt64>(oArray.Size())};
+            if( bAllString )
+            {
+                CPLStringList aosValues;
+                for( const auto& oElt: oArray )
+                    aosValues.AddString(oElt.ToString().c_str());
+                auto poAttr = m_poGroup->CreateAttribute(
+                    osName, anDims, GDALExtendedDataType::CreateString());
+                if( poAttr )
+                    poAttr->Write(aosValues.List());
+            }
+            else if( bAllNumber )
+            {
+                std::vector<double> adfValues;
+                for( const auto& oElt: oArray )
+                    adfValues.push_back(oElt.ToDouble());
+                auto poAttr = m_poGroup->CreateAttribute(
+                    osName, anDims, GDALExtendedDataType::Create(GDT_Float64));
+                if( poAttr )
+                    poAttr->Write(adfValues.data(), adfValues.size());
+            }
+            else
+            {
+                auto poAttr = m_poGroup->CreateAttribute(
+                    osName, {}, GDALExtendedDataType::CreateString());
+                if( poAttr )
+                    poAttr->Write(item.Format(CPLJSONObject::PrettyFormat::Plain).c_str());
+            }
+        }
+        else if( eType == CPLJSONObject::Type::Object )
+        {
+            auto poAttr = m_poGroup->CreateAttribute(
+                osName, {}, GDALExtendedDataType::CreateString());
+            if( poAttr )
+                poAttr->Write(item.Format(CPLJSONObject::PrettyFormat::Plain).c_str());
+        }
+    }
+    m_bModified = false;
+}
+
+/************************************************************************/
+/*                   ZarrAttributeGroup::Serialize()                    */
+/************************************************************************/
+
+CPLJSONObject ZarrAttributeGroup::Serialize() const
+{
+    CPLJSONObject o;
+    for( const auto& poAttr: m_poGroup->GetAttributes() )
+    {
+        const auto& osName = poAttr->GetName();
+        const auto& oType = poAttr->GetDataType();
+        const bool bIsArray = poAttr->GetDimensionCount() == 1;
+        if( oType.GetClass() == GEDTC_STRING )
+        {
+            if( bIsArray )
+            {
+                CPLJSONArray oArray;
+                const auto aosValues = poAttr->ReadAsStringArray();
+                for( int i = 0; i < aosValues.size(); ++i )
+                    oArray.Add(aosValues[i]);
+                o.Add(osName, oArray);
+            }
+            else
+            {
+                const char* pszValue = poAttr->ReadAsString();
+                o.Add(osName, pszValue ? pszValue : "");
+            }
+        }
+        else if( oType.GetClass() == GEDTC_NUMERIC )
+        {
+            const bool bIsInt =
+                !GDALDataTypeIsFloating(oType.GetNumericDataType()) &&
+                !GDALDataTypeIsComplex(oType.GetNumericDataType());
+            if( bIsArray )
+            {
+                CPLJSONArray oArray;
+                for( const double dfVal: poAttr->ReadAsDoubleArray() )
+                {
+                    if( bIsInt )
+                        oArray.Add(static_cast<GInt64>(dfVal));
+                    else
+                        oArray.Add(dfVal);
+                }
+                o.Add(osName, oArray);
+            }
+            else
+            {
+                const double dfVal = poAttr->ReadAsDouble();
+                if( bIsInt )
+                    o.Add(osName, static_cast<GInt64>(dfVal));
+                else
+                    o.Add(osName, dfVal);
+            }
+        }
+    }
+    return o;
+}
+
+/************************************************************************/
+/*                  ZarrAttributeGroup::GetAttribute()                  */
+/************************************************************************/
+
+std::shared_ptr<GDALAttribute> ZarrAttributeGroup::GetAttribute(
+                                        const std::string& osName) const
+{
+    return m_poGroup->GetAttribute(osName);
+}
+
+/************************************************************************/
+/*                 ZarrAttributeGroup::GetAttributes()                  */
+/************************************************************************/
+
+std::vector<std::shared_ptr<GDALAttribute>> ZarrAttributeGroup::GetAttributes(
+                                            CSLConstList papszOptions) const
+{
+    return m_poGroup->GetAttributes(papszOptions);
+}
+
+/************************************************************************/
+/*                 ZarrAttributeGroup::CreateAttribute()                */
+/************************************************************************/
+
+std::shared_ptr<GDALAttribute> ZarrAttributeGroup::CreateAttribute(
+                                    const std::string& osName,
+                                    const std::vector<GUInt64>& anDimensions,
+                                    const GDALExtendedDataType& oDataType,
+                                    CSLConstList papszOptions)
+{
+    if( anDimensions.size() > 1 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Only 0 or 1-dimensional attributes are supported");
+        return nullptr;
+    }
+    if( oDataType.GetClass() == GEDTC_COMPOUND )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Compound attributes are not supported");
+        return nullptr;
+    }
+    auto poAttr = m_poGroup->CreateAttribute(osName, anDimensions, oDataType,
+                                             papszOptions);
+    if( poAttr )
+        m_bModified = true;
+    return poAttr;
+}
@@ -0,0 +1,829 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zarr driver
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "zarr.h"
+
+#include "cpl_minixml.h"
+
+#include <algorithm>
+
+/************************************************************************/
+/*                        ZarrSharedResource()                          */
+/************************************************************************/
+
+ZarrSharedResource::ZarrSharedResource(const std::string& osRootDirectoryName,
+                                       bool bUpdatable):
+    m_osRootDirectoryName(osRootDirectoryName),
+    m_bUpdatable(bUpdatable)
+{
+    // Consolidated metadata is only used in read-only mode, as we do not
+    // update it when writing.
+    if( bUpdatable )
+        return;
+    const std::string osZmetadataFilename(
+        CPLFormFilename(osRootDirectoryName.c_str(), ".zmetadata", nullptr));
+    VSIStatBufL sStat;
+    if( VSIStatL(osZmetadataFilename.c_str(), &sStat) != 0 )
+        return;
+    CPLJSONDocument oDoc;
+    if( !oDoc.Load(osZmetadataFilename) )
+        return;
+    const auto oMetadata = oDoc.GetRoot()["metadata"];
+    if( oMetadata.GetType() != CPLJSONObject::Type::Object )
+        return;
+    // GetObj() would split keys on '/', so iterate over children instead
+    for( const auto& oChild: oMetadata.GetChildren() )
+    {
+        m_oMapConsolidated[oChild.GetName()] = oChild;
+    }
+    m_bHasConsolidated = true;
+}
+
+/************************************************************************/
+/*                       ~ZarrSharedResource()                          */
+/************************************************************************/
+
+ZarrSharedResource::~ZarrSharedResource()
+{
+    GDALMDArrayChunkReader::InvalidateCache(m_osChunkCacheKeyPrefix);
+}
+
+/************************************************************************/
+/*                  ZarrSharedResource::LoadJSON()                      */
+/************************************************************************/
+
+/** Load a .zgroup, .zarray or .zattrs file, from the consolidated metadata
+ * if available, or from the directory otherwise. */
+bool ZarrSharedResource::LoadJSON(const std::string& osDirectoryName,
+                                  const char* pszFilename,
+                                  CPLJSONObject& oObj) const
+{
+    if( m_bHasConsolidated )
+    {
+        std::string osKey;
+        if( osDirectoryName == m_osRootDirectoryName )
+        {
+            osKey = pszFilename;
+        }
+        else if( osDirectoryName.size() > m_osRootDirectoryName.size() &&
+                 osDirectoryName.compare(0, m_osRootDirectoryName.size(),
+                                         m_osRootDirectoryName) == 0 &&
+                 osDirectoryName[m_osRootDirectoryName.size()] == '/' )
+        {
+            osKey = osDirectoryName.substr(m_osRootDirectoryName.size() + 1);
+            osKey += '/';
+            osKey += pszFilename;
+        }
+        const auto oIter = m_oMapConsolidated.find(osKey);
+        if( oIter == m_oMapConsolidated.end() )
+            return false;
+        oObj = oIter->second;
+        return true;
+    }
+
+    const std::string osFilename(
+        CPLFormFilename(osDirectoryName.c_str(), pszFilename, nullptr));
+    VSIStatBufL sStat;
+    if( VSIStatL(osFilename.c_str(), &sStat) != 0 )
+        return false;
+    CPLJSONDocument oDoc;
+    if( !oDoc.Load(osFilename) )
+        return false;
+    oObj = oDoc.GetRoot();
+    return true;
+}
+
+/************************************************************************/
+/*                            ZarrWriteJSON()                           */
+/************************************************************************/
+
+bool ZarrWriteJSON(const std::string& osFilename, const CPLJSONObject& oObj)
+{
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                 osFilename.c_str());
+        return false;
+    }
+    const std::string osContent(
+        oObj.Format(CPLJSONObject::PrettyFormat::Pretty) + '\n');
+    bool bRet = VSIFWriteL(osContent.data(), osContent.size(), 1, fp) == 1;
+    bRet = VSIFCloseL(fp) == 0 && bRet;
+    if( !bRet )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write %s",
+                 osFilename.c_str());
+    }
+    return bRet;
+}
+
+/************************************************************************/
+/*                            ZarrGroup()                               */
+/************************************************************************/
+
+ZarrGroup::ZarrGroup(const std::shared_ptr<ZarrSharedResource>& poSharedResource,
+                     const std::string& osParentName,
+                     const std::string& osName,
+                     const std::string& osDirectoryName):
+    GDALGroup(osParentName, osName),
+    m_poSharedResource(poSharedResource),
+    m_osDirectoryName(osDirectoryName)
+{
+}
+
+/************************************************************************/
+/*                           ~ZarrGroup()                               */
+/************************************************************************/
+
+ZarrGroup::~ZarrGroup()
+{
+    Flush();
+}
+
+/************************************************************************/
+/*                              Init()                                  */
+/************************************************************************/
+
+void ZarrGroup::Init(const CPLJSONObject& oAttributes)
+{
+    m_oAttrGroup.Init(oAttributes);
+}
+
+/************************************************************************/
+/*                          SetSingleArray()                            */
+/************************************************************************/
+
+// Used when the dataset opened is directly an array, and not a group.
+void ZarrGroup::SetSingleArray(const std::string& osArrayName)
+{
+    m_bDirectoryExplored = true;
+    m_aosArrays.push_back(osArrayName);
+}
+
+/************************************************************************/
+/*                              Flush()                                 */
+/************************************************************************/
+
+// Write the attributes of this group, and the pending changes of the
+// arrays and groups already opened, recursively.
+void ZarrGroup::Flush()
+{
+    if( m_oAttrGroup.IsModified() )
+    {
+        m_oAttrGroup.SetModified(false);
+        ZarrWriteJSON(CPLFormFilename(m_osDirectoryName.c_str(), ".zattrs",
+                                      nullptr),
+                      m_oAttrGroup.Serialize());
+    }
+    for( auto& oIter: m_oMapMDArrays )
+        oIter.second->Flush();
+    for( auto& oIter: m_oMapGroups )
+        oIter.second->Flush();
+}
+
+/************************************************************************/
+/*                         ExploreDirectory()                           */
+/************************************************************************/
+
+void ZarrGroup::ExploreDirectory() const
+{
+    if( m_bDirectoryExplored )
+        return;
+    m_bDirectoryExplored = true;
+
+    const auto& osRootDirectoryName = m_poSharedResource->GetRootDirectoryName();
+    if( m_poSharedResource->HasConsolidatedMetadata() )
+    {
+        std::string osPrefix;
+        if( m_osDirectoryName != osRootDirectoryName )
+        {
+            osPrefix = m_osDirectoryName.substr(osRootDirectoryName.size() + 1);
+            osPrefix += '/';
+        }
+        for( const auto& oIter: m_poSharedResource->GetConsolidatedMetadata() )
+        {
+            const auto& osKey = oIter.first;
+            if( osKey.compare(0, osPrefix.size(), osPrefix) != 0 )
+                continue;
+            const auto aosTokens(CPLStringList(CSLTokenizeString2(
+                osKey.c_str() + osPrefix.size(), "/", 0)));
+            if( aosTokens.size() != 2 )
+                continue;
+            if( strcmp(aosTokens[1], ".zarray") == 0 )
+                m_aosArrays.push_back(aosTokens[0]);
+            else if( strcmp(aosTokens[1], ".zgroup") == 0 )
+                m_aosGroups.push_back(aosTokens[0]);
+        }
+        return;
+    }
+
+    const CPLStringList aosFiles(VSIReadDir(m_osDirectoryName.c_str()));
+    for( int i = 0; i < aosFiles.size(); ++i )
+    {
+        if( aosFiles[i][0] == '.' )
+            continue;
+        const std::string osSubDir(
+            CPLFormFilename(m_osDirectoryName.c_str(), aosFiles[i], nullptr));
+        VSIStatBufL sStat;
+        if( VSIStatL(CPLFormFilename(osSubDir.c_str(), ".zarray", nullptr),
+                     &sStat) == 0 )
+        {
+            m_aosArrays.push_back(aosFiles[i]);
+        }
+        else if( VSIStatL(CPLFormFilename(osSubDir.c_str(), ".zgroup", nullptr),
+                          &sStat) == 0 )
+        {
+            m_aosGroups.push_back(aosFiles[i]);
+        }
+    }
+}
+
+/************************************************************************/
+/*                          GetMDArrayNames()                           */
+/************************************************************************/
+
+std::vector<std::string> ZarrGroup::GetMDArrayNames(CSLConstList) const
+{
+    ExploreDirectory();
+    return m_aosArrays;
+}
+
+/************************************************************************/
+/*                           GetGroupNames()                            */
+/************************************************************************/
+
+std::vector<std::string> ZarrGroup::GetGroupNames(CSLConstList) const
+{
+    ExploreDirectory();
+    return m_aosGroups;
+}
+
+/************************************************************************/
+/*                             OpenGroup()                              */
+/************************************************************************/
+
+std::shared_ptr<GDALGroup> ZarrGroup::OpenGroup(const std::string& osName,
+                                                CSLConstList) const
+{
+    const auto oIter = m_oMapGroups.find(osName);
+    if( oIter != m_oMapGroups.end() )
+        return oIter->second;
+
+    ExploreDirectory();
+    if( std::find(m_aosGroups.begin(), m_aosGroups.end(), osName) ==
+                                                        m_aosGroups.end() )
+    {
+        return nullptr;
+    }
+
+    const std::string osSubDir(
+        CPLFormFilename(m_osDirectoryName.c_str(), osName.c_str(), nullptr));
+    CPLJSONObject oAttributes;
+    m_poSharedResource->LoadJSON(osSubDir, ".zattrs", oAttributes);
+    auto poGroup = std::make_shared<ZarrGroup>(
+        m_poSharedResource, GetFullName(), osName, osSubDir);
+    poGroup->Init(oAttributes);
+    m_oMapGroups[osName] = poGroup;
+    return poGroup;
+}
+
+/************************************************************************/
+/*                        GetOrCreateDimension()                        */
+/************************************************************************/
+
+/** Return the dimension of this group of the specified name, creating it
+ * if needed. Returns nullptr if a dimension of the same name but a different
+ * size already exists. */
+std::shared_ptr<GDALDimension> ZarrGroup::GetOrCreateDimension(
+                            const std::string& osName, GUInt64 nSize) const
+{
+    const auto oIter = m_oMapDimensions.find(osName);
+    if( oIter != m_oMapDimensions.end() )
+    {
+        if( oIter->second->GetSize() == nSize )
+            return oIter->second;
+        return nullptr;
+    }
+
+    auto poDim = std::make_shared<GDALDimensionWeakIndexingVar>(
+        GetFullName(), osName, std::string(), std::string(), nSize);
+    // Insert the dimension before loading its indexing variable, as the
+    // latter refers to it.
+    m_oMapDimensions[osName] = poDim;
+
+    ExploreDirectory();
+    if( std::find(m_aosArrays.begin(), m_aosArrays.end(), osName) !=
+                                                    m_aosArrays.end() &&
+        m_oSetArraysInLoading.find(osName) == m_oSetArraysInLoading.end() )
+    {
+        auto poIndexingVar = LoadArray(osName);
+        if( poIndexingVar && poIndexingVar->GetDimensionCount() == 1 &&
+            poIndexingVar->GetDimensions()[0]->GetSize() == nSize )
+        {
+            poDim->SetIndexingVariable(poIndexingVar);
+        }
+    }
+    return poDim;
+}
+
+/************************************************************************/
+/*                           GetDimensions()                            */
+/************************************************************************/
+
+std::vector<std::shared_ptr<GDALDimension>> ZarrGroup::GetDimensions(
+                                                        CSLConstList) const
+{
+    // Dimensions are only known from the arrays that reference them
+    ExploreDirectory();
+    for( const auto& osArrayName: m_aosArrays )
+        LoadArray(osArrayName);
+
+    std::vector<std::shared_ptr<GDALDimension>> oRes;
+    for( const auto& oIter: m_oMapDimensions )
+        oRes.push_back(oIter.second);
+    return oRes;
+}
+
+/************************************************************************/
+/*                            OpenMDArray()                             */
+/************************************************************************/
+
+std::shared_ptr<GDALMDArray> ZarrGroup::OpenMDArray(const std::string& osName,
+                                                    CSLConstList) const
+{
+    ExploreDirectory();
+    if( std::find(m_aosArrays.begin(), m_aosArrays.end(), osName) ==
+                                                        m_aosArrays.end() )
+    {
+        return nullptr;
+    }
+    return LoadArray(osName);
+}
+
+/************************************************************************/
+/*                             LoadArray()                              */
+/************************************************************************/
+
+std::shared_ptr<ZarrArray> ZarrGroup::LoadArray(const std::string& osName) const
+{
+    const auto oIter = m_oMapMDArrays.find(osName);
+    if( oIter != m_oMapMDArrays.end() )
+        return oIter->second;
+    if( m_oSetArraysInLoading.find(osName) != m_oSetArraysInLoading.end() )
+        return nullptr;
+
+    struct SetLoadingRemover
+    {
+        std::set<std::string>& m_oSet;
+        const std::string& m_osName;
+        SetLoadingRemover(std::set<std::string>& oSet,
+                          const std::string& osNameIn):
+            m_oSet(oSet), m_osName(osNameIn)
+        {
+            m_oSet.insert(m_osName);
+        }
+        ~SetLoadingRemover() { m_oSet.erase(m_osName); }
+    };
+    SetLoadingRemover oRemover(m_oSetArraysInLoading, osName);
+
+    const std::string osArrayDir(
+        CPLFormFilename(m_osDirectoryName.c_str(), osName.c_str(), nullptr));
+    CPLJSONObject oZarray;
+    if( !m_poSharedResource->LoadJSON(osArrayDir, ".zarray", oZarray) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Cannot load %s/.zarray", osArrayDir.c_str());
+        return nullptr;
+    }
+    CPLJSONObject oAttributes;
+    m_poSharedResource->LoadJSON(osArrayDir, ".zattrs", oAttributes);
+
+    if( oZarray.GetInteger("zarr_format") != 2 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s: only zarr_format = 2 is supported",
+                 osArrayDir.c_str());
+        return nullptr;
+    }
+
+    const auto oShape = oZarray.GetArray("shape");
+    const auto oChunks = oZarray.GetArray("chunks");
+    if( !oShape.IsValid() || !oChunks.IsValid() ||
+        oShape.Size() != oChunks.Size() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s: invalid shape and/or chunks", osArrayDir.c_str());
+        return nullptr;
+    }
+    const int nDims = oShape.Size();
+    std::vector<GUInt64> anShape;
+    std::vector<GUInt64> anBlockSize;
+    for( int i = 0; i < nDims; ++i )
+    {
+        const GInt64 nSize = oShape[i].ToLong(-1);
+        const GInt64 nChunk = oChunks[i].ToLong(-1);
+        if( nSize < 0 || nChunk <= 0 )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "%s: invalid shape and/or chunks", osArrayDir.c_str());
+            return nullptr;
+        }
+        anShape.push_back(static_cast<GUInt64>(nSize));
+        anBlockSize.push_back(static_cast<GUInt64>(nChunk));
+    }
+
+    if( oZarray.GetString("order", "C") != "C" )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s: only order = C is supported", osArrayDir.c_str());
+        return nullptr;
+    }
+
+    ZarrDataTypeInfo oDTInfo;
+    const auto oDType = oZarray["dtype"];
+    if( oDType.GetType() != CPLJSONObject::Type::String ||
+        !ZarrDataTypeInfo::Parse(oDType.ToString(), oDTInfo) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s: unsupported dtype %s", osArrayDir.c_str(),
+                 oDType.Format(CPLJSONObject::PrettyFormat::Plain).c_str());
+        return nullptr;
+    }
+
+    // Dimension names follow the convention of xarray
+    std::vector<std::string> aosDimNames;
+    const auto oArrayDims = oAttributes.GetArray("_ARRAY_DIMENSIONS");
+    if( oArrayDims.IsValid() && oArrayDims.Size() == nDims )
+    {
+        for( const auto& oDimName: oArrayDims )
+        {
+            if( oDimName.GetType() != CPLJSONObject::Type::String )
+            {
+                aosDimNames.clear();
+                break;
+            }
+            aosDimNames.push_back(oDimName.ToString());
+        }
+    }
+
+    std::vector<std::shared_ptr<GDALDimension>> aoDims;
+    const std::string osArrayFullName(
+        (GetFullName() == "/" ? std::string() : GetFullName()) + "/" + osName);
+    for( int i = 0; i < nDims; ++i )
+    {
+        std::shared_ptr<GDALDimension> poDim;
+        if( !aosDimNames.empty() )
+            poDim = GetOrCreateDimension(aosDimNames[i], anShape[i]);
+        if( !poDim )
+        {
+            poDim = std::make_shared<GDALDimension>(
+                osArrayFullName,
+                aosDimNames.empty() ? CPLSPrintf("dim%d", i) :
+                                      aosDimNames[i].c_str(),
+                std::string(), std::string(), anShape[i]);
+        }
+        aoDims.push_back(poDim);
+    }
+
+    auto poArray = ZarrArray::Create(m_poSharedResource, GetFullName(), osName,
+                                     aoDims,
+                                     GDALExtendedDataType::Create(oDTInfo.eDT),
+                                     oDTInfo, anBlockSize, osArrayDir);
+    if( !poArray->ParseCodecs(oZarray) )
+        return nullptr;
+    poArray->InitAttributes(oAttributes);
+    m_oMapMDArrays[osName] = poArray;
+    return poArray;
+}
+
+/************************************************************************/
+/*                           GetAttribute()                             */
+/************************************************************************/
+
+std::shared_ptr<GDALAttribute> ZarrGroup::GetAttribute(
+                                            const std::string& osName) const
+{
+    return m_oAttrGroup.GetAttribute(osName);
+}
+
+/************************************************************************/
+/*                           GetAttributes()                            */
+/************************************************************************/
+
+std::vector<std::shared_ptr<GDALAttribute>> ZarrGroup::GetAttributes(
+                                            CSLConstList papszOptions) const
+{
+    return m_oAttrGroup.GetAttributes(papszOptions);
+}
+
+/************************************************************************/
+/*                          CreateAttribute()                           */
+/************************************************************************/
+
+std::shared_ptr<GDALAttribute> ZarrGroup::CreateAttribute(
+                                    const std::string& osName,
+                                    const std::vector<GUInt64>& anDimensions,
+                                    const GDALExtendedDataType& oDataType,
+                                    CSLConstList papszOptions)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return nullptr;
+    }
+    return m_oAttrGroup.CreateAttribute(osName, anDimensions, oDataType,
+                                        papszOptions);
+}
+
+/************************************************************************/
+/*                            CreateGroup()                             */
+/************************************************************************/
+
+std::shared_ptr<GDALGroup> ZarrGroup::CreateGroup(const std::string& osName,
+                                                  CSLConstList)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return nullptr;
+    }
+    if( osName.empty() || osName[0] == '.' ||
+        osName.find('/') != std::string::npos ||
+        osName.find('\\') != std::string::npos )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported, "Invalid group name");
+        return nullptr;
+    }
+    ExploreDirectory();
+    if( std::find(m_aosGroups.begin(), m_aosGroups.end(), osName) !=
+                                                    m_aosGroups.end() ||
+        std::find(m_aosArrays.begin(), m_aosArrays.end(), osName) !=
+                                                    m_aosArrays.end() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "A group or array with same name already exists");
+        return nullptr;
+    }
+
+    const std::string osSubDir(
+        CPLFormFilename(m_osDirectoryName.c_str(), osName.c_str(), nullptr));
+    if( VSIMkdir(osSubDir.c_str(), 0755) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create directory %s",
+                 osSubDir.c_str());
+        return nullptr;
+    }
+    CPLJSONObject oZgroup;
+    oZgroup.Add("zarr_format", 2);
+    if( !ZarrWriteJSON(CPLFormFilename(osSubDir.c_str(), ".zgroup", nullptr),
+                       oZgroup) )
+    {
+        return nullptr;
+    }
+
+    auto poGroup = std::make_shared<ZarrGroup>(
+        m_poSharedResource, GetFullName(), osName, osSubDir);
+    m_aosGroups.push_back(osName);
+    m_oMapGroups[osName] = poGroup;
+    return poGroup;
+}
+
+/************************************************************************/
+/*                          CreateDimension()                           */
+/************************************************************************/
+
+std::shared_ptr<GDALDimension> ZarrGroup::CreateDimension(
+                                            const std::string& osName,
+                                            const std::string& osType,
+                                            const std::string& osDirection,
+                                            GUInt64 nSize,
+                                            CSLConstList)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return nullptr;
+    }
+    if( osName.empty() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Empty dimension name not supported");
+        return nullptr;
+    }
+    if( m_oMapDimensions.find(osName) != m_oMapDimensions.end() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "A dimension with same name already exists");
+        return nullptr;
+    }
+    auto poDim = std::make_shared<GDALDimensionWeakIndexingVar>(
+        GetFullName(), osName, osType, osDirection, nSize);
+    m_oMapDimensions[osName] = poDim;
+    return poDim;
+}
+
+/************************************************************************/
+/*                           CreateMDArray()                            */
+/************************************************************************/
+
+std::shared_ptr<GDALMDArray> ZarrGroup::CreateMDArray(
+                const std::string& osName,
+                const std::vector<std::shared_ptr<GDALDimension>>& aoDimensions,
+                const GDALExtendedDataType& oDataType,
+                CSLConstList papszOptions)
+{
+    if( !m_poSharedResource->IsUpdatable() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Dataset not open in update mode");
+        return nullptr;
+    }
+    if( osName.empty() || osName[0] == '.' ||
+        osName.find('/') != std::string::npos ||
+        osName.find('\\') != std::string::npos )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported, "Invalid array name");
+        return nullptr;
+    }
+    ExploreDirectory();
+    if( std::find(m_aosGroups.begin(), m_aosGroups.end(), osName) !=
+                                                    m_aosGroups.end() ||
+        std::find(m_aosArrays.begin(), m_aosArrays.end(), osName) !=
+                                                    m_aosArrays.end() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "A group or array with same name already exists");
+        return nullptr;
+    }
+
+    ZarrDataTypeInfo oDTInfo;
+    if( oDataType.GetClass() != GEDTC_NUMERIC ||
+        !ZarrDataTypeInfo::FromGDALDataType(oDataType.GetNumericDataType(),
+                                            oDTInfo) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported data type");
+        return nullptr;
+    }
+
+    const size_t nDims = aoDimensions.size();
+    std::vector<GUInt64> anBlockSize(nDims, 1);
+    const char* pszBlockSize = CSLFetchNameValue(papszOptions, "BLOCKSIZE");
+    if( pszBlockSize )
+    {
+        const auto aszTokens(CPLStringList(CSLTokenizeString2(pszBlockSize, ",", 0)));
+        if( static_cast<size_t>(aszTokens.size()) != nDims )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Invalid number of values in BLOCKSIZE");
+            return nullptr;
+        }
+        for( size_t i = 0; i < nDims; ++i )
+        {
+            anBlockSize[i] = static_cast<GUInt64>(CPLAtoGIntBig(aszTokens[i]));
+            if( anBlockSize[i] == 0 )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Values in BLOCKSIZE should be > 0");
+                return nullptr;
+            }
+        }
+    }
+    else if( nDims >= 1 )
+    {
+        // Default to 256x256 chunks on the 2 fastest varying dimensions
+        for( size_t i = nDims >= 2 ? nDims - 2 : 0; i < nDims; ++i )
+            anBlockSize[i] = std::max<GUInt64>(1,
+                std::min<GUInt64>(256, aoDimensions[i]->GetSize()));
+    }
+    GUInt64 nChunkBytes = oDTInfo.nNativeSize;
+    for( const auto nBlockSize: anBlockSize )
+    {
+        if( nBlockSize > std::numeric_limits<GUInt64>::max() / nChunkBytes ||
+            nChunkBytes * nBlockSize > static_cast<GUInt64>(INT_MAX) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Too large chunk size");
+            return nullptr;
+        }
+        nChunkBytes *= nBlockSize;
+    }
+
+    const std::string osSubDir(
+        CPLFormFilename(m_osDirectoryName.c_str(), osName.c_str(), nullptr));
+    if( VSIMkdir(osSubDir.c_str(), 0755) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create directory %s",
+                 osSubDir.c_str());
+        return nullptr;
+    }
+
+    auto poArray = ZarrArray::Create(m_poSharedResource, GetFullName(), osName,
+                                     aoDimensions, oDataType, oDTInfo,
+                                     anBlockSize, osSubDir);
+
+    const char* pszCompress = CSLFetchNameValueDef(papszOptions, "COMPRESS", "NONE");
+    if( !EQUAL(pszCompress, "NONE") )
+    {
+        const CPLString osId(CPLString(pszCompress).tolower());
+        const CPLCompressor* psCompressor = CPLGetCompressor(osId.c_str());
+        if( psCompressor == nullptr || psCompressor->eType != CCT_COMPRESSOR )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Unsupported value for COMPRESS: %s", pszCompress);
+            return nullptr;
+        }
+
+        // Integer options of the compressor are set from the
+        // <COMPRESS>_<OPTION> creation options, or their default value.
+        CPLJSONObject oCompressor;
+        oCompressor.Add("id", osId);
+        CPLXMLTreeCloser oTree(CPLParseXMLString(CSLFetchNameValueDef(
+            psCompressor->papszMetadata, "OPTIONS", "<Options/>")));
+        const CPLXMLNode* psOptions = oTree.get() ?
+            CPLGetXMLNode(oTree.get(), "=Options") : nullptr;
+        for( const CPLXMLNode* psIter = psOptions ? psOptions->psChild : nullptr;
+             psIter; psIter = psIter->psNext )
+        {
+            if( psIter->eType != CXT_Element ||
+                !EQUAL(CPLGetXMLValue(psIter, "type", ""), "int") )
+                continue;
+            const char* pszName = CPLGetXMLValue(psIter, "name", "");
+            const char* pszDefault = CPLGetXMLValue(psIter, "default", nullptr);
+            const char* pszValue = CSLFetchNameValueDef(papszOptions,
+                (CPLString(pszCompress).toupper() + "_" + pszName).c_str(),
+                pszDefault);
+            // Backward compatible name of ZLIB_LEVEL
+            if( osId == "zlib" && EQUAL(pszName, "LEVEL") )
+                pszValue = CSLFetchNameValueDef(papszOptions, "ZLEVEL",
+                                                pszValue);
+            if( pszValue )
+                oCompressor.Add(CPLString(pszName).tolower(), atoi(pszValue));
+        }
+        if( osId == "lzma" )
+        {
+            // Default values of the numcodecs LZMA codec
+            oCompressor.Add("format", 1);
+            oCompressor.Add("check", -1);
+            oCompressor.AddNull("filters");
+        }
+        if( !poArray->SetCompressor(oCompressor) )
+            return nullptr;
+    }
+    if( CPLTestBool(CSLFetchNameValueDef(papszOptions, "SHUFFLE", "NO")) )
+        poArray->SetShuffleEltSize(oDTInfo.nNativeSize);
+    const char* pszDimSeparator =
+        CSLFetchNameValueDef(papszOptions, "DIM_SEPARATOR", ".");
+    if( strcmp(pszDimSeparator, ".") != 0 && strcmp(pszDimSeparator, "/") != 0 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "DIM_SEPARATOR should be . or /");
+        return nullptr;
+    }
+    poArray->SetDimSeparator(pszDimSeparator);
+    poArray->SetDefinitionModified();
+    if( !poArray->Flush() )
+        return nullptr;
+
+    m_aosArrays.push_back(osName);
+    m_oMapMDArrays[osName] = poArray;
+
+    // Link the array to the dimension of the same name
+    if( nDims == 1 && aoDimensions[0]->GetName() == osName )
+    {
+        auto poDim = std::dynamic_pointer_cast<GDALDimensionWeakIndexingVar>(
+                                                            aoDimensions[0]);
+        if( poDim )
+            poDim->SetIndexingVariable(poArray);
+    }
+    return poArray;
+}
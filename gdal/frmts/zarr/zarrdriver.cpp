@@ -0,0 +1,377 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zarr driver
+ * Author:   Even Rouault, <even dot rouault at spatialys.com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault <even dot rouault at spatialys.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "zarr.h"
+
+#include "cpl_minixml.h"
+
+#include <algorithm>
+
+extern "C" void GDALRegister_Zarr();
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                            ZarrDataset()                             */
+/************************************************************************/
+
+ZarrDataset::ZarrDataset(const std::shared_ptr<GDALGroup>& poRootGroup):
+    m_poRootGroup(poRootGroup)
+{
+}
+
+/************************************************************************/
+/*                           ~ZarrDataset()                             */
+/************************************************************************/
+
+ZarrDataset::~ZarrDataset()
+{
+    // Arrays and groups may outlive the dataset, but make sure that their
+    // metadata is written when it is closed.
+    auto poZarrGroup = std::dynamic_pointer_cast<ZarrGroup>(m_poRootGroup);
+    if( poZarrGroup )
+        poZarrGroup->Flush();
+}
+
+/************************************************************************/
+/*                              Identify()                              */
+/************************************************************************/
+
+int ZarrDataset::Identify( GDALOpenInfo * poOpenInfo )
+{
+    if( STARTS_WITH_CI(poOpenInfo->pszFilename, "ZARR:") )
+        return TRUE;
+    if( !poOpenInfo->bIsDirectory )
+        return FALSE;
+
+    VSIStatBufL sStat;
+    for( const char* pszFilename: { ".zarray", ".zgroup", ".zmetadata" } )
+    {
+        if( VSIStatL(CPLFormFilename(poOpenInfo->pszFilename, pszFilename,
+                                     nullptr), &sStat) == 0 )
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                           GetMetadata()                              */
+/************************************************************************/
+
+char** ZarrDataset::GetMetadata(const char* pszDomain)
+{
+    if( pszDomain != nullptr && EQUAL(pszDomain, "SUBDATASETS") )
+        return m_aosSubdatasets.List();
+    return GDALDataset::GetMetadata(pszDomain);
+}
+
+/************************************************************************/
+/*                           ExploreGroup()                             */
+/************************************************************************/
+
+// Collect the arrays of at least 2 dimensions, recursively.
+static void ExploreGroup(const std::shared_ptr<GDALGroup>& poGroup,
+                         std::vector<std::shared_ptr<GDALMDArray>>& apoArrays)
+{
+    for( const auto& osName: poGroup->GetMDArrayNames() )
+    {
+        auto poArray = poGroup->OpenMDArray(osName);
+        if( poArray && poArray->GetDimensionCount() >= 2 )
+            apoArrays.emplace_back(poArray);
+    }
+    for( const auto& osName: poGroup->GetGroupNames() )
+    {
+        auto poSubGroup = poGroup->OpenGroup(osName);
+        if( poSubGroup )
+            ExploreGroup(poSubGroup, apoArrays);
+    }
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+GDALDataset* ZarrDataset::Open(GDALOpenInfo* poOpenInfo)
+{
+    if( !Identify(poOpenInfo) )
+        return nullptr;
+
+    // Syntax is ZARR:"/path/to/dir":/path/to/array
+    std::string osFilename(poOpenInfo->pszFilename);
+    std::string osArrayFullName;
+    if( STARTS_WITH_CI(poOpenInfo->pszFilename, "ZARR:") )
+    {
+        osFilename = poOpenInfo->pszFilename + strlen("ZARR:");
+        if( !osFilename.empty() && osFilename[0] == '"' )
+        {
+            const auto nPos = osFilename.find('"', 1);
+            if( nPos == std::string::npos )
+                return nullptr;
+            const std::string osRemaining(osFilename.substr(nPos + 1));
+            osFilename = osFilename.substr(1, nPos - 1);
+            if( !osRemaining.empty() )
+            {
+                if( osRemaining[0] != ':' )
+                    return nullptr;
+                osArrayFullName = osRemaining.substr(1);
+            }
+        }
+    }
+    while( osFilename.size() > 1 && osFilename.back() == '/' )
+        osFilename.resize(osFilename.size() - 1);
+
+    VSIStatBufL sStat;
+    if( VSIStatL(osFilename.c_str(), &sStat) != 0 || !VSI_ISDIR(sStat.st_mode) )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed,
+                 "%s is not a directory", osFilename.c_str());
+        return nullptr;
+    }
+
+    const bool bUpdate = poOpenInfo->eAccess == GA_Update;
+    std::shared_ptr<ZarrSharedResource> poSharedResource;
+    std::shared_ptr<ZarrGroup> poRG;
+    if( VSIStatL(CPLFormFilename(osFilename.c_str(), ".zarray", nullptr),
+                 &sStat) == 0 )
+    {
+        // The dataset is directly an array: expose it in a root group
+        // pointing to its parent directory.
+        const std::string osParentDir(CPLGetPath(osFilename.c_str()));
+        poSharedResource = std::make_shared<ZarrSharedResource>(
+            osParentDir, bUpdate);
+        poRG = std::make_shared<ZarrGroup>(
+            poSharedResource, std::string(), "/", osParentDir);
+        poRG->SetSingleArray(CPLGetFilename(osFilename.c_str()));
+    }
+    else
+    {
+        poSharedResource = std::make_shared<ZarrSharedResource>(
+            osFilename, bUpdate);
+        poRG = std::make_shared<ZarrGroup>(
+            poSharedResource, std::string(), "/", osFilename);
+        CPLJSONObject oAttributes;
+        poSharedResource->LoadJSON(osFilename, ".zattrs", oAttributes);
+        poRG->Init(oAttributes);
+    }
+
+    if( (poOpenInfo->nOpenFlags & GDAL_OF_MULTIDIM_RASTER) != 0 )
+    {
+        auto poDS = new ZarrDataset(poRG);
+        poDS->SetDescription(poOpenInfo->pszFilename);
+        return poDS;
+    }
+
+    // Classic raster view
+    std::shared_ptr<GDALMDArray> poArray;
+    if( !osArrayFullName.empty() )
+    {
+        poArray = poRG->OpenMDArrayFromFullname(osArrayFullName);
+        if( poArray == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot find array %s", osArrayFullName.c_str());
+            return nullptr;
+        }
+        if( poArray->GetDimensionCount() < 2 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Array %s has less than 2 dimensions",
+                     osArrayFullName.c_str());
+            return nullptr;
+        }
+    }
+    else
+    {
+        std::vector<std::shared_ptr<GDALMDArray>> apoArrays;
+        ExploreGroup(poRG, apoArrays);
+        if( apoArrays.empty() )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "No array of at least 2 dimensions found");
+            return nullptr;
+        }
+        if( apoArrays.size() > 1 )
+        {
+            auto poDS = new ZarrDataset(poRG);
+            poDS->SetDescription(poOpenInfo->pszFilename);
+            int iSubDS = 1;
+            for( const auto& poSubArray: apoArrays )
+            {
+                std::string osDim;
+                for( const auto& poDim: poSubArray->GetDimensions() )
+                {
+                    if( !osDim.empty() )
+                        osDim += 'x';
+                    osDim += CPLSPrintf(CPL_FRMT_GUIB,
+                        static_cast<GUIntBig>(poDim->GetSize()));
+                }
+                poDS->m_aosSubdatasets.SetNameValue(
+                    CPLSPrintf("SUBDATASET_%d_NAME", iSubDS),
+                    CPLSPrintf("ZARR:\"%s\":%s", osFilename.c_str(),
+                               poSubArray->GetFullName().c_str()));
+                poDS->m_aosSubdatasets.SetNameValue(
+                    CPLSPrintf("SUBDATASET_%d_DESC", iSubDS),
+                    CPLSPrintf("[%s] %s (%s)", osDim.c_str(),
+                               poSubArray->GetFullName().c_str(),
+                               GDALGetDataTypeName(poSubArray->GetDataType().
+                                                   GetNumericDataType())));
+                ++iSubDS;
+            }
+            return poDS;
+        }
+        poArray = apoArrays[0];
+    }
+
+    const size_t nDims = poArray->GetDimensionCount();
+    GDALDataset* poDS = poArray->AsClassicDataset(nDims - 1, nDims - 2);
+    if( poDS )
+        poDS->SetDescription(poOpenInfo->pszFilename);
+    return poDS;
+}
+
+/************************************************************************/
+/*                       CreateMultiDimensional()                       */
+/************************************************************************/
+
+GDALDataset* ZarrDataset::CreateMultiDimensional(const char * pszFilename,
+                                                 CSLConstList /*papszRootGroupOptions*/,
+                                                 CSLConstList /*papszOptions*/)
+{
+    if( VSIMkdir(pszFilename, 0755) != 0 )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL(pszFilename, &sStat) == 0 )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "%s already exists", pszFilename);
+        }
+        else
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot create directory %s", pszFilename);
+        }
+        return nullptr;
+    }
+
+    CPLJSONObject oZgroup;
+    oZgroup.Add("zarr_format", 2);
+    if( !ZarrWriteJSON(CPLFormFilename(pszFilename, ".zgroup", nullptr),
+                       oZgroup) )
+    {
+        return nullptr;
+    }
+
+    auto poSharedResource = std::make_shared<ZarrSharedResource>(
+        pszFilename, true);
+    auto poRG = std::make_shared<ZarrGroup>(
+        poSharedResource, std::string(), "/", pszFilename);
+    auto poDS = new ZarrDataset(poRG);
+    poDS->SetDescription(pszFilename);
+    return poDS;
+}
+
+/************************************************************************/
+/*                         GDALRegister_Zarr()                          */
+/************************************************************************/
+
+void GDALRegister_Zarr()
+
+{
+    if( GDALGetDriverByName( "Zarr" ) != nullptr )
+        return;
+
+    GDALDriver *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "Zarr" );
+    poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_MULTIDIM_RASTER, "YES" );
+    poDriver->SetMetadataItem( GDAL_DCAP_CREATE_MULTIDIMENSIONAL, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Zarr" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drivers/raster/zarr.html" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "YES" );
+
+    // The list of compressors, and their options, depends on the ones
+    // available in the CPL compressor registry.
+    CPLString osCompressValues;
+    CPLString osCompressOptions;
+    for( const char* pszId: { "zlib", "gzip", "lzma", "zstd", "lz4" } )
+    {
+        const CPLCompressor* psCompressor = CPLGetCompressor(pszId);
+        if( psCompressor == nullptr )
+            continue;
+        const CPLString osId(CPLString(pszId).toupper());
+        osCompressValues += "     <Value>" + osId + "</Value>";
+        CPLXMLTreeCloser oTree(CPLParseXMLString(CSLFetchNameValueDef(
+            psCompressor->papszMetadata, "OPTIONS", "<Options/>")));
+        const CPLXMLNode* psOptions = oTree.get() ?
+            CPLGetXMLNode(oTree.get(), "=Options") : nullptr;
+        for( const CPLXMLNode* psIter = psOptions ? psOptions->psChild : nullptr;
+             psIter; psIter = psIter->psNext )
+        {
+            if( psIter->eType != CXT_Element ||
+                !EQUAL(CPLGetXMLValue(psIter, "type", ""), "int") )
+                continue;
+            osCompressOptions += CPLSPrintf(
+                "   <Option name='%s_%s' type='int' "
+                "description='%s compression: %s' default='%s'/>",
+                osId.c_str(), CPLGetXMLValue(psIter, "name", ""),
+                osId.c_str(), CPLGetXMLValue(psIter, "description", ""),
+                CPLGetXMLValue(psIter, "default", ""));
+        }
+    }
+
+    poDriver->SetMetadataItem(GDAL_DMD_MULTIDIM_ARRAY_CREATIONOPTIONLIST,
+("<MultiDimArrayCreationOptionList>"
+"   <Option name='BLOCKSIZE' type='string' "
+        "description='Chunk size, as a comma separated list of values "
+        "for each dimension'/>"
+"   <Option name='COMPRESS' type='string-select' default='NONE'>"
+"     <Value>NONE</Value>" +
+    osCompressValues +
+"   </Option>"
+"   <Option name='ZLEVEL' type='int' description='ZLIB compression level 1-9' "
+        "default='6'/>" +
+    osCompressOptions +
+"   <Option name='SHUFFLE' type='boolean' description='Whether to apply the "
+        "shuffle filter before compression' default='NO'/>"
+"   <Option name='DIM_SEPARATOR' type='string-select' default='.'>"
+"     <Value>.</Value>"
+"     <Value>/</Value>"
+"   </Option>"
+"</MultiDimArrayCreationOptionList>").c_str() );
+
+    poDriver->pfnIdentify = ZarrDataset::Identify;
+    poDriver->pfnOpen = ZarrDataset::Open;
+    poDriver->pfnCreateMultiDimensional = ZarrDataset::CreateMultiDimensional;
+
+    GetGDALDriverManager()->RegisterDriver( poDriver );
+}
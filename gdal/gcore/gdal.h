@@ -779,6 +779,11 @@ CPLErr CPL_DLL CPL_STDCALL GDALDatasetAdviseRead( GDALDatasetH hDS,
     int nBXSize, int nBYSize, GDALDataType eBDataType,
     int nBandCount, int *panBandCount, CSLConstList papszOptions );
 
+CPLErr CPL_DLL GDALDatasetSamplePoints( GDALDatasetH hDS, size_t nPoints,
+    const double* padfX, const double* padfY,
+    int nBandCount, const int* panBandList, GDALRIOResampleAlg eResampleAlg,
+    double* padfValues, int* pabValid, CSLConstList papszOptions );
+
 const char CPL_DLL * CPL_STDCALL GDALGetProjectionRef( GDALDatasetH );
 OGRSpatialReferenceH CPL_DLL GDALGetSpatialRef( GDALDatasetH );
 CPLErr CPL_DLL CPL_STDCALL GDALSetProjection( GDALDatasetH, const char * );
@@ -911,6 +916,10 @@ CPLErr CPL_DLL CPL_STDCALL GDALRasterAdviseRead( GDALRasterBandH hRB,
     int nDSXOff, int nDSYOff, int nDSXSize, int nDSYSize,
     int nBXSize, int nBYSize, GDALDataType eBDataType, CSLConstList papszOptions );
 
+CPLErr CPL_DLL GDALRasterSamplePoints( GDALRasterBandH hBand, size_t nPoints,
+    const double* padfX, const double* padfY, GDALRIOResampleAlg eResampleAlg,
+    double* padfValues, int* pabValid, CSLConstList papszOptions );
+
 CPLErr CPL_DLL CPL_STDCALL
 GDALRasterIO( GDALRasterBandH hRBand, GDALRWFlag eRWFlag,
               int nDSXOff, int nDSYOff, int nDSXSize, int nDSYSize,
@@ -1387,6 +1396,12 @@ GIntBig CPL_DLL CPL_STDCALL GDALGetCacheUsed64(void);
 
 int CPL_DLL CPL_STDCALL GDALFlushCacheBlock(void);
 
+char CPL_DLL ** GDALGetRuntimeStatistics(void) CPL_WARN_UNUSED_RESULT;
+char CPL_DLL ** GDALDatasetGetRuntimeStatistics(GDALDatasetH hDS)
+                                                    CPL_WARN_UNUSED_RESULT;
+char CPL_DLL ** GDALGetDriverRuntimeStatistics(GDALDriverH hDriver)
+                                                    CPL_WARN_UNUSED_RESULT;
+
 /* ==================================================================== */
 /*      GDAL virtual memory                                             */
 /* ==================================================================== */
@@ -204,6 +204,7 @@ void CPL_DLL GDALRegister_HEIF(void);
 void CPL_DLL GDALRegister_TGA(void);
 void CPL_DLL GDALRegister_OGCAPI(void);
 void CPL_DLL GDALRegister_STACTA(void);
+void CPL_DLL GDALRegister_Zarr(void);
 CPL_C_END
 
 #endif /* ndef GDAL_FRMTS_H_INCLUDED */
@@ -54,6 +54,7 @@
 #include "gdal.h"
 #include "gdal_mdreader.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "ogr_core.h"
 #include "ogr_spatialref.h"
 #include "ogr_geos.h"
@@ -1329,8 +1330,8 @@ CPLString GDALFindAssociatedFile( const char *pszBaseFilename,
     }
     else
     {
-        const int iSibling = CSLFindString( papszSiblingFiles,
-                                            CPLGetFilename(osTarget) );
+        const int iSibling = GDALFindSiblingFile( papszSiblingFiles,
+                                                  CPLGetFilename(osTarget) );
         if( iSibling < 0 )
             return "";
 
@@ -1783,7 +1784,8 @@ int GDALReadTabFile2( const char * pszBaseFilename,
 
     if (papszSiblingFiles && GDALCanReliablyUseSiblingFileList(pszTAB))
     {
-        int iSibling = CSLFindString(papszSiblingFiles, CPLGetFilename(pszTAB));
+        int iSibling =
+            GDALFindSiblingFile(papszSiblingFiles, CPLGetFilename(pszTAB));
         if (iSibling >= 0)
         {
             CPLString osTabFilename = pszBaseFilename;
@@ -2035,7 +2037,7 @@ int GDALReadWorldFile2( const char *pszBaseFilename, const char *pszExtension,
     if (papszSiblingFiles && GDALCanReliablyUseSiblingFileList(pszTFW))
     {
         const int iSibling =
-            CSLFindString(papszSiblingFiles, CPLGetFilename(pszTFW));
+            GDALFindSiblingFile(papszSiblingFiles, CPLGetFilename(pszTFW));
         if (iSibling >= 0)
         {
             CPLString osTFWFilename = pszBaseFilename;
@@ -4154,3 +4156,165 @@ double GDALAdjustNoDataCloseToFloatMax(double dfVal)
         return kMaxFloat;
     return dfVal;
 }
+
+/************************************************************************/
+/*                      GDALGetRuntimeStatistics()                      */
+/************************************************************************/
+
+/**
+ * \brief Return process-wide statistics on caches and thread pools.
+ *
+ * The returned list contains NAME=VALUE pairs. The counters are cumulated
+ * since the start of the process. The following items are returned:
+ * <ul>
+ * <li>BLOCK_CACHE_HITS: number of block requests served by the raster block
+ * cache.</li>
+ * <li>BLOCK_CACHE_MISSES: number of block requests that required a new block
+ * to be instantiated (and generally read from its dataset).</li>
+ * <li>BLOCK_CACHE_EVICTIONS: number of unmodified blocks discarded to keep
+ * the block cache below GDAL_CACHEMAX. Modified blocks discarded for the same
+ * reason are counted in BLOCK_CACHE_DIRTY_FLUSHES.</li>
+ * <li>BLOCK_CACHE_DIRTY_FLUSHES: number of modified blocks written back to
+ * their dataset.</li>
+ * <li>BLOCK_CACHE_USED and BLOCK_CACHE_MAX: current size and maximum size of
+ * the block cache, in bytes.</li>
+ * <li>BLOCK_CACHE_RECYCLED_BUFFERS: cumulated size, in bytes, of the buffers
+ * of discarded blocks kept for reuse by next blocks of the same size. This
+ * size counts with BLOCK_CACHE_USED against BLOCK_CACHE_MAX.</li>
+ * <li>VSICURL_REGION_CACHE_HITS and VSICURL_REGION_CACHE_MISSES: number of
+ * reads of /vsicurl/ (and related file systems) served from the cache of
+ * downloaded regions, or that required a download.</li>
+ * <li>PROXY_POOL_HITS: number of accesses to a proxy pool dataset (for example
+ * VRT sources) served by an already opened dataset.</li>
+ * <li>PROXY_POOL_OPENS: number of datasets (re)opened by the proxy pool.</li>
+ * <li>PROXY_POOL_EVICTIONS: number of datasets closed to make room for another
+ * one, because GDAL_MAX_DATASET_POOL_SIZE was reached. A high value compared to
+ * PROXY_POOL_OPENS indicates that the pool is too small.</li>
+ * <li>OGR_CT_CACHE_HITS and OGR_CT_CACHE_MISSES: number of coordinate
+ * transformations instantiated from the cache of previously created ones, or
+ * created from scratch.</li>
+ * <li>THREAD_POOL_THREADS: number of threads of the global thread pool (used
+ * for example by the GTiff driver for multi-threaded compression).</li>
+ * <li>THREAD_POOL_QUEUED_JOBS: number of jobs of the global thread pool not
+ * yet started.</li>
+ * <li>THREAD_POOL_COMPLETED_JOBS: number of jobs run by the global thread
+ * pool.</li>
+ * <li>THREAD_POOL_BUSY_TIME_US: cumulated time, in microseconds, spent by the
+ * threads of the global thread pool in running jobs.</li>
+ * </ul>
+ *
+ * @return a list of NAME=VALUE pairs to free with CSLDestroy().
+ *
+ * @see GDALDatasetGetRuntimeStatistics(), GDALGetDriverRuntimeStatistics()
+ * @since GDAL 3.4
+ */
+
+char** GDALGetRuntimeStatistics()
+{
+    CPLStringList aosList;
+    aosList.Assign(GDALGetBlockCacheCounters().AppendTo(nullptr), true);
+    aosList.SetNameValue("BLOCK_CACHE_USED",
+                         CPLSPrintf(CPL_FRMT_GIB, GDALGetCacheUsed64()));
+    aosList.SetNameValue("BLOCK_CACHE_MAX",
+                         CPLSPrintf(CPL_FRMT_GIB, GDALGetCacheMax64()));
+    aosList.SetNameValue("BLOCK_CACHE_RECYCLED_BUFFERS",
+                         CPLSPrintf(CPL_FRMT_GIB,
+                                    GDALRasterBlock::GetRecycledBuffersSize()));
+
+    GIntBig nHits = 0;
+    GIntBig nMisses = 0;
+    VSICurlGetRegionCacheStatistics(&nHits, &nMisses);
+    aosList.SetNameValue("VSICURL_REGION_CACHE_HITS",
+                         CPLSPrintf(CPL_FRMT_GIB, nHits));
+    aosList.SetNameValue("VSICURL_REGION_CACHE_MISSES",
+                         CPLSPrintf(CPL_FRMT_GIB, nMisses));
+
+    GIntBig nOpens = 0;
+    GIntBig nEvictions = 0;
+    GDALProxyPoolGetStatistics(&nHits, &nOpens, &nEvictions);
+    aosList.SetNameValue("PROXY_POOL_HITS", CPLSPrintf(CPL_FRMT_GIB, nHits));
+    aosList.SetNameValue("PROXY_POOL_OPENS", CPLSPrintf(CPL_FRMT_GIB, nOpens));
+    aosList.SetNameValue("PROXY_POOL_EVICTIONS",
+                         CPLSPrintf(CPL_FRMT_GIB, nEvictions));
+
+    OCTGetCacheStatistics(&nHits, &nMisses);
+    aosList.SetNameValue("OGR_CT_CACHE_HITS", CPLSPrintf(CPL_FRMT_GIB, nHits));
+    aosList.SetNameValue("OGR_CT_CACHE_MISSES",
+                         CPLSPrintf(CPL_FRMT_GIB, nMisses));
+
+    int nThreads = 0;
+    int nQueuedJobs = 0;
+    GIntBig nCompletedJobs = 0;
+    GIntBig nBusyTimeMicroSec = 0;
+    GDALGetGlobalThreadPoolStatistics(&nThreads, &nQueuedJobs,
+                                      &nCompletedJobs, &nBusyTimeMicroSec);
+    aosList.SetNameValue("THREAD_POOL_THREADS", CPLSPrintf("%d", nThreads));
+    aosList.SetNameValue("THREAD_POOL_QUEUED_JOBS",
+                         CPLSPrintf("%d", nQueuedJobs));
+    aosList.SetNameValue("THREAD_POOL_COMPLETED_JOBS",
+                         CPLSPrintf(CPL_FRMT_GIB, nCompletedJobs));
+    aosList.SetNameValue("THREAD_POOL_BUSY_TIME_US",
+                         CPLSPrintf(CPL_FRMT_GIB, nBusyTimeMicroSec));
+
+    return aosList.StealList();
+}
+
+/************************************************************************/
+/*                  GDALDatasetGetRuntimeStatistics()                   */
+/************************************************************************/
+
+/**
+ * \brief Return statistics on the use of the block cache by a dataset.
+ *
+ * The returned list contains the BLOCK_CACHE_HITS, BLOCK_CACHE_MISSES,
+ * BLOCK_CACHE_EVICTIONS and BLOCK_CACHE_DIRTY_FLUSHES items, with the same
+ * meaning as in GDALGetRuntimeStatistics(), but restricted to the blocks of
+ * the bands of the dataset, since its opening.
+ *
+ * @param hDS Dataset handle.
+ * @return a list of NAME=VALUE pairs to free with CSLDestroy().
+ *
+ * @since GDAL 3.4
+ */
+
+char** GDALDatasetGetRuntimeStatistics(GDALDatasetH hDS)
+{
+    VALIDATE_POINTER1(hDS, "GDALDatasetGetRuntimeStatistics", nullptr);
+
+    GDALBlockCacheCounters* poCounters =
+        GDALDataset::FromHandle(hDS)->GetBlockCacheCounters();
+    if( poCounters == nullptr )
+        return nullptr;
+    return poCounters->AppendTo(nullptr);
+}
+
+/************************************************************************/
+/*                   GDALGetDriverRuntimeStatistics()                   */
+/************************************************************************/
+
+/**
+ * \brief Return statistics on the use of the block cache by the datasets
+ * of a driver.
+ *
+ * The returned list contains the BLOCK_CACHE_HITS, BLOCK_CACHE_MISSES,
+ * BLOCK_CACHE_EVICTIONS and BLOCK_CACHE_DIRTY_FLUSHES items, with the same
+ * meaning as in GDALGetRuntimeStatistics(), but restricted to the blocks of
+ * the datasets opened or created with the driver.
+ *
+ * @param hDriver Driver handle.
+ * @return a list of NAME=VALUE pairs to free with CSLDestroy().
+ *
+ * @since GDAL 3.4
+ */
+
+char** GDALGetDriverRuntimeStatistics(GDALDriverH hDriver)
+{
+    VALIDATE_POINTER1(hDriver, "GDALGetDriverRuntimeStatistics", nullptr);
+
+    const GDALBlockCacheCounters* poCounters =
+        GDALGetDriverBlockCacheCounters(GDALDriver::FromHandle(hDriver),
+                                        false);
+    if( poCounters == nullptr )
+        return GDALBlockCacheCounters().AppendTo(nullptr);
+    return poCounters->AppendTo(nullptr);
+}
@@ -69,7 +69,9 @@ class GDALAsyncReader;
 #include <stdarg.h>
 
 #include <cmath>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <map>
@@ -264,11 +266,17 @@ class CPL_DLL GDALDefaultOverviews
 /*                             GDALOpenInfo                             */
 /* ******************************************************************** */
 
+//! @cond Doxygen_Suppress
+class GDALDirListing;
+//! @endcond
+
 /** Class for dataset open functions. */
 class CPL_DLL GDALOpenInfo
 {
     bool        bHasGotSiblingFiles;
     char        **papszSiblingFiles;
+    // Owner of papszSiblingFiles when it comes from a directory listing
+    std::shared_ptr<const GDALDirListing> poSiblingFilesListing{};
     int         nHeaderBytesTried;
 
   public:
@@ -327,6 +335,31 @@ class GDALGroup;
 typedef struct GDALSQLParseInfo GDALSQLParseInfo;
 //! @endcond
 
+//! @cond Doxygen_Suppress
+/** Block cache events counted by GDALBlockCacheCounters */
+enum class GDALBlockCacheEvent
+{
+    HIT,
+    MISS,
+    EVICTION,
+    DIRTY_FLUSH
+};
+
+/** Block cache counters of a dataset, of a driver or of the whole process */
+struct GDALBlockCacheCounters
+{
+    std::atomic<GIntBig> nHits{0};
+    std::atomic<GIntBig> nMisses{0};
+    std::atomic<GIntBig> nEvictions{0};
+    std::atomic<GIntBig> nDirtyFlushes{0};
+
+    void Increment(GDALBlockCacheEvent eEvent);
+    char** AppendTo(char** papszList) const;
+
+    static void Count(GDALRasterBand* poBand, GDALBlockCacheEvent eEvent);
+};
+//! @endcond
+
 //! @cond Doxygen_Suppress
 #ifdef GDAL_COMPILATION
 #define OPTIONAL_OUTSIDE_GDAL(val)
@@ -463,6 +496,11 @@ class CPL_DLL GDALDataset : public GDALMajorObject
   public:
      ~GDALDataset() override;
 
+//! @cond Doxygen_Suppress
+    GDALBlockCacheCounters* GetBlockCacheCounters();
+    GDALBlockCacheCounters* GetDriverBlockCacheCounters();
+//! @endcond
+
     int GetRasterXSize();
     int GetRasterYSize();
     int GetRasterCount();
@@ -587,6 +625,13 @@ class CPL_DLL GDALDataset : public GDALMajorObject
 #endif
                           ) CPL_WARN_UNUSED_RESULT;
 
+    CPLErr      SamplePoints( size_t nPoints,
+                              const double* padfX, const double* padfY,
+                              int nBandCount, const int* panBandList,
+                              GDALRIOResampleAlg eResampleAlg,
+                              double* padfValues, int* pabValid,
+                              CSLConstList papszOptions = nullptr );
+
     int           Reference();
     int           Dereference();
     int           ReleaseRef();
@@ -898,6 +943,10 @@ using GDALDatasetUniquePtr = std::unique_ptr<GDALDataset, GDALDatasetUniquePtrDe
 /*                           GDALRasterBlock                            */
 /* ******************************************************************** */
 
+//! @cond Doxygen_Suppress
+struct GDALSharedBlockKey;
+//! @endcond
+
 /** A single raster block in the block cache.
  *
  * And the global block manager that manages a least-recently-used list of
@@ -931,6 +980,8 @@ class CPL_DLL GDALRasterBlock
 
     CPL_INTERNAL void        RecycleFor( int nXOffIn, int nYOffIn );
 
+    CPL_INTERNAL bool        GetSharedCacheKey( GDALSharedBlockKey& sKey );
+
   public:
                 GDALRasterBlock( GDALRasterBand *, int, int );
                 GDALRasterBlock( int nXOffIn, int nYOffIn ); /* only for lookup purpose */
@@ -948,6 +999,9 @@ class CPL_DLL GDALRasterBlock
 
     CPLErr      Write();
 
+    CPL_INTERNAL bool        ReadFromSharedCache();
+    CPL_INTERNAL void        WriteToSharedCache();
+
     /** Return the data type
      * @return data type
      */
@@ -996,6 +1050,9 @@ class CPL_DLL GDALRasterBlock
     static void EnterDisableDirtyBlockFlush();
     static void LeaveDisableDirtyBlockFlush();
 
+    static void TrimRecycledBuffers(GIntBig nMaxSize);
+    static GIntBig GetRecycledBuffersSize();
+
 #ifdef notdef
     static void CheckNonOrphanedBlocks(GDALRasterBand* poBand);
     void        DumpBlock();
@@ -1134,9 +1191,19 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     CPLErr eFlushBlockErr = CE_None;
     GDALAbstractBandBlockCache* poBandBlockCache = nullptr;
 
+    // Shared memory block cache: 0 = not evaluated, 1 = used, 2 = used and
+    // a block was found in it, -1 = not used.
+    int         nSharedBlockCacheStatus = 0;
+    GUInt64     anSharedBlockCacheDSKey[2] = {0, 0};
+
     CPL_INTERNAL void           SetFlushBlockErr( CPLErr eErr );
     CPL_INTERNAL CPLErr         UnreferenceBlock( GDALRasterBlock* poBlock );
     CPL_INTERNAL void           SetValidPercent( GUIntBig nSampleCount, GUIntBig nValidCount );
+    CPL_INTERNAL CPLErr         ComputeStatisticsFromBlockSample(
+                                    int nSampleCount,
+                                    double *pdfMin, double *pdfMax,
+                                    double *pdfMean, double *pdfStdDev,
+                                    GDALProgressFunc, void *pProgressData );
     CPL_INTERNAL void           IncDirtyBlocks(int nInc);
 
   protected:
@@ -1232,6 +1299,11 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                           OPTIONAL_OUTSIDE_GDAL(nullptr)
 #endif
                           ) CPL_WARN_UNUSED_RESULT;
+    CPLErr      SamplePoints( size_t nPoints,
+                              const double* padfX, const double* padfY,
+                              GDALRIOResampleAlg eResampleAlg,
+                              double* padfValues, int* pabValid,
+                              CSLConstList papszOptions = nullptr );
     CPLErr      ReadBlock( int, int, void * ) CPL_WARN_UNUSED_RESULT;
 
     CPLErr      WriteBlock( int, int, void * ) CPL_WARN_UNUSED_RESULT;
@@ -1485,6 +1557,12 @@ class CPL_DLL GDALDriver : public GDALMajorObject
     GDALDriver();
     ~GDALDriver() override;
 
+    char      **GetMetadataDomainList() override;
+    char      **GetMetadata( const char * pszDomain = "" ) override;
+    CPLErr      SetMetadata( char ** papszMetadata,
+                             const char * pszDomain = "" ) override;
+    const char *GetMetadataItem( const char * pszName,
+                                 const char * pszDomain = "" ) override;
     CPLErr      SetMetadataItem( const char * pszName,
                                  const char * pszValue,
                                  const char * pszDomain = "" ) override;
@@ -1568,6 +1646,13 @@ class CPL_DLL GDALDriver : public GDALMajorObject
                                                  char ** papszOptions );
     CPLErr              (*pfnDeleteDataSource)( GDALDriver*,
                                                  const char * pszName );
+
+    /** Function completing the initialization of a driver on first use. */
+    typedef std::function<void(GDALDriver*)> DeferredInitFunc;
+
+    void                SetDeferredInit( DeferredInitFunc&& oFunc );
+    bool                HasPendingDeferredInit() const;
+    void                RunDeferredInit();
 //! @endcond
 
 /* -------------------------------------------------------------------- */
@@ -1620,6 +1705,16 @@ class CPL_DLL GDALDriver : public GDALMajorObject
         { return static_cast<GDALDriver*>(hDriver); }
 
 private:
+    DeferredInitFunc    m_oDeferredInitFunc{};
+    std::atomic<bool>   m_bDeferredInitPending{false};
+    // Metadata published once the deferred initialization has completed.
+    std::atomic<GDALMultiDomainMetadata*> m_poFullMDMD{nullptr};
+    // Metadata being built by the deferred initialization.
+    GDALMultiDomainMetadata *m_poStagingMDMD = nullptr;
+
+    GDALMultiDomainMetadata& GetMDMDForRead();
+    GDALMultiDomainMetadata& GetMDMDForWrite();
+
     CPL_DISALLOW_COPY_ASSIGN(GDALDriver)
 };
 
@@ -1647,8 +1742,15 @@ class CPL_DLL GDALDriverManager : public GDALMajorObject
     GDALDriver  *GetDriverByName_unlocked( const char * pszName )
             { return oMapNameToDrivers[CPLString(pszName).toupper()]; }
 
+    // Plugin driver proxy whose shared library is being loaded, and the
+    // real driver registered by the library.
+    GDALDriver  *m_poPluginProxyBeingLoaded = nullptr;
+    GDALDriver  *m_poPluginRealDriver = nullptr;
+
     static char** GetSearchPaths(const char* pszGDAL_DRIVER_PATH);
 
+    friend class GDALPluginDriverProxy;
+
     static void   CleanupPythonDrivers();
 
     CPL_DISALLOW_COPY_ASSIGN(GDALDriverManager)
@@ -2754,6 +2856,12 @@ void GDALNullifyOpenDatasetsList();
 CPLMutex** GDALGetphDMMutex();
 CPLMutex** GDALGetphDLMutex();
 void GDALNullifyProxyPoolSingleton();
+void GDALProxyPoolGetStatistics(GIntBig* pnHits, GIntBig* pnOpens,
+                                GIntBig* pnEvictions);
+GDALBlockCacheCounters& GDALGetBlockCacheCounters();
+GDALBlockCacheCounters* GDALGetDriverBlockCacheCounters(GDALDriver* poDriver,
+                                                        bool bCreate);
+void GDALRemoveDriverBlockCacheCounters(GDALDriver* poDriver);
 void GDALSetResponsiblePIDForCurrentThread(GIntBig responsiblePID);
 GIntBig GDALGetResponsiblePIDForCurrentThread();
 
@@ -2800,6 +2908,17 @@ double GDALAdjustNoDataCloseToFloatMax(double dfVal);
 // (minimum value, maximum value, etc.)
 #define GDALSTAT_APPROX_NUMSAMPLES 2500
 
+void GDALComputeStatisticsUInt8Or16( GDALDataType eDataType,
+                                     const void* pData,
+                                     size_t nVals,
+                                     bool bHasNoData,
+                                     GUInt32 nNoDataValue,
+                                     GUInt32& nMin,
+                                     GUInt32& nMax,
+                                     GUInt64& nValidCount,
+                                     double& dfMean,
+                                     double& dfM2 );
+
 void GDALSerializeGCPListToXML( CPLXMLNode* psParentNode,
                                 GDAL_GCP* pasGCPList,
                                 int nGCPCount,
@@ -2816,6 +2935,9 @@ int GDALCanFileAcceptSidecarFile(const char* pszFilename);
 
 bool GDALCanReliablyUseSiblingFileList(const char* pszFilename);
 
+int CPL_DLL GDALFindSiblingFile(CSLConstList papszSiblingFiles,
+                                const char* pszFilename);
+
 bool CPL_DLL GDALIsDriverDeprecatedForGDAL35StillEnabled(const char* pszDriverName, const char* pszExtraMsg = "");
 
 //! @endcond
@@ -58,3 +58,22 @@ void GDALDestroyGlobalThreadPool()
     delete gpoCompressThreadPool;
     gpoCompressThreadPool = nullptr;
 }
+
+void GDALGetGlobalThreadPoolStatistics(int* pnThreads, int* pnQueuedJobs,
+                                       GIntBig* pnCompletedJobs,
+                                       GIntBig* pnBusyTimeMicroSec)
+{
+    std::lock_guard<std::mutex> oGuard(gMutexThreadPool);
+    if( gpoCompressThreadPool == nullptr )
+    {
+        *pnThreads = 0;
+        *pnQueuedJobs = 0;
+        *pnCompletedJobs = 0;
+        *pnBusyTimeMicroSec = 0;
+        return;
+    }
+    *pnThreads = gpoCompressThreadPool->GetThreadCount();
+    *pnQueuedJobs = gpoCompressThreadPool->GetQueuedJobCount();
+    *pnCompletedJobs = gpoCompressThreadPool->GetCompletedJobCount();
+    *pnBusyTimeMicroSec = gpoCompressThreadPool->GetBusyTimeMicroSec();
+}
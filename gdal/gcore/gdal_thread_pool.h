@@ -35,4 +35,8 @@ CPLWorkerThreadPool* GDALGetGlobalThreadPool(int nThreads);
 
 void GDALDestroyGlobalThreadPool();
 
+void GDALGetGlobalThreadPoolStatistics(int* pnThreads, int* pnQueuedJobs,
+                                       GIntBig* pnCompletedJobs,
+                                       GIntBig* pnBusyTimeMicroSec);
+
 #endif // GDAL_THREAD_POOL_H
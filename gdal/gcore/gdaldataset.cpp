@@ -37,6 +37,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <new>
 #include <set>
@@ -49,6 +50,7 @@
 #include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_error.h"
 #include "ogr_api.h"
@@ -125,6 +127,10 @@ class GDALDataset::Private
 
     bool m_bOverviewsEnabled = true;
 
+    GDALBlockCacheCounters m_oBlockCacheCounters{};
+    std::atomic<GDALDriver*> m_poBlockCacheCountersDriver{nullptr};
+    std::atomic<GDALBlockCacheCounters*> m_poDriverBlockCacheCounters{nullptr};
+
     Private() = default;
 };
 
@@ -3374,6 +3380,9 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
             continue;
         }
 
+        CPLTraceSpan oTraceSpan("gdal", "GDALOpenEx");
+        oTraceSpan.SetDetail(poDriver->GetDescription());
+
         // Remove general OVERVIEW_LEVEL open options from list before passing
         // it to the driver, if it isn't a driver specific option already.
         char **papszTmpOpenOptions = nullptr;
@@ -7568,6 +7577,36 @@ void GDALDataset::InitRWLock()
     }
 }
 
+/************************************************************************/
+/*                       GetBlockCacheCounters()                        */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+GDALBlockCacheCounters* GDALDataset::GetBlockCacheCounters()
+{
+    return m_poPrivate ? &(m_poPrivate->m_oBlockCacheCounters) : nullptr;
+}
+
+/************************************************************************/
+/*                    GetDriverBlockCacheCounters()                     */
+/************************************************************************/
+
+GDALBlockCacheCounters* GDALDataset::GetDriverBlockCacheCounters()
+{
+    if( m_poPrivate == nullptr || poDriver == nullptr )
+        return nullptr;
+    // The driver of a dataset is set once after its opening or creation,
+    // so the counters of the driver are only looked up when it changes.
+    if( m_poPrivate->m_poBlockCacheCountersDriver != poDriver )
+    {
+        m_poPrivate->m_poDriverBlockCacheCounters =
+            GDALGetDriverBlockCacheCounters(poDriver, true);
+        m_poPrivate->m_poBlockCacheCountersDriver = poDriver;
+    }
+    return m_poPrivate->m_poDriverBlockCacheCounters;
+}
+//! @endcond
+
 /************************************************************************/
 /*                       DisableReadWriteMutex()                        */
 /************************************************************************/
@@ -312,14 +312,14 @@ void GDALDefaultOverviews::OverviewScan()
         if( papszInitSiblingFiles )
         {
             CPLString osAuxFilename = CPLResetExtension( pszInitName, "aux");
-            int iSibling = CSLFindString( papszInitSiblingFiles,
-                                          CPLGetFilename(osAuxFilename) );
+            int iSibling = GDALFindSiblingFile( papszInitSiblingFiles,
+                                                CPLGetFilename(osAuxFilename) );
             if( iSibling < 0 )
             {
                 osAuxFilename = pszInitName;
                 osAuxFilename += ".aux";
-                iSibling = CSLFindString( papszInitSiblingFiles,
-                                        CPLGetFilename(osAuxFilename) );
+                iSibling = GDALFindSiblingFile( papszInitSiblingFiles,
+                                                CPLGetFilename(osAuxFilename) );
                 if( iSibling < 0 )
                     bTryFindAssociatedAuxFile = false;
             }
@@ -42,6 +42,7 @@
 #include "cpl_minixml.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "ogr_core.h"
 #include "ogrsf_frmts.h"
@@ -79,6 +80,10 @@ GDALDriver::~GDALDriver()
 {
     if( pfnUnloadDriver != nullptr )
         pfnUnloadDriver( this );
+
+    GDALRemoveDriverBlockCacheCounters(this);
+
+    delete m_poFullMDMD.load();
 }
 
 /************************************************************************/
@@ -159,6 +164,8 @@ GDALDataset * GDALDriver::Create( const char * pszFilename,
                                   GDALDataType eType, char ** papszOptions )
 
 {
+    RunDeferredInit();
+
 /* -------------------------------------------------------------------- */
 /*      Does this format support creation.                              */
 /* -------------------------------------------------------------------- */
@@ -314,6 +321,8 @@ GDALDataset * GDALDriver::CreateMultiDimensional( const char * pszFilename,
                                                   CSLConstList papszOptions )
 
 {
+    RunDeferredInit();
+
 /* -------------------------------------------------------------------- */
 /*      Does this format support creation.                              */
 /* -------------------------------------------------------------------- */
@@ -944,6 +953,8 @@ GDALDataset *GDALDriver::CreateCopy( const char * pszFilename,
                                      void * pProgressData )
 
 {
+    RunDeferredInit();
+
     if( pfnProgress == nullptr )
         pfnProgress = GDALDummyProgress;
 
@@ -1164,6 +1175,7 @@ CPLErr GDALDriver::QuietDelete( const char *pszName,
 
     CPLDebug( "GDAL", "QuietDelete(%s) invoking Delete()", pszName );
 
+    poDriver->RunDeferredInit();
     const bool bQuiet =
         !bExists && poDriver->pfnDelete == nullptr &&
         poDriver->pfnDeleteDataSource == nullptr;
@@ -1205,6 +1217,8 @@ CPLErr GDALDriver::QuietDelete( const char *pszName,
 CPLErr GDALDriver::Delete( const char * pszFilename )
 
 {
+    RunDeferredInit();
+
     if( pfnDelete != nullptr )
         return pfnDelete( pszFilename );
     else if( pfnDeleteDataSource != nullptr )
@@ -1380,6 +1394,8 @@ CPLErr GDALDriver::DefaultRename( const char * pszNewName,
 CPLErr GDALDriver::Rename( const char * pszNewName, const char *pszOldName )
 
 {
+    RunDeferredInit();
+
     if( pfnRename != nullptr )
         return pfnRename( pszNewName, pszOldName );
 
@@ -1505,6 +1521,8 @@ CPLErr GDALDriver::DefaultCopyFiles( const char *pszNewName,
 CPLErr GDALDriver::CopyFiles( const char *pszNewName, const char *pszOldName )
 
 {
+    RunDeferredInit();
+
     if( pfnCopyFiles != nullptr )
         return pfnCopyFiles( pszNewName, pszOldName );
 
@@ -2266,6 +2284,187 @@ GDALIdentifyDriverEx( const char* pszFilename,
     return nullptr;
 }
 
+/************************************************************************/
+/*                          SetDeferredInit()                           */
+/************************************************************************/
+
+/**
+ * \brief Register a function completing the initialization of the driver.
+ *
+ * This is intended to be called by drivers at registration time, to defer
+ * the computation of expensive metadata items (creation option list, etc.)
+ * until they are first needed. The function is called at most once, with
+ * the driver as argument, when a metadata item not yet set is requested, when
+ * the whole metadata of a domain is requested, or before any Create(),
+ * CreateCopy(), Delete(), Rename() or CopyFiles() operation.
+ *
+ * Capabilities (GDAL_DCAP_xxx items) must be set before registering the
+ * driver, and not by the deferred initialization, as querying an
+ * absent capability does not trigger it.
+ *
+ * If the GDAL_LAZY_DRIVER_REGISTRATION configuration option is set to NO,
+ * the function is immediately called.
+ *
+ * @since GDAL 3.4
+ */
+
+void GDALDriver::SetDeferredInit( DeferredInitFunc&& oFunc )
+{
+    if( !CPLTestBool(
+            CPLGetConfigOption("GDAL_LAZY_DRIVER_REGISTRATION", "YES")) )
+    {
+        oFunc(this);
+        return;
+    }
+    m_oDeferredInitFunc = std::move(oFunc);
+    m_bDeferredInitPending = true;
+}
+
+/************************************************************************/
+/*                       HasPendingDeferredInit()                       */
+/************************************************************************/
+
+/** Return whether a deferred initialization has not yet been run.
+ * @since GDAL 3.4
+ */
+bool GDALDriver::HasPendingDeferredInit() const
+{
+    return m_bDeferredInitPending.load(std::memory_order_acquire);
+}
+
+/************************************************************************/
+/*                          RunDeferredInit()                           */
+/************************************************************************/
+
+/** Run the deferred initialization of the driver, if not already done.
+ *
+ * The metadata set by the deferred initialization is accumulated in a
+ * separate object that replaces the initial one once it is complete, so
+ * that other threads can keep on querying the initial metadata items
+ * without locking.
+ *
+ * @since GDAL 3.4
+ */
+void GDALDriver::RunDeferredInit()
+{
+    if( !HasPendingDeferredInit() )
+        return;
+
+    CPLMutexHolderD( GDALGetphDMMutex() );
+    // Either already done by another thread, or recursive call from the
+    // deferred initialization function itself.
+    if( !m_bDeferredInitPending.load(std::memory_order_relaxed) ||
+        m_poStagingMDMD != nullptr )
+    {
+        return;
+    }
+
+    CPLTraceSpan oSpan("GDAL", "DriverDeferredInit");
+    if( oSpan.IsActive() )
+        oSpan.SetDetail(GetDescription());
+
+    auto poMDMD = new GDALMultiDomainMetadata();
+    for( CSLConstList papszIter = oMDMD.GetDomainList();
+         papszIter && *papszIter; ++papszIter )
+    {
+        poMDMD->SetMetadata(oMDMD.GetMetadata(*papszIter), *papszIter);
+    }
+    m_poStagingMDMD = poMDMD;
+    m_oDeferredInitFunc(this);
+    m_oDeferredInitFunc = nullptr;
+    m_poStagingMDMD = nullptr;
+
+    m_poFullMDMD.store(poMDMD, std::memory_order_release);
+    m_bDeferredInitPending.store(false, std::memory_order_release);
+}
+
+/************************************************************************/
+/*                          GetMDMDForRead()                            */
+/************************************************************************/
+
+GDALMultiDomainMetadata& GDALDriver::GetMDMDForRead()
+{
+    auto poMDMD = m_poFullMDMD.load(std::memory_order_acquire);
+    return poMDMD ? *poMDMD : oMDMD;
+}
+
+/************************************************************************/
+/*                          GetMDMDForWrite()                           */
+/************************************************************************/
+
+GDALMultiDomainMetadata& GDALDriver::GetMDMDForWrite()
+{
+    if( HasPendingDeferredInit() )
+    {
+        // Only the thread running the deferred initialization can acquire
+        // the mutex while the staging object is set.
+        CPLMutexHolderD( GDALGetphDMMutex() );
+        if( m_poStagingMDMD )
+            return *m_poStagingMDMD;
+        // Items set before the deferred initialization is triggered, such
+        // as the capabilities set by RegisterDriver(), go with the initial
+        // ones.
+        if( m_bDeferredInitPending.load(std::memory_order_relaxed) )
+            return oMDMD;
+    }
+    return GetMDMDForRead();
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **GDALDriver::GetMetadataDomainList()
+{
+    RunDeferredInit();
+    return CSLDuplicate(GetMDMDForRead().GetDomainList());
+}
+
+/************************************************************************/
+/*                            GetMetadata()                             */
+/************************************************************************/
+
+char **GDALDriver::GetMetadata( const char *pszDomain )
+{
+    RunDeferredInit();
+    return GetMDMDForRead().GetMetadata(pszDomain);
+}
+
+/************************************************************************/
+/*                            SetMetadata()                             */
+/************************************************************************/
+
+CPLErr GDALDriver::SetMetadata( char **papszMetadata, const char *pszDomain )
+{
+    auto& oTargetMDMD = GetMDMDForWrite();
+    nFlags |= GMO_MD_DIRTY;
+    return oTargetMDMD.SetMetadata(papszMetadata, pszDomain);
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *GDALDriver::GetMetadataItem( const char *pszName,
+                                         const char *pszDomain )
+{
+    if( HasPendingDeferredInit() )
+    {
+        // Items set at registration time, and capabilities, are available
+        // without running the deferred initialization.
+        const char* pszValue = oMDMD.GetMetadataItem(pszName, pszDomain);
+        if( pszValue != nullptr )
+            return pszValue;
+        if( (pszDomain == nullptr || pszDomain[0] == '\0') &&
+            STARTS_WITH_CI(pszName, "DCAP_") )
+        {
+            return nullptr;
+        }
+        RunDeferredInit();
+    }
+    return GetMDMDForRead().GetMetadataItem(pszName, pszDomain);
+}
+
 /************************************************************************/
 /*                          SetMetadataItem()                           */
 /************************************************************************/
@@ -2275,14 +2474,16 @@ CPLErr GDALDriver::SetMetadataItem( const char *pszName,
                                     const char *pszDomain )
 
 {
+    auto& oTargetMDMD = GetMDMDForWrite();
+    nFlags |= GMO_MD_DIRTY;
     if( pszDomain == nullptr || pszDomain[0] == '\0' )
     {
         /* Automatically sets GDAL_DMD_EXTENSIONS from GDAL_DMD_EXTENSION */
         if( EQUAL(pszName, GDAL_DMD_EXTENSION) &&
-            GDALMajorObject::GetMetadataItem(GDAL_DMD_EXTENSIONS) == nullptr )
+            oTargetMDMD.GetMetadataItem(GDAL_DMD_EXTENSIONS) == nullptr )
         {
-            GDALMajorObject::SetMetadataItem(GDAL_DMD_EXTENSIONS, pszValue);
+            oTargetMDMD.SetMetadataItem(GDAL_DMD_EXTENSIONS, pszValue);
         }
     }
-    return GDALMajorObject::SetMetadataItem(pszName, pszValue, pszDomain);
+    return oTargetMDMD.SetMetadataItem(pszName, pszValue, pszDomain);
 }
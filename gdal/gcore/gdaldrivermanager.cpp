@@ -33,12 +33,15 @@
 #include <cstring>
 #include <map>
 
+#include "cpl_compressor.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_http.h"
 #include "cpl_multiproc.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_port.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
@@ -226,6 +229,12 @@ GDALDriverManager::~GDALDriverManager()
     CleanupPythonDrivers();
 
     GDALDestroyGlobalThreadPool();
+    CPLPackedRTreeCleanup();
+
+/* -------------------------------------------------------------------- */
+/*      Export (if CPL_TRACE_FILE is set) and free tracing spans.       */
+/* -------------------------------------------------------------------- */
+    CPLTraceCleanup();
 
 /* -------------------------------------------------------------------- */
 /*      Cleanup local memory.                                           */
@@ -251,6 +260,7 @@ GDALDriverManager::~GDALDriverManager()
     CPLFinderClean();
     CPLFreeConfig();
     CPLCleanupSharedFileMutex();
+    CPLDestroyCompressorRegistry();
 
 #ifdef HAVE_XERCES
     OGRCleanupXercesMutex();
@@ -432,6 +442,24 @@ int GDALDriverManager::RegisterDriver( GDALDriver * poDriver )
 {
     CPLMutexHolderD( &hDMMutex );
 
+/* -------------------------------------------------------------------- */
+/*      If this is the driver of a deferred plugin being loaded, hand   */
+/*      it to its proxy instead of registering it.                      */
+/* -------------------------------------------------------------------- */
+    if( m_poPluginProxyBeingLoaded != nullptr &&
+        m_poPluginRealDriver == nullptr &&
+        EQUAL(poDriver->GetDescription(),
+              m_poPluginProxyBeingLoaded->GetDescription()) )
+    {
+        m_poPluginRealDriver = poDriver;
+        for( int i = 0; i < nDrivers; ++i )
+        {
+            if( papoDrivers[i] == m_poPluginProxyBeingLoaded )
+                return i;
+        }
+        return -1;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      If it is already registered, just return the existing           */
 /*      index.                                                          */
@@ -488,7 +516,8 @@ int GDALDriverManager::RegisterDriver( GDALDriver * poDriver )
         poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     }
 
-    if( poDriver->GetMetadataItem( GDAL_DMD_OPENOPTIONLIST ) != nullptr &&
+    if( !poDriver->HasPendingDeferredInit() &&
+        poDriver->GetMetadataItem( GDAL_DMD_OPENOPTIONLIST ) != nullptr &&
         poDriver->pfnIdentify == nullptr &&
         poDriver->pfnIdentifyEx == nullptr &&
         !STARTS_WITH_CI(poDriver->GetDescription(), "Interlis") )
@@ -606,6 +635,13 @@ GDALDriver * GDALDriverManager::GetDriverByName( const char * pszName )
     if( EQUAL(pszName, "CartoDB") )
         pszName = "Carto";
 
+    // Hide the proxy of a deferred plugin to its own registration function
+    if( m_poPluginProxyBeingLoaded != nullptr &&
+        EQUAL(pszName, m_poPluginProxyBeingLoaded->GetDescription()) )
+    {
+        return nullptr;
+    }
+
     return oMapNameToDrivers[CPLString(pszName).toupper()];
 }
 
@@ -750,6 +786,271 @@ char** GDALDriverManager::GetSearchPaths(const char* pszGDAL_DRIVER_PATH)
     return papszSearchPaths;
 }
 
+#ifndef GDAL_NO_AUTOLOAD
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        GDALPluginDriverProxy                         */
+/* ==================================================================== */
+/************************************************************************/
+
+/* Driver standing for a plugin whose shared library is only loaded when it is
+ * actually needed, that is when a file to open matches one of its extensions
+ * or its connection prefix, or when an operation other than opening is
+ * requested. Its initial metadata comes from a description file next to the
+ * library.
+ */
+
+class GDALPluginDriverProxy final: public GDALDriver
+{
+    CPLString   m_osLibraryName;
+    CPLString   m_osFuncName;
+    GDALDriver *m_poRealDriver = nullptr;
+
+    bool        MayHandle( GDALOpenInfo* poOpenInfo );
+
+    static void Load( GDALDriver* poDriver );
+    static int  Identify( GDALDriver* poDriver, GDALOpenInfo* poOpenInfo );
+    static GDALDataset* Open( GDALDriver* poDriver, GDALOpenInfo* poOpenInfo );
+
+    GDALPluginDriverProxy( const char* pszLibraryName,
+                           const char* pszFuncName ):
+        m_osLibraryName(pszLibraryName), m_osFuncName(pszFuncName) {}
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALPluginDriverProxy)
+
+  public:
+    ~GDALPluginDriverProxy() override;
+
+    static GDALPluginDriverProxy* Create( const char* pszLibraryName,
+                                          const char* pszFuncName,
+                                          const char* pszDescriptionFile );
+};
+
+/************************************************************************/
+/*                       ~GDALPluginDriverProxy()                       */
+/************************************************************************/
+
+GDALPluginDriverProxy::~GDALPluginDriverProxy()
+{
+    delete m_poRealDriver;
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/************************************************************************/
+
+/* The description file contains KEY=VALUE lines. The DRIVER key is the
+ * short name of the driver, and is mandatory. Other keys are metadata items
+ * of the default domain, typically DCAP_RASTER, DCAP_VECTOR, DCAP_CREATE,
+ * DMD_LONGNAME, DMD_EXTENSIONS and DMD_CONNECTION_PREFIX.
+ */
+
+GDALPluginDriverProxy* GDALPluginDriverProxy::Create(
+                                        const char* pszLibraryName,
+                                        const char* pszFuncName,
+                                        const char* pszDescriptionFile )
+{
+    const CPLStringList aosLines(
+        CSLLoad2(pszDescriptionFile, 1000, 10000, nullptr));
+    const char* pszDriverName = aosLines.FetchNameValue("DRIVER");
+    if( pszDriverName == nullptr || pszDriverName[0] == '\0' )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s lacks a DRIVER item. Ignoring it", pszDescriptionFile );
+        return nullptr;
+    }
+
+    auto poProxy = new GDALPluginDriverProxy(pszLibraryName, pszFuncName);
+    poProxy->SetDescription(pszDriverName);
+    for( int i = 0; i < aosLines.size(); ++i )
+    {
+        const char* pszLine = aosLines[i];
+        if( pszLine[0] == '#' )
+            continue;
+        char* pszKey = nullptr;
+        const char* pszValue = CPLParseNameValue(pszLine, &pszKey);
+        if( pszKey != nullptr && pszValue != nullptr &&
+            !EQUAL(pszKey, "DRIVER") )
+        {
+            poProxy->SetMetadataItem(pszKey, pszValue);
+        }
+        CPLFree(pszKey);
+    }
+
+    poProxy->pfnIdentifyEx = Identify;
+    poProxy->pfnOpenWithDriverArg = Open;
+    poProxy->SetDeferredInit(Load);
+    return poProxy;
+}
+
+/************************************************************************/
+/*                              MayHandle()                             */
+/************************************************************************/
+
+bool GDALPluginDriverProxy::MayHandle( GDALOpenInfo* poOpenInfo )
+{
+    // Only look at the items of the description file, so as not to trigger
+    // the loading.
+    const char* pszPrefix =
+        oMDMD.GetMetadataItem(GDAL_DMD_CONNECTION_PREFIX, "");
+    if( pszPrefix != nullptr && pszPrefix[0] != '\0' &&
+        STARTS_WITH_CI(poOpenInfo->pszFilename, pszPrefix) )
+    {
+        return true;
+    }
+
+    const char* pszExtensions =
+        oMDMD.GetMetadataItem(GDAL_DMD_EXTENSIONS, "");
+    const CPLString osExtension(CPLGetExtension(poOpenInfo->pszFilename));
+    if( pszExtensions == nullptr || osExtension.empty() )
+        return false;
+    const CPLStringList aosExtensions(CSLTokenizeString(pszExtensions));
+    return aosExtensions.FindString(osExtension) >= 0;
+}
+
+/************************************************************************/
+/*                                Load()                                */
+/************************************************************************/
+
+/* Deferred initialization of the proxy: loads the shared library, and runs
+ * its registration function, whose driver is captured by RegisterDriver(). */
+
+void GDALPluginDriverProxy::Load( GDALDriver* poDriver )
+{
+    auto poProxy = static_cast<GDALPluginDriverProxy*>(poDriver);
+    CPLTraceSpan oSpan("GDAL", "LoadPlugin");
+    if( oSpan.IsActive() )
+        oSpan.SetDetail(poProxy->GetDescription());
+
+    CPLDebug( "GDAL", "Loading %s for driver %s",
+              poProxy->m_osLibraryName.c_str(), poProxy->GetDescription() );
+
+    CPLErrorReset();
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    void *pRegister = CPLGetSymbol( poProxy->m_osLibraryName,
+                                    poProxy->m_osFuncName );
+    CPLPopErrorHandler();
+    if( pRegister == nullptr )
+    {
+        CPLString osLastErrorMsg(CPLGetLastErrorMsg());
+        pRegister = CPLGetSymbol( poProxy->m_osLibraryName, "GDALRegisterMe" );
+        if( pRegister == nullptr )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "%s", osLastErrorMsg.c_str() );
+            return;
+        }
+    }
+
+    GDALDriverManager* poDriverManager = GetGDALDriverManager();
+    poDriverManager->m_poPluginProxyBeingLoaded = poProxy;
+    reinterpret_cast<void (*)()>(pRegister)();
+    GDALDriver* poRealDriver = poDriverManager->m_poPluginRealDriver;
+    poDriverManager->m_poPluginProxyBeingLoaded = nullptr;
+    poDriverManager->m_poPluginRealDriver = nullptr;
+
+    if( poRealDriver == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s did not register a driver named %s",
+                  poProxy->m_osLibraryName.c_str(),
+                  poProxy->GetDescription() );
+        return;
+    }
+    poProxy->m_poRealDriver = poRealDriver;
+
+    // Identification and opening keep on going through the proxy callbacks,
+    // that forward to the real driver.
+    poProxy->pfnCreate = poRealDriver->pfnCreate;
+    poProxy->pfnCreateEx = poRealDriver->pfnCreateEx;
+    poProxy->pfnCreateMultiDimensional =
+        poRealDriver->pfnCreateMultiDimensional;
+    poProxy->pfnDelete = poRealDriver->pfnDelete;
+    poProxy->pfnCreateCopy = poRealDriver->pfnCreateCopy;
+    poProxy->pDriverData = poRealDriver->pDriverData;
+    poProxy->pfnRename = poRealDriver->pfnRename;
+    poProxy->pfnCopyFiles = poRealDriver->pfnCopyFiles;
+    poProxy->pfnCreateVectorOnly = poRealDriver->pfnCreateVectorOnly;
+    poProxy->pfnDeleteDataSource = poRealDriver->pfnDeleteDataSource;
+
+    CPLStringList aosDomains(poRealDriver->GetMetadataDomainList());
+    if( aosDomains.FindString("") < 0 )
+        aosDomains.AddString("");
+    for( int i = 0; i < aosDomains.size(); ++i )
+    {
+        const char* pszDomain = aosDomains[i];
+        for( CSLConstList papszIter = poRealDriver->GetMetadata(pszDomain);
+             papszIter && *papszIter; ++papszIter )
+        {
+            char* pszKey = nullptr;
+            const char* pszValue = CPLParseNameValue(*papszIter, &pszKey);
+            if( pszKey != nullptr && pszValue != nullptr )
+                poProxy->SetMetadataItem(pszKey, pszValue, pszDomain);
+            CPLFree(pszKey);
+        }
+    }
+
+    if( poProxy->pfnCreate != nullptr || poProxy->pfnCreateEx != nullptr )
+        poProxy->SetMetadataItem( GDAL_DCAP_CREATE, "YES" );
+    if( poProxy->pfnCreateCopy != nullptr )
+        poProxy->SetMetadataItem( GDAL_DCAP_CREATECOPY, "YES" );
+    if( poProxy->pfnCreateMultiDimensional != nullptr )
+        poProxy->SetMetadataItem( GDAL_DCAP_CREATE_MULTIDIMENSIONAL, "YES" );
+}
+
+/************************************************************************/
+/*                              Identify()                              */
+/************************************************************************/
+
+int GDALPluginDriverProxy::Identify( GDALDriver* poDriver,
+                                     GDALOpenInfo* poOpenInfo )
+{
+    auto poProxy = static_cast<GDALPluginDriverProxy*>(poDriver);
+    if( poProxy->HasPendingDeferredInit() )
+    {
+        if( !poProxy->MayHandle(poOpenInfo) )
+            return FALSE;
+        poProxy->RunDeferredInit();
+    }
+
+    GDALDriver* poRealDriver = poProxy->m_poRealDriver;
+    if( poRealDriver == nullptr )
+        return FALSE;
+    if( poRealDriver->pfnIdentifyEx )
+        return poRealDriver->pfnIdentifyEx(poRealDriver, poOpenInfo);
+    if( poRealDriver->pfnIdentify )
+        return poRealDriver->pfnIdentify(poOpenInfo);
+    return GDAL_IDENTIFY_UNKNOWN;
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+GDALDataset* GDALPluginDriverProxy::Open( GDALDriver* poDriver,
+                                          GDALOpenInfo* poOpenInfo )
+{
+    auto poProxy = static_cast<GDALPluginDriverProxy*>(poDriver);
+    if( poProxy->HasPendingDeferredInit() )
+    {
+        if( !poProxy->MayHandle(poOpenInfo) )
+            return nullptr;
+        poProxy->RunDeferredInit();
+    }
+
+    GDALDriver* poRealDriver = poProxy->m_poRealDriver;
+    if( poRealDriver == nullptr )
+        return nullptr;
+    if( poRealDriver->pfnOpen )
+        return poRealDriver->pfnOpen(poOpenInfo);
+    if( poRealDriver->pfnOpenWithDriverArg )
+        return poRealDriver->pfnOpenWithDriverArg(poRealDriver, poOpenInfo);
+    return nullptr;
+}
+
+#endif  // GDAL_NO_AUTOLOAD
+
 /************************************************************************/
 /*                          AutoLoadDrivers()                           */
 /************************************************************************/
@@ -773,6 +1074,27 @@ char** GDALDriverManager::GetSearchPaths(const char* pszGDAL_DRIVER_PATH)
  *
  * Auto loading can be completely disabled by setting the GDAL_DRIVER_PATH
  * config option to "disable".
+ *
+ * Starting with GDAL 3.4, if a gdal_X.driverinfo (resp. ogr_X.driverinfo) file
+ * is found next to the shared library, the library is not loaded at that
+ * point. A proxy driver is registered instead, from the content of that file,
+ * and the library is loaded the first time the driver is needed, that is
+ * when a dataset name matches one of its DMD_EXTENSIONS or its
+ * DMD_CONNECTION_PREFIX, when an operation other than opening (creation,
+ * deletion, etc.) is requested, or when a metadata item not in the file is
+ * requested. The file contains KEY=VALUE lines, with a mandatory DRIVER key
+ * for the driver short name, and metadata items of the default domain,
+ * such as:
+ * <pre>
+ * DRIVER=X
+ * DMD_LONGNAME=X format
+ * DCAP_RASTER=YES
+ * DCAP_CREATE=YES
+ * DMD_EXTENSIONS=x
+ * DMD_CONNECTION_PREFIX=X:
+ * </pre>
+ * Those files are ignored if the GDAL_LAZY_DRIVER_REGISTRATION configuration
+ * option is set to NO.
  */
 
 void GDALDriverManager::AutoLoadDrivers()
@@ -808,6 +1130,9 @@ void GDALDriverManager::AutoLoadDrivers()
 
     osABIVersion.Printf( "%d.%d", GDAL_VERSION_MAJOR, GDAL_VERSION_MINOR );
 
+    const bool bLazyRegistration = CPLTestBool(
+        CPLGetConfigOption("GDAL_LAZY_DRIVER_REGISTRATION", "YES"));
+
 /* -------------------------------------------------------------------- */
 /*      Scan each directory looking for files starting with gdal_       */
 /* -------------------------------------------------------------------- */
@@ -852,6 +1177,44 @@ void GDALDriverManager::AutoLoadDrivers()
                 = CPLFormFilename( osABISpecificDir,
                                    papszFiles[iFile], nullptr );
 
+/* -------------------------------------------------------------------- */
+/*      Defer the loading of the library if it comes with a             */
+/*      description of its driver.                                      */
+/* -------------------------------------------------------------------- */
+            if( bLazyRegistration )
+            {
+                const CPLString osLibraryName(pszFilename);
+                const CPLString osDescriptionFile(
+                    CPLResetExtension(pszFilename, "driverinfo"));
+                VSIStatBufL sDescStatBuf;
+                if( VSIStatL(osDescriptionFile, &sDescStatBuf) == 0 )
+                {
+                    auto poProxy = GDALPluginDriverProxy::Create(
+                        osLibraryName, osFuncName, osDescriptionFile);
+                    if( poProxy != nullptr )
+                    {
+                        GDALDriverManager* poDriverManager =
+                            GetGDALDriverManager();
+                        if( poDriverManager->GetDriverByName(
+                                        poProxy->GetDescription()) != nullptr )
+                        {
+                            delete poProxy;
+                        }
+                        else
+                        {
+                            CPLDebug( "GDAL",
+                                      "Deferred registration of %s from %s.",
+                                      poProxy->GetDescription(),
+                                      osLibraryName.c_str() );
+                            poDriverManager->RegisterDriver(poProxy);
+                        }
+                        continue;
+                    }
+                }
+                pszFilename = CPLFormFilename( osABISpecificDir,
+                                               papszFiles[iFile], nullptr );
+            }
+
             CPLErrorReset();
             CPLPushErrorHandler(CPLQuietErrorHandler);
             void *pRegister = CPLGetSymbol( pszFilename, osFuncName );
@@ -0,0 +1,659 @@
+/**********************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Chunk-oriented reading of multidimensional arrays, with a
+ *           process-wide cache of decoded chunks
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdalmdarraychunkreader.h"
+#include "gdal_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+namespace
+{
+
+/************************************************************************/
+/*                          GDALMDChunkCache                            */
+/************************************************************************/
+
+// Process-wide LRU cache of decoded chunks, keyed by a string made of the
+// key prefix of the array and the chunk indices.
+class GDALMDChunkCache
+{
+    typedef std::shared_ptr<const std::vector<GByte>> ChunkPtr;
+    typedef std::list<std::pair<std::string, ChunkPtr>> ListType;
+
+    std::mutex m_oMutex{};
+    ListType m_oList{};
+    std::map<std::string, ListType::iterator> m_oMap{};
+    size_t m_nSize = 0;
+
+    void EvictIfNeeded(size_t nMaxSize)
+    {
+        while( m_nSize > nMaxSize && !m_oList.empty() )
+        {
+            m_nSize -= m_oList.back().second->size();
+            m_oMap.erase(m_oList.back().first);
+            m_oList.pop_back();
+        }
+    }
+
+public:
+    ChunkPtr Get(const std::string& osKey)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMap.find(osKey);
+        if( oIter == m_oMap.end() )
+            return nullptr;
+        m_oList.splice(m_oList.begin(), m_oList, oIter->second);
+        return oIter->second->second;
+    }
+
+    void Insert(const std::string& osKey, const ChunkPtr& poChunk,
+                size_t nMaxSize)
+    {
+        if( poChunk->size() > nMaxSize )
+            return;
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( m_oMap.find(osKey) != m_oMap.end() )
+            return;
+        m_oList.emplace_front(osKey, poChunk);
+        m_oMap[osKey] = m_oList.begin();
+        m_nSize += poChunk->size();
+        EvictIfNeeded(nMaxSize);
+    }
+
+    void Invalidate(const std::string& osKeyPrefix)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMap.lower_bound(osKeyPrefix);
+        while( oIter != m_oMap.end() &&
+               oIter->first.compare(0, osKeyPrefix.size(), osKeyPrefix) == 0 )
+        {
+            m_nSize -= oIter->second->second->size();
+            m_oList.erase(oIter->second);
+            oIter = m_oMap.erase(oIter);
+        }
+    }
+};
+
+GDALMDChunkCache& GetChunkCache()
+{
+    static GDALMDChunkCache oCache;
+    return oCache;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                        GDALMDArrayChunkReader()                      */
+/************************************************************************/
+
+GDALMDArrayChunkReader::GDALMDArrayChunkReader(
+                                const std::string& osKeyPrefix,
+                                const std::vector<GUInt64>& anArraySize,
+                                const std::vector<GUInt64>& anChunkSize,
+                                const GDALExtendedDataType& oDT,
+                                FetchFunc fetchFunc,
+                                DecodeFunc decodeFunc):
+    m_osKeyPrefix(osKeyPrefix),
+    m_anArraySize(anArraySize),
+    m_anChunkSize(anChunkSize),
+    m_oDT(oDT),
+    m_fetchFunc(fetchFunc),
+    m_decodeFunc(decodeFunc)
+{
+    if( m_anArraySize.empty() ||
+        m_anArraySize.size() != m_anChunkSize.size() ||
+        m_oDT.GetClass() != GEDTC_NUMERIC )
+    {
+        return;
+    }
+    GUInt64 nChunkBytes = m_oDT.GetSize();
+    for( const auto nChunkSize: m_anChunkSize )
+    {
+        if( nChunkSize == 0 ||
+            nChunkSize > std::numeric_limits<int>::max() / nChunkBytes )
+        {
+            return;
+        }
+        nChunkBytes *= nChunkSize;
+    }
+    m_nChunkBytes = static_cast<size_t>(nChunkBytes);
+}
+
+/************************************************************************/
+/*                           GetNewKeyPrefix()                          */
+/************************************************************************/
+
+/** Return a unique prefix, that drivers typically assign to each opened
+ * dataset, and complete with an identifier of the array. */
+std::string GDALMDArrayChunkReader::GetNewKeyPrefix()
+{
+    static std::atomic<GUIntBig> nCounter(0);
+    return CPLSPrintf(CPL_FRMT_GUIB ":", static_cast<GUIntBig>(++nCounter));
+}
+
+/************************************************************************/
+/*                           InvalidateCache()                          */
+/************************************************************************/
+
+/** Remove from the cache all chunks whose key starts with osKeyPrefix. */
+void GDALMDArrayChunkReader::InvalidateCache(const std::string& osKeyPrefix)
+{
+    GetChunkCache().Invalidate(osKeyPrefix);
+}
+
+/************************************************************************/
+/*                           GetCacheMaxSize()                          */
+/************************************************************************/
+
+/** Return the maximum size in bytes of the cache, as set by the
+ * GDAL_MDARRAY_CHUNK_CACHE_SIZE configuration option (in MB). */
+size_t GDALMDArrayChunkReader::GetCacheMaxSize()
+{
+    const GIntBig nMB = CPLAtoGIntBig(
+        CPLGetConfigOption("GDAL_MDARRAY_CHUNK_CACHE_SIZE", "64"));
+    if( nMB <= 0 )
+        return 0;
+    if( static_cast<GUIntBig>(nMB) >
+            std::numeric_limits<size_t>::max() / (1024 * 1024) )
+        return std::numeric_limits<size_t>::max();
+    return static_cast<size_t>(nMB) * 1024 * 1024;
+}
+
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+/** Return the number of threads to use, as set by the GDAL_NUM_THREADS
+ * configuration option (defaults to 1). */
+int GDALMDArrayChunkReader::GetNumThreads()
+{
+    const char* pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+    return std::max(1, std::min(nThreads, 1024));
+}
+
+/************************************************************************/
+/*                              IsUsable()                              */
+/************************************************************************/
+
+/** Return whether Read() can be used. The chunked path is worth using only
+ * if chunks can be cached, or if their decoding can be parallelized. */
+bool GDALMDArrayChunkReader::IsUsable() const
+{
+    if( m_nChunkBytes == 0 )
+        return false;
+    return m_nChunkBytes <= GetCacheMaxSize() || CanDecodeInParallel();
+}
+
+/************************************************************************/
+/*                         CanDecodeInParallel()                        */
+/************************************************************************/
+
+bool GDALMDArrayChunkReader::CanDecodeInParallel() const
+{
+    return m_decodeFunc != nullptr && GetNumThreads() > 1;
+}
+
+/************************************************************************/
+/*                            GetChunkKey()                             */
+/************************************************************************/
+
+std::string GDALMDArrayChunkReader::GetChunkKey(
+                            const std::vector<GUInt64>& anChunkIdx) const
+{
+    std::string osKey(m_osKeyPrefix);
+    for( const auto nIdx: anChunkIdx )
+    {
+        osKey += CPLSPrintf(CPL_FRMT_GUIB, static_cast<GUIntBig>(nIdx));
+        osKey += ',';
+    }
+    return osKey;
+}
+
+/************************************************************************/
+/*                         GetSampleRangeInChunk()                      */
+/************************************************************************/
+
+// Return the range [nFirst, nLast] of the indices k in [0, nCount-1] such
+// that nStart + k * nStep is in [nChunkStart, nChunkEnd[
+static bool GetSampleRangeInChunk(GUInt64 nStart, size_t nCount, GUInt64 nStep,
+                                  GUInt64 nChunkStart, GUInt64 nChunkEnd,
+                                  size_t& nFirst, size_t& nLast)
+{
+    GUInt64 nK0 = 0;
+    if( nChunkStart > nStart )
+        nK0 = (nChunkStart - nStart + nStep - 1) / nStep;
+    if( nK0 >= nCount )
+        return false;
+    if( nChunkEnd <= nStart )
+        return false;
+    GUInt64 nK1 = (nChunkEnd - 1 - nStart) / nStep;
+    if( nK1 >= nCount )
+        nK1 = nCount - 1;
+    if( nK0 > nK1 )
+        return false;
+    nFirst = static_cast<size_t>(nK0);
+    nLast = static_cast<size_t>(nK1);
+    return true;
+}
+
+/************************************************************************/
+/*                          CopyChunkAndBuffer()                        */
+/************************************************************************/
+
+// Copy the samples of the request that are inside the chunk, from the chunk
+// to the buffer, or the reverse. Steps must be strictly positive.
+static void CopyChunkAndBuffer(bool bChunkToBuffer,
+                               const std::vector<GUInt64>& anChunkSize,
+                               const GDALExtendedDataType& oChunkDT,
+                               const std::vector<GUInt64>& anChunkIdx,
+                               GByte* pabyChunk,
+                               const GUInt64* arrayStartIdx,
+                               const size_t* count,
+                               const GInt64* arrayStep,
+                               const GPtrDiff_t* bufferStride,
+                               const GDALExtendedDataType& bufferDataType,
+                               GByte* pabyBuffer)
+{
+    const size_t nDims = anChunkSize.size();
+    const size_t nChunkDTSize = oChunkDT.GetSize();
+    const size_t nBufferDTSize = bufferDataType.GetSize();
+    std::vector<size_t> anFirst(nDims), anLast(nDims);
+    std::vector<GUInt64> anStep(nDims);
+    std::vector<size_t> anChunkStride(nDims);
+    size_t nStride = 1;
+    for( size_t i = nDims; i > 0; )
+    {
+        --i;
+        anChunkStride[i] = nStride;
+        nStride *= static_cast<size_t>(anChunkSize[i]);
+        anStep[i] = count[i] == 1 ? 1 : static_cast<GUInt64>(arrayStep[i]);
+        const GUInt64 nChunkStart = anChunkIdx[i] * anChunkSize[i];
+        if( !GetSampleRangeInChunk(arrayStartIdx[i], count[i], anStep[i],
+                                   nChunkStart,
+                                   nChunkStart + anChunkSize[i],
+                                   anFirst[i], anLast[i]) )
+        {
+            return;
+        }
+    }
+
+    const size_t iLast = nDims - 1;
+    const size_t nInnerCount = anLast[iLast] - anFirst[iLast] + 1;
+    const int nChunkInnerStride = nInnerCount == 1 ? 0 :
+        static_cast<int>(anStep[iLast] * nChunkDTSize);
+    const int nBufferInnerStride =
+        static_cast<int>(bufferStride[iLast] * static_cast<GPtrDiff_t>(nBufferDTSize));
+    const GDALDataType eChunkDT = oChunkDT.GetNumericDataType();
+    const GDALDataType eBufferDT = bufferDataType.GetNumericDataType();
+
+    std::vector<size_t> anK(anFirst);
+    while( true )
+    {
+        size_t nChunkOffset = 0;
+        GPtrDiff_t nBufferOffset = 0;
+        for( size_t i = 0; i < nDims; ++i )
+        {
+            const GUInt64 nChunkStart = anChunkIdx[i] * anChunkSize[i];
+            nChunkOffset += static_cast<size_t>(
+                arrayStartIdx[i] + anK[i] * anStep[i] - nChunkStart) *
+                    anChunkStride[i];
+            nBufferOffset += static_cast<GPtrDiff_t>(anK[i]) * bufferStride[i];
+        }
+        GByte* pabyChunkPtr = pabyChunk + nChunkOffset * nChunkDTSize;
+        GByte* pabyBufferPtr = pabyBuffer +
+            nBufferOffset * static_cast<GPtrDiff_t>(nBufferDTSize);
+        if( bChunkToBuffer )
+        {
+            GDALCopyWords64(pabyChunkPtr, eChunkDT, nChunkInnerStride,
+                            pabyBufferPtr, eBufferDT, nBufferInnerStride,
+                            static_cast<GPtrDiff_t>(nInnerCount));
+        }
+        else
+        {
+            GDALCopyWords64(pabyBufferPtr, eBufferDT, nBufferInnerStride,
+                            pabyChunkPtr, eChunkDT, nChunkInnerStride,
+                            static_cast<GPtrDiff_t>(nInnerCount));
+        }
+
+        // Advance to the next line, in C order
+        size_t i = iLast;
+        while( i > 0 )
+        {
+            --i;
+            if( anK[i] < anLast[i] )
+            {
+                ++anK[i];
+                break;
+            }
+            anK[i] = anFirst[i];
+            if( i == 0 )
+                return;
+        }
+        if( iLast == 0 )
+            return;
+    }
+}
+
+/************************************************************************/
+/*                          CopyChunkToBuffer()                         */
+/************************************************************************/
+
+/** Copy the samples of a request (with strictly positive steps) that are
+ * inside a decoded chunk to the user buffer. */
+void GDALMDArrayChunkReader::CopyChunkToBuffer(
+                                const std::vector<GUInt64>& anChunkSize,
+                                const GDALExtendedDataType& oChunkDT,
+                                const std::vector<GUInt64>& anChunkIdx,
+                                const GByte* pabyChunk,
+                                const GUInt64* arrayStartIdx,
+                                const size_t* count,
+                                const GInt64* arrayStep,
+                                const GPtrDiff_t* bufferStride,
+                                const GDALExtendedDataType& bufferDataType,
+                                void* pDstBuffer)
+{
+    CopyChunkAndBuffer(true, anChunkSize, oChunkDT, anChunkIdx,
+                       const_cast<GByte*>(pabyChunk),
+                       arrayStartIdx, count, arrayStep, bufferStride,
+                       bufferDataType, static_cast<GByte*>(pDstBuffer));
+}
+
+/************************************************************************/
+/*                          CopyBufferToChunk()                         */
+/************************************************************************/
+
+/** Reverse of CopyChunkToBuffer(), for drivers that write chunks. */
+void GDALMDArrayChunkReader::CopyBufferToChunk(
+                                const std::vector<GUInt64>& anChunkSize,
+                                const GDALExtendedDataType& oChunkDT,
+                                const std::vector<GUInt64>& anChunkIdx,
+                                GByte* pabyChunk,
+                                const GUInt64* arrayStartIdx,
+                                const size_t* count,
+                                const GInt64* arrayStep,
+                                const GPtrDiff_t* bufferStride,
+                                const GDALExtendedDataType& bufferDataType,
+                                const void* pSrcBuffer)
+{
+    CopyChunkAndBuffer(false, anChunkSize, oChunkDT, anChunkIdx, pabyChunk,
+                       arrayStartIdx, count, arrayStep, bufferStride,
+                       bufferDataType,
+                       static_cast<GByte*>(const_cast<void*>(pSrcBuffer)));
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+namespace
+{
+struct DecodeJob
+{
+    const GDALMDArrayChunkReader::DecodeFunc* pDecodeFunc = nullptr;
+    std::vector<GUInt64> anChunkIdx{};
+    std::vector<GByte> abyRaw{};
+    std::shared_ptr<std::vector<GByte>> poDecoded{};
+    bool bOK = false;
+};
+
+void DecodeJobFunc(void* pData)
+{
+    auto psJob = static_cast<DecodeJob*>(pData);
+    psJob->bOK = (*psJob->pDecodeFunc)(psJob->anChunkIdx, psJob->abyRaw,
+                                       *(psJob->poDecoded));
+    // Release the raw buffer as soon as possible
+    std::vector<GByte>().swap(psJob->abyRaw);
+}
+} // namespace
+
+/** Read a region of the array.
+ *
+ * Same semantics as GDALAbstractMDArray::IRead(), except that null steps
+ * are not supported.
+ *
+ * Requests that cannot be handled, or that would not benefit from the
+ * chunked path (chunks too large to be cached, and a single chunk to decode
+ * or no parallel decoding), are rejected before pDstBuffer is modified.
+ * When an error occurs while fetching or decoding chunks, pDstBuffer may
+ * have been partially written: callers that fallback to their generic code
+ * path must fully overwrite the requested region.
+ *
+ * @return false if the request cannot be handled (in which case the caller
+ * should fallback to its generic code path), or if an error occurred.
+ */
+bool GDALMDArrayChunkReader::Read(const GUInt64* arrayStartIdx,
+                                  const size_t* count,
+                                  const GInt64* arrayStep,
+                                  const GPtrDiff_t* bufferStride,
+                                  const GDALExtendedDataType& bufferDataType,
+                                  void* pDstBuffer) const
+{
+    if( m_nChunkBytes == 0 ||
+        bufferDataType.GetClass() != GEDTC_NUMERIC )
+    {
+        return false;
+    }
+
+    const size_t nDims = m_anArraySize.size();
+
+    // Turn negative steps into positive ones, by starting from the other
+    // end of the request, and going backwards in the buffer.
+    std::vector<GUInt64> anStartIdx(arrayStartIdx, arrayStartIdx + nDims);
+    std::vector<GInt64> anStep(nDims);
+    std::vector<GPtrDiff_t> anBufferStride(bufferStride, bufferStride + nDims);
+    GByte* pabyDstBuffer = static_cast<GByte*>(pDstBuffer);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        if( count[i] == 0 )
+            return true;
+        anStep[i] = count[i] == 1 ? 1 : arrayStep[i];
+        if( anStep[i] < 0 )
+        {
+            const GUInt64 nBackwards =
+                (count[i] - 1) * static_cast<GUInt64>(-anStep[i]);
+            if( nBackwards > anStartIdx[i] )
+                return false;
+            anStartIdx[i] -= nBackwards;
+            pabyDstBuffer += static_cast<GPtrDiff_t>(count[i] - 1) *
+                anBufferStride[i] *
+                static_cast<GPtrDiff_t>(bufferDataType.GetSize());
+            anStep[i] = -anStep[i];
+            anBufferStride[i] = -anBufferStride[i];
+        }
+    }
+    arrayStartIdx = anStartIdx.data();
+    arrayStep = anStep.data();
+    bufferStride = anBufferStride.data();
+    pDstBuffer = pabyDstBuffer;
+
+    std::vector<GUInt64> anFirstChunk(nDims), anLastChunk(nDims);
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        if( count[i] > 1 && arrayStep[i] <= 0 )
+            return false;
+        const GUInt64 nStep = count[i] == 1 ? 1 : static_cast<GUInt64>(arrayStep[i]);
+        const GUInt64 nEnd = arrayStartIdx[i] + (count[i] - 1) * nStep;
+        if( nEnd >= m_anArraySize[i] )
+            return false;
+        anFirstChunk[i] = arrayStartIdx[i] / m_anChunkSize[i];
+        anLastChunk[i] = nEnd / m_anChunkSize[i];
+    }
+    if( std::abs(bufferStride[nDims - 1]) >
+            std::numeric_limits<int>::max() /
+                static_cast<GPtrDiff_t>(bufferDataType.GetSize()) )
+    {
+        return false;
+    }
+
+    // Chunks larger than the cache are never cached: decoding whole chunks
+    // only pays off if several of them can be decoded in parallel.
+    auto& oCache = GetChunkCache();
+    size_t nCacheMaxSize = GetCacheMaxSize();
+    if( m_nChunkBytes > nCacheMaxSize )
+    {
+        if( !CanDecodeInParallel() )
+            return false;
+        nCacheMaxSize = 0;
+    }
+
+    // Enumerate the chunks that contain at least one requested sample, and
+    // serve the ones already in cache.
+    std::vector<std::vector<GUInt64>> aanMissingChunks;
+    std::vector<GUInt64> anChunkIdx(anFirstChunk);
+    while( true )
+    {
+        bool bHasSamples = true;
+        for( size_t i = 0; i < nDims && bHasSamples; ++i )
+        {
+            size_t nFirst = 0, nLast = 0;
+            const GUInt64 nChunkStart = anChunkIdx[i] * m_anChunkSize[i];
+            bHasSamples = GetSampleRangeInChunk(
+                arrayStartIdx[i], count[i],
+                count[i] == 1 ? 1 : static_cast<GUInt64>(arrayStep[i]),
+                nChunkStart, nChunkStart + m_anChunkSize[i], nFirst, nLast);
+        }
+        if( bHasSamples )
+        {
+            auto poChunk = nCacheMaxSize > 0 ?
+                oCache.Get(GetChunkKey(anChunkIdx)) : nullptr;
+            if( poChunk )
+            {
+                CopyChunkToBuffer(m_anChunkSize, m_oDT, anChunkIdx,
+                                  poChunk->data(),
+                                  arrayStartIdx, count, arrayStep,
+                                  bufferStride, bufferDataType, pDstBuffer);
+            }
+            else
+            {
+                aanMissingChunks.push_back(anChunkIdx);
+            }
+        }
+
+        size_t i = nDims;
+        bool bFinished = true;
+        while( i > 0 )
+        {
+            --i;
+            if( anChunkIdx[i] < anLastChunk[i] )
+            {
+                ++anChunkIdx[i];
+                bFinished = false;
+                break;
+            }
+            anChunkIdx[i] = anFirstChunk[i];
+        }
+        if( bFinished )
+            break;
+    }
+
+    if( aanMissingChunks.empty() )
+        return true;
+    // Nothing has been written to pDstBuffer if the cache is not used.
+    if( nCacheMaxSize == 0 && aanMissingChunks.size() == 1 )
+        return false;
+
+    // Fetch missing chunks by batches, so as to bound memory usage, and
+    // decode each batch in parallel.
+    const int nThreads = m_decodeFunc ? GetNumThreads() : 1;
+    std::unique_ptr<CPLJobQueue> poQueue;
+    if( nThreads > 1 && aanMissingChunks.size() > 1 )
+    {
+        auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poQueue = poThreadPool->CreateJobQueue();
+    }
+    constexpr size_t MAX_BATCH_BYTES = 256 * 1024 * 1024;
+    const size_t nBatchSize = std::max<size_t>(1,
+        std::min<size_t>(poQueue ? 2 * nThreads : 1,
+                         MAX_BATCH_BYTES / m_nChunkBytes));
+
+    for( size_t iStart = 0; iStart < aanMissingChunks.size();
+                                                iStart += nBatchSize )
+    {
+        const size_t nJobs =
+            std::min(nBatchSize, aanMissingChunks.size() - iStart);
+        std::vector<DecodeJob> asJobs(nJobs);
+        for( size_t j = 0; j < nJobs; ++j )
+        {
+            auto& sJob = asJobs[j];
+            sJob.pDecodeFunc = &m_decodeFunc;
+            sJob.anChunkIdx = aanMissingChunks[iStart + j];
+            sJob.poDecoded = std::make_shared<std::vector<GByte>>();
+            if( !m_fetchFunc(sJob.anChunkIdx, sJob.abyRaw) )
+            {
+                if( poQueue )
+                    poQueue->WaitCompletion();
+                return false;
+            }
+            if( !m_decodeFunc )
+            {
+                sJob.poDecoded->swap(sJob.abyRaw);
+                sJob.bOK = true;
+            }
+            else if( !poQueue || !poQueue->SubmitJob(DecodeJobFunc, &sJob) )
+            {
+                DecodeJobFunc(&sJob);
+            }
+        }
+        if( poQueue )
+            poQueue->WaitCompletion();
+
+        for( const auto& sJob: asJobs )
+        {
+            if( !sJob.bOK || sJob.poDecoded->size() != m_nChunkBytes )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Cannot decode chunk %s",
+                         GetChunkKey(sJob.anChunkIdx).c_str());
+                return false;
+            }
+            CopyChunkToBuffer(m_anChunkSize, m_oDT, sJob.anChunkIdx,
+                              sJob.poDecoded->data(),
+                              arrayStartIdx, count, arrayStep,
+                              bufferStride, bufferDataType, pDstBuffer);
+            if( nCacheMaxSize > 0 )
+                oCache.Insert(GetChunkKey(sJob.anChunkIdx), sJob.poDecoded,
+                              nCacheMaxSize);
+        }
+    }
+    return true;
+}
+
+//! @endcond
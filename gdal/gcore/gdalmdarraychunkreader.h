@@ -0,0 +1,130 @@
+/**********************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Chunk-oriented reading of multidimensional arrays, with a
+ *           process-wide cache of decoded chunks
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDALMDARRAYCHUNKREADER_H
+#define GDALMDARRAYCHUNKREADER_H
+
+//! @cond Doxygen_Suppress
+
+#include "gdal_priv.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/************************************************************************/
+/*                       GDALMDArrayChunkReader                         */
+/************************************************************************/
+
+/** Helper for drivers of chunked multidimensional arrays.
+ *
+ * A request is split into the chunks it intersects. Chunks already present
+ * in the process-wide cache are served from it. Missing chunks are fetched
+ * sequentially from the calling thread (as the underlying libraries are
+ * generally not thread-safe), and then decoded in parallel with the global
+ * thread pool, before being inserted in the cache.
+ *
+ * Decoded chunks are always laid out as full chunks in C order, even for
+ * chunks partially outside of the array.
+ */
+class CPL_DLL GDALMDArrayChunkReader
+{
+public:
+    /** Fetch the raw content of the chunk whose indices (in chunk units)
+     * are passed. Called from the thread that calls Read(). */
+    typedef std::function<bool(const std::vector<GUInt64>& anChunkIdx,
+                               std::vector<GByte>& abyRaw)> FetchFunc;
+
+    /** Decode a raw chunk into a full chunk. Must be thread-safe. */
+    typedef std::function<bool(const std::vector<GUInt64>& anChunkIdx,
+                               const std::vector<GByte>& abyRaw,
+                               std::vector<GByte>& abyDecoded)> DecodeFunc;
+
+    GDALMDArrayChunkReader(const std::string& osKeyPrefix,
+                           const std::vector<GUInt64>& anArraySize,
+                           const std::vector<GUInt64>& anChunkSize,
+                           const GDALExtendedDataType& oDT,
+                           FetchFunc fetchFunc,
+                           DecodeFunc decodeFunc = nullptr);
+
+    bool IsUsable() const;
+
+    bool Read(const GUInt64* arrayStartIdx,
+              const size_t* count,
+              const GInt64* arrayStep,
+              const GPtrDiff_t* bufferStride,
+              const GDALExtendedDataType& bufferDataType,
+              void* pDstBuffer) const;
+
+    static std::string GetNewKeyPrefix();
+    static void InvalidateCache(const std::string& osKeyPrefix);
+    static size_t GetCacheMaxSize();
+    static int GetNumThreads();
+
+    static void CopyChunkToBuffer(const std::vector<GUInt64>& anChunkSize,
+                                  const GDALExtendedDataType& oChunkDT,
+                                  const std::vector<GUInt64>& anChunkIdx,
+                                  const GByte* pabyChunk,
+                                  const GUInt64* arrayStartIdx,
+                                  const size_t* count,
+                                  const GInt64* arrayStep,
+                                  const GPtrDiff_t* bufferStride,
+                                  const GDALExtendedDataType& bufferDataType,
+                                  void* pDstBuffer);
+
+    static void CopyBufferToChunk(const std::vector<GUInt64>& anChunkSize,
+                                  const GDALExtendedDataType& oChunkDT,
+                                  const std::vector<GUInt64>& anChunkIdx,
+                                  GByte* pabyChunk,
+                                  const GUInt64* arrayStartIdx,
+                                  const size_t* count,
+                                  const GInt64* arrayStep,
+                                  const GPtrDiff_t* bufferStride,
+                                  const GDALExtendedDataType& bufferDataType,
+                                  const void* pSrcBuffer);
+
+private:
+    std::string m_osKeyPrefix;
+    std::vector<GUInt64> m_anArraySize;
+    std::vector<GUInt64> m_anChunkSize;
+    GDALExtendedDataType m_oDT;
+    FetchFunc m_fetchFunc;
+    DecodeFunc m_decodeFunc;
+    size_t m_nChunkBytes = 0;
+
+    std::string GetChunkKey(const std::vector<GUInt64>& anChunkIdx) const;
+    bool CanDecodeInParallel() const;
+
+    GDALMDArrayChunkReader(const GDALMDArrayChunkReader&) = delete;
+    GDALMDArrayChunkReader& operator=(const GDALMDArrayChunkReader&) = delete;
+};
+
+//! @endcond
+
+#endif // GDALMDARRAYCHUNKREADER_H
@@ -30,12 +30,16 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <queue>
 #include <set>
 
 #include "gdal_priv.h"
 #include "gdal_pam.h"
 #include "cpl_safemaths.hpp"
+#include "gdal_thread_pool.h"
+#include "gdalmdarraychunkreader.h"
 
 #if defined(__clang__) || defined(_MSC_VER)
 #define COMPILER_WARNS_ABOUT_ABSTRACT_VBASE_INIT
@@ -1827,29 +1831,16 @@ std::vector<GUInt64> GDALAbstractMDArray::GetBlockSize() const
 }
 
 /************************************************************************/
-/*                       GetProcessingChunkSize()                       */
+/*                GetProcessingChunkSizeFromBlockSize()                 */
 /************************************************************************/
 
-/** \brief Return an optimal chunk size for read/write oerations, given the natural
- * block size and memory constraints specified.
- *
- * This method will use GetBlockSize() to define a chunk whose dimensions are
- * multiple of those returned by GetBlockSize() (unless the block define by
- * GetBlockSize() is larger than nMaxChunkMemory, in which case it will be
- * returned by this method).
- *
- * This is the same as the C function GDALMDArrayGetProcessingChunkSize().
- *
- * @param nMaxChunkMemory Maximum amount of memory, in bytes, to use for the chunk.
- *
- * @return the chunk size, in number of elements along each dimension.
- */
-std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunkMemory) const
+static std::vector<size_t> GetProcessingChunkSizeFromBlockSize(
+                const std::vector<std::shared_ptr<GDALDimension>>& dims,
+                size_t nDTSize,
+                const std::vector<GUInt64>& blockSize,
+                size_t nMaxChunkMemory)
 {
-    const auto& dims = GetDimensions();
-    const auto& nDTSize = GetDataType().GetSize();
     std::vector<size_t> anChunkSize;
-    auto blockSize = GetBlockSize();
     CPLAssert( blockSize.size() == dims.size() );
     size_t nChunkSize = nDTSize;
     bool bOverflow = false;
@@ -1931,6 +1922,32 @@ std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunk
     return anChunkSize;
 }
 
+/************************************************************************/
+/*                       GetProcessingChunkSize()                       */
+/************************************************************************/
+
+/** \brief Return an optimal chunk size for read/write oerations, given the natural
+ * block size and memory constraints specified.
+ *
+ * This method will use GetBlockSize() to define a chunk whose dimensions are
+ * multiple of those returned by GetBlockSize() (unless the block define by
+ * GetBlockSize() is larger than nMaxChunkMemory, in which case it will be
+ * returned by this method).
+ *
+ * This is the same as the C function GDALMDArrayGetProcessingChunkSize().
+ *
+ * @param nMaxChunkMemory Maximum amount of memory, in bytes, to use for the chunk.
+ *
+ * @return the chunk size, in number of elements along each dimension.
+ */
+std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunkMemory) const
+{
+    return GetProcessingChunkSizeFromBlockSize(GetDimensions(),
+                                               GetDataType().GetSize(),
+                                               GetBlockSize(),
+                                               nMaxChunkMemory);
+}
+
 /************************************************************************/
 /*                             SetUnit()                                */
 /************************************************************************/
@@ -3047,6 +3064,305 @@ bool GDALMDArray::CopyFromAllExceptValues(const GDALMDArray* poSrcArray,
     return true;
 }
 
+/************************************************************************/
+/*                          GetCopyChunkSize()                          */
+/************************************************************************/
+
+// Return the size of the units used by CopyFrom(). They are made of a whole
+// number of blocks of both the source and the target arrays when possible,
+// so that each source block is read once and each target block is written
+// once.
+static std::vector<size_t> GetCopyChunkSize(const GDALMDArray* poSrcArray,
+                                            const GDALMDArray* poDstArray,
+                                            size_t nMaxChunkMemory)
+{
+    const auto& dims = poSrcArray->GetDimensions();
+    const size_t nDTSize = poSrcArray->GetDataType().GetSize();
+    const auto anSrcBlockSize = poSrcArray->GetBlockSize();
+    const auto anDstBlockSize = poDstArray->GetBlockSize();
+    if( anSrcBlockSize.size() != dims.size() ||
+        anDstBlockSize.size() != dims.size() )
+    {
+        return poDstArray->GetProcessingChunkSize(nMaxChunkMemory);
+    }
+
+    std::vector<GUInt64> anBlockSize(dims.size());
+    double dfBlockBytes = static_cast<double>(nDTSize);
+    for( size_t i = 0; i < dims.size(); i++ )
+    {
+        const GUInt64 nSrc = anSrcBlockSize[i];
+        const GUInt64 nDst = anDstBlockSize[i];
+        GUInt64 nBlock;
+        if( nSrc == 0 )
+            nBlock = nDst;
+        else if( nDst == 0 )
+            nBlock = nSrc;
+        else
+        {
+            // Least common multiple of both block sizes
+            GUInt64 a = nSrc;
+            GUInt64 b = nDst;
+            while( b != 0 )
+            {
+                const GUInt64 r = a % b;
+                a = b;
+                b = r;
+            }
+            const GUInt64 nSrcMul = nSrc / a;
+            nBlock = nSrcMul > std::numeric_limits<GUInt64>::max() / nDst ?
+                        std::numeric_limits<GUInt64>::max() : nSrcMul * nDst;
+        }
+        // A unit spanning the whole dimension is aligned on both layouts
+        nBlock = std::min(nBlock, dims[i]->GetSize());
+        anBlockSize[i] = nBlock;
+        dfBlockBytes *= static_cast<double>(std::max<GUInt64>(1, nBlock));
+    }
+    if( dfBlockBytes > static_cast<double>(nMaxChunkMemory) )
+    {
+        // Cannot honour both layouts within the memory budget: favor the
+        // target one, as partial writes are generally more costly than
+        // partial reads.
+        anBlockSize = anDstBlockSize;
+    }
+    return GetProcessingChunkSizeFromBlockSize(dims, nDTSize, anBlockSize,
+                                               nMaxChunkMemory);
+}
+
+/************************************************************************/
+/*                             CopyPipeline                             */
+/************************************************************************/
+
+// Number of buffers used when reading and writing are pipelined: one being
+// read, one being written, and one pending.
+constexpr size_t COPY_PIPELINE_BUFFERS = 3;
+
+struct CopyPipeline
+{
+    GDALMDArray* poDstArray = nullptr;
+    GDALProgressFunc pfnProgress = nullptr;
+    void* pProgressData = nullptr;
+    GUInt64 nCurCost = 0;
+    GUInt64 nTotalCost = 0;
+    GUInt64 nTotalBytesThisArray = 0;
+    bool bStop = false;
+    std::vector<std::vector<GByte>> aabyBuffers{};
+
+    struct PendingWrite
+    {
+        size_t iBuffer = 0;
+        std::vector<GUInt64> anStartIdx{};
+        std::vector<size_t> anCount{};
+    };
+
+    // Below members are only used when pipelining
+    const GDALMDArray* poSrcArray = nullptr;
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+    std::vector<size_t> anFreeBuffers{};
+    std::queue<PendingWrite> oQueue{};
+    GUInt64 nChunksWritten = 0;
+    bool bReaderDone = false;
+    bool bWriteError = false;
+
+    bool Write(const GDALExtendedDataType& dt,
+               size_t nDims,
+               const GUInt64* chunkArrayStartIdx,
+               const size_t* chunkCount,
+               GByte* pabyBuffer,
+               bool bSkipWrite = false);
+
+    bool Progress(GUInt64 iCurChunk, GUInt64 nChunkCount);
+
+    static bool ReadAndWrite(GDALAbstractMDArray* l_poSrcArray,
+                             const GUInt64* chunkArrayStartIdx,
+                             const size_t* chunkCount,
+                             GUInt64 iCurChunk,
+                             GUInt64 nChunkCount,
+                             void* pUserData);
+
+    static bool ReadAndQueue(GDALAbstractMDArray* l_poSrcArray,
+                             const GUInt64* chunkArrayStartIdx,
+                             const size_t* chunkCount,
+                             GUInt64 iCurChunk,
+                             GUInt64 nChunkCount,
+                             void* pUserData);
+
+    static void WriterJob(void* pData);
+};
+
+/************************************************************************/
+/*                        CopyPipeline::Write()                         */
+/************************************************************************/
+
+// Write a buffer into the target array, and release the dynamic memory of
+// its values. If bSkipWrite is set, only the latter is done.
+bool CopyPipeline::Write(const GDALExtendedDataType& dt,
+                         size_t nDims,
+                         const GUInt64* chunkArrayStartIdx,
+                         const size_t* chunkCount,
+                         GByte* pabyBuffer,
+                         bool bSkipWrite)
+{
+    bool bRet = !bSkipWrite &&
+        poDstArray->Write(chunkArrayStartIdx,
+                          chunkCount,
+                          nullptr, nullptr,
+                          dt,
+                          pabyBuffer);
+    if( dt.NeedsFreeDynamicMemory() )
+    {
+        const auto l_nDTSize = dt.GetSize();
+        GByte* ptr = pabyBuffer;
+        size_t nEltCount = 1;
+        for( size_t i = 0; i < nDims; ++i )
+        {
+            nEltCount *= chunkCount[i];
+        }
+        for( size_t i = 0; i < nEltCount; i++ )
+        {
+            dt.FreeDynamicMemory(ptr);
+            ptr += l_nDTSize;
+        }
+    }
+    return bRet;
+}
+
+/************************************************************************/
+/*                       CopyPipeline::Progress()                       */
+/************************************************************************/
+
+bool CopyPipeline::Progress(GUInt64 iCurChunk, GUInt64 nChunkCount)
+{
+    double dfCurCost = double(nCurCost) +
+        double(iCurChunk) / nChunkCount * nTotalBytesThisArray;
+    if( !pfnProgress(dfCurCost / nTotalCost, "", pProgressData) )
+    {
+        bStop = true;
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                     CopyPipeline::ReadAndWrite()                     */
+/************************************************************************/
+
+bool CopyPipeline::ReadAndWrite(GDALAbstractMDArray* l_poSrcArray,
+                                const GUInt64* chunkArrayStartIdx,
+                                const size_t* chunkCount,
+                                GUInt64 iCurChunk,
+                                GUInt64 nChunkCount,
+                                void* pUserData)
+{
+    const auto dt(l_poSrcArray->GetDataType());
+    auto data = static_cast<CopyPipeline*>(pUserData);
+    GByte* pabyBuffer = &data->aabyBuffers[0][0];
+    if( !l_poSrcArray->Read(chunkArrayStartIdx,
+                            chunkCount,
+                            nullptr, nullptr,
+                            dt,
+                            pabyBuffer) )
+    {
+        return false;
+    }
+    if( !data->Write(dt, l_poSrcArray->GetDimensionCount(),
+                     chunkArrayStartIdx, chunkCount, pabyBuffer) )
+    {
+        return false;
+    }
+    return data->Progress(iCurChunk, nChunkCount);
+}
+
+/************************************************************************/
+/*                     CopyPipeline::ReadAndQueue()                     */
+/************************************************************************/
+
+// Read a copy unit into a free buffer, and queue it for WriterJob().
+bool CopyPipeline::ReadAndQueue(GDALAbstractMDArray* l_poSrcArray,
+                                const GUInt64* chunkArrayStartIdx,
+                                const size_t* chunkCount,
+                                GUInt64 /* iCurChunk */,
+                                GUInt64 nChunkCount,
+                                void* pUserData)
+{
+    const auto dt(l_poSrcArray->GetDataType());
+    auto data = static_cast<CopyPipeline*>(pUserData);
+    size_t iBuffer;
+    GUInt64 nChunksWritten;
+    {
+        std::unique_lock<std::mutex> oLock(data->oMutex);
+        data->oCV.wait(oLock, [data] {
+            return !data->anFreeBuffers.empty() || data->bWriteError; });
+        if( data->bWriteError )
+            return false;
+        iBuffer = data->anFreeBuffers.back();
+        data->anFreeBuffers.pop_back();
+        nChunksWritten = data->nChunksWritten;
+    }
+
+    if( !data->Progress(nChunksWritten, nChunkCount) ||
+        !l_poSrcArray->Read(chunkArrayStartIdx,
+                            chunkCount,
+                            nullptr, nullptr,
+                            dt,
+                            &data->aabyBuffers[iBuffer][0]) )
+    {
+        std::lock_guard<std::mutex> oLock(data->oMutex);
+        data->anFreeBuffers.push_back(iBuffer);
+        return false;
+    }
+
+    const size_t nDims = l_poSrcArray->GetDimensionCount();
+    PendingWrite oWrite;
+    oWrite.iBuffer = iBuffer;
+    oWrite.anStartIdx.assign(chunkArrayStartIdx, chunkArrayStartIdx + nDims);
+    oWrite.anCount.assign(chunkCount, chunkCount + nDims);
+    {
+        std::lock_guard<std::mutex> oLock(data->oMutex);
+        data->oQueue.push(std::move(oWrite));
+    }
+    data->oCV.notify_all();
+    return true;
+}
+
+/************************************************************************/
+/*                      CopyPipeline::WriterJob()                       */
+/************************************************************************/
+
+// Write the buffers queued by ReadAndQueue(), in the order they have been
+// read, until the reader is done.
+void CopyPipeline::WriterJob(void* pData)
+{
+    auto data = static_cast<CopyPipeline*>(pData);
+    const auto& dt(data->poSrcArray->GetDataType());
+    const size_t nDims = data->poSrcArray->GetDimensionCount();
+    std::unique_lock<std::mutex> oLock(data->oMutex);
+    while( true )
+    {
+        data->oCV.wait(oLock, [data] {
+            return !data->oQueue.empty() || data->bReaderDone; });
+        if( data->oQueue.empty() )
+            break;
+        PendingWrite oWrite(std::move(data->oQueue.front()));
+        data->oQueue.pop();
+        const bool bSkipWrite = data->bWriteError;
+        oLock.unlock();
+
+        const bool bOK = data->Write(dt, nDims, oWrite.anStartIdx.data(),
+                                     oWrite.anCount.data(),
+                                     &data->aabyBuffers[oWrite.iBuffer][0],
+                                     bSkipWrite);
+
+        oLock.lock();
+        if( bOK )
+            data->nChunksWritten++;
+        else
+            data->bWriteError = true;
+        data->anFreeBuffers.push_back(oWrite.iBuffer);
+        data->oCV.notify_all();
+    }
+}
+
 //! @endcond
 
 /************************************************************************/
@@ -3114,82 +3430,6 @@ bool GDALMDArray::CopyFrom(CPL_UNUSED GDALDataset* poSrcDS,
             count[i] = static_cast<size_t>(dims[i]->GetSize());
         }
 
-        struct CopyFunc
-        {
-            GDALMDArray* poDstArray = nullptr;
-            std::vector<GByte> abyTmp{};
-            GDALProgressFunc pfnProgress = nullptr;
-            void* pProgressData = nullptr;
-            GUInt64 nCurCost = 0;
-            GUInt64 nTotalCost = 0;
-            GUInt64 nTotalBytesThisArray = 0;
-            bool bStop = false;
-
-            static bool f(GDALAbstractMDArray* l_poSrcArray,
-                          const GUInt64* chunkArrayStartIdx,
-                          const size_t* chunkCount,
-                          GUInt64 iCurChunk,
-                          GUInt64 nChunkCount,
-                          void* pUserData)
-            {
-                const auto dt(l_poSrcArray->GetDataType());
-                auto data = static_cast<CopyFunc*>(pUserData);
-                auto poDstArray = data->poDstArray;
-                if( !l_poSrcArray->Read(chunkArrayStartIdx,
-                                      chunkCount,
-                                      nullptr, nullptr,
-                                      dt,
-                                      &data->abyTmp[0]) )
-                {
-                    return false;
-                }
-                bool bRet =
-                    poDstArray->Write(chunkArrayStartIdx,
-                                       chunkCount,
-                                       nullptr, nullptr,
-                                       dt,
-                                       &data->abyTmp[0]);
-                if( dt.NeedsFreeDynamicMemory() )
-                {
-                    const auto l_nDTSize = dt.GetSize();
-                    GByte* ptr = &data->abyTmp[0];
-                    const size_t l_nDims(l_poSrcArray->GetDimensionCount());
-                    size_t nEltCount = 1;
-                    for( size_t i = 0; i < l_nDims; ++i )
-                    {
-                        nEltCount *= chunkCount[i];
-                    }
-                    for( size_t i = 0; i < nEltCount; i++ )
-                    {
-                        dt.FreeDynamicMemory(ptr);
-                        ptr += l_nDTSize;
-                    }
-                }
-                if( !bRet )
-                {
-                    return false;
-                }
-
-                double dfCurCost = double(data->nCurCost) +
-                    double(iCurChunk) / nChunkCount * data->nTotalBytesThisArray;
-                if( !data->pfnProgress(dfCurCost / data->nTotalCost, "",
-                                       data->pProgressData) )
-                {
-                    data->bStop = true;
-                    return false;
-                }
-
-                return true;
-            }
-        };
-
-        CopyFunc copyFunc;
-        copyFunc.poDstArray = this;
-        copyFunc.nCurCost = nCurCost;
-        copyFunc.nTotalCost = nTotalCost;
-        copyFunc.nTotalBytesThisArray = GetTotalElementsCount() * nDTSize;
-        copyFunc.pfnProgress = pfnProgress;
-        copyFunc.pProgressData = pProgressData;
         const char* pszSwathSize = CPLGetConfigOption("GDAL_SWATH_SIZE", nullptr);
         const size_t nMaxChunkSize = pszSwathSize ?
             static_cast<size_t>(
@@ -3198,34 +3438,101 @@ bool GDALMDArray::CopyFrom(CPL_UNUSED GDALDataset* poSrcDS,
             static_cast<size_t>(
                 std::min(GIntBig(std::numeric_limits<size_t>::max() / 2),
                          GDALGetCacheMax64() / 4));
-        const auto anChunkSizes(GetProcessingChunkSize(nMaxChunkSize));
+
+        // When several threads are available, reading from the source and
+        // writing into the target are pipelined: the calling thread reads
+        // copy units in a few buffers, that are written by a job of the
+        // global thread pool. The memory budget is shared among those
+        // buffers.
+        const int nThreads = GDALMDArrayChunkReader::GetNumThreads();
+        const size_t nBuffers = nThreads > 1 ? COPY_PIPELINE_BUFFERS : 1;
+        const auto anChunkSizes(
+            GetCopyChunkSize(poSrcArray, this, nMaxChunkSize / nBuffers));
         size_t nRealChunkSize = nDTSize;
-        for( const auto& nChunkSize: anChunkSizes )
+        GUInt64 nChunkCount = 1;
+        for( size_t i = 0; i < dims.size(); i++ )
+        {
+            nRealChunkSize *= anChunkSizes[i];
+            nChunkCount *= DIV_ROUND_UP(count[i], anChunkSizes[i]);
+        }
+
+        const GUInt64 nTotalBytesThisArray = GetTotalElementsCount() * nDTSize;
+        if( nTotalBytesThisArray == 0 )
+            return true;
+
+        CopyPipeline pipeline;
+        pipeline.poDstArray = this;
+        pipeline.poSrcArray = poSrcArray;
+        pipeline.nCurCost = nCurCost;
+        pipeline.nTotalCost = nTotalCost;
+        pipeline.nTotalBytesThisArray = nTotalBytesThisArray;
+        pipeline.pfnProgress = pfnProgress;
+        pipeline.pProgressData = pProgressData;
+
+        CPLWorkerThreadPool* poThreadPool = nullptr;
+        if( nThreads > 1 && nChunkCount > 1 )
         {
-            nRealChunkSize *= nChunkSize;
+            poThreadPool = GDALGetGlobalThreadPool(nThreads);
         }
+        const size_t nBuffersToAllocate = poThreadPool ? nBuffers : 1;
         try
         {
-            copyFunc.abyTmp.resize(nRealChunkSize);
+            pipeline.aabyBuffers.resize(nBuffersToAllocate);
+            for( size_t i = 0; i < nBuffersToAllocate; i++ )
+            {
+                pipeline.aabyBuffers[i].resize(nRealChunkSize);
+                pipeline.anFreeBuffers.push_back(i);
+            }
         }
         catch( const std::exception& )
         {
             CPLError(CE_Failure, CPLE_OutOfMemory,
                         "Cannot allocate temporary buffer");
-            nCurCost += copyFunc.nTotalBytesThisArray;
+            nCurCost += nTotalBytesThisArray;
             return false;
         }
-        if( copyFunc.nTotalBytesThisArray != 0 &&
-            !const_cast<GDALMDArray*>(poSrcArray)->
+
+        bool bRet;
+        if( poThreadPool )
+        {
+            auto poJobQueue = poThreadPool->CreateJobQueue();
+            if( !poJobQueue->SubmitJob(CopyPipeline::WriterJob, &pipeline) )
+            {
+                nCurCost += nTotalBytesThisArray;
+                return false;
+            }
+            bRet = const_cast<GDALMDArray*>(poSrcArray)->
                 ProcessPerChunk(arrayStartIdx.data(), count.data(),
                                 anChunkSizes.data(),
-                                CopyFunc::f, &copyFunc) &&
-            (bStrict || copyFunc.bStop) )
+                                CopyPipeline::ReadAndQueue, &pipeline);
+            {
+                std::lock_guard<std::mutex> oLock(pipeline.oMutex);
+                pipeline.bReaderDone = true;
+            }
+            pipeline.oCV.notify_all();
+            poJobQueue->WaitCompletion();
+            if( pipeline.bWriteError )
+                bRet = false;
+            if( bRet &&
+                !pfnProgress(double(nCurCost + nTotalBytesThisArray) / nTotalCost,
+                             "", pProgressData) )
+            {
+                pipeline.bStop = true;
+                bRet = false;
+            }
+        }
+        else
+        {
+            bRet = const_cast<GDALMDArray*>(poSrcArray)->
+                ProcessPerChunk(arrayStartIdx.data(), count.data(),
+                                anChunkSizes.data(),
+                                CopyPipeline::ReadAndWrite, &pipeline);
+        }
+        nCurCost += nTotalBytesThisArray;
+        if( !bRet && (bStrict || pipeline.bStop) )
         {
-            nCurCost += copyFunc.nTotalBytesThisArray;
             return false;
         }
-        nCurCost += copyFunc.nTotalBytesThisArray;
     }
 
     return true;
@@ -6005,9 +6312,10 @@ GDALDataset* GDALMDArray::AsClassicDataset(size_t iXDim, size_t iYDim) const
  * from it (generally its persistent auxiliary metadata) already cached
  * statistics.
  *
- * @param bApproxOK Currently ignored. In the future, should be set to true
- * if statistics on the whole array are wished, or to false if a subset of it
- * may be used.
+ * @param bApproxOK Should be set to true if statistics computed on a subset
+ * of the array are acceptable, or false if statistics on the whole array are
+ * wished. In the former case, only a sample of the chunks of the array are
+ * read (since GDAL 3.4).
  *
  * @param bForce If false statistics will only be returned if it can
  * be done without rescanning the image.
@@ -6067,6 +6375,237 @@ CPLErr GDALMDArray::GetStatistics( GDALDataset* poDS,
                 ? CE_None: CE_Failure;
 }
 
+/************************************************************************/
+/*                         MDArrayStatistics                            */
+/************************************************************************/
+
+// Statistics accumulated over a subset of an array.
+struct MDArrayStatistics
+{
+    double dfMin = std::numeric_limits<double>::max();
+    double dfMax = -std::numeric_limits<double>::max();
+    double dfMean = 0.0;
+    double dfM2 = 0.0;
+    GUInt64 nValidCount = 0;
+
+    void Merge(const MDArrayStatistics& other)
+    {
+        if( other.nValidCount == 0 )
+            return;
+        if( nValidCount == 0 )
+        {
+            *this = other;
+            return;
+        }
+        dfMin = std::min(dfMin, other.dfMin);
+        dfMax = std::max(dfMax, other.dfMax);
+        const double dfN = static_cast<double>(nValidCount);
+        const double dfNOther = static_cast<double>(other.nValidCount);
+        const double dfNTotal = dfN + dfNOther;
+        const double dfDelta = other.dfMean - dfMean;
+        dfMean += dfDelta * dfNOther / dfNTotal;
+        dfM2 += other.dfM2 + dfDelta * dfDelta * dfN * dfNOther / dfNTotal;
+        nValidCount += other.nValidCount;
+    }
+};
+
+/************************************************************************/
+/*                      MDArrayStatisticsContext                        */
+/************************************************************************/
+
+// State of GDALMDArray::ComputeStatistics(). Chunks are read sequentially by
+// the calling thread into a ring of slots, and their statistics computed by
+// jobs of the global thread pool. The statistics of each slot are merged
+// before it is reused, that is in chunk order, so that the result does not
+// depend on the scheduling of jobs.
+struct MDArrayStatisticsContext
+{
+    struct Slot
+    {
+        MDArrayStatisticsContext* poContext = nullptr;
+        std::vector<GByte> abyData{};
+        GByte* pabyData = nullptr; // aligned on 32 bytes
+        std::vector<GByte> abyMaskData{};
+        size_t nVals = 0;
+        bool bBusy = false;
+        MDArrayStatistics oStats{};
+    };
+
+    const GDALMDArray* poArray = nullptr;
+    std::shared_ptr<GDALMDArray> poMask{}; // nullptr if all values are valid
+    GDALDataType eDT = GDT_Unknown;
+    bool bUseUInt8Or16Kernel = false;
+    bool bHasNoData = false;
+    GUInt32 nNoDataValue = 0;
+    GUInt64 nSampleRate = 1;
+    GDALProgressFunc pfnProgress = nullptr;
+    void* pProgressData = nullptr;
+
+    std::vector<Slot> aoSlots{};
+    size_t iNextSlot = 0;
+    MDArrayStatistics oStats{};
+    std::unique_ptr<CPLJobQueue> poJobQueue{};
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+
+    static void ComputeSlot(Slot& oSlot);
+    static void ComputeSlotJob(void* pData);
+    static bool PerChunkFunc(GDALAbstractMDArray*,
+                             const GUInt64* chunkArrayStartIdx,
+                             const size_t* chunkCount,
+                             GUInt64 iCurChunk,
+                             GUInt64 nChunkCount,
+                             void* pUserData);
+};
+
+/************************************************************************/
+/*               MDArrayStatisticsContext::ComputeSlot()                */
+/************************************************************************/
+
+void MDArrayStatisticsContext::ComputeSlot(Slot& oSlot)
+{
+    const auto poContext = oSlot.poContext;
+    MDArrayStatistics& oStats = oSlot.oStats;
+    oStats = MDArrayStatistics();
+#ifdef CPL_HAS_GINT64
+    if( poContext->bUseUInt8Or16Kernel )
+    {
+        GUInt32 nMin = poContext->eDT == GDT_Byte ? 255 : 65535;
+        GUInt32 nMax = 0;
+        GDALComputeStatisticsUInt8Or16(poContext->eDT, oSlot.pabyData,
+                                       oSlot.nVals,
+                                       poContext->bHasNoData,
+                                       poContext->nNoDataValue,
+                                       nMin, nMax,
+                                       oStats.nValidCount,
+                                       oStats.dfMean, oStats.dfM2);
+        if( oStats.nValidCount )
+        {
+            oStats.dfMin = nMin;
+            oStats.dfMax = nMax;
+        }
+        return;
+    }
+#endif
+
+    // Convert values to double by pieces, to avoid allocating a double
+    // buffer as large as the chunk.
+    constexpr size_t nPieceSize = 4096;
+    double adfValues[nPieceSize];
+    const int nDTSize = GDALGetDataTypeSizeBytes(poContext->eDT);
+    const GByte* pabyMask = poContext->poMask ?
+                                oSlot.abyMaskData.data() : nullptr;
+    for( size_t i = 0; i < oSlot.nVals; i += nPieceSize )
+    {
+        const size_t nThisPiece = std::min(nPieceSize, oSlot.nVals - i);
+        GDALCopyWords64( oSlot.pabyData + i * nDTSize, poContext->eDT, nDTSize,
+                         adfValues, GDT_Float64,
+                         static_cast<int>(sizeof(double)),
+                         static_cast<GPtrDiff_t>(nThisPiece) );
+        for( size_t j = 0; j < nThisPiece; j++ )
+        {
+            if( pabyMask == nullptr || pabyMask[i + j] )
+            {
+                const double dfValue = adfValues[j];
+                oStats.dfMin = std::min(oStats.dfMin, dfValue);
+                oStats.dfMax = std::max(oStats.dfMax, dfValue);
+                oStats.nValidCount++;
+                const double dfDelta = dfValue - oStats.dfMean;
+                oStats.dfMean += dfDelta / oStats.nValidCount;
+                oStats.dfM2 += dfDelta * (dfValue - oStats.dfMean);
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*              MDArrayStatisticsContext::ComputeSlotJob()              */
+/************************************************************************/
+
+void MDArrayStatisticsContext::ComputeSlotJob(void* pData)
+{
+    Slot* poSlot = static_cast<Slot*>(pData);
+    ComputeSlot(*poSlot);
+    auto poContext = poSlot->poContext;
+    {
+        std::lock_guard<std::mutex> oLock(poContext->oMutex);
+        poSlot->bBusy = false;
+    }
+    poContext->oCV.notify_all();
+}
+
+/************************************************************************/
+/*              MDArrayStatisticsContext::PerChunkFunc()                */
+/************************************************************************/
+
+bool MDArrayStatisticsContext::PerChunkFunc(GDALAbstractMDArray*,
+                                            const GUInt64* chunkArrayStartIdx,
+                                            const size_t* chunkCount,
+                                            GUInt64 iCurChunk,
+                                            GUInt64 nChunkCount,
+                                            void* pUserData)
+{
+    auto poContext = static_cast<MDArrayStatisticsContext*>(pUserData);
+    if( (iCurChunk % poContext->nSampleRate) != 0 )
+        return true;
+
+    Slot& oSlot = poContext->aoSlots[poContext->iNextSlot];
+    poContext->iNextSlot =
+        (poContext->iNextSlot + 1) % poContext->aoSlots.size();
+    if( poContext->poJobQueue )
+    {
+        std::unique_lock<std::mutex> oLock(poContext->oMutex);
+        poContext->oCV.wait(oLock, [&oSlot] { return !oSlot.bBusy; });
+    }
+    poContext->oStats.Merge(oSlot.oStats);
+    oSlot.oStats = MDArrayStatistics();
+
+    const GDALMDArray* poArray = poContext->poArray;
+    const size_t nDims = poArray->GetDimensionCount();
+    size_t nVals = 1;
+    for( size_t i = 0; i < nDims; i++ )
+        nVals *= chunkCount[i];
+    oSlot.nVals = nVals;
+
+    // Get mask
+    const GDALMDArray* poMask = poContext->poMask.get();
+    if( poMask &&
+        !(poMask->Read(chunkArrayStartIdx, chunkCount, nullptr, nullptr,
+                       poMask->GetDataType(), &oSlot.abyMaskData[0])) )
+    {
+        return false;
+    }
+
+    // Get data
+    if( !poArray->Read(chunkArrayStartIdx, chunkCount, nullptr, nullptr,
+                       poArray->GetDataType(), oSlot.pabyData) )
+    {
+        return false;
+    }
+
+    if( poContext->poJobQueue )
+    {
+        oSlot.bBusy = true;
+        if( !poContext->poJobQueue->SubmitJob(ComputeSlotJob, &oSlot) )
+        {
+            oSlot.bBusy = false;
+            return false;
+        }
+    }
+    else
+    {
+        ComputeSlot(oSlot);
+    }
+
+    if( poContext->pfnProgress &&
+        !poContext->pfnProgress(static_cast<double>(iCurChunk+1) / nChunkCount,
+                                "", poContext->pProgressData) )
+    {
+        return false;
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                         ComputeStatistics()                          */
 /************************************************************************/
@@ -6085,15 +6624,20 @@ CPLErr GDALMDArray::GetStatistics( GDALDataset* poDS,
  *
  * Cached statistics can be cleared with GDALDataset::ClearStatistics().
  *
+ * Starting with GDAL 3.4, the statistics of chunks are computed in parallel
+ * when the GDAL_NUM_THREADS configuration option is set to a value greater
+ * than 1 (it defaults to ALL_CPUS).
+ *
  * This method is the same as the C function GDALMDArrayComputeStatistics().
  *
  * @param poDS Owing dataset. If set to non-NULL, the method will attempt to
  * store computed statistics in it (generally its persistent auxiliary metadata)
  * for further retrieval by GetStatistics()
  *
- * @param bApproxOK Currently ignored. In the future, should be set to true
- * if statistics on the whole array are wished, or to false if a subset of it
- * may be used.
+ * @param bApproxOK Should be set to true if statistics computed on a subset
+ * of the array are acceptable, or false if statistics on the whole array are
+ * wished. In the former case, only a sample of the chunks of the array are
+ * read (since GDAL 3.4).
  *
  * @param pdfMin Location into which to load image minimum (may be NULL).
  *
@@ -6123,93 +6667,6 @@ bool GDALMDArray::ComputeStatistics( GDALDataset* poDS,
                                     GUInt64* pnValidCount,
                                     GDALProgressFunc pfnProgress, void *pProgressData )
 {
-    struct StatsPerChunkType
-    {
-        const GDALMDArray* array = nullptr;
-        std::shared_ptr<GDALMDArray> poMask{};
-        double dfMin = std::numeric_limits<double>::max();
-        double dfMax = -std::numeric_limits<double>::max();
-        double dfMean = 0.0;
-        double dfM2 = 0.0;
-        GUInt64 nValidCount = 0;
-        std::vector<GByte> abyData{};
-        std::vector<double> adfData{};
-        std::vector<GByte> abyMaskData{};
-        GDALProgressFunc pfnProgress = nullptr;
-        void* pProgressData = nullptr;
-    };
-
-    const auto PerChunkFunc = [](GDALAbstractMDArray*,
-                                 const GUInt64* chunkArrayStartIdx,
-                                 const size_t* chunkCount,
-                                 GUInt64 iCurChunk,
-                                 GUInt64 nChunkCount,
-                                 void* pUserData)
-    {
-        StatsPerChunkType* data = static_cast<StatsPerChunkType*>(pUserData);
-        const GDALMDArray* array = data->array;
-        const GDALMDArray* poMask = data->poMask.get();
-        const size_t nDims = array->GetDimensionCount();
-        size_t nVals = 1;
-        for( size_t i = 0; i < nDims; i++ )
-            nVals *= chunkCount[i];
-
-        // Get mask
-        data->abyMaskData.resize(nVals);
-        if( !(poMask->Read(chunkArrayStartIdx, chunkCount, nullptr, nullptr,
-                           poMask->GetDataType(), &data->abyMaskData[0])) )
-        {
-            return false;
-        }
-
-        // Get data
-        const auto& oType = array->GetDataType();
-        if( oType.GetNumericDataType() == GDT_Float64 )
-        {
-            data->adfData.resize(nVals);
-            if( !array->Read(chunkArrayStartIdx, chunkCount, nullptr, nullptr,
-                            oType, &data->adfData[0]) )
-            {
-                return false;
-            }
-        }
-        else
-        {
-            data->abyData.resize(nVals * oType.GetSize());
-            if( !array->Read(chunkArrayStartIdx, chunkCount, nullptr, nullptr,
-                            oType, &data->abyData[0]) )
-            {
-                return false;
-            }
-            data->adfData.resize(nVals);
-            GDALCopyWords64( &data->abyData[0], oType.GetNumericDataType(),
-                             static_cast<int>(oType.GetSize()),
-                             &data->adfData[0], GDT_Float64,
-                             static_cast<int>(sizeof(double)),
-                             static_cast<GPtrDiff_t>(nVals) );
-        }
-        for( size_t i = 0; i < nVals; i++ )
-        {
-            if( data->abyMaskData[i] )
-            {
-                const double dfValue = data->adfData[i];
-                data->dfMin = std::min(data->dfMin, dfValue);
-                data->dfMax = std::max(data->dfMax, dfValue);
-                data->nValidCount++;
-                const double dfDelta = dfValue - data->dfMean;
-                data->dfMean += dfDelta / data->nValidCount;
-                data->dfM2 += dfDelta * (dfValue - data->dfMean);
-            }
-        }
-        if( data->pfnProgress &&
-            !data->pfnProgress(static_cast<double>(iCurChunk+1) / nChunkCount,
-                               "", data->pProgressData) )
-        {
-            return false;
-        }
-        return true;
-    };
-
     const auto& oType = GetDataType();
     if( oType.GetClass() != GEDTC_NUMERIC ||
         GDALDataTypeIsComplex(oType.GetNumericDataType()) )
@@ -6235,43 +6692,164 @@ bool GDALMDArray::ComputeStatistics( GDALDataset* poDS,
         static_cast<size_t>(
             std::min(GIntBig(std::numeric_limits<size_t>::max() / 2),
                         GDALGetCacheMax64() / 4));
-    StatsPerChunkType sData;
-    sData.array = this;
-    sData.poMask = GetMask(nullptr);
-    if( sData.poMask == nullptr )
+
+    MDArrayStatisticsContext sContext;
+    sContext.poArray = this;
+    sContext.eDT = oType.GetNumericDataType();
+    sContext.pfnProgress = pfnProgress;
+    sContext.pProgressData = pProgressData;
+
+    // Reading the mask can be skipped if it would be valid everywhere, or
+    // if it is only driven by the nodata value, for the types for which
+    // optimized code paths exist. Must be consistent with GDALMDArrayMask.
+    const bool bHasMaskAttribute =
+        GetAttribute("missing_value") != nullptr ||
+        GetAttribute("_FillValue") != nullptr ||
+        GetAttribute("valid_min") != nullptr ||
+        GetAttribute("valid_max") != nullptr ||
+        GetAttribute("valid_range") != nullptr;
+    const bool bHasRawNoData = GetRawNoDataValue() != nullptr;
+#ifdef CPL_HAS_GINT64
+    if( !bHasMaskAttribute &&
+        (sContext.eDT == GDT_Byte || sContext.eDT == GDT_UInt16) )
+    {
+        sContext.bUseUInt8Or16Kernel = true;
+        if( bHasRawNoData )
+        {
+            const double dfNoDataValue = GetNoDataValueAsDouble();
+            const GUInt32 nMaxValueType =
+                sContext.eDT == GDT_Byte ? 255 : 65535;
+            sContext.bHasNoData =
+                dfNoDataValue >= 0 && dfNoDataValue <= nMaxValueType &&
+                dfNoDataValue == static_cast<GUInt32>(dfNoDataValue);
+            if( sContext.bHasNoData )
+                sContext.nNoDataValue = static_cast<GUInt32>(dfNoDataValue);
+        }
+    }
+    else
+#endif
+    if( bHasMaskAttribute || bHasRawNoData ||
+        !GDALDataTypeIsInteger(sContext.eDT) )
     {
-        return false;
+        sContext.poMask = GetMask(nullptr);
+        if( sContext.poMask == nullptr )
+        {
+            return false;
+        }
+    }
+
+    // In approximate mode, work on the natural blocks of the array if it
+    // has some, so as to sample as many distinct places as possible.
+    bool bHasBlockSize = nDims > 0;
+    for( const auto nBlockSize: GetBlockSize() )
+    {
+        if( nBlockSize == 0 )
+            bHasBlockSize = false;
     }
-    sData.pfnProgress = pfnProgress;
-    sData.pProgressData = pProgressData;
-    if( !ProcessPerChunk(arrayStartIdx.data(), count.data(),
-                         GetProcessingChunkSize(nMaxChunkSize).data(),
-                         PerChunkFunc, &sData) )
+    const int nThreads = GDALMDArrayChunkReader::GetNumThreads();
+    size_t nSlots = nThreads > 1 ? static_cast<size_t>(nThreads) + 1 : 1;
+    const auto anChunkSize( bApproxOK && bHasBlockSize ?
+                            GetProcessingChunkSize(0) :
+                            GetProcessingChunkSize(nMaxChunkSize / nSlots) );
+    size_t nChunkVals = 1;
+    GUInt64 nChunkCount = 1;
+    for( size_t i = 0; i < nDims; i++ )
     {
+        nChunkVals *= anChunkSize[i];
+        nChunkCount *= DIV_ROUND_UP(count[i], anChunkSize[i]);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Figure out the ratio of chunks we will read to get an           */
+/*      approximate value.                                              */
+/* -------------------------------------------------------------------- */
+    if( bApproxOK )
+    {
+        sContext.nSampleRate = static_cast<GUInt64>(
+            std::max(1.0, sqrt(static_cast<double>(nChunkCount))));
+        // Avoid probing always the same chunk along the fastest varying
+        // dimension.
+        if( nDims > 0 && sContext.nSampleRate > 1 &&
+            sContext.nSampleRate ==
+                DIV_ROUND_UP(count.back(), anChunkSize.back()) )
+        {
+            sContext.nSampleRate ++;
+        }
+    }
+    if( sContext.nSampleRate == 1 )
+        bApproxOK = false;
+
+    const GUInt64 nChunksToProcess =
+                        DIV_ROUND_UP(nChunkCount, sContext.nSampleRate);
+    if( nThreads > 1 && nChunksToProcess > 1 )
+    {
+        auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            sContext.poJobQueue = poThreadPool->CreateJobQueue();
+    }
+    if( sContext.poJobQueue )
+        nSlots = static_cast<size_t>(std::min<GUInt64>(nSlots, nChunksToProcess));
+    else
+        nSlots = 1;
+
+    try
+    {
+        sContext.aoSlots.resize(nSlots);
+        for( auto& oSlot: sContext.aoSlots )
+        {
+            oSlot.poContext = &sContext;
+            // Extra space to align the buffer on 32 bytes
+            oSlot.abyData.resize(nChunkVals * oType.GetSize() + 32);
+            oSlot.pabyData = oSlot.abyData.data() +
+                (32 - (reinterpret_cast<GUIntptr_t>(oSlot.abyData.data()) % 32)) % 32;
+            if( sContext.poMask )
+                oSlot.abyMaskData.resize(nChunkVals);
+        }
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate temporary buffer");
         return false;
     }
 
+    const bool bRet = ProcessPerChunk(arrayStartIdx.data(), count.data(),
+                                      anChunkSize.data(),
+                                      MDArrayStatisticsContext::PerChunkFunc,
+                                      &sContext);
+    if( sContext.poJobQueue )
+        sContext.poJobQueue->WaitCompletion();
+    if( !bRet )
+        return false;
+    // Merge the pending slots, oldest first
+    for( size_t i = 0; i < nSlots; i++ )
+    {
+        sContext.oStats.Merge(
+            sContext.aoSlots[(sContext.iNextSlot + i) % nSlots].oStats);
+    }
+    const MDArrayStatistics& oStats = sContext.oStats;
+
     if( pdfMin )
-        *pdfMin = sData.dfMin;
+        *pdfMin = oStats.dfMin;
 
     if( pdfMax )
-        *pdfMax = sData.dfMax;
+        *pdfMax = oStats.dfMax;
 
     if( pdfMean )
-        *pdfMean = sData.dfMean;
+        *pdfMean = oStats.dfMean;
 
-    const double dfStdDev = sData.nValidCount > 0 ? sqrt(sData.dfM2 / sData.nValidCount) : 0.0;
+    const double dfStdDev = oStats.nValidCount > 0 ? sqrt(oStats.dfM2 / oStats.nValidCount) : 0.0;
     if( pdfStdDev )
         *pdfStdDev = dfStdDev;
 
     if( pnValidCount )
-        *pnValidCount = sData.nValidCount;
+        *pnValidCount = oStats.nValidCount;
 
     if( poDS )
     {
         SetStatistics(poDS, bApproxOK,
-                      sData.dfMin, sData.dfMax, sData.dfMean, dfStdDev,
-                      sData.nValidCount);
+                      oStats.dfMin, oStats.dfMax, oStats.dfMean, dfStdDev,
+                      oStats.nValidCount);
     }
 
     return true;
@@ -37,7 +37,10 @@
 #endif
 
 #include <algorithm>
+#include <ctime>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -393,7 +396,259 @@ GDALOpenInfo::~GDALOpenInfo()
 
     if( fpL != nullptr )
         CPL_IGNORE_RET_VAL(VSIFCloseL( fpL ));
-    CSLDestroy( papszSiblingFiles );
+    if( !poSiblingFilesListing )
+        CSLDestroy( papszSiblingFiles );
+}
+
+/************************************************************************/
+/*                            GDALDirListing                            */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+
+// Immutable listing of a directory, with file names sorted in case
+// insensitive order.
+class GDALDirListing
+{
+  public:
+    time_t        nMTime = 0;
+    // Maximum number of files requested when listing the directory.
+    int           nMaxFiles = 0;
+    // Whether the directory has more than nMaxFiles files, in which case
+    // aosFiles is empty.
+    bool          bTooManyFiles = false;
+    CPLStringList aosFiles{};
+
+    bool IsUsableFor(int nMaxFilesIn) const
+    {
+        if( !bTooManyFiles )
+            return true;
+        return nMaxFilesIn > 0 && nMaxFilesIn <= nMaxFiles;
+    }
+
+    bool HasTooManyFilesFor(int nMaxFilesIn) const
+    {
+        return bTooManyFiles ||
+               (nMaxFilesIn > 0 && aosFiles.size() > nMaxFilesIn);
+    }
+};
+
+//! @endcond
+
+namespace
+{
+
+/************************************************************************/
+/*                         GDALDirListingCache                          */
+/************************************************************************/
+
+// Process-wide LRU cache of directory listings, keyed by directory name,
+// and validated against the modification time of the directory. Its size is
+// capped by the total number of file names.
+class GDALDirListingCache
+{
+    typedef std::shared_ptr<const GDALDirListing> ListingPtr;
+    typedef std::list<std::pair<std::string, ListingPtr>> ListType;
+
+    std::mutex m_oMutex{};
+    ListType m_oList{};
+    std::map<std::string, ListType::iterator> m_oMap{};
+    size_t m_nSize = 0;
+
+    // Listings (cached or not) currently in use, indexed by their file list,
+    // so that GDALFindSiblingFile() can recognize them.
+    std::map<CSLConstList, std::weak_ptr<const GDALDirListing>>
+                                                        m_oMapListings{};
+    size_t m_nListingsAfterLastPrune = 0;
+
+    static size_t GetSize(const ListingPtr& poListing)
+    {
+        return 1 + static_cast<size_t>(poListing->aosFiles.size());
+    }
+
+    void EvictIfNeeded(size_t nMaxSize)
+    {
+        while( m_nSize > nMaxSize && !m_oList.empty() )
+        {
+            m_nSize -= GetSize(m_oList.back().second);
+            m_oMap.erase(m_oList.back().first);
+            m_oList.pop_back();
+        }
+    }
+
+public:
+    ListingPtr Get(const std::string& osDir, time_t nMTime, int nMaxFiles)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMap.find(osDir);
+        if( oIter == m_oMap.end() )
+            return nullptr;
+        const ListingPtr& poListing = oIter->second->second;
+        if( poListing->nMTime != nMTime ||
+            !poListing->IsUsableFor(nMaxFiles) )
+        {
+            return nullptr;
+        }
+        m_oList.splice(m_oList.begin(), m_oList, oIter->second);
+        return poListing;
+    }
+
+    void Insert(const std::string& osDir, const ListingPtr& poListing,
+                size_t nMaxSize)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMap.find(osDir);
+        if( oIter != m_oMap.end() )
+        {
+            m_nSize -= GetSize(oIter->second->second);
+            m_oList.erase(oIter->second);
+            m_oMap.erase(oIter);
+        }
+        if( GetSize(poListing) <= nMaxSize )
+        {
+            m_oList.emplace_front(osDir, poListing);
+            m_oMap[osDir] = m_oList.begin();
+            m_nSize += GetSize(poListing);
+        }
+        EvictIfNeeded(nMaxSize);
+    }
+
+    void Register(const ListingPtr& poListing)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_oMapListings[poListing->aosFiles.List()] = poListing;
+        if( m_oMapListings.size() > 2 * m_nListingsAfterLastPrune + 64 )
+        {
+            for( auto oIter = m_oMapListings.begin();
+                 oIter != m_oMapListings.end(); )
+            {
+                if( oIter->second.expired() )
+                    oIter = m_oMapListings.erase(oIter);
+                else
+                    ++oIter;
+            }
+            m_nListingsAfterLastPrune = m_oMapListings.size();
+        }
+    }
+
+    // Returns the listing whose file list is papszList, if it is still alive.
+    ListingPtr Find(CSLConstList papszList)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto oIter = m_oMapListings.find(papszList);
+        if( oIter == m_oMapListings.end() )
+            return nullptr;
+        return oIter->second.lock();
+    }
+};
+
+GDALDirListingCache& GetDirListingCache()
+{
+    static GDALDirListingCache oCache;
+    return oCache;
+}
+
+/************************************************************************/
+/*                        GDALSiblingFileLess()                         */
+/************************************************************************/
+
+bool GDALSiblingFileLess(const char* pszA, const char* pszB)
+{
+    return STRCASECMP(pszA, pszB) < 0;
+}
+
+/************************************************************************/
+/*                          GDALGetDirListing()                         */
+/************************************************************************/
+
+// Returns the listing of a directory of the local file system, from the
+// cache when it is still valid, or nullptr for other file systems (the
+// network ones have their own caching of directory listings).
+std::shared_ptr<const GDALDirListing> GDALGetDirListing(const CPLString& osDir,
+                                                        int nMaxFiles)
+{
+    if( STARTS_WITH(osDir, "/vsi") )
+        return nullptr;
+    const int nMaxCacheSize =
+        atoi(CPLGetConfigOption("GDAL_READDIR_CACHE_SIZE_ON_OPEN", "100000"));
+    if( nMaxCacheSize <= 0 )
+        return nullptr;
+
+    VSIStatBufL sStat;
+    if( VSIStatL(osDir, &sStat) != 0 || !VSI_ISDIR(sStat.st_mode) )
+        return nullptr;
+
+    auto& oCache = GetDirListingCache();
+    auto poCachedListing = oCache.Get(osDir, sStat.st_mtime, nMaxFiles);
+    if( poCachedListing )
+        return poCachedListing;
+
+    auto poListing = std::make_shared<GDALDirListing>();
+    poListing->nMTime = sStat.st_mtime;
+    poListing->nMaxFiles = nMaxFiles;
+    poListing->aosFiles.Assign(VSIReadDirEx(osDir, nMaxFiles), TRUE);
+    // Also makes sure that the lazily computed count is set before the
+    // listing is shared between threads.
+    const int nFiles = poListing->aosFiles.size();
+    if( nMaxFiles > 0 && nFiles > nMaxFiles )
+    {
+        poListing->bTooManyFiles = true;
+        poListing->aosFiles.Clear();
+        CPL_IGNORE_RET_VAL(poListing->aosFiles.size());
+    }
+    else if( nFiles > 1 )
+    {
+        char** papszFiles = poListing->aosFiles.List();
+        std::stable_sort(papszFiles, papszFiles + nFiles,
+                         GDALSiblingFileLess);
+    }
+
+    // The modification time of the directory has typically a resolution of
+    // one second, so a listing made in the same second as a modification
+    // might miss a later modification within that second.
+    if( time(nullptr) - sStat.st_mtime >= 2 )
+    {
+        oCache.Insert(osDir, poListing, static_cast<size_t>(nMaxCacheSize));
+    }
+    return poListing;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                        GDALFindSiblingFile()                         */
+/************************************************************************/
+
+/**
+ * \brief Find a file name in a list of sibling files.
+ *
+ * This is equivalent to CSLFindString(), except that the search is a binary
+ * search when the list is the one returned by GDALOpenInfo::GetSiblingFiles()
+ * from a directory listing.
+ *
+ * @param papszSiblingFiles list of sibling files, or NULL.
+ * @param pszFilename file name to search (case insensitive).
+ * @return the index of the file in the list, or -1.
+ * @since GDAL 3.4
+ */
+
+int GDALFindSiblingFile(CSLConstList papszSiblingFiles,
+                        const char* pszFilename)
+{
+    if( papszSiblingFiles == nullptr || pszFilename == nullptr )
+        return -1;
+    auto poListing = GetDirListingCache().Find(papszSiblingFiles);
+    if( !poListing )
+        return CSLFindString(papszSiblingFiles, pszFilename);
+
+    const char* const* papszBegin = papszSiblingFiles;
+    const char* const* papszEnd = papszBegin + poListing->aosFiles.size();
+    const char* const* papszIter =
+        std::lower_bound(papszBegin, papszEnd, pszFilename,
+                         GDALSiblingFileLess);
+    if( papszIter != papszEnd && EQUAL(*papszIter, pszFilename) )
+        return static_cast<int>(papszIter - papszBegin);
+    return -1;
 }
 
 /************************************************************************/
@@ -417,6 +672,25 @@ char** GDALOpenInfo::GetSiblingFiles()
     CPLString osDir = CPLGetDirname( pszFilename );
     const int nMaxFiles =
         atoi(CPLGetConfigOption("GDAL_READDIR_LIMIT_ON_OPEN", "1000"));
+
+    auto poListing = GDALGetDirListing(osDir, nMaxFiles);
+    if( poListing )
+    {
+        if( poListing->HasTooManyFilesFor(nMaxFiles) )
+        {
+            CPLDebug("GDAL", "GDAL_READDIR_LIMIT_ON_OPEN reached on %s",
+                     osDir.c_str());
+            return nullptr;
+        }
+        if( poListing->aosFiles.empty() )
+            return nullptr;
+        GetDirListingCache().Register(poListing);
+        poSiblingFilesListing = poListing;
+        // The list is shared with other GDALOpenInfo and with the cache.
+        papszSiblingFiles = const_cast<char**>(poListing->aosFiles.List());
+        return papszSiblingFiles;
+    }
+
     papszSiblingFiles = VSIReadDirEx( osDir, nMaxFiles );
     if( nMaxFiles > 0 && CSLCount(papszSiblingFiles) > nMaxFiles )
     {
@@ -444,6 +718,11 @@ char** GDALOpenInfo::GetSiblingFiles()
 char** GDALOpenInfo::StealSiblingFiles()
 {
     char** papszRet = GetSiblingFiles();
+    if( poSiblingFilesListing )
+    {
+        papszRet = CSLDuplicate(papszRet);
+        poSiblingFilesListing.reset();
+    }
     papszSiblingFiles = nullptr;
     return papszRet;
 }
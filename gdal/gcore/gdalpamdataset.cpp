@@ -843,8 +843,8 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
         GDALCanReliablyUseSiblingFileList(psPam->pszPamFilename) )
     {
         const int iSibling =
-            CSLFindString( papszSiblingFiles,
-                           CPLGetFilename(psPam->pszPamFilename) );
+            GDALFindSiblingFile( papszSiblingFiles,
+                                 CPLGetFilename(psPam->pszPamFilename) );
         if( iSibling >= 0 )
         {
             CPLErrorReset();
@@ -1564,14 +1564,14 @@ CPLErr GDALPamDataset::TryLoadAux(char **papszSiblingFiles)
     if( papszSiblingFiles && GDALCanReliablyUseSiblingFileList(pszPhysicalFile) )
     {
         CPLString osAuxFilename = CPLResetExtension( pszPhysicalFile, "aux");
-        int iSibling = CSLFindString( papszSiblingFiles,
-                                      CPLGetFilename(osAuxFilename) );
+        int iSibling = GDALFindSiblingFile( papszSiblingFiles,
+                                            CPLGetFilename(osAuxFilename) );
         if( iSibling < 0 )
         {
             osAuxFilename = pszPhysicalFile;
             osAuxFilename += ".aux";
-            iSibling = CSLFindString( papszSiblingFiles,
-                                      CPLGetFilename(osAuxFilename) );
+            iSibling = GDALFindSiblingFile( papszSiblingFiles,
+                                            CPLGetFilename(osAuxFilename) );
             if( iSibling < 0 )
                 return CE_None;
         }
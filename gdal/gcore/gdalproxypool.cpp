@@ -63,6 +63,23 @@ static GDALDatasetPool* singleton = nullptr;
 
 void GDALNullifyProxyPoolSingleton() { singleton = nullptr; }
 
+// Statistics, protected by GDALGetphDLMutex()
+static GIntBig gnProxyPoolHits = 0;
+static GIntBig gnProxyPoolOpens = 0;
+static GIntBig gnProxyPoolEvictions = 0;
+
+/* Return the number of requests served by an already opened dataset, */
+/* the number of datasets (re)opened and the number of datasets closed */
+/* to make room for another one. */
+void GDALProxyPoolGetStatistics(GIntBig* pnHits, GIntBig* pnOpens,
+                                GIntBig* pnEvictions)
+{
+    CPLMutexHolderD( GDALGetphDLMutex() );
+    *pnHits = gnProxyPoolHits;
+    *pnOpens = gnProxyPoolOpens;
+    *pnEvictions = gnProxyPoolEvictions;
+}
+
 struct _GDALProxyPoolCacheEntry
 {
     GIntBig       responsiblePID;
@@ -264,6 +281,7 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
             }
 
             cur->refCount ++;
+            gnProxyPoolHits ++;
             return cur;
         }
 
@@ -290,6 +308,8 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
         lastEntryWithZeroRefCount->pszFileName[0] = '\0';
         if (lastEntryWithZeroRefCount->poDS)
         {
+            gnProxyPoolEvictions ++;
+
             /* Close by pretending we are the thread that GDALOpen'ed this */
             /* dataset */
             GDALSetResponsiblePIDForCurrentThread(lastEntryWithZeroRefCount->responsiblePID);
@@ -349,6 +369,7 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
     cur->responsiblePID = responsiblePID;
     cur->refCount = 1;
 
+    gnProxyPoolOpens ++;
     refCountOfDisableRefCount ++;
     int nFlag = ((eAccess == GA_Update) ? GDAL_OF_UPDATE : GDAL_OF_READONLY) | GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
     CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
@@ -39,22 +39,44 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <condition_variable>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_rat.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                        SetBlockTraceDetail()                         */
+/************************************************************************/
+
+static void SetBlockTraceDetail( CPLTraceSpan& oSpan, GDALRasterBand* poBand,
+                                 int nXBlockOff, int nYBlockOff )
+{
+    if( oSpan.IsActive() )
+    {
+        GDALDataset* poDS = poBand->GetDataset();
+        oSpan.SetDetailf("%s band %d block %d,%d",
+                         poDS ? CPLGetFilename(poDS->GetDescription()) : "",
+                         poBand->GetBand(), nXBlockOff, nYBlockOff);
+    }
+}
+
 /************************************************************************/
 /*                           GDALRasterBand()                           */
 /************************************************************************/
@@ -547,6 +569,9 @@ CPLErr GDALRasterBand::ReadBlock( int nXBlockOff, int nYBlockOff,
 /*      Invoke underlying implementation method.                        */
 /* -------------------------------------------------------------------- */
 
+    CPLTraceSpan oTraceSpan("gdal", "IReadBlock");
+    SetBlockTraceDetail(oTraceSpan, this, nXBlockOff, nYBlockOff);
+
     int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
     CPLErr eErr = IReadBlock( nXBlockOff, nYBlockOff, pImage );
     if( bCallLeaveReadWrite) LeaveReadWrite();
@@ -702,6 +727,9 @@ CPLErr GDALRasterBand::WriteBlock( int nXBlockOff, int nYBlockOff,
 /*      Invoke underlying implementation method.                        */
 /* -------------------------------------------------------------------- */
 
+    CPLTraceSpan oTraceSpan("gdal", "IWriteBlock");
+    SetBlockTraceDetail(oTraceSpan, this, nXBlockOff, nYBlockOff);
+
     const bool bCallLeaveReadWrite = CPL_TO_BOOL(EnterReadWrite(GF_Write));
     CPLErr eErr = IWriteBlock( nXBlockOff, nYBlockOff, pImage );
     if( bCallLeaveReadWrite ) LeaveReadWrite();
@@ -1240,6 +1268,9 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
                                                      int bJustInitialize )
 
 {
+    CPLTraceSpan oTraceSpan("gdal", "BlockCacheHit");
+    SetBlockTraceDetail(oTraceSpan, this, nXBlockOff, nYBlockOff);
+
 /* -------------------------------------------------------------------- */
 /*      Try and fetch from cache.                                       */
 /* -------------------------------------------------------------------- */
@@ -1252,6 +1283,9 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
 /* -------------------------------------------------------------------- */
     if( poBlock == nullptr )
     {
+        oTraceSpan.SetName("BlockCacheMiss");
+        GDALBlockCacheCounters::Count(this, GDALBlockCacheEvent::MISS);
+
         if( !InitBlockInfo() )
             return( nullptr );
 
@@ -1312,12 +1346,22 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return nullptr;
         }
 
-        if( !bJustInitialize )
+        if( !bJustInitialize && poBlock->ReadFromSharedCache() )
+        {
+            oTraceSpan.SetName("SharedBlockCacheHit");
+        }
+        else if( !bJustInitialize )
         {
             const GUInt32 nErrorCounter = CPLGetErrorCounter();
-            int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
-            eErr = IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef());
-            if( bCallLeaveReadWrite) LeaveReadWrite();
+            {
+                CPLTraceSpan oTraceSpanRead("gdal", "IReadBlock");
+                SetBlockTraceDetail(oTraceSpanRead, this,
+                                    nXBlockOff, nYBlockOff);
+
+                int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
+                eErr = IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef());
+                if( bCallLeaveReadWrite) LeaveReadWrite();
+            }
             if( eErr != CE_None )
             {
                 poBlock->DropLock();
@@ -1329,6 +1373,7 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
                         CPLSPrintf(": %s", CPLGetLastErrorMsg()) : "");
                 return nullptr;
             }
+            poBlock->WriteToSharedCache();
 
             nBlockReads++;
             if( static_cast<GIntBig>(nBlockReads) ==
@@ -1340,6 +1385,10 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             }
         }
     }
+    else
+    {
+        GDALBlockCacheCounters::Count(this, GDALBlockCacheEvent::HIT);
+    }
 
     return poBlock;
 }
@@ -4706,6 +4755,76 @@ void ComputeStatisticsInternal<GUInt16>( int nXCheck,
 
 #endif // (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
 
+/************************************************************************/
+/*                  GDALComputeStatisticsUInt8Or16()                    */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+
+// Accumulate the statistics of nVals contiguous values of type GDT_Byte or
+// GDT_UInt16 with the above code paths, for use by
+// GDALMDArray::ComputeStatistics(). pData must be aligned on 32 bytes.
+// nMin and nMax must be initialized respectively to 255 / 65535 and 0 before
+// the first call. nValidCount, dfMean and dfM2 (sum of squared differences
+// to the mean) are updated on output.
+void GDALComputeStatisticsUInt8Or16( GDALDataType eDataType,
+                                     const void* pData,
+                                     size_t nVals,
+                                     bool bHasNoData,
+                                     GUInt32 nNoDataValue,
+                                     GUInt32& nMin,
+                                     GUInt32& nMax,
+                                     GUInt64& nValidCount,
+                                     double& dfMean,
+                                     double& dfM2 )
+{
+    CPLAssert( eDataType == GDT_Byte || eDataType == GDT_UInt16 );
+    // Small enough so that the sum of squares fits on a uint64, and a
+    // multiple of 32 to preserve the alignment of the pieces.
+    constexpr size_t nPieceSize = 16 * 1024 * 1024;
+    for( size_t i = 0; i < nVals; i += nPieceSize )
+    {
+        const int nThisPiece = static_cast<int>(std::min(nPieceSize, nVals - i));
+        GUIntBig nSum = 0;
+        GUIntBig nSumSquare = 0;
+        GUIntBig nSampleCount = 0;
+        GUIntBig nValidCountPiece = 0;
+        if( eDataType == GDT_Byte )
+        {
+            ComputeStatisticsInternal( nThisPiece, nThisPiece, 1,
+                                       static_cast<const GByte*>(pData) + i,
+                                       bHasNoData, nNoDataValue,
+                                       nMin, nMax, nSum, nSumSquare,
+                                       nSampleCount, nValidCountPiece );
+        }
+        else
+        {
+            ComputeStatisticsInternal( nThisPiece, nThisPiece, 1,
+                                       static_cast<const GUInt16*>(pData) + i,
+                                       bHasNoData, nNoDataValue,
+                                       nMin, nMax, nSum, nSumSquare,
+                                       nSampleCount, nValidCountPiece );
+        }
+        if( nValidCountPiece == 0 )
+            continue;
+
+        // Merge the statistics of this piece with the previous ones
+        const double dfNPiece = static_cast<double>(nValidCountPiece);
+        const double dfMeanPiece = static_cast<double>(nSum) / dfNPiece;
+        const double dfM2Piece = static_cast<double>(
+            GDALUInt128::Mul(nSumSquare, nValidCountPiece) -
+            GDALUInt128::Mul(nSum, nSum)) / dfNPiece;
+        const double dfN = static_cast<double>(nValidCount);
+        const double dfNTotal = dfN + dfNPiece;
+        const double dfDelta = dfMeanPiece - dfMean;
+        dfMean += dfDelta * dfNPiece / dfNTotal;
+        dfM2 += dfM2Piece + dfDelta * dfDelta * dfN * dfNPiece / dfNTotal;
+        nValidCount += nValidCountPiece;
+    }
+}
+
+//! @endcond
+
 #endif // CPL_HAS_GINT64
 
 
@@ -4851,6 +4970,528 @@ void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount
     }
 }
 
+/************************************************************************/
+/*                    Stratified block sampling                         */
+/************************************************************************/
+
+namespace {
+
+// Statistics of one sampled block, and weight of the stratum it stands for.
+struct GDALStatsBlockSample
+{
+    int      nXBlock = 0;
+    int      nYBlock = 0;
+    double   dfWeight = 0.0;
+    GUIntBig nSampleCount = 0;
+    GUIntBig nValidCount = 0;
+    double   dfMin = 0.0;
+    double   dfMax = 0.0;
+    double   dfMean = 0.0;
+    double   dfM2 = 0.0;
+};
+
+struct GDALStatsSamplingContext
+{
+    GDALDataType eDataType = GDT_Unknown;
+    bool         bSignedByte = false;
+    bool         bGotNoDataValue = false;
+    double       dfNoDataValue = 0.0;
+    bool         bGotFloatNoDataValue = false;
+    float        fNoDataValue = 0.0f;
+    int          nBlockXSize = 0;
+    GDALStatsBlockSample* pasSamples = nullptr;
+
+    // Used by the jobs to reopen the dataset.
+    CPLString     osFilename{};
+    CPLStringList aosOpenOptions{};
+    int           nBand = 0;
+    int           nXSize = 0;
+    int           nYSize = 0;
+};
+
+// Progress of the jobs, reported by the calling thread.
+struct GDALStatsSamplingProgress
+{
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    size_t                  nSamplesDone = 0;
+    size_t                  nJobsDone = 0;
+    bool                    bStop = false;
+};
+
+struct GDALStatsSamplingJob
+{
+    const GDALStatsSamplingContext* psCtxt = nullptr;
+    GDALStatsSamplingProgress* psProgress = nullptr;
+    size_t  iStart = 0;
+    size_t  iEnd = 0;
+    bool    bSuccess = false;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+};
+
+} // namespace
+
+/************************************************************************/
+/*                     GDALStatsReadBlockSamples()                      */
+/************************************************************************/
+
+static bool GDALStatsReadBlockSamples( GDALRasterBand* poBand,
+                                       const GDALStatsSamplingContext& sCtxt,
+                                       size_t iStart, size_t iEnd,
+                                       size_t nTotal,
+                                       GDALProgressFunc pfnProgress,
+                                       void* pProgressData )
+{
+    for( size_t i = iStart; i < iEnd; i++ )
+    {
+        GDALStatsBlockSample& sSample = sCtxt.pasSamples[i];
+        GDALRasterBlock * const poBlock =
+            poBand->GetLockedBlockRef( sSample.nXBlock, sSample.nYBlock );
+        if( poBlock == nullptr )
+            return false;
+
+        const void* const pData = poBlock->GetDataRef();
+
+        int nXCheck = 0, nYCheck = 0;
+        poBand->GetActualBlockSize(sSample.nXBlock, sSample.nYBlock,
+                                   &nXCheck, &nYCheck);
+
+        sSample.nSampleCount = 0;
+        sSample.nValidCount = 0;
+        sSample.dfMean = 0.0;
+        sSample.dfM2 = 0.0;
+        for( int iY = 0; iY < nYCheck; iY++ )
+        {
+            for( int iX = 0; iX < nXCheck; iX++ )
+            {
+                const GPtrDiff_t iOffset =
+                    iX + static_cast<GPtrDiff_t>(iY) * sCtxt.nBlockXSize;
+                bool bValid = true;
+                const double dfValue = GetPixelValue( sCtxt.eDataType,
+                                                      sCtxt.bSignedByte,
+                                                      pData,
+                                                      iOffset,
+                                                      sCtxt.bGotNoDataValue,
+                                                      sCtxt.dfNoDataValue,
+                                                      sCtxt.bGotFloatNoDataValue,
+                                                      sCtxt.fNoDataValue,
+                                                      bValid );
+                sSample.nSampleCount++;
+                if( !bValid )
+                    continue;
+
+                if( sSample.nValidCount == 0 )
+                {
+                    sSample.dfMin = dfValue;
+                    sSample.dfMax = dfValue;
+                }
+                else
+                {
+                    sSample.dfMin = std::min(sSample.dfMin, dfValue);
+                    sSample.dfMax = std::max(sSample.dfMax, dfValue);
+                }
+
+                sSample.nValidCount++;
+                const double dfDelta = dfValue - sSample.dfMean;
+                sSample.dfMean += dfDelta / sSample.nValidCount;
+                sSample.dfM2 += dfDelta * (dfValue - sSample.dfMean);
+            }
+        }
+
+        poBlock->DropLock();
+
+        if( pfnProgress != nullptr &&
+            !pfnProgress( static_cast<double>(i + 1) / nTotal,
+                          "Compute Statistics", pProgressData) )
+        {
+            poBand->ReportError( CE_Failure, CPLE_UserInterrupt,
+                                 "User terminated" );
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                    GDALStatsSamplingJobProgress()                    */
+/************************************************************************/
+
+static int CPL_STDCALL GDALStatsSamplingJobProgress( double /* dfComplete */,
+                                                     const char* /* pszMsg */,
+                                                     void* pData )
+{
+    auto psProgress = static_cast<GDALStatsSamplingProgress*>(pData);
+    {
+        std::lock_guard<std::mutex> oLock(psProgress->oMutex);
+        if( psProgress->bStop )
+            return FALSE;
+        psProgress->nSamplesDone++;
+    }
+    psProgress->oCV.notify_one();
+    return TRUE;
+}
+
+/************************************************************************/
+/*                      GDALStatsSamplingJobFunc()                      */
+/************************************************************************/
+
+static void GDALStatsSamplingJobFunc( void* pData )
+{
+    auto psJob = static_cast<GDALStatsSamplingJob*>(pData);
+    const auto& sCtxt = *(psJob->psCtxt);
+
+    CPLInstallErrorHandlerAccumulator(psJob->aoErrors);
+    CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+
+    // Each job uses its own dataset, so that the blocks of the different
+    // jobs are fetched concurrently.
+    auto poDS = GDALDataset::Open(sCtxt.osFilename.c_str(),
+                                  GDAL_OF_RASTER | GDAL_OF_INTERNAL,
+                                  nullptr, sCtxt.aosOpenOptions.List(),
+                                  nullptr);
+    if( poDS && poDS->GetRasterXSize() == sCtxt.nXSize &&
+        poDS->GetRasterYSize() == sCtxt.nYSize )
+    {
+        auto poBand = poDS->GetRasterBand(sCtxt.nBand);
+        int nBlockXSize = 0;
+        int nBlockYSize = 0;
+        if( poBand )
+            poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+        if( poBand && poBand->GetRasterDataType() == sCtxt.eDataType &&
+            nBlockXSize == sCtxt.nBlockXSize )
+        {
+            psJob->bSuccess = GDALStatsReadBlockSamples(
+                poBand, sCtxt, psJob->iStart, psJob->iEnd, 1,
+                GDALStatsSamplingJobProgress, psJob->psProgress);
+        }
+    }
+    delete poDS;
+
+    CPLUninstallErrorHandlerAccumulator();
+
+    {
+        std::lock_guard<std::mutex> oLock(psJob->psProgress->oMutex);
+        psJob->psProgress->nJobsDone++;
+    }
+    psJob->psProgress->oCV.notify_one();
+}
+
+/************************************************************************/
+/*                  GDALStatsUseStratifiedSampling()                    */
+/************************************************************************/
+
+static bool GDALStatsUseStratifiedSampling( GDALRasterBand* poBand )
+{
+    const char* pszSampling =
+        CPLGetConfigOption("GDAL_STATS_APPROX_SAMPLING", "AUTO");
+    if( EQUAL(pszSampling, "STRATIFIED") )
+        return true;
+    if( !EQUAL(pszSampling, "AUTO") )
+        return false;
+    // By default, only used on network file systems, where the latency of
+    // the sequential reads dominates.
+    GDALDataset* poDS = poBand->GetDataset();
+    return poDS != nullptr &&
+           VSIHasOptimizedReadMultiRange(poDS->GetDescription());
+}
+
+/************************************************************************/
+/*                  ComputeStatisticsFromBlockSample()                  */
+/************************************************************************/
+
+/**
+ * \brief Compute approximate statistics from a stratified sample of blocks.
+ *
+ * The raster is divided in a grid of strata of neighbouring blocks, with
+ * a shape close to the one of the raster, and a pseudo-randomly chosen
+ * block of each stratum is read. No more than nSampleCount blocks, and
+ * GDAL_STATS_APPROX_MAX_BYTES bytes, are read. When GDAL_NUM_THREADS is
+ * set, the blocks are read by several threads, each one with its own
+ * dataset.
+ *
+ * The mean is estimated as a ratio estimator, each block being weighted by
+ * the number of blocks of its stratum, and its standard error is stored in
+ * the STATISTICS_MEAN_STDERR metadata item.
+ */
+
+CPLErr
+GDALRasterBand::ComputeStatisticsFromBlockSample( int nSampleCount,
+                                                  double *pdfMin,
+                                                  double *pdfMax,
+                                                  double *pdfMean,
+                                                  double *pdfStdDev,
+                                                  GDALProgressFunc pfnProgress,
+                                                  void *pProgressData )
+{
+    const GIntBig nBlocks =
+        static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerColumn;
+    const GIntBig nBlockBytes =
+        static_cast<GIntBig>(nBlockXSize) * nBlockYSize *
+        std::max(1, GDALGetDataTypeSizeBytes(eDataType));
+    const GIntBig nMaxBytes = std::max(static_cast<GIntBig>(0),
+        CPLAtoGIntBig(CPLGetConfigOption("GDAL_STATS_APPROX_MAX_BYTES",
+                                         "67108864")));
+    const GIntBig nTarget = std::max(static_cast<GIntBig>(1),
+        std::min(std::min(static_cast<GIntBig>(nSampleCount), nBlocks),
+                 nMaxBytes / nBlockBytes));
+
+/* -------------------------------------------------------------------- */
+/*      Build a grid of gx x gy strata, and pick one block in each.     */
+/* -------------------------------------------------------------------- */
+    const int nStrataX = static_cast<int>(std::max(1.0, std::min(
+        static_cast<double>(std::min(static_cast<GIntBig>(nBlocksPerRow),
+                                     nTarget)),
+        std::floor(sqrt(static_cast<double>(nTarget) * nBlocksPerRow /
+                        nBlocksPerColumn) + 0.5))));
+    const int nStrataY = static_cast<int>(std::max(static_cast<GIntBig>(1),
+        std::min(static_cast<GIntBig>(nBlocksPerColumn), nTarget / nStrataX)));
+
+    std::vector<GDALStatsBlockSample> asSamples;
+    asSamples.reserve(static_cast<size_t>(nStrataX) * nStrataY);
+    GUInt64 nState = 0x9E3779B97F4A7C15ULL;
+    for( int j = 0; j < nStrataY; j++ )
+    {
+        const int nY0 = static_cast<int>(
+            static_cast<GIntBig>(j) * nBlocksPerColumn / nStrataY);
+        const int nY1 = static_cast<int>(
+            static_cast<GIntBig>(j + 1) * nBlocksPerColumn / nStrataY);
+        for( int i = 0; i < nStrataX; i++ )
+        {
+            const int nX0 = static_cast<int>(
+                static_cast<GIntBig>(i) * nBlocksPerRow / nStrataX);
+            const int nX1 = static_cast<int>(
+                static_cast<GIntBig>(i + 1) * nBlocksPerRow / nStrataX);
+            // Deterministic pseudo-random generator (xorshift64*), so that
+            // the same statistics are computed on the same raster.
+            nState ^= nState >> 12;
+            nState ^= nState << 25;
+            nState ^= nState >> 27;
+            const GUInt64 nRand = nState * 0x2545F4914F6CDD1DULL;
+            const GUInt64 nStratumBlocks =
+                static_cast<GUInt64>(nX1 - nX0) * (nY1 - nY0);
+            const GUInt64 iBlock = (nRand >> 11) % nStratumBlocks;
+            GDALStatsBlockSample sSample;
+            sSample.nXBlock = nX0 + static_cast<int>(iBlock % (nX1 - nX0));
+            sSample.nYBlock = nY0 + static_cast<int>(iBlock / (nX1 - nX0));
+            sSample.dfWeight = static_cast<double>(nStratumBlocks);
+            asSamples.push_back(sSample);
+        }
+    }
+    const size_t nSamples = asSamples.size();
+
+    GDALStatsSamplingContext sCtxt;
+    sCtxt.eDataType = eDataType;
+    const char* pszPixelType =
+        GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+    sCtxt.bSignedByte =
+        pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
+    int bGotNoDataValue = FALSE;
+    sCtxt.dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
+    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(sCtxt.dfNoDataValue);
+    sCtxt.bGotNoDataValue = CPL_TO_BOOL(bGotNoDataValue);
+    ComputeFloatNoDataValue( eDataType, sCtxt.dfNoDataValue, bGotNoDataValue,
+                             sCtxt.fNoDataValue, sCtxt.bGotFloatNoDataValue );
+    sCtxt.nBlockXSize = nBlockXSize;
+    sCtxt.pasSamples = asSamples.data();
+
+/* -------------------------------------------------------------------- */
+/*      Read the sampled blocks, in parallel if possible.               */
+/* -------------------------------------------------------------------- */
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                      atoi(pszNumThreads);
+    nThreads = static_cast<int>(std::min(
+        static_cast<size_t>(std::max(1, std::min(128, nThreads))), nSamples));
+    if( poDS == nullptr || poDS->GetAccess() != GA_ReadOnly ||
+        poDS->GetDescription()[0] == '\0' || nBand <= 0 ||
+        poDS->GetRasterBand(nBand) != this )
+    {
+        nThreads = 1;
+    }
+    CPLWorkerThreadPool* poPool =
+        nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+
+    CPLDebug("GDAL", "Computing approximate statistics from %u blocks "
+             "(%d x %d strata) with %d thread(s)",
+             static_cast<unsigned>(nSamples), nStrataX, nStrataY,
+             poPool ? nThreads : 1);
+
+    if( poPool == nullptr )
+    {
+        if( !GDALStatsReadBlockSamples(this, sCtxt, 0, nSamples, nSamples,
+                                       pfnProgress, pProgressData) )
+            return CE_Failure;
+    }
+    else
+    {
+        sCtxt.osFilename = poDS->GetDescription();
+        sCtxt.aosOpenOptions.Assign(CSLDuplicate(poDS->GetOpenOptions()),
+                                    TRUE);
+        sCtxt.nBand = nBand;
+        sCtxt.nXSize = poDS->GetRasterXSize();
+        sCtxt.nYSize = poDS->GetRasterYSize();
+
+        const size_t nJobs = std::min(nSamples,
+                                      static_cast<size_t>(nThreads) * 2);
+        GDALStatsSamplingProgress sProgress;
+        std::vector<GDALStatsSamplingJob> asJobs(nJobs);
+        for( size_t i = 0; i < nJobs; i++ )
+        {
+            asJobs[i].psCtxt = &sCtxt;
+            asJobs[i].psProgress = &sProgress;
+            asJobs[i].iStart = i * nSamples / nJobs;
+            asJobs[i].iEnd = (i + 1) * nSamples / nJobs;
+        }
+        auto poQueue = poPool->CreateJobQueue();
+        for( auto& sJob: asJobs )
+            poQueue->SubmitJob(GDALStatsSamplingJobFunc, &sJob);
+
+        // Report the progress of the jobs from this thread, as the
+        // progress function may not be thread-safe.
+        {
+            std::unique_lock<std::mutex> oLock(sProgress.oMutex);
+            while( sProgress.nJobsDone < nJobs )
+            {
+                sProgress.oCV.wait(oLock);
+                const double dfComplete =
+                    static_cast<double>(sProgress.nSamplesDone) / nSamples;
+                oLock.unlock();
+                const bool bContinue = pfnProgress(
+                    dfComplete, "Compute Statistics", pProgressData) != FALSE;
+                oLock.lock();
+                if( !bContinue )
+                {
+                    sProgress.bStop = true;
+                    break;
+                }
+            }
+        }
+        poQueue->WaitCompletion();
+        if( sProgress.bStop )
+        {
+            ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            return CE_Failure;
+        }
+
+        // Jobs that failed are run again on this band, so that errors are
+        // reported as in the single-threaded case.
+        for( const auto& sJob: asJobs )
+        {
+            if( sJob.bSuccess )
+            {
+                for( const auto& oError: sJob.aoErrors )
+                    CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+                continue;
+            }
+            CPLDebug("GDAL", "Statistics sampling job failed. Retrying it");
+            if( !GDALStatsReadBlockSamples(this, sCtxt, sJob.iStart,
+                                           sJob.iEnd, 0, nullptr, nullptr) )
+                return CE_Failure;
+        }
+    }
+
+    if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
+    {
+        ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Combine the blocks, weighted by the size of their stratum.      */
+/* -------------------------------------------------------------------- */
+    GUIntBig nPixelCount = 0;
+    GUIntBig nValidCount = 0;
+    double dfMin = 0.0;
+    double dfMax = 0.0;
+    double dfSumWeights = 0.0;  // Estimated number of valid pixels.
+    double dfMean = 0.0;
+    double dfM2 = 0.0;
+    for( const auto& sSample: asSamples )
+    {
+        nPixelCount += sSample.nSampleCount;
+        if( sSample.nValidCount == 0 )
+            continue;
+        if( nValidCount == 0 )
+        {
+            dfMin = sSample.dfMin;
+            dfMax = sSample.dfMax;
+        }
+        else
+        {
+            dfMin = std::min(dfMin, sSample.dfMin);
+            dfMax = std::max(dfMax, sSample.dfMax);
+        }
+        nValidCount += sSample.nValidCount;
+
+        // Parallel variant of the Welford algorithm (Chan et al.)
+        const double dfWeight =
+            sSample.dfWeight * static_cast<double>(sSample.nValidCount);
+        const double dfNewSumWeights = dfSumWeights + dfWeight;
+        const double dfDelta = sSample.dfMean - dfMean;
+        dfMean += dfDelta * dfWeight / dfNewSumWeights;
+        dfM2 += sSample.dfWeight * sSample.dfM2 +
+                dfDelta * dfDelta * dfSumWeights * dfWeight / dfNewSumWeights;
+        dfSumWeights = dfNewSumWeights;
+    }
+
+    if( nValidCount == 0 )
+    {
+        SetValidPercent( nPixelCount, nValidCount );
+        ReportError(
+            CE_Failure, CPLE_AppDefined,
+            "Failed to compute statistics, no valid pixels found in sampling." );
+        return CE_Failure;
+    }
+
+    const double dfStdDev = sqrt(dfM2 / dfSumWeights);
+
+    // Linearized standard error of the ratio estimator of the mean, with
+    // the sampled blocks as clusters. As each stratum has a single block,
+    // the variance is estimated from the differences between neighbouring
+    // strata (successive difference estimator).
+    double dfMeanStdErr = 0.0;
+    if( nSamples > 1 )
+    {
+        double dfSumSqDiff = 0.0;
+        double dfPrevResidual = 0.0;
+        for( size_t i = 0; i < nSamples; i++ )
+        {
+            const auto& sSample = asSamples[i];
+            const double dfResidual =
+                sSample.nValidCount == 0 ? 0.0 :
+                sSample.dfWeight * static_cast<double>(sSample.nValidCount) *
+                (sSample.dfMean - dfMean);
+            if( i > 0 )
+                dfSumSqDiff += (dfResidual - dfPrevResidual) *
+                               (dfResidual - dfPrevResidual);
+            dfPrevResidual = dfResidual;
+        }
+        const double dfSamplingFraction =
+            static_cast<double>(nSamples) / static_cast<double>(nBlocks);
+        dfMeanStdErr = sqrt( (1.0 - dfSamplingFraction) *
+                             static_cast<double>(nSamples) /
+                             (2.0 * static_cast<double>(nSamples - 1)) *
+                             dfSumSqDiff ) / dfSumWeights;
+    }
+
+    SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+    SetMetadataItem( "STATISTICS_MEAN_STDERR",
+                     CPLSPrintf("%.14g", dfMeanStdErr) );
+    SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
+    SetValidPercent( nPixelCount, nValidCount );
+
+    if( pdfMin != nullptr )
+        *pdfMin = dfMin;
+    if( pdfMax != nullptr )
+        *pdfMax = dfMax;
+    if( pdfMean != nullptr )
+        *pdfMean = dfMean;
+    if( pdfStdDev != nullptr )
+        *pdfStdDev = dfStdDev;
+
+    return CE_None;
+}
+
 /************************************************************************/
 /*                         ComputeStatistics()                          */
 /************************************************************************/
@@ -4901,6 +5542,10 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
     if( pfnProgress == nullptr )
         pfnProgress = GDALDummyProgress;
 
+    // Only set when computed from a sample of blocks.
+    if( GetMetadataItem( "STATISTICS_MEAN_STDERR" ) )
+        SetMetadataItem( "STATISTICS_MEAN_STDERR", nullptr );
+
 /* -------------------------------------------------------------------- */
 /*      If we have overview bands, use them for statistics.             */
 /* -------------------------------------------------------------------- */
@@ -5079,6 +5724,16 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         if( nSampleRate == 1 )
             bApproxOK = false;
 
+        if( bApproxOK && GDALStatsUseStratifiedSampling(this) )
+        {
+            return ComputeStatisticsFromBlockSample(
+                static_cast<int>(DIV_ROUND_UP(
+                    static_cast<GIntBig>(nBlocksPerRow) * nBlocksPerColumn,
+                    nSampleRate)),
+                pdfMin, pdfMax, pdfMean, pdfStdDev,
+                pfnProgress, pProgressData );
+        }
+
 #ifdef CPL_HAS_GINT64
         // Particular case for GDT_Byte that only use integral types for all
         // intermediate computations. Only possible if the number of pixels
@@ -35,14 +35,30 @@
 #include <algorithm>
 #include <climits>
 #include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 
+#if defined(__linux__) && defined(HAVE_MMAP) && defined(CPL_MULTIPROC_PTHREAD)
+#define GDAL_HAS_SHARED_BLOCK_CACHE
+#include <cerrno>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 CPL_CVSID("$Id$")
 
 static bool bCacheMaxInitialized = false;
@@ -55,6 +71,14 @@ static GDALRasterBlock *poNewest = nullptr;  // Head.
 
 static int nDisableDirtyBlockFlushCounter = 0;
 
+// Buffers of evicted blocks, by block size, kept to be reused by the next
+// blocks of the same size. Their cumulated effective size counts, with
+// nCacheUsed, against GDAL_CACHEMAX.
+static bool bRecycleBlockBuffers = true;
+static std::mutex goRecycledBuffersMutex;
+static std::map<GPtrDiff_t, std::vector<void*>> goMapRecycledBuffers;
+static GIntBig nRecycledBuffersSize = 0;
+
 #if 0
 static CPLMutex *hRBLock = nullptr;
 #define INITIALIZE_LOCK CPLMutexHolderD( &hRBLock )
@@ -99,6 +123,17 @@ static CPLLockType GetLockType()
 
 #endif
 
+/************************************************************************/
+/*                         GetCacheUsedLocked()                         */
+/************************************************************************/
+
+// Return nCacheUsed for the code that does not hold hRBLock.
+static GIntBig GetCacheUsedLocked()
+{
+    TAKE_LOCK;
+    return nCacheUsed;
+}
+
 //#define ENABLE_DEBUG
 
 /************************************************************************/
@@ -161,9 +196,12 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
     nCacheMax = nNewSizeInBytes;
 
 /* -------------------------------------------------------------------- */
-/*      Flush blocks till we are under the new limit or till we         */
-/*      can't seem to flush anymore.                                    */
+/*      Release recycled block buffers first, and then flush blocks     */
+/*      till we are under the new limit or till we can't seem to       */
+/*      flush anymore.                                                  */
 /* -------------------------------------------------------------------- */
+    GDALRasterBlock::TrimRecycledBuffers(
+        std::max<GIntBig>(0, nCacheMax - GetCacheUsedLocked()));
     while( nCacheUsed > nCacheMax )
     {
         const GIntBig nOldCacheUsed = nCacheUsed;
@@ -245,6 +283,8 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
         }
         bSleepsForBockCacheDebug = CPLTestBool(
             CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
+        bRecycleBlockBuffers = CPLTestBool(
+            CPLGetConfigOption("GDAL_RECYCLE_BLOCK_BUFFERS", "YES"));
 
         const char* pszCacheMax = CPLGetConfigOption("GDAL_CACHEMAX","5%");
 
@@ -375,6 +415,113 @@ int CPL_STDCALL GDALFlushCacheBlock()
     return GDALRasterBlock::FlushCacheBlock();
 }
 
+/************************************************************************/
+/*                       GDALBlockCacheCounters                         */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+
+static GDALBlockCacheCounters goBlockCacheCounters;
+
+GDALBlockCacheCounters& GDALGetBlockCacheCounters()
+{
+    return goBlockCacheCounters;
+}
+
+void GDALBlockCacheCounters::Increment(GDALBlockCacheEvent eEvent)
+{
+    // Counters are only read for statistics purposes, so no ordering with
+    // other memory operations is needed.
+    switch( eEvent )
+    {
+        case GDALBlockCacheEvent::HIT:
+            nHits.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case GDALBlockCacheEvent::MISS:
+            nMisses.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case GDALBlockCacheEvent::EVICTION:
+            nEvictions.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case GDALBlockCacheEvent::DIRTY_FLUSH:
+            nDirtyFlushes.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+}
+
+char** GDALBlockCacheCounters::AppendTo(char** papszList) const
+{
+    papszList = CSLSetNameValue(papszList, "BLOCK_CACHE_HITS",
+        CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(nHits)));
+    papszList = CSLSetNameValue(papszList, "BLOCK_CACHE_MISSES",
+        CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(nMisses)));
+    papszList = CSLSetNameValue(papszList, "BLOCK_CACHE_EVICTIONS",
+        CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(nEvictions)));
+    papszList = CSLSetNameValue(papszList, "BLOCK_CACHE_DIRTY_FLUSHES",
+        CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(nDirtyFlushes)));
+    return papszList;
+}
+
+/* Count an event in the process-wide counters, and in the ones of the */
+/* dataset and driver of the band. */
+void GDALBlockCacheCounters::Count(GDALRasterBand* poBand,
+                                   GDALBlockCacheEvent eEvent)
+{
+    goBlockCacheCounters.Increment(eEvent);
+    GDALDataset* poDS = poBand ? poBand->GetDataset() : nullptr;
+    if( poDS )
+    {
+        GDALBlockCacheCounters* poCounters = poDS->GetBlockCacheCounters();
+        if( poCounters )
+            poCounters->Increment(eEvent);
+        poCounters = poDS->GetDriverBlockCacheCounters();
+        if( poCounters )
+            poCounters->Increment(eEvent);
+    }
+}
+
+/* Counters of the drivers are kept out of GDALDriver, whose layout is part */
+/* of the ABI. They are owned by this map until the driver is destroyed. */
+static std::mutex goDriverBlockCacheCountersMutex;
+static std::map<GDALDriver*, std::unique_ptr<GDALBlockCacheCounters>>*
+                                        gpoMapDriverBlockCacheCounters = nullptr;
+
+GDALBlockCacheCounters* GDALGetDriverBlockCacheCounters(GDALDriver* poDriver,
+                                                        bool bCreate)
+{
+    std::lock_guard<std::mutex> oLock(goDriverBlockCacheCountersMutex);
+    if( gpoMapDriverBlockCacheCounters == nullptr )
+    {
+        if( !bCreate )
+            return nullptr;
+        gpoMapDriverBlockCacheCounters =
+            new std::map<GDALDriver*, std::unique_ptr<GDALBlockCacheCounters>>();
+    }
+    auto oIter = gpoMapDriverBlockCacheCounters->find(poDriver);
+    if( oIter != gpoMapDriverBlockCacheCounters->end() )
+        return oIter->second.get();
+    if( !bCreate )
+        return nullptr;
+    GDALBlockCacheCounters* poCounters = new GDALBlockCacheCounters();
+    (*gpoMapDriverBlockCacheCounters)[poDriver].reset(poCounters);
+    return poCounters;
+}
+
+void GDALRemoveDriverBlockCacheCounters(GDALDriver* poDriver)
+{
+    std::lock_guard<std::mutex> oLock(goDriverBlockCacheCountersMutex);
+    if( gpoMapDriverBlockCacheCounters == nullptr )
+        return;
+    gpoMapDriverBlockCacheCounters->erase(poDriver);
+    if( gpoMapDriverBlockCacheCounters->empty() )
+    {
+        delete gpoMapDriverBlockCacheCounters;
+        gpoMapDriverBlockCacheCounters = nullptr;
+    }
+}
+
+//! @endcond
+
 /************************************************************************/
 /* ==================================================================== */
 /*                           GDALRasterBlock                            */
@@ -465,6 +612,11 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         poTarget->GetBand()->UnreferenceBlock(poTarget);
     }
 
+    // Dirty blocks are counted as dirty flushes when written back.
+    if( !poTarget->GetDirty() )
+        GDALBlockCacheCounters::Count(poTarget->GetBand(),
+                                      GDALBlockCacheEvent::EVICTION);
+
     if( bSleepsForBockCacheDebug )
     {
         // coverity[tainted_data]
@@ -484,7 +636,7 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
     }
 
-    VSIFreeAligned(poTarget->pData);
+    VSIFreeLarge(poTarget->pData);
     poTarget->pData = nullptr;
     poTarget->GetBand()->AddBlockToFreeList(poTarget);
 
@@ -657,6 +809,124 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
     bMustDetach = true;
 }
 
+/************************************************************************/
+/*                        GetEffectiveBlockSize()                       */
+/************************************************************************/
+
+static size_t GetEffectiveBlockSize(GPtrDiff_t nBlockSize)
+{
+    // The real cost of a block allocation is more than just nBlockSize
+    // As we allocate with 64-byte alignment, use 64 as a multiple.
+    // We arbitrarily add 2 * sizeof(GDALRasterBlock) to account for that
+    return static_cast<size_t>(
+        std::min(static_cast<GUIntBig>(UINT_MAX),
+                    static_cast<GUIntBig>(DIV_ROUND_UP(nBlockSize, 64)) * 64 +
+                        2 * sizeof(GDALRasterBlock)));
+}
+
+/************************************************************************/
+/*                         GetRecycledBuffer()                          */
+/************************************************************************/
+
+// Return a recycled buffer of nSize bytes, or nullptr.
+static void* GetRecycledBuffer(GPtrDiff_t nSize)
+{
+    std::lock_guard<std::mutex> oLock(goRecycledBuffersMutex);
+    auto oIter = goMapRecycledBuffers.find(nSize);
+    if( oIter == goMapRecycledBuffers.end() )
+        return nullptr;
+    void* pData = oIter->second.back();
+    oIter->second.pop_back();
+    if( oIter->second.empty() )
+        goMapRecycledBuffers.erase(oIter);
+    nRecycledBuffersSize -= GetEffectiveBlockSize(nSize);
+    return pData;
+}
+
+/************************************************************************/
+/*                           RecycleBuffer()                            */
+/************************************************************************/
+
+// Keep the buffer of an evicted block for later reuse if this fits within
+// GDAL_CACHEMAX, otherwise free it.
+static void RecycleBuffer(void* pData, GPtrDiff_t nSize)
+{
+    if( pData == nullptr )
+        return;
+    if( bRecycleBlockBuffers )
+    {
+        const GIntBig nEffectiveSize = GetEffectiveBlockSize(nSize);
+        const GIntBig nCurCacheUsed = GetCacheUsedLocked();
+        std::lock_guard<std::mutex> oLock(goRecycledBuffersMutex);
+        if( nCurCacheUsed + nRecycledBuffersSize + nEffectiveSize <= nCacheMax )
+        {
+            try
+            {
+                goMapRecycledBuffers[nSize].push_back(pData);
+                nRecycledBuffersSize += nEffectiveSize;
+                return;
+            }
+            catch( const std::exception& )
+            {
+            }
+        }
+    }
+    VSIFreeLarge(pData);
+}
+
+/************************************************************************/
+/*                        TrimRecycledBuffers()                         */
+/************************************************************************/
+
+/**
+ * Free buffers of evicted blocks kept for reuse.
+ *
+ * Buffers of the largest sizes are freed first.
+ *
+ * This is done automatically when room is needed in the block cache, when
+ * GDALSetCacheMax() is called, or when an allocation fails.
+ *
+ * @param nMaxSize Maximum cumulated size, in bytes, of the buffers to keep.
+ * @since GDAL 3.4
+ */
+
+void GDALRasterBlock::TrimRecycledBuffers( GIntBig nMaxSize )
+{
+    std::vector<void*> apToFree;
+    {
+        std::lock_guard<std::mutex> oLock(goRecycledBuffersMutex);
+        while( nRecycledBuffersSize > nMaxSize &&
+               !goMapRecycledBuffers.empty() )
+        {
+            auto oIter = std::prev(goMapRecycledBuffers.end());
+            apToFree.push_back(oIter->second.back());
+            oIter->second.pop_back();
+            nRecycledBuffersSize -= GetEffectiveBlockSize(oIter->first);
+            if( oIter->second.empty() )
+                goMapRecycledBuffers.erase(oIter);
+        }
+    }
+    for( void* pData: apToFree )
+        VSIFreeLarge(pData);
+}
+
+/************************************************************************/
+/*                      GetRecycledBuffersSize()                        */
+/************************************************************************/
+
+/**
+ * Return the cumulated size, in bytes, of the buffers of evicted blocks
+ * kept for reuse.
+ *
+ * @since GDAL 3.4
+ */
+
+GIntBig GDALRasterBlock::GetRecycledBuffersSize()
+{
+    std::lock_guard<std::mutex> oLock(goRecycledBuffersMutex);
+    return nRecycledBuffersSize;
+}
+
 /************************************************************************/
 /*                          ~GDALRasterBlock()                          */
 /************************************************************************/
@@ -672,10 +942,11 @@ GDALRasterBlock::~GDALRasterBlock()
 {
     Detach();
 
-    if( pData != nullptr )
-    {
-        VSIFreeAligned( pData );
-    }
+    // Blocks evicted to make room for other ones give their buffer to the
+    // new block, or to the recycled buffers, in Internalize(). The
+    // remaining ones are destroyed when their band is flushed or closed,
+    // so their memory is given back.
+    VSIFreeLarge( pData );
 
     CPLAssert( nLockCount <= 0 );
 
@@ -684,21 +955,6 @@ GDALRasterBlock::~GDALRasterBlock()
 #endif
 }
 
-/************************************************************************/
-/*                        GetEffectiveBlockSize()                       */
-/************************************************************************/
-
-static size_t GetEffectiveBlockSize(GPtrDiff_t nBlockSize)
-{
-    // The real cost of a block allocation is more than just nBlockSize
-    // As we allocate with 64-byte alignment, use 64 as a multiple.
-    // We arbitrarily add 2 * sizeof(GDALRasterBlock) to account for that
-    return static_cast<size_t>(
-        std::min(static_cast<GUIntBig>(UINT_MAX),
-                    static_cast<GUIntBig>(DIV_ROUND_UP(nBlockSize, 64)) * 64 +
-                        2 * sizeof(GDALRasterBlock)));
-}
-
 /************************************************************************/
 /*                               Detach()                               */
 /************************************************************************/
@@ -845,6 +1101,18 @@ CPLErr GDALRasterBlock::Write()
 
     if (poBand->eFlushBlockErr == CE_None)
     {
+        GDALBlockCacheCounters::Count(poBand,
+                                      GDALBlockCacheEvent::DIRTY_FLUSH);
+
+        CPLTraceSpan oTraceSpan("gdal", "IWriteBlock");
+        if( oTraceSpan.IsActive() )
+        {
+            GDALDataset* poDS = poBand->GetDataset();
+            oTraceSpan.SetDetailf("%s band %d block %d,%d",
+                poDS ? CPLGetFilename(poDS->GetDescription()) : "",
+                poBand->GetBand(), nXOff, nYOff);
+        }
+
         int bCallLeaveReadWrite = poBand->EnterReadWrite(GF_Write);
         CPLErr eErr = poBand->IWriteBlock( nXOff, nYOff, pData );
         if( bCallLeaveReadWrite ) poBand->LeaveReadWrite();
@@ -950,6 +1218,19 @@ CPLErr GDALRasterBlock::Internalize()
     // No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo().
     const auto nSizeInBytes = GetBlockSize();
 
+/* -------------------------------------------------------------------- */
+/*      Reuse the buffer of a previously evicted block of the same      */
+/*      size, and release the other ones if they take the room needed   */
+/*      by this block.                                                  */
+/* -------------------------------------------------------------------- */
+    if( bRecycleBlockBuffers )
+    {
+        pNewData = GetRecycledBuffer(nSizeInBytes);
+        GDALRasterBlock::TrimRecycledBuffers(std::max<GIntBig>(0,
+            nCurCacheMax - GetCacheUsedLocked() -
+            (pNewData ? 0 : GetEffectiveBlockSize(nSizeInBytes))));
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Flush old blocks if we are nearing our memory limit.            */
 /* -------------------------------------------------------------------- */
@@ -1079,6 +1360,9 @@ CPLErr GDALRasterBlock::Internalize()
         for( int i = 0; i < nBlocksToFree; ++i)
         {
             GDALRasterBlock * const poBlock = apoBlocksToFree[i];
+            if( !poBlock->GetDirty() )
+                GDALBlockCacheCounters::Count(poBlock->GetBand(),
+                                              GDALBlockCacheEvent::EVICTION);
 
             if( poBlock->GetDirty() )
             {
@@ -1110,7 +1394,7 @@ CPLErr GDALRasterBlock::Internalize()
             }
             else
             {
-                VSIFreeAligned(poBlock->pData);
+                RecycleBuffer(poBlock->pData, poBlock->GetBlockSize());
             }
             poBlock->pData = nullptr;
 
@@ -1121,10 +1405,16 @@ CPLErr GDALRasterBlock::Internalize()
 
     if( pNewData == nullptr )
     {
-        pNewData = VSI_MALLOC_ALIGNED_AUTO_VERBOSE( nSizeInBytes );
+        pNewData = VSIMallocLarge( nSizeInBytes );
         if( pNewData == nullptr )
         {
-            return( CE_Failure );
+            // Retry after having released recycled buffers
+            TrimRecycledBuffers(0);
+            pNewData = VSI_MALLOC_LARGE_VERBOSE( nSizeInBytes );
+            if( pNewData == nullptr )
+            {
+                return( CE_Failure );
+            }
         }
     }
 
@@ -1180,6 +1470,7 @@ void GDALRasterBlock::MarkClean()
 /*! @cond Doxygen_Suppress */
 void GDALRasterBlock::DestroyRBMutex()
 {
+    TrimRecycledBuffers(0);
     if( hRBLock != nullptr )
         DESTROY_LOCK;
     hRBLock = nullptr;
@@ -1266,6 +1557,659 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
     return FALSE;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                      Shared memory block cache                       */
+/* ==================================================================== */
+/************************************************************************/
+
+// Blocks of read-only datasets can be shared with other processes through
+// a file mapped in memory (typically in /dev/shm), pointed by the
+// GDAL_SHARED_BLOCK_CACHE configuration option. The file holds a hash
+// table of blocks, whose content is stored in chains of fixed size slots.
+// All accesses are protected by a robust process-shared mutex: if a
+// process dies while holding it, the next process that takes it resets
+// the cache, which might have been left inconsistent.
+
+/*! @cond Doxygen_Suppress */
+struct GDALSharedBlockKey
+{
+    GUInt64 anDatasetKey[2];
+    GInt32  nBand;
+    GInt32  nRasterXSize;
+    GInt32  nRasterYSize;
+    GInt32  nDataType;
+    GInt32  nBlockXSize;
+    GInt32  nBlockYSize;
+    GInt32  nXBlockOff;
+    GInt32  nYBlockOff;
+};
+/*! @endcond */
+
+#ifdef GDAL_HAS_SHARED_BLOCK_CACHE
+
+namespace {
+
+constexpr const char szSharedBlockCacheMagic[] = "GDALSHBLKCACHE1";
+
+struct GDALSharedBlockEntry
+{
+    GDALSharedBlockKey sKey;
+    GUInt64 nDataSize;
+    GInt32  nFirstSlot;
+    GInt32  nNext;          // Next entry of the bucket, or free entry.
+    GInt32  nBucket;
+    GInt32  bUsed;
+    GInt32  bReferenced;    // For the CLOCK eviction.
+    GInt32  nPadding;
+};
+
+struct GDALSharedBlockCacheHeader
+{
+    char            szMagic[16];
+    GUInt64         nTotalSize;
+    GUInt64         nSlotSize;
+    GInt32          nSlots;         // Also the number of entries and buckets.
+    GInt32          nFreeSlots;
+    GInt32          nFreeSlotHead;
+    GInt32          nFreeEntryHead;
+    GInt32          nClockHand;
+    GInt32          nPadding;
+    GUInt64         nHits;
+    GUInt64         nMisses;
+    GUInt64         nEvictions;
+    GUInt64         nRecoveries;
+    pthread_mutex_t sMutex;
+};
+
+constexpr size_t SHARED_CACHE_ALIGNMENT = 64;
+
+size_t SharedCacheAlign( size_t nSize )
+{
+    return (nSize + SHARED_CACHE_ALIGNMENT - 1) &
+                            ~(SHARED_CACHE_ALIGNMENT - 1);
+}
+
+size_t SharedCacheRequiredSize( size_t nSlots, size_t nSlotSize )
+{
+    return SharedCacheAlign(sizeof(GDALSharedBlockCacheHeader)) +
+           SharedCacheAlign(nSlots * sizeof(GInt32)) +              // buckets
+           SharedCacheAlign(nSlots * sizeof(GDALSharedBlockEntry)) +
+           SharedCacheAlign(nSlots * sizeof(GInt32)) +              // slot chains
+           nSlots * nSlotSize;
+}
+
+class GDALSharedBlockCache
+{
+    GDALSharedBlockCacheHeader* m_psHeader = nullptr;
+    GInt32*                     m_panBuckets = nullptr;
+    GDALSharedBlockEntry*       m_pasEntries = nullptr;
+    GInt32*                     m_panNextSlot = nullptr;
+    GByte*                      m_pabySlots = nullptr;
+
+    void    Map( void* pBase );
+    void    Reset();
+    bool    Lock();
+    void    Unlock() { pthread_mutex_unlock(&m_psHeader->sMutex); }
+    GInt32  Find( const GDALSharedBlockKey& sKey, size_t nBucket ) const;
+    void    Remove( GInt32 iEntry );
+    bool    EvictOne();
+
+    GDALSharedBlockCache( const GDALSharedBlockCache& ) = delete;
+    GDALSharedBlockCache& operator=( const GDALSharedBlockCache& ) = delete;
+
+  public:
+    GDALSharedBlockCache() = default;
+
+    bool    Open( const char* pszFilename, GIntBig nSize, GIntBig nSlotSize );
+    bool    Read( const GDALSharedBlockKey& sKey, void* pData, size_t nSize );
+    void    Write( const GDALSharedBlockKey& sKey, const void* pData,
+                   size_t nSize );
+};
+
+/************************************************************************/
+/*                                Map()                                 */
+/************************************************************************/
+
+void GDALSharedBlockCache::Map( void* pBase )
+{
+    GByte* pabyIter = static_cast<GByte*>(pBase);
+    m_psHeader = reinterpret_cast<GDALSharedBlockCacheHeader*>(pabyIter);
+    const size_t nSlots = static_cast<size_t>(m_psHeader->nSlots);
+    pabyIter += SharedCacheAlign(sizeof(GDALSharedBlockCacheHeader));
+    m_panBuckets = reinterpret_cast<GInt32*>(pabyIter);
+    pabyIter += SharedCacheAlign(nSlots * sizeof(GInt32));
+    m_pasEntries = reinterpret_cast<GDALSharedBlockEntry*>(pabyIter);
+    pabyIter += SharedCacheAlign(nSlots * sizeof(GDALSharedBlockEntry));
+    m_panNextSlot = reinterpret_cast<GInt32*>(pabyIter);
+    pabyIter += SharedCacheAlign(nSlots * sizeof(GInt32));
+    m_pabySlots = pabyIter;
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+// Empty the cache. Must be called with the mutex held, or on a new cache.
+void GDALSharedBlockCache::Reset()
+{
+    const GInt32 nSlots = m_psHeader->nSlots;
+    for( GInt32 i = 0; i < nSlots; i++ )
+    {
+        m_panBuckets[i] = -1;
+        m_pasEntries[i].bUsed = FALSE;
+        m_pasEntries[i].nNext = (i + 1 < nSlots) ? i + 1 : -1;
+        m_panNextSlot[i] = (i + 1 < nSlots) ? i + 1 : -1;
+    }
+    m_psHeader->nFreeSlots = nSlots;
+    m_psHeader->nFreeSlotHead = 0;
+    m_psHeader->nFreeEntryHead = 0;
+    m_psHeader->nClockHand = 0;
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+bool GDALSharedBlockCache::Open( const char* pszFilename, GIntBig nSize,
+                                 GIntBig nSlotSize )
+{
+    const int fd = open(pszFilename, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if( fd < 0 )
+    {
+        CPLError(CE_Warning, CPLE_FileIO,
+                 "Cannot open shared block cache %s: %s",
+                 pszFilename, strerror(errno));
+        return false;
+    }
+
+    // The lock is released by the kernel if this process dies, so a
+    // partially initialized cache will be initialized again by the next
+    // process, as its magic is written last.
+    if( flock(fd, LOCK_EX) != 0 )
+    {
+        close(fd);
+        return false;
+    }
+
+    void* pBase = MAP_FAILED;
+    size_t nMappedSize = 0;
+    struct stat sStat;
+    if( fstat(fd, &sStat) == 0 &&
+        static_cast<size_t>(sStat.st_size) >=
+                                    sizeof(GDALSharedBlockCacheHeader) )
+    {
+        nMappedSize = static_cast<size_t>(sStat.st_size);
+        pBase = mmap(nullptr, nMappedSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+        if( pBase != MAP_FAILED )
+        {
+            const auto psHeader =
+                static_cast<const GDALSharedBlockCacheHeader*>(pBase);
+            if( memcmp(psHeader->szMagic, szSharedBlockCacheMagic,
+                       sizeof(szSharedBlockCacheMagic)) == 0 &&
+                psHeader->nTotalSize == nMappedSize &&
+                SharedCacheRequiredSize(
+                    static_cast<size_t>(psHeader->nSlots),
+                    static_cast<size_t>(psHeader->nSlotSize)) <= nMappedSize )
+            {
+                Map(pBase);
+            }
+            else
+            {
+                munmap(pBase, nMappedSize);
+                pBase = MAP_FAILED;
+            }
+        }
+    }
+
+    if( pBase == MAP_FAILED )
+    {
+        // Create the cache.
+        const size_t nPerSlot = static_cast<size_t>(nSlotSize) +
+                                sizeof(GDALSharedBlockEntry) +
+                                2 * sizeof(GInt32);
+        const size_t nSlots = std::min(
+            static_cast<size_t>(INT_MAX),
+            static_cast<size_t>(nSize) / nPerSlot);
+        nMappedSize = nSlots > 0 ?
+            SharedCacheRequiredSize(nSlots, static_cast<size_t>(nSlotSize)) : 0;
+        if( nSlots == 0 ||
+            ftruncate(fd, static_cast<off_t>(nMappedSize)) != 0 ||
+            (pBase = mmap(nullptr, nMappedSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0)) == MAP_FAILED )
+        {
+            CPLError(CE_Warning, CPLE_FileIO,
+                     "Cannot create shared block cache %s", pszFilename);
+            flock(fd, LOCK_UN);
+            close(fd);
+            return false;
+        }
+
+        auto psHeader = static_cast<GDALSharedBlockCacheHeader*>(pBase);
+        memset(psHeader, 0, sizeof(GDALSharedBlockCacheHeader));
+        psHeader->nTotalSize = nMappedSize;
+        psHeader->nSlotSize = static_cast<GUInt64>(nSlotSize);
+        psHeader->nSlots = static_cast<GInt32>(nSlots);
+
+        pthread_mutexattr_t sAttr;
+        pthread_mutexattr_init(&sAttr);
+        pthread_mutexattr_setpshared(&sAttr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&sAttr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&psHeader->sMutex, &sAttr);
+        pthread_mutexattr_destroy(&sAttr);
+
+        Map(pBase);
+        Reset();
+        memcpy(psHeader->szMagic, szSharedBlockCacheMagic,
+               sizeof(szSharedBlockCacheMagic));
+        msync(pBase, sizeof(GDALSharedBlockCacheHeader), MS_ASYNC);
+    }
+
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    CPLDebug("GDAL", "Using shared block cache %s of %d slots of %d bytes",
+             pszFilename, m_psHeader->nSlots,
+             static_cast<int>(m_psHeader->nSlotSize));
+    return true;
+}
+
+/************************************************************************/
+/*                                Lock()                                */
+/************************************************************************/
+
+bool GDALSharedBlockCache::Lock()
+{
+    const int nRet = pthread_mutex_lock(&m_psHeader->sMutex);
+    if( nRet == EOWNERDEAD )
+    {
+        // The previous owner died while modifying the cache.
+        CPLDebug("GDAL", "Resetting shared block cache after the death of "
+                 "a process");
+        Reset();
+        m_psHeader->nRecoveries++;
+        pthread_mutex_consistent(&m_psHeader->sMutex);
+        return true;
+    }
+    return nRet == 0;
+}
+
+/************************************************************************/
+/*                                Find()                                */
+/************************************************************************/
+
+GInt32 GDALSharedBlockCache::Find( const GDALSharedBlockKey& sKey,
+                                   size_t nBucket ) const
+{
+    for( GInt32 iEntry = m_panBuckets[nBucket]; iEntry >= 0;
+         iEntry = m_pasEntries[iEntry].nNext )
+    {
+        if( memcmp(&m_pasEntries[iEntry].sKey, &sKey, sizeof(sKey)) == 0 )
+            return iEntry;
+    }
+    return -1;
+}
+
+/************************************************************************/
+/*                               Remove()                               */
+/************************************************************************/
+
+void GDALSharedBlockCache::Remove( GInt32 iEntry )
+{
+    GDALSharedBlockEntry& sEntry = m_pasEntries[iEntry];
+
+    // Unlink from its bucket.
+    GInt32* piLink = &m_panBuckets[sEntry.nBucket];
+    while( *piLink != iEntry )
+        piLink = &m_pasEntries[*piLink].nNext;
+    *piLink = sEntry.nNext;
+
+    // Give back its slots.
+    GInt32 iSlot = sEntry.nFirstSlot;
+    while( iSlot >= 0 )
+    {
+        const GInt32 iNextSlot = m_panNextSlot[iSlot];
+        m_panNextSlot[iSlot] = m_psHeader->nFreeSlotHead;
+        m_psHeader->nFreeSlotHead = iSlot;
+        m_psHeader->nFreeSlots++;
+        iSlot = iNextSlot;
+    }
+
+    sEntry.bUsed = FALSE;
+    sEntry.nNext = m_psHeader->nFreeEntryHead;
+    m_psHeader->nFreeEntryHead = iEntry;
+}
+
+/************************************************************************/
+/*                              EvictOne()                              */
+/************************************************************************/
+
+bool GDALSharedBlockCache::EvictOne()
+{
+    const GInt32 nSlots = m_psHeader->nSlots;
+    for( GInt32 i = 0; i < 2 * nSlots; i++ )
+    {
+        const GInt32 iEntry = m_psHeader->nClockHand;
+        m_psHeader->nClockHand = (iEntry + 1 < nSlots) ? iEntry + 1 : 0;
+        GDALSharedBlockEntry& sEntry = m_pasEntries[iEntry];
+        if( !sEntry.bUsed )
+            continue;
+        if( sEntry.bReferenced )
+        {
+            sEntry.bReferenced = FALSE;
+            continue;
+        }
+        Remove(iEntry);
+        m_psHeader->nEvictions++;
+        return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                           SharedCacheHash()                          */
+/************************************************************************/
+
+// 64-bit FNV-1a hash.
+GUInt64 SharedCacheHash( const void* pData, size_t nSize,
+                         GUInt64 nHash = 0xCBF29CE484222325ULL )
+{
+    const GByte* pabyData = static_cast<const GByte*>(pData);
+    for( size_t i = 0; i < nSize; i++ )
+    {
+        nHash ^= pabyData[i];
+        nHash *= 0x100000001B3ULL;
+    }
+    return nHash;
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+bool GDALSharedBlockCache::Read( const GDALSharedBlockKey& sKey,
+                                 void* pData, size_t nSize )
+{
+    const size_t nBucket = static_cast<size_t>(
+        SharedCacheHash(&sKey, sizeof(sKey)) %
+            static_cast<GUInt64>(m_psHeader->nSlots));
+    if( !Lock() )
+        return false;
+
+    const GInt32 iEntry = Find(sKey, nBucket);
+    const bool bFound =
+        iEntry >= 0 && m_pasEntries[iEntry].nDataSize == nSize;
+    if( bFound )
+    {
+        GDALSharedBlockEntry& sEntry = m_pasEntries[iEntry];
+        sEntry.bReferenced = TRUE;
+        const size_t nSlotSize = static_cast<size_t>(m_psHeader->nSlotSize);
+        GByte* pabyData = static_cast<GByte*>(pData);
+        size_t nOffset = 0;
+        for( GInt32 iSlot = sEntry.nFirstSlot; iSlot >= 0 && nOffset < nSize;
+             iSlot = m_panNextSlot[iSlot] )
+        {
+            const size_t nToCopy = std::min(nSlotSize, nSize - nOffset);
+            memcpy(pabyData + nOffset,
+                   m_pabySlots + static_cast<size_t>(iSlot) * nSlotSize,
+                   nToCopy);
+            nOffset += nToCopy;
+        }
+        m_psHeader->nHits++;
+    }
+    else
+    {
+        m_psHeader->nMisses++;
+    }
+
+    Unlock();
+    return bFound;
+}
+
+/************************************************************************/
+/*                                Write()                               */
+/************************************************************************/
+
+void GDALSharedBlockCache::Write( const GDALSharedBlockKey& sKey,
+                                  const void* pData, size_t nSize )
+{
+    const size_t nSlotSize = static_cast<size_t>(m_psHeader->nSlotSize);
+    const size_t nSlotsNeeded =
+        std::max(static_cast<size_t>(1), (nSize + nSlotSize - 1) / nSlotSize);
+    // Do not let a single block take most of the cache.
+    if( nSlotsNeeded > static_cast<size_t>(m_psHeader->nSlots) / 4 )
+        return;
+
+    const size_t nBucket = static_cast<size_t>(
+        SharedCacheHash(&sKey, sizeof(sKey)) %
+            static_cast<GUInt64>(m_psHeader->nSlots));
+    if( !Lock() )
+        return;
+
+    // Another process may have inserted it in the mean time.
+    if( Find(sKey, nBucket) >= 0 )
+    {
+        Unlock();
+        return;
+    }
+
+    while( static_cast<size_t>(m_psHeader->nFreeSlots) < nSlotsNeeded )
+    {
+        if( !EvictOne() )
+        {
+            Unlock();
+            return;
+        }
+    }
+
+    // There are at least as many entries as slots, so there is a free one.
+    const GInt32 iEntry = m_psHeader->nFreeEntryHead;
+    GDALSharedBlockEntry& sEntry = m_pasEntries[iEntry];
+    m_psHeader->nFreeEntryHead = sEntry.nNext;
+
+    const GByte* pabyData = static_cast<const GByte*>(pData);
+    GInt32* piLink = &sEntry.nFirstSlot;
+    size_t nOffset = 0;
+    for( size_t i = 0; i < nSlotsNeeded; i++ )
+    {
+        const GInt32 iSlot = m_psHeader->nFreeSlotHead;
+        m_psHeader->nFreeSlotHead = m_panNextSlot[iSlot];
+        m_psHeader->nFreeSlots--;
+        *piLink = iSlot;
+        piLink = &m_panNextSlot[iSlot];
+
+        const size_t nToCopy = std::min(nSlotSize, nSize - nOffset);
+        memcpy(m_pabySlots + static_cast<size_t>(iSlot) * nSlotSize,
+               pabyData + nOffset, nToCopy);
+        nOffset += nToCopy;
+    }
+    *piLink = -1;
+
+    sEntry.sKey = sKey;
+    sEntry.nDataSize = nSize;
+    sEntry.nBucket = static_cast<GInt32>(nBucket);
+    sEntry.bUsed = TRUE;
+    sEntry.bReferenced = FALSE;
+    sEntry.nNext = m_panBuckets[nBucket];
+    m_panBuckets[nBucket] = iEntry;
+
+    Unlock();
+}
+
+/************************************************************************/
+/*                      GetSharedBlockCache()                           */
+/************************************************************************/
+
+std::mutex goSharedBlockCacheMutex;
+bool gbSharedBlockCacheInitialized = false;
+GDALSharedBlockCache* gpoSharedBlockCache = nullptr;
+
+GDALSharedBlockCache* GetSharedBlockCache()
+{
+    std::lock_guard<std::mutex> oLock(goSharedBlockCacheMutex);
+    if( !gbSharedBlockCacheInitialized )
+    {
+        gbSharedBlockCacheInitialized = true;
+        const char* pszFilename =
+            CPLGetConfigOption("GDAL_SHARED_BLOCK_CACHE", nullptr);
+        if( pszFilename != nullptr && pszFilename[0] != '\0' )
+        {
+            // Same conventions as GDAL_CACHEMAX: values lower than 100000
+            // are in MB.
+            GIntBig nSize = CPLAtoGIntBig(
+                CPLGetConfigOption("GDAL_SHARED_BLOCK_CACHE_SIZE", "256"));
+            if( nSize < 100000 )
+                nSize *= 1024 * 1024;
+            const GIntBig nSlotSize = std::max(static_cast<GIntBig>(4096),
+                CPLAtoGIntBig(CPLGetConfigOption(
+                    "GDAL_SHARED_BLOCK_CACHE_SLOT_SIZE", "65536")));
+            gpoSharedBlockCache = new GDALSharedBlockCache();
+            if( !gpoSharedBlockCache->Open(pszFilename, nSize, nSlotSize) )
+            {
+                delete gpoSharedBlockCache;
+                gpoSharedBlockCache = nullptr;
+            }
+        }
+    }
+    return gpoSharedBlockCache;
+}
+
+} // namespace
+
+#endif // GDAL_HAS_SHARED_BLOCK_CACHE
+
+/************************************************************************/
+/*                         GetSharedCacheKey()                          */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+// Blocks are identified by the driver and open options of their dataset,
+// by the device, inode, size and modification time of its file, and by the
+// number, size, data type and block size of their band, which distinguishes
+// overviews.
+bool GDALRasterBlock::GetSharedCacheKey( GDALSharedBlockKey& sKey )
+{
+#ifdef GDAL_HAS_SHARED_BLOCK_CACHE
+    if( poBand->nSharedBlockCacheStatus == 0 )
+    {
+        poBand->nSharedBlockCacheStatus = -1;
+        // Drivers whose pixels are not all in the file of the dataset, but
+        // come from other datasets or from a service, and may thus change
+        // without the file being modified.
+        static const char* const apszExcludedDrivers[] = {
+            "VRT", "DERIVED", "WMS", "WMTS", "PLMOSAIC", "ESRIC", nullptr };
+        GDALDataset* poDS = poBand->poDS;
+        GDALDriver* poDriver = poDS ? poDS->GetDriver() : nullptr;
+        const char* pszFilename = poDS ? poDS->GetDescription() : "";
+        struct stat sStat;
+        if( poDriver != nullptr &&
+            CSLFindString(apszExcludedDrivers,
+                          poDriver->GetDescription()) < 0 &&
+            poDS->GetAccess() == GA_ReadOnly &&
+            poBand->nBand >= 1 &&
+            poDS->GetRasterBand(poBand->nBand) == poBand &&
+            pszFilename[0] != '\0' &&
+            !STARTS_WITH_CI(pszFilename, "/vsi") &&
+            stat(pszFilename, &sStat) == 0 && S_ISREG(sStat.st_mode) )
+        {
+            CPLString osIdentity;
+            osIdentity += poDriver->GetDescription();
+            osIdentity += CPLSPrintf(
+                "\n" CPL_FRMT_GUIB "\n" CPL_FRMT_GUIB "\n" CPL_FRMT_GUIB
+                "\n" CPL_FRMT_GIB "\n" CPL_FRMT_GIB,
+                static_cast<GUIntBig>(sStat.st_dev),
+                static_cast<GUIntBig>(sStat.st_ino),
+                static_cast<GUIntBig>(sStat.st_size),
+                static_cast<GIntBig>(sStat.st_mtim.tv_sec),
+                static_cast<GIntBig>(sStat.st_mtim.tv_nsec));
+            for( CSLConstList papszIter = poDS->GetOpenOptions();
+                 papszIter && *papszIter; ++papszIter )
+            {
+                osIdentity += '\n';
+                osIdentity += *papszIter;
+            }
+            poBand->anSharedBlockCacheDSKey[0] =
+                SharedCacheHash(osIdentity.data(), osIdentity.size());
+            // Second hash, with another seed, to make collisions unlikely.
+            poBand->anSharedBlockCacheDSKey[1] =
+                SharedCacheHash(osIdentity.data(), osIdentity.size(),
+                                0x84222325CBF29CE4ULL);
+            poBand->nSharedBlockCacheStatus = 1;
+        }
+    }
+    if( poBand->nSharedBlockCacheStatus < 0 )
+        return false;
+
+    memset(&sKey, 0, sizeof(sKey));
+    sKey.anDatasetKey[0] = poBand->anSharedBlockCacheDSKey[0];
+    sKey.anDatasetKey[1] = poBand->anSharedBlockCacheDSKey[1];
+    sKey.nBand = poBand->nBand;
+    sKey.nRasterXSize = poBand->nRasterXSize;
+    sKey.nRasterYSize = poBand->nRasterYSize;
+    sKey.nDataType = static_cast<GInt32>(eType);
+    sKey.nBlockXSize = nXSize;
+    sKey.nBlockYSize = nYSize;
+    sKey.nXBlockOff = nXOff;
+    sKey.nYBlockOff = nYOff;
+    return true;
+#else
+    CPL_IGNORE_RET_VAL(sKey);
+    return false;
+#endif
+}
+
+/************************************************************************/
+/*                        ReadFromSharedCache()                         */
+/************************************************************************/
+
+/**
+ * Fill the block with its content from the shared memory block cache.
+ *
+ * @return true if the block was found in the shared cache.
+ */
+bool GDALRasterBlock::ReadFromSharedCache()
+{
+#ifdef GDAL_HAS_SHARED_BLOCK_CACHE
+    GDALSharedBlockCache* poCache = GetSharedBlockCache();
+    GDALSharedBlockKey sKey;
+    if( poCache == nullptr || pData == nullptr || !GetSharedCacheKey(sKey) )
+        return false;
+    if( !poCache->Read(sKey, pData, static_cast<size_t>(GetBlockSize())) )
+        return false;
+    if( poBand->nSharedBlockCacheStatus == 1 )
+    {
+        // Only reported for the first block of the band.
+        poBand->nSharedBlockCacheStatus = 2;
+        CPLDebug("GDAL", "%s: band %d: block found in shared block cache",
+                 poBand->poDS->GetDescription(), poBand->nBand);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/************************************************************************/
+/*                         WriteToSharedCache()                         */
+/************************************************************************/
+
+/**
+ * Store the content of the block, just read from its band, in the shared
+ * memory block cache.
+ */
+void GDALRasterBlock::WriteToSharedCache()
+{
+#ifdef GDAL_HAS_SHARED_BLOCK_CACHE
+    GDALSharedBlockCache* poCache = GetSharedBlockCache();
+    GDALSharedBlockKey sKey;
+    if( poCache == nullptr || pData == nullptr || !GetSharedCacheKey(sKey) )
+        return;
+    poCache->Write(sKey, pData, static_cast<size_t>(GetBlockSize()));
+#endif
+}
+/*! @endcond */
+
 #if 0
 void GDALRasterBlock::DumpAll()
 {
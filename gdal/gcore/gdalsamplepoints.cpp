@@ -0,0 +1,736 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Sampling of raster values at a batch of points
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+#include "gdal_thread_pool.h"
+#include "cpl_error_internal.h"
+#include "cpl_string.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+namespace {
+
+/************************************************************************/
+/*                       GDALSamplePointsContext                        */
+/************************************************************************/
+
+struct GDALSamplePointsContext
+{
+    const double*       padfX = nullptr;
+    const double*       padfY = nullptr;
+    bool                bGeoreferenced = false;
+    double              adfInvGT[6] = {0, 1, 0, 0, 0, 1};
+    int                 nXSize = 0;
+    int                 nYSize = 0;
+    int                 nBandCount = 0;
+    GDALRIOResampleAlg  eResampleAlg = GRIORA_NearestNeighbour;
+    double*             padfValues = nullptr;
+    int*                pabValid = nullptr;
+
+    // Valid points, as (block key, point index) pairs sorted by block
+    std::vector<std::pair<GUInt64, size_t>> aoOrder{};
+
+    // Used by worker threads to reopen the dataset
+    std::string         osFilename{};
+    CPLStringList       aosOpenOptions{};
+    std::vector<int>    anBandList{};
+
+    void ToPixel(size_t iPoint, double& dfPixel, double& dfLine) const
+    {
+        const double dfX = padfX[iPoint];
+        const double dfY = padfY[iPoint];
+        if( bGeoreferenced )
+        {
+            dfPixel = adfInvGT[0] + adfInvGT[1] * dfX + adfInvGT[2] * dfY;
+            dfLine = adfInvGT[3] + adfInvGT[4] * dfX + adfInvGT[5] * dfY;
+        }
+        else
+        {
+            dfPixel = dfX;
+            dfLine = dfY;
+        }
+    }
+};
+
+/************************************************************************/
+/*                      GDALSamplePointsBlockReader                     */
+/************************************************************************/
+
+// Keeps the last few blocks of a band locked, so that the pixels of
+// neighbouring points, and the taps of the interpolation kernels that cross
+// block boundaries, do not go through the block cache lookup.
+class GDALSamplePointsBlockReader
+{
+    static constexpr int MAX_BLOCKS = 4;
+
+    struct Entry
+    {
+        int              nBlockX = -1;
+        int              nBlockY = -1;
+        GDALRasterBlock *poBlock = nullptr;
+    };
+
+    GDALRasterBand *m_poBand;
+    GDALDataType    m_eDT;
+    int             m_nDTSize;
+    int             m_nBlockXSize = 0;
+    int             m_nBlockYSize = 0;
+    Entry           m_asEntries[MAX_BLOCKS]{};
+    int             m_iNextEntry = 0;
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALSamplePointsBlockReader)
+
+  public:
+    explicit GDALSamplePointsBlockReader(GDALRasterBand* poBand) :
+        m_poBand(poBand),
+        m_eDT(poBand->GetRasterDataType()),
+        m_nDTSize(GDALGetDataTypeSizeBytes(m_eDT))
+    {
+        poBand->GetBlockSize(&m_nBlockXSize, &m_nBlockYSize);
+    }
+
+    ~GDALSamplePointsBlockReader()
+    {
+        for( auto& sEntry: m_asEntries )
+        {
+            if( sEntry.poBlock )
+                sEntry.poBlock->DropLock();
+        }
+    }
+
+    bool GetPixel(int iX, int iY, double& dfValue)
+    {
+        const int nBlockX = iX / m_nBlockXSize;
+        const int nBlockY = iY / m_nBlockYSize;
+        GDALRasterBlock* poBlock = nullptr;
+        for( const auto& sEntry: m_asEntries )
+        {
+            if( sEntry.poBlock && sEntry.nBlockX == nBlockX &&
+                sEntry.nBlockY == nBlockY )
+            {
+                poBlock = sEntry.poBlock;
+                break;
+            }
+        }
+        if( poBlock == nullptr )
+        {
+            poBlock = m_poBand->GetLockedBlockRef(nBlockX, nBlockY);
+            if( poBlock == nullptr )
+                return false;
+            auto& sEntry = m_asEntries[m_iNextEntry];
+            m_iNextEntry = (m_iNextEntry + 1) % MAX_BLOCKS;
+            if( sEntry.poBlock )
+                sEntry.poBlock->DropLock();
+            sEntry.nBlockX = nBlockX;
+            sEntry.nBlockY = nBlockY;
+            sEntry.poBlock = poBlock;
+        }
+        const size_t nOffset =
+            static_cast<size_t>(iY - nBlockY * m_nBlockYSize) * m_nBlockXSize +
+            (iX - nBlockX * m_nBlockXSize);
+        GDALCopyWords(static_cast<const GByte*>(poBlock->GetDataRef()) +
+                            nOffset * m_nDTSize,
+                      m_eDT, 0, &dfValue, GDT_Float64, 0, 1);
+        return true;
+    }
+};
+
+/************************************************************************/
+/*                          GDALSamplePointsBand                        */
+/************************************************************************/
+
+struct GDALSamplePointsBand
+{
+    std::unique_ptr<GDALSamplePointsBlockReader> poReader{};
+    bool    bHasNoData = false;
+    double  dfNoData = 0.0;
+
+    bool IsValid(double dfValue) const
+    {
+        return !std::isnan(dfValue) && !(bHasNoData && dfValue == dfNoData);
+    }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                       GDALSamplePointsCubicWeights()                 */
+/************************************************************************/
+
+// Keys cubic convolution kernel, with a = -0.5
+static void GDALSamplePointsCubicWeights(double dfT, double adfW[4])
+{
+    adfW[0] = ((-0.5 * dfT + 1.0) * dfT - 0.5) * dfT;
+    adfW[1] = (1.5 * dfT - 2.5) * dfT * dfT + 1.0;
+    adfW[2] = ((-1.5 * dfT + 2.0) * dfT + 0.5) * dfT;
+    adfW[3] = (0.5 * dfT - 0.5) * dfT * dfT;
+}
+
+/************************************************************************/
+/*                        GDALSamplePointsPixel()                       */
+/************************************************************************/
+
+// Returns 1 if a value was computed, 0 if all contributing pixels are
+// invalid, and -1 in case of read error.
+static int GDALSamplePointsPixel(GDALSamplePointsBand& sBand,
+                                 const GDALSamplePointsContext& sCtxt,
+                                 double dfPixel, double dfLine,
+                                 double& dfValue)
+{
+    auto& oReader = *(sBand.poReader);
+    if( sCtxt.eResampleAlg == GRIORA_NearestNeighbour )
+    {
+        if( !oReader.GetPixel(static_cast<int>(dfPixel),
+                              static_cast<int>(dfLine), dfValue) )
+            return -1;
+        return sBand.IsValid(dfValue) ? 1 : 0;
+    }
+
+    // Interpolation is done between pixel centers
+    const double dfSrcX = dfPixel - 0.5;
+    const double dfSrcY = dfLine - 0.5;
+    const int nX0 = static_cast<int>(std::floor(dfSrcX));
+    const int nY0 = static_cast<int>(std::floor(dfSrcY));
+    const double dfTX = dfSrcX - nX0;
+    const double dfTY = dfSrcY - nY0;
+    const auto ClampX = [&sCtxt](int iX)
+        { return std::max(0, std::min(sCtxt.nXSize - 1, iX)); };
+    const auto ClampY = [&sCtxt](int iY)
+        { return std::max(0, std::min(sCtxt.nYSize - 1, iY)); };
+
+    if( sCtxt.eResampleAlg == GRIORA_Cubic )
+    {
+        double adfWX[4];
+        double adfWY[4];
+        GDALSamplePointsCubicWeights(dfTX, adfWX);
+        GDALSamplePointsCubicWeights(dfTY, adfWY);
+        double dfSum = 0.0;
+        bool bAllValid = true;
+        for( int j = 0; j < 4 && bAllValid; ++j )
+        {
+            const int iY = ClampY(nY0 - 1 + j);
+            for( int i = 0; i < 4; ++i )
+            {
+                double dfTap = 0.0;
+                if( !oReader.GetPixel(ClampX(nX0 - 1 + i), iY, dfTap) )
+                    return -1;
+                if( !sBand.IsValid(dfTap) )
+                {
+                    bAllValid = false;
+                    break;
+                }
+                dfSum += adfWX[i] * adfWY[j] * dfTap;
+            }
+        }
+        if( bAllValid )
+        {
+            dfValue = dfSum;
+            return 1;
+        }
+        // Fallback to bilinear, which can skip invalid pixels
+    }
+
+    const double adfWX[2] = { 1.0 - dfTX, dfTX };
+    const double adfWY[2] = { 1.0 - dfTY, dfTY };
+    double dfSum = 0.0;
+    double dfWeightSum = 0.0;
+    for( int j = 0; j < 2; ++j )
+    {
+        const int iY = ClampY(nY0 + j);
+        for( int i = 0; i < 2; ++i )
+        {
+            const double dfWeight = adfWX[i] * adfWY[j];
+            if( dfWeight == 0.0 )
+                continue;
+            double dfTap = 0.0;
+            if( !oReader.GetPixel(ClampX(nX0 + i), iY, dfTap) )
+                return -1;
+            if( sBand.IsValid(dfTap) )
+            {
+                dfSum += dfWeight * dfTap;
+                dfWeightSum += dfWeight;
+            }
+        }
+    }
+    if( dfWeightSum == 0.0 )
+        return 0;
+    dfValue = dfSum / dfWeightSum;
+    return 1;
+}
+
+/************************************************************************/
+/*                        GDALSamplePointsRange()                       */
+/************************************************************************/
+
+// Samples the points of sCtxt.aoOrder[iStart:iEnd[ in the passed bands.
+static bool GDALSamplePointsRange(const GDALSamplePointsContext& sCtxt,
+                                  GDALRasterBand* const* papoBands,
+                                  size_t iStart, size_t iEnd)
+{
+    std::vector<GDALSamplePointsBand> asBands(sCtxt.nBandCount);
+    for( int iBand = 0; iBand < sCtxt.nBandCount; ++iBand )
+    {
+        asBands[iBand].poReader.reset(
+            new GDALSamplePointsBlockReader(papoBands[iBand]));
+        int bHasNoData = FALSE;
+        asBands[iBand].dfNoData = papoBands[iBand]->GetNoDataValue(&bHasNoData);
+        asBands[iBand].bHasNoData = CPL_TO_BOOL(bHasNoData);
+    }
+
+    for( size_t i = iStart; i < iEnd; ++i )
+    {
+        const size_t iPoint = sCtxt.aoOrder[i].second;
+        double dfPixel = 0.0;
+        double dfLine = 0.0;
+        sCtxt.ToPixel(iPoint, dfPixel, dfLine);
+        for( int iBand = 0; iBand < sCtxt.nBandCount; ++iBand )
+        {
+            const size_t iOut = iPoint * sCtxt.nBandCount + iBand;
+            double dfValue = 0.0;
+            const int nRet = GDALSamplePointsPixel(asBands[iBand], sCtxt,
+                                                   dfPixel, dfLine, dfValue);
+            if( nRet < 0 )
+                return false;
+            if( nRet > 0 )
+            {
+                sCtxt.padfValues[iOut] = dfValue;
+                if( sCtxt.pabValid )
+                    sCtxt.pabValid[iOut] = TRUE;
+            }
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          GDALSamplePointsJob                         */
+/************************************************************************/
+
+namespace {
+struct GDALSamplePointsJob
+{
+    const GDALSamplePointsContext* psCtxt = nullptr;
+    size_t  iStart = 0;
+    size_t  iEnd = 0;
+    bool    bSuccess = false;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+};
+} // namespace
+
+static void GDALSamplePointsJobFunc(void* pData)
+{
+    auto psJob = static_cast<GDALSamplePointsJob*>(pData);
+    const auto& sCtxt = *(psJob->psCtxt);
+
+    CPLInstallErrorHandlerAccumulator(psJob->aoErrors);
+    CPLSetCurrentErrorHandlerCatchDebug(FALSE);
+
+    // Each job uses its own dataset, so that block reads of different jobs
+    // do not serialize on the dataset mutex.
+    auto poDS = GDALDataset::Open(sCtxt.osFilename.c_str(),
+                                  GDAL_OF_RASTER | GDAL_OF_INTERNAL,
+                                  nullptr, sCtxt.aosOpenOptions.List(),
+                                  nullptr);
+    if( poDS && poDS->GetRasterXSize() == sCtxt.nXSize &&
+        poDS->GetRasterYSize() == sCtxt.nYSize )
+    {
+        std::vector<GDALRasterBand*> apoBands;
+        for( int nBand: sCtxt.anBandList )
+        {
+            auto poBand = poDS->GetRasterBand(nBand);
+            if( poBand == nullptr )
+                break;
+            apoBands.push_back(poBand);
+        }
+        if( static_cast<int>(apoBands.size()) == sCtxt.nBandCount )
+        {
+            psJob->bSuccess = GDALSamplePointsRange(sCtxt, apoBands.data(),
+                                                    psJob->iStart,
+                                                    psJob->iEnd);
+        }
+    }
+    delete poDS;
+
+    CPLUninstallErrorHandlerAccumulator();
+}
+
+/************************************************************************/
+/*                           GDALSamplePoints()                         */
+/************************************************************************/
+
+static CPLErr GDALSamplePoints(GDALDataset* poDS,
+                               const std::vector<GDALRasterBand*>& apoBands,
+                               size_t nPoints,
+                               const double* padfX, const double* padfY,
+                               GDALRIOResampleAlg eResampleAlg,
+                               double* padfValues, int* pabValid,
+                               CSLConstList papszOptions)
+{
+    if( eResampleAlg != GRIORA_NearestNeighbour &&
+        eResampleAlg != GRIORA_Bilinear &&
+        eResampleAlg != GRIORA_Cubic )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Only nearest, bilinear and cubic resampling are supported "
+                 "for point sampling");
+        return CE_Failure;
+    }
+    if( apoBands.empty() )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "No band to sample");
+        return CE_Failure;
+    }
+    if( nPoints > 0 && (padfX == nullptr || padfY == nullptr ||
+                        padfValues == nullptr) )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Null coordinate or value array");
+        return CE_Failure;
+    }
+
+    GDALSamplePointsContext sCtxt;
+    sCtxt.padfX = padfX;
+    sCtxt.padfY = padfY;
+    sCtxt.nXSize = apoBands[0]->GetXSize();
+    sCtxt.nYSize = apoBands[0]->GetYSize();
+    sCtxt.nBandCount = static_cast<int>(apoBands.size());
+    sCtxt.eResampleAlg = eResampleAlg;
+    sCtxt.padfValues = padfValues;
+    sCtxt.pabValid = pabValid;
+
+    const char* pszCoordinates =
+        CSLFetchNameValueDef(papszOptions, "COORDINATES", "PIXEL");
+    if( EQUAL(pszCoordinates, "GEOREFERENCED") )
+    {
+        double adfGT[6] = {};
+        if( poDS == nullptr || poDS->GetGeoTransform(adfGT) != CE_None ||
+            !GDALInvGeoTransform(adfGT, sCtxt.adfInvGT) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot use georeferenced coordinates: no invertible "
+                     "geotransform");
+            return CE_Failure;
+        }
+        sCtxt.bGeoreferenced = true;
+    }
+    else if( !EQUAL(pszCoordinates, "PIXEL") )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for COORDINATES: %s", pszCoordinates);
+        return CE_Failure;
+    }
+
+    // Points out of the raster, or whose all contributing pixels are
+    // nodata, are set to the nodata value of the band, or 0.
+    for( int iBand = 0; iBand < sCtxt.nBandCount; ++iBand )
+    {
+        int bHasNoData = FALSE;
+        const double dfNoData = apoBands[iBand]->GetNoDataValue(&bHasNoData);
+        const double dfDefault = bHasNoData ? dfNoData : 0.0;
+        for( size_t i = 0; i < nPoints; ++i )
+        {
+            padfValues[i * sCtxt.nBandCount + iBand] = dfDefault;
+            if( pabValid )
+                pabValid[i * sCtxt.nBandCount + iBand] = FALSE;
+        }
+    }
+
+    // Group the points by block, so that each block is read once
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    apoBands[0]->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const GUInt64 nBlocksPerRow =
+        DIV_ROUND_UP(static_cast<GUInt64>(sCtxt.nXSize), nBlockXSize);
+    sCtxt.aoOrder.reserve(nPoints);
+    for( size_t i = 0; i < nPoints; ++i )
+    {
+        double dfPixel = 0.0;
+        double dfLine = 0.0;
+        sCtxt.ToPixel(i, dfPixel, dfLine);
+        // Also rejects NaN
+        if( !(dfPixel >= 0 && dfPixel < sCtxt.nXSize &&
+              dfLine >= 0 && dfLine < sCtxt.nYSize) )
+            continue;
+        const GUInt64 nKey =
+            static_cast<GUInt64>(static_cast<int>(dfLine) / nBlockYSize) *
+                nBlocksPerRow +
+            static_cast<int>(dfPixel) / nBlockXSize;
+        sCtxt.aoOrder.emplace_back(nKey, i);
+    }
+    std::sort(sCtxt.aoOrder.begin(), sCtxt.aoOrder.end());
+    const size_t nValid = sCtxt.aoOrder.size();
+
+    // Multi-threading is only possible on a dataset that can be reopened
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                      atoi(pszNumThreads);
+    constexpr size_t MIN_POINTS_PER_JOB = 1024;
+    nThreads = static_cast<int>(std::min(
+        static_cast<size_t>(std::max(1, std::min(128, nThreads))),
+        DIV_ROUND_UP(nValid, MIN_POINTS_PER_JOB)));
+    if( nThreads > 1 && poDS != nullptr && poDS->GetAccess() == GA_ReadOnly &&
+        poDS->GetDescription()[0] != '\0' )
+    {
+        for( auto poBand: apoBands )
+        {
+            if( poBand->GetDataset() != poDS || poBand->GetBand() <= 0 )
+            {
+                nThreads = 1;
+                break;
+            }
+            sCtxt.anBandList.push_back(poBand->GetBand());
+        }
+    }
+    else
+    {
+        nThreads = 1;
+    }
+
+    CPLWorkerThreadPool* poPool =
+        nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+    if( poPool == nullptr )
+    {
+        return GDALSamplePointsRange(sCtxt, apoBands.data(), 0, nValid) ?
+                                                        CE_None : CE_Failure;
+    }
+
+    sCtxt.osFilename = poDS->GetDescription();
+    sCtxt.aosOpenOptions.Assign(CSLDuplicate(poDS->GetOpenOptions()), TRUE);
+
+    // Split the points in a few jobs per thread, at block boundaries.
+    const size_t nJobs = static_cast<size_t>(nThreads) * 4;
+    std::vector<GDALSamplePointsJob> asJobs;
+    size_t iStart = 0;
+    while( iStart < nValid )
+    {
+        size_t iEnd = std::min(nValid,
+                               iStart + std::max(MIN_POINTS_PER_JOB,
+                                                 DIV_ROUND_UP(nValid, nJobs)));
+        while( iEnd < nValid &&
+               sCtxt.aoOrder[iEnd].first == sCtxt.aoOrder[iEnd - 1].first )
+            ++iEnd;
+        GDALSamplePointsJob sJob;
+        sJob.psCtxt = &sCtxt;
+        sJob.iStart = iStart;
+        sJob.iEnd = iEnd;
+        asJobs.emplace_back(std::move(sJob));
+        iStart = iEnd;
+    }
+
+    CPLDebug("GDAL", "Sampling %u points with %u jobs on %d threads",
+             static_cast<unsigned>(nValid),
+             static_cast<unsigned>(asJobs.size()), nThreads);
+    auto poQueue = poPool->CreateJobQueue();
+    for( auto& sJob: asJobs )
+        poQueue->SubmitJob(GDALSamplePointsJobFunc, &sJob);
+    poQueue->WaitCompletion();
+
+    // Jobs that could not reopen the dataset, or hit a read error, are run
+    // again with the bands of the caller, so that errors are reported as
+    // in the single-threaded case.
+    for( const auto& sJob: asJobs )
+    {
+        if( sJob.bSuccess )
+        {
+            for( const auto& oError: sJob.aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+            continue;
+        }
+        CPLDebug("GDAL", "Sampling job failed. Retrying it");
+        if( !GDALSamplePointsRange(sCtxt, apoBands.data(),
+                                   sJob.iStart, sJob.iEnd) )
+        {
+            return CE_Failure;
+        }
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                     GDALRasterBand::SamplePoints()                   */
+/************************************************************************/
+
+/**
+ * \brief Sample the values of the band at a batch of points.
+ *
+ * Points are grouped by block before being sampled, so that each block is
+ * read once, whatever the order of the points.
+ *
+ * Points out of the raster, or at which all the pixels contributing to the
+ * value are nodata (or NaN), are set to the nodata value of the band, or 0
+ * if it has none, and are flagged as invalid in pabValid. With cubic
+ * resampling, points where some of the 4x4 contributing pixels are nodata
+ * are sampled with bilinear resampling.
+ *
+ * Interpolation is done between pixel centers: a point at (0.5, 0.5) gets
+ * the value of the top-left pixel, whatever the resampling.
+ *
+ * The following options are supported:
+ * <ul>
+ * <li>COORDINATES=PIXEL/GEOREFERENCED: whether padfX/padfY are pixel/line
+ * coordinates (default), or georeferenced coordinates in the SRS of the
+ * dataset, converted with its geotransform.</li>
+ * <li>NUM_THREADS=number or ALL_CPUS: number of threads used. Defaults to the
+ * value of the GDAL_NUM_THREADS configuration option, or 1. Each thread
+ * reopens the dataset, so this is only available for datasets opened in
+ * read-only mode from a file or connection string.</li>
+ * </ul>
+ *
+ * This method is the same as the C function GDALRasterSamplePoints().
+ *
+ * @param nPoints Number of points.
+ * @param padfX Array of nPoints X coordinates.
+ * @param padfY Array of nPoints Y coordinates.
+ * @param eResampleAlg GRIORA_NearestNeighbour, GRIORA_Bilinear or
+ * GRIORA_Cubic.
+ * @param padfValues Array of nPoints values, filled by the method.
+ * @param pabValid Array of nPoints flags, filled by the method, or nullptr.
+ * @param papszOptions NULL terminated list of options, or nullptr.
+ * @return CE_None in case of success.
+ * @since GDAL 3.4
+ */
+CPLErr GDALRasterBand::SamplePoints(size_t nPoints,
+                                    const double* padfX, const double* padfY,
+                                    GDALRIOResampleAlg eResampleAlg,
+                                    double* padfValues, int* pabValid,
+                                    CSLConstList papszOptions)
+{
+    return GDALSamplePoints(poDS, std::vector<GDALRasterBand*>{this},
+                            nPoints, padfX, padfY, eResampleAlg,
+                            padfValues, pabValid, papszOptions);
+}
+
+/************************************************************************/
+/*                        GDALRasterSamplePoints()                      */
+/************************************************************************/
+
+/**
+ * \brief Sample the values of the band at a batch of points.
+ *
+ * @see GDALRasterBand::SamplePoints()
+ * @since GDAL 3.4
+ */
+CPLErr GDALRasterSamplePoints(GDALRasterBandH hBand, size_t nPoints,
+                              const double* padfX, const double* padfY,
+                              GDALRIOResampleAlg eResampleAlg,
+                              double* padfValues, int* pabValid,
+                              CSLConstList papszOptions)
+{
+    VALIDATE_POINTER1(hBand, "GDALRasterSamplePoints", CE_Failure);
+    return GDALRasterBand::FromHandle(hBand)->SamplePoints(
+        nPoints, padfX, padfY, eResampleAlg, padfValues, pabValid,
+        papszOptions);
+}
+
+/************************************************************************/
+/*                      GDALDataset::SamplePoints()                     */
+/************************************************************************/
+
+/**
+ * \brief Sample the values of several bands at a batch of points.
+ *
+ * The values and validity flags of band panBandList[iBand] at point iPoint
+ * are stored at index iPoint * nBandCount + iBand of padfValues and pabValid.
+ *
+ * See GDALRasterBand::SamplePoints() for the description of the sampling
+ * and the supported options.
+ *
+ * This method is the same as the C function GDALDatasetSamplePoints().
+ *
+ * @param nPoints Number of points.
+ * @param padfX Array of nPoints X coordinates.
+ * @param padfY Array of nPoints Y coordinates.
+ * @param nBandCount Number of bands, or 0 for all bands.
+ * @param panBandList Array of nBandCount band numbers (1-based), or nullptr
+ * for the first nBandCount bands.
+ * @param eResampleAlg GRIORA_NearestNeighbour, GRIORA_Bilinear or
+ * GRIORA_Cubic.
+ * @param padfValues Array of nPoints * nBandCount values, filled by the
+ * method.
+ * @param pabValid Array of nPoints * nBandCount flags, filled by the method,
+ * or nullptr.
+ * @param papszOptions NULL terminated list of options, or nullptr.
+ * @return CE_None in case of success.
+ * @since GDAL 3.4
+ */
+CPLErr GDALDataset::SamplePoints(size_t nPoints,
+                                 const double* padfX, const double* padfY,
+                                 int nBandCount, const int* panBandList,
+                                 GDALRIOResampleAlg eResampleAlg,
+                                 double* padfValues, int* pabValid,
+                                 CSLConstList papszOptions)
+{
+    if( nBandCount == 0 )
+        nBandCount = GetRasterCount();
+    std::vector<GDALRasterBand*> apoBands;
+    for( int i = 0; i < nBandCount; ++i )
+    {
+        const int nBand = panBandList ? panBandList[i] : i + 1;
+        auto poBand = GetRasterBand(nBand);
+        if( poBand == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg, "Invalid band number: %d",
+                     nBand);
+            return CE_Failure;
+        }
+        apoBands.push_back(poBand);
+    }
+    return GDALSamplePoints(this, apoBands, nPoints, padfX, padfY,
+                            eResampleAlg, padfValues, pabValid, papszOptions);
+}
+
+/************************************************************************/
+/*                       GDALDatasetSamplePoints()                      */
+/************************************************************************/
+
+/**
+ * \brief Sample the values of several bands at a batch of points.
+ *
+ * @see GDALDataset::SamplePoints()
+ * @since GDAL 3.4
+ */
+CPLErr GDALDatasetSamplePoints(GDALDatasetH hDS, size_t nPoints,
+                               const double* padfX, const double* padfY,
+                               int nBandCount, const int* panBandList,
+                               GDALRIOResampleAlg eResampleAlg,
+                               double* padfValues, int* pabValid,
+                               CSLConstList papszOptions)
+{
+    VALIDATE_POINTER1(hDS, "GDALDatasetSamplePoints", CE_Failure);
+    return GDALDataset::FromHandle(hDS)->SamplePoints(
+        nPoints, padfX, padfY, nBandCount, panBandList, eResampleAlg,
+        padfValues, pabValid, papszOptions);
+}
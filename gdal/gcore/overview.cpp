@@ -46,6 +46,7 @@
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_thread_pool.h"
@@ -4149,6 +4150,11 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     {
         OvrJob* poJob = static_cast<OvrJob*>(pData);
 
+        CPLTraceSpan oTraceSpan("overview", "OverviewResample");
+        if( oTraceSpan.IsActive() )
+            oTraceSpan.SetDetailf("dst lines %d-%d",
+                                  poJob->nDstYOff, poJob->nDstYOff2);
+
         if( poJob->eWrkDataType != GDT_CFloat32 )
         {
             poJob->eErr = poJob->pfnResampleFn(
@@ -4203,6 +4209,10 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     // Function to write resample data to target band
     const auto WriteJobData = [](const OvrJob* poJob)
     {
+        CPLTraceSpan oTraceSpan("overview", "OverviewWrite");
+        if( oTraceSpan.IsActive() )
+            oTraceSpan.SetDetailf("dst lines %d-%d",
+                                  poJob->nDstYOff, poJob->nDstYOff2);
         return poJob->poDstBand->RasterIO( GF_Write,
                                             0,
                                             poJob->nDstYOff,
@@ -4330,16 +4340,22 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
         }
 
         // Read chunk.
-        if( eErr == CE_None )
-            eErr = poSrcBand->RasterIO(
-                GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
-                pChunk, nWidth, nChunkYSizeQueried, eWrkDataType,
-                0, 0, nullptr );
-        if( eErr == CE_None && bUseNoDataMask )
-            eErr = poMaskBand->RasterIO(
-                GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
-                pabyChunkNodataMask, nWidth, nChunkYSizeQueried, GDT_Byte,
-                0, 0, nullptr );
+        {
+            CPLTraceSpan oTraceSpan("overview", "OverviewSrcRead");
+            if( oTraceSpan.IsActive() )
+                oTraceSpan.SetDetailf("src lines %d-%d", nChunkYOffQueried,
+                                      nChunkYOffQueried + nChunkYSizeQueried);
+            if( eErr == CE_None )
+                eErr = poSrcBand->RasterIO(
+                    GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                    pChunk, nWidth, nChunkYSizeQueried, eWrkDataType,
+                    0, 0, nullptr );
+            if( eErr == CE_None && bUseNoDataMask )
+                eErr = poMaskBand->RasterIO(
+                    GF_Read, 0, nChunkYOffQueried, nWidth, nChunkYSizeQueried,
+                    pabyChunkNodataMask, nWidth, nChunkYSizeQueried, GDT_Byte,
+                    0, 0, nullptr );
+        }
 
         // Special case to promote 1bit data to 8bit 0/255 values.
         if( EQUAL(pszResampling, "AVERAGE_BIT2GRAYSCALE") )
@@ -4859,6 +4875,12 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
         {
             OvrJob* poJob = static_cast<OvrJob*>(pData);
 
+            CPLTraceSpan oTraceSpan("overview", "OverviewResample");
+            if( oTraceSpan.IsActive() )
+                oTraceSpan.SetDetailf("dst %d,%d-%d,%d",
+                                      poJob->nDstXOff, poJob->nDstYOff,
+                                      poJob->nDstXOff2, poJob->nDstYOff2);
+
             poJob->eErr = poJob->pfnResampleFn(
                 poJob->dfXRatioDstToSrc,
                 poJob->dfYRatioDstToSrc,
@@ -4896,6 +4918,11 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
         // Function to write resample data to target band
         const auto WriteJobData = [](const OvrJob* poJob)
         {
+            CPLTraceSpan oTraceSpan("overview", "OverviewWrite");
+            if( oTraceSpan.IsActive() )
+                oTraceSpan.SetDetailf("dst %d,%d-%d,%d",
+                                      poJob->nDstXOff, poJob->nDstYOff,
+                                      poJob->nDstXOff2, poJob->nDstYOff2);
             return poJob->poOverview->RasterIO(
                                 GF_Write,
                                 poJob->nDstXOff,
@@ -5076,6 +5103,8 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                 }
 
                 // Read the source buffers for all the bands.
+                const GIntBig nTraceReadStart =
+                    CPLTraceIsEnabled() ? CPLTraceGetTimestamp() : -1;
                 for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
                 {
                     GDALRasterBand* poSrcBand = nullptr;
@@ -5109,6 +5138,15 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                         GDT_Byte, 0, 0, nullptr );
                 }
 
+                if( nTraceReadStart >= 0 )
+                {
+                    CPLTraceRecordSpan("overview", "OverviewSrcRead",
+                        CPLSPrintf("src %d,%d %dx%d",
+                                   nChunkXOffQueried, nChunkYOffQueried,
+                                   nChunkXSizeQueried, nChunkYSizeQueried),
+                        nTraceReadStart, CPLTraceGetTimestamp());
+                }
+
                 std::shared_ptr<PointerHolder> oSrcMaskBufferHolder(
                     new PointerHolder(poJobQueue ? pabyChunkNoDataMask : nullptr));
 
@@ -1091,6 +1091,8 @@ OCTTransform4DWithErrorCodes( OGRCoordinateTransformationH hCT,
                   int nCount, double *x, double *y, double *z, double *t,
                   int *panErrorCodes );
 
+void CPL_DLL OCTGetCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses );
+
 
 CPL_C_END
 
@@ -100,6 +100,9 @@ class OGRProjCT;
 typedef std::string CTCacheKey;
 typedef std::shared_ptr<std::unique_ptr<OGRProjCT>> CTCacheValue;
 static lru11::Cache<CTCacheKey, CTCacheValue>* g_poCTCache = nullptr;
+// Statistics, protected by g_oCTCacheMutex
+static GIntBig g_nCTCacheHits = 0;
+static GIntBig g_nCTCacheMisses = 0;
 
 /************************************************************************/
 /*             OGRCoordinateTransformationOptions::Private              */
@@ -2528,17 +2531,22 @@ OGRProjCT* OGRProjCT::FindFromCache( const OGRSpatialReference *poSource,
 {
     std::lock_guard<std::mutex> oGuard(g_oCTCacheMutex);
     if( g_poCTCache == nullptr || g_poCTCache->empty() )
+    {
+        g_nCTCacheMisses ++;
         return nullptr;
+    }
 
     const auto key = MakeCacheKey(poSource, poTarget, options);
     // Get value from cache and remove it
     CTCacheValue holder;
     if( g_poCTCache->tryGet(key, holder) )
     {
+        g_nCTCacheHits ++;
         auto poCT = holder->release();
         g_poCTCache->remove(key);
         return poCT;
     }
+    g_nCTCacheMisses ++;
     return nullptr;
 }
 
@@ -2663,3 +2671,25 @@ void OGRCTDumpStatistics()
              static_cast<int>(g_dfTotalTimeReprojection * 1000));
 #endif
 }
+
+/************************************************************************/
+/*                       OCTGetCacheStatistics()                        */
+/************************************************************************/
+
+/** Return statistics on the cache of coordinate transformations.
+ *
+ * Coordinate transformations that are destroyed are kept in a cache, so that
+ * creating again a transformation between the same CRS is fast.
+ *
+ * @param pnHits Pointer to the number of transformations created from the
+ * cache.
+ * @param pnMisses Pointer to the number of transformations created from
+ * scratch.
+ * @since GDAL 3.4
+ */
+void OCTGetCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses )
+{
+    std::lock_guard<std::mutex> oGuard(g_oCTCacheMutex);
+    *pnHits = g_nCTCacheHits;
+    *pnMisses = g_nCTCacheMisses;
+}
@@ -0,0 +1,1051 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Registry of compression/decompression functions
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "cpl_compressor.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBDEFLATE
+#include "libdeflate.h"
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+CPL_CVSID("$Id$")
+
+static std::mutex gMutex;
+static std::list<CPLCompressor>* gpCompressors = nullptr;
+static std::list<CPLCompressor>* gpDecompressors = nullptr;
+
+/************************************************************************/
+/*                        CPLProcessOutput()                            */
+/************************************************************************/
+
+// Implement the output_data/output_size conventions of CPLCompressionFunc
+// for a function whose output size is at most nMaxOutputSize.
+// pfnProcess(pOut, nOutAvailable, &nOutWritten) does the actual work.
+template<class Func>
+static bool CPLProcessOutput(size_t nMaxOutputSize,
+                             void** output_data, size_t* output_size,
+                             Func pfnProcess)
+{
+    if( output_size == nullptr )
+        return false;
+    if( output_data == nullptr )
+    {
+        *output_size = nMaxOutputSize;
+        return true;
+    }
+    if( *output_data != nullptr )
+    {
+        size_t nWritten = 0;
+        if( !pfnProcess(*output_data, *output_size, nWritten) )
+            return false;
+        *output_size = nWritten;
+        return true;
+    }
+    void* pOut = VSI_MALLOC_VERBOSE(std::max<size_t>(1, nMaxOutputSize));
+    if( pOut == nullptr )
+        return false;
+    size_t nWritten = 0;
+    if( !pfnProcess(pOut, nMaxOutputSize, nWritten) )
+    {
+        VSIFree(pOut);
+        return false;
+    }
+    *output_data = pOut;
+    *output_size = nWritten;
+    return true;
+}
+
+/************************************************************************/
+/*                          zlib and gzip                               */
+/************************************************************************/
+
+#ifdef HAVE_LIBZ
+
+static bool CPLZlibCompressorInternal(const void* input_data,
+                                      size_t input_size,
+                                      void** output_data,
+                                      size_t* output_size,
+                                      CSLConstList options,
+                                      bool bGZip)
+{
+    const int nLevel = atoi(CSLFetchNameValueDef(options, "LEVEL", "6"));
+    if( nLevel < 1 || nLevel > 9 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Invalid LEVEL=%d", nLevel);
+        return false;
+    }
+    // Upper bound for both zlib and libdeflate, with the gzip header.
+    const size_t nMaxOutputSize = input_size + input_size / 1000 + 64;
+    return CPLProcessOutput(nMaxOutputSize, output_data, output_size,
+        [input_data, input_size, nLevel, bGZip](void* pOut,
+                                                size_t nOutAvailable,
+                                                size_t& nOutWritten)
+    {
+#ifdef HAVE_LIBDEFLATE
+        struct libdeflate_compressor* enc =
+                                    libdeflate_alloc_compressor(nLevel);
+        if( enc == nullptr )
+            return false;
+        nOutWritten = bGZip ?
+            libdeflate_gzip_compress(enc, input_data, input_size,
+                                     pOut, nOutAvailable) :
+            libdeflate_zlib_compress(enc, input_data, input_size,
+                                     pOut, nOutAvailable);
+        libdeflate_free_compressor(enc);
+        return nOutWritten != 0;
+#else
+        if( input_size > UINT_MAX || nOutAvailable > UINT_MAX )
+            return false;
+        z_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        if( deflateInit2(&strm, nLevel, Z_DEFLATED,
+                         bGZip ? MAX_WBITS + 16 : MAX_WBITS,
+                         8, Z_DEFAULT_STRATEGY) != Z_OK )
+            return false;
+        strm.avail_in = static_cast<uInt>(input_size);
+        strm.next_in = static_cast<Bytef*>(const_cast<void*>(input_data));
+        strm.avail_out = static_cast<uInt>(nOutAvailable);
+        strm.next_out = static_cast<Bytef*>(pOut);
+        const int ret = deflate(&strm, Z_FINISH);
+        nOutWritten = nOutAvailable - strm.avail_out;
+        deflateEnd(&strm);
+        return ret == Z_STREAM_END;
+#endif
+    });
+}
+
+static bool CPLZlibCompressor(const void* input_data, size_t input_size,
+                              void** output_data, size_t* output_size,
+                              CSLConstList options,
+                              void* /* compressor_user_data */)
+{
+    return CPLZlibCompressorInternal(input_data, input_size, output_data,
+                                     output_size, options, false);
+}
+
+static bool CPLGZipCompressor(const void* input_data, size_t input_size,
+                              void** output_data, size_t* output_size,
+                              CSLConstList options,
+                              void* /* compressor_user_data */)
+{
+    return CPLZlibCompressorInternal(input_data, input_size, output_data,
+                                     output_size, options, true);
+}
+
+// Both zlib and gzip streams are recognized by CPLZLibInflate()
+static bool CPLZlibDecompressor(const void* input_data, size_t input_size,
+                                void** output_data, size_t* output_size,
+                                CSLConstList /* options */,
+                                void* /* compressor_user_data */)
+{
+    if( output_data == nullptr || output_size == nullptr )
+        return false;
+    size_t nOutBytes = 0;
+    void* pOut = CPLZLibInflate(input_data, input_size,
+                                *output_data, *output_size, &nOutBytes);
+    if( pOut == nullptr )
+        return false;
+    *output_data = pOut;
+    *output_size = nOutBytes;
+    return true;
+}
+
+#endif // HAVE_LIBZ
+
+/************************************************************************/
+/*                               lzma                                   */
+/************************************************************************/
+
+#ifdef HAVE_LZMA
+
+static bool CPLLZMACompressor(const void* input_data, size_t input_size,
+                              void** output_data, size_t* output_size,
+                              CSLConstList options,
+                              void* /* compressor_user_data */)
+{
+    const int nPreset = atoi(CSLFetchNameValueDef(options, "PRESET", "6"));
+    if( nPreset < 0 || nPreset > 9 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Invalid PRESET=%d", nPreset);
+        return false;
+    }
+    return CPLProcessOutput(lzma_stream_buffer_bound(input_size),
+                            output_data, output_size,
+        [input_data, input_size, nPreset](void* pOut, size_t nOutAvailable,
+                                          size_t& nOutWritten)
+    {
+        nOutWritten = 0;
+        return lzma_easy_buffer_encode(
+            static_cast<uint32_t>(nPreset), LZMA_CHECK_CRC64, nullptr,
+            static_cast<const uint8_t*>(input_data), input_size,
+            static_cast<uint8_t*>(pOut), &nOutWritten,
+            nOutAvailable) == LZMA_OK;
+    });
+}
+
+static bool CPLLZMADecompressor(const void* input_data, size_t input_size,
+                                void** output_data, size_t* output_size,
+                                CSLConstList /* options */,
+                                void* /* compressor_user_data */)
+{
+    if( output_data == nullptr || output_size == nullptr )
+        return false;
+    const auto Decode = [input_data, input_size](void* pOut,
+                                                 size_t nOutAvailable,
+                                                 size_t& nOutWritten)
+    {
+        size_t nInPos = 0;
+        uint64_t nMemLimit = std::numeric_limits<uint64_t>::max();
+        nOutWritten = 0;
+        return lzma_stream_buffer_decode(
+            &nMemLimit, 0, nullptr,
+            static_cast<const uint8_t*>(input_data), &nInPos, input_size,
+            static_cast<uint8_t*>(pOut), &nOutWritten,
+            nOutAvailable);
+    };
+    if( *output_data != nullptr )
+    {
+        size_t nOutWritten = 0;
+        if( Decode(*output_data, *output_size, nOutWritten) != LZMA_OK )
+            return false;
+        *output_size = nOutWritten;
+        return true;
+    }
+
+    // Output size unknown: grow the buffer until decoding succeeds.
+    size_t nOutAvailable = std::max<size_t>(4096, 2 * input_size);
+    while( true )
+    {
+        void* pOut = VSI_MALLOC_VERBOSE(nOutAvailable);
+        if( pOut == nullptr )
+            return false;
+        size_t nOutWritten = 0;
+        const auto ret = Decode(pOut, nOutAvailable, nOutWritten);
+        if( ret == LZMA_OK )
+        {
+            *output_data = pOut;
+            *output_size = nOutWritten;
+            return true;
+        }
+        VSIFree(pOut);
+        if( ret != LZMA_BUF_ERROR ||
+            nOutAvailable > std::numeric_limits<size_t>::max() / 2 )
+            return false;
+        nOutAvailable *= 2;
+    }
+}
+
+#endif // HAVE_LZMA
+
+/************************************************************************/
+/*                               zstd                                   */
+/************************************************************************/
+
+#ifdef HAVE_ZSTD
+
+static bool CPLZSTDCompressor(const void* input_data, size_t input_size,
+                              void** output_data, size_t* output_size,
+                              CSLConstList options,
+                              void* /* compressor_user_data */)
+{
+    const int nLevel = atoi(CSLFetchNameValueDef(options, "LEVEL", "13"));
+    if( nLevel < 1 || nLevel > ZSTD_maxCLevel() )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Invalid LEVEL=%d", nLevel);
+        return false;
+    }
+    return CPLProcessOutput(ZSTD_compressBound(input_size),
+                            output_data, output_size,
+        [input_data, input_size, nLevel](void* pOut, size_t nOutAvailable,
+                                         size_t& nOutWritten)
+    {
+        nOutWritten = ZSTD_compress(pOut, nOutAvailable,
+                                    input_data, input_size, nLevel);
+        return !ZSTD_isError(nOutWritten);
+    });
+}
+
+static bool CPLZSTDDecompressor(const void* input_data, size_t input_size,
+                                void** output_data, size_t* output_size,
+                                CSLConstList /* options */,
+                                void* /* compressor_user_data */)
+{
+    if( output_data == nullptr || output_size == nullptr )
+        return false;
+    size_t nMaxOutputSize = *output_size;
+    if( *output_data == nullptr )
+    {
+        const auto nContentSize =
+                        ZSTD_getFrameContentSize(input_data, input_size);
+        if( nContentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+            nContentSize == ZSTD_CONTENTSIZE_ERROR ||
+            nContentSize > std::numeric_limits<size_t>::max() )
+            return false;
+        nMaxOutputSize = static_cast<size_t>(nContentSize);
+    }
+    return CPLProcessOutput(nMaxOutputSize, output_data, output_size,
+        [input_data, input_size](void* pOut, size_t nOutAvailable,
+                                 size_t& nOutWritten)
+    {
+        nOutWritten = ZSTD_decompress(pOut, nOutAvailable,
+                                      input_data, input_size);
+        return !ZSTD_isError(nOutWritten);
+    });
+}
+
+#endif // HAVE_ZSTD
+
+/************************************************************************/
+/*                               lz4                                    */
+/************************************************************************/
+
+#ifdef HAVE_LZ4
+
+// With HEADER=YES (default), the compressed stream is prefixed with the
+// uncompressed size as a 32-bit little-endian integer, as done by the LZ4
+// codec of numcodecs.
+constexpr size_t LZ4_HEADER_SIZE = sizeof(GInt32);
+
+static bool CPLLZ4Compressor(const void* input_data, size_t input_size,
+                             void** output_data, size_t* output_size,
+                             CSLConstList options,
+                             void* /* compressor_user_data */)
+{
+    if( input_size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Too large input buffer for LZ4");
+        return false;
+    }
+    const int nAcceleration =
+        std::max(1, atoi(CSLFetchNameValueDef(options, "ACCELERATION", "1")));
+    const bool bHeader =
+        CPLTestBool(CSLFetchNameValueDef(options, "HEADER", "YES"));
+    const size_t nHeaderSize = bHeader ? LZ4_HEADER_SIZE : 0;
+    const int nInputSize = static_cast<int>(input_size);
+    return CPLProcessOutput(
+        nHeaderSize + static_cast<size_t>(LZ4_compressBound(nInputSize)),
+        output_data, output_size,
+        [input_data, nInputSize, nAcceleration, nHeaderSize](
+                    void* pOut, size_t nOutAvailable, size_t& nOutWritten)
+    {
+        if( nOutAvailable < nHeaderSize )
+            return false;
+        GByte* pabyOut = static_cast<GByte*>(pOut);
+        if( nHeaderSize )
+        {
+            GInt32 nSize = nInputSize;
+            CPL_LSBPTR32(&nSize);
+            memcpy(pabyOut, &nSize, sizeof(nSize));
+        }
+        const int nRet = LZ4_compress_fast(
+            static_cast<const char*>(input_data),
+            reinterpret_cast<char*>(pabyOut + nHeaderSize),
+            nInputSize,
+            static_cast<int>(std::min<size_t>(INT_MAX,
+                                              nOutAvailable - nHeaderSize)),
+            nAcceleration);
+        nOutWritten = nHeaderSize + static_cast<size_t>(nRet);
+        return nRet > 0 || nInputSize == 0;
+    });
+}
+
+static bool CPLLZ4Decompressor(const void* input_data, size_t input_size,
+                               void** output_data, size_t* output_size,
+                               CSLConstList options,
+                               void* /* compressor_user_data */)
+{
+    if( output_data == nullptr || output_size == nullptr )
+        return false;
+    const bool bHeader =
+        CPLTestBool(CSLFetchNameValueDef(options, "HEADER", "YES"));
+    const size_t nHeaderSize = bHeader ? LZ4_HEADER_SIZE : 0;
+    if( input_size < nHeaderSize ||
+        input_size - nHeaderSize > static_cast<size_t>(INT_MAX) )
+        return false;
+    size_t nMaxOutputSize = *output_size;
+    if( bHeader )
+    {
+        GInt32 nSize = 0;
+        memcpy(&nSize, input_data, sizeof(nSize));
+        CPL_LSBPTR32(&nSize);
+        if( nSize < 0 )
+            return false;
+        if( *output_data == nullptr )
+            nMaxOutputSize = static_cast<size_t>(nSize);
+    }
+    else if( *output_data == nullptr )
+    {
+        return false;
+    }
+    return CPLProcessOutput(nMaxOutputSize, output_data, output_size,
+        [input_data, input_size, nHeaderSize](void* pOut,
+                                              size_t nOutAvailable,
+                                              size_t& nOutWritten)
+    {
+        const int nRet = LZ4_decompress_safe(
+            static_cast<const char*>(input_data) + nHeaderSize,
+            static_cast<char*>(pOut),
+            static_cast<int>(input_size - nHeaderSize),
+            static_cast<int>(std::min<size_t>(INT_MAX, nOutAvailable)));
+        if( nRet < 0 )
+            return false;
+        nOutWritten = static_cast<size_t>(nRet);
+        return true;
+    });
+}
+
+#endif // HAVE_LZ4
+
+/************************************************************************/
+/*                         shuffle filters                              */
+/************************************************************************/
+
+// Byte shuffling as done by the Shuffle codec of numcodecs, and by the
+// HDF5/Blosc shuffle filters: byte j of element i goes to position
+// j * nElts + i. Trailing bytes that do not form a whole element are left
+// untouched. Specialized for the common element sizes, so that the compiler
+// unrolls the inner loop.
+template<int N> static void CPLShuffleT(const GByte* pabySrc, GByte* pabyDst,
+                                        size_t nElts)
+{
+    for( size_t i = 0; i < nElts; ++i )
+    {
+        for( int j = 0; j < N; ++j )
+            pabyDst[j * nElts + i] = pabySrc[i * N + j];
+    }
+}
+
+template<int N> static void CPLUnshuffleT(const GByte* pabySrc,
+                                          GByte* pabyDst, size_t nElts)
+{
+    for( size_t i = 0; i < nElts; ++i )
+    {
+        for( int j = 0; j < N; ++j )
+            pabyDst[i * N + j] = pabySrc[j * nElts + i];
+    }
+}
+
+static void CPLShuffle(const GByte* pabySrc, GByte* pabyDst, size_t nSize,
+                       size_t nEltSize, bool bUnshuffle)
+{
+    const size_t nElts = nSize / nEltSize;
+    switch( nEltSize )
+    {
+        case 1:
+            memcpy(pabyDst, pabySrc, nSize);
+            return;
+        case 2:
+            bUnshuffle ? CPLUnshuffleT<2>(pabySrc, pabyDst, nElts) :
+                         CPLShuffleT<2>(pabySrc, pabyDst, nElts);
+            break;
+        case 4:
+            bUnshuffle ? CPLUnshuffleT<4>(pabySrc, pabyDst, nElts) :
+                         CPLShuffleT<4>(pabySrc, pabyDst, nElts);
+            break;
+        case 8:
+            bUnshuffle ? CPLUnshuffleT<8>(pabySrc, pabyDst, nElts) :
+                         CPLShuffleT<8>(pabySrc, pabyDst, nElts);
+            break;
+        default:
+            for( size_t i = 0; i < nElts; ++i )
+            {
+                for( size_t j = 0; j < nEltSize; ++j )
+                {
+                    if( bUnshuffle )
+                        pabyDst[i * nEltSize + j] = pabySrc[j * nElts + i];
+                    else
+                        pabyDst[j * nElts + i] = pabySrc[i * nEltSize + j];
+                }
+            }
+            break;
+    }
+    memcpy(pabyDst + nElts * nEltSize, pabySrc + nElts * nEltSize,
+           nSize - nElts * nEltSize);
+}
+
+// Transpose a 8x8 bit matrix: bit m of pabyOut[b] is bit b of pabyIn[m].
+static void CPLTranspose8x8Bits(const GByte* pabyIn, size_t nInStride,
+                                GByte* pabyOut, size_t nOutStride)
+{
+    GUInt64 x = 0;
+    for( int m = 0; m < 8; ++m )
+        x |= static_cast<GUInt64>(pabyIn[m * nInStride]) << (8 * m);
+    // From "Hacker's Delight", transpose8rS64
+    GUInt64 t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    for( int b = 0; b < 8; ++b )
+        pabyOut[b * nOutStride] = static_cast<GByte>(x >> (8 * b));
+}
+
+// Bit shuffling: elements are processed by groups of 8, and bit b of byte j
+// of element i goes to bit (i % 8) of byte i / 8 of the bit plane j * 8 + b,
+// each bit plane being nElts / 8 bytes large. Trailing elements that do not
+// form a whole group of 8, and trailing bytes, are left untouched.
+static bool CPLBitShuffle(const GByte* pabySrc, GByte* pabyDst, size_t nSize,
+                          size_t nEltSize, bool bUnshuffle)
+{
+    const size_t nGroups = nSize / nEltSize / 8;
+    const size_t nShuffledSize = nGroups * 8 * nEltSize;
+    std::vector<GByte> abyTmp;
+    try
+    {
+        abyTmp.resize(nShuffledSize);
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Out of memory in bitshuffle");
+        return false;
+    }
+    // Byte shuffling is done first (or last), so that the bits to transpose
+    // are in 8 consecutive bytes.
+    const size_t nElts = nGroups * 8;
+    if( !bUnshuffle )
+    {
+        CPLShuffle(pabySrc, abyTmp.data(), nShuffledSize, nEltSize, false);
+        for( size_t j = 0; j < nEltSize; ++j )
+        {
+            for( size_t k = 0; k < nGroups; ++k )
+            {
+                CPLTranspose8x8Bits(abyTmp.data() + j * nElts + k * 8, 1,
+                                    pabyDst + j * nElts + k, nGroups);
+            }
+        }
+    }
+    else
+    {
+        for( size_t j = 0; j < nEltSize; ++j )
+        {
+            for( size_t k = 0; k < nGroups; ++k )
+            {
+                CPLTranspose8x8Bits(pabySrc + j * nElts + k, nGroups,
+                                    abyTmp.data() + j * nElts + k * 8, 1);
+            }
+        }
+        CPLShuffle(abyTmp.data(), pabyDst, nShuffledSize, nEltSize, true);
+    }
+    memcpy(pabyDst + nShuffledSize, pabySrc + nShuffledSize,
+           nSize - nShuffledSize);
+    return true;
+}
+
+static bool CPLShuffleFilterInternal(const void* input_data,
+                                     size_t input_size,
+                                     void** output_data,
+                                     size_t* output_size,
+                                     CSLConstList options,
+                                     bool bBitShuffle,
+                                     bool bUnshuffle)
+{
+    const int nEltSize = atoi(CSLFetchNameValueDef(options, "ELEMENTSIZE",
+                                                   "4"));
+    if( nEltSize <= 0 || nEltSize > 1024 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid ELEMENTSIZE=%d", nEltSize);
+        return false;
+    }
+    return CPLProcessOutput(input_size, output_data, output_size,
+        [input_data, input_size, nEltSize, bUnshuffle, bBitShuffle](
+                    void* pOut, size_t nOutAvailable, size_t& nOutWritten)
+    {
+        if( nOutAvailable < input_size )
+            return false;
+        nOutWritten = input_size;
+        if( bBitShuffle )
+        {
+            return CPLBitShuffle(static_cast<const GByte*>(input_data),
+                                 static_cast<GByte*>(pOut), input_size,
+                                 static_cast<size_t>(nEltSize), bUnshuffle);
+        }
+        CPLShuffle(static_cast<const GByte*>(input_data),
+                   static_cast<GByte*>(pOut), input_size,
+                   static_cast<size_t>(nEltSize), bUnshuffle);
+        return true;
+    });
+}
+
+static bool CPLShuffleCompressor(const void* input_data, size_t input_size,
+                                 void** output_data, size_t* output_size,
+                                 CSLConstList options,
+                                 void* /* compressor_user_data */)
+{
+    return CPLShuffleFilterInternal(input_data, input_size, output_data,
+                                    output_size, options, false, false);
+}
+
+static bool CPLShuffleDecompressor(const void* input_data, size_t input_size,
+                                   void** output_data, size_t* output_size,
+                                   CSLConstList options,
+                                   void* /* compressor_user_data */)
+{
+    return CPLShuffleFilterInternal(input_data, input_size, output_data,
+                                    output_size, options, false, true);
+}
+
+static bool CPLBitShuffleCompressor(const void* input_data, size_t input_size,
+                                    void** output_data, size_t* output_size,
+                                    CSLConstList options,
+                                    void* /* compressor_user_data */)
+{
+    return CPLShuffleFilterInternal(input_data, input_size, output_data,
+                                    output_size, options, true, false);
+}
+
+static bool CPLBitShuffleDecompressor(const void* input_data,
+                                      size_t input_size,
+                                      void** output_data,
+                                      size_t* output_size,
+                                      CSLConstList options,
+                                      void* /* compressor_user_data */)
+{
+    return CPLShuffleFilterInternal(input_data, input_size, output_data,
+                                    output_size, options, true, true);
+}
+
+/************************************************************************/
+/*                       CPLAddBuiltinCompressors()                     */
+/************************************************************************/
+
+static void CPLAddCompressor(std::list<CPLCompressor>* pList,
+                             const CPLCompressor* psComp)
+{
+    CPLCompressor sComp(*psComp);
+    sComp.pszId = CPLStrdup(psComp->pszId);
+    sComp.papszMetadata = CSLDuplicate(
+                    const_cast<char**>(psComp->papszMetadata));
+    pList->push_back(sComp);
+}
+
+static void CPLAddBuiltinCompressors()
+{
+    const auto Add = [](const char* pszId, CPLCompressorType eType,
+                        const char* pszOptions,
+                        CPLCompressionFunc pfnCompress,
+                        CPLCompressionFunc pfnDecompress)
+    {
+        const char* const apszMetadata[] = { pszOptions, nullptr };
+        CPLCompressor sComp;
+        sComp.nStructVersion = 1;
+        sComp.pszId = pszId;
+        sComp.eType = eType;
+        sComp.papszMetadata = apszMetadata;
+        sComp.pfnFunc = pfnCompress;
+        sComp.user_data = nullptr;
+        CPLAddCompressor(gpCompressors, &sComp);
+        sComp.pfnFunc = pfnDecompress;
+        CPLAddCompressor(gpDecompressors, &sComp);
+    };
+
+#ifdef HAVE_LIBZ
+    const char* pszZlibOptions =
+        "OPTIONS=<Options>"
+        "  <Option name='LEVEL' type='int' description='Compression level' "
+            "min='1' max='9' default='6'/>"
+        "</Options>";
+    Add("zlib", CCT_COMPRESSOR, pszZlibOptions,
+        CPLZlibCompressor, CPLZlibDecompressor);
+    Add("gzip", CCT_COMPRESSOR, pszZlibOptions,
+        CPLGZipCompressor, CPLZlibDecompressor);
+#endif
+#ifdef HAVE_LZMA
+    Add("lzma", CCT_COMPRESSOR,
+        "OPTIONS=<Options>"
+        "  <Option name='PRESET' type='int' description='Compression level' "
+            "min='0' max='9' default='6'/>"
+        "</Options>",
+        CPLLZMACompressor, CPLLZMADecompressor);
+#endif
+#ifdef HAVE_ZSTD
+    Add("zstd", CCT_COMPRESSOR,
+        CPLSPrintf("OPTIONS=<Options>"
+        "  <Option name='LEVEL' type='int' description='Compression level' "
+            "min='1' max='%d' default='13'/>"
+        "</Options>", ZSTD_maxCLevel()),
+        CPLZSTDCompressor, CPLZSTDDecompressor);
+#endif
+#ifdef HAVE_LZ4
+    Add("lz4", CCT_COMPRESSOR,
+        "OPTIONS=<Options>"
+        "  <Option name='ACCELERATION' type='int' "
+            "description='Acceleration factor. The higher, the faster "
+            "and the less compressed' min='1' default='1'/>"
+        "  <Option name='HEADER' type='boolean' "
+            "description='Whether the compressed stream is prefixed with "
+            "the uncompressed size' default='YES'/>"
+        "</Options>",
+        CPLLZ4Compressor, CPLLZ4Decompressor);
+#endif
+    const char* pszShuffleOptions =
+        "OPTIONS=<Options>"
+        "  <Option name='ELEMENTSIZE' type='int' "
+            "description='Size in bytes of the elements' default='4'/>"
+        "</Options>";
+    Add("shuffle", CCT_FILTER, pszShuffleOptions,
+        CPLShuffleCompressor, CPLShuffleDecompressor);
+    Add("bitshuffle", CCT_FILTER, pszShuffleOptions,
+        CPLBitShuffleCompressor, CPLBitShuffleDecompressor);
+}
+
+/************************************************************************/
+/*                     CPLGetCompressorList()                           */
+/************************************************************************/
+
+// Must be called with gMutex held.
+static std::list<CPLCompressor>* CPLGetCompressorList(bool bDecompressors)
+{
+    if( gpCompressors == nullptr )
+    {
+        gpCompressors = new std::list<CPLCompressor>();
+        gpDecompressors = new std::list<CPLCompressor>();
+        CPLAddBuiltinCompressors();
+    }
+    return bDecompressors ? gpDecompressors : gpCompressors;
+}
+
+/************************************************************************/
+/*                      CPLRegisterCompressorInternal()                 */
+/************************************************************************/
+
+static bool CPLRegisterCompressorInternal(const CPLCompressor* psComp,
+                                          bool bDecompressor)
+{
+    if( psComp->nStructVersion < 1 )
+        return false;
+    if( psComp->pszId == nullptr || psComp->pfnFunc == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid compressor definition");
+        return false;
+    }
+    std::lock_guard<std::mutex> oLock(gMutex);
+    auto poList = CPLGetCompressorList(bDecompressor);
+    for( const auto& sComp: *poList )
+    {
+        if( strcmp(sComp.pszId, psComp->pszId) == 0 )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "%s %s already registered",
+                     bDecompressor ? "Decompressor" : "Compressor",
+                     psComp->pszId);
+            return false;
+        }
+    }
+    CPLAddCompressor(poList, psComp);
+    return true;
+}
+
+/************************************************************************/
+/*                       CPLRegisterCompressor()                        */
+/************************************************************************/
+
+/** Register a new compressor.
+ *
+ * The provided structure is copied. Its pfnFunc and user_data members should
+ * remain valid beyond this call however.
+ *
+ * @param compressor Compressor structure. Should not be null.
+ * @return true if successful, or false if a compressor with the same id is
+ *         already registered.
+ * @since GDAL 3.4
+ */
+
+bool CPLRegisterCompressor(const CPLCompressor* compressor)
+{
+    return CPLRegisterCompressorInternal(compressor, false);
+}
+
+/************************************************************************/
+/*                      CPLRegisterDecompressor()                       */
+/************************************************************************/
+
+/** Register a new decompressor.
+ *
+ * The provided structure is copied. Its pfnFunc and user_data members should
+ * remain valid beyond this call however.
+ *
+ * @param decompressor Decompressor structure. Should not be null.
+ * @return true if successful, or false if a decompressor with the same id is
+ *         already registered.
+ * @since GDAL 3.4
+ */
+
+bool CPLRegisterDecompressor(const CPLCompressor* decompressor)
+{
+    return CPLRegisterCompressorInternal(decompressor, true);
+}
+
+/************************************************************************/
+/*                      CPLGetCompressorsInternal()                     */
+/************************************************************************/
+
+static char** CPLGetCompressorsInternal(bool bDecompressors)
+{
+    std::lock_guard<std::mutex> oLock(gMutex);
+    CPLStringList aosIds;
+    for( const auto& sComp: *CPLGetCompressorList(bDecompressors) )
+        aosIds.AddString(sComp.pszId);
+    return aosIds.StealList();
+}
+
+/************************************************************************/
+/*                         CPLGetCompressors()                          */
+/************************************************************************/
+
+/** Return the list of registered compressors.
+ *
+ * @return list of strings. Should be freed with CSLDestroy()
+ * @since GDAL 3.4
+ */
+
+char** CPLGetCompressors(void)
+{
+    return CPLGetCompressorsInternal(false);
+}
+
+/************************************************************************/
+/*                        CPLGetDecompressors()                         */
+/************************************************************************/
+
+/** Return the list of registered decompressors.
+ *
+ * @return list of strings. Should be freed with CSLDestroy()
+ * @since GDAL 3.4
+ */
+
+char** CPLGetDecompressors(void)
+{
+    return CPLGetCompressorsInternal(true);
+}
+
+/************************************************************************/
+/*                      CPLGetCompressorInternal()                      */
+/************************************************************************/
+
+static const CPLCompressor* CPLGetCompressorInternal(const char* pszId,
+                                                    bool bDecompressor)
+{
+    std::lock_guard<std::mutex> oLock(gMutex);
+    // Entries are never removed before CPLDestroyCompressorRegistry(), and
+    // std::list guarantees that their address does not change.
+    for( auto& sComp: *CPLGetCompressorList(bDecompressor) )
+    {
+        if( EQUAL(sComp.pszId, pszId) )
+            return &sComp;
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/*                         CPLGetCompressor()                           */
+/************************************************************************/
+
+/** Return a compressor.
+ *
+ * The returned pointer remains valid until CPLDestroyCompressorRegistry()
+ * is called (at GDALDestroyDriverManager() time).
+ *
+ * @param pszId Compressor id. Should NOT be NULL.
+ * @return compressor structure, or NULL.
+ * @since GDAL 3.4
+ */
+
+const CPLCompressor* CPLGetCompressor(const char* pszId)
+{
+    return CPLGetCompressorInternal(pszId, false);
+}
+
+/************************************************************************/
+/*                        CPLGetDecompressor()                          */
+/************************************************************************/
+
+/** Return a decompressor.
+ *
+ * The returned pointer remains valid until CPLDestroyCompressorRegistry()
+ * is called (at GDALDestroyDriverManager() time).
+ *
+ * @param pszId Decompressor id. Should NOT be NULL.
+ * @return decompressor structure, or NULL.
+ * @since GDAL 3.4
+ */
+
+const CPLCompressor* CPLGetDecompressor(const char* pszId)
+{
+    return CPLGetCompressorInternal(pszId, true);
+}
+
+/************************************************************************/
+/*                     CPLCompressorRunMultiple()                       */
+/************************************************************************/
+
+namespace {
+struct CPLCompressorJob
+{
+    const CPLCompressor* psComp = nullptr;
+    const void*          pInputData = nullptr;
+    size_t               nInputSize = 0;
+    void**               ppOutputData = nullptr;
+    size_t*              pnOutputSize = nullptr;
+    CSLConstList         papszOptions = nullptr;
+    bool                 bOK = false;
+};
+} // namespace
+
+static void CPLCompressorJobFunc(void* pData)
+{
+    CPLCompressorJob* psJob = static_cast<CPLCompressorJob*>(pData);
+    psJob->bOK = psJob->psComp->pfnFunc(psJob->pInputData,
+                                        psJob->nInputSize,
+                                        psJob->ppOutputData,
+                                        psJob->pnOutputSize,
+                                        psJob->papszOptions,
+                                        psJob->psComp->user_data);
+}
+
+/** Run a compressor, decompressor or filter on several independent buffers,
+ * possibly in parallel.
+ *
+ * This is a convenience function for callers that process data by blocks,
+ * such as tiles or chunks. For each buffer i, compressor->pfnFunc is called
+ * with papInputData[i], panInputSize[i], &papOutputData[i] and
+ * &panOutputSize[i], following the conventions of CPLCompressionFunc for the
+ * output buffers.
+ *
+ * @param compressor Compressor, decompressor or filter.
+ * @param nBuffers Number of buffers.
+ * @param papInputData Array of nBuffers input buffers.
+ * @param panInputSize Array of nBuffers input sizes.
+ * @param papOutputData Array of nBuffers output buffers (or NULL pointers to
+ *                      let the function allocate them).
+ * @param panOutputSize Array of nBuffers output sizes.
+ * @param options Options passed to the function.
+ * @param nThreads Maximum number of threads to use, or 0 to use as many
+ *                 threads as CPUs.
+ * @return true if the processing of all buffers succeeded.
+ * @since GDAL 3.4
+ */
+
+bool CPLCompressorRunMultiple(const CPLCompressor* compressor,
+                              size_t nBuffers,
+                              const void* const* papInputData,
+                              const size_t* panInputSize,
+                              void** papOutputData,
+                              size_t* panOutputSize,
+                              CSLConstList options,
+                              int nThreads)
+{
+    if( nThreads <= 0 )
+        nThreads = CPLGetNumCPUs();
+    nThreads = static_cast<int>(std::min<size_t>(
+                                        std::min(nThreads, 128), nBuffers));
+
+    std::vector<CPLCompressorJob> asJobs(nBuffers);
+    for( size_t i = 0; i < nBuffers; ++i )
+    {
+        asJobs[i].psComp = compressor;
+        asJobs[i].pInputData = papInputData[i];
+        asJobs[i].nInputSize = panInputSize[i];
+        asJobs[i].ppOutputData = &papOutputData[i];
+        asJobs[i].pnOutputSize = &panOutputSize[i];
+        asJobs[i].papszOptions = options;
+    }
+
+    CPLWorkerThreadPool oPool;
+    if( nThreads > 1 && oPool.Setup(nThreads, nullptr, nullptr) )
+    {
+        std::vector<void*> apData;
+        for( auto& sJob: asJobs )
+            apData.push_back(&sJob);
+        oPool.SubmitJobs(CPLCompressorJobFunc, apData);
+        oPool.WaitCompletion();
+    }
+    else
+    {
+        for( auto& sJob: asJobs )
+            CPLCompressorJobFunc(&sJob);
+    }
+
+    bool bRet = true;
+    for( const auto& sJob: asJobs )
+        bRet &= sJob.bOK;
+    return bRet;
+}
+
+/************************************************************************/
+/*                   CPLDestroyCompressorRegistry()                     */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+void CPLDestroyCompressorRegistry(void)
+{
+    std::lock_guard<std::mutex> oLock(gMutex);
+    for( auto* poList: { gpCompressors, gpDecompressors } )
+    {
+        if( poList == nullptr )
+            continue;
+        for( auto& sComp: *poList )
+        {
+            CPLFree(const_cast<char*>(sComp.pszId));
+            CSLDestroy(const_cast<char**>(sComp.papszMetadata));
+        }
+        delete poList;
+    }
+    gpCompressors = nullptr;
+    gpDecompressors = nullptr;
+}
+/*! @endcond */
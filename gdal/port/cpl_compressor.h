@@ -0,0 +1,127 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Registry of compression/decompression functions
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_COMPRESSOR_H_INCLUDED
+#define CPL_COMPRESSOR_H_INCLUDED
+
+#include "cpl_port.h"
+
+#include <stdbool.h>
+
+/**
+ * \file cpl_compressor.h
+ *
+ * Registry of compression/decompression functions.
+ *
+ * Compressors (and their decompressor counterparts) are looked up by an
+ * identifier. Built-in ones are "zlib", "gzip", and, depending on the build,
+ * "lzma", "zstd" and "lz4". Filters, that do not change the data size but
+ * rearrange it so that it compresses better, are registered in the same way:
+ * "shuffle" (byte shuffle) and "bitshuffle" (bit shuffle) of typed elements.
+ *
+ * @since GDAL 3.4
+ */
+
+CPL_C_START
+
+/** Callback of a compressor, decompressor or filter.
+ *
+ * The semantics of the output arguments are:
+ * <ul>
+ * <li>if output_data is NULL and output_size is not NULL, *output_size is
+ *     set to an upper bound of the output size, when the function can
+ *     compute it without processing the input (compressors and filters
+ *     generally can, decompressors generally cannot).</li>
+ * <li>if output_data is not NULL and *output_data is not NULL, *output_data
+ *     is a caller-provided buffer of *output_size bytes. On success,
+ *     *output_size is set to the number of bytes written.</li>
+ * <li>if output_data is not NULL and *output_data is NULL, the function
+ *     allocates the output buffer, that the caller must free with VSIFree(),
+ *     and sets *output_size to its size.</li>
+ * </ul>
+ *
+ * @return true in case of success.
+ */
+typedef bool (*CPLCompressionFunc)(const void* input_data,
+                                   size_t input_size,
+                                   void** output_data,
+                                   size_t* output_size,
+                                   CSLConstList options,
+                                   void* compressor_user_data);
+
+/** Type of compressor */
+typedef enum
+{
+    /** Compressor */
+    CCT_COMPRESSOR,
+    /** Filter */
+    CCT_FILTER
+} CPLCompressorType;
+
+/** Compressor/decompressor description */
+typedef struct
+{
+    /** Structure version. Should be set to 1 */
+    int nStructVersion;
+    /** Id of the compressor/decompressor. Should not be NULL. */
+    const char* pszId;
+    /** Compressor type */
+    CPLCompressorType eType;
+    /** Metadata, as a list of KEY=VALUE strings. May be NULL.
+     * The OPTIONS key, if present, is the XML description of the options,
+     * in the same format as creation option lists of drivers. */
+    CSLConstList papszMetadata;
+    /** Compressor/decompressor callback. Should not be NULL. */
+    CPLCompressionFunc pfnFunc;
+    /** User data to provide to the callback. May be NULL. */
+    void* user_data;
+} CPLCompressor;
+
+bool CPL_DLL CPLRegisterCompressor(const CPLCompressor* compressor);
+bool CPL_DLL CPLRegisterDecompressor(const CPLCompressor* decompressor);
+char CPL_DLL ** CPLGetCompressors(void);
+char CPL_DLL ** CPLGetDecompressors(void);
+const CPLCompressor CPL_DLL *CPLGetCompressor(const char* pszId);
+const CPLCompressor CPL_DLL *CPLGetDecompressor(const char* pszId);
+
+bool CPL_DLL CPLCompressorRunMultiple(const CPLCompressor* compressor,
+                                      size_t nBuffers,
+                                      const void* const* papInputData,
+                                      const size_t* panInputSize,
+                                      void** papOutputData,
+                                      size_t* panOutputSize,
+                                      CSLConstList options,
+                                      int nThreads);
+
+/*! @cond Doxygen_Suppress */
+void CPLDestroyCompressorRegistry(void);
+/*! @endcond */
+
+CPL_C_END
+
+#endif /* CPL_COMPRESSOR_H_INCLUDED */
@@ -54,6 +54,7 @@
 #include "cpl_conv.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
 #include <climits>
@@ -72,7 +73,9 @@
 #ifdef DEBUG_CONFIG_OPTIONS
 #include <set>
 #endif
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_multiproc.h"
@@ -94,8 +97,35 @@ void OGRAPISPYCPLSetThreadLocalConfigOption(const char*, const char*);
 
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                      CPLConfigOptionsSnapshot                        */
+/************************************************************************/
+
+// Immutable list of the options set with CPLSetConfigOption().
+// CPLSetConfigOption() never modifies a snapshot, but publishes a new one,
+// sharing the "KEY=VALUE" strings of the keys it does not change, so that
+// a value returned by CPLGetConfigOption() remains valid until its key is
+// set again, as with the previous CSL-based implementation.
+struct CPLConfigOptionsSnapshot
+{
+    std::vector<std::shared_ptr<const std::string>> aoEntries{};
+    // NULL terminated list pointing to aoEntries, for CSLFetchNameValue().
+    std::vector<char*> apszList{};
+};
+
+// Per-thread reference to the snapshot last seen by the thread.
+struct CPLConfigOptionsSnapshotRef
+{
+    std::shared_ptr<const CPLConfigOptionsSnapshot> poSnapshot{};
+};
+
+// Protects g_poConfigOptions and serializes writers. Readers only take it
+// when the snapshot has changed since their last access.
 static CPLMutex *hConfigMutex = nullptr;
-static volatile char **g_papszConfigOptions = nullptr;
+static std::shared_ptr<const CPLConfigOptionsSnapshot> g_poConfigOptions{};
+// Address of the current snapshot, or nullptr if there are no options.
+static std::atomic<const CPLConfigOptionsSnapshot*>
+                                        g_poConfigOptionsCurrent{nullptr};
 
 // Used by CPLOpenShared() and friends.
 static CPLMutex *hSharedFileMutex = nullptr;
@@ -1654,6 +1684,82 @@ static void CPLAccessConfigOption( const char *pszKey, bool bGet )
 }
 #endif
 
+/************************************************************************/
+/*                      CPLPublishConfigOptions()                       */
+/************************************************************************/
+
+// Must be called with hConfigMutex held.
+static void CPLPublishConfigOptions(
+            std::vector<std::shared_ptr<const std::string>>&& aoEntries )
+{
+    std::shared_ptr<CPLConfigOptionsSnapshot> poSnapshot;
+    if( !aoEntries.empty() )
+    {
+        poSnapshot = std::make_shared<CPLConfigOptionsSnapshot>();
+        poSnapshot->aoEntries = std::move(aoEntries);
+        poSnapshot->apszList.reserve(poSnapshot->aoEntries.size() + 1);
+        for( const auto& poEntry: poSnapshot->aoEntries )
+            poSnapshot->apszList.push_back(
+                const_cast<char*>(poEntry->c_str()));
+        poSnapshot->apszList.push_back(nullptr);
+    }
+    g_poConfigOptions = poSnapshot;
+    g_poConfigOptionsCurrent.store(poSnapshot.get(), std::memory_order_release);
+}
+
+/************************************************************************/
+/*                   CPLConfigOptionsSnapshotRefFree()                  */
+/************************************************************************/
+
+static void CPLConfigOptionsSnapshotRefFree( void *pData )
+{
+    delete static_cast<CPLConfigOptionsSnapshotRef*>(pData);
+}
+
+/************************************************************************/
+/*                     CPLFetchGlobalConfigOption()                     */
+/************************************************************************/
+
+// Look for pszKey in the options set with CPLSetConfigOption().
+// Each thread keeps a reference to the last snapshot it has seen, and only
+// needs to take hConfigMutex when a new snapshot has been published since.
+static const char* CPLFetchGlobalConfigOption( const char *pszKey )
+{
+    const CPLConfigOptionsSnapshot* poCurrent =
+        g_poConfigOptionsCurrent.load(std::memory_order_acquire);
+
+    int bMemoryError = FALSE;
+    auto psRef = static_cast<CPLConfigOptionsSnapshotRef*>(
+        CPLGetTLSEx(CTLS_CONFIGOPTIONSSNAPSHOT, &bMemoryError));
+    if( bMemoryError )
+    {
+        CPLMutexHolderD(&hConfigMutex);
+        if( g_poConfigOptions == nullptr )
+            return nullptr;
+        return CSLFetchNameValue(
+            const_cast<char**>(g_poConfigOptions->apszList.data()), pszKey);
+    }
+    if( psRef == nullptr )
+    {
+        if( poCurrent == nullptr )
+            return nullptr;
+        psRef = new CPLConfigOptionsSnapshotRef();
+        CPLSetTLSWithFreeFunc(CTLS_CONFIGOPTIONSSNAPSHOT, psRef,
+                              CPLConfigOptionsSnapshotRefFree);
+    }
+    if( psRef->poSnapshot.get() != poCurrent )
+    {
+        CPLMutexHolderD(&hConfigMutex);
+        psRef->poSnapshot = g_poConfigOptions;
+    }
+
+    const CPLConfigOptionsSnapshot* poSnapshot = psRef->poSnapshot.get();
+    if( poSnapshot == nullptr )
+        return nullptr;
+    return CSLFetchNameValue(
+        const_cast<char**>(poSnapshot->apszList.data()), pszKey);
+}
+
 /************************************************************************/
 /*                         CPLGetConfigOption()                         */
 /************************************************************************/
@@ -1708,12 +1814,7 @@ CPLGetConfigOption( const char *pszKey, const char *pszDefault )
         pszResult = CSLFetchNameValue(papszTLConfigOptions, pszKey);
 
     if( pszResult == nullptr )
-    {
-        CPLMutexHolderD(&hConfigMutex);
-
-        pszResult =
-            CSLFetchNameValue(const_cast<char **>(g_papszConfigOptions), pszKey);
-    }
+        pszResult = CPLFetchGlobalConfigOption(pszKey);
 
     if( pszResult == nullptr )
         pszResult = getenv(pszKey);
@@ -1742,7 +1843,10 @@ CPLGetConfigOption( const char *pszKey, const char *pszDefault )
 char** CPLGetConfigOptions(void)
 {
     CPLMutexHolderD(&hConfigMutex);
-    return CSLDuplicate(const_cast<char**>(g_papszConfigOptions));
+    if( g_poConfigOptions == nullptr )
+        return nullptr;
+    return CSLDuplicate(
+        const_cast<char**>(g_poConfigOptions->apszList.data()));
 }
 
 /************************************************************************/
@@ -1767,10 +1871,15 @@ char** CPLGetConfigOptions(void)
   */
 void CPLSetConfigOptions(const char* const * papszConfigOptions)
 {
+    std::vector<std::shared_ptr<const std::string>> aoEntries;
+    for( const char* const* papszIter = papszConfigOptions;
+         papszIter && *papszIter; ++papszIter )
+    {
+        aoEntries.emplace_back(std::make_shared<const std::string>(*papszIter));
+    }
+
     CPLMutexHolderD(&hConfigMutex);
-    CSLDestroy(const_cast<char**>(g_papszConfigOptions));
-    g_papszConfigOptions = const_cast<volatile char**>(
-            CSLDuplicate(const_cast<char**>(papszConfigOptions)));
+    CPLPublishConfigOptions(std::move(aoEntries));
 }
 
 /************************************************************************/
@@ -1858,9 +1967,46 @@ CPLSetConfigOption( const char *pszKey, const char *pszValue )
     OGRAPISPYCPLSetConfigOption(pszKey, pszValue);
 #endif
 
-    g_papszConfigOptions = const_cast<volatile char **>(
-        CSLSetNameValue(
-            const_cast<char **>(g_papszConfigOptions), pszKey, pszValue));
+    // Copy-on-write of the current snapshot, with the same key matching
+    // rules as CSLSetNameValue().
+    std::vector<std::shared_ptr<const std::string>> aoEntries;
+    if( g_poConfigOptions != nullptr )
+        aoEntries = g_poConfigOptions->aoEntries;
+
+    size_t nKeyLen = strlen(pszKey);
+    while( nKeyLen > 0 && pszKey[nKeyLen-1] == ' ' )
+        nKeyLen --;
+    bool bFound = false;
+    for( size_t i = 0; i < aoEntries.size(); ++i )
+    {
+        const char* pszEntry = aoEntries[i]->c_str();
+        if( !EQUALN(pszEntry, pszKey, nKeyLen) )
+            continue;
+        size_t j = nKeyLen;
+        while( pszEntry[j] == ' ' )
+            ++j;
+        if( pszEntry[j] != '=' && pszEntry[j] != ':' )
+            continue;
+
+        if( pszValue == nullptr )
+        {
+            aoEntries.erase(aoEntries.begin() + i);
+        }
+        else
+        {
+            aoEntries[i] = std::make_shared<const std::string>(
+                std::string(pszKey) + pszEntry[j] + pszValue);
+        }
+        bFound = true;
+        break;
+    }
+    if( !bFound && pszValue != nullptr )
+    {
+        aoEntries.emplace_back(std::make_shared<const std::string>(
+            std::string(pszKey) + '=' + pszValue));
+    }
+
+    CPLPublishConfigOptions(std::move(aoEntries));
 }
 
 /************************************************************************/
@@ -1991,8 +2137,17 @@ void CPL_STDCALL CPLFreeConfig()
     {
         CPLMutexHolderD(&hConfigMutex);
 
-        CSLDestroy(const_cast<char **>(g_papszConfigOptions));
-        g_papszConfigOptions = nullptr;
+        CPLPublishConfigOptions(
+            std::vector<std::shared_ptr<const std::string>>());
+
+        int bMemoryErrorSnapshot = FALSE;
+        auto psRef = static_cast<CPLConfigOptionsSnapshotRef*>(
+            CPLGetTLSEx(CTLS_CONFIGOPTIONSSNAPSHOT, &bMemoryErrorSnapshot));
+        if( psRef != nullptr )
+        {
+            delete psRef;
+            CPLSetTLS(CTLS_CONFIGOPTIONSSNAPSHOT, nullptr, FALSE);
+        }
 
         int bMemoryError = FALSE;
         char **papszTLConfigOptions = reinterpret_cast<char **>(
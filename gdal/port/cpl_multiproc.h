@@ -229,6 +229,8 @@ class CPL_DLL CPLLockHolder
 #define CTLS_PROJCONTEXTHOLDER          18         /* ogr_proj_p.cpp */
 #define CTLS_GDALDEFAULTOVR_ANTIREC     19         /* gdaldefaultoverviews.cpp */
 #define CTLS_HTTPFETCHCALLBACK          20         /* cpl_http.cpp */
+#define CTLS_CONFIGOPTIONSSNAPSHOT      21         /* cpl_conv.cpp */
+#define CTLS_TRACEBUFFER                22         /* cpl_trace.cpp */
 
 #define CTLS_MAX                        32
 
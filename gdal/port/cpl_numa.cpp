@@ -0,0 +1,334 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  NUMA topology, thread and memory placement
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "cpl_numa.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+CPL_CVSID("$Id$")
+
+#if defined(__linux__) && defined(CPU_SET) && defined(SYS_getcpu) && \
+    defined(SYS_mbind)
+#define HAVE_LINUX_NUMA
+#endif
+
+#ifdef HAVE_LINUX_NUMA
+
+namespace {
+
+struct CPLNUMANode
+{
+    int              nId = 0;   // Id of the node for the kernel
+    std::vector<int> anCPUs{};  // CPUs of the node usable by the process
+};
+
+struct CPLNUMATopology
+{
+    std::vector<CPLNUMANode> asNodes{};
+    std::vector<int>         anCPUs{};  // CPUs usable by the process
+};
+
+} // namespace
+
+/************************************************************************/
+/*                          CPLParseCPUList()                           */
+/************************************************************************/
+
+// Parse a list such as "0-3,8,10-11" in the format of the Linux sysfs.
+static std::vector<int> CPLParseCPUList(const char* pszList)
+{
+    std::vector<int> anRet;
+    const CPLStringList aosTokens(CSLTokenizeString2(pszList, ",", 0));
+    for( int i = 0; i < aosTokens.size(); ++i )
+    {
+        const char* pszToken = aosTokens[i];
+        const int nStart = atoi(pszToken);
+        const char* pszDash = strchr(pszToken, '-');
+        const int nEnd = pszDash ? atoi(pszDash + 1) : nStart;
+        if( nStart < 0 || nEnd < nStart || nEnd >= CPU_SETSIZE )
+            continue;
+        for( int j = nStart; j <= nEnd; ++j )
+            anRet.push_back(j);
+    }
+    return anRet;
+}
+
+/************************************************************************/
+/*                          CPLReadSysFile()                            */
+/************************************************************************/
+
+static CPLString CPLReadSysFile(const char* pszFilename)
+{
+    CPLString osRet;
+    FILE* fp = fopen(pszFilename, "rb");
+    if( fp )
+    {
+        char szBuffer[4096] = {};
+        const size_t nRead = fread(szBuffer, 1, sizeof(szBuffer) - 1, fp);
+        szBuffer[nRead] = '\0';
+        fclose(fp);
+        osRet = szBuffer;
+        osRet.Trim();
+    }
+    return osRet;
+}
+
+/************************************************************************/
+/*                        CPLGetNUMATopology()                          */
+/************************************************************************/
+
+static const CPLNUMATopology& CPLGetNUMATopology()
+{
+    static const CPLNUMATopology oTopology = []()
+    {
+        CPLNUMATopology oRet;
+        cpu_set_t sSet;
+        CPU_ZERO(&sSet);
+        const bool bHasAffinity =
+            sched_getaffinity(0, sizeof(sSet), &sSet) == 0;
+        const auto IsUsable = [bHasAffinity, &sSet](int iCPU)
+        {
+            return !bHasAffinity || CPU_ISSET(iCPU, &sSet);
+        };
+
+        const CPLString osNodes(
+            CPLReadSysFile("/sys/devices/system/node/online"));
+        for( int nId: CPLParseCPUList(osNodes) )
+        {
+            CPLNUMANode sNode;
+            sNode.nId = nId;
+            for( int iCPU: CPLParseCPUList(CPLReadSysFile(CPLSPrintf(
+                        "/sys/devices/system/node/node%d/cpulist", nId))) )
+            {
+                if( IsUsable(iCPU) )
+                {
+                    sNode.anCPUs.push_back(iCPU);
+                    oRet.anCPUs.push_back(iCPU);
+                }
+            }
+            // Memory only nodes are not exposed
+            if( !sNode.anCPUs.empty() )
+                oRet.asNodes.emplace_back(std::move(sNode));
+        }
+
+        if( oRet.asNodes.empty() )
+        {
+            // No sysfs (containers, kernels without NUMA support): a single
+            // node with all the CPUs we are allowed to run on.
+            oRet.anCPUs.clear();
+            for( int iCPU = 0; iCPU < CPU_SETSIZE; ++iCPU )
+            {
+                if( bHasAffinity && CPU_ISSET(iCPU, &sSet) )
+                    oRet.anCPUs.push_back(iCPU);
+            }
+            CPLNUMANode sNode;
+            sNode.nId = -1;
+            sNode.anCPUs = oRet.anCPUs;
+            oRet.asNodes.emplace_back(std::move(sNode));
+        }
+        return oRet;
+    }();
+    return oTopology;
+}
+
+#endif // HAVE_LINUX_NUMA
+
+/************************************************************************/
+/*                         CPLGetNUMANodeCount()                        */
+/************************************************************************/
+
+/** Return the number of NUMA nodes with CPUs the process may run on.
+ *
+ * Nodes are designated in the other functions of this file by an index
+ * between 0 and the return value of this function minus one.
+ *
+ * @return the number of nodes, at least 1.
+ * @since GDAL 3.4
+ */
+int CPLGetNUMANodeCount()
+{
+#ifdef HAVE_LINUX_NUMA
+    return static_cast<int>(CPLGetNUMATopology().asNodes.size());
+#else
+    return 1;
+#endif
+}
+
+/************************************************************************/
+/*                        CPLGetCurrentNUMANode()                       */
+/************************************************************************/
+
+/** Return the index of the NUMA node of the CPU the calling thread is
+ * running on.
+ *
+ * Unless the thread is bound to a node, the result may be out of date as
+ * soon as it is returned.
+ *
+ * @return a node index, or -1 if unknown.
+ * @since GDAL 3.4
+ */
+int CPLGetCurrentNUMANode()
+{
+#ifdef HAVE_LINUX_NUMA
+    const auto& oTopology = CPLGetNUMATopology();
+    if( oTopology.asNodes.size() == 1 )
+        return 0;
+    unsigned nCPU = 0;
+    unsigned nNode = 0;
+    if( syscall(SYS_getcpu, &nCPU, &nNode, nullptr) != 0 )
+        return -1;
+    for( size_t i = 0; i < oTopology.asNodes.size(); ++i )
+    {
+        if( oTopology.asNodes[i].nId == static_cast<int>(nNode) )
+            return static_cast<int>(i);
+    }
+    return -1;
+#else
+    return 0;
+#endif
+}
+
+/************************************************************************/
+/*                   CPLBindCurrentThreadToNUMANode()                   */
+/************************************************************************/
+
+/** Restrict the calling thread to the CPUs of a NUMA node.
+ *
+ * @param iNode Node index, between 0 and CPLGetNUMANodeCount() - 1.
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+int CPLBindCurrentThreadToNUMANode(int iNode)
+{
+#ifdef HAVE_LINUX_NUMA
+    const auto& oTopology = CPLGetNUMATopology();
+    if( iNode < 0 || iNode >= static_cast<int>(oTopology.asNodes.size()) ||
+        oTopology.asNodes[iNode].anCPUs.empty() )
+        return FALSE;
+    cpu_set_t sSet;
+    CPU_ZERO(&sSet);
+    for( int iCPU: oTopology.asNodes[iNode].anCPUs )
+        CPU_SET(iCPU, &sSet);
+    // On Linux, a pid of 0 designates the calling thread.
+    return sched_setaffinity(0, sizeof(sSet), &sSet) == 0;
+#else
+    CPL_IGNORE_RET_VAL(iNode);
+    return FALSE;
+#endif
+}
+
+/************************************************************************/
+/*                      CPLBindCurrentThreadToCPU()                     */
+/************************************************************************/
+
+/** Restrict the calling thread to a single CPU.
+ *
+ * @param iCPU Index of the CPU among the ones the process may run on,
+ *             between 0 and CPLGetNumCPUs() - 1. Larger values wrap around.
+ *             CPUs are ordered so that consecutive indices are on the same
+ *             NUMA node.
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+int CPLBindCurrentThreadToCPU(int iCPU)
+{
+#ifdef HAVE_LINUX_NUMA
+    const auto& oTopology = CPLGetNUMATopology();
+    if( iCPU < 0 || oTopology.anCPUs.empty() )
+        return FALSE;
+    // Enumerate CPUs node after node
+    int iIdx = iCPU % static_cast<int>(oTopology.anCPUs.size());
+    for( const auto& sNode: oTopology.asNodes )
+    {
+        if( iIdx < static_cast<int>(sNode.anCPUs.size()) )
+        {
+            cpu_set_t sSet;
+            CPU_ZERO(&sSet);
+            CPU_SET(sNode.anCPUs[iIdx], &sSet);
+            return sched_setaffinity(0, sizeof(sSet), &sSet) == 0;
+        }
+        iIdx -= static_cast<int>(sNode.anCPUs.size());
+    }
+    return FALSE;
+#else
+    CPL_IGNORE_RET_VAL(iCPU);
+    return FALSE;
+#endif
+}
+
+/************************************************************************/
+/*                       CPLBindMemoryToNUMANode()                      */
+/************************************************************************/
+
+/** Set the preferred NUMA node of the pages of a memory range.
+ *
+ * Only pages not yet touched are affected. This is typically used on
+ * anonymous memory mappings just after their creation.
+ *
+ * @param pAddr Start of the range. Must be aligned on a page boundary.
+ * @param nSize Size of the range, in bytes.
+ * @param iNode Node index, between 0 and CPLGetNUMANodeCount() - 1.
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+int CPLBindMemoryToNUMANode(void* pAddr, size_t nSize, int iNode)
+{
+#ifdef HAVE_LINUX_NUMA
+    const auto& oTopology = CPLGetNUMATopology();
+    if( iNode < 0 || iNode >= static_cast<int>(oTopology.asNodes.size()) )
+        return FALSE;
+    const int nId = oTopology.asNodes[iNode].nId;
+    constexpr int MAX_NODES = 1024;
+    constexpr int BITS_PER_LONG = static_cast<int>(8 * sizeof(unsigned long));
+    if( nId < 0 || nId >= MAX_NODES )
+        return FALSE;
+    unsigned long anMask[MAX_NODES / BITS_PER_LONG] = {};
+    anMask[nId / BITS_PER_LONG] = 1UL << (nId % BITS_PER_LONG);
+    constexpr int MPOL_PREFERRED_VALUE = 1;  // from <linux/mempolicy.h>
+    // The kernel uses maxnode - 1 bits of the mask
+    return syscall(SYS_mbind, pAddr, nSize, MPOL_PREFERRED_VALUE, anMask,
+                   static_cast<unsigned long>(MAX_NODES + 1), 0) == 0;
+#else
+    CPL_IGNORE_RET_VAL(pAddr);
+    CPL_IGNORE_RET_VAL(nSize);
+    CPL_IGNORE_RET_VAL(iNode);
+    return FALSE;
+#endif
+}
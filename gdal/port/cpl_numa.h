@@ -0,0 +1,57 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  NUMA topology, thread and memory placement
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_NUMA_H_INCLUDED
+#define CPL_NUMA_H_INCLUDED
+
+#include "cpl_port.h"
+
+/**
+ * \file cpl_numa.h
+ *
+ * NUMA topology, thread and memory placement.
+ *
+ * Only implemented on Linux, where the topology is read from
+ * /sys/devices/system/node, restricted to the CPUs the process is allowed
+ * to run on. On other platforms, a single node is reported, and the binding
+ * functions fail.
+ *
+ * @since GDAL 3.4
+ */
+
+CPL_C_START
+
+int CPL_DLL CPLGetNUMANodeCount(void);
+int CPL_DLL CPLGetCurrentNUMANode(void);
+int CPL_DLL CPLBindCurrentThreadToNUMANode(int iNode);
+int CPL_DLL CPLBindCurrentThreadToCPU(int iCPU);
+int CPL_DLL CPLBindMemoryToNUMANode(void* pAddr, size_t nSize, int iNode);
+
+CPL_C_END
+
+#endif /* CPL_NUMA_H_INCLUDED */
@@ -0,0 +1,966 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static, bulk-loaded, packed R-tree
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "cpl_packed_rtree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+
+CPL_CVSID("$Id$")
+
+constexpr int DEFAULT_NODE_CAPACITY = 16;
+constexpr int MAX_NODE_CAPACITY = 65535;
+
+// Below that number of items, the construction is done in a single thread.
+constexpr int MIN_ITEMS_FOR_MULTITHREADING = 65536;
+
+constexpr char SERIALIZATION_MAGIC[8] = { 'C','P','L','P','R','T','R','E' };
+constexpr GUInt32 SERIALIZATION_VERSION = 1;
+
+/*
+ * All entries (items at the bottom, then nodes of each level up to the root)
+ * are stored in the same arrays. For an item entry, anIndices[] is the index
+ * of the item in the array passed at creation. For a node entry, it is the
+ * position of its first child entry in the level below: the children of a
+ * node are the nNodeCapacity consecutive entries starting at that position
+ * (or less at the end of the level).
+ */
+struct _CPLPackedRTree
+{
+    int                 nItems = 0;
+    int                 nNodeCapacity = DEFAULT_NODE_CAPACITY;
+    std::vector<double> adfBoxes{};         // 4 values per entry
+    std::vector<int>    anIndices{};        // 1 value per entry
+    std::vector<int>    anLevelBounds{};    // end of each level, in entries
+};
+
+/************************************************************************/
+/*                         ComputeLevelBounds()                         */
+/************************************************************************/
+
+static std::vector<int> ComputeLevelBounds(int nItems, int nNodeCapacity)
+{
+    std::vector<int> anLevelBounds;
+    if( nItems == 0 )
+        return anLevelBounds;
+    int nLevelCount = nItems;
+    int nEntries = nItems;
+    anLevelBounds.push_back(nEntries);
+    do
+    {
+        nLevelCount = (nLevelCount + nNodeCapacity - 1) / nNodeCapacity;
+        nEntries += nLevelCount;
+        anLevelBounds.push_back(nEntries);
+    } while( nLevelCount != 1 );
+    return anLevelBounds;
+}
+
+/************************************************************************/
+/*                              Hilbert()                               */
+/************************************************************************/
+
+// Based on public domain code at https://github.com/rawrunprotected/hilbert_curves
+static GUInt32 Hilbert(GUInt32 x, GUInt32 y)
+{
+    GUInt32 a = x ^ y;
+    GUInt32 b = 0xFFFF ^ a;
+    GUInt32 c = 0xFFFF ^ (x | y);
+    GUInt32 d = x & (y ^ 0xFFFF);
+
+    GUInt32 A = a | (b >> 1);
+    GUInt32 B = (a >> 1) ^ a;
+    GUInt32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    GUInt32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+    B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+    C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+    D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+    B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+    C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+    D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+    a = A; b = B; c = C; d = D;
+    C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+    D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    GUInt32 i0 = x ^ y;
+    GUInt32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
+
+/************************************************************************/
+/*                          CPLPackedRTreeJob                           */
+/************************************************************************/
+
+namespace {
+struct CPLPackedRTreeJob
+{
+    CPLPackedRTree*    psTree = nullptr;
+    const CPLRectObj*  pasBounds = nullptr;
+    const CPLRectObj*  psExtent = nullptr;
+    std::vector<GUInt64>* panKeys = nullptr;
+    size_t             nStart = 0;
+    size_t             nMiddle = 0;
+    size_t             nEnd = 0;
+};
+} // namespace
+
+/************************************************************************/
+/*                     CPLPackedRTreeComputeKeys()                      */
+/************************************************************************/
+
+// Return the coordinate on the Hilbert curve grid of a position relative to
+// the extent of the items. Infinite bounds can give positions outside [0,1],
+// or NaN, which must not be converted to an integer.
+static GUInt32 CPLPackedRTreeGetHilbertCoord(double dfRelPos)
+{
+    constexpr double HILBERT_MAX = 65535.0;
+    const double dfPos = std::floor(HILBERT_MAX * dfRelPos);
+    if( !(dfPos > 0) )
+        return 0;
+    if( dfPos > HILBERT_MAX )
+        return static_cast<GUInt32>(HILBERT_MAX);
+    return static_cast<GUInt32>(dfPos);
+}
+
+// Compute the sort keys of a range of items, and sort that range.
+// A key is made of the Hilbert value of the center of the item in its
+// 32 most significant bits, and of the item index in the 32 least
+// significant ones, so that the ordering is deterministic.
+static void CPLPackedRTreeComputeKeys(void* pData)
+{
+    CPLPackedRTreeJob* psJob = static_cast<CPLPackedRTreeJob*>(pData);
+    const CPLRectObj* psExtent = psJob->psExtent;
+    const double dfWidth = psExtent->maxx - psExtent->minx;
+    const double dfHeight = psExtent->maxy - psExtent->miny;
+    std::vector<GUInt64>& anKeys = *(psJob->panKeys);
+    for( size_t i = psJob->nStart; i < psJob->nEnd; ++i )
+    {
+        const CPLRectObj& sRect = psJob->pasBounds[i];
+        const GUInt32 nX = dfWidth > 0 ? CPLPackedRTreeGetHilbertCoord(
+            ((sRect.minx + sRect.maxx) / 2 - psExtent->minx) / dfWidth) : 0;
+        const GUInt32 nY = dfHeight > 0 ? CPLPackedRTreeGetHilbertCoord(
+            ((sRect.miny + sRect.maxy) / 2 - psExtent->miny) / dfHeight) : 0;
+        anKeys[i] = (static_cast<GUInt64>(Hilbert(nX, nY)) << 32) | i;
+    }
+    std::sort(anKeys.begin() + psJob->nStart, anKeys.begin() + psJob->nEnd);
+}
+
+/************************************************************************/
+/*                     CPLPackedRTreeMergeKeys()                        */
+/************************************************************************/
+
+static void CPLPackedRTreeMergeKeys(void* pData)
+{
+    CPLPackedRTreeJob* psJob = static_cast<CPLPackedRTreeJob*>(pData);
+    std::vector<GUInt64>& anKeys = *(psJob->panKeys);
+    std::inplace_merge(anKeys.begin() + psJob->nStart,
+                       anKeys.begin() + psJob->nMiddle,
+                       anKeys.begin() + psJob->nEnd);
+}
+
+/************************************************************************/
+/*                     CPLPackedRTreeFillItems()                        */
+/************************************************************************/
+
+static void CPLPackedRTreeFillItems(void* pData)
+{
+    CPLPackedRTreeJob* psJob = static_cast<CPLPackedRTreeJob*>(pData);
+    CPLPackedRTree* psTree = psJob->psTree;
+    const std::vector<GUInt64>& anKeys = *(psJob->panKeys);
+    for( size_t i = psJob->nStart; i < psJob->nEnd; ++i )
+    {
+        const int nIdx = static_cast<int>(anKeys[i] & 0xFFFFFFFFU);
+        const CPLRectObj& sRect = psJob->pasBounds[nIdx];
+        psTree->adfBoxes[4 * i + 0] = sRect.minx;
+        psTree->adfBoxes[4 * i + 1] = sRect.miny;
+        psTree->adfBoxes[4 * i + 2] = sRect.maxx;
+        psTree->adfBoxes[4 * i + 3] = sRect.maxy;
+        psTree->anIndices[i] = nIdx;
+    }
+}
+
+/************************************************************************/
+/*                   CPLPackedRTreeGetThreadCount()                     */
+/************************************************************************/
+
+static int CPLPackedRTreeGetThreadCount(int nItems)
+{
+    if( nItems < MIN_ITEMS_FOR_MULTITHREADING )
+        return 1;
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                   atoi(pszThreads);
+    // Do not use threads processing less than half the minimum.
+    nThreads = std::min(nThreads,
+                        nItems / (MIN_ITEMS_FOR_MULTITHREADING / 2));
+    return std::max(1, std::min(128, nThreads));
+}
+
+/************************************************************************/
+/*                     CPLPackedRTreeGetThreadPool()                    */
+/************************************************************************/
+
+// The pool is kept from one tree creation to the next one, and shared by
+// concurrent creations, each using its own job queue.
+static std::mutex gMutexPackedRTreeThreadPool;
+static CPLWorkerThreadPool* gpoPackedRTreeThreadPool = nullptr;
+
+static CPLWorkerThreadPool* CPLPackedRTreeGetThreadPool(int nThreads)
+{
+    std::lock_guard<std::mutex> oGuard(gMutexPackedRTreeThreadPool);
+    if( gpoPackedRTreeThreadPool == nullptr )
+    {
+        gpoPackedRTreeThreadPool = new CPLWorkerThreadPool();
+        if( !gpoPackedRTreeThreadPool->Setup(nThreads, nullptr, nullptr) )
+        {
+            delete gpoPackedRTreeThreadPool;
+            gpoPackedRTreeThreadPool = nullptr;
+        }
+    }
+    else if( nThreads > gpoPackedRTreeThreadPool->GetThreadCount() )
+    {
+        gpoPackedRTreeThreadPool->Setup(nThreads, nullptr, nullptr, false);
+    }
+    return gpoPackedRTreeThreadPool;
+}
+
+/************************************************************************/
+/*                      CPLPackedRTreeCleanup()                         */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+
+// Called by GDALDestroyDriverManager() to stop the worker threads.
+void CPLPackedRTreeCleanup(void)
+{
+    std::lock_guard<std::mutex> oGuard(gMutexPackedRTreeThreadPool);
+    delete gpoPackedRTreeThreadPool;
+    gpoPackedRTreeThreadPool = nullptr;
+}
+
+/*! @endcond */
+
+/************************************************************************/
+/*                        CPLPackedRTreeCreate()                        */
+/************************************************************************/
+
+/**
+ * Create a packed R-tree from the bounds of a set of items.
+ *
+ * The items are sorted along a Hilbert curve of the centers of their bounds,
+ * and grouped by nNodeCapacity to form the nodes of each level. When there
+ * are a lot of items, the sort is done with several threads, whose number
+ * is controlled by the GDAL_NUM_THREADS configuration option (default: 1).
+ * Items whose bounds have a NaN coordinate are not accepted.
+ *
+ * @param nItems number of items. Must be positive or zero.
+ * @param pasBounds array of nItems bounds. Item i of the tree is the one
+ *                  whose bounds are pasBounds[i]. The array is not
+ *                  referenced after the call.
+ * @param nNodeCapacity maximum number of children of a node, or 0 to use the
+ *                      default value (16).
+ *
+ * @return a newly allocated tree, to free with CPLPackedRTreeDestroy(),
+ *         or NULL in case of error.
+ * @since GDAL 3.4
+ */
+
+CPLPackedRTree *CPLPackedRTreeCreate( int nItems,
+                                      const CPLRectObj* pasBounds,
+                                      int nNodeCapacity )
+{
+    if( nItems < 0 || (nItems > 0 && pasBounds == nullptr) ||
+        nItems > std::numeric_limits<int>::max() / 2 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "CPLPackedRTreeCreate(): invalid item count");
+        return nullptr;
+    }
+    if( nNodeCapacity <= 0 )
+        nNodeCapacity = DEFAULT_NODE_CAPACITY;
+    nNodeCapacity = std::max(2, std::min(MAX_NODE_CAPACITY, nNodeCapacity));
+
+    CPLPackedRTree* psTree = new CPLPackedRTree();
+    psTree->nItems = nItems;
+    psTree->nNodeCapacity = nNodeCapacity;
+    if( nItems == 0 )
+        return psTree;
+
+    psTree->anLevelBounds = ComputeLevelBounds(nItems, nNodeCapacity);
+    const size_t nEntries = static_cast<size_t>(psTree->anLevelBounds.back());
+    std::vector<GUInt64> anKeys;
+    try
+    {
+        psTree->adfBoxes.resize(4 * nEntries);
+        psTree->anIndices.resize(nEntries);
+        anKeys.resize(static_cast<size_t>(nItems));
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "CPLPackedRTreeCreate(): out of memory");
+        delete psTree;
+        return nullptr;
+    }
+
+    for( int i = 0; i < nItems; ++i )
+    {
+        if( std::isnan(pasBounds[i].minx) || std::isnan(pasBounds[i].miny) ||
+            std::isnan(pasBounds[i].maxx) || std::isnan(pasBounds[i].maxy) )
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg,
+                     "CPLPackedRTreeCreate(): NaN bounds for item %d", i);
+            delete psTree;
+            return nullptr;
+        }
+    }
+
+    CPLRectObj sExtent = pasBounds[0];
+    for( int i = 1; i < nItems; ++i )
+    {
+        sExtent.minx = std::min(sExtent.minx, pasBounds[i].minx);
+        sExtent.miny = std::min(sExtent.miny, pasBounds[i].miny);
+        sExtent.maxx = std::max(sExtent.maxx, pasBounds[i].maxx);
+        sExtent.maxy = std::max(sExtent.maxy, pasBounds[i].maxy);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Sort the items along the Hilbert curve, and copy their bounds   */
+/*      in that order. With several threads, each one sorts a chunk,    */
+/*      and then chunks are merged by pairs.                            */
+/* -------------------------------------------------------------------- */
+    const int nThreads = CPLPackedRTreeGetThreadCount(nItems);
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool* poPool = CPLPackedRTreeGetThreadPool(nThreads);
+        if( poPool == nullptr )
+        {
+            delete psTree;
+            return nullptr;
+        }
+        poJobQueue = poPool->CreateJobQueue();
+    }
+
+    std::vector<CPLPackedRTreeJob> asJobs(nThreads);
+    std::vector<size_t> anChunkStarts;
+    for( int i = 0; i < nThreads; ++i )
+    {
+        asJobs[i].psTree = psTree;
+        asJobs[i].pasBounds = pasBounds;
+        asJobs[i].psExtent = &sExtent;
+        asJobs[i].panKeys = &anKeys;
+        asJobs[i].nStart = static_cast<size_t>(nItems) * i / nThreads;
+        asJobs[i].nEnd = static_cast<size_t>(nItems) * (i + 1) / nThreads;
+        anChunkStarts.push_back(asJobs[i].nStart);
+    }
+    anChunkStarts.push_back(static_cast<size_t>(nItems));
+
+    const auto RunJobs = [&poJobQueue, &asJobs](CPLThreadFunc pfnFunc,
+                                                size_t nJobs)
+    {
+        if( poJobQueue == nullptr )
+        {
+            for( size_t i = 0; i < nJobs; ++i )
+                pfnFunc(&asJobs[i]);
+            return;
+        }
+        for( size_t i = 0; i < nJobs; ++i )
+        {
+            // Run the job in this thread if it cannot be queued.
+            if( !poJobQueue->SubmitJob(pfnFunc, &asJobs[i]) )
+                pfnFunc(&asJobs[i]);
+        }
+        poJobQueue->WaitCompletion();
+    };
+
+    RunJobs(CPLPackedRTreeComputeKeys, asJobs.size());
+
+    while( anChunkStarts.size() > 2 )
+    {
+        std::vector<size_t> anNewChunkStarts;
+        size_t nJobs = 0;
+        size_t i = 0;
+        for( ; i + 2 < anChunkStarts.size(); i += 2 )
+        {
+            asJobs[nJobs].nStart = anChunkStarts[i];
+            asJobs[nJobs].nMiddle = anChunkStarts[i + 1];
+            asJobs[nJobs].nEnd = anChunkStarts[i + 2];
+            nJobs++;
+            anNewChunkStarts.push_back(anChunkStarts[i]);
+        }
+        // Odd chunk count: the last chunk is left as it is.
+        if( i + 1 < anChunkStarts.size() )
+            anNewChunkStarts.push_back(anChunkStarts[i]);
+        anNewChunkStarts.push_back(static_cast<size_t>(nItems));
+        RunJobs(CPLPackedRTreeMergeKeys, nJobs);
+        anChunkStarts = std::move(anNewChunkStarts);
+    }
+
+    for( int i = 0; i < nThreads; ++i )
+    {
+        asJobs[i].nStart = static_cast<size_t>(nItems) * i / nThreads;
+        asJobs[i].nEnd = static_cast<size_t>(nItems) * (i + 1) / nThreads;
+    }
+    RunJobs(CPLPackedRTreeFillItems, asJobs.size());
+
+/* -------------------------------------------------------------------- */
+/*      Build the nodes of each level from the entries of the level     */
+/*      below.                                                          */
+/* -------------------------------------------------------------------- */
+    double* padfBoxes = psTree->adfBoxes.data();
+    int nPos = 0;
+    int nNewPos = nItems;
+    for( size_t iLevel = 0; iLevel + 1 < psTree->anLevelBounds.size();
+         ++iLevel )
+    {
+        const int nEnd = psTree->anLevelBounds[iLevel];
+        while( nPos < nEnd )
+        {
+            const int nFirstChild = nPos;
+            double dfMinX = padfBoxes[4 * nPos + 0];
+            double dfMinY = padfBoxes[4 * nPos + 1];
+            double dfMaxX = padfBoxes[4 * nPos + 2];
+            double dfMaxY = padfBoxes[4 * nPos + 3];
+            ++nPos;
+            const int nChildEnd = std::min(nFirstChild + nNodeCapacity, nEnd);
+            for( ; nPos < nChildEnd; ++nPos )
+            {
+                dfMinX = std::min(dfMinX, padfBoxes[4 * nPos + 0]);
+                dfMinY = std::min(dfMinY, padfBoxes[4 * nPos + 1]);
+                dfMaxX = std::max(dfMaxX, padfBoxes[4 * nPos + 2]);
+                dfMaxY = std::max(dfMaxY, padfBoxes[4 * nPos + 3]);
+            }
+            padfBoxes[4 * nNewPos + 0] = dfMinX;
+            padfBoxes[4 * nNewPos + 1] = dfMinY;
+            padfBoxes[4 * nNewPos + 2] = dfMaxX;
+            padfBoxes[4 * nNewPos + 3] = dfMaxY;
+            psTree->anIndices[nNewPos] = nFirstChild;
+            ++nNewPos;
+        }
+    }
+
+    return psTree;
+}
+
+/************************************************************************/
+/*                       CPLPackedRTreeDestroy()                        */
+/************************************************************************/
+
+/**
+ * Destroy a packed R-tree.
+ *
+ * @param hTree the tree to destroy. May be NULL.
+ * @since GDAL 3.4
+ */
+
+void CPLPackedRTreeDestroy( CPLPackedRTree* hTree )
+{
+    delete hTree;
+}
+
+/************************************************************************/
+/*                    CPLPackedRTreeGetItemCount()                      */
+/************************************************************************/
+
+/**
+ * Return the number of items indexed by a packed R-tree.
+ *
+ * @param hTree the tree.
+ * @return the number of items.
+ * @since GDAL 3.4
+ */
+
+int CPLPackedRTreeGetItemCount( const CPLPackedRTree* hTree )
+{
+    return hTree->nItems;
+}
+
+/************************************************************************/
+/*                      CPLPackedRTreeGetBounds()                       */
+/************************************************************************/
+
+/**
+ * Return the union of the bounds of the items of a packed R-tree.
+ *
+ * For an empty tree, all members of *pBounds are set to 0.
+ *
+ * @param hTree the tree.
+ * @param pBounds pointer to the bounds to fill.
+ * @since GDAL 3.4
+ */
+
+void CPLPackedRTreeGetBounds( const CPLPackedRTree* hTree,
+                              CPLRectObj* pBounds )
+{
+    if( hTree->nItems == 0 )
+    {
+        memset(pBounds, 0, sizeof(*pBounds));
+        return;
+    }
+    const double* padfRoot = hTree->adfBoxes.data() +
+                                            hTree->adfBoxes.size() - 4;
+    pBounds->minx = padfRoot[0];
+    pBounds->miny = padfRoot[1];
+    pBounds->maxx = padfRoot[2];
+    pBounds->maxy = padfRoot[3];
+}
+
+/************************************************************************/
+/*                        GetLevelEnd()                                 */
+/************************************************************************/
+
+// Return the end of the level the entry at nPos belongs to.
+static int GetLevelEnd( const CPLPackedRTree* hTree, int nPos )
+{
+    return *std::upper_bound(hTree->anLevelBounds.begin(),
+                             hTree->anLevelBounds.end(), nPos);
+}
+
+/************************************************************************/
+/*                       CPLPackedRTreeForeach()                        */
+/************************************************************************/
+
+/**
+ * Run a callback on all items whose bounds intersect an area of interest.
+ *
+ * Bounds touching the area of interest are considered as intersecting it.
+ *
+ * @param hTree the tree.
+ * @param pAoi the area of interest.
+ * @param pfnForeach function called with the index of each item found, and
+ *                   pUserData. It must return TRUE to continue the search,
+ *                   or FALSE to stop it.
+ * @param pUserData user data passed to pfnForeach.
+ * @since GDAL 3.4
+ */
+
+void CPLPackedRTreeForeach( const CPLPackedRTree* hTree,
+                            const CPLRectObj* pAoi,
+                            CPLPackedRTreeForeachFunc pfnForeach,
+                            void* pUserData )
+{
+    if( hTree->nItems == 0 )
+        return;
+
+    const double* padfBoxes = hTree->adfBoxes.data();
+    const int* panIndices = hTree->anIndices.data();
+    std::vector<int> anStack;
+    int nNodePos = hTree->anLevelBounds.back() - 1;
+    while( true )
+    {
+        const int nEnd = std::min(nNodePos + hTree->nNodeCapacity,
+                                  GetLevelEnd(hTree, nNodePos));
+        const bool bIsItemLevel = nNodePos < hTree->nItems;
+        for( int nPos = nNodePos; nPos < nEnd; ++nPos )
+        {
+            const double* padfBox = padfBoxes + 4 * nPos;
+            if( pAoi->maxx < padfBox[0] || pAoi->maxy < padfBox[1] ||
+                pAoi->minx > padfBox[2] || pAoi->miny > padfBox[3] )
+                continue;
+            if( bIsItemLevel )
+            {
+                if( !pfnForeach(panIndices[nPos], pUserData) )
+                    return;
+            }
+            else
+            {
+                anStack.push_back(panIndices[nPos]);
+            }
+        }
+        if( anStack.empty() )
+            break;
+        nNodePos = anStack.back();
+        anStack.pop_back();
+    }
+}
+
+/************************************************************************/
+/*                        CPLPackedRTreeSearch()                        */
+/************************************************************************/
+
+static int CPLPackedRTreeCollect(int nItemIdx, void* pUserData)
+{
+    static_cast<std::vector<int>*>(pUserData)->push_back(nItemIdx);
+    return TRUE;
+}
+
+/**
+ * Return the items whose bounds intersect an area of interest.
+ *
+ * Bounds touching the area of interest are considered as intersecting it.
+ *
+ * @param hTree the tree.
+ * @param pAoi the area of interest.
+ * @param pnItemCount pointer to an integer set to the number of items found.
+ *
+ * @return an array of *pnItemCount item indices, in no particular order,
+ *         to free with CPLFree(), or NULL if no item was found.
+ * @since GDAL 3.4
+ */
+
+int *CPLPackedRTreeSearch( const CPLPackedRTree* hTree,
+                           const CPLRectObj* pAoi,
+                           int* pnItemCount )
+{
+    std::vector<int> anRes;
+    CPLPackedRTreeForeach(hTree, pAoi, CPLPackedRTreeCollect, &anRes);
+    *pnItemCount = static_cast<int>(anRes.size());
+    if( anRes.empty() )
+        return nullptr;
+    int* panRet = static_cast<int*>(
+        VSI_MALLOC2_VERBOSE(anRes.size(), sizeof(int)));
+    if( panRet == nullptr )
+    {
+        *pnItemCount = 0;
+        return nullptr;
+    }
+    memcpy(panRet, anRes.data(), anRes.size() * sizeof(int));
+    return panRet;
+}
+
+/************************************************************************/
+/*                       CPLPackedRTreeNearest()                        */
+/************************************************************************/
+
+/**
+ * Return the items whose bounds are the nearest from a point.
+ *
+ * The distance between the point and an item is the Euclidean distance to
+ * the bounds of the item, that is 0 if the point is within them.
+ *
+ * @param hTree the tree.
+ * @param dfX X coordinate of the point.
+ * @param dfY Y coordinate of the point.
+ * @param nMaxItems maximum number of items to return.
+ * @param dfMaxDistance maximum distance of the items to return, or 0 for
+ *                      no limit.
+ * @param pnItemCount pointer to an integer set to the number of items found.
+ *
+ * @return an array of *pnItemCount item indices, ordered by increasing
+ *         distance, to free with CPLFree(), or NULL if no item was found.
+ * @since GDAL 3.4
+ */
+
+int *CPLPackedRTreeNearest( const CPLPackedRTree* hTree,
+                            double dfX, double dfY,
+                            int nMaxItems,
+                            double dfMaxDistance,
+                            int* pnItemCount )
+{
+    *pnItemCount = 0;
+    if( hTree->nItems == 0 || nMaxItems <= 0 )
+        return nullptr;
+
+    const double dfMaxSquareDist =
+        dfMaxDistance > 0 ? dfMaxDistance * dfMaxDistance :
+                            std::numeric_limits<double>::infinity();
+
+    // Best-first traversal: the queue contains both nodes (whose distance is
+    // a lower bound of the one of their items) and items, so that an item
+    // at the top of the queue is nearer than anything not yet returned.
+    struct Candidate
+    {
+        double dfSquareDist;
+        int    nValue;      // first child entry for a node, item index else
+        bool   bIsItem;
+
+        bool operator< (const Candidate& other) const
+        {
+            return dfSquareDist > other.dfSquareDist;
+        }
+    };
+    std::priority_queue<Candidate> oQueue;
+    std::vector<int> anRes;
+
+    const double* padfBoxes = hTree->adfBoxes.data();
+    const int* panIndices = hTree->anIndices.data();
+    int nNodePos = hTree->anLevelBounds.back() - 1;
+    while( true )
+    {
+        const int nEnd = std::min(nNodePos + hTree->nNodeCapacity,
+                                  GetLevelEnd(hTree, nNodePos));
+        const bool bIsItemLevel = nNodePos < hTree->nItems;
+        for( int nPos = nNodePos; nPos < nEnd; ++nPos )
+        {
+            const double* padfBox = padfBoxes + 4 * nPos;
+            const double dfDX = dfX < padfBox[0] ? padfBox[0] - dfX :
+                                dfX > padfBox[2] ? dfX - padfBox[2] : 0.0;
+            const double dfDY = dfY < padfBox[1] ? padfBox[1] - dfY :
+                                dfY > padfBox[3] ? dfY - padfBox[3] : 0.0;
+            const double dfSquareDist = dfDX * dfDX + dfDY * dfDY;
+            if( dfSquareDist > dfMaxSquareDist )
+                continue;
+            Candidate oCandidate;
+            oCandidate.dfSquareDist = dfSquareDist;
+            oCandidate.nValue = panIndices[nPos];
+            oCandidate.bIsItem = bIsItemLevel;
+            oQueue.push(oCandidate);
+        }
+
+        while( !oQueue.empty() && oQueue.top().bIsItem )
+        {
+            anRes.push_back(oQueue.top().nValue);
+            oQueue.pop();
+            if( static_cast<int>(anRes.size()) == nMaxItems )
+                break;
+        }
+        if( static_cast<int>(anRes.size()) == nMaxItems || oQueue.empty() )
+            break;
+        nNodePos = oQueue.top().nValue;
+        oQueue.pop();
+    }
+
+    if( anRes.empty() )
+        return nullptr;
+    int* panRet = static_cast<int*>(
+        VSI_MALLOC2_VERBOSE(anRes.size(), sizeof(int)));
+    if( panRet == nullptr )
+        return nullptr;
+    memcpy(panRet, anRes.data(), anRes.size() * sizeof(int));
+    *pnItemCount = static_cast<int>(anRes.size());
+    return panRet;
+}
+
+/************************************************************************/
+/*                         CPLPackedRTreeSave()                         */
+/************************************************************************/
+
+/**
+ * Save a packed R-tree to a file.
+ *
+ * The file can be loaded back with CPLPackedRTreeLoad(). Values are written
+ * in little-endian order, so that the file can be exchanged between hosts.
+ *
+ * @param hTree the tree.
+ * @param pszFilename the output filename (may be a /vsi path).
+ *
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+
+int CPLPackedRTreeSave( const CPLPackedRTree* hTree, const char* pszFilename )
+{
+    VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename);
+        return FALSE;
+    }
+
+    bool bOK = VSIFWriteL(SERIALIZATION_MAGIC, sizeof(SERIALIZATION_MAGIC),
+                          1, fp) == 1;
+    GUInt32 anHeader[3] = { SERIALIZATION_VERSION,
+                            static_cast<GUInt32>(hTree->nNodeCapacity),
+                            static_cast<GUInt32>(hTree->nItems) };
+    for( auto& nVal: anHeader )
+        CPL_LSBPTR32(&nVal);
+    bOK &= VSIFWriteL(anHeader, sizeof(anHeader), 1, fp) == 1;
+
+#ifdef CPL_MSB
+    std::vector<double> adfBoxes(hTree->adfBoxes);
+    for( auto& dfVal: adfBoxes )
+        CPL_LSBPTR64(&dfVal);
+    std::vector<int> anIndices(hTree->anIndices);
+    for( auto& nVal: anIndices )
+        CPL_LSBPTR32(&nVal);
+#else
+    const std::vector<double>& adfBoxes = hTree->adfBoxes;
+    const std::vector<int>& anIndices = hTree->anIndices;
+#endif
+    bOK &= VSIFWriteL(adfBoxes.data(), sizeof(double),
+                      adfBoxes.size(), fp) == adfBoxes.size();
+    bOK &= VSIFWriteL(anIndices.data(), sizeof(int),
+                      anIndices.size(), fp) == anIndices.size();
+    bOK &= VSIFCloseL(fp) == 0;
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write %s", pszFilename);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                         CPLPackedRTreeLoad()                         */
+/************************************************************************/
+
+/**
+ * Load a packed R-tree from a file written by CPLPackedRTreeSave().
+ *
+ * @param pszFilename the input filename (may be a /vsi path).
+ *
+ * @return a newly allocated tree, to free with CPLPackedRTreeDestroy(),
+ *         or NULL in case of error.
+ * @since GDAL 3.4
+ */
+
+CPLPackedRTree *CPLPackedRTreeLoad( const char* pszFilename )
+{
+    VSILFILE* fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot open %s", pszFilename);
+        return nullptr;
+    }
+
+    char achMagic[sizeof(SERIALIZATION_MAGIC)] = {};
+    GUInt32 anHeader[3] = { 0, 0, 0 };
+    if( VSIFReadL(achMagic, sizeof(achMagic), 1, fp) != 1 ||
+        memcmp(achMagic, SERIALIZATION_MAGIC, sizeof(achMagic)) != 0 ||
+        VSIFReadL(anHeader, sizeof(anHeader), 1, fp) != 1 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s is not a packed R-tree file", pszFilename);
+        VSIFCloseL(fp);
+        return nullptr;
+    }
+    for( auto& nVal: anHeader )
+        CPL_LSBPTR32(&nVal);
+    if( anHeader[0] != SERIALIZATION_VERSION ||
+        anHeader[1] < 2 || anHeader[1] > MAX_NODE_CAPACITY ||
+        anHeader[2] > static_cast<GUInt32>(
+                                std::numeric_limits<int>::max() / 2) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s: unsupported version or invalid header", pszFilename);
+        VSIFCloseL(fp);
+        return nullptr;
+    }
+
+    CPLPackedRTree* psTree = new CPLPackedRTree();
+    psTree->nNodeCapacity = static_cast<int>(anHeader[1]);
+    psTree->nItems = static_cast<int>(anHeader[2]);
+    psTree->anLevelBounds = ComputeLevelBounds(psTree->nItems,
+                                               psTree->nNodeCapacity);
+    const size_t nEntries = psTree->anLevelBounds.empty() ? 0 :
+                    static_cast<size_t>(psTree->anLevelBounds.back());
+
+    // Check the file size before allocating.
+    VSIFSeekL(fp, 0, SEEK_END);
+    const vsi_l_offset nExpectedSize = sizeof(SERIALIZATION_MAGIC) +
+        sizeof(anHeader) + nEntries * (4 * sizeof(double) + sizeof(int));
+    bool bOK = VSIFTellL(fp) == nExpectedSize;
+    if( bOK )
+    {
+        try
+        {
+            psTree->adfBoxes.resize(4 * nEntries);
+            psTree->anIndices.resize(nEntries);
+        }
+        catch( const std::exception& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "CPLPackedRTreeLoad(): out of memory");
+            VSIFCloseL(fp);
+            delete psTree;
+            return nullptr;
+        }
+        bOK = VSIFSeekL(fp, sizeof(SERIALIZATION_MAGIC) + sizeof(anHeader),
+                        SEEK_SET) == 0 &&
+              VSIFReadL(psTree->adfBoxes.data(), sizeof(double),
+                        4 * nEntries, fp) == 4 * nEntries &&
+              VSIFReadL(psTree->anIndices.data(), sizeof(int),
+                        nEntries, fp) == nEntries;
+    }
+    VSIFCloseL(fp);
+
+#ifdef CPL_MSB
+    for( auto& dfVal: psTree->adfBoxes )
+        CPL_LSBPTR64(&dfVal);
+    for( auto& nVal: psTree->anIndices )
+        CPL_LSBPTR32(&nVal);
+#endif
+
+    // Check that item indices are valid, and that each node points to the
+    // start of a group of children in the level below it, so that queries
+    // cannot access out of bounds entries.
+    int nLevelStart = 0;
+    for( size_t iLevel = 0; bOK && iLevel < psTree->anLevelBounds.size();
+         ++iLevel )
+    {
+        const int nLevelEnd = psTree->anLevelBounds[iLevel];
+        for( int nPos = nLevelStart; bOK && nPos < nLevelEnd; ++nPos )
+        {
+            const int nVal = psTree->anIndices[nPos];
+            if( iLevel == 0 )
+            {
+                bOK = nVal >= 0 && nVal < psTree->nItems;
+            }
+            else
+            {
+                const int nChildLevelStart =
+                    iLevel == 1 ? 0 : psTree->anLevelBounds[iLevel - 2];
+                bOK = nVal == nChildLevelStart +
+                        (nPos - nLevelStart) * psTree->nNodeCapacity;
+            }
+        }
+        nLevelStart = nLevelEnd;
+    }
+
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s: corrupted packed R-tree file", pszFilename);
+        delete psTree;
+        return nullptr;
+    }
+    return psTree;
+}
@@ -0,0 +1,90 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static, bulk-loaded, packed R-tree
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_PACKED_RTREE_H_INCLUDED
+#define CPL_PACKED_RTREE_H_INCLUDED
+
+#include "cpl_port.h"
+#include "cpl_quad_tree.h"
+
+/**
+ * \file cpl_packed_rtree.h
+ *
+ * Static packed R-tree.
+ *
+ * Contrary to CPLQuadTree, a packed R-tree is built once from the full set
+ * of item bounds, and cannot be modified afterwards. Items are sorted along
+ * a Hilbert curve, and the nodes of all levels are stored in contiguous
+ * arrays, which makes both construction and queries cache friendly.
+ * Items are identified by their index in the array of bounds passed at
+ * creation time.
+ *
+ * @since GDAL 3.4
+ */
+
+CPL_C_START
+
+/** Opaque type for a packed R-tree */
+typedef struct _CPLPackedRTree CPLPackedRTree;
+
+/** CPLPackedRTreeForeachFunc. Return FALSE to stop the iteration. */
+typedef int (*CPLPackedRTreeForeachFunc)(int nItemIdx, void* pUserData);
+
+CPLPackedRTree CPL_DLL *CPLPackedRTreeCreate(int nItems,
+                                             const CPLRectObj* pasBounds,
+                                             int nNodeCapacity);
+void           CPL_DLL  CPLPackedRTreeDestroy(CPLPackedRTree* hTree);
+
+int            CPL_DLL  CPLPackedRTreeGetItemCount(const CPLPackedRTree* hTree);
+void           CPL_DLL  CPLPackedRTreeGetBounds(const CPLPackedRTree* hTree,
+                                                CPLRectObj* pBounds);
+
+int            CPL_DLL *CPLPackedRTreeSearch(const CPLPackedRTree* hTree,
+                                             const CPLRectObj* pAoi,
+                                             int* pnItemCount);
+void           CPL_DLL  CPLPackedRTreeForeach(const CPLPackedRTree* hTree,
+                                              const CPLRectObj* pAoi,
+                                              CPLPackedRTreeForeachFunc pfnForeach,
+                                              void* pUserData);
+int            CPL_DLL *CPLPackedRTreeNearest(const CPLPackedRTree* hTree,
+                                              double dfX, double dfY,
+                                              int nMaxItems,
+                                              double dfMaxDistance,
+                                              int* pnItemCount);
+
+int            CPL_DLL  CPLPackedRTreeSave(const CPLPackedRTree* hTree,
+                                           const char* pszFilename);
+CPLPackedRTree CPL_DLL *CPLPackedRTreeLoad(const char* pszFilename);
+
+/*! @cond Doxygen_Suppress */
+void CPLPackedRTreeCleanup(void);
+/*! @endcond */
+
+CPL_C_END
+
+#endif /* CPL_PACKED_RTREE_H_INCLUDED */
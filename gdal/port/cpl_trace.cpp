@@ -0,0 +1,450 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Low overhead recording of tracing spans
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_json_streaming_writer.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$")
+
+constexpr int TRACE_DETAIL_SIZE = 64;
+
+struct CPLTraceEvent
+{
+    const char* pszCategory;
+    const char* pszName;
+    GIntBig     nStart;
+    GIntBig     nDuration;
+    int         nThreadId;
+    char        szDetail[TRACE_DETAIL_SIZE];
+};
+
+// Ring buffer of the spans recorded by a thread. Only the owning thread
+// writes into it, so its mutex is normally uncontended: it is only needed
+// to let CPLTraceExport() and CPLTraceClear() access it.
+struct CPLTraceThreadBuffer
+{
+    std::mutex                 oMutex{};
+    int                        nThreadId = 0;
+    bool                       bThreadAlive = true;
+    std::vector<CPLTraceEvent> aoEvents{};
+    size_t                     nNext = 0;
+    bool                       bWrapped = false;
+};
+
+// -1: not initialized from CPL_TRACE yet, 0: disabled, 1: enabled
+static std::atomic<int> g_nTraceEnabled{-1};
+
+// Protects the list of buffers and their bThreadAlive/nThreadId members.
+static std::mutex g_oTraceMutex;
+static std::vector<CPLTraceThreadBuffer*>* g_papoTraceBuffers = nullptr;
+static int g_nTraceLastThreadId = 0;
+
+/************************************************************************/
+/*                          CPLTraceIsEnabled()                         */
+/************************************************************************/
+
+/** Return whether spans are recorded.
+ *
+ * On the first call, this is initialized from the CPL_TRACE configuration
+ * option, unless CPLTraceSetEnabled() has been called before.
+ *
+ * @since GDAL 3.4
+ */
+int CPLTraceIsEnabled(void)
+{
+    int nEnabled = g_nTraceEnabled.load(std::memory_order_relaxed);
+    if( nEnabled < 0 )
+    {
+        int nExpected = -1;
+        g_nTraceEnabled.compare_exchange_strong(
+            nExpected, CPLTestBool(CPLGetConfigOption("CPL_TRACE", "NO")));
+        nEnabled = g_nTraceEnabled.load(std::memory_order_relaxed);
+    }
+    return nEnabled;
+}
+
+/************************************************************************/
+/*                          CPLTraceSetEnabled()                        */
+/************************************************************************/
+
+/** Enable or disable recording of spans.
+ *
+ * This overrides the CPL_TRACE configuration option.
+ *
+ * @since GDAL 3.4
+ */
+void CPLTraceSetEnabled(int bEnabled)
+{
+    g_nTraceEnabled = bEnabled ? 1 : 0;
+}
+
+/************************************************************************/
+/*                        CPLTraceGetTimestamp()                        */
+/************************************************************************/
+
+/** Return a monotonic timestamp in micro-seconds, suitable for
+ * CPLTraceRecordSpan().
+ *
+ * @since GDAL 3.4
+ */
+GIntBig CPLTraceGetTimestamp(void)
+{
+    return static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/************************************************************************/
+/*                     CPLTraceThreadBufferRelease()                    */
+/************************************************************************/
+
+// Called at thread exit: the buffer is kept, so that its spans can be
+// exported, and can be reused by a new thread.
+static void CPLTraceThreadBufferRelease(void* pData)
+{
+    std::lock_guard<std::mutex> oLock(g_oTraceMutex);
+    if( g_papoTraceBuffers == nullptr )
+        return;
+    for( auto poBuffer: *g_papoTraceBuffers )
+    {
+        if( poBuffer == pData )
+        {
+            poBuffer->bThreadAlive = false;
+            break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                      CPLTraceGetThreadBuffer()                       */
+/************************************************************************/
+
+static CPLTraceThreadBuffer* CPLTraceGetThreadBuffer()
+{
+    int bMemoryError = FALSE;
+    auto poBuffer = static_cast<CPLTraceThreadBuffer*>(
+        CPLGetTLSEx(CTLS_TRACEBUFFER, &bMemoryError));
+    if( bMemoryError )
+        return nullptr;
+    if( poBuffer )
+        return poBuffer;
+
+    {
+        std::lock_guard<std::mutex> oLock(g_oTraceMutex);
+        if( g_papoTraceBuffers == nullptr )
+            g_papoTraceBuffers = new std::vector<CPLTraceThreadBuffer*>();
+        for( auto poIter: *g_papoTraceBuffers )
+        {
+            if( !poIter->bThreadAlive )
+            {
+                poBuffer = poIter;
+                break;
+            }
+        }
+        if( poBuffer == nullptr )
+        {
+            const int nSize = std::max(1, atoi(
+                CPLGetConfigOption("CPL_TRACE_BUFFER_SIZE", "16384")));
+            poBuffer = new CPLTraceThreadBuffer();
+            try
+            {
+                poBuffer->aoEvents.resize(nSize);
+            }
+            catch( const std::exception& )
+            {
+                delete poBuffer;
+                return nullptr;
+            }
+            g_papoTraceBuffers->push_back(poBuffer);
+        }
+        poBuffer->bThreadAlive = true;
+        poBuffer->nThreadId = ++g_nTraceLastThreadId;
+    }
+
+    CPLSetTLSWithFreeFunc(CTLS_TRACEBUFFER, poBuffer,
+                          CPLTraceThreadBufferRelease);
+    return poBuffer;
+}
+
+/************************************************************************/
+/*                         CPLTraceRecordSpan()                         */
+/************************************************************************/
+
+/** Record a span in the buffer of the current thread.
+ *
+ * This is a no-op if tracing is disabled. CPLTraceSpan should generally be
+ * used instead.
+ *
+ * @param pszCategory category. Must have static storage duration.
+ * @param pszName name. Must have static storage duration.
+ * @param pszDetail detail, or NULL. Copied and possibly truncated.
+ * @param nStartMicroSec start, as returned by CPLTraceGetTimestamp()
+ * @param nEndMicroSec end, as returned by CPLTraceGetTimestamp()
+ *
+ * @since GDAL 3.4
+ */
+void CPLTraceRecordSpan(const char* pszCategory,
+                        const char* pszName,
+                        const char* pszDetail,
+                        GIntBig nStartMicroSec,
+                        GIntBig nEndMicroSec)
+{
+    if( !CPLTraceIsEnabled() )
+        return;
+    CPLTraceThreadBuffer* poBuffer = CPLTraceGetThreadBuffer();
+    if( poBuffer == nullptr )
+        return;
+
+    std::lock_guard<std::mutex> oLock(poBuffer->oMutex);
+    CPLTraceEvent& oEvent = poBuffer->aoEvents[poBuffer->nNext];
+    oEvent.pszCategory = pszCategory;
+    oEvent.pszName = pszName;
+    oEvent.nStart = nStartMicroSec;
+    oEvent.nDuration = nEndMicroSec - nStartMicroSec;
+    oEvent.nThreadId = poBuffer->nThreadId;
+    CPLStrlcpy(oEvent.szDetail, pszDetail ? pszDetail : "",
+               sizeof(oEvent.szDetail));
+    poBuffer->nNext++;
+    if( poBuffer->nNext == poBuffer->aoEvents.size() )
+    {
+        poBuffer->nNext = 0;
+        poBuffer->bWrapped = true;
+    }
+}
+
+#ifndef CPL_TRACE_DISABLED
+
+/************************************************************************/
+/*                      CPLTraceSpan::SetDetail()                       */
+/************************************************************************/
+
+/** Set the detail of the span (copied and possibly truncated). */
+void CPLTraceSpan::SetDetail(const char* pszDetail)
+{
+    if( m_nStart >= 0 )
+        CPLStrlcpy(m_szDetail, pszDetail, sizeof(m_szDetail));
+}
+
+/************************************************************************/
+/*                      CPLTraceSpan::SetDetailf()                      */
+/************************************************************************/
+
+/** Set the detail of the span, with a printf()-like format. */
+void CPLTraceSpan::SetDetailf(CPL_FORMAT_STRING(const char* pszFormat), ...)
+{
+    if( m_nStart < 0 )
+        return;
+    va_list args;
+    va_start(args, pszFormat);
+    CPLvsnprintf(m_szDetail, sizeof(m_szDetail), pszFormat, args);
+    va_end(args);
+}
+
+#endif
+
+/************************************************************************/
+/*                           CPLTraceExport()                           */
+/************************************************************************/
+
+static void CPLTraceWriteFunc(const char* pszTxt, void* pUserData)
+{
+    VSILFILE* fp = static_cast<VSILFILE*>(pUserData);
+    VSIFWriteL(pszTxt, 1, strlen(pszTxt), fp);
+}
+
+/** Export the spans currently recorded by all threads to a file in the
+ * Chrome trace event JSON format.
+ *
+ * Recording can continue during the export.
+ *
+ * @param pszFilename output filename.
+ * @return TRUE in case of success.
+ *
+ * @since GDAL 3.4
+ */
+int CPLTraceExport(const char* pszFilename)
+{
+    std::vector<CPLTraceEvent> aoEvents;
+    {
+        std::lock_guard<std::mutex> oLock(g_oTraceMutex);
+        if( g_papoTraceBuffers )
+        {
+            for( auto poBuffer: *g_papoTraceBuffers )
+            {
+                std::lock_guard<std::mutex> oLockBuffer(poBuffer->oMutex);
+                if( poBuffer->bWrapped )
+                {
+                    aoEvents.insert(aoEvents.end(),
+                        poBuffer->aoEvents.begin() + poBuffer->nNext,
+                        poBuffer->aoEvents.end());
+                }
+                aoEvents.insert(aoEvents.end(),
+                    poBuffer->aoEvents.begin(),
+                    poBuffer->aoEvents.begin() + poBuffer->nNext);
+            }
+        }
+    }
+
+    VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename);
+        return FALSE;
+    }
+
+    {
+        CPLJSonStreamingWriter oWriter(CPLTraceWriteFunc, fp);
+        oWriter.SetPrettyFormatting(false);
+        auto oRoot = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("traceEvents");
+        {
+            auto oArray = oWriter.MakeArrayContext();
+            for( const auto& oEvent: aoEvents )
+            {
+                auto oObj = oWriter.MakeObjectContext();
+                oWriter.AddObjKey("name");
+                oWriter.Add(oEvent.pszName);
+                oWriter.AddObjKey("cat");
+                oWriter.Add(oEvent.pszCategory);
+                oWriter.AddObjKey("ph");
+                oWriter.Add("X");
+                oWriter.AddObjKey("ts");
+                oWriter.Add(oEvent.nStart);
+                oWriter.AddObjKey("dur");
+                oWriter.Add(oEvent.nDuration);
+                oWriter.AddObjKey("pid");
+                oWriter.Add(1);
+                oWriter.AddObjKey("tid");
+                oWriter.Add(oEvent.nThreadId);
+                if( oEvent.szDetail[0] )
+                {
+                    oWriter.AddObjKey("args");
+                    auto oArgs = oWriter.MakeObjectContext();
+                    oWriter.AddObjKey("detail");
+                    oWriter.Add(oEvent.szDetail);
+                }
+            }
+        }
+        oWriter.AddObjKey("displayTimeUnit");
+        oWriter.Add("ms");
+    }
+
+    return VSIFCloseL(fp) == 0;
+}
+
+/************************************************************************/
+/*                            CPLTraceClear()                           */
+/************************************************************************/
+
+/** Discard the spans recorded so far by all threads.
+ *
+ * @since GDAL 3.4
+ */
+void CPLTraceClear(void)
+{
+    std::lock_guard<std::mutex> oLock(g_oTraceMutex);
+    if( g_papoTraceBuffers == nullptr )
+        return;
+    for( auto poBuffer: *g_papoTraceBuffers )
+    {
+        std::lock_guard<std::mutex> oLockBuffer(poBuffer->oMutex);
+        poBuffer->nNext = 0;
+        poBuffer->bWrapped = false;
+    }
+}
+
+/************************************************************************/
+/*                           CPLTraceCleanup()                          */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+
+// Called by GDALDestroyDriverManager(): exports spans to CPL_TRACE_FILE if
+// set, and frees the buffers that are no longer in use.
+void CPLTraceCleanup(void)
+{
+    const char* pszTraceFile = CPLGetConfigOption("CPL_TRACE_FILE", nullptr);
+    if( pszTraceFile != nullptr )
+        CPLTraceExport(pszTraceFile);
+
+    int bMemoryError = FALSE;
+    void* pCurrentBuffer = CPLGetTLSEx(CTLS_TRACEBUFFER, &bMemoryError);
+    if( pCurrentBuffer )
+        CPLSetTLS(CTLS_TRACEBUFFER, nullptr, FALSE);
+
+    {
+        std::lock_guard<std::mutex> oLock(g_oTraceMutex);
+        if( g_papoTraceBuffers != nullptr )
+        {
+            // Buffers of threads still alive are kept, as they may record
+            // again.
+            std::vector<CPLTraceThreadBuffer*> apoKept;
+            for( auto poBuffer: *g_papoTraceBuffers )
+            {
+                if( poBuffer->bThreadAlive && poBuffer != pCurrentBuffer )
+                {
+                    std::lock_guard<std::mutex> oLockBuffer(poBuffer->oMutex);
+                    poBuffer->nNext = 0;
+                    poBuffer->bWrapped = false;
+                    apoKept.push_back(poBuffer);
+                }
+                else
+                {
+                    delete poBuffer;
+                }
+            }
+            if( apoKept.empty() )
+            {
+                delete g_papoTraceBuffers;
+                g_papoTraceBuffers = nullptr;
+            }
+            else
+            {
+                *g_papoTraceBuffers = std::move(apoKept);
+            }
+        }
+    }
+
+    g_nTraceEnabled = -1;
+}
+
+/*! @endcond */
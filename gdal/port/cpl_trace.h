@@ -0,0 +1,145 @@
+/**********************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Low overhead recording of tracing spans
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ **********************************************************************
+ * Copyright (c) 2021, Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_TRACE_H_INCLUDED
+#define CPL_TRACE_H_INCLUDED
+
+#include "cpl_port.h"
+
+/**
+ * \file cpl_trace.h
+ *
+ * Recording of tracing spans.
+ *
+ * Spans are recorded in per-thread ring buffers, only when tracing is
+ * enabled, either with the CPL_TRACE=ON configuration option or
+ * CPLTraceSetEnabled(). They can be exported in the Chrome trace event JSON
+ * format (that can be loaded in chrome://tracing or https://ui.perfetto.dev)
+ * with CPLTraceExport(), or automatically at GDALDestroyDriverManager() time
+ * in the file pointed by the CPL_TRACE_FILE configuration option.
+ *
+ * The size of each per-thread ring buffer, in number of spans, is controlled
+ * by the CPL_TRACE_BUFFER_SIZE configuration option (default 16384). Older
+ * spans are overwritten when the buffer is full.
+ *
+ * When GDAL is built with the CPL_TRACE_DISABLED macro defined, the
+ * CPLTraceSpan class compiles to nothing.
+ *
+ * @since GDAL 3.4
+ */
+
+CPL_C_START
+
+int CPL_DLL CPLTraceIsEnabled(void);
+void CPL_DLL CPLTraceSetEnabled(int bEnabled);
+void CPL_DLL CPLTraceRecordSpan(const char* pszCategory,
+                                const char* pszName,
+                                const char* pszDetail,
+                                GIntBig nStartMicroSec,
+                                GIntBig nEndMicroSec);
+GIntBig CPL_DLL CPLTraceGetTimestamp(void);
+int CPL_DLL CPLTraceExport(const char* pszFilename);
+void CPL_DLL CPLTraceClear(void);
+
+/*! @cond Doxygen_Suppress */
+void CPLTraceCleanup(void);
+/*! @endcond */
+
+CPL_C_END
+
+#if defined(__cplusplus) && !defined(CPL_SUPRESS_CPLUSPLUS)
+
+/************************************************************************/
+/*                            CPLTraceSpan                              */
+/************************************************************************/
+
+/** RAII helper recording a span from its construction to its destruction,
+ * when tracing is enabled.
+ *
+ * pszCategory and pszName must be strings with static storage duration,
+ * typically literals, as they are not copied. The optional detail string is
+ * copied (and possibly truncated).
+ *
+ * @since GDAL 3.4
+ */
+#ifdef CPL_TRACE_DISABLED
+class CPLTraceSpan
+{
+    CPL_DISALLOW_COPY_ASSIGN(CPLTraceSpan)
+
+  public:
+    CPLTraceSpan(const char*, const char*) {}
+    bool IsActive() const { return false; }
+    void SetName(const char*) {}
+    void SetDetail(const char*) {}
+    void SetDetailf(CPL_FORMAT_STRING(const char*), ...)
+        CPL_PRINT_FUNC_FORMAT (2, 3) {}
+};
+#else
+class CPL_DLL CPLTraceSpan
+{
+    CPL_DISALLOW_COPY_ASSIGN(CPLTraceSpan)
+
+    const char* m_pszCategory;
+    const char* m_pszName;
+    GIntBig     m_nStart = -1;
+    char        m_szDetail[64];
+
+  public:
+    /** Start a span, if tracing is enabled. */
+    CPLTraceSpan(const char* pszCategory, const char* pszName):
+        m_pszCategory(pszCategory), m_pszName(pszName)
+    {
+        m_szDetail[0] = '\0';
+        if( CPLTraceIsEnabled() )
+            m_nStart = CPLTraceGetTimestamp();
+    }
+
+    /** Record the span, if it was started. */
+    ~CPLTraceSpan()
+    {
+        if( m_nStart >= 0 )
+            CPLTraceRecordSpan(m_pszCategory, m_pszName, m_szDetail,
+                               m_nStart, CPLTraceGetTimestamp());
+    }
+
+    /** Return whether the span will be recorded. */
+    bool IsActive() const { return m_nStart >= 0; }
+
+    /** Change the name of the span (must have static storage duration). */
+    void SetName(const char* pszName) { m_pszName = pszName; }
+
+    void SetDetail(const char* pszDetail);
+    void SetDetailf(CPL_FORMAT_STRING(const char* pszFormat), ...)
+        CPL_PRINT_FUNC_FORMAT (2, 3);
+};
+#endif
+
+#endif /* defined(__cplusplus) && !defined(CPL_SUPRESS_CPLUSPLUS) */
+
+#endif /* CPL_TRACE_H_INCLUDED */
@@ -253,6 +253,13 @@ void CPL_DLL   *VSIMallocAlignedAutoVerbose( size_t nSize, const char* pszFile,
 /** VSIMallocAlignedAutoVerbose() with FILE and LINE reporting */
 #define VSI_MALLOC_ALIGNED_AUTO_VERBOSE( size ) VSIMallocAlignedAutoVerbose(size,__FILE__,__LINE__)
 
+void CPL_DLL   *VSIMallocLarge( size_t nSize ) CPL_WARN_UNUSED_RESULT;
+void CPL_DLL    VSIFreeLarge( void* ptr );
+
+void CPL_DLL   *VSIMallocLargeVerbose( size_t nSize, const char* pszFile, int nLine ) CPL_WARN_UNUSED_RESULT;
+/** VSIMallocLargeVerbose() with FILE and LINE reporting */
+#define VSI_MALLOC_LARGE_VERBOSE( size ) VSIMallocLargeVerbose(size,__FILE__,__LINE__)
+
 /**
  VSIMalloc2 allocates (nSize1 * nSize2) bytes.
  In case of overflow of the multiplication, or if memory allocation fails, a
@@ -389,6 +396,8 @@ void CPL_DLL VSIInstallSubFileHandler(void);
 void VSIInstallCurlFileHandler(void);
 void CPL_DLL VSICurlClearCache(void);
 void CPL_DLL VSICurlPartialClearCache(const char* pszFilenamePrefix);
+void CPL_DLL VSICurlGetRegionCacheStatistics(GIntBig* pnHits,
+                                             GIntBig* pnMisses);
 void VSIInstallCurlStreamingFileHandler(void);
 void VSIInstallS3FileHandler(void);
 void VSIInstallS3StreamingFileHandler(void);
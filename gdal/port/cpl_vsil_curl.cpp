@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <set>
 #include <map>
 #include <memory>
@@ -43,6 +44,7 @@
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_virtual.h"
 #include "cpl_http.h"
@@ -79,6 +81,12 @@ void VSICurlPartialClearCache(const char* )
     // Not supported.
 }
 
+void VSICurlGetRegionCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses )
+{
+    *pnHits = 0;
+    *pnMisses = 0;
+}
+
 void VSICurlAuthParametersChanged()
 {
     // Not supported.
@@ -131,6 +139,10 @@ int VSICurlUninstallReadCbk( VSILFILE* /* fp */ )
 
 static unsigned int gnGenerationAuthParameters = 0;
 
+// Statistics of the region cache, shared by all network file systems
+static std::atomic<GIntBig> gnRegionCacheHits{0};
+static std::atomic<GIntBig> gnRegionCacheMisses{0};
+
 void VSICurlAuthParametersChanged()
 {
     gnGenerationAuthParameters++;
@@ -801,6 +813,19 @@ void MultiPerform(CURLM* hCurlMultiHandle, CURL* hEasyHandle)
 {
     int repeats = 0;
 
+    CPLTraceSpan oTraceSpan("vsi", "VSICurlRequest");
+    if( oTraceSpan.IsActive() && hEasyHandle )
+    {
+        char* pszURL = nullptr;
+        curl_easy_getinfo(hEasyHandle, CURLINFO_EFFECTIVE_URL, &pszURL);
+        if( pszURL )
+        {
+            // Keep the end of long URLs, which is the most specific part.
+            const size_t nLen = strlen(pszURL);
+            oTraceSpan.SetDetail(nLen > 63 ? pszURL + nLen - 63 : pszURL);
+        }
+    }
+
     if( hEasyHandle )
         curl_multi_add_handle(hCurlMultiHandle, hEasyHandle);
 
@@ -1806,10 +1831,12 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
         std::shared_ptr<std::string> psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
         if( psRegion != nullptr )
         {
+            gnRegionCacheHits.fetch_add(1, std::memory_order_relaxed);
             osRegion = *psRegion;
         }
         else
         {
+            gnRegionCacheMisses.fetch_add(1, std::memory_order_relaxed);
             if( nOffsetToDownload == lastDownloadedOffset )
             {
                 // In case of consecutive reads (of small size), we use a
@@ -5064,6 +5091,25 @@ void VSICurlPartialClearCache(const char* pszFilenamePrefix)
         poFSHandler->PartialClearCache(pszFilenamePrefix);
 }
 
+/************************************************************************/
+/*                   VSICurlGetRegionCacheStatistics()                  */
+/************************************************************************/
+
+/**
+ * \brief Return statistics on the cache of downloaded regions of /vsicurl/
+ * (and related file systems)
+ *
+ * @param pnHits Pointer to the number of reads served from the cache.
+ * @param pnMisses Pointer to the number of reads that required a download.
+ * @since GDAL 3.4
+ */
+
+void VSICurlGetRegionCacheStatistics( GIntBig* pnHits, GIntBig* pnMisses )
+{
+    *pnHits = gnRegionCacheHits;
+    *pnMisses = gnRegionCacheMisses;
+}
+
 /************************************************************************/
 /*                        VSINetworkStatsReset()                        */
 /************************************************************************/
@@ -103,6 +103,15 @@ CPL_CVSID("$Id$")
 #  include <direct.h>
 #endif
 
+#if defined(__linux__) && defined(HAVE_MMAP)
+#include <sys/mman.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include "cpl_numa.h"
+#define HAVE_VSI_MALLOC_LARGE_MMAP
+#endif
+
 /************************************************************************/
 /*                              VSIFOpen()                              */
 /************************************************************************/
@@ -987,6 +996,237 @@ void VSIFreeAligned( void* ptr )
 #endif
 }
 
+/************************************************************************/
+/*                           VSIMallocLarge()                           */
+/************************************************************************/
+
+#ifdef HAVE_VSI_MALLOC_LARGE_MMAP
+
+// Sizes of the mappings returned by VSIMallocLarge(). Other buffers are
+// allocated with VSIMallocAlignedAuto().
+static std::mutex goMutexLargeMappings;
+static std::map<void*, size_t> goMapLargeMappings;
+// Number of elements of goMapLargeMappings, to avoid taking the mutex
+// when freeing heap buffers while there is no mapping.
+static std::atomic<int> gnLargeMappings{0};
+
+// Minimum size of a buffer for it to be placed on the NUMA node of the
+// allocating thread. Below that, the cost of a mapping is not worth it.
+constexpr size_t VSI_LARGE_NUMA_MIN_SIZE = 64 * 1024;
+
+static size_t VSIGetHugePageSize()
+{
+    static const size_t nHugePageSize = []()
+    {
+        size_t nRet = 2 * 1024 * 1024;
+        FILE* fp = fopen("/proc/meminfo", "rb");
+        if( fp )
+        {
+            char szLine[256];
+            while( fgets(szLine, sizeof(szLine), fp) )
+            {
+                if( STARTS_WITH(szLine, "Hugepagesize:") )
+                {
+                    const int nKB = atoi(szLine + strlen("Hugepagesize:"));
+                    if( nKB > 0 )
+                        nRet = static_cast<size_t>(nKB) * 1024;
+                    break;
+                }
+            }
+            fclose(fp);
+        }
+        return nRet;
+    }();
+    return nHugePageSize;
+}
+
+// Create an anonymous mapping of at least nSize bytes, using huge pages if
+// requested, and whose start is aligned on nAlignment (power of two).
+static void* VSIMapLarge( size_t nSize, size_t nAlignment, bool bExplicitHuge,
+                          size_t& nMapSize )
+{
+#ifdef MAP_HUGETLB
+    if( bExplicitHuge )
+    {
+        nMapSize = (nSize + nAlignment - 1) & ~(nAlignment - 1);
+        void* pRet = mmap(nullptr, nMapSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if( pRet != MAP_FAILED )
+            return pRet;
+        static std::atomic<bool> bWarned{false};
+        if( !bWarned.exchange(true) )
+        {
+            CPLDebug("VSI", "Cannot allocate explicit huge pages. "
+                     "Falling back to transparent huge pages");
+        }
+    }
+#else
+    CPL_IGNORE_RET_VAL(bExplicitHuge);
+#endif
+
+    // Over-allocate, and trim the unaligned head and the tail.
+    const size_t nSizeRounded = (nSize + nAlignment - 1) & ~(nAlignment - 1);
+    if( nSizeRounded < nSize || nSizeRounded + nAlignment < nSizeRounded )
+        return nullptr;
+    const size_t nPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t nExtra = nAlignment > nPageSize ? nAlignment : 0;
+    GByte* pabyMap = static_cast<GByte*>(
+        mmap(nullptr, nSizeRounded + nExtra, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if( pabyMap == MAP_FAILED )
+        return nullptr;
+    const size_t nHead = nExtra == 0 ? 0 :
+        (nAlignment - reinterpret_cast<size_t>(pabyMap) % nAlignment)
+            % nAlignment;
+    if( nHead )
+        munmap(pabyMap, nHead);
+    if( nExtra - nHead )
+        munmap(pabyMap + nHead + nSizeRounded, nExtra - nHead);
+    nMapSize = nSizeRounded;
+    return pabyMap + nHead;
+}
+
+#endif // HAVE_VSI_MALLOC_LARGE_MMAP
+
+/** Allocates a large buffer, such as a block cache or warping buffer.
+ *
+ * The returned buffer is aligned like with VSIMallocAlignedAuto(). It must be
+ * freed with VSIFreeLarge().
+ *
+ * On Linux, the following configuration options control the placement of
+ * the buffer:
+ * <ul>
+ * <li>CPL_HUGE_PAGES=NO/TRANSPARENT/EXPLICIT. Defaults to NO. When set to
+ * TRANSPARENT, buffers of at least the huge page size are mapped at an
+ * address aligned on the huge page size, and are marked as candidates for
+ * transparent huge pages (if they are enabled in "madvise" mode or
+ * "always" mode). When set to EXPLICIT, such buffers are allocated from the
+ * pool of reserved huge pages (/proc/sys/vm/nr_hugepages), falling back to
+ * TRANSPARENT when it is exhausted.</li>
+ * <li>CPL_NUMA_LOCAL_ALLOC=YES/NO. Defaults to NO. When set to YES on
+ * a system with several NUMA nodes, buffers of at least 64 KB are
+ * mapped with a preference for the NUMA node of the calling thread, which is
+ * supposed to be the one that will use them. This is typically combined with
+ * GDAL_THREAD_PINNING=NUMA.</li>
+ * </ul>
+ *
+ * On other platforms, or with default settings, this is equivalent to
+ * VSIMallocAlignedAuto().
+ *
+ * @param nSize Size of the buffer to allocate.
+ * @return a buffer of size nSize, or NULL
+ * @since GDAL 3.4
+ */
+
+void* VSIMallocLarge( size_t nSize )
+{
+#ifdef HAVE_VSI_MALLOC_LARGE_MMAP
+    if( nSize >= VSI_LARGE_NUMA_MIN_SIZE )
+    {
+        const char* pszHugePages = CPLGetConfigOption("CPL_HUGE_PAGES", "NO");
+        const bool bHugePages =
+            nSize >= VSIGetHugePageSize() &&
+            (EQUAL(pszHugePages, "TRANSPARENT") ||
+             EQUAL(pszHugePages, "EXPLICIT"));
+        const bool bNUMALocal =
+            CPLTestBool(CPLGetConfigOption("CPL_NUMA_LOCAL_ALLOC", "NO")) &&
+            CPLGetNUMANodeCount() > 1;
+        if( bHugePages || bNUMALocal )
+        {
+            size_t nMapSize = 0;
+            GByte* pabyBase = static_cast<GByte*>(VSIMapLarge(
+                nSize,
+                bHugePages ? VSIGetHugePageSize() :
+                             static_cast<size_t>(sysconf(_SC_PAGESIZE)),
+                bHugePages && EQUAL(pszHugePages, "EXPLICIT"),
+                nMapSize));
+            if( pabyBase == nullptr )
+                return nullptr;
+#ifdef MADV_HUGEPAGE
+            if( bHugePages )
+                madvise(pabyBase, nMapSize, MADV_HUGEPAGE);
+#endif
+            if( bNUMALocal )
+            {
+                const int iNode = CPLGetCurrentNUMANode();
+                if( iNode >= 0 )
+                    CPLBindMemoryToNUMANode(pabyBase, nMapSize, iNode);
+            }
+            try
+            {
+                std::lock_guard<std::mutex> oLock(goMutexLargeMappings);
+                goMapLargeMappings[pabyBase] = nMapSize;
+                gnLargeMappings++;
+            }
+            catch( const std::exception& )
+            {
+                munmap(pabyBase, nMapSize);
+                return nullptr;
+            }
+            return pabyBase;
+        }
+    }
+
+#endif
+    return VSIMallocAlignedAuto(nSize);
+}
+
+/************************************************************************/
+/*                        VSIMallocLargeVerbose()                       */
+/************************************************************************/
+
+/** See VSIMallocLarge() */
+void *VSIMallocLargeVerbose( size_t nSize, const char* pszFile, int nLine )
+{
+    void* pRet = VSIMallocLarge(nSize);
+    if( pRet == nullptr && nSize != 0 )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "%s, %d: cannot allocate " CPL_FRMT_GUIB " bytes",
+                 pszFile ? pszFile : "(unknown file)",
+                 nLine, static_cast<GUIntBig>(nSize));
+    }
+    return pRet;
+}
+
+/************************************************************************/
+/*                            VSIFreeLarge()                            */
+/************************************************************************/
+
+/** Free a buffer allocated with VSIMallocLarge().
+ *
+ * @param ptr Buffer to free.
+ * @since GDAL 3.4
+ */
+
+void VSIFreeLarge( void* ptr )
+{
+#ifdef HAVE_VSI_MALLOC_LARGE_MMAP
+    if( ptr == nullptr )
+        return;
+    if( gnLargeMappings > 0 )
+    {
+        size_t nMapSize = 0;
+        {
+            std::lock_guard<std::mutex> oLock(goMutexLargeMappings);
+            auto oIter = goMapLargeMappings.find(ptr);
+            if( oIter != goMapLargeMappings.end() )
+            {
+                nMapSize = oIter->second;
+                goMapLargeMappings.erase(oIter);
+                gnLargeMappings--;
+            }
+        }
+        if( nMapSize )
+        {
+            munmap(ptr, nMapSize);
+            return;
+        }
+    }
+#endif
+    VSIFreeAligned(ptr);
+}
+
 /************************************************************************/
 /*                             VSIStrdup()                              */
 /************************************************************************/
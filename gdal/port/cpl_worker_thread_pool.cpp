@@ -29,22 +29,37 @@
 #include "cpl_port.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <chrono>
+#include <climits>
 #include <cstddef>
 #include <memory>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_numa.h"
 #include "cpl_vsi.h"
 
-
 CPL_CVSID("$Id$")
 
 struct CPLWorkerThreadJob
 {
     CPLThreadFunc  pfnFunc;
     void          *pData;
+    CPLJobQueue   *poQueue; // may be null
 };
 
+// Values of CPLWorkerThread::nPinningMode
+constexpr int PINNING_NONE = 0;
+constexpr int PINNING_NUMA = 1;
+constexpr int PINNING_CPU = 2;
+
+// Index of the CPU or NUMA node to which the next pinned worker thread,
+// of any pool, is bound.
+static std::atomic<int> gnNextPinningIndex{0};
+
+// Worker thread (and its pool) running the current thread, if any.
+static thread_local CPLWorkerThread* tls_psCurrentWorkerThread = nullptr;
+
 /************************************************************************/
 /*                         CPLWorkerThreadPool()                        */
 /************************************************************************/
@@ -87,6 +102,18 @@ CPLWorkerThreadPool::~CPLWorkerThreadPool()
     CPLListDestroy(psWaitingWorkerThreadsList);
 }
 
+/************************************************************************/
+/*                      GetCurrentWorkerThread()                        */
+/************************************************************************/
+
+// Return the worker thread structure of the calling thread, if it is a
+// worker thread of this pool.
+CPLWorkerThread* CPLWorkerThreadPool::GetCurrentWorkerThread() const
+{
+    CPLWorkerThread* psWT = tls_psCurrentWorkerThread;
+    return psWT && psWT->poTP == this ? psWT : nullptr;
+}
+
 /************************************************************************/
 /*                       WorkerThreadFunction()                         */
 /************************************************************************/
@@ -95,6 +122,19 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
 {
     CPLWorkerThread* psWT = static_cast<CPLWorkerThread*>(user_data);
     CPLWorkerThreadPool* poTP = psWT->poTP;
+    tls_psCurrentWorkerThread = psWT;
+
+    if( psWT->nPinningMode == PINNING_NUMA )
+    {
+        // Workers are spread in a round-robin way over the NUMA nodes, and
+        // can run on any CPU of their node.
+        CPLBindCurrentThreadToNUMANode(
+            psWT->nPinningIndex % CPLGetNUMANodeCount());
+    }
+    else if( psWT->nPinningMode == PINNING_CPU )
+    {
+        CPLBindCurrentThreadToCPU(psWT->nPinningIndex);
+    }
 
     if( psWT->pfnInitFunc )
         psWT->pfnInitFunc( psWT->pInitData );
@@ -105,29 +145,55 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
         if( psJob == nullptr )
             break;
 
-        if( psJob->pfnFunc )
-        {
-            psJob->pfnFunc(psJob->pData);
-        }
-        CPLFree(psJob);
+        // Jobs run by nested WaitCompletion() calls are accounted in the
+        // busy time of the job that waits.
+        const auto nStart = std::chrono::steady_clock::now();
+        poTP->RunJob(psJob);
+        poTP->m_nBusyTimeMicroSec.fetch_add(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - nStart).count(),
+            std::memory_order_relaxed);
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "%p finished a job", psWT);
 #endif
-        poTP->DeclareJobFinished();
     }
 }
 
+/************************************************************************/
+/*                               RunJob()                               */
+/************************************************************************/
+
+void CPLWorkerThreadPool::RunJob(CPLWorkerThreadJob* psJob)
+{
+    if( psJob->pfnFunc )
+    {
+        psJob->pfnFunc(psJob->pData);
+    }
+    CPLFree(psJob);
+    m_nCompletedJobs.fetch_add(1, std::memory_order_relaxed);
+    DeclareJobFinished();
+}
+
 /************************************************************************/
 /*                             SubmitJob()                              */
 /************************************************************************/
 
 /** Queue a new job.
+ *
+ * When called from one of the worker threads of the pool, the job is queued
+ * in the queue of that thread, from which idle threads may steal it.
  *
  * @param pfnFunc Function to run for the job.
  * @param pData User data to pass to the job function.
  * @return true in case of success.
  */
 bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+{
+    return SubmitJob(pfnFunc, pData, nullptr);
+}
+
+bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData,
+                                     CPLJobQueue* poQueue )
 {
     CPLAssert( !aWT.empty() );
 
@@ -137,50 +203,25 @@ bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
         return false;
     psJob->pfnFunc = pfnFunc;
     psJob->pData = pData;
+    psJob->poQueue = poQueue;
 
-    CPLList* psItem =
-        static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-    if( psItem == nullptr )
-    {
-        VSIFree(psJob);
-        return false;
-    }
-    psItem->pData = psJob;
-
+    CPLWorkerThread* psCurWT = GetCurrentWorkerThread();
     std::unique_lock<std::mutex> oGuard(m_mutex);
-
-    psItem->psNext = psJobQueue;
-    psJobQueue = psItem;
+    // The job must be counted before it is published: another worker thread
+    // may steal it and complete it as soon as it is in a queue.
     nPendingJobs++;
-
-    if( psWaitingWorkerThreadsList )
+    m_nQueuedJobs++;
+    if( psCurWT )
     {
-        CPLWorkerThread* psWorkerThread =
-            static_cast<CPLWorkerThread *>(psWaitingWorkerThreadsList->pData);
-
-        CPLAssert( psWorkerThread->bMarkedAsWaiting );
-        psWorkerThread->bMarkedAsWaiting = false;
-
-        CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-        CPLList* psToFree = psWaitingWorkerThreadsList;
-        psWaitingWorkerThreadsList = psNext;
-        nWaitingWorkerThreads--;
-
-        // CPLAssert(
-        //   CPLListCount(psWaitingWorkerThreadsList) == nWaitingWorkerThreads);
-
-#if DEBUG_VERBOSE
-        CPLDebug("JOB", "Waking up %p", psWorkerThread);
-#endif
-
-        {
-            std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-            oGuard.unlock();
-            psWorkerThread->m_cv.notify_one();
-        }
-
-        CPLFree(psToFree);
+        std::lock_guard<std::mutex> oGuardJobs(psCurWT->m_mutexJobs);
+        psCurWT->m_apsJobs.push_back(psJob);
     }
+    else
+    {
+        m_apsJobs.push_back(psJob);
+    }
+
+    WakeUpWaitingWorkerThreads(1, oGuard);
 
     return true;
 }
@@ -200,90 +241,84 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 {
     CPLAssert( !aWT.empty() );
 
-    std::unique_lock<std::mutex> oGuard(m_mutex);
-
-    CPLList* psJobQueueInit = psJobQueue;
-    bool bRet = true;
-
+    std::vector<CPLWorkerThreadJob*> apsJobs;
     for(size_t i=0;i<apData.size();i++)
     {
         CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob*>(
             VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
         if( psJob == nullptr )
         {
-            bRet = false;
-            break;
+            for( auto psJobToFree: apsJobs )
+                VSIFree(psJobToFree);
+            return false;
         }
         psJob->pfnFunc = pfnFunc;
         psJob->pData = apData[i];
-
-        CPLList* psItem =
-            static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-        if( psItem == nullptr )
-        {
-            VSIFree(psJob);
-            bRet = false;
-            break;
-        }
-        psItem->pData = psJob;
-
-        psItem->psNext = psJobQueue;
-        psJobQueue = psItem;
-        nPendingJobs++;
+        psJob->poQueue = nullptr;
+        apsJobs.push_back(psJob);
     }
 
-    if( !bRet )
+    CPLWorkerThread* psCurWT = GetCurrentWorkerThread();
+    std::unique_lock<std::mutex> oGuard(m_mutex);
+    // Count the jobs before they are published (see SubmitJob())
+    nPendingJobs += static_cast<int>(apsJobs.size());
+    m_nQueuedJobs += static_cast<int>(apsJobs.size());
+    if( psCurWT )
     {
-        for( CPLList* psIter = psJobQueue; psIter != psJobQueueInit; )
-        {
-            CPLList* psNext = psIter->psNext;
-            VSIFree(psIter->pData);
-            VSIFree(psIter);
-            nPendingJobs--;
-            psIter = psNext;
-        }
-        return false;
+        std::lock_guard<std::mutex> oGuardJobs(psCurWT->m_mutexJobs);
+        psCurWT->m_apsJobs.insert(psCurWT->m_apsJobs.end(),
+                                  apsJobs.begin(), apsJobs.end());
     }
-
-    for(size_t i=0;i<apData.size();i++)
+    else
     {
-        if( psWaitingWorkerThreadsList && psJobQueue )
-        {
-            CPLWorkerThread* psWorkerThread;
+        m_apsJobs.insert(m_apsJobs.end(), apsJobs.begin(), apsJobs.end());
+    }
+
+    WakeUpWaitingWorkerThreads(static_cast<int>(apsJobs.size()), oGuard);
+
+    return true;
+}
+
+/************************************************************************/
+/*                     WakeUpWaitingWorkerThreads()                     */
+/************************************************************************/
 
-            psWorkerThread = static_cast<CPLWorkerThread*>(psWaitingWorkerThreadsList->pData);
+// Wake up at most nJobs waiting worker threads. oGuard must hold m_mutex,
+// and is unlocked on return.
+void CPLWorkerThreadPool::WakeUpWaitingWorkerThreads(
+                                        int nJobs,
+                                        std::unique_lock<std::mutex>& oGuard)
+{
+    for( int i = 0; i < nJobs && psWaitingWorkerThreadsList; i++ )
+    {
+        CPLWorkerThread* psWorkerThread =
+            static_cast<CPLWorkerThread *>(psWaitingWorkerThreadsList->pData);
 
-            CPLAssert( psWorkerThread->bMarkedAsWaiting );
-            psWorkerThread->bMarkedAsWaiting = false;
+        CPLAssert( psWorkerThread->bMarkedAsWaiting );
+        psWorkerThread->bMarkedAsWaiting = false;
 
-            CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-            CPLList* psToFree = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psNext;
-            nWaitingWorkerThreads--;
+        CPLList* psNext = psWaitingWorkerThreadsList->psNext;
+        CPLList* psToFree = psWaitingWorkerThreadsList;
+        psWaitingWorkerThreadsList = psNext;
+        nWaitingWorkerThreads--;
 
-            // CPLAssert(
-            //    CPLListCount(psWaitingWorkerThreadsList) ==
-            //    nWaitingWorkerThreads);
+        // CPLAssert(
+        //   CPLListCount(psWaitingWorkerThreadsList) == nWaitingWorkerThreads);
 
 #if DEBUG_VERBOSE
-            CPLDebug("JOB", "Waking up %p", psWorkerThread);
+        CPLDebug("JOB", "Waking up %p", psWorkerThread);
 #endif
-            {
-                std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-                oGuard.unlock();
-                psWorkerThread->m_cv.notify_one();
-            }
 
-            CPLFree(psToFree);
-            oGuard.lock();
-        }
-        else
         {
-            break;
+            std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
+            oGuard.unlock();
+            psWorkerThread->m_cv.notify_one();
         }
-    }
 
-    return true;
+        CPLFree(psToFree);
+        oGuard.lock();
+    }
+    oGuard.unlock();
 }
 
 /************************************************************************/
@@ -291,6 +326,9 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * This method should not be called from a job of this pool, as the calling
+ * job is itself counted as pending. Use a CPLJobQueue in that situation.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -351,6 +389,22 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
 }
 
 /** Setup the pool.
+ *
+ * Starting with GDAL 3.4, the GDAL_THREAD_PINNING configuration option,
+ * evaluated at the time of this call, controls the CPU affinity of the
+ * worker threads on Linux:
+ * <ul>
+ * <li>NO (default): no affinity is set.</li>
+ * <li>NUMA: the threads are distributed in a round-robin way over the NUMA
+ * nodes, and each of them may only run on the CPUs of its node. Combined with
+ * CPL_NUMA_LOCAL_ALLOC=YES, the large buffers allocated by a worker thread
+ * are located on its node.</li>
+ * <li>CPU: each thread is bound to a single CPU, CPUs of a same NUMA node
+ * being used first.</li>
+ * </ul>
+ * CPUs and nodes are assigned in sequence over all the pinned threads of the
+ * process, so that the threads of several pools do not all use the first
+ * CPUs or nodes.
  *
  * @param nThreads Number of threads to launch
  * @param pfnInitFunc Initialization function to run in each thread. May be NULL
@@ -366,6 +420,18 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
 {
     CPLAssert( nThreads > 0 );
 
+    const char* pszPinning = CPLGetConfigOption("GDAL_THREAD_PINNING", "NO");
+    int nPinningMode = PINNING_NONE;
+    if( EQUAL(pszPinning, "NUMA") )
+        nPinningMode = PINNING_NUMA;
+    else if( EQUAL(pszPinning, "CPU") )
+        nPinningMode = PINNING_CPU;
+    else if( !EQUAL(pszPinning, "NO") )
+    {
+        CPLError(CE_Warning, CPLE_IllegalArg,
+                 "Invalid value for GDAL_THREAD_PINNING: %s", pszPinning);
+    }
+
     bool bRet = true;
     for(int i=static_cast<int>(aWT.size());i<nThreads;i++)
     {
@@ -374,6 +440,12 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
         wt->pInitData = pasInitData ? pasInitData[i] : nullptr;
         wt->poTP = this;
         wt->bMarkedAsWaiting = false;
+        wt->nIndex = i;
+        wt->nPinningMode = nPinningMode;
+        if( nPinningMode != PINNING_NONE )
+            wt->nPinningIndex = gnNextPinningIndex++ & INT_MAX;
+        // Worker threads steal jobs from aWT, hence the lock
+        std::lock_guard<std::mutex> oGuard(m_mutex);
         wt->hThread =
             CPLCreateJoinableThread(WorkerThreadFunction, wt.get());
         if( wt->hThread == nullptr )
@@ -409,36 +481,149 @@ void CPLWorkerThreadPool::DeclareJobFinished()
 {
     std::lock_guard<std::mutex> oGuard(m_mutex);
     nPendingJobs --;
-    m_cv.notify_one();
+    m_cv.notify_all();
 }
 
 /************************************************************************/
-/*                             GetNextJob()                             */
+/*                              TryGetJob()                             */
 /************************************************************************/
 
+// Pop a job if one is available, without waiting. Jobs are taken in turn
+// from the back of the queue of psWorkerThread (most recently submitted
+// first, whose data is more likely to be in CPU caches), from the jobs
+// submitted by external threads, and from the front of the queues of the
+// other worker threads (oldest first, which are generally the largest
+// units of work in nested parallelism).
+// If poQueue is not null, only jobs of this queue are considered.
 CPLWorkerThreadJob *
-CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
+CPLWorkerThreadPool::TryGetJob( CPLWorkerThread* psWorkerThread,
+                                const CPLJobQueue* poQueue )
 {
-    while(true)
+    if( m_nQueuedJobs == 0 )
+        return nullptr;
+
+    const auto TakeFrom = [poQueue](std::deque<CPLWorkerThreadJob*>& apsJobs,
+                                    bool bFromBack) -> CPLWorkerThreadJob*
     {
-        std::unique_lock<std::mutex> oGuard(m_mutex);
-        if( eState == CPLWTS_STOP )
-        {
+        if( apsJobs.empty() )
             return nullptr;
+        if( poQueue == nullptr )
+        {
+            CPLWorkerThreadJob* psJob;
+            if( bFromBack )
+            {
+                psJob = apsJobs.back();
+                apsJobs.pop_back();
+            }
+            else
+            {
+                psJob = apsJobs.front();
+                apsJobs.pop_front();
+            }
+            return psJob;
         }
-        CPLList* psTopJobIter = psJobQueue;
-        if( psTopJobIter )
+        if( bFromBack )
         {
-            psJobQueue = psTopJobIter->psNext;
+            for( auto iter = apsJobs.rbegin(); iter != apsJobs.rend(); ++iter )
+            {
+                if( (*iter)->poQueue == poQueue )
+                {
+                    CPLWorkerThreadJob* psJob = *iter;
+                    apsJobs.erase(std::next(iter).base());
+                    return psJob;
+                }
+            }
+        }
+        else
+        {
+            for( auto iter = apsJobs.begin(); iter != apsJobs.end(); ++iter )
+            {
+                if( (*iter)->poQueue == poQueue )
+                {
+                    CPLWorkerThreadJob* psJob = *iter;
+                    apsJobs.erase(iter);
+                    return psJob;
+                }
+            }
+        }
+        return nullptr;
+    };
 
+    CPLWorkerThreadJob* psJob = nullptr;
+    if( psWorkerThread )
+    {
+        std::lock_guard<std::mutex> oGuardJobs(psWorkerThread->m_mutexJobs);
+        psJob = TakeFrom(psWorkerThread->m_apsJobs, true);
+    }
+    if( psJob == nullptr )
+    {
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        psJob = TakeFrom(m_apsJobs, false);
+        if( psJob == nullptr )
+        {
+            // Start from a different thread for each thief
+            const size_t nThreads = aWT.size();
+            size_t iStart = 0;
+            for( size_t i = 0; i < nThreads; i++ )
+            {
+                if( aWT[i].get() == psWorkerThread )
+                {
+                    iStart = i + 1;
+                    break;
+                }
+            }
+            for( size_t i = 0; psJob == nullptr && i < nThreads; i++ )
+            {
+                CPLWorkerThread* psOther = aWT[(iStart + i) % nThreads].get();
+                if( psOther == psWorkerThread )
+                    continue;
+                std::lock_guard<std::mutex> oGuardJobs(psOther->m_mutexJobs);
+                psJob = TakeFrom(psOther->m_apsJobs, false);
+            }
+        }
+    }
+    if( psJob )
+    {
+        m_nQueuedJobs--;
 #if DEBUG_VERBOSE
-            CPLDebug("JOB", "%p got a job", psWorkerThread);
+        CPLDebug("JOB", "%p got a job", psWorkerThread);
 #endif
-            CPLWorkerThreadJob* psJob =
-                static_cast<CPLWorkerThreadJob*>(psTopJobIter->pData);
-            CPLFree(psTopJobIter);
+    }
+    return psJob;
+}
+
+/************************************************************************/
+/*                             GetNextJob()                             */
+/************************************************************************/
+
+CPLWorkerThreadJob *
+CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
+{
+    while(true)
+    {
+        {
+            std::lock_guard<std::mutex> oGuard(m_mutex);
+            if( eState == CPLWTS_STOP )
+            {
+                return nullptr;
+            }
+        }
+
+        CPLWorkerThreadJob* psJob = TryGetJob(psWorkerThread, nullptr);
+        if( psJob )
             return psJob;
+
+        std::unique_lock<std::mutex> oGuard(m_mutex);
+        if( eState == CPLWTS_STOP )
+        {
+            return nullptr;
         }
+        // A job might have been submitted after TryGetJob() returned.
+        // As m_nQueuedJobs is incremented before a submitter looks for a
+        // waiting worker thread under m_mutex, either we see it here, or the
+        // submitter will see us as waiting.
+        if( m_nQueuedJobs > 0 )
+            continue;
 
         if( !psWorkerThread->bMarkedAsWaiting )
         {
@@ -542,7 +727,7 @@ void CPLJobQueue::DeclareJobFinished()
 {
     std::lock_guard<std::mutex> oGuard(m_mutex);
     m_nPendingJobs --;
-    m_cv.notify_one();
+    m_cv.notify_all();
 }
 
 /************************************************************************/
@@ -565,10 +750,19 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
         std::lock_guard<std::mutex> oGuard(m_mutex);
         m_nPendingJobs ++;
     }
-    bool bRet = m_poPool->SubmitJob(JobQueueFunction, poJob);
+    bool bRet = m_poPool->SubmitJob(JobQueueFunction, poJob, this);
     if( !bRet )
     {
         delete poJob;
+        DeclareJobFinished();
+    }
+    else
+    {
+        // Wake up a worker thread that would wait for this queue, so that it
+        // can run the job.
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_nSubmittedJobs ++;
+        m_cv.notify_all();
     }
     return bRet;
 }
@@ -578,6 +772,10 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * When called from a worker thread of the pool, pending jobs of this queue
+ * are run by the calling thread while waiting, which avoids deadlocks when
+ * all worker threads wait for jobs of nested queues.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -585,9 +783,33 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
  */
 void CPLJobQueue::WaitCompletion(int nMaxRemainingJobs)
 {
+    CPLWorkerThread* psCurWT = m_poPool->GetCurrentWorkerThread();
     std::unique_lock<std::mutex> oGuard(m_mutex);
     while( m_nPendingJobs > nMaxRemainingJobs )
     {
-        m_cv.wait(oGuard);
+        if( psCurWT )
+        {
+            const int nSubmittedJobsBefore = m_nSubmittedJobs;
+            oGuard.unlock();
+            CPLWorkerThreadJob* psJob = m_poPool->TryGetJob(psCurWT, this);
+            if( psJob )
+            {
+                m_poPool->RunJob(psJob);
+                oGuard.lock();
+                continue;
+            }
+            oGuard.lock();
+            // The remaining jobs of the queue are being run by other
+            // threads. Wait for one of them to finish, or for a new job.
+            if( m_nPendingJobs > nMaxRemainingJobs &&
+                m_nSubmittedJobs == nSubmittedJobsBefore )
+            {
+                m_cv.wait(oGuard);
+            }
+        }
+        else
+        {
+            m_cv.wait(oGuard);
+        }
     }
 }
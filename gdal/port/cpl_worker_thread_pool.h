@@ -33,7 +33,9 @@
 #include "cpl_multiproc.h"
 #include "cpl_list.h"
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -59,9 +61,19 @@ struct CPLWorkerThread
     CPLWorkerThreadPool *poTP = nullptr;
     CPLJoinableThread   *hThread = nullptr;
     bool                 bMarkedAsWaiting = false;
+    // Index of the thread in the pool, GDAL_THREAD_PINNING mode, and index
+    // of the CPU or NUMA node the thread is bound to (modulo their count)
+    int                  nIndex = 0;
+    int                  nPinningMode = 0;
+    int                  nPinningIndex = 0;
 
     std::mutex              m_mutex{};
     std::condition_variable m_cv{};
+
+    // Jobs submitted from this thread. The thread itself pops them from the
+    // back, and other threads steal them from the front.
+    std::mutex                       m_mutexJobs{};
+    std::deque<CPLWorkerThreadJob*>  m_apsJobs{};
 };
 
 typedef enum
@@ -83,8 +95,14 @@ class CPL_DLL CPLWorkerThreadPool
         std::mutex              m_mutex{};
         std::condition_variable m_cv{};
         volatile CPLWorkerThreadState eState = CPLWTS_OK;
-        CPLList* psJobQueue = nullptr;
+        // Jobs submitted from threads that are not workers of this pool
+        std::deque<CPLWorkerThreadJob*> m_apsJobs{};
         volatile int nPendingJobs = 0;
+        // Number of jobs not yet started, in m_apsJobs and workers' queues
+        std::atomic<int> m_nQueuedJobs{0};
+        // Statistics
+        std::atomic<GIntBig> m_nCompletedJobs{0};
+        std::atomic<GIntBig> m_nBusyTimeMicroSec{0};
 
         CPLList* psWaitingWorkerThreadsList = nullptr;
         int nWaitingWorkerThreads = 0;
@@ -93,6 +111,16 @@ class CPL_DLL CPLWorkerThreadPool
 
         void DeclareJobFinished();
         CPLWorkerThreadJob* GetNextJob(CPLWorkerThread* psWorkerThread);
+        CPLWorkerThreadJob* TryGetJob(CPLWorkerThread* psWorkerThread,
+                                      const CPLJobQueue* poQueue);
+        void RunJob(CPLWorkerThreadJob* psJob);
+        bool SubmitJob(CPLThreadFunc pfnFunc, void* pData,
+                       CPLJobQueue* poQueue);
+        void WakeUpWaitingWorkerThreads(int nJobs,
+                                        std::unique_lock<std::mutex>& oGuard);
+        CPLWorkerThread* GetCurrentWorkerThread() const;
+
+        friend class CPLJobQueue;
 
     public:
         CPLWorkerThreadPool();
@@ -116,9 +144,30 @@ class CPL_DLL CPLWorkerThreadPool
 
         /** Return the number of threads setup */
         int GetThreadCount() const { return static_cast<int>(aWT.size()); }
+
+        /** Return the number of jobs submitted but not yet started.
+         * @since GDAL 3.4 */
+        int GetQueuedJobCount() const { return m_nQueuedJobs; }
+
+        /** Return the number of jobs run since the creation of the pool.
+         * @since GDAL 3.4 */
+        GIntBig GetCompletedJobCount() const { return m_nCompletedJobs; }
+
+        /** Return the cumulated time, in microseconds, spent by the worker
+         * threads in running jobs, since the creation of the pool.
+         * @since GDAL 3.4 */
+        GIntBig GetBusyTimeMicroSec() const { return m_nBusyTimeMicroSec; }
 };
 
-/** Job queue */
+/** Job queue.
+ *
+ * A job queue is a group of jobs submitted to a worker thread pool, whose
+ * completion can be waited for independently of the other jobs of the pool.
+ *
+ * Since GDAL 3.4, jobs may submit jobs to their own job queues and wait for
+ * their completion: when WaitCompletion() is called from a worker thread of
+ * the pool, the thread runs pending jobs of the queue instead of blocking.
+ */
 class CPL_DLL CPLJobQueue
 {
         CPL_DISALLOW_COPY_ASSIGN(CPLJobQueue)
@@ -126,6 +175,7 @@ class CPL_DLL CPLJobQueue
         std::mutex m_mutex{};
         std::condition_variable m_cv{};
         int m_nPendingJobs = 0;
+        int m_nSubmittedJobs = 0;
 
         static void JobQueueFunction(void*);
         void DeclareJobFinished();